@@ -7,7 +7,9 @@
 #include "actuators/HeaterActuator.h"
 #include "actuators/LEDStripActuator.h"
 #include "actuators/ServoActuator.h"
+#include "actuators/RelayController.h"
 #include "blynk/BlynkManager.h"
+#include "system/StateSnapshot.h"
 
 /**
  * @brief Gestor centralizado de actuadores para invernadero ESP32
@@ -21,6 +23,7 @@
  * - Calefactor para control de temperatura
  * - Tira LED para iluminación de crecimiento
  * - Servomotor para tapar/destapar ventilador
+ * - Válvulas de riego por zona (relé multicanal)
  */
 class ActuatorManager {
 private:
@@ -29,6 +32,7 @@ private:
     HeaterActuator* heaterActuator;
     LEDStripActuator* ledStripActuator;
     ServoActuator* servoActuator;
+    RelayController* valveRelays;
     BlynkManager* blynkManager;
     
     // Control de envío de datos
@@ -37,6 +41,14 @@ private:
     
     bool actuatorsInitialized;
     
+    // Bits de getSafeState(): salidas en los bits 0-3, brillo en 8-15, posición del servo en 16-23
+    static constexpr uint32_t SAFE_FAN = 1u << 0;
+    static constexpr uint32_t SAFE_HEATER = 1u << 1;
+    static constexpr uint32_t SAFE_LED = 1u << 2;
+    static constexpr uint32_t SAFE_VALID = 1u << 3;   // 0 = sin estado (bloqueo antes de terminar una iteración)
+    static constexpr uint8_t SAFE_BRIGHTNESS_SHIFT = 8;
+    static constexpr uint8_t SAFE_VENT_SHIFT = 16;
+    
 public:
     explicit ActuatorManager(BlynkManager& blynk);
     ~ActuatorManager();
@@ -46,6 +58,19 @@ public:
     
     // Actualización periódica
     void update();
+    // ms hasta que update() tenga trabajo: paso del servo, tiempo máximo o envío a Blynk
+    unsigned long getIdleTime();
+    // Salidas PWM (LEDC) activas: el sueño ligero las pararía
+    bool needsPwmClock();
+    
+    // Salidas a recuperar tras un reinicio por bloqueo; la bomba y las válvulas no (el riego lo decide la lógica)
+    uint32_t getSafeState();
+    void restoreSafeState(uint32_t state);
+    
+    // Arranque en caliente (StateSnapshot): relés, contadores, brillo y ventana; las válvulas
+    // no, el riego interrumpido lo reanuda la lógica
+    void saveState(StateSnapshot::State& state);
+    void restoreState(const StateSnapshot::State& state);
     
     // Gestión de actuadores
     void sendDataToBlynk();
@@ -59,6 +84,7 @@ public:
     HeaterActuator* getHeater();
     LEDStripActuator* getLEDStrip();
     ServoActuator* getServo();
+    RelayController* getValveRelays();
     
     // Métodos de control directo (para compatibilidad)
     bool activarVentilador();
@@ -87,9 +113,6 @@ public:
     
     // Funciones de utilidad
     void imprimirEstado() const;
-    
-    // Integración con Blynk
-    bool controlarDesdeBlynk(uint8_t actuador, int estado);
 };
 
 #endif // ACTUATORMANAGER_H
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <Arduino.h>
+#include "system/StateSnapshot.h"
 
 class FanActuator {
 private:
@@ -30,6 +31,7 @@ public:
     bool turnOn();
     bool turnOff();
     bool toggle();
+    bool resumeOn();  // Tras un reinicio en caliente: estaba encendido, sin esperar el intervalo mínimo
     
     // Estado
     bool isRunning();
@@ -47,6 +49,10 @@ public:
     // Funciones de utilidad
     void printStatus();
     
+    // Arranque en caliente (StateSnapshot)
+    void saveState(StateSnapshot::Relay& state);
+    void restoreState(const StateSnapshot::Relay& state);
+    
     // Integración con Blynk
     int getBlynkState();
     bool setFromBlynk(int state);
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <Arduino.h>
+#include "system/StateSnapshot.h"
 
 class HeaterActuator {
 private:
@@ -38,6 +39,7 @@ public:
     bool turnOn();
     bool turnOff();
     bool toggle();
+    bool resumeOn();  // Tras un reinicio en caliente: estaba encendido, sin esperar el intervalo mínimo
     
     // Estado
     bool isRunning();
@@ -57,6 +59,7 @@ public:
     unsigned long getTimeSinceLastStateChange();
     unsigned long getContinuousRunTime();
     bool hasExceededMaxRunTime();
+    unsigned long getTimeUntilMaxRunTime();  // ULONG_MAX si está apagado o sin límite
     
     // Estadísticas
     unsigned long getTotalRunTime();
@@ -66,6 +69,10 @@ public:
     // Funciones de utilidad
     void printStatus();
     
+    // Arranque en caliente (StateSnapshot)
+    void saveState(StateSnapshot::Relay& state);
+    void restoreState(const StateSnapshot::Relay& state);
+    
     // Integración con Blynk
     int getBlynkState();
     bool setFromBlynk(int state);
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <Arduino.h>
+#include "system/StateSnapshot.h"
 
 class LEDStripActuator {
 private:
@@ -39,6 +40,7 @@ public:
     bool turnOn();
     bool turnOff();
     bool toggle();
+    bool resumeOn();  // Tras un reinicio en caliente: estaba encendido, sin esperar el intervalo mínimo
     
     // Control de intensidad (solo si PWM está habilitado)
     bool setBrightness(uint8_t brightness);
@@ -68,6 +70,10 @@ public:
     // Funciones de utilidad
     void printStatus();
     
+    // Arranque en caliente (StateSnapshot)
+    void saveState(StateSnapshot::Relay& state);
+    void restoreState(const StateSnapshot::Relay& state);
+    
     // Integración con Blynk
     int getBlynkState();
     bool setFromBlynk(int state);
@@ -62,6 +62,7 @@ public:
     
     // Movimiento suave
     void update(); // Llamar en loop para movimiento suave
+    unsigned long getIdleTime(); // ms hasta el siguiente paso (ULONG_MAX si no se mueve)
     bool smoothMoveTo(int position);
     
     // Calibración
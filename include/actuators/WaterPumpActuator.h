@@ -1,6 +1,7 @@
 #pragma once
 
 #include <Arduino.h>
+#include "system/StateSnapshot.h"
 
 class WaterPumpActuator {
 private:
@@ -47,6 +48,7 @@ public:
     unsigned long getTimeSinceLastStateChange();
     unsigned long getContinuousRunTime();
     bool hasExceededMaxRunTime();
+    unsigned long getTimeUntilMaxRunTime();  // ULONG_MAX si está apagado o sin límite
     
     // Estadísticas
     unsigned long getTotalRunTime();
@@ -56,6 +58,10 @@ public:
     // Funciones de utilidad
     void printStatus();
     
+    // Arranque en caliente (StateSnapshot)
+    void saveState(StateSnapshot::Relay& state);
+    void restoreState(const StateSnapshot::Relay& state);
+    
     // Integración con Blynk
     int getBlynkState();
     bool setFromBlynk(int state);
@@ -70,6 +70,9 @@ public:
 private:
     void (*connectCallback)();
     void (*disconnectCallback)();
+    
+    // Solo pines de BlynkTargets::PIN_TABLE, donde no pueden repetirse
+    bool canSend(int pin);
 };
 
 #endif
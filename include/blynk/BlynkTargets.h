@@ -0,0 +1,184 @@
+#pragma once
+
+#include <Arduino.h>
+#include "config/config.h"
+#include "config/Targets.h"
+
+class LogicManager;
+class ActuatorManager;
+class BlynkManager;
+class SettingsStore;
+
+/**
+ * @brief Registro de pines virtuales Blynk
+ *
+ * Cada pin usado por el firmware aparece una sola vez en PIN_TABLE con su
+ * manejador de escritura, sus límites y, si es un objetivo, el campo de
+ * `targets` que modifica. Los estados de los actuadores principales (0/1)
+ * también se pueden mandar desde la app. Los pines duplicados o fuera de rango son un error
+ * de compilación, y BLYNK_WRITE_DEFAULT() despacha cualquier escritura con un
+ * acceso directo a PIN_INDEX, sin memoria dinámica. BlynkManager no envía a
+ * pines que no estén en la tabla.
+ */
+namespace BlynkTargets {
+
+struct PinEntry;
+typedef void (*WriteHandler)(const PinEntry& entry, float value);
+
+struct PinEntry {
+    uint8_t pin;
+    const char* name;
+    WriteHandler onWrite;      // nullptr = pin solo de salida
+    float Targets::* field;    // Objetivo modificado (nullptr si no es un objetivo)
+    float minValue;
+    float maxValue;
+};
+
+// Write handlers (BlynkTargets.cpp)
+void writeTarget(const PinEntry& entry, float value);
+void writeAutotuneTemperature(const PinEntry& entry, float value);
+void writeAutotuneHumidity(const PinEntry& entry, float value);
+void writeFan(const PinEntry& entry, float value);
+void writeWaterPump(const PinEntry& entry, float value);
+void writeHeater(const PinEntry& entry, float value);
+void writeLEDStrip(const PinEntry& entry, float value);
+void writeServo(const PinEntry& entry, float value);
+
+inline constexpr PinEntry PIN_TABLE[] = {
+    // Sensores (solo salida)
+    {BLYNK_VPIN_TEMPERATURE, "Temperatura", nullptr, nullptr, 0, 0},
+    {BLYNK_VPIN_HUMIDITY, "Humedad", nullptr, nullptr, 0, 0},
+    {BLYNK_VPIN_HEAT_INDEX, "Indice de calor", nullptr, nullptr, 0, 0},
+    {BLYNK_VPIN_LUX, "Lux AS7341", nullptr, nullptr, 0, 0},
+    {BLYNK_VPIN_COLOR_TEMP, "Temperatura de color", nullptr, nullptr, 0, 0},
+    {BLYNK_VPIN_RED_LIGHT, "Luz roja", nullptr, nullptr, 0, 0},
+    {BLYNK_VPIN_GREEN_LIGHT, "Luz verde", nullptr, nullptr, 0, 0},
+    {BLYNK_VPIN_BLUE_LIGHT, "Luz azul", nullptr, nullptr, 0, 0},
+    {BLYNK_VPIN_CLEAR_LIGHT, "Luz clear", nullptr, nullptr, 0, 0},
+    {BLYNK_VPIN_NIR_LIGHT, "Luz NIR", nullptr, nullptr, 0, 0},
+    {BLYNK_VPIN_SOIL_MOISTURE, "Humedad suelo", nullptr, nullptr, 0, 0},
+    {BLYNK_VPIN_SOIL_RAW, "Humedad suelo raw", nullptr, nullptr, 0, 0},
+    {BLYNK_VPIN_LIGHT_LUX, "Lux BH1750", nullptr, nullptr, 0, 0},
+    {BLYNK_VPIN_LIGHT_LEVEL, "Nivel de luz", nullptr, nullptr, 0, 0},
+    {BLYNK_VPIN_WATER_LEVEL, "Nivel de agua", nullptr, nullptr, 0, 0},
+    {BLYNK_VPIN_WATER_PERCENTAGE, "Porcentaje de agua", nullptr, nullptr, 0, 0},
+    {BLYNK_VPIN_WATER_STATUS, "Estado del agua", nullptr, nullptr, 0, 0},
+    {BLYNK_VPIN_SOIL_TEMP, "Temperatura suelo", nullptr, nullptr, 0, 0},
+    {BLYNK_VPIN_SOIL_MOISTURE_RS485, "Humedad suelo RS485", nullptr, nullptr, 0, 0},
+    {BLYNK_VPIN_SOIL_EC, "EC suelo", nullptr, nullptr, 0, 0},
+    {BLYNK_VPIN_SOIL_PH, "pH suelo", nullptr, nullptr, 0, 0},
+    {BLYNK_VPIN_SOIL_NPK_N, "Nitrogeno", nullptr, nullptr, 0, 0},
+    {BLYNK_VPIN_SOIL_NPK_P, "Fosforo", nullptr, nullptr, 0, 0},
+    {BLYNK_VPIN_SOIL_NPK_K, "Potasio", nullptr, nullptr, 0, 0},
+
+    // Actuadores (los estados 0/1 de los principales se pueden mandar desde la app)
+    {BLYNK_VPIN_RELAY_1, "Rele 1", nullptr, nullptr, 0, 0},
+    {BLYNK_VPIN_RELAY_2, "Rele 2", nullptr, nullptr, 0, 0},
+    {BLYNK_VPIN_RELAY_3, "Rele 3", nullptr, nullptr, 0, 0},
+    {BLYNK_VPIN_RELAY_4, "Rele 4", nullptr, nullptr, 0, 0},
+    {BLYNK_VPIN_RELAY_5, "Rele 5", nullptr, nullptr, 0, 0},
+    {BLYNK_VPIN_RELAY_6, "Rele 6", nullptr, nullptr, 0, 0},
+    {BLYNK_VPIN_RELAY_7, "Rele 7", nullptr, nullptr, 0, 0},
+    {BLYNK_VPIN_RELAY_8, "Rele 8", nullptr, nullptr, 0, 0},
+    {BLYNK_VPIN_FAN_MAIN_STATE, "Ventilador principal", writeFan, nullptr, 0, 1},
+    {BLYNK_VPIN_FAN_MAIN_SPEED, "Velocidad ventilador principal", nullptr, nullptr, 0, 0},
+    {BLYNK_VPIN_FAN_CIRCULATION_STATE, "Ventilador circulacion", nullptr, nullptr, 0, 0},
+    {BLYNK_VPIN_FAN_CIRCULATION_SPEED, "Velocidad ventilador circulacion", nullptr, nullptr, 0, 0},
+    {BLYNK_VPIN_FAN_AUTO_MODE, "Ventilador automatico", nullptr, nullptr, 0, 0},
+    {BLYNK_VPIN_HEATER_MAIN_STATE, "Calefactor principal", writeHeater, nullptr, 0, 1},
+    {BLYNK_VPIN_HEATER_MAIN_POWER, "Potencia calefactor principal", nullptr, nullptr, 0, 0},
+    {BLYNK_VPIN_HEATER_TARGET_TEMP, "Temperatura calefactor", nullptr, nullptr, 0, 0},
+    {BLYNK_VPIN_HEATER_AUX_STATE, "Calefactor auxiliar", nullptr, nullptr, 0, 0},
+    {BLYNK_VPIN_HEATER_AUX_POWER, "Potencia calefactor auxiliar", nullptr, nullptr, 0, 0},
+    {BLYNK_VPIN_HEATER_AUTO_MODE, "Calefactor automatico", nullptr, nullptr, 0, 0},
+    {BLYNK_VPIN_WATER_PUMP_STATE, "Bomba", writeWaterPump, nullptr, 0, 1},
+    {BLYNK_VPIN_WATER_PUMP_MODE, "Bomba automatica", nullptr, nullptr, 0, 0},
+    {BLYNK_VPIN_WATER_PUMP_TIMER, "Programador bomba", nullptr, nullptr, 0, 0},
+    {BLYNK_VPIN_WATER_PUMP_STATS, "Estadisticas bomba", nullptr, nullptr, 0, 0},
+    {BLYNK_VPIN_LED_STRIP_STATE, "Tira LED", writeLEDStrip, nullptr, 0, 1},
+    {BLYNK_VPIN_LED_STRIP_BRIGHTNESS, "Brillo tira LED", nullptr, nullptr, 0, 0},
+    {BLYNK_VPIN_FAN_SERVO_STATE, "Servo ventilador", writeServo, nullptr, 0, 1},
+    {BLYNK_VPIN_FAN_SERVO_POSITION, "Posicion servo ventilador", nullptr, nullptr, 0, 0},
+
+    // Estado del sistema (solo salida)
+    {BLYNK_VPIN_STATUS_TARGET_TEMPERATURE, "Objetivo temperatura aplicado", nullptr, nullptr, 0, 0},
+    {BLYNK_VPIN_STATUS_TARGET_HUMIDITY, "Objetivo humedad aplicado", nullptr, nullptr, 0, 0},
+    {BLYNK_VPIN_STATUS_TARGET_LUX, "Objetivo luz aplicado", nullptr, nullptr, 0, 0},
+    {BLYNK_VPIN_STATUS_TARGET_SOIL, "Objetivo suelo aplicado", nullptr, nullptr, 0, 0},
+    {BLYNK_VPIN_SYSTEM_ENABLED, "Sistema habilitado", nullptr, nullptr, 0, 0},
+    {BLYNK_VPIN_AUTO_MODE, "Modo automatico", nullptr, nullptr, 0, 0},
+
+    // Objetivos ajustables (rangos de los deslizadores en docs/setup_blynk.md)
+    {BLYNK_VPIN_TARGET_TEMPERATURE, "Temperatura objetivo", writeTarget, &Targets::temperature, 15.0, 35.0},
+    {BLYNK_VPIN_TARGET_HUMIDITY, "Humedad objetivo", writeTarget, &Targets::humidity, 40.0, 80.0},
+    {BLYNK_VPIN_TARGET_SOIL_MOISTURE, "Humedad suelo objetivo", writeTarget, &Targets::soilMoisture, 30.0, 80.0},
+    {BLYNK_VPIN_TARGET_LUX_MIN, "Lux minimo", writeTarget, &Targets::luxMin, 1000.0, 20000.0},
+    {BLYNK_VPIN_TARGET_VENT_TEMP, "Temperatura ventilacion", writeTarget, &Targets::ventTemp, 20.0, 35.0},
+    {BLYNK_VPIN_TARGET_SOIL_PH, "pH suelo objetivo", writeTarget, &Targets::soilPH, 5.5, 7.5},
+    {BLYNK_VPIN_TARGET_SOIL_EC, "EC suelo objetivo", writeTarget, &Targets::soilEC, 800.0, 2500.0},
+    {BLYNK_VPIN_TARGET_WATER_LEVEL, "Nivel agua critico", writeTarget, &Targets::waterLevel, 10.0, 30.0},
+
+    // Autoajuste PID (1 = iniciar, 0 = cancelar)
+    {BLYNK_VPIN_AUTOTUNE_TEMPERATURE, "Autoajuste temperatura", writeAutotuneTemperature, nullptr, 0, 1},
+    {BLYNK_VPIN_AUTOTUNE_HUMIDITY, "Autoajuste humedad", writeAutotuneHumidity, nullptr, 0, 1},
+    {BLYNK_VPIN_AUTOTUNE_STATUS, "Estado autoajuste", nullptr, nullptr, 0, 0},
+};
+
+inline constexpr uint8_t PIN_COUNT = sizeof(PIN_TABLE) / sizeof(PIN_TABLE[0]);
+inline constexpr uint8_t MAX_VPIN = 127; // Blynk admite hasta V255; el índice ocupa MAX_VPIN + 1 bytes
+inline constexpr uint8_t NO_ENTRY = 0xFF;
+
+constexpr bool pinsInRange() {
+    for (uint8_t i = 0; i < PIN_COUNT; i++) {
+        if (PIN_TABLE[i].pin > MAX_VPIN) return false;
+    }
+    return true;
+}
+
+constexpr bool pinsUnique() {
+    for (uint8_t i = 0; i < PIN_COUNT; i++) {
+        for (uint8_t j = i + 1; j < PIN_COUNT; j++) {
+            if (PIN_TABLE[i].pin == PIN_TABLE[j].pin) return false;
+        }
+    }
+    return true;
+}
+
+static_assert(PIN_COUNT < NO_ENTRY, "PIN_TABLE demasiado grande para el índice");
+static_assert(pinsInRange(), "Pin virtual Blynk mayor que MAX_VPIN");
+static_assert(pinsUnique(), "Pin virtual Blynk duplicado en PIN_TABLE (revisar BLYNK_VPIN_* en config.h)");
+
+// Pin -> posición en PIN_TABLE, calculado en compilación
+struct PinIndex {
+    uint8_t slot[MAX_VPIN + 1];
+};
+
+constexpr PinIndex buildPinIndex() {
+    PinIndex index = {};
+    for (uint8_t pin = 0; pin <= MAX_VPIN; pin++) {
+        index.slot[pin] = NO_ENTRY;
+    }
+    for (uint8_t i = 0; i < PIN_COUNT; i++) {
+        index.slot[PIN_TABLE[i].pin] = i;
+    }
+    return index;
+}
+
+inline constexpr PinIndex PIN_INDEX = buildPinIndex();
+
+// Entrada del pin o nullptr si no está registrado, O(1)
+constexpr const PinEntry* findPin(uint8_t pin) {
+    if (pin > MAX_VPIN || PIN_INDEX.slot[pin] == NO_ENTRY) return nullptr;
+    return &PIN_TABLE[PIN_INDEX.slot[pin]];
+}
+
+// Destinos de los manejadores (llamar una vez iniciado el sistema)
+void begin(LogicManager* logic, ActuatorManager* actuators, SettingsStore* settings, BlynkManager* blynk);
+
+/**
+ * @brief Despacha una escritura de la app
+ * @return false si el pin no está registrado o es solo de salida
+ */
+bool dispatch(uint8_t pin, float value);
+
+} // namespace BlynkTargets
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <Arduino.h>
+#include "config/Targets.h"
+
+/**
+ * @brief Ajustes de control guardados junto a los targets
+ * NAN en una ganancia = se mantienen las del controlador (config.h)
+ */
+struct ControlTuning {
+    float temperatureKp = NAN;
+    float temperatureKi = NAN;
+    float temperatureKd = NAN;
+    float humidityKp = NAN;
+    float humidityKi = NAN;
+    float humidityKd = NAN;
+    float ventTempHysteresis = 3.0;      // Banda sobre targets.ventTemp (°C)
+    float ventHumidityHysteresis = 15.0; // Banda sobre targets.humidity (%)
+
+    void loadDefaults();
+    bool hasTemperatureGains() const;
+    bool hasHumidityGains() const;
+};
+
+extern ControlTuning tuning;
+
+/**
+ * @brief Almacén persistente de `targets` y `tuning` en NVS
+ *
+ * - Un único registro binario con versión, tamaño y CRC32: se lee en una sola
+ *   operación al arrancar, antes de iniciar cualquier controlador
+ * - Un registro dañado o de otra versión se descarta y quedan los valores por
+ *   defecto (sin aplicar datos a medias)
+ * - Las escrituras se agrupan: markDirty() tras cada cambio y update() escribe
+ *   SETTINGS_FLUSH_DELAY ms después del último, y solo si el contenido cambió
+ */
+class SettingsStore {
+private:
+    struct Record {
+        uint32_t magic;
+        uint16_t version;
+        uint16_t size;
+        Targets targets;
+        ControlTuning tuning;
+        uint32_t crc;
+    };
+
+    static const uint32_t RECORD_MAGIC = 0x47524E48; // "GRNH"
+
+    bool loaded;
+    bool dirty;
+    unsigned long lastChange;
+    uint32_t savedCrc;
+    unsigned int writeCount;
+
+    void fillRecord(Record& record) const;
+    bool importLegacyGains();
+    static uint32_t crc32(const uint8_t* data, size_t length);
+
+public:
+    SettingsStore();
+
+    // Carga targets y tuning; false si no había registro válido (quedan los valores actuales)
+    bool begin();
+    // Llamar en cada iteración del loop
+    void update();
+    // ms hasta la escritura diferida (ULONG_MAX sin cambios pendientes)
+    unsigned long getIdleTime() const;
+
+    // Cambio pendiente de guardar (escritura diferida)
+    void markDirty();
+    // Escritura inmediata de los cambios pendientes
+    bool flush();
+    // Vuelve a los valores por defecto y los guarda
+    void resetToDefaults();
+
+    // Status
+    bool isLoaded() const;
+    bool isDirty() const;
+    unsigned int getWriteCount() const;
+};
@@ -40,14 +40,29 @@
 // CONFIGURACIÓN DE SENSORES
 // ===========================================
 
+// Bus I2C compartido (AS7341, BH1750)
+#define I2C_SDA_PIN 21                   // Pin SDA para I2C (GPIO 21)
+#define I2C_SCL_PIN 22                   // Pin SCL para I2C (GPIO 22)
+#define I2C_FREQUENCY 400000             // Fast mode (400 kHz)
+#define I2C_TIMEOUT_MS 10                // Tiempo máximo de una transacción (ms)
+#define I2C_QUEUE_SIZE 8                 // Trabajos en cola de todos los dispositivos
+#define I2C_MAX_DEVICES 6                // Dispositivos registrados (estadísticas por dispositivo)
+#define I2C_MAX_JOBS_PER_UPDATE 4        // Trabajos ejecutados por iteración del loop
+
 // DHT22 Sensor
 #define DHT22_PIN 4                      // Pin GPIO del sensor DHT22
 #define DHT22_READ_INTERVAL 5000         // Intervalo de lectura en ms (5 segundos)
+#define DHT22_WARMUP_TIME 2000           // Estabilización tras el arranque, sin bloquear (2 segundos)
+#define DHT22_USE_RMT true               // Captura por RMT sin desactivar interrupciones (false: librería Adafruit)
+#define DHT22_RMT_CHANNEL 4              // Canal RMT de recepción (0-7)
+#define DHT22_RMT_IDLE_US 200            // Línea sin flancos este tiempo: fin de la trama (µs)
+#define DHT22_START_SIGNAL_US 1100       // Señal de inicio del host a nivel bajo (µs)
+#define DHT22_CAPTURE_TIMEOUT 20         // Tiempo máximo hasta recibir la trama (ms)
+#define DHT22_MIN_INTERVAL 2000          // Mínimo entre transacciones que admite el sensor (ms)
 
 // AS7341 Sensor Espectral
 #define AS7341_READ_INTERVAL 3000        // Intervalo de lectura en ms (3 segundos)
-#define AS7341_SDA_PIN 21                // Pin SDA para I2C (GPIO 21)
-#define AS7341_SCL_PIN 22                // Pin SCL para I2C (GPIO 22)
+#define AS7341_WARMUP_TIME 100           // Estabilización tras configurar el sensor (ms)
 
 // Sensor de Humedad del Suelo
 #define SOIL_MOISTURE_PIN 35             // Pin GPIO analógico del sensor (GPIO 35)
@@ -55,8 +70,10 @@
 
 // Sensor BH1750 de Luz
 #define BH1750_READ_INTERVAL 4000        // Intervalo de lectura en ms (4 segundos)
-#define BH1750_SDA_PIN 21                // Pin SDA para I2C (GPIO 21)
-#define BH1750_SCL_PIN 22                // Pin SCL para I2C (GPIO 22)
+#define BH1750_WARMUP_TIME 200           // Estabilización tras encender el sensor (ms)
+#define BH1750_AUTO_MTREG true           // Ajustar MTreg con poca luz y cerca de saturar
+#define BH1750_AUTO_MTREG_DARK_RAW 100   // Cuentas (a MTreg 69) por debajo: máxima sensibilidad (~83 lx)
+#define BH1750_AUTO_MTREG_BRIGHT_RAW 60000 // Cuentas (a MTreg 69) por encima: mínima sensibilidad (~50000 lx)
 
 // Sensor HC-SR04 Ultrasónico para Nivel de Agua
 #define HCSR04_TRIGGER_PIN 5             // Pin GPIO Trigger del HC-SR04 (GPIO 5)
@@ -66,8 +83,9 @@
 // Sensor RS485 de Suelo (NPK-EC-PH-Temperatura-Humedad)
 #define RS485_TX_PIN 17                  // Pin GPIO TX para RS485 (GPIO 17)
 #define RS485_RX_PIN 16                  // Pin GPIO RX para RS485 (GPIO 16)
-#define RS485_TX_ENABLE_PIN 4            // Pin GPIO TX Enable para RS485 (GPIO 4)
+#define RS485_TX_ENABLE_PIN 2            // Pin GPIO TX Enable para RS485 (GPIO 2, RE/DE del módulo)
 #define RS485_READ_INTERVAL 10000        // Intervalo de lectura en ms (10 segundos)
+#define RS485_WARMUP_TIME 100            // Espera tras abrir el puerto antes de la primera petición (ms)
 
 // Intervalos de actualización
 #define BLYNK_UPDATE_INTERVAL 10000      // Envío a Blynk cada 10 segundos
@@ -117,14 +135,15 @@
 #define RELAY_TRIGGER_TYPE 0             // 0 = ACTIVE_LOW, 1 = ACTIVE_HIGH
 #define RELAY_MAX_SIMULTANEOUS 6         // Máximo de relés activos simultáneamente (protección)
 
-// Pines GPIO para relés (ajustar según necesidades)
+// Pines GPIO para relés (ajustar según necesidades). RelayController solo cablea los canales
+// de las válvulas de riego; ActuatorManager comprueba en compilación que no pisan otro pin
 #define RELAY_PIN_1 25                   // Canal 1 - Bomba de agua principal
 #define RELAY_PIN_2 26                   // Canal 2 - Ventilador de extracción
 #define RELAY_PIN_3 27                   // Canal 3 - Ventilador de circulación  
 #define RELAY_PIN_4 14                   // Canal 4 - Iluminación LED
 #define RELAY_PIN_5 12                   // Canal 5 - Bomba de nutrientes
 #define RELAY_PIN_6 13                   // Canal 6 - Válvula de riego zona 1
-#define RELAY_PIN_7 32                   // Canal 7 - Válvula de riego zona 2
+#define RELAY_PIN_7 19                   // Canal 7 - Válvula de riego zona 2 (GPIO 19)
 #define RELAY_PIN_8 33                   // Canal 8 - Sistema de calefacción
 
 // Pines virtuales Blynk para control de relés
@@ -147,24 +166,41 @@
 #define BLYNK_VPIN_TARGET_SOIL_EC 46         // Pin virtual para EC objetivo (V46)
 #define BLYNK_VPIN_TARGET_WATER_LEVEL 47     // Pin virtual para nivel agua crítico (V47)
 
+// Pines virtuales Blynk de estado del sistema (solo salida)
+#define BLYNK_VPIN_STATUS_TARGET_TEMPERATURE 58 // Objetivo de temperatura aplicado (V58)
+#define BLYNK_VPIN_STATUS_TARGET_HUMIDITY 59    // Objetivo de humedad aplicado (V59)
+#define BLYNK_VPIN_STATUS_TARGET_LUX 60         // Objetivo de luz aplicado (V60)
+#define BLYNK_VPIN_STATUS_TARGET_SOIL 61        // Objetivo de humedad del suelo de la zona 1 (V61)
+#define BLYNK_VPIN_SYSTEM_ENABLED 62            // Sistema de control habilitado (V62)
+#define BLYNK_VPIN_AUTO_MODE 63                 // Modo automático (V63)
+
 // Configuración de tiempos para actuadores
 #define RELAY_UPDATE_INTERVAL 1000       // Intervalo de actualización de timers en ms
 #define DEFAULT_PUMP_DURATION 300000     // Duración por defecto bomba (5 minutos)
 #define DEFAULT_FAN_DURATION 600000      // Duración por defecto ventilador (10 minutos)
 #define DEFAULT_IRRIGATION_DURATION 180000 // Duración por defecto riego (3 minutos)
 
+// Tira LED (LEDC) y servo de la trampilla del ventilador
+#define LED_STRIP_PIN 32                 // Pin PWM de la tira LED (GPIO 32)
+#define LED_STRIP_PWM_CHANNEL 0          // Canal LEDC de la tira LED (0-15)
+#define FAN_SERVO_PIN 33                 // Pin del servo que tapa el ventilador (GPIO 33)
+#define BLYNK_VPIN_LED_STRIP_STATE 64    // Pin virtual estado tira LED (V64)
+#define BLYNK_VPIN_LED_STRIP_BRIGHTNESS 65 // Pin virtual brillo tira LED en % (V65)
+#define BLYNK_VPIN_FAN_SERVO_STATE 66    // Pin virtual estado servo del ventilador (V66)
+#define BLYNK_VPIN_FAN_SERVO_POSITION 67 // Pin virtual posición servo del ventilador en % (V67)
+
 // ===========================================
 // CONFIGURACIÓN DE VENTILADORES
 // ===========================================
 
 // Ventilador Principal (Extracción)
-#define FAN_MAIN_PIN 26                  // Pin del ventilador principal (relé o PWM)
+#define FAN_MAIN_PIN 25                  // Pin del ventilador principal (relé o PWM)
 #define FAN_MAIN_CONTROL_TYPE 0          // 0 = RELAY_CONTROL, 1 = PWM_CONTROL
 #define FAN_MAIN_PWM_FREQUENCY 1000      // Frecuencia PWM en Hz (solo si PWM_CONTROL)
 #define FAN_MAIN_PWM_CHANNEL 0           // Canal PWM ESP32 (0-15)
 
 // Ventilador Secundario (Circulación)
-#define FAN_CIRCULATION_PIN 27           // Pin del ventilador de circulación
+#define FAN_CIRCULATION_PIN -1           // Pin del ventilador de circulación (-1 = no instalado)
 #define FAN_CIRCULATION_CONTROL_TYPE 1   // Control PWM para velocidad variable
 #define FAN_CIRCULATION_PWM_FREQUENCY 1000
 #define FAN_CIRCULATION_PWM_CHANNEL 1
@@ -174,6 +210,7 @@
 #define FAN_AUTO_TEMP_HIGH 28.0         // Temperatura alta (°C) - ventilador MAX
 #define FAN_AUTO_SPEED_MIN 30           // Velocidad mínima en modo auto (%)
 #define FAN_AUTO_SPEED_MAX 100          // Velocidad máxima en modo auto (%)
+#define FAN_COOLING_HYSTERESIS 1.0      // La refrigeración para este margen por debajo de donde arrancó (°C)
 
 // Configuración de seguridad
 #define FAN_MAX_RUN_TIME 3600000        // Tiempo máximo funcionamiento (1 hora)
@@ -181,6 +218,11 @@
 #define FAN_OVERHEAT_TEMP 80.0          // Temperatura de protección (°C)
 #define FAN_SOFT_START_TIME 3000        // Tiempo de arranque suave (ms)
 
+// Control de humedad por ventilación (salida proporcional en el tiempo del PID de humedad)
+#define FAN_HUMIDITY_WINDOW 600000      // Ventana del ventilador (10 minutos): un pulso por ventana
+#define FAN_HUMIDITY_MIN_SWITCH 60000   // Tiempo mínimo encendido y apagado dentro de la ventana (1 minuto)
+#define HUMIDIFIER_INSTALLED false      // Sistema de nebulización; sin él el PID de humedad solo deshumidifica
+
 // Pines virtuales Blynk para ventiladores
 #define BLYNK_VPIN_FAN_MAIN_STATE 32    // Pin virtual estado ventilador principal (V32)
 #define BLYNK_VPIN_FAN_MAIN_SPEED 33    // Pin virtual velocidad ventilador principal (V33)
@@ -193,13 +235,13 @@
 // ===========================================
 
 // Calefactor Principal
-#define HEATER_MAIN_PIN 32              // Pin del calefactor principal (relé o PWM)
+#define HEATER_MAIN_PIN 27              // Pin del calefactor principal (relé o PWM)
 #define HEATER_MAIN_CONTROL_TYPE 0      // 0 = RELAY_CONTROL, 1 = PWM_CONTROL
 #define HEATER_MAIN_PWM_FREQUENCY 1000  // Frecuencia PWM en Hz (solo si PWM_CONTROL)
 #define HEATER_MAIN_PWM_CHANNEL 2       // Canal PWM ESP32 (0-15)
 
 // Calefactor Auxiliar (opcional)
-#define HEATER_AUX_PIN 33               // Pin del calefactor auxiliar
+#define HEATER_AUX_PIN -1               // Pin del calefactor auxiliar (-1 = no instalado)
 #define HEATER_AUX_CONTROL_TYPE 1       // Control PWM para potencia variable
 #define HEATER_AUX_PWM_FREQUENCY 1000
 #define HEATER_AUX_PWM_CHANNEL 3
@@ -219,26 +261,40 @@
 #define HEATER_EMERGENCY_SHUTDOWN true  // Activar parada de emergencia
 
 // Operación cíclica (para control por relé)
-#define HEATER_CYCLE_ON_TIME 300000     // Tiempo encendido en ciclo (5 minutos)
-#define HEATER_CYCLE_OFF_TIME 60000     // Tiempo apagado en ciclo (1 minuto)
+#define HEATER_CYCLE_ON_TIME 120000     // Ventana de control proporcional en el tiempo (2 minutos): un pulso por ventana,
+                                        // el apagado es el resto de la ventana
 
-// Control PID (para control preciso de temperatura)
-#define HEATER_PID_KP 2.0               // Constante proporcional
-#define HEATER_PID_KI 0.1               // Constante integral  
-#define HEATER_PID_KD 0.05              // Constante derivativa
+// Control PID (para control preciso de temperatura), salida en % de la ventana
+// Ajustado sobre la planta térmica del gemelo digital (test/test_heater_pid); el autoajuste los sustituye
+#define HEATER_PID_KP 30.0              // Constante proporcional (%/°C)
+#define HEATER_PID_KI 0.015             // Constante integral (%/(°C·s), Ti ~ 33 min)
+#define HEATER_PID_KD 0.0               // Constante derivativa (PI: la derivada amplificaría los pasos de 0.1 °C del DHT22)
 
 // Pines virtuales Blynk para calefactores
 #define BLYNK_VPIN_HEATER_MAIN_STATE 37    // Pin virtual estado calefactor principal (V37)
 #define BLYNK_VPIN_HEATER_MAIN_POWER 38    // Pin virtual potencia calefactor principal (V38)
 #define BLYNK_VPIN_HEATER_TARGET_TEMP 39   // Pin virtual temperatura objetivo (V39)
-#define BLYNK_VPIN_HEATER_AUX_STATE 40     // Pin virtual estado calefactor auxiliar (V40)
-#define BLYNK_VPIN_HEATER_AUX_POWER 41     // Pin virtual potencia calefactor auxiliar (V41)
-#define BLYNK_VPIN_HEATER_AUTO_MODE 42     // Pin virtual modo automático (V42)
+#define BLYNK_VPIN_HEATER_AUX_STATE 51     // Pin virtual estado calefactor auxiliar (V51)
+#define BLYNK_VPIN_HEATER_AUX_POWER 52     // Pin virtual potencia calefactor auxiliar (V52)
+#define BLYNK_VPIN_HEATER_AUTO_MODE 53     // Pin virtual modo automático (V53)
+
+// ===== CONFIGURACIÓN AUTOAJUSTE PID (relé Åström–Hägglund) =====
+
+#define AUTOTUNE_TEMP_HYSTERESIS 0.2       // Histéresis del relé de temperatura (°C)
+#define AUTOTUNE_HUMIDITY_HYSTERESIS 1.0   // Histéresis del relé de humedad (%)
+#define AUTOTUNE_CYCLES 3                  // Ciclos estables necesarios para el ajuste
+#define AUTOTUNE_TIMEOUT 14400000          // Tiempo máximo del autoajuste (4 horas)
+#define AUTOTUNE_PREFS_NAMESPACE "pidtune" // Espacio NVS antiguo de las ganancias (se importa a SETTINGS_PREFS_NAMESPACE)
+
+// Pines virtuales Blynk para autoajuste
+#define BLYNK_VPIN_AUTOTUNE_TEMPERATURE 48 // Iniciar/cancelar autoajuste de temperatura (V48)
+#define BLYNK_VPIN_AUTOTUNE_HUMIDITY 49    // Iniciar/cancelar autoajuste de humedad (V49)
+#define BLYNK_VPIN_AUTOTUNE_STATUS 50      // Estado del autoajuste (V50)
 
 // ===== CONFIGURACIÓN BOMBA DE AGUA =====
 
 // Pin de control
-#define WATER_PUMP_PIN 19                  // Pin del relé para bomba de agua
+#define WATER_PUMP_PIN 26                  // Pin del relé para bomba de agua
 
 // Configuración temporal (en segundos)
 #define WATER_PUMP_MAX_RUN_TIME 300        // Tiempo máximo funcionamiento continuo (5 min)
@@ -250,9 +306,191 @@
 #define WATER_PUMP_SAFETY_TIMEOUT true     // Habilitar timeout de seguridad
 
 // Pines virtuales Blynk para bomba de agua
-#define BLYNK_VPIN_WATER_PUMP_STATE 43     // Pin virtual estado bomba (V43)
-#define BLYNK_VPIN_WATER_PUMP_MODE 44      // Pin virtual modo automático (V44)
-#define BLYNK_VPIN_WATER_PUMP_TIMER 45     // Pin virtual programador (V45)
-#define BLYNK_VPIN_WATER_PUMP_STATS 46     // Pin virtual estadísticas (V46)
+#define BLYNK_VPIN_WATER_PUMP_STATE 54     // Pin virtual estado bomba (V54)
+#define BLYNK_VPIN_WATER_PUMP_MODE 55      // Pin virtual modo automático (V55)
+#define BLYNK_VPIN_WATER_PUMP_TIMER 56     // Pin virtual programador (V56)
+#define BLYNK_VPIN_WATER_PUMP_STATS 57     // Pin virtual estadísticas (V57)
+
+// ===== CONFIGURACIÓN PLANIFICADOR DE RIEGO (horizonte deslizante) =====
+
+#define IRRIGATION_PLANNER_SAMPLE_INTERVAL 300000 // Muestreo de humedad para el ajuste (5 minutos)
+#define IRRIGATION_PLANNER_SETTLE_TIME 600000     // Espera tras riego antes de medir la respuesta (10 min)
+#define IRRIGATION_PLANNER_HORIZON 21600000       // Horizonte de predicción (6 horas)
+#define IRRIGATION_PLANNER_LEAD_TIME 120000       // Antelación del pulso respecto al cruce previsto (2 min)
+#define IRRIGATION_PLANNER_MARGIN 1.0             // Margen inicial sobre el límite inferior (%), antes de aprender el modelo
+#define IRRIGATION_PLANNER_MIN_MARGIN 0.15        // Margen fijo que queda cuando los pulsos llegan siempre a tiempo (%)
+#define IRRIGATION_PLANNER_MARGIN_DECAY 0.9       // Reducción del margen aprendido por cada pulso que llega a tiempo
+#define IRRIGATION_PLANNER_RESIDUAL_MOISTURE 10.0 // Humedad residual asintótica del suelo (%)
+#define IRRIGATION_PLANNER_DEFAULT_GAIN 0.2       // Respuesta inicial del suelo (% humedad por segundo de bomba)
+#define IRRIGATION_PLANNER_MIN_PULSE 10           // Pulso mínimo de riego (segundos)
+#define IRRIGATION_PLANNER_MIN_RISE 1.0           // Subida mínima de humedad por pulso (%): acota los arranques de bomba
+#define IRRIGATION_PLANNER_MERGE_WINDOW 3600000   // Pulso previsto que se adelanta para compartir la bomba con otra zona (1 hora)
+
+// ===== CONFIGURACIÓN RIEGO MULTIZONA =====
+
+// Zonas de riego: cada zona abre su válvula (canal del relé multicanal) y
+// comparte la única bomba de agua. Canales numerados desde 1 como RELAY_PIN_x
+#define IRRIGATION_ZONE_COUNT 2                   // Número de zonas (máximo 8)
+#define IRRIGATION_ZONE_1_RELAY 6                 // Zona 1 -> relé 6 (RELAY_PIN_6)
+#define IRRIGATION_ZONE_2_RELAY 7                 // Zona 2 -> relé 7 (RELAY_PIN_7)
+
+#define IRRIGATION_VALVE_SETTLE_TIME 2000         // Apertura/cierre de válvula antes/después de la bomba (ms)
+#define IRRIGATION_VALVE_OVERLAP 1000             // Solape entre válvulas al encadenar zonas (ms)
+#define IRRIGATION_PUMP_MAX_CONTINUOUS 1800000    // Marcha continua máxima de la bomba encadenando zonas (30 min)
+#define IRRIGATION_PUMP_REST_TIME 60000           // Descanso de la bomba tras alcanzar el máximo (1 min)
+
+// ===========================================
+// CONFIGURACIÓN DE HORA (SNTP / RTC)
+// ===========================================
+
+#define TIME_NTP_SERVER_1 "pool.ntp.org"          // Servidor SNTP principal
+#define TIME_NTP_SERVER_2 "time.google.com"       // Servidor SNTP secundario
+#define TIME_TIMEZONE "CET-1CEST,M3.5.0,M10.5.0/3" // Zona horaria POSIX (España peninsular)
+#define TIME_SYNC_INTERVAL 3600000                // Re-sincronización con la fuente principal (1 hora)
+#define TIME_RETRY_INTERVAL 10000                 // Reintento mientras no hay hora de la fuente principal (10 s)
+#define TIME_MIN_VALID_EPOCH 1704067200           // 2024-01-01: un reloj anterior no está en hora
+#define TIME_MIN_DRIFT_WINDOW 600000              // Tiempo mínimo entre sincronizaciones para medir deriva (10 min)
+#define TIME_MAX_DRIFT_PPM 500.0                  // Deriva máxima aceptada del reloj local (ppm)
+#define TIME_DAY_START_HOUR 7                     // Inicio del periodo diurno (ventilación)
+#define TIME_DAY_END_HOUR 20                      // Fin del periodo diurno
+
+// ===========================================
+// CONFIGURACIÓN PERSISTENTE (NVS)
+// ===========================================
+
+#define SETTINGS_PREFS_NAMESPACE "settings"       // Espacio NVS de targets y ajustes de control
+#define SETTINGS_VERSION 1                        // Versión del registro (cambiar si cambia su formato)
+#define SETTINGS_FLUSH_DELAY 30000                // Escritura tras el último cambio (30 s, agrupa los deslizadores)
+
+// ===========================================
+// CONFIGURACIÓN SERVIDOR WEB LOCAL
+// ===========================================
+
+#define WEB_SERVER_PORT 80                        // Puerto del panel y la API JSON
+#define WEB_STATIC_PATH "/www/"                   // Ficheros del panel en LittleFS (index.html.gz)
+#define WEB_STATIC_CACHE "max-age=86400"          // Caché de los ficheros estáticos (1 día)
+#define WEB_SNAPSHOT_INTERVAL 250                 // Copia de sensores y actuadores: API y trama del canal en vivo (250 ms)
+#define WEB_HISTORY_INTERVAL 60000                // Muestreo del histórico (1 minuto)
+#define WEB_HISTORY_SIZE 120                      // Muestras del histórico (2 horas)
+#define WEB_JSON_MAX_SIZE 1024                    // Tamaño máximo de una respuesta JSON (bytes)
+#define WEB_HISTORY_JSON_MAX_SIZE 10240           // Tamaño máximo de la respuesta del histórico (bytes)
+#define WEB_MAX_BODY_SIZE 512                     // Tamaño máximo del cuerpo de PUT /api/targets
+#define WEB_METRICS_PATH "/metrics"               // Métricas para Prometheus (texto, respuesta por trozos)
+#define WEB_LIVE_PATH "/ws"                       // WebSocket con los cambios en vivo
+#define WEB_LIVE_MAX_CLIENTS 4                    // Clientes simultáneos del canal en vivo
+#define WEB_LIVE_MAX_MESSAGE 768                  // Tamaño máximo de un mensaje del canal en vivo (bytes)
+// La cola por cliente la limita WS_MAX_QUEUED_MESSAGES (platformio.ini); un cliente con la cola llena se desconecta
+
+// ===========================================
+// CONFIGURACIÓN TELEMETRÍA (MQTT)
+// ===========================================
+
+#define TELEMETRY_INTERVAL 10000                  // Muestreo enviado a los destinos de telemetría (10 s)
+#define TELEMETRY_MAX_SINKS 2                     // Destinos de telemetría simultáneos
+#define TELEMETRY_MAX_FRAME 112                   // Tamaño máximo de una trama binaria (bytes)
+
+#define MQTT_ENABLED false                        // Publicar telemetría por MQTT (además de Blynk)
+#define MQTT_BROKER_HOST "mqtt.local"             // Broker (Home Assistant, mosquitto...)
+#define MQTT_BROKER_PORT 1883
+#define MQTT_TOPIC_PREFIX "greenhouse"            // Temas: <prefijo>/<nodo>/t, /schema, /status
+#define MQTT_NODE_ID "invernadero-1"              // Identificador de cliente y de nodo en los temas
+#define MQTT_KEEP_ALIVE 30                        // Keep alive (s)
+#define MQTT_RECONNECT_INTERVAL 10000             // Intento de conexión al broker (10 s)
+#define MQTT_RETRY_INTERVAL 15000                 // Reenvío de una trama sin PUBACK (15 s)
+#define MQTT_OUTBOX_SIZE 16                       // Tramas guardadas sin confirmar (2,7 min a 10 s)
+#define MQTT_MAX_INFLIGHT 4                       // Tramas enviadas sin PUBACK a la vez
+#define MQTT_SCHEMA_MAX_SIZE 1536                 // Tamaño máximo del JSON de canales (bytes)
+
+// ===========================================
+// CONFIGURACIÓN MODBUS (ESCLAVO TCP / RTU)
+// ===========================================
+
+// Mapa de registros en include/modbus/ModbusRegisterMap.h y docs/modbus.md
+#define MODBUS_UNIT_ID 1                          // Dirección de esclavo (RTU; en TCP se responde a cualquiera)
+#define MODBUS_IMAGE_INTERVAL 250                 // Conversión de datos a la imagen de registros (250 ms)
+#define MODBUS_MAX_PENDING_WRITES 16              // Escrituras aceptadas pendientes de aplicar en el loop
+
+#define MODBUS_TCP_ENABLED true                   // Esclavo Modbus TCP por WiFi
+#define MODBUS_TCP_PORT 502
+#define MODBUS_TCP_MAX_CLIENTS 2                  // Conexiones simultáneas (SCADA + ingeniería)
+#define MODBUS_TCP_BUFFER_SIZE 520                // Búfer de recepción por conexión (dos peticiones máximas)
+#define MODBUS_TCP_IDLE_TIMEOUT 60                // Cierre de una conexión sin peticiones (s)
+
+#define MODBUS_RTU_ENABLED false                  // Esclavo Modbus RTU en UART1 (UART2 es el sensor RS485)
+#define MODBUS_RTU_BAUD 19200
+#define MODBUS_RTU_RX_PIN 34                      // Pin GPIO RX (GPIO 34, solo entrada)
+#define MODBUS_RTU_TX_PIN 23                      // Pin GPIO TX (GPIO 23)
+#define MODBUS_RTU_DE_PIN 15                      // Pin GPIO DE/RE del transceptor (GPIO 15)
+#define MODBUS_RTU_IDLE_GAP 20                    // Silencio que cierra una trama de función desconocida (ms)
+
+// ===========================================
+// ARRANQUE
+// ===========================================
+
+#define BOOT_SENSOR_TIMEOUT 10000                 // Control local aunque no haya lecturas mínimas (10 s desde el encendido)
+
+// ===========================================
+// PERFILADOR DEL LOOP
+// ===========================================
+
+#define LOOP_PROFILER_ENABLED true                // false = sin instrumentación (el compilador elimina las medidas)
+#define LOOP_PROFILER_BUDGET_US 50000             // Trabajo máximo de una iteración; por encima cuenta como desborde (50 ms)
+#define LOOP_PROFILER_REPORT_INTERVAL 300000      // Informe por Serial (5 min, 0 = solo GET /api/profile)
+#define WEB_PROFILE_JSON_MAX_SIZE 2560            // Tamaño máximo de la respuesta de /api/profile (bytes)
+
+// ===========================================
+// ENERGÍA (espera adaptativa del loop y sueño ligero)
+// ===========================================
+
+#define POWER_MIN_SLEEP 5                         // Espera mínima entre iteraciones del loop (ms)
+#define POWER_MAX_SLEEP 20000                     // Espera máxima aunque ningún subsistema tenga trabajo antes (ms, < WATCHDOG_TASK_TIMEOUT)
+#define POWER_BUSY_POLL_INTERVAL 100              // Arranque y riego en curso: secuencias de menos de un segundo (ms)
+#define POWER_NETWORK_POLL_INTERVAL 1000          // Blynk.run, reconexiones WiFi/MQTT y refresco del panel web (ms)
+#define POWER_SENSOR_RETRY_INTERVAL 1000          // Reintento de un sensor cuya lectura ha fallado (ms)
+#define POWER_LIGHT_SLEEP_ENABLED true            // Sueño ligero automático (requiere CONFIG_PM_ENABLE y tickless idle)
+#define POWER_CPU_MAX_MHZ 240                     // Frecuencia con trabajo (gestión dinámica de frecuencia)
+#define POWER_CPU_MIN_MHZ 80                      // Frecuencia en reposo; 80 MHz mantiene el APB de LEDC, UART e I2C
+#define POWER_WIFI_SLEEP WIFI_PS_MIN_MODEM        // Modem sleep del WiFi (WIFI_PS_MAX_MODEM: menos consumo, más latencia)
+
+// ===========================================
+// SUPERVISOR (watchdog y diagnóstico de bloqueos)
+// ===========================================
+
+#define WATCHDOG_ENABLED true                     // false = sin watchdog del loop ni plazos por subsistema
+#define WATCHDOG_TASK_TIMEOUT 30                  // Task watchdog del loop: último recurso si el plazo de la etapa no salta (s)
+// Plazo de cada etapa de SystemManager::update(); al superarlo se guarda el diagnóstico y se reinicia (ms)
+#define WATCHDOG_DEADLINE_TIME 1000               // Hora local y eventos de calendario
+#define WATCHDOG_DEADLINE_SETTINGS 2000           // Escritura de targets en NVS
+#define WATCHDOG_DEADLINE_WIFI 15000              // Reconexión WiFi; onWiFiConnect espera a Blynk hasta 10 s
+#define WATCHDOG_DEADLINE_BLYNK 15000             // Reconexión de Blynk y Blynk.run()
+#define WATCHDOG_DEADLINE_SENSORS 8000            // Timeouts del RS485 (1 s por registro), pulseIn del HC-SR04
+#define WATCHDOG_DEADLINE_ACTUATORS 2000          // Paso del servo y límites de funcionamiento
+#define WATCHDOG_DEADLINE_LOGIC 8000              // Incluye los fundidos bloqueantes de la tira LED
+#define WATCHDOG_DEADLINE_WEB 2000                // Imagen para el panel web y cambios recibidos
+#define WATCHDOG_DEADLINE_TELEMETRY 5000          // Envío MQTT con el broker lento
+#define WATCHDOG_DEADLINE_MODBUS 2000             // Imagen de registros y tramas RTU
+#define WATCHDOG_DEADLINE_LOOP 2000               // Fin de la iteración: informe del perfilador y cálculo de la espera
+#define WATCHDOG_SLEEP_MARGIN 5000                // Margen sobre POWER_MAX_SLEEP para la espera del loop (ms)
+
+// ===========================================
+// ARRANQUE EN CALIENTE (estado en memoria RTC)
+// ===========================================
+
+#define SNAPSHOT_ENABLED true                     // false = cada reinicio empieza con todo apagado, como el encendido
+#define SNAPSHOT_MIN_RESUME 10                    // Riego interrumpido: con menos tiempo pendiente se da por terminado (s)
+
+// ===========================================
+// TRAZA DE SENSORES (grabación para reproducir en el PC)
+// ===========================================
+
+#define SENSOR_TRACE_OFF 0
+#define SENSOR_TRACE_SERIAL 1                     // Líneas "#T " en hexadecimal entre los mensajes de consola
+#define SENSOR_TRACE_FILE 2                       // Fichero binario en LittleFS
+#define SENSOR_TRACE_OUTPUT SENSOR_TRACE_OFF
+#define SENSOR_TRACE_PATH "/trace.bin"            // Traza del arranque actual
+#define SENSOR_TRACE_PREVIOUS_PATH "/trace.prev.bin" // Traza del arranque anterior (se conserva una)
+#define SENSOR_TRACE_MAX_BYTES 524288             // Tamaño máximo del fichero; al llegar se detiene (512 KB)
+#define SENSOR_TRACE_TIME_INTERVAL 600000         // Registro de hora y vaciado del fichero (10 min)
+#define SENSOR_TRACE_SENSORS 0x3D                 // Sensores grabados (bit = Metrics::Sensor); sin AS7341, que no usa el control
 
 #endif
@@ -11,4 +11,8 @@ const char* WIFI_PASSWORD = "---";
 // Credenciales Blynk
 const char* BLYNK_AUTH_TOKEN = "---";
 
+// Credenciales MQTT (nullptr = broker sin autenticación)
+const char* MQTT_USER = nullptr;
+const char* MQTT_PASSWORD = nullptr;
+
 #endif
@@ -0,0 +1,70 @@
+#ifndef FIXED_POINT_H
+#define FIXED_POINT_H
+
+#include <Arduino.h>
+
+/**
+ * FixedPoint - Número en coma fija con signo sobre int32_t (formato Q(31-F).F)
+ * Permite ejecutar PIDController sin operaciones en coma flotante
+ * Por defecto Q16.16: rango ±32768 y resolución ~0.000015
+ */
+template <int FracBits = 16>
+class FixedPoint {
+    static_assert(FracBits > 0 && FracBits < 31, "FracBits must be in 1..30");
+
+private:
+    int32_t value;
+
+    struct RawTag {};
+    constexpr FixedPoint(int32_t raw, RawTag) : value(raw) {}
+
+    static constexpr int32_t saturate(int64_t v) {
+        return v > INT32_MAX ? INT32_MAX : (v < INT32_MIN ? INT32_MIN : (int32_t)v);
+    }
+
+public:
+    static constexpr int32_t ONE = (int32_t)1 << FracBits;
+
+    constexpr FixedPoint() : value(0) {}
+    constexpr FixedPoint(int v) : value(saturate((int64_t)v * ONE)) {}
+    constexpr FixedPoint(unsigned int v) : value(saturate((int64_t)v * ONE)) {}
+    constexpr FixedPoint(long v) : value(saturate((int64_t)v * ONE)) {}
+    constexpr FixedPoint(unsigned long v) : value(saturate((int64_t)v * ONE)) {}
+    constexpr FixedPoint(float v) : value(saturate((int64_t)(v * ONE + (v >= 0 ? 0.5f : -0.5f)))) {}
+    constexpr FixedPoint(double v) : value(saturate((int64_t)(v * ONE + (v >= 0 ? 0.5 : -0.5)))) {}
+
+    static constexpr FixedPoint fromRaw(int32_t raw) { return FixedPoint(raw, RawTag()); }
+    constexpr int32_t raw() const { return value; }
+
+    constexpr float toFloat() const { return (float)value / ONE; }
+    constexpr explicit operator float() const { return toFloat(); }
+    constexpr explicit operator int32_t() const { return value / ONE; }
+
+    // Arithmetic saturates instead of wrapping so controller state cannot flip sign
+    constexpr FixedPoint operator+(FixedPoint o) const { return fromRaw(saturate((int64_t)value + o.value)); }
+    constexpr FixedPoint operator-(FixedPoint o) const { return fromRaw(saturate((int64_t)value - o.value)); }
+    constexpr FixedPoint operator-() const { return fromRaw(saturate(-(int64_t)value)); }
+    constexpr FixedPoint operator*(FixedPoint o) const {
+        return fromRaw(saturate(((int64_t)value * o.value) >> FracBits));
+    }
+    constexpr FixedPoint operator/(FixedPoint o) const {
+        return o.value == 0 ? fromRaw(value >= 0 ? INT32_MAX : INT32_MIN)
+                            : fromRaw(saturate(((int64_t)value * ONE) / o.value));
+    }
+
+    FixedPoint& operator+=(FixedPoint o) { return *this = *this + o; }
+    FixedPoint& operator-=(FixedPoint o) { return *this = *this - o; }
+    FixedPoint& operator*=(FixedPoint o) { return *this = *this * o; }
+    FixedPoint& operator/=(FixedPoint o) { return *this = *this / o; }
+
+    constexpr bool operator<(FixedPoint o) const { return value < o.value; }
+    constexpr bool operator>(FixedPoint o) const { return value > o.value; }
+    constexpr bool operator<=(FixedPoint o) const { return value <= o.value; }
+    constexpr bool operator>=(FixedPoint o) const { return value >= o.value; }
+    constexpr bool operator==(FixedPoint o) const { return value == o.value; }
+    constexpr bool operator!=(FixedPoint o) const { return value != o.value; }
+};
+
+typedef FixedPoint<16> Q16_16;
+
+#endif
@@ -2,6 +2,8 @@
 #define HUMIDITY_CONTROL_H
 
 #include <Arduino.h>
+#include "PIDController.h"
+#include "FixedPoint.h"
 
 /**
  * HumidityControl - Control de humedad automático para invernadero
@@ -14,10 +16,10 @@ private:
     float currentHumidity;
     float tolerance;
     
-    // Control variables
-    float previousError;
-    float errorSum;
-    float kp, ki, kd; // Control constants
+    // Control variables (output > 0 humidify, < 0 dehumidify, ±100%)
+    // Relative humidity stays within 0-100, well inside the Q16.16 range
+    PIDController<Q16_16> pid;
+    bool humidifierInstalled;
     
     // Humidity limits
     float minHumidity, maxHumidity;
@@ -25,8 +27,16 @@ private:
     
     // Timing
     unsigned long lastUpdate;
-    unsigned long lastAction;
-    const unsigned long MIN_ACTION_INTERVAL = 30000; // 30 segundos mínimo entre acciones
+    
+    // Time-proportioning fan output (slow PWM for the relay), like the heater
+    unsigned long fanWindowSize;
+    unsigned long fanMinSwitchTime;
+    unsigned long fanWindowStart;
+    unsigned long fanOnTime;
+    float fanDuty; // 0-100%
+    float humidifierDuty; // 0-100%, only with a humidifier installed
+    bool fanOutput;
+    bool fanPulseDone; // ON pulse of the current window already delivered
     
     // Status
     bool enabled;
@@ -56,6 +66,7 @@ public:
     void setControlConstants(float p, float i, float d);
     void setHumidityLimits(float min, float max);
     void setCriticalLimits(float criticalLow, float criticalHigh);
+    void setFanWindow(unsigned long windowMs, unsigned long minSwitchMs);
     
     // Environmental context
     void setDaytimeStatus(bool isDay);
@@ -64,6 +75,7 @@ public:
     // Control
     void enable();
     void disable();
+    void resetControl(); // Restart PID and fan window, e.g. after an autotune relay experiment
     bool isEnabled() const;
     
     // Status
@@ -76,9 +88,18 @@ public:
     bool isCriticalCondition() const;
     
     // Control output
-    float getControlOutput();
+    float getControlOutput() const;
     int getVentilationLevel(); // 0-100%
     
+    // Fan relay output (time-proportioning of the dehumidifying PID output)
+    bool isFanOutputOn() const;
+    float getFanDuty() const;
+    float getHumidifierDuty() const;
+
+    // Integral term, kept across warm restarts (StateSnapshot)
+    float getIntegralTerm() const;
+    void restoreIntegralTerm(float integral);
+    
     // Statistics
     unsigned long getTotalActiveTime() const;
     unsigned int getAdjustmentCount() const;
@@ -93,6 +114,9 @@ public:
     // Advanced features
     void adaptToWeather(bool isRaining, float outsideHumidity = -1);
     float calculateIdealHumidity(float temperature) const;
+
+private:
+    void updateFanOutput(unsigned long currentTime, float duty);
 };
 
 #endif
@@ -2,11 +2,16 @@
 #define IRRIGATION_CONTROL_H
 
 #include <Arduino.h>
+#include "IrrigationPlanner.h"
+#include "ScheduleTable.h"
+#include "../system/StateSnapshot.h"
 
 /**
  * IrrigationControl - Control de riego automático para invernadero
  * Implementa algoritmos de riego inteligente basado en humedad del suelo
  * Basado en sistemas de agricultura de precisión y riego por goteo
+ * Las decisiones las toma un planificador predictivo (IrrigationPlanner);
+ * mientras no hay modelo de secado se usa la política reactiva
  */
 class IrrigationControl {
 private:
@@ -26,12 +31,22 @@ private:
     IrrigationSchedule morningSchedule;
     IrrigationSchedule eveningSchedule;
     IrrigationSchedule emergencySchedule;
+    int lastScheduledMinute; // Minuto del día del último riego programado (-1 = ninguno)
+    
+    // Compiled sessions: one-minute windows, value = duration in seconds
+    static const uint8_t RULE_MORNING = 0;
+    static const uint8_t RULE_EVENING = 1;
+    ScheduleTable scheduleTable;
     
     // Control variables
     float previousMoisture;
     float moistureRate; // Rate of change
     unsigned long lastMoistureCheck;
     
+    // Receding-horizon planner (falls back to reactive control without a model)
+    IrrigationPlanner planner;
+    bool plannerEnabled;
+    
     // Irrigation parameters
     unsigned int defaultIrrigationDuration; // segundos
     unsigned int maxIrrigationDuration;
@@ -49,6 +64,10 @@ private:
     unsigned long currentIrrigationStart;
     bool irrigationActive;
     
+    // Multizona: la sesión espera a que el secuenciador abra la válvula
+    bool deferredStart;
+    unsigned int requestedDuration; // segundos, 0 = sin petición
+    
     // Environmental factors
     float temperatureFactor;
     float humidityFactor;
@@ -77,7 +96,8 @@ public:
     IrrigationControl();
     
     bool begin();
-    void update(float currentMoisture, float temperature = -1, float humidity = -1, float lightLevel = -1);
+    void update(float currentMoisture, float temperature = -1, float humidity = -1, float lightLevel = -1,
+                uint8_t currentHour = 255, uint8_t currentMinute = 255, uint8_t currentWeekDay = 255);
     
     // Configuration
     void setTarget(float targetMoisture);
@@ -92,10 +112,13 @@ public:
     void setSoilRetentionCapacity(float capacity);
     void setPlantWaterConsumption(float consumption);
     void setWaterFlowRate(float flowRate);
+    float getWaterFlowRate() const;
     
     // Scheduling
     void setMorningSchedule(uint8_t hour, uint8_t minute, unsigned int duration, uint8_t weekDays = 0b01111111);
     void setEveningSchedule(uint8_t hour, uint8_t minute, unsigned int duration, uint8_t weekDays = 0b01111111);
+    int8_t addScheduledSession(uint8_t hour, uint8_t minute, unsigned int duration, uint8_t weekDays = 0b01111111);
+    uint16_t getMinutesToNextSession(uint8_t weekDay, uint8_t hour, uint8_t minute) const;
     void enableSchedule(bool enable);
     bool isScheduleEnabled() const;
     
@@ -113,6 +136,14 @@ public:
     void stopIrrigation();
     void emergencyIrrigation();
     
+    // Deferred start (shared pump, see IrrigationScheduler)
+    void setDeferredStart(bool deferred);
+    unsigned int getRequestedDuration() const;
+    bool confirmIrrigationStart();
+    void cancelIrrigationRequest();
+    // Brings a planned pulse due within IRRIGATION_PLANNER_MERGE_WINDOW forward into the pump run of another zone
+    bool joinPumpRun();
+    
     // Status
     float getCurrentSoilMoisture() const;
     float getMoistureDeficit() const;
@@ -136,6 +167,15 @@ public:
     void resetDailyStatistics();
     void resetStatistics();
     
+    // Planner (disabled: morning/evening sessions and reactive policy only)
+    const IrrigationPlanner& getPlanner() const;
+    void enablePlanner(bool enable);
+    bool isPlannerEnabled() const;
+    
+    // Warm restart (StateSnapshot): last irrigation and the session the reset interrupted
+    void saveState(StateSnapshot::Zone& state) const;
+    void restoreState(const StateSnapshot::Zone& state);
+    
     // Status string
     String getStatusString() const;
     String getScheduleString() const;
@@ -152,9 +192,13 @@ public:
     
 private:
     bool shouldIrrigateNow() const;
-    bool isScheduledTime(uint8_t currentHour, uint8_t currentMinute) const;
+    bool isScheduledTime(uint8_t currentWeekDay, uint8_t currentHour, uint8_t currentMinute) const;
+    void compileSchedule(uint8_t rule, const IrrigationSchedule& schedule);
     bool isValidIrrigationTime() const;
     float calculateAdjustedDuration() const;
+    void beginIrrigationSession(float durationSeconds);
+    void activateSession(unsigned int durationSeconds);
+    void configurePlanner();
     void updateEvapotranspiration(float temperature, float humidity, float light);
 };
 
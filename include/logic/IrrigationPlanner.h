@@ -0,0 +1,102 @@
+#ifndef IRRIGATION_PLANNER_H
+#define IRRIGATION_PLANNER_H
+
+#include <Arduino.h>
+
+/**
+ * IrrigationPlanner - Planificador de riego predictivo (horizonte deslizante)
+ * Ajusta la curva de secado del suelo a partir del historial de humedad:
+ *     m(t) = r + (m0 - r)·e^(-k·t)     (r = humedad residual)
+ * y predice cuándo la humedad cruzará el límite inferior (objetivo - tolerancia).
+ * El nivel actual y el secado más reciente salen de las muestras tomadas desde
+ * el último riego, que siguen mejor la aceleración del secado a mediodía.
+ * En cada actualización vuelve a planificar un único pulso, justo antes del
+ * cruce, que repone el secado previsto hasta el siguiente pulso: el que cabe
+ * hasta la siguiente oportunidad de riego (intervalo mínimo) y nunca menos de
+ * una subida mínima, para no arrancar la bomba por décimas de humedad.
+ * Mantener el suelo cerca del límite inferior reduce las pérdidas, que crecen
+ * con la humedad.
+ *
+ * La respuesta del suelo (% por segundo de bomba) se aprende de cada riego. El
+ * margen sobre el límite empieza holgado y se estrecha con cada pulso que
+ * encuentra el suelo aún en banda; si lo encuentra por debajo (secado más
+ * rápido que el ajustado, espera de la bomba compartida) se abre otra vez.
+ * Una instancia por zona de riego.
+ */
+class IrrigationPlanner {
+private:
+    static const uint8_t MAX_SAMPLES = 24;     // 2 horas a 5 minutos
+    static const uint8_t MIN_FIT_SAMPLES = 6;
+    static const uint8_t MIN_RECENT_SAMPLES = 3;
+
+    // Drying curve history (rescaled onto the new curve after each irrigation)
+    unsigned long sampleTimes[MAX_SAMPLES];
+    float sampleValues[MAX_SAMPLES];
+    uint8_t sampleCount;
+    uint8_t sampleHead;
+    uint8_t segmentSamples;      // Samples taken since the last pulse soaked in
+    unsigned long lastSampleTime;
+
+    // Limits
+    float lowerBound;
+    float upperBound;
+    unsigned long minInterval;   // ms between pulses
+    unsigned int maxPulse;       // s
+
+    // Model
+    bool modelValid;
+    float decayRate;             // k, 1/h
+    float recentDecayRate;       // k over the samples since the last pulse: follows drying that speeds up
+    float anchorMoisture;        // Fitted moisture at anchorTime
+    unsigned long anchorTime;
+    float responseGain;          // % moisture per second of pumping
+    bool gainMeasured;           // responseGain comes from a measured pulse, not the default
+    float learnedMargin;         // % above lowerBound, from the soil found below it at pulse start
+    bool holdingBound;           // The last pulse started near the bound (not filling a dry soil up)
+
+    // Pending pulse response
+    bool awaitingResponse;
+    unsigned long pulseStart;
+    unsigned int pulseSeconds;
+    float moistureBeforePulse;
+
+    // Current plan
+    bool pulsePlanned;
+    unsigned long nextPulseTime;
+    unsigned int plannedPulse;   // s
+    long timeToCrossing;         // ms, -1 if not within the horizon
+
+    void fitSegment();
+    bool fitDecay(uint8_t count, float& rate, float& intercept) const;
+    void learnResponse(float moisture, unsigned long currentTime);
+
+public:
+    IrrigationPlanner();
+
+    void configure(float lower, float upper, unsigned long minIntervalMs, unsigned int maxPulseSeconds);
+    void reset();
+
+    // Feed the soil moisture reading (internally downsampled)
+    void addSample(float moisture, unsigned long currentTime);
+    // Report any irrigation (planned, manual or emergency)
+    void notifyIrrigation(unsigned int seconds, float moistureBefore, unsigned long currentTime);
+
+    // Receding-horizon step: recompute the next pulse
+    void plan(unsigned long currentTime, unsigned long lastIrrigationTime);
+    // advance > 0: the planned pulse is due within that time (to share a pump run)
+    bool shouldIrrigateNow(unsigned long currentTime, unsigned long advance = 0) const;
+
+    // Model status
+    bool hasModel() const;
+    float getDecayRate() const;      // 1/h
+    float getResponseGain() const;   // %/s
+    float getLearnedMargin() const;  // %
+    float predictMoisture(unsigned long atTime) const;
+    long getTimeToCrossing() const;  // ms, -1 if none within horizon
+    bool isPulsePlanned() const;
+    unsigned long getNextPulseTime() const;
+    unsigned int getPlannedPulse() const;
+    String getStatusString(unsigned long currentTime) const;
+};
+
+#endif
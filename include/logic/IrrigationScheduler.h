@@ -0,0 +1,103 @@
+#ifndef IRRIGATION_SCHEDULER_H
+#define IRRIGATION_SCHEDULER_H
+
+#include <Arduino.h>
+#include "IrrigationControl.h"
+#include "../actuators/WaterPumpActuator.h"
+#include "../actuators/RelayController.h"
+
+/**
+ * IrrigationScheduler - Secuenciador de riego multizona con bomba compartida
+ * Cada zona tiene su propio IrrigationControl (humedad y planificador) y una
+ * válvula en el relé multicanal. Las zonas solicitan riego y el secuenciador:
+ * - Abre una sola válvula cada vez (cola FIFO de peticiones)
+ * - Abre la válvula antes de arrancar la bomba y la cierra después de pararla
+ * - Encadena zonas consecutivas sin parar la bomba (solape de válvulas)
+ * - Respeta la marcha continua máxima de la bomba con un descanso
+ * - Contabiliza el volumen de agua entregado a cada zona
+ */
+class IrrigationScheduler {
+public:
+    static const uint8_t MAX_ZONES = 8;
+    static const int8_t NO_ZONE = -1;
+
+private:
+    enum State {
+        STATE_IDLE,
+        STATE_OPENING,   // Valve open, pump about to start
+        STATE_RUNNING,   // Pump on, active zone watering
+        STATE_DRAINING,  // Pump off, valve about to close
+        STATE_RESTING    // Pump hit its continuous limit, waiting
+    };
+
+    struct Zone {
+        IrrigationControl* control;
+        uint8_t relayChannel;
+        String name;
+        bool queued;
+        unsigned long runStart;
+        unsigned long runDuration; // ms
+        float totalVolume;         // ml
+        float dailyVolume;         // ml
+        unsigned int runCount;
+    };
+
+    Zone zones[MAX_ZONES];
+    uint8_t zoneCount;
+
+    // FIFO of zone indexes waiting for their valve
+    uint8_t queue[MAX_ZONES];
+    uint8_t queueHead;
+    uint8_t queueSize;
+
+    WaterPumpActuator* pump;
+    RelayController* valves;
+
+    State state;
+    unsigned long stateSince;
+    int8_t activeZone;
+    int8_t closingZone;       // Previous zone during the valve overlap
+    unsigned long closingAt;
+    bool restPending;         // Next zone refused: pump reached its continuous limit
+    unsigned long lastUpdate;
+    unsigned int pumpStarts;
+
+    bool enqueue(uint8_t zone);
+    int8_t dequeue();
+    void startZone(uint8_t zone, unsigned long currentTime);
+    void finishZone(uint8_t zone);
+    bool pumpHasRoomFor(uint8_t zone) const;
+    void setState(State newState, unsigned long currentTime);
+
+public:
+    IrrigationScheduler();
+
+    bool begin(WaterPumpActuator* waterPump, RelayController* valveRelays);
+    int8_t addZone(IrrigationControl* control, uint8_t relayChannel, const String& name);
+
+    // Call every loop iteration (valve/pump timing is sub-second)
+    void update();
+
+    // Stop everything: pump off, all valves closed, queue cleared
+    void stopAll();
+
+    // Status
+    uint8_t getZoneCount() const;
+    IrrigationControl* getZoneControl(uint8_t zone) const;
+    int8_t getActiveZone() const;
+    uint8_t getQueuedZones() const;
+    bool isBusy() const;
+    bool hasNewRequests() const;   // Requests the next update() will queue
+    unsigned int getPumpStarts() const;
+
+    // Water accounting
+    float getZoneVolume(uint8_t zone) const;       // ml
+    float getZoneDailyVolume(uint8_t zone) const;  // ml
+    unsigned int getZoneRunCount(uint8_t zone) const;
+    float getTotalVolume() const;
+    void resetDailyVolumes();
+
+    String getStatusString() const;
+};
+
+#endif
@@ -2,6 +2,8 @@
 #define LIGHT_CONTROL_H
 
 #include <Arduino.h>
+#include "PIDController.h"
+#include "ScheduleTable.h"
 
 /**
  * LightControl - Control de iluminación automático para invernadero
@@ -33,12 +35,16 @@ private:
     LightSchedule morningSchedule;
     LightSchedule daySchedule;
     LightSchedule eveningSchedule;
-    LightSchedule nightSchedule;
+    LightSchedule nightSchedule; // Fuera de toda franja
     
-    // Control variables
-    float previousError;
-    float errorIntegral;
-    float kp, ki, kd;
+    // Compiled windows: morning, day and evening first, then user rules
+    static const uint8_t RULE_MORNING = 0;
+    static const uint8_t RULE_DAY = 1;
+    static const uint8_t RULE_EVENING = 2;
+    ScheduleTable scheduleTable;
+    
+    // Control variables (output = LED intensity 0-100%)
+    PIDController<float> pid;
     
     // Light limits
     float minLux, maxLux;
@@ -48,17 +54,21 @@ private:
     unsigned long lastUpdate;
     unsigned long lastAdjustment;
     const unsigned long MIN_ADJUST_INTERVAL = 10000; // 10 segundos
+    const float LED_ON_LEVEL = 5.0;  // % de PID para encender la tira
+    const float LED_OFF_LEVEL = 1.0; // % de PID para apagarla
     
     // Status
     bool enabled;
     bool artificialLightActive;
     bool photoperiodActive;
     bool isDaytime;
+    bool clockSynced; // Hora real disponible: el día lo marca el calendario
     
     // Environmental adaptation
     bool cloudinessDetection;
     float naturalLightLevel;
     float supplementalLightLevel;
+    float ledIntensity; // PID output, LED PWM 0-100%
     
     // Statistics
     unsigned long totalLightTime;
@@ -70,7 +80,8 @@ public:
     LightControl();
     
     bool begin();
-    void update(float currentLux, uint8_t currentHour = 255, uint8_t currentMinute = 255);
+    void update(float currentLux, uint8_t currentHour = 255, uint8_t currentMinute = 255,
+                uint8_t currentWeekDay = 255);
     
     // Configuration
     void setTarget(float targetLux);
@@ -87,6 +98,11 @@ public:
     void setDaySchedule(uint8_t startH, uint8_t startM, uint8_t endH, uint8_t endM, float intensity);
     void setEveningSchedule(uint8_t startH, uint8_t startM, uint8_t endH, uint8_t endM, float intensity);
     void setNightSchedule(uint8_t startH, uint8_t startM, uint8_t endH, uint8_t endM, float intensity);
+    // Franja adicional (p. ej. luz de fin de semana); rige fuera de mañana/día/tarde
+    int8_t addScheduleRule(uint8_t startH, uint8_t startM, uint8_t endH, uint8_t endM, float intensity,
+                           uint8_t weekDays = ScheduleTable::ALL_DAYS);
+    const ScheduleTable& getScheduleTable() const;
+    uint16_t getMinutesToNextScheduleChange(uint8_t weekDay, uint8_t hour, uint8_t minute) const;
     
     // Control modes
     void enable();
@@ -108,6 +124,11 @@ public:
     float getLEDIntensity() const; // 0-100%
     float getSupplementalLight() const;
     float getNaturalLight() const;
+    float getPIDOutput() const;
+
+    // Integral term, kept across warm restarts (StateSnapshot)
+    float getIntegralTerm() const;
+    void restoreIntegralTerm(float integral);
     
     // Statistics
     unsigned long getTotalLightTime() const;
@@ -130,8 +151,8 @@ public:
     bool checkEmergency() const;
     
 private:
-    LightSchedule getCurrentSchedule(uint8_t hour, uint8_t minute) const;
-    bool isTimeInSchedule(uint8_t hour, uint8_t minute, const LightSchedule& schedule) const;
+    LightSchedule getCurrentSchedule(uint8_t weekDay, uint8_t hour, uint8_t minute) const;
+    void compileSchedule(uint8_t rule, const LightSchedule& schedule);
     void updatePhotoperiod();
     float calculateOptimalIntensity(uint8_t hour, uint8_t minute) const;
 };
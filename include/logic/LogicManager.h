@@ -6,26 +6,52 @@
 #include "HumidityControl.h"
 #include "LightControl.h"
 #include "IrrigationControl.h"
+#include "IrrigationScheduler.h"
 #include "VentilationControl.h"
+#include "RelayAutotune.h"
 #include "../sensors/SensorManager.h"
 #include "../actuators/ActuatorManager.h"
 #include "../blynk/BlynkManager.h"
+#include "../system/TimeManager.h"
+#include "../system/Metrics.h"
+#include "../config/config.h"
+#include "../config/SettingsStore.h"
 
 class LogicManager {
+public:
+    // Control loop identified by the relay autotune
+    enum AutotuneLoop {
+        AUTOTUNE_NONE,
+        AUTOTUNE_TEMPERATURE,
+        AUTOTUNE_HUMIDITY
+    };
+
 private:
     TemperatureControl* temperatureControl;
     HumidityControl* humidityControl;
     LightControl* lightControl;
-    IrrigationControl* irrigationControl;
+    // One controller per irrigation zone, sharing the pump through the scheduler
+    IrrigationControl* irrigationZones[IRRIGATION_ZONE_COUNT];
+    IrrigationScheduler* irrigationScheduler;
     VentilationControl* ventilationControl;
     
+    // PID autotune (owns the heater or the fan while running)
+    RelayAutotune* autotune;
+    AutotuneLoop autotuneLoop;
+    
     SensorManager* sensorManager;
     ActuatorManager* actuatorManager;
     BlynkManager* blynkManager;
+    TimeManager* timeManager; // Optional: without it schedules stay idle
+    SettingsStore* settingsStore; // Optional: without it tuned gains are not kept
     
     unsigned long lastUpdate;
     const unsigned long UPDATE_INTERVAL = 5000; // 5 segundos
     
+    // Control inputs without a valid reading: their loop is held and its actuator kept safe
+    bool inputFault[Metrics::INPUT_COUNT];
+    unsigned int inputFaultCount[Metrics::INPUT_COUNT]; // Pérdidas de lectura desde el arranque
+    
     bool autoMode;
     bool systemEnabled;
 
@@ -33,8 +59,10 @@ public:
     LogicManager();
     ~LogicManager();
     
-    bool begin(SensorManager* sensors, ActuatorManager* actuators, BlynkManager* blynk);
+    bool begin(SensorManager* sensors, ActuatorManager* actuators, BlynkManager* blynk, TimeManager* clock = nullptr,
+               SettingsStore* settings = nullptr);
     void update();
+    unsigned long getIdleTime();  // ms hasta el próximo ciclo de control (o el siguiente paso del riego)
     void processLogic();
     
     // Control modes
@@ -48,28 +76,59 @@ public:
     void setHumidityTarget(float target);
     void setLightTarget(float target);
     void setSoilMoistureTarget(float target);
+    void setZoneMoistureTarget(uint8_t zone, float target);
     
     // Get current targets
     float getTemperatureTarget() const;
     float getHumidityTarget() const;
     float getLightTarget() const;
     float getSoilMoistureTarget() const;
+    float getZoneMoistureTarget(uint8_t zone) const;
+    
+    // Irrigation zones
+    IrrigationScheduler* getIrrigationScheduler();
+    
+    // Ventilation (emergency state)
+    VentilationControl* getVentilationControl();
+    
+    // Warm restart (StateSnapshot): auto mode, PID integrals and irrigation per zone
+    void saveState(StateSnapshot::State& state) const;
+    void restoreState(const StateSnapshot::State& state);
     
     // Status
     void getSystemStatus(String& status);
     void sendStatusToBlynk();
     
+    // Calendar (day rollover from TimeManager)
+    void resetDailyStatistics();
+    
     // Emergency handling
     void handleEmergency();
     bool checkAlerts();
     
+    // Sensor faults (loops held for a missing reading)
+    bool hasInputFault(Metrics::ControlInput input) const;
+    unsigned int getInputFaultCount(Metrics::ControlInput input) const;
+    
+    // PID autotune (relay feedback)
+    bool startAutotune(AutotuneLoop loop);
+    void cancelAutotune();
+    bool isAutotuning() const;
+    String getAutotuneStatus() const;
+    
 private:
     // Apply control actions to actuators
     void applyTemperatureControl();
-    void applyHumidityControl();
     void applyLightControl();
-    void applyIrrigationControl();
     void applyVentilationControl();
+    bool checkInput(Metrics::ControlInput input, float value);
+    
+    // Autotune helpers
+    void processAutotune();
+    void applyAutotuneOutput(bool relayHigh);
+    void finishAutotune();
+    void applyStoredTuning();
+    void saveTunedGains(AutotuneLoop loop, float kp, float ki, float kd);
 };
 
 #endif
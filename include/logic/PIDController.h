@@ -0,0 +1,141 @@
+#ifndef PID_CONTROLLER_H
+#define PID_CONTROLLER_H
+
+#include <Arduino.h>
+
+/**
+ * PIDController - Motor PID discreto compartido por los controles del invernadero
+ * Parametrizado por tipo numérico (float, double o FixedPoint)
+ *
+ * - Derivada sobre la medición (sin picos al cambiar el objetivo desde Blynk)
+ *   con filtro de primer orden
+ * - Anti-windup por retro-cálculo (back-calculation) contra los límites de salida
+ * - Cambio de objetivo y de constantes sin saltos (bumpless): el término
+ *   integral se guarda en unidades de salida y absorbe el salto proporcional
+ * - Paso de tiempo entero en milisegundos, sin aritmética float de millis()
+ */
+template <typename T>
+class PIDController {
+private:
+    // Gains
+    T kp, ki, kd;
+    T kt; // Back-calculation tracking gain (1/s)
+
+    // Derivative low-pass filter: weight kept from the previous derivative (0..1)
+    T derivativeFilter;
+
+    // Output limits
+    T outputMin, outputMax;
+
+    // State
+    T setpoint;
+    T integralTerm; // Integral contribution already scaled by ki (output units)
+    T derivativeTerm; // Filtered d(measurement)/dt
+    T previousMeasurement;
+    T lastOutput;
+    T lastError;
+    bool initialized;
+    bool bumpless;
+
+    static T clamp(T v, T lo, T hi) {
+        return v < lo ? lo : (v > hi ? hi : v);
+    }
+
+public:
+    PIDController() :
+        kp(T(0)), ki(T(0)), kd(T(0)), kt(T(0)),
+        derivativeFilter(T(0)),
+        outputMin(T(-100)), outputMax(T(100)),
+        setpoint(T(0)), integralTerm(T(0)), derivativeTerm(T(0)),
+        previousMeasurement(T(0)), lastOutput(T(0)), lastError(T(0)),
+        initialized(false), bumpless(true)
+    {
+    }
+
+    // Configuration
+    void setGains(T p, T i, T d) {
+        kp = p;
+        ki = i;
+        kd = d;
+        // Default tracking gain ~ ki/kp (1/Ti), a common choice for back-calculation.
+        // Without both terms there is no Ti; the integral clamp alone bounds windup
+        kt = (kp > T(0) && ki > T(0)) ? ki / kp : T(0);
+    }
+
+    void setTrackingGain(T tracking) { kt = tracking; }
+    void setDerivativeFilter(T alpha) { derivativeFilter = clamp(alpha, T(0), T(1)); }
+    void setBumpless(bool enable) { bumpless = enable; }
+
+    void setOutputLimits(T minOut, T maxOut) {
+        if (!(minOut < maxOut)) return;
+        outputMin = minOut;
+        outputMax = maxOut;
+        integralTerm = clamp(integralTerm, outputMin, outputMax);
+        lastOutput = clamp(lastOutput, outputMin, outputMax);
+    }
+
+    void setSetpoint(T sp) {
+        if (sp == setpoint) return;
+        // Keep the output continuous: the integral absorbs the proportional step
+        if (bumpless && initialized) {
+            integralTerm = clamp(integralTerm - kp * (sp - setpoint), outputMin, outputMax);
+        }
+        setpoint = sp;
+    }
+
+    // Reset state; the integral is preloaded with the current actuator output
+    void reset(T currentOutput = T(0)) {
+        integralTerm = clamp(currentOutput, outputMin, outputMax);
+        derivativeTerm = T(0);
+        lastOutput = integralTerm;
+        lastError = T(0);
+        initialized = false;
+    }
+
+    // Run one control step. dtMs is the time since the previous step in ms
+    T compute(T measurement, unsigned long dtMs) {
+        T error = setpoint - measurement;
+        lastError = error;
+
+        if (!initialized) {
+            // No previous measurement yet: start the derivative from zero
+            previousMeasurement = measurement;
+            derivativeTerm = T(0);
+            initialized = true;
+        }
+
+        if (dtMs == 0) {
+            return lastOutput;
+        }
+        T dt = T(dtMs) / T(1000);
+
+        // Derivative on measurement with first-order filter
+        T rawDerivative = (measurement - previousMeasurement) / dt;
+        derivativeTerm = derivativeFilter * derivativeTerm + (T(1) - derivativeFilter) * rawDerivative;
+        previousMeasurement = measurement;
+
+        T unsaturated = kp * error + integralTerm - kd * derivativeTerm;
+        T output = clamp(unsaturated, outputMin, outputMax);
+
+        // Integrate, bleeding off the excess beyond the output limits
+        integralTerm = integralTerm + (ki * error + kt * (output - unsaturated)) * dt;
+        integralTerm = clamp(integralTerm, outputMin, outputMax);
+
+        lastOutput = output;
+        return output;
+    }
+
+    // Status
+    T getOutput() const { return lastOutput; }
+    T getSetpoint() const { return setpoint; }
+    T getError() const { return lastError; }
+    T getIntegralTerm() const { return integralTerm; }
+    T getDerivative() const { return derivativeTerm; }
+    T getKp() const { return kp; }
+    T getKi() const { return ki; }
+    T getKd() const { return kd; }
+    T getOutputMin() const { return outputMin; }
+    T getOutputMax() const { return outputMax; }
+};
+
+#endif
@@ -0,0 +1,98 @@
+#ifndef RELAY_AUTOTUNE_H
+#define RELAY_AUTOTUNE_H
+
+#include <Arduino.h>
+
+/**
+ * RelayAutotune - Autoajuste PID por realimentación con relé (Åström–Hägglund)
+ * Sustituye el PID por un relé con histéresis alrededor del objetivo, lo que
+ * fuerza una oscilación sostenida del proceso. De la amplitud y el periodo de
+ * esa oscilación se obtienen la ganancia última Ku y el periodo último Tu:
+ *     Ku = 4d / (π·sqrt(a² - ε²))
+ * (d = amplitud del relé, a = amplitud de la oscilación, ε = histéresis)
+ *
+ * Las salidas se expresan en las mismas unidades que el PID que se ajusta,
+ * de modo que las ganancias resultantes se aplican directamente.
+ */
+class RelayAutotune {
+public:
+    enum State {
+        STATE_IDLE,
+        STATE_RUNNING,
+        STATE_DONE,
+        STATE_FAILED
+    };
+
+    enum TuningRule {
+        RULE_ZIEGLER_NICHOLS, // Respuesta rápida, sobreimpulso apreciable
+        RULE_TYREUS_LUYBEN    // Conservadora, poco sobreimpulso (por defecto)
+    };
+
+private:
+    static const uint8_t MAX_CYCLES = 8;
+
+    // Relay configuration
+    float setpoint;
+    float outputHigh;
+    float outputLow;
+    float hysteresis;
+    float minMeasurement, maxMeasurement; // Safety band for the measurement
+    uint8_t requiredCycles;
+    unsigned long timeout;
+
+    // Relay state
+    State state;
+    bool relayHigh;
+    unsigned long startTime;
+    unsigned long lastRiseTime; // Last low->high switch
+    float peakMax, peakMin;     // Extremes since the last low->high switch
+
+    // Measured cycles (first cycle discarded as transient)
+    uint8_t cycleCount;
+    float amplitudes[MAX_CYCLES]; // Half peak-to-peak
+    float periods[MAX_CYCLES];    // Seconds
+
+    // Results
+    float ultimateGain;
+    float ultimatePeriod;
+    String failReason;
+
+    void fail(const char* reason);
+    bool cyclesConverged() const;
+    void finish();
+
+public:
+    RelayAutotune();
+
+    // Configuration (must be called before start)
+    void setOutputs(float high, float low);
+    void setHysteresis(float hyst);
+    void setMeasurementLimits(float minValue, float maxValue);
+    void setCycles(uint8_t cycles);
+    void setTimeout(unsigned long timeoutMs);
+
+    // Control
+    void start(float target, float currentMeasurement);
+    void cancel();
+
+    // Feed one measurement; returns the relay output to apply
+    float update(float measurement, unsigned long currentTime);
+
+    // Status
+    State getState() const;
+    bool isRunning() const;
+    bool isDone() const;
+    bool hasFailed() const;
+    bool isOutputHigh() const;
+    float getOutput() const;
+    uint8_t getCycleCount() const;
+    String getFailReason() const;
+    String getStatusString() const;
+
+    // Results
+    float getUltimateGain() const;
+    float getUltimatePeriod() const; // Seconds
+    bool getGains(float& kp, float& ki, float& kd, TuningRule rule = RULE_TYREUS_LUYBEN) const;
+};
+
+#endif
@@ -0,0 +1,74 @@
+#ifndef SCHEDULE_TABLE_H
+#define SCHEDULE_TABLE_H
+
+#include <Arduino.h>
+
+/**
+ * ScheduleTable - Tabla de horarios semanal compilada
+ * Cada regla es una franja horaria [inicio, fin) con máscara de días y un
+ * valor asociado (intensidad, duración...). Si fin <= inicio la franja cruza
+ * la medianoche y termina al día siguiente.
+ *
+ * Al añadir o cambiar reglas se compila un índice ordenado de transiciones de
+ * la semana con el conjunto de reglas activas tras cada una. Las consultas
+ * "qué está activo ahora" y "cuándo cambia algo" son una búsqueda binaria.
+ * Prioridad: ante varias reglas activas gana la de menor índice.
+ */
+class ScheduleTable {
+public:
+    static const uint8_t MAX_RULES = 16;
+    static const int8_t NO_RULE = -1;
+    static const uint8_t ALL_DAYS = 0b01111111;  // Bit 0 = domingo (como tm_wday)
+    static const uint16_t MINUTES_PER_DAY = 1440;
+    static const uint16_t MINUTES_PER_WEEK = 10080;
+    static const uint16_t NO_CHANGE = 0xFFFF;
+
+    struct Rule {
+        uint16_t startMinute;  // Minuto del día, 0-1439
+        uint16_t endMinute;    // 1-1440; <= inicio cruza la medianoche
+        uint8_t weekDays;      // Días en que empieza la franja
+        float value;
+        bool enabled;
+    };
+
+private:
+    struct Transition {
+        uint16_t weekMinute;   // Minuto de la semana desde el domingo 00:00
+        uint16_t activeMask;   // Reglas activas desde esta transición
+    };
+
+    static const uint16_t MAX_TRANSITIONS = MAX_RULES * 7 * 2;
+
+    Rule rules[MAX_RULES];
+    uint8_t ruleCount;
+
+    Transition transitions[MAX_TRANSITIONS];
+    uint16_t transitionCount;
+
+    void compile();
+    int16_t findTransition(uint16_t weekMinute) const;
+    static uint16_t toWeekMinute(uint8_t weekDay, uint8_t hour, uint8_t minute);
+
+public:
+    ScheduleTable();
+
+    // Rules (the index is recompiled on every change)
+    int8_t addRule(uint8_t startHour, uint8_t startMinute, uint8_t endHour, uint8_t endMinute,
+                   float value, uint8_t weekDays = ALL_DAYS);
+    bool setRule(uint8_t index, uint8_t startHour, uint8_t startMinute, uint8_t endHour, uint8_t endMinute,
+                 float value, uint8_t weekDays = ALL_DAYS);
+    bool setRuleEnabled(uint8_t index, bool enabled);
+    void clear();
+
+    uint8_t getRuleCount() const;
+    const Rule& getRule(uint8_t index) const;
+
+    // Queries, O(log n). weekDay 0 = domingo (fuera de rango se trata como domingo)
+    uint16_t getActiveMask(uint8_t weekDay, uint8_t hour, uint8_t minute) const;
+    int8_t getActiveRule(uint8_t weekDay, uint8_t hour, uint8_t minute) const;
+    float getActiveValue(uint8_t weekDay, uint8_t hour, uint8_t minute, float defaultValue) const;
+    bool isActive(uint8_t index, uint8_t weekDay, uint8_t hour, uint8_t minute) const;
+    uint16_t getMinutesToNextChange(uint8_t weekDay, uint8_t hour, uint8_t minute) const;
+};
+
+#endif
@@ -2,10 +2,13 @@
 #define TEMPERATURE_CONTROL_H
 
 #include <Arduino.h>
+#include "PIDController.h"
 
 /**
  * TemperatureControl - Control de temperatura automático para invernadero
  * Implementa control PID para mantener temperatura objetivo
+ * La salida PID se convierte en un ciclo de trabajo sobre una ventana fija
+ * (modulación proporcional en el tiempo) para el calefactor por relé
  * Basado en algoritmos de control ambiental para invernaderos
  */
 class TemperatureControl {
@@ -13,20 +16,25 @@ private:
     float targetTemperature;
     float currentTemperature;
     float tolerance;
+    float coolingHysteresis; // Cooling stops this far below the level that started it
     
-    // PID Controller variables
-    float previousError;
-    float integral;
-    float derivative;
-    float kp, ki, kd; // PID constants
+    // PID Controller (output = heater duty 0-100%)
+    PIDController<float> pid;
     
     // Control limits
     float minTemp, maxTemp;
-    float maxIntegral;
     
     // Timing
     unsigned long lastUpdate;
-    float deltaTime;
+    
+    // Time-proportioning heater output (slow PWM for relay)
+    unsigned long heaterWindowSize;
+    unsigned long heaterMinSwitchTime;
+    unsigned long heaterWindowStart;
+    unsigned long heaterOnTime;
+    float heaterDuty; // 0-100%
+    bool heaterOutput;
+    bool heaterPulseDone; // ON pulse of the current window already delivered
     
     // Status
     bool enabled;
@@ -50,10 +58,12 @@ public:
     void setTolerance(float tol);
     void setPIDConstants(float p, float i, float d);
     void setTemperatureLimits(float min, float max);
+    void setHeaterWindow(unsigned long windowMs, unsigned long minSwitchMs);
     
     // Control
     void enable();
     void disable();
+    void resetControl(); // Restart PID and heater window, e.g. after an autotune relay experiment
     bool isEnabled() const;
     
     // Status
@@ -64,7 +74,15 @@ public:
     bool isInRange() const;
     
     // PID output
-    float getPIDOutput();
+    float getPIDOutput() const;
+
+    // Integral term, kept across warm restarts (StateSnapshot)
+    float getIntegralTerm() const;
+    void restoreIntegralTerm(float integral);
+    
+    // Heater relay output (time-proportioning)
+    bool isHeaterOutputOn() const;
+    float getHeaterDuty() const;
     
     // Statistics
     unsigned long getTotalActiveTime() const;
@@ -76,6 +94,9 @@ public:
     
     // Emergency check
     bool checkEmergency() const;
+    
+private:
+    void updateHeaterOutput(unsigned long currentTime, float pidOutput);
 };
 
 #endif
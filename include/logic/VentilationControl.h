@@ -9,10 +9,22 @@
  * Basado en sistemas de ventilación para agricultura controlada
  */
 class VentilationControl {
+public:
+    // Ventilation levels
+    enum VentilationLevel {
+        VENTILATION_OFF = 0,
+        VENTILATION_LOW = 25,
+        VENTILATION_MEDIUM = 50,
+        VENTILATION_HIGH = 75,
+        VENTILATION_MAX = 100
+    };
+
 private:
     // Targets and current values
     float targetAirExchangeRate; // renovaciones por hora
     float currentAirQuality; // CO2 equivalent or composite index
+    float currentTemperature; // Lecturas del invernadero del último update()
+    float currentHumidity;
     
     // Multi-parameter control
     float temperatureThreshold;
@@ -21,15 +33,6 @@ private:
     float targetTemperature;
     float targetHumidity;
     
-    // Ventilation levels
-    enum VentilationLevel {
-        VENTILATION_OFF = 0,
-        VENTILATION_LOW = 25,
-        VENTILATION_MEDIUM = 50,
-        VENTILATION_HIGH = 75,
-        VENTILATION_MAX = 100
-    };
-    
     VentilationLevel currentLevel;
     VentilationLevel previousLevel;
     
@@ -52,6 +55,12 @@ private:
     unsigned long maxRunTime; // Tiempo máximo continuo
     unsigned long cooldownTime; // Tiempo de descanso entre ciclos
     
+    // Ventilación programada (nivel mínimo dentro de la franja horaria)
+    bool scheduleActive;
+    uint16_t scheduleStartMinute; // Minuto del día
+    uint16_t scheduleEndMinute;
+    VentilationLevel scheduledLevel;
+    
     // Environmental conditions
     float outsideTemperature;
     float outsideHumidity;
@@ -94,7 +103,8 @@ public:
     VentilationControl();
     
     bool begin();
-    void update(float temperature, float humidity, float co2Level = -1, float lightLevel = -1);
+    void update(float temperature, float humidity, float co2Level = -1,
+                uint8_t currentHour = 255, uint8_t currentMinute = 255);
     
     // Configuration
     void setTemperatureThresholds(float target, float threshold, float hysteresis = 1.0);
@@ -168,6 +178,7 @@ private:
     void updateFanControl();
     void updateServoControl();
     bool isLevelChangeAllowed() const;
+    bool isInScheduledWindow(uint8_t hour, uint8_t minute) const;
     float calculateCompositeAirQuality(float temp, float humidity, float co2) const;
     void updateEnergyConsumption();
     VentilationLevel adaptLevelToConditions(VentilationLevel baseLevel) const;
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <Arduino.h>
+#include <AsyncTCP.h>
+#include "config/config.h"
+#include "modbus/ModbusRegisterMap.h"
+
+class SensorManager;
+class ActuatorManager;
+class LogicManager;
+
+/**
+ * @brief Esclavo Modbus TCP (y RTU opcional) para PLC/SCADA
+ *
+ * El mapa de registros está en modbus/ModbusRegisterMap.h. Cada
+ * MODBUS_IMAGE_INTERVAL ms el loop convierte los datos una vez a una imagen
+ * con los registros ya en orden de red (big endian); una lectura solo copia
+ * bytes de esa imagen, sin conversiones por petición.
+ *
+ * TCP se atiende en la tarea de AsyncTCP. Cada conexión acumula lo recibido
+ * y responde a todas las peticiones completas que haya en el búfer, en orden,
+ * de modo que un cliente puede encadenar varias sin esperar respuesta. Las
+ * escrituras se responden al momento y se aplican en el loop (objetivos por
+ * BlynkTargets::dispatch, con sus límites; bobinas por ActuatorManager).
+ *
+ * RTU se atiende en el loop: la respuesta sale en la siguiente iteración.
+ */
+class ModbusManager {
+public:
+    // Longitudes máximas de Modbus (PDU 253 bytes)
+    static const uint16_t MAX_PDU = 253;
+    static const uint16_t MAX_TCP_ADU = MAX_PDU + 7;
+    static const uint16_t MAX_RTU_ADU = MAX_PDU + 3;
+    static_assert(MODBUS_TCP_BUFFER_SIZE >= MAX_TCP_ADU, "MODBUS_TCP_BUFFER_SIZE must hold one full request");
+
+private:
+    struct PendingWrite {
+        ModbusMap::Area area;
+        uint16_t address;
+        uint16_t value;
+    };
+
+    struct Connection {
+        AsyncClient* client;
+        uint8_t buffer[MODBUS_TCP_BUFFER_SIZE];
+        uint16_t length;
+    };
+
+    AsyncServer* server;
+    SensorManager* sensorManager;
+    ActuatorManager* actuatorManager;
+    LogicManager* logicManager;
+
+    // Shared with the AsyncTCP task, guarded by dataMutex
+    SemaphoreHandle_t dataMutex;
+    uint8_t inputImage[ModbusMap::INPUT_COUNT * 2];
+    uint8_t holdingImage[ModbusMap::HOLDING_COUNT * 2];
+    uint8_t coilImage[(ModbusMap::COIL_COUNT + 7) / 8];
+    PendingWrite pendingWrites[MODBUS_MAX_PENDING_WRITES];
+    uint8_t pendingCount;
+    unsigned long requestCount;
+    unsigned long exceptionCount;
+
+    // AsyncTCP task only
+    Connection connections[MODBUS_TCP_MAX_CLIENTS];
+
+    // RTU (loop only)
+    HardwareSerial* rtuSerial;
+    uint8_t rtuBuffer[MAX_RTU_ADU];
+    uint16_t rtuLength;
+    unsigned long rtuLastByte;
+
+    unsigned long lastImage;
+    bool running;
+
+    // Loop side
+    void publishImage();
+    void applyPendingWrites();
+    void pollRtu();
+
+    // AsyncTCP side
+    void handleClient(AsyncClient* client);
+    void handleData(Connection& connection, const uint8_t* data, size_t length);
+    void processConnection(Connection& connection);
+    void closeConnection(Connection& connection);
+
+    // Shared protocol core; the caller holds dataMutex
+    uint16_t processPdu(const uint8_t* pdu, uint16_t length, uint8_t* response);
+    uint16_t exceptionResponse(uint8_t function, uint8_t code, uint8_t* response);
+    bool queueWrite(ModbusMap::Area area, uint16_t address, uint16_t value);
+
+public:
+    ModbusManager();
+    ~ModbusManager();
+
+    // Deshabilitar copia y asignación (el servidor guarda punteros a this)
+    ModbusManager(const ModbusManager&) = delete;
+    ModbusManager& operator=(const ModbusManager&) = delete;
+
+    // Llamar con WiFi iniciado y los demás gestores ya listos
+    bool begin(SensorManager* sensors, ActuatorManager* actuators, LogicManager* logic);
+    // Llamar en cada iteración del loop
+    void update();
+    // ms hasta que update() tenga trabajo (escrituras recibidas o sondeo RTU)
+    unsigned long getIdleTime() const;
+
+    // Mapa de registros por Serial (para configurar el SCADA)
+    void printRegisterMap() const;
+
+    bool isRunning() const;
+    unsigned long getRequestCount() const;
+    unsigned long getExceptionCount() const;
+
+    static uint16_t crc16(const uint8_t* data, uint16_t length);
+};
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <Arduino.h>
+#include "config/config.h"
+
+/**
+ * @brief Mapa de registros Modbus del invernadero
+ *
+ * Una sola tabla (REGISTER_MAP) define las tres áreas:
+ * - Registros de entrada (FC04): lecturas de sensores, int16 = valor × escala;
+ *   0x8000 (-32768) = sensor sin lectura.
+ * - Registros de retención (FC03/06/16): objetivos de `targets`, con el campo
+ *   y el rango de su pin Blynk en BlynkTargets::PIN_TABLE.
+ * - Bobinas (FC01/05/15): estado de los actuadores y del modo automático.
+ *
+ * Las direcciones de cada área empiezan en 0 y son consecutivas; el tamaño
+ * de cada área y la imagen de ModbusManager salen de esta tabla, y un hueco
+ * o una dirección repetida es un error de compilación. Añadir un registro al
+ * final de su área no cambia las direcciones existentes.
+ */
+namespace ModbusMap {
+
+enum class Area : uint8_t { COIL, INPUT_REGISTER, HOLDING_REGISTER };
+
+// Origen de los registros de entrada y de las bobinas
+enum Source : uint8_t {
+    SRC_TEMPERATURE,
+    SRC_HUMIDITY,
+    SRC_HEAT_INDEX,
+    SRC_LUX,
+    SRC_LIGHT_LUX,
+    SRC_SOIL_MOISTURE,
+    SRC_SOIL_MOISTURE_RS485,
+    SRC_SOIL_TEMPERATURE,
+    SRC_SOIL_EC,
+    SRC_SOIL_PH,
+    SRC_WATER_LEVEL,
+    SRC_WATER_PERCENTAGE,
+    SRC_UPTIME_MINUTES,
+    SRC_FAN,
+    SRC_WATER_PUMP,
+    SRC_HEATER,
+    SRC_LED_STRIP,
+    SRC_VENTILATION,
+    SRC_AUTO_MODE,
+};
+
+struct Entry {
+    Area area;
+    uint16_t address;
+    const char* name;
+    uint8_t source;   // Registros de retención: pin Blynk del objetivo; resto: Source
+    float scale;      // Registro = valor × escala (bobinas: sin uso)
+    bool writable;    // Bobinas que acepta FC05/FC15
+};
+
+inline constexpr Entry REGISTER_MAP[] = {
+    // Registros de entrada (FC04)
+    {Area::INPUT_REGISTER, 0, "temperature_x10", SRC_TEMPERATURE, 10, false},
+    {Area::INPUT_REGISTER, 1, "humidity_x10", SRC_HUMIDITY, 10, false},
+    {Area::INPUT_REGISTER, 2, "heat_index_x10", SRC_HEAT_INDEX, 10, false},
+    {Area::INPUT_REGISTER, 3, "lux_as7341_div10", SRC_LUX, 0.1f, false},
+    {Area::INPUT_REGISTER, 4, "lux_bh1750_div10", SRC_LIGHT_LUX, 0.1f, false},
+    {Area::INPUT_REGISTER, 5, "soil_moisture_x10", SRC_SOIL_MOISTURE, 10, false},
+    {Area::INPUT_REGISTER, 6, "soil_moisture_rs485_x10", SRC_SOIL_MOISTURE_RS485, 10, false},
+    {Area::INPUT_REGISTER, 7, "soil_temperature_x10", SRC_SOIL_TEMPERATURE, 10, false},
+    {Area::INPUT_REGISTER, 8, "soil_ec", SRC_SOIL_EC, 1, false},
+    {Area::INPUT_REGISTER, 9, "soil_ph_x100", SRC_SOIL_PH, 100, false},
+    {Area::INPUT_REGISTER, 10, "water_level_x10", SRC_WATER_LEVEL, 10, false},
+    {Area::INPUT_REGISTER, 11, "water_percentage_x10", SRC_WATER_PERCENTAGE, 10, false},
+    {Area::INPUT_REGISTER, 12, "uptime_minutes", SRC_UPTIME_MINUTES, 1, false},
+
+    // Registros de retención (FC03/06/16)
+    {Area::HOLDING_REGISTER, 0, "target_temperature_x10", BLYNK_VPIN_TARGET_TEMPERATURE, 10, true},
+    {Area::HOLDING_REGISTER, 1, "target_humidity_x10", BLYNK_VPIN_TARGET_HUMIDITY, 10, true},
+    {Area::HOLDING_REGISTER, 2, "target_soil_moisture_x10", BLYNK_VPIN_TARGET_SOIL_MOISTURE, 10, true},
+    {Area::HOLDING_REGISTER, 3, "target_lux_min", BLYNK_VPIN_TARGET_LUX_MIN, 1, true},
+    {Area::HOLDING_REGISTER, 4, "target_vent_temperature_x10", BLYNK_VPIN_TARGET_VENT_TEMP, 10, true},
+    {Area::HOLDING_REGISTER, 5, "target_soil_ph_x100", BLYNK_VPIN_TARGET_SOIL_PH, 100, true},
+    {Area::HOLDING_REGISTER, 6, "target_soil_ec", BLYNK_VPIN_TARGET_SOIL_EC, 1, true},
+    {Area::HOLDING_REGISTER, 7, "target_water_level_x10", BLYNK_VPIN_TARGET_WATER_LEVEL, 10, true},
+
+    // Bobinas (FC01/05/15); en modo automático la lógica puede revertir una orden manual
+    {Area::COIL, 0, "fan", SRC_FAN, 0, true},
+    {Area::COIL, 1, "water_pump", SRC_WATER_PUMP, 0, true},
+    {Area::COIL, 2, "heater", SRC_HEATER, 0, true},
+    {Area::COIL, 3, "led_strip", SRC_LED_STRIP, 0, true},
+    {Area::COIL, 4, "ventilation_open", SRC_VENTILATION, 0, true},
+    {Area::COIL, 5, "auto_mode", SRC_AUTO_MODE, 0, true},
+};
+
+constexpr uint16_t areaSize(Area area) {
+    uint16_t size = 0;
+    for (const Entry& entry : REGISTER_MAP) {
+        if (entry.area == area) size++;
+    }
+    return size;
+}
+
+// Every address 0..size-1 appears exactly once in its area
+constexpr bool areaDense(Area area) {
+    uint16_t size = areaSize(area);
+    for (uint16_t address = 0; address < size; address++) {
+        uint8_t matches = 0;
+        for (const Entry& entry : REGISTER_MAP) {
+            if (entry.area == area && entry.address == address) matches++;
+        }
+        if (matches != 1) return false;
+    }
+    return true;
+}
+
+constexpr const Entry* findEntry(Area area, uint16_t address) {
+    for (const Entry& entry : REGISTER_MAP) {
+        if (entry.area == area && entry.address == address) return &entry;
+    }
+    return nullptr;
+}
+
+inline constexpr uint16_t INPUT_COUNT = areaSize(Area::INPUT_REGISTER);
+inline constexpr uint16_t HOLDING_COUNT = areaSize(Area::HOLDING_REGISTER);
+inline constexpr uint16_t COIL_COUNT = areaSize(Area::COIL);
+
+static_assert(areaDense(Area::INPUT_REGISTER), "Input register addresses must be unique and start at 0 without gaps");
+static_assert(areaDense(Area::HOLDING_REGISTER), "Holding register addresses must be unique and start at 0 without gaps");
+static_assert(areaDense(Area::COIL), "Coil addresses must be unique and start at 0 without gaps");
+
+// Valor de un registro de entrada sin lectura
+inline constexpr uint16_t NO_READING = 0x8000;
+
+} // namespace ModbusMap
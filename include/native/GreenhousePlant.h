@@ -0,0 +1,142 @@
+#pragma once
+
+#include <Arduino.h>
+#include "config/config.h"
+#include "native/SimDevices.h"
+
+class ActuatorManager;
+
+/**
+ * @brief Gemelo digital del invernadero para pruebas en lazo cerrado
+ *
+ * Modelo de parámetros concentrados, integrado con el paso del loop:
+ * - Aire: capacidad térmica, pérdidas por la envolvente, calefactor, LEDs,
+ *   ganancia solar y renovación de aire (infiltración, ventana y ventilador)
+ * - Humedad: humedad absoluta con transpiración (según radiación y suelo),
+ *   intercambio con el exterior y condensación por encima del 100 %
+ * - Suelo: evapotranspiración por zona y caudal de la bomba repartido entre
+ *   las válvulas abiertas (sin válvula abierta la bomba no mueve agua)
+ * - Exterior: curva diaria de radiación y de temperatura
+ *
+ * Lee los actuadores a través de ActuatorManager (lo que ordenó el firmware)
+ * y escribe los sensores simulados de SimDevices, que el firmware lee con sus
+ * drivers reales.
+ */
+class GreenhousePlant {
+public:
+    struct Params {
+        // Aire y estructura
+        float airVolume;             // m³
+        float thermalCapacity;       // J/K (aire, estructura y superficie del suelo)
+        float envelopeUA;            // W/K
+        float infiltrationFlow;      // m³/s con todo cerrado
+        float ventFlow;              // m³/s con la ventana abierta, sin ventilador
+        float fanFlow;               // m³/s con el ventilador en marcha
+        // Exterior
+        float outsideMeanTemp;       // °C
+        float outsideTempSwing;      // °C de amplitud (máximo a las 15 h)
+        float outsideHumidity;       // %HR
+        float peakIrradiance;        // W/m² a mediodía solar
+        float sunriseHour;
+        float sunsetHour;
+        float solarArea;             // m² de cubierta
+        float transmittance;         // Fracción que atraviesa la cubierta
+        float solarHeatFraction;     // Fracción de la radiación transmitida que calienta el aire
+        float luxPerWatt;            // lx por W/m² de radiación
+        // Cultivo y suelo
+        float peakTranspiration;     // g/s de vapor a plena radiación y suelo húmedo
+        float nightTranspiration;    // g/s
+        float soilDryingRate;        // %/h sin radiación
+        float soilEtRate;            // %/h adicionales a plena radiación
+        float litresPerPercent;      // Agua para subir un 1 % la humedad de una zona
+        float fieldCapacity;         // % por encima del cual el agua drena
+        // Actuadores
+        float heaterPower;           // W
+        float fanPower;              // W
+        float pumpPower;             // W
+        float pumpFlow;              // L/min
+        float ledPower;              // W a brillo máximo
+        float ledLux;                // lx a brillo máximo
+    };
+
+    enum Load {
+        LOAD_HEATER,
+        LOAD_FAN,
+        LOAD_PUMP,
+        LOAD_LED,
+        LOAD_COUNT
+    };
+
+    enum Cycled {
+        CYCLE_HEATER,
+        CYCLE_FAN,
+        CYCLE_PUMP,
+        CYCLE_LED,
+        CYCLE_VENT,
+        CYCLE_VALVE_1,
+        CYCLE_VALVE_2,
+        CYCLE_COUNT
+    };
+
+    // Totales de un día simulado
+    struct DayStats {
+        float energyWh[LOAD_COUNT];
+        float waterLitres;
+        float seconds;
+        float temperatureInBand;     // s dentro de la banda
+        float humidityInBand;
+        float soilInBand[IRRIGATION_ZONE_COUNT];
+        uint32_t cycles[CYCLE_COUNT];  // Encendidos (flancos de apagado a encendido)
+        float minTemperature;
+        float maxTemperature;
+    };
+
+    // Bandas para el tiempo en banda (alrededor de los targets de config/Targets.h)
+    static constexpr float TEMPERATURE_BAND = 1.5f;   // ± °C
+    static constexpr float HUMIDITY_BAND = 10.0f;     // ± %HR
+    static constexpr float SOIL_BAND = 5.0f;          // % por debajo del objetivo
+
+    static Params defaultParams();
+
+private:
+    Params params;
+    SimDevices::Greenhouse* devices;
+    ActuatorManager* actuators;
+
+    // Estado físico
+    float airTemperature;        // °C
+    float absoluteHumidity;      // g/m³
+    float soilMoisture[IRRIGATION_ZONE_COUNT];
+    float hourOfDay;
+
+    // Estado anterior de cada actuador (ciclos)
+    bool lastOn[CYCLE_COUNT];
+
+    DayStats today;
+
+    static float saturationDensity(float temperature);   // g/m³
+    float outsideTemperature() const;
+    float irradiance() const;
+    void countCycle(Cycled actuator, bool on);
+    void accumulate(float dt, const float watts[LOAD_COUNT], float water);
+    void publishSensors(float ledFraction);
+
+public:
+    GreenhousePlant(SimDevices::Greenhouse& greenhouse, ActuatorManager& actuatorManager,
+                    const Params& plantParams = defaultParams());
+
+    // Estado inicial, y sensores publicados antes de que arranque el firmware
+    void begin(float temperature, float humidity, float soil, float hour);
+
+    // Avanza el modelo dt segundos con la hora local dada (0-24)
+    void step(float dt, float hour);
+
+    // Estadísticas del día en curso; resetDay() empieza uno nuevo
+    const DayStats& getDayStats() const { return today; }
+    void resetDay();
+
+    float getAirTemperature() const { return airTemperature; }
+    float getRelativeHumidity() const;
+    float getSoilMoisture(uint8_t zone) const;
+    float getIrradiance() const { return irradiance(); }
+};
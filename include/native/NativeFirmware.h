@@ -0,0 +1,43 @@
+#pragma once
+
+#include <Arduino.h>
+#include <time.h>
+#include "config/SettingsStore.h"
+#include "blynk/BlynkManager.h"
+#include "sensors/SensorManager.h"
+#include "actuators/ActuatorManager.h"
+#include "logic/LogicManager.h"
+#include "system/TimeManager.h"
+#include "system/TimeSource.h"
+
+/**
+ * @brief Firmware sin red para los programas del entorno native
+ *
+ * Los mismos gestores que SystemManager, arrancados en el mismo orden
+ * (actuadores, ajustes, sensores, lógica), sin WiFi, Blynk conectado, web,
+ * telemetría ni Modbus. La hora sale de una ManualTimeSource: RtcTimeSource
+ * escribiría el reloj del host.
+ */
+struct NativeFirmware {
+    ManualTimeSource primaryTime;
+    ManualTimeSource fallbackTime;
+    BlynkManager blynk;
+    SensorManager sensors;
+    ActuatorManager actuators;
+    LogicManager logic;
+    TimeManager clock;
+    SettingsStore settings;
+
+    NativeFirmware() : sensors(blynk), actuators(blynk) {}
+
+    // Hora UTC inicial; false si falla algún gestor. replay: sensores sin
+    // hardware, alimentados con SensorManager::replayRecord()
+    bool begin(time_t epoch, bool replay = false);
+
+    // Una iteración del loop (orden de SystemManager::update)
+    void update();
+
+    // Espera del loop tras update() (SystemManager::getIdleTime sin los
+    // servicios de red), entre POWER_MIN_SLEEP y POWER_MAX_SLEEP ms
+    unsigned long getIdleTime();
+};
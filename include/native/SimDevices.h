@@ -0,0 +1,83 @@
+#pragma once
+
+#include <Arduino.h>
+#include <NativeHal.h>
+
+/**
+ * @brief Dispositivos simulados del invernadero para el entorno native
+ *
+ * Cada modelo responde por el mismo bus que el hardware real (I2C, RS485 o
+ * pines de NativeHal), de modo que los drivers se ejecutan sin cambios.
+ * Los valores físicos se fijan desde el banco de pruebas.
+ */
+namespace SimDevices {
+
+/**
+ * @brief BH1750: comandos de un byte, lectura de 2 bytes (big endian)
+ */
+class BH1750Model : public NativeHal::I2CDevice {
+private:
+    float lux;
+    uint8_t mtreg;
+    bool powered;
+    uint8_t pendingMtregHigh;
+
+public:
+    BH1750Model();
+    void setLux(float value) { lux = value; }
+    bool write(const uint8_t* data, size_t length) override;
+    size_t read(uint8_t* data, size_t length) override;
+};
+
+/**
+ * @brief AS7341: banco de registros con autoincremento (ID 0x09 en 0x92)
+ */
+class AS7341Model : public NativeHal::I2CDevice {
+private:
+    uint8_t registers[256];
+    uint8_t pointer;
+
+public:
+    AS7341Model();
+    // Los 12 canales de datos a partir de CH0_DATA_L, escalados por intensity (0-1)
+    void setIntensity(float intensity);
+    bool write(const uint8_t* data, size_t length) override;
+    size_t read(uint8_t* data, size_t length) override;
+};
+
+/**
+ * @brief Sonda de suelo 7 en 1 por Modbus RTU (función 0x03, registros 0-6)
+ */
+class SoilProbeModel : public NativeHal::UartPeer {
+private:
+    uint8_t address;
+    uint16_t registers[7];
+    uint32_t requests;
+
+public:
+    explicit SoilProbeModel(uint8_t deviceAddress = 0x01);
+    void setReadings(float moisture, float temperature, uint16_t ec, float ph, uint16_t n, uint16_t p, uint16_t k);
+    uint32_t getRequestCount() const { return requests; }
+    void onTransmit(HardwareSerial& port, const uint8_t* data, size_t length) override;
+
+    static uint16_t crc16(const uint8_t* data, size_t length);
+};
+
+/**
+ * @brief Conjunto de dispositivos conectados como en docs/hardware_connections.md
+ */
+struct Greenhouse {
+    BH1750Model bh1750;
+    AS7341Model as7341;
+    SoilProbeModel soilProbe;
+
+    // Registra los modelos en NativeHal y fija valores de partida
+    void attach();
+
+    void setAirConditions(float temperature, float humidity);
+    void setLight(float lux);
+    void setSoilMoistureRaw(uint16_t adcValue);
+    void setWaterDistanceCm(float centimeters);
+};
+
+} // namespace SimDevices
@@ -1,6 +1,6 @@
 #pragma once
 
-#include <Wire.h>
+#include "sensors/I2CBus.h"
 
 // Registros AS7341
 #define AS7341_ADDR 0x39
@@ -42,6 +42,11 @@
 
 class AS7341Sensor {
 private:
+    // Bus I2C compartido (SensorManager)
+    I2CBus* bus;
+    uint8_t busDevice;
+    bool readPending;             // Medición en curso en la cola del bus
+    
     // Valores de lectura espectral (11 canales)
     uint16_t spectralData[12]; // 12 canales incluido clear/NIR
     float violetReading;       // Canal 415nm
@@ -58,6 +63,7 @@ private:
     // Control de lecturas
     unsigned long lastReading;
     unsigned long readInterval;
+    unsigned long readyAt;        // Fin de la estabilización (millis)
     bool isInitialized;
     bool lastReadValid;
     
@@ -71,16 +77,23 @@ private:
     int currentSample;
     
 public:
-    AS7341Sensor();
+    explicit AS7341Sensor(I2CBus& i2cBus);
     ~AS7341Sensor();
     
+    // Deshabilitar copia y asignación (el bus guarda un puntero en sus trabajos)
+    AS7341Sensor(const AS7341Sensor&) = delete;
+    AS7341Sensor& operator=(const AS7341Sensor&) = delete;
+    
     // Inicialización
     bool begin();
     
-    // Lectura de datos
+    // Lectura de datos: encola la medición y devuelve el resultado de la anterior
     bool readSensor();
     bool isDataValid();
     
+    // Lectura reproducida de una SensorTrace (campos en el orden de la traza), sin tocar el hardware
+    void replayReading(bool valid, const float* fields);
+    
     // Getters para canales específicos
     float getViolet();     // 415nm
     float getBlue();       // 445nm
@@ -107,6 +120,7 @@ public:
     bool isReady();
     unsigned long getTimeSinceLastReading();
     bool shouldRead();
+    unsigned long getIdleTime();    // ms hasta que shouldRead() sea true (0 = ya)
     
     // Utilidades
     void resetSamples();
@@ -116,6 +130,9 @@ private:
     float calculateAverage(const uint16_t samples[], int count);
     bool isValidReading(uint16_t* data);
     void updateFloatValues();
+    bool processSpectralData(const uint8_t* buffer, bool ok);
+    static void onSpectralData(void* context, bool ok, const uint8_t* data, uint8_t length);
+    unsigned long getIntegrationTimeMs() const;
     
     // Comunicación I2C
     bool writeRegister(uint8_t reg, uint8_t value);
@@ -2,8 +2,8 @@
 #define BH1750_SENSOR_H
 
 #include <Arduino.h>
-#include <Wire.h>
 #include "config/config.h"
+#include "sensors/I2CBus.h"
 
 // Direcciones I2C del BH1750
 #define BH1750_DEFAULT_ADDR  0x23    // Dirección por defecto (ADDR pin LOW)
@@ -13,6 +13,13 @@
 #define BH1750_POWER_DOWN    0x00    // Apagar sensor
 #define BH1750_POWER_ON      0x01    // Encender sensor
 #define BH1750_RESET         0x07    // Reset sensor
+#define BH1750_MTREG_HIGH    0x40    // Bits 7-5 de MTreg (01000_MT[7:5])
+#define BH1750_MTREG_LOW     0x60    // Bits 4-0 de MTreg (011_MT[4:0])
+
+// Registro de tiempo de medición (MTreg): sensibilidad proporcional a su valor
+#define BH1750_MTREG_DEFAULT 69      // 120 ms típicos, 180 ms máximo en alta resolución
+#define BH1750_MTREG_MIN     31      // Hasta ~120000 lx (pleno sol)
+#define BH1750_MTREG_MAX     254     // 0.25 lx por cuenta (amanecer, noche)
 
 // Modos de medición
 #define BH1750_CONT_HIGH_RES 0x10    // Medición continua, alta resolución (1 lx)
@@ -26,9 +33,16 @@
 
 class BH1750Sensor {
 private:
+    // Bus I2C compartido (SensorManager)
+    I2CBus* bus;
+    uint8_t busDevice;
+    bool readPending;             // Lectura en la cola del bus
+    
     // Variables de configuración
     uint8_t deviceAddress;
     uint8_t currentMode;
+    uint8_t measurementTimeReg;   // MTreg actual
+    bool autoMeasurementTime;     // Ajuste de MTreg en los extremos de luz
     
     // Variables de lectura
     float luxValue;
@@ -38,6 +52,7 @@ private:
     // Control de tiempo
     unsigned long lastReading;
     unsigned long readInterval;
+    unsigned long readyAt;        // Próxima conversión garantizada completa (millis)
     
     // Estados
     bool isInitialized;
@@ -49,23 +64,34 @@ private:
     void resetSamples();
     bool writeCommand(uint8_t command);
     uint16_t readRawValue();
+    bool processRawValue(uint16_t rawValue);
+    void adjustMeasurementTime(uint16_t rawValue);
+    bool writeMeasurementTime(uint8_t mtreg);
+    bool isContinuousMode() const;
+    static void onRawValue(void* context, bool ok, const uint8_t* data, uint8_t length);
     float convertToLux(uint16_t rawValue);
     unsigned long getMeasurementTime(uint8_t mode);
 
 public:
     // Constructor y destructor
-    BH1750Sensor();
-    explicit BH1750Sensor(uint8_t address);
+    explicit BH1750Sensor(I2CBus& i2cBus, uint8_t address = BH1750_DEFAULT_ADDR);
     ~BH1750Sensor();
     
+    // Deshabilitar copia y asignación (el bus guarda un puntero en sus trabajos)
+    BH1750Sensor(const BH1750Sensor&) = delete;
+    BH1750Sensor& operator=(const BH1750Sensor&) = delete;
+    
     // Inicialización
     bool begin();
     bool begin(uint8_t mode);
     
-    // Lectura del sensor
+    // Lectura del sensor: encola la lectura y devuelve el resultado de la anterior
     bool readSensor();
     bool isDataValid();
     
+    // Lectura reproducida de una SensorTrace (campos en el orden de la traza), sin tocar el hardware
+    void replayReading(bool valid, const float* fields);
+    
     // Getters
     float getLux();
     float getLuxRaw();
@@ -80,7 +106,10 @@ public:
     // Configuración
     void setReadInterval(unsigned long interval);
     bool setMode(uint8_t mode);
-    bool setAddress(uint8_t address);
+    bool setAddress(uint8_t address);    // Solo antes de begin()
+    bool setMeasurementTime(uint8_t mtreg);  // BH1750_MTREG_MIN..BH1750_MTREG_MAX
+    void setAutoMeasurementTime(bool enabled);
+    uint8_t getMeasurementTimeRegister();
     
     // Control
     bool isReady();
@@ -89,6 +118,7 @@ public:
     bool reset();
     unsigned long getTimeSinceLastReading();
     bool shouldRead();
+    unsigned long getIdleTime();    // ms hasta que shouldRead() sea true (0 = ya)
     
     // Debug
     void printLightData();
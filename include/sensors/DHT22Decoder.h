@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Decodificador de la trama de un solo hilo del DHT22 (AM2302)
+ *
+ * Recibe la forma de onda como niveles con su duración, tal como la
+ * captura el periférico RMT, y devuelve temperatura y humedad de una sola
+ * transacción. No depende de Arduino ni del hardware: una captura guardada
+ * con DHT22Sensor::printLastCapture() se decodifica igual en el PC.
+ *
+ * Trama tras la señal de inicio del host:
+ *   respuesta  80 µs bajo + 80 µs alto
+ *   40 bits    50 µs bajo + 26-28 µs alto (0) o 70 µs alto (1)
+ *   fin        50 µs bajo y la línea queda libre (alto)
+ * Bytes: humedad (x10), temperatura (x10, bit 15 = signo) y suma de control.
+ */
+namespace DHT22Decoder {
+
+struct Level {
+    bool high;
+    uint16_t micros;
+};
+
+enum Result : uint8_t {
+    RESULT_OK,
+    RESULT_NO_RESPONSE,   // Sin pulso de respuesta del sensor
+    RESULT_TRUNCATED,     // Menos de 40 bits
+    RESULT_BAD_TIMING,    // Un pulso fuera de tolerancia
+    RESULT_CHECKSUM,      // Suma de control incorrecta
+    RESULT_COUNT
+};
+
+struct Reading {
+    float temperature;  // °C
+    float humidity;     // %
+};
+
+// Tolerancias (µs), holgadas respecto a la hoja de datos para cables largos
+inline constexpr uint16_t RESPONSE_MIN_US = 60;
+inline constexpr uint16_t RESPONSE_MAX_US = 110;
+inline constexpr uint16_t BIT_LOW_MIN_US = 30;
+inline constexpr uint16_t BIT_LOW_MAX_US = 80;
+inline constexpr uint16_t BIT_HIGH_MIN_US = 10;
+inline constexpr uint16_t BIT_HIGH_MAX_US = 100;
+inline constexpr uint16_t BIT_ONE_THRESHOLD_US = 48;  // Alto más largo: bit a 1
+
+// Niveles de una trama completa con margen (inicio, respuesta, 80 de datos, fin)
+inline constexpr size_t MAX_LEVELS = 96;
+
+// levels en orden de llegada; niveles consecutivos iguales o de 0 µs se admiten
+Result decode(const Level* levels, size_t count, Reading& reading);
+
+const char* resultName(Result result);
+
+} // namespace DHT22Decoder
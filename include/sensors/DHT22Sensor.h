@@ -1,12 +1,37 @@
 #pragma once
 
 #include <DHT.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/ringbuf.h>
+#include "sensors/DHT22Decoder.h"
 
+/**
+ * @brief Sensor DHT22 de temperatura y humedad
+ *
+ * Con DHT22_USE_RMT la trama la captura el periférico RMT en lugar de la
+ * librería de Adafruit, que lee bit a bit con las interrupciones
+ * desactivadas unos 5 ms (jitter en LEDC, servos y WiFi). readSensor()
+ * baja la línea, un esp_timer la libera tras DHT22_START_SIGNAL_US y arranca
+ * la recepción; update() recoge la trama en una iteración posterior y la
+ * decodifica (temperatura y humedad de una sola transacción).
+ */
 class DHT22Sensor {
 private:
-    DHT* dht;
+    DHT* dht;                     // Modo Adafruit; en modo RMT solo el índice de calor
     uint8_t pin;
     
+    // Captura por RMT
+    RingbufHandle_t rmtBuffer;
+    esp_timer_handle_t startTimer;
+    bool capturePending;
+    unsigned long captureStartedAt;
+    unsigned long lastTransaction;   // El DHT22 necesita DHT22_MIN_INTERVAL entre tramas
+    DHT22Decoder::Result lastDecodeResult;
+    uint32_t decodeFailures;
+    DHT22Decoder::Level lastCapture[DHT22Decoder::MAX_LEVELS];
+    size_t lastCaptureLength;
+    
     // Valores de lectura
     float temperature;
     float humidity;
@@ -15,6 +40,7 @@ private:
     // Control de lecturas
     unsigned long lastReading;
     unsigned long readInterval;
+    unsigned long readyAt;        // Fin de la estabilización (millis)
     bool isInitialized;
     bool lastReadValid;
     
@@ -35,10 +61,16 @@ public:
     // Inicialización
     bool begin();
     
-    // Lectura de datos
+    // Lectura de datos; en modo RMT inicia la transacción y devuelve el resultado de la anterior
     bool readSensor();
+    
+    // Recoger la trama RMT pendiente (cada iteración del loop)
+    void update();
     bool isDataValid();
     
+    // Lectura reproducida de una SensorTrace (campos en el orden de la traza), sin tocar el hardware
+    void replayReading(bool valid, const float* fields);
+    
     // Getters
     float getTemperature();
     float getHumidity(); 
@@ -53,9 +85,20 @@ public:
     
     // Funciones de utilidad
     bool shouldRead();
+    unsigned long getIdleTime();    // ms hasta la próxima lectura o la recogida de la trama RMT
     void resetSamples();
     
+    // Diagnóstico de la captura RMT
+    DHT22Decoder::Result getLastDecodeResult();
+    uint32_t getDecodeFailures();
+    void printLastCapture();    // Niveles como inicializador C, para decodificarlos en el PC
+    
 private:
+    bool beginCapture();
+    void startCapture();
+    void finishCapture(const DHT22Decoder::Level* levels, size_t count);
+    static void onStartSignalDone(void* context);
+    bool processReading(float newTemp, float newHum);
     float calculateAverage(const float samples[], int count);
     bool isValidReading(float temp, float hum);
 };
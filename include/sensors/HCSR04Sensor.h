@@ -59,6 +59,9 @@ public:
     bool readSensor();
     bool isDataValid();
     
+    // Lectura reproducida de una SensorTrace (campos en el orden de la traza), sin tocar el hardware
+    void replayReading(bool valid, const float* fields);
+    
     // Getters de distancia
     float getDistance();        // Distancia medida por el sensor
     float getDistanceRaw();     // Distancia sin promediado
@@ -83,6 +86,7 @@ public:
     bool isReady();
     unsigned long getTimeSinceLastReading();
     bool shouldRead();
+    unsigned long getIdleTime();    // ms hasta que shouldRead() sea true (0 = ya)
     
     // Calibración y configuración
     void calibrateEmpty();     // Calibrar cuando el tanque está vacío
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <Arduino.h>
+#include <Wire.h>
+#include "config/config.h"
+
+/**
+ * @brief Dueño único del bus I2C compartido (AS7341, BH1750 y futuros)
+ *
+ * Inicia Wire una sola vez a I2C_FREQUENCY y ejecuta las transacciones de
+ * todos los dispositivos. Los drivers encolan trabajos (escritura y/o
+ * lectura) con un retardo opcional y un callback de fin; update() ejecuta
+ * en el loop los que ya tocan, en orden por dispositivo, hasta
+ * I2C_MAX_JOBS_PER_UPDATE por pasada. Una espera de conversión es así un
+ * trabajo diferido y no un delay() que para el loop.
+ *
+ * Si una transacción falla con el bus bloqueado (SDA retenida a nivel bajo
+ * por un esclavo a medio byte), se liberan con hasta 9 pulsos de SCL y una
+ * condición de STOP antes de reiniciar Wire.
+ *
+ * Cada dispositivo registrado lleva sus transacciones, errores y latencia
+ * (media y máxima). Solo se usa desde la tarea del loop.
+ */
+class I2CBus {
+public:
+    // data/length: bytes leídos (length 0 en trabajos solo de escritura o con error)
+    typedef void (*Callback)(void* context, bool ok, const uint8_t* data, uint8_t length);
+
+    static const uint8_t MAX_WRITE = 4;   // Registro + valores de configuración
+    static const uint8_t MAX_READ = 24;   // 12 canales del AS7341
+    static const uint8_t NO_DEVICE = 0xFF;
+
+    struct DeviceStats {
+        const char* name;
+        uint8_t address;
+        uint32_t transactions;
+        uint32_t errors;
+        uint32_t totalMicros;
+        uint32_t maxMicros;
+    };
+
+private:
+    struct Job {
+        uint8_t device;
+        uint8_t writeLength;
+        uint8_t write[MAX_WRITE];
+        uint8_t readLength;
+        unsigned long notBefore;  // millis()
+        Callback callback;
+        void* context;
+    };
+
+    Job queue[I2C_QUEUE_SIZE];    // En orden de llegada
+    uint8_t queueLength;
+    DeviceStats devices[I2C_MAX_DEVICES];
+    uint8_t deviceCount;
+    uint32_t recoveries;
+    uint32_t droppedJobs;
+    bool started;
+
+    bool execute(uint8_t device, const uint8_t* write, uint8_t writeLength, uint8_t* read, uint8_t readLength);
+    bool recoverBus();
+    void startWire();
+
+public:
+    I2CBus();
+
+    // Deshabilitar copia y asignación (los drivers guardan un puntero al bus)
+    I2CBus(const I2CBus&) = delete;
+    I2CBus& operator=(const I2CBus&) = delete;
+
+    // Idempotente: cada driver lo llama en su begin()
+    bool begin();
+
+    // Devuelve el identificador del dispositivo (el mismo si ya estaba) o NO_DEVICE
+    uint8_t addDevice(const char* name, uint8_t address);
+
+    // Transacción inmediata (configuración en begin() y lecturas puntuales);
+    // writeLength y readLength a 0 comprueban solo que el dispositivo responde
+    bool transfer(uint8_t device, const uint8_t* write, uint8_t writeLength, uint8_t* read, uint8_t readLength);
+
+    // Trabajo en cola; false si la cola está llena (el callback no se llamará)
+    bool submit(uint8_t device, const uint8_t* write, uint8_t writeLength, uint8_t readLength,
+                unsigned long delayMs, Callback callback, void* context);
+
+    // Llamar en cada iteración del loop
+    void update();
+    // ms hasta el primer trabajo en cola que toca (ULONG_MAX con la cola vacía)
+    unsigned long getIdleTime() const;
+
+    // Estadísticas
+    uint8_t getDeviceCount() const;
+    const DeviceStats& getDeviceStats(uint8_t device) const;
+    uint8_t getQueueLength() const;
+    uint32_t getRecoveryCount() const;
+    uint32_t getDroppedJobCount() const;
+    void printStats() const;
+};
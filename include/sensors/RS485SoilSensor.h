@@ -36,6 +36,7 @@ private:
     // Control de tiempo
     unsigned long lastReading;
     unsigned long readInterval;
+    unsigned long readyAt;        // Fin de la estabilización (millis)
     
     // Estados
     bool isInitialized;
@@ -88,6 +89,9 @@ public:
     // Estado del sensor
     bool isDataValid();
     bool isReady();
+    
+    // Lectura reproducida de una SensorTrace (campos en el orden de la traza), sin tocar el hardware
+    void replayReading(bool valid, const float* fields);
     String getSoilStatus();
     String getNutrientStatus();
     String getMoistureLevel();
@@ -111,6 +115,7 @@ public:
     // Utilidades
     unsigned long getTimeSinceLastReading();
     bool shouldRead();
+    unsigned long getIdleTime();    // ms hasta que shouldRead() sea true (0 = ya)
     void printSoilData();
     void printNutrientData();
     void printAllData();
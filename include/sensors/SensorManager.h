@@ -1,15 +1,18 @@
 #pragma once
 
+#include "sensors/I2CBus.h"
 #include "sensors/DHT22Sensor.h"
 #include "sensors/AS7341Sensor.h"
 #include "sensors/SoilMoistureSensor.h"
 #include "sensors/BH1750Sensor.h"
 #include "sensors/HCSR04Sensor.h"
 #include "sensors/RS485SoilSensor.h"
+#include "sensors/SensorTrace.h"
 #include "blynk/BlynkManager.h"
 
 class SensorManager {
 private:
+    I2CBus i2cBus;                // Compartido por AS7341 y BH1750
     DHT22Sensor* dht22Sensor;
     AS7341Sensor* as7341Sensor;
     SoilMoistureSensor* soilMoistureSensor;
@@ -24,6 +27,10 @@ private:
     
     bool sensorsInitialized;
     
+    // Traza de lecturas: grabación (nullptr = sin grabar) y reproducción
+    SensorTrace::Recorder* traceRecorder;
+    bool replaying;
+    
 public:
     explicit SensorManager(BlynkManager& blynk);
     ~SensorManager();
@@ -37,6 +44,8 @@ public:
     
     // Actualización periódica
     void update();
+    // ms hasta que update() tenga trabajo: próxima lectura, trabajo I2C o envío a Blynk
+    unsigned long getIdleTime();
     
     // Gestión de sensores
     bool readAllSensors();
@@ -89,7 +98,20 @@ public:
     
     // Utilidades
     void printAllSensorData();
+    const I2CBus& getI2CBus() const;
+    
+    // Lecturas mínimas para el control local (temperatura y humedad del DHT22)
+    bool hasControlReadings();
+    
+    // Traza de lecturas (SensorTrace): se graba al final de cada update()
+    void setTraceRecorder(SensorTrace::Recorder* recorder);
+    
+    // Reproducción en el PC: sin hardware, las lecturas llegan con replayRecord()
+    void beginReplay();
+    void replayRecord(const SensorTrace::Record& record);
     
 private:
     bool shouldUpdateBlynk();
+    void recordTrace();
+    static unsigned long untilRead(unsigned long wait);
 };
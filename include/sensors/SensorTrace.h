@@ -0,0 +1,107 @@
+#pragma once
+
+#include <Arduino.h>
+#include <time.h>
+#include "system/Metrics.h"
+
+/**
+ * @brief Traza binaria de las lecturas de sensores (grabación y reproducción)
+ *
+ * Cabecera: "GT", versión (TRACE_VERSION) y millis() del arranque de la
+ * traza, uint32 little endian.
+ * Registro: milisegundos desde el registro anterior (varint), tipo (número de
+ * Metrics::Sensor, o RECORD_TIME) con el bit FLAG_INVALID si el sensor no
+ * tiene dato válido, y después los campos del sensor multiplicados por
+ * 10^decimales (como TelemetryFrame), como diferencia con el último registro
+ * válido del mismo sensor en varint zigzag. RECORD_TIME lleva la hora Unix
+ * en varint.
+ *
+ * Se graba lo que SensorManager entrega a la lógica (lecturas ya filtradas),
+ * y solo cuando cambia: una lectura estable no ocupa nada. Reproducir la
+ * traza da exactamente las mismas entradas al control, con la resolución de
+ * FIELD_DECIMALS.
+ */
+namespace SensorTrace {
+
+static const uint8_t TRACE_VERSION = 1;
+static const uint8_t HEADER_SIZE = 7;
+static const uint8_t MAX_FIELDS = 10;
+static const uint8_t RECORD_TIME = 0x7F;
+static const uint8_t FLAG_INVALID = 0x80;
+static const uint8_t MAX_RECORD_SIZE = 5 + 1 + MAX_FIELDS * 5; // Varints de 32 bits
+
+// Campos grabados de cada sensor (orden de Metrics::Sensor)
+uint8_t fieldCount(Metrics::Sensor sensor);
+
+struct Record {
+    uint32_t millis;              // millis() del firmware grabado
+    uint8_t type;                 // Metrics::Sensor o RECORD_TIME
+    bool valid;
+    float fields[MAX_FIELDS];
+    uint32_t epoch;               // Solo RECORD_TIME
+};
+
+/**
+ * @brief Escribe la traza en un Print (fichero de LittleFS o Serial)
+ *
+ * Sobre Serial cada bloque va en una línea "#T " en hexadecimal, para que
+ * conviva con el resto de mensajes de la consola; la herramienta de
+ * reproducción extrae esas líneas del registro capturado.
+ */
+class Recorder {
+private:
+    Print* output;
+    bool hexLines;
+    size_t maxBytes;
+    size_t bytesWritten;
+    bool full;
+    unsigned long lastRecordMillis;
+    unsigned long lastTimeRecord;
+    bool recorded[Metrics::SENSOR_COUNT];
+    bool lastValid[Metrics::SENSOR_COUNT];
+    int32_t lastFields[Metrics::SENSOR_COUNT][MAX_FIELDS];
+
+    bool write(const uint8_t* data, size_t length);
+    size_t beginRecord(uint8_t* buffer, uint8_t type);
+
+public:
+    Recorder();
+
+    // maxBytes = 0: sin límite
+    void begin(Print& out, bool hex, size_t maxBytes);
+    bool isActive() const { return output && !full; }
+    size_t getBytesWritten() const { return bytesWritten; }
+
+    // Lectura actual de un sensor; solo se graba si cambió
+    void sample(Metrics::Sensor sensor, bool valid, const float* fields);
+
+    // Hora Unix cada SENSOR_TRACE_TIME_INTERVAL (se ignora sin hora válida)
+    void clock(time_t epoch);
+};
+
+/**
+ * @brief Lee una traza completa en memoria (herramienta de reproducción)
+ */
+class Reader {
+private:
+    const uint8_t* data;
+    size_t length;
+    size_t position;
+    uint32_t millis;
+    int32_t lastFields[Metrics::SENSOR_COUNT][MAX_FIELDS];
+
+    bool readVarint(uint32_t& value);
+
+public:
+    Reader();
+
+    // false si no empieza por una cabecera válida
+    bool begin(const uint8_t* trace, size_t size);
+    uint32_t getStartMillis() const;
+
+    // false al final de la traza o ante un registro truncado o desconocido
+    bool next(Record& record);
+    bool isAtEnd() const { return position >= length; }
+};
+
+} // namespace SensorTrace
@@ -46,6 +46,9 @@ public:
     bool readSensor();
     bool isDataValid();
     
+    // Lectura reproducida de una SensorTrace (campos en el orden de la traza), sin tocar el hardware
+    void replayReading(bool valid, const float* fields);
+    
     // Getters
     float getMoisturePercentage();
     uint16_t getRawValue();
@@ -66,6 +69,7 @@ public:
     bool isReady();
     unsigned long getTimeSinceLastReading();
     bool shouldRead();
+    unsigned long getIdleTime();    // ms hasta que shouldRead() sea true (0 = ya)
     
     // Debug
     void printMoistureData();
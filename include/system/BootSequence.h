@@ -0,0 +1,94 @@
+#pragma once
+
+#include <Arduino.h>
+
+/**
+ * @brief Grafo de arranque por fases
+ *
+ * PHASES define cada fase con las que necesita terminadas antes. Las fases
+ * inmediatas las ejecuta SystemManager::initialize() en el orden de la tabla
+ * y ninguna bloquea esperando a un dispositivo: los sensores arrancan su
+ * estabilización y siguen solos, y el WiFi conecta en segundo plano. Las
+ * fases diferidas se completan en el loop cuando se cumple su condición.
+ *
+ * Orden: salidas en estado seguro primero, control local en cuanto hay
+ * lecturas mínimas, y la red cuando llegue. Cada fase registra su duración
+ * y el instante desde el encendido por Serial.
+ */
+namespace Boot {
+
+enum Phase : uint8_t {
+    PHASE_ACTUATORS,       // Salidas configuradas y apagadas
+    PHASE_SETTINGS,        // Targets y ajustes guardados en NVS
+    PHASE_SENSORS,         // Sensores iniciados; sus estabilizaciones corren en paralelo
+    PHASE_LOGIC,           // Controladores con los targets guardados
+    PHASE_NETWORK,         // WiFi en segundo plano, hora y Blynk
+    PHASE_SERVICES,        // Panel web, telemetría y Modbus
+    PHASE_SENSORS_READY,   // Lecturas mínimas válidas (o BOOT_SENSOR_TIMEOUT)
+    PHASE_CONTROL,         // Primer ciclo de control local
+    PHASE_WIFI_CONNECTED,  // Conexión WiFi establecida
+    PHASE_COUNT
+};
+
+constexpr uint16_t bit(Phase phase) {
+    return (uint16_t)(1u << phase);
+}
+
+struct PhaseEntry {
+    Phase phase;
+    const char* name;
+    uint16_t dependsOn;  // Fases que deben haber terminado (bit(PHASE_...))
+    bool required;       // Si falla no hay control: initialize() devuelve false
+    bool deferred;       // Se completa en el loop, no en initialize()
+};
+
+inline constexpr PhaseEntry PHASES[] = {
+    {PHASE_ACTUATORS, "actuators", 0, true, false},
+    {PHASE_SETTINGS, "settings", 0, false, false},
+    {PHASE_SENSORS, "sensors", 0, false, false},
+    {PHASE_LOGIC, "logic", bit(PHASE_ACTUATORS) | bit(PHASE_SETTINGS), true, false},
+    {PHASE_NETWORK, "network", bit(PHASE_SETTINGS), false, false},
+    {PHASE_SERVICES, "services", bit(PHASE_SENSORS) | bit(PHASE_LOGIC), false, false},
+    {PHASE_SENSORS_READY, "sensors_ready", bit(PHASE_SENSORS), false, true},
+    {PHASE_CONTROL, "control", bit(PHASE_LOGIC) | bit(PHASE_SENSORS_READY), true, true},
+    {PHASE_WIFI_CONNECTED, "wifi_connected", bit(PHASE_NETWORK), false, true},
+};
+
+// Table order is execution order: an entry may only depend on earlier ones
+constexpr bool phasesOrdered() {
+    uint8_t index = 0;
+    for (const PhaseEntry& entry : PHASES) {
+        if (entry.phase != index) return false;
+        if (entry.dependsOn >> index) return false;
+        index++;
+    }
+    return index == PHASE_COUNT;
+}
+static_assert(phasesOrdered(), "Boot::PHASES must list every phase once, in order, after its dependencies");
+
+} // namespace Boot
+
+/**
+ * @brief Estado del arranque: fases terminadas, fallidas y sus tiempos
+ */
+class BootSequence {
+private:
+    uint16_t finished;
+    uint16_t failed;
+    unsigned long finishedAt[Boot::PHASE_COUNT]; // millis() desde el encendido
+    bool summaryPrinted;
+
+public:
+    BootSequence();
+
+    // Dependencias terminadas y la fase aún pendiente
+    bool isReady(Boot::Phase phase) const;
+    bool isFinished(Boot::Phase phase) const;
+    bool isComplete() const;
+
+    // Registrar el final de una fase (startedAt = millis() al empezarla)
+    void finish(Boot::Phase phase, bool ok, unsigned long startedAt);
+
+    // Resumen por Serial, una sola vez, cuando terminan todas las fases
+    void printSummaryOnce();
+};
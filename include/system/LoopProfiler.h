@@ -0,0 +1,145 @@
+#pragma once
+
+#include <Arduino.h>
+#include <atomic>
+#include <esp_timer.h>
+#include "config/config.h"
+
+/**
+ * @brief Perfilador por subsistema de SystemManager::update()
+ *
+ * Cada etapa del loop (WiFi, Blynk, sensores, lógica...) registra su
+ * duración con esp_timer_get_time() en un histograma logarítmico: cuatro
+ * cubetas por potencia de dos, de 1 µs a ~16 s, con un error por cubeta
+ * menor del 25 %. De ahí salen p50, p99 y máximo sin guardar muestras.
+ * Una iteración que supera LOOP_PROFILER_BUDGET_US cuenta como desborde.
+ *
+ * Solo escribe el loop; el servidor web y el informe por Serial leen los
+ * contadores atómicos sin bloquear. Con LOOP_PROFILER_ENABLED = false las
+ * medidas desaparecen en compilación (if constexpr) y el enlazador descarta
+ * las tablas.
+ */
+namespace LoopProfiler {
+
+// Etapas medidas, en el orden de SystemManager::update()
+enum Stage : uint8_t {
+    STAGE_TIME,
+    STAGE_SETTINGS,
+    STAGE_WIFI,
+    STAGE_BLYNK,
+    STAGE_SENSORS,
+    STAGE_ACTUATORS,
+    STAGE_LOGIC,
+    STAGE_WEB,
+    STAGE_TELEMETRY,
+    STAGE_MODBUS,
+    STAGE_LOOP,     // Iteración completa
+    STAGE_COUNT
+};
+
+// Values below 4 µs get their own bucket; above, 4 buckets per octave up to 2^24 µs
+inline constexpr uint8_t MAX_OCTAVE = 24;
+inline constexpr uint8_t BUCKET_COUNT = (MAX_OCTAVE - 1) * 4;
+
+struct StageData {
+    std::atomic<uint32_t> buckets[BUCKET_COUNT];
+    std::atomic<uint32_t> maxMicros;
+    std::atomic<uint64_t> totalMicros;
+};
+
+struct Summary {
+    uint32_t count;
+    uint32_t p50Micros;   // Límite superior de la cubeta (nunca mayor que el máximo)
+    uint32_t p99Micros;
+    uint32_t maxMicros;
+    uint32_t meanMicros;
+};
+
+// Storage (LoopProfiler.cpp)
+extern StageData stages[STAGE_COUNT];
+extern std::atomic<uint32_t> overruns;
+extern std::atomic<bool> resetRequested;
+
+const char* stageName(Stage stage);
+
+constexpr uint8_t bucketOf(uint32_t micros) {
+    if (micros < 4) return (uint8_t)micros;
+    uint8_t octave = 31 - __builtin_clz(micros);
+    if (octave >= MAX_OCTAVE) return BUCKET_COUNT - 1;
+    return (uint8_t)((octave - 1) * 4 + ((micros >> (octave - 2)) & 3));
+}
+
+// Largest value that falls in a bucket
+constexpr uint32_t bucketUpperBound(uint8_t bucket) {
+    if (bucket < 4) return bucket;
+    uint8_t octave = bucket / 4 + 1;
+    uint32_t width = 1UL << (octave - 2);
+    return (4 + bucket % 4) * width + width - 1;
+}
+
+static_assert(bucketOf(7) == 7 && bucketOf(8) == 8 && bucketOf(11) == 9, "Buckets must be 4 per octave");
+static_assert(bucketOf(bucketUpperBound(50)) == 50 && bucketOf(bucketUpperBound(50) + 1) == 51,
+              "bucketUpperBound must be the last value of its bucket");
+
+// Loop task only: a single writer, so plain load/store instead of read-modify-write
+inline void record(Stage stage, uint32_t micros) {
+    StageData& data = stages[stage];
+    std::atomic<uint32_t>& bucket = data.buckets[bucketOf(micros)];
+    bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    data.totalMicros.store(data.totalMicros.load(std::memory_order_relaxed) + micros, std::memory_order_relaxed);
+    if (micros > data.maxMicros.load(std::memory_order_relaxed)) {
+        data.maxMicros.store(micros, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Cronómetro por vueltas de una iteración del loop
+ * mark() cierra la etapa que acaba de terminar y empieza la siguiente;
+ * finish() registra la iteración completa y el desborde.
+ */
+class Stopwatch {
+private:
+    int64_t loopStart;
+    int64_t lapStart;
+
+    void resetIfRequested();
+
+public:
+    Stopwatch() : loopStart(0), lapStart(0) {
+        if constexpr (LOOP_PROFILER_ENABLED) {
+            resetIfRequested();
+            loopStart = esp_timer_get_time();
+            lapStart = loopStart;
+        }
+    }
+
+    void mark(Stage stage) {
+        if constexpr (LOOP_PROFILER_ENABLED) {
+            int64_t now = esp_timer_get_time();
+            record(stage, (uint32_t)(now - lapStart));
+            lapStart = now;
+        }
+    }
+
+    void finish() {
+        if constexpr (LOOP_PROFILER_ENABLED) {
+            uint32_t elapsed = (uint32_t)(esp_timer_get_time() - loopStart);
+            record(STAGE_LOOP, elapsed);
+            if (elapsed > LOOP_PROFILER_BUDGET_US) {
+                overruns.store(overruns.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            }
+        }
+    }
+};
+
+// Percentiles from the buckets; safe from any task
+Summary summarize(Stage stage);
+uint32_t getOverrunCount();
+
+// Puesta a cero al principio de la siguiente iteración (desde cualquier tarea)
+void requestReset();
+
+// Tabla por Serial
+void printReport();
+
+} // namespace LoopProfiler
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <Arduino.h>
+#include <atomic>
+
+/**
+ * @brief Registro de métricas para Prometheus (GET /metrics)
+ *
+ * Todas las series existen desde el arranque en tablas de tamaño fijo:
+ * contadores de 32 bits e histogramas de latencia con los mismos límites
+ * (BUCKET_BOUNDS_US). Actualizar una métrica es un incremento atómico sobre
+ * su ranura, sin cadenas ni memoria dinámica, así que se puede llamar desde
+ * el loop o desde un sensor sin coste apreciable. Los indicadores (heap,
+ * RSSI) no se actualizan: se leen al servir la petición.
+ *
+ * Renderer genera el formato de texto de Prometheus (0.0.4) línea a línea
+ * sobre el búfer que le pasa la respuesta por trozos, de modo que el cuerpo
+ * completo nunca está en RAM.
+ */
+namespace Metrics {
+
+// Sensores con latencia y fallos propios (etiqueta sensor="...")
+enum Sensor : uint8_t {
+    SENSOR_DHT22,
+    SENSOR_AS7341,
+    SENSOR_SOIL_MOISTURE,
+    SENSOR_BH1750,
+    SENSOR_HCSR04,
+    SENSOR_RS485_SOIL,
+    SENSOR_COUNT
+};
+
+// Salidas con contador de conmutaciones (etiqueta relay="...")
+enum Relay : uint8_t {
+    RELAY_FAN,
+    RELAY_HEATER,
+    RELAY_WATER_PUMP,
+    RELAY_LED_STRIP,
+    RELAY_MULTICHANNEL, // Canales de RelayController
+    RELAY_COUNT
+};
+
+// Entradas de los lazos de LogicManager (etiqueta input="...")
+enum ControlInput : uint8_t {
+    INPUT_TEMPERATURE,
+    INPUT_HUMIDITY,
+    INPUT_LIGHT,
+    INPUT_SOIL_ZONE_1, // Una por zona de riego
+    INPUT_SOIL_ZONE_2,
+    INPUT_COUNT
+};
+
+// Counter slots; labelled families take one slot per label value
+enum Counter : uint8_t {
+    SENSOR_READ_FAILURES,
+    RS485_CRC_ERRORS = SENSOR_READ_FAILURES + SENSOR_COUNT,
+    RELAY_TOGGLES,
+    BLYNK_RECONNECTS = RELAY_TOGGLES + RELAY_COUNT,
+    LOOP_WAKEUPS,
+    CONTROL_INPUT_FAULTS,
+    COUNTER_COUNT = CONTROL_INPUT_FAULTS + INPUT_COUNT
+};
+
+// Histogram slots
+enum Histogram : uint8_t {
+    LOOP_DURATION,
+    SENSOR_READ_DURATION,
+    HISTOGRAM_COUNT = SENSOR_READ_DURATION + SENSOR_COUNT
+};
+
+// Upper bounds (µs) shared by every histogram; the last bucket is +Inf
+inline constexpr uint32_t BUCKET_BOUNDS_US[] = {
+    1000, 2500, 5000, 10000, 25000, 50000, 100000, 250000, 500000, 1000000
+};
+inline constexpr uint8_t BUCKET_COUNT = sizeof(BUCKET_BOUNDS_US) / sizeof(BUCKET_BOUNDS_US[0]);
+
+struct HistogramData {
+    std::atomic<uint32_t> buckets[BUCKET_COUNT + 1]; // No acumulados; se suman al servir
+    std::atomic<uint64_t> sumMicros;
+};
+
+// Storage (Metrics.cpp)
+extern std::atomic<uint32_t> counters[COUNTER_COUNT];
+extern HistogramData histograms[HISTOGRAM_COUNT];
+
+inline void increment(Counter id) {
+    counters[id].fetch_add(1, std::memory_order_relaxed);
+}
+
+inline void increment(Counter family, uint8_t label) {
+    counters[family + label].fetch_add(1, std::memory_order_relaxed);
+}
+
+inline void observe(Histogram id, uint32_t micros) {
+    uint8_t bucket = 0;
+    while (bucket < BUCKET_COUNT && micros > BUCKET_BOUNDS_US[bucket]) {
+        bucket++;
+    }
+    histograms[id].buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    histograms[id].sumMicros.fetch_add(micros, std::memory_order_relaxed);
+}
+
+inline void relayToggled(Relay relay) {
+    increment(RELAY_TOGGLES, relay);
+}
+
+// Latencia de una lectura y, si falló, su fallo
+inline void sensorRead(Sensor sensor, uint32_t micros, bool success) {
+    observe((Histogram)(SENSOR_READ_DURATION + sensor), micros);
+    if (!success) {
+        increment(SENSOR_READ_FAILURES, sensor);
+    }
+}
+
+/**
+ * @brief Recorrido del registro para una respuesta por trozos
+ * Cada fill() continúa donde lo dejó el anterior; devuelve 0 al terminar.
+ */
+class Renderer {
+private:
+    static const size_t MAX_LINE = 160;
+
+    uint8_t family;
+    uint16_t item;       // 0 = HELP, 1 = TYPE, después las líneas de cada serie
+    uint32_t cumulative; // Cubetas acumuladas de la serie de histograma en curso
+    char pending[MAX_LINE];
+    size_t pendingLength;
+    size_t pendingOffset;
+
+    size_t formatItem(char* out, size_t size);
+
+public:
+    Renderer();
+    size_t fill(uint8_t* buffer, size_t maxLength);
+};
+
+} // namespace Metrics
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <Arduino.h>
+#include "config/config.h"
+
+/**
+ * @brief Espera adaptativa del loop y sueño ligero automático
+ *
+ * En lugar de un delay() fijo, el loop duerme lo que SystemManager calcula
+ * hasta el próximo trabajo de algún subsistema: la tarea se bloquea en
+ * ulTaskNotifyTake() con ese plazo, y otra tarea (servidor web, Modbus TCP)
+ * la despierta antes con wake() cuando deja un cambio pendiente.
+ *
+ * Con CONFIG_PM_ENABLE, begin() activa la gestión dinámica de frecuencia
+ * (POWER_CPU_MAX_MHZ con trabajo, POWER_CPU_MIN_MHZ en reposo) y, si el
+ * sdkconfig incluye tickless idle, el sueño ligero automático durante las
+ * esperas; el WiFi sigue asociado en modem sleep. Sin esas opciones la
+ * espera bloqueada solo deja la CPU parada en la tarea idle. Las salidas
+ * PWM (LEDC) se paran en sueño ligero: mientras ActuatorManager las
+ * necesita, sleep() mantiene un bloqueo ESP_PM_NO_LIGHT_SLEEP.
+ *
+ * Cada hora informa por Serial de los despertares del loop y del tiempo
+ * que ha estado despierto (la corriente media depende de ese porcentaje).
+ */
+namespace PowerManager {
+
+enum Mode : uint8_t {
+    MODE_WAIT,          // Solo espera bloqueada (sin CONFIG_PM_ENABLE)
+    MODE_DFS,           // Frecuencia dinámica, sin sueño ligero
+    MODE_LIGHT_SLEEP    // Frecuencia dinámica y sueño ligero automático
+};
+
+struct HourStats {
+    uint32_t wakes;          // Iteraciones del loop
+    uint32_t earlyWakes;     // Adelantadas por wake()
+    uint32_t awakeMillis;    // Tiempo dentro de SystemManager::update()
+    uint32_t lengthMillis;   // Duración de la ventana (una hora salvo la primera consulta)
+};
+
+// Tarea del loop, antes de cualquier espera
+void begin();
+
+// Tarea del loop: espera hasta idleMs (entre POWER_MIN_SLEEP y POWER_MAX_SLEEP) o hasta wake()
+void sleep(unsigned long idleMs, bool keepPwmClock);
+
+// Cualquier tarea: adelanta la siguiente iteración del loop
+void wake();
+
+// Modem sleep del WiFi (tras cada conexión)
+void configureWiFi();
+
+Mode getMode();
+const char* getModeName();
+
+// Última hora completa (la hora en curso si aún no ha terminado ninguna)
+HourStats getLastHour();
+
+} // namespace PowerManager
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <Arduino.h>
+#include "config/config.h"
+
+/**
+ * @brief Estado de actuadores y controladores en memoria RTC para el arranque en caliente
+ *
+ * Tras un reinicio por watchdog, esp_restart() o una caída de tensión, la
+ * memoria RTC_NOINIT_ATTR conserva su contenido (solo el encendido la deja
+ * con basura, que el CRC descarta). SystemManager reúne al final de cada
+ * iteración lo que no se debe perder: relés encendidos y desde cuándo,
+ * contadores de funcionamiento, brillo y ventana, modo automático,
+ * integradores de los PID y riego por zona. update() solo reescribe el
+ * registro (y su CRC) cuando algo ha cambiado.
+ *
+ * Los instantes se guardan en millis() del arranque que los escribió; touch()
+ * anota al principio de cada iteración el millis() de ese arranque, y begin()
+ * los traslada a la nueva base de tiempos como si el reinicio hubiera sido en
+ * ese momento (más lo que el Supervisor sepa que duró la iteración bloqueada).
+ * Así los intervalos mínimos, la marcha continua máxima y el intervalo entre
+ * riegos siguen contando a través del reinicio.
+ */
+namespace StateSnapshot {
+
+// Instantes en millis() con signo: tras el traslado, los anteriores al reinicio son negativos
+// (y al asignarlos a un unsigned long de 64 bits en el PC se extiende el signo, como debe)
+
+// Un actuador de relé (ventilador, calefactor, bomba, tira LED)
+struct Relay {
+    int32_t lastStateChange;
+    int32_t onSince;            // Inicio de la marcha continua (si on)
+    uint32_t totalRunTime;      // ms, sin la marcha en curso
+    uint16_t activationCount;
+    uint8_t on;
+    uint8_t reserved;
+};
+
+// Una zona de riego
+struct Zone {
+    int32_t lastIrrigationTime;   // 0 = nunca
+    int32_t sessionStart;         // Si sessionActive
+    uint32_t sessionLength;       // ms; sin sessionActive, petición a la espera de su válvula (0 = ninguna)
+    uint8_t sessionActive;
+    uint8_t reserved[3];
+};
+
+struct State {
+    Relay fan;
+    Relay heater;
+    Relay pump;
+    Relay ledStrip;
+    uint8_t ledBrightness;
+    uint8_t ventPosition;       // Destino del servo (grados)
+    uint8_t autoMode;
+    uint8_t reserved;
+    float temperatureIntegral;  // Término integral de cada PID (unidades de salida)
+    float humidityIntegral;
+    float lightIntegral;
+    Zone zones[IRRIGATION_ZONE_COUNT];
+};
+
+// Tarea del loop, antes de las fases de arranque. hangMillis: duración de la
+// iteración que bloqueó el reinicio (Supervisor), 0 si no se sabe
+void begin(unsigned long hangMillis);
+
+// Estado del arranque anterior ya en millis() de este; nullptr en arranque en frío
+const State* getRestored();
+
+// Tarea del loop: principio de cada iteración
+void touch();
+
+// Tarea del loop: final de cada iteración; reescribe el registro si ha cambiado
+void update(const State& state);
+
+// Escrituras del registro desde el arranque (cambios de estado)
+uint32_t getWriteCount();
+
+} // namespace StateSnapshot
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <Arduino.h>
+#include "config/config.h"
+#include "system/LoopProfiler.h"
+
+/**
+ * @brief Watchdog del loop con plazos por subsistema y diagnóstico de bloqueos
+ *
+ * SystemManager::update() avisa con enter() al empezar cada etapa. Cada aviso
+ * alimenta el task watchdog (la tarea del loop está suscrita) y rearma un
+ * esp_timer de un disparo con el plazo de esa etapa (WATCHDOG_DEADLINE_*):
+ * el task watchdog de IDF 4.4 tiene un único timeout para todas las tareas,
+ * así que los plazos por subsistema los vigila el temporizador y el task
+ * watchdog queda como último recurso (WATCHDOG_TASK_TIMEOUT).
+ *
+ * Si una etapa no termina a tiempo se guarda en RTC (RTC_NOINIT_ATTR, sobrevive
+ * al reinicio pero no a un corte de alimentación) qué etapa se bloqueó, cuánto
+ * llevaba, el perfil de la última iteración completa y de la interrumpida, y
+ * el estado seguro de los actuadores; después esp_restart(). En el arranque
+ * siguiente begin() valida el registro con su CRC, lo informa por Serial junto
+ * con esp_reset_reason(), y SystemManager restaura los actuadores en cuanto
+ * están inicializados.
+ */
+namespace Supervisor {
+
+// Etapas fuera de SystemManager::update(): espera del loop (PowerManager::sleep) y fases de arranque
+inline constexpr uint8_t STAGE_SLEEP = LoopProfiler::STAGE_COUNT;
+inline constexpr uint8_t STAGE_BOOT = LoopProfiler::STAGE_COUNT + 1;
+
+enum Cause : uint8_t {
+    CAUSE_DEADLINE,         // Etapa más larga que su plazo
+    CAUSE_TASK_WATCHDOG     // Saltó antes el task watchdog (la tarea del temporizador tampoco llegó a ejecutarse)
+};
+
+struct HangRecord {
+    uint32_t magic;
+    uint8_t cause;                                    // Cause
+    uint8_t stage;                                    // LoopProfiler::Stage, STAGE_SLEEP o STAGE_BOOT
+    uint8_t resetReason;                              // esp_reset_reason_t del arranque que lo informa
+    uint8_t reserved;
+    uint32_t elapsedMillis;                           // Tiempo dentro de la etapa al saltar
+    uint32_t deadlineMillis;
+    uint32_t uptimeSeconds;
+    uint32_t actuatorState;                           // ActuatorManager::getSafeState()
+    uint32_t lastLoopMicros[LoopProfiler::STAGE_COUNT];  // Última iteración completa (STAGE_LOOP = total)
+    uint32_t hungLoopMicros[LoopProfiler::STAGE_COUNT];  // Iteración interrumpida, hasta la etapa bloqueada
+    uint32_t crc;                                     // esp_rom_crc32_le de todo lo anterior
+};
+
+// Tarea del loop, antes de las fases de arranque
+void begin();
+
+// Tarea del loop: principio de cada iteración (empieza por STAGE_TIME), cada etapa y final
+void beginIteration();
+void enter(LoopProfiler::Stage stage);
+void endIteration(uint32_t actuatorState);
+// Tarea del loop: antes de dormir hasta la siguiente iteración
+void sleeping();
+
+// Bloqueo que causó el último reinicio; false si el arranque no viene de uno
+bool getLastHang(HangRecord& record);
+
+const char* stageName(uint8_t stage);
+const char* causeName(uint8_t cause);
+const char* resetReasonName(uint8_t reason);
+
+} // namespace Supervisor
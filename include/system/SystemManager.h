@@ -5,6 +5,17 @@
 #include "sensors/SensorManager.h"
 #include "logic/LogicManager.h"
 #include "actuators/ActuatorManager.h"
+#include "system/TimeManager.h"
+#include "config/SettingsStore.h"
+#include "web/WebServerManager.h"
+#include "telemetry/TelemetryManager.h"
+#include "telemetry/MqttTelemetry.h"
+#include "modbus/ModbusManager.h"
+#include "system/BootSequence.h"
+#include "sensors/SensorTrace.h"
+#if SENSOR_TRACE_OUTPUT == SENSOR_TRACE_FILE
+#include <LittleFS.h>
+#endif
 
 class SystemManager {
 private:
@@ -13,16 +24,33 @@ private:
     SensorManager* sensorManager;
     LogicManager* logicManager;
     ActuatorManager* actuatorManager;
+    TimeManager* timeManager;
+    SettingsStore* settingsStore;
+    WebServerManager* webServerManager;
+    TelemetryManager* telemetryManager;
+    MqttTelemetry* mqttTelemetry; // nullptr con MQTT_ENABLED = false
+    ModbusManager* modbusManager;
     // Variables de estado
     bool wifiConnected;
     bool blynkConnected;
     bool sensorsReady;
+    unsigned long lastProfileReport;
+    BootSequence boot;
+    SensorTrace::Recorder sensorTrace;
+#if SENSOR_TRACE_OUTPUT == SENSOR_TRACE_FILE
+    File traceFile;
+#endif
     // Callbacks internos
     static void onWiFiConnectCallback();
     static void onWiFiDisconnectCallback();
     static void onBlynkConnectCallback();
     static void onBlynkDisconnectCallback();
+    static void onDayRolloverCallback();
     static SystemManager* instance;
+    // Arranque por fases
+    bool runBootPhase(Boot::Phase phase);
+    void advanceBoot();
+    void beginSensorTrace();
     
 public:
     SystemManager(WiFiManager& wifi, BlynkManager& blynk);
@@ -35,6 +63,10 @@ public:
     bool initialize();
     void update();
     
+    // Espera del loop hasta el próximo trabajo de algún subsistema (PowerManager)
+    unsigned long getIdleTime();
+    void sleepUntilNextTask();
+    
     // Callbacks públicos
     void onWiFiConnect();
     void onWiFiDisconnect();
@@ -48,4 +80,12 @@ public:
     
     // Acceso a managers
     SensorManager* getSensorManager() { return sensorManager; }
+    LogicManager* getLogicManager() { return logicManager; }
+    ActuatorManager* getActuatorManager() { return actuatorManager; }
+    TimeManager* getTimeManager() { return timeManager; }
+    SettingsStore* getSettingsStore() { return settingsStore; }
+    WebServerManager* getWebServerManager() { return webServerManager; }
+    TelemetryManager* getTelemetryManager() { return telemetryManager; }
+    MqttTelemetry* getMqttTelemetry() { return mqttTelemetry; }
+    ModbusManager* getModbusManager() { return modbusManager; }
 };
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <Arduino.h>
+#include <time.h>
+#include "system/TimeSource.h"
+
+/**
+ * @brief Servicio de hora local para los controladores programados
+ *
+ * - Sincroniza con la fuente principal (SNTP por defecto) y, mientras no hay
+ *   hora de red, arranca desde la fuente de respaldo (RTC del ESP32)
+ * - Entre sincronizaciones extrapola con millis() corrigiendo la deriva
+ *   medida del reloj local frente a la fuente principal
+ * - Mantiene en caché la hora local (acceso O(1) desde los controladores)
+ * - Emite eventos de calendario: cada minuto y cambio de día (una sola vez
+ *   por día aunque el reloj retroceda al corregirse)
+ */
+class TimeManager {
+public:
+    typedef void (*CalendarCallback)();
+
+    static const uint8_t INVALID_TIME = 255; // Igual que LightControl: hora desconocida
+
+private:
+    // Default sources, replaceable with setPrimarySource/setFallbackSource
+    SntpTimeSource sntpSource;
+    RtcTimeSource rtcSource;
+    TimeSource* primary;
+    TimeSource* fallback;
+    const char* activeSource;
+
+    // Local clock: anchor + elapsed millis corrected by the measured drift
+    bool anchored;
+    bool anchoredToPrimary;
+    int64_t anchorEpochMs;
+    unsigned long anchorMillis;
+    float driftPpm;
+    bool driftKnown;
+    unsigned long lastSyncAttempt;
+    unsigned long lastSync;
+
+    // Cached local time, refreshed once per second
+    time_t cachedEpoch;
+    struct tm cachedLocal;
+
+    // Calendar events
+    long lastMinuteKey;
+    long lastDayKey;
+    CalendarCallback minuteCallback;
+    CalendarCallback dayCallback;
+
+    void pollSources(unsigned long nowMillis);
+    void anchorTo(const struct timeval& tv, unsigned long atMillis, bool measureDrift);
+    int64_t extrapolate(unsigned long nowMillis) const;
+    void refreshCache(time_t epoch);
+    void emitEvents();
+
+public:
+    TimeManager();
+
+    // Llamar con la pila de red iniciada (después de WiFi.mode)
+    bool begin();
+    // Llamar en cada iteración del loop (coste mínimo si no cambia el segundo)
+    void update();
+    // ms hasta el próximo evento de minuto o consulta a las fuentes de hora
+    unsigned long getIdleTime() const;
+
+    // Time sources (before begin)
+    void setPrimarySource(TimeSource* source);
+    void setFallbackSource(TimeSource* source);
+
+    // Calendar events
+    void onMinuteTick(CalendarCallback callback);
+    void onDayRollover(CalendarCallback callback);
+
+    // Local time (INVALID_TIME while the clock is not set)
+    bool isValid() const;
+    time_t now() const;
+    uint8_t getHour() const;
+    uint8_t getMinute() const;
+    uint8_t getSecond() const;
+    uint8_t getWeekDay() const;        // 0 = domingo
+    const struct tm& getLocalTime() const;
+
+    // Status
+    const char* getSourceName() const;
+    float getDriftPpm() const;
+    unsigned long getTimeSinceSync() const; // ms
+    String getTimeString() const;
+};
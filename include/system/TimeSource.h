@@ -0,0 +1,85 @@
+#pragma once
+
+#include <Arduino.h>
+#include <sys/time.h>
+
+/**
+ * @brief Fuente de hora intercambiable para TimeManager
+ *
+ * Cada fuente entrega la hora UTC con resolución de milisegundos. TimeManager
+ * la lee periódicamente y extrapola entre lecturas con millis(), de modo que
+ * se puede sustituir la fuente real por un reloj simulado en el host.
+ */
+class TimeSource {
+public:
+    virtual ~TimeSource() {}
+
+    virtual bool begin() = 0;
+
+    /**
+     * @brief Lee la hora UTC
+     * @param tv Hora leída (segundos y microsegundos desde 1970)
+     * @return true solo si hay una hora válida y nueva desde la última lectura
+     */
+    virtual bool read(struct timeval& tv) = 0;
+
+    /**
+     * @brief Corrige la hora de la fuente (p. ej. el RTC tras sincronizar por SNTP)
+     * @return true si la fuente admite escritura
+     */
+    virtual bool write(const struct timeval& tv) { (void)tv; return false; }
+
+    // true si la fuente es de referencia (sirve para medir la deriva local)
+    virtual bool isAuthoritative() const = 0;
+
+    virtual const char* getName() const = 0;
+};
+
+/**
+ * @brief Hora de red por SNTP (servidores y zona horaria en config.h)
+ * Solo entrega una lectura tras cada sincronización real con el servidor.
+ */
+class SntpTimeSource : public TimeSource {
+private:
+    static volatile bool syncPending;
+    static void onSync(struct timeval* tv);
+
+public:
+    bool begin() override;
+    bool read(struct timeval& tv) override;
+    bool isAuthoritative() const override { return true; }
+    const char* getName() const override { return "SNTP"; }
+};
+
+/**
+ * @brief Reloj del sistema del ESP32 (temporizador RTC)
+ * Conserva la hora tras reinicios por software y deep sleep, pero no tras un
+ * corte de alimentación. Se usa como respaldo mientras no hay SNTP.
+ */
+class RtcTimeSource : public TimeSource {
+public:
+    bool begin() override;
+    bool read(struct timeval& tv) override;
+    bool write(const struct timeval& tv) override;
+    bool isAuthoritative() const override { return false; }
+    const char* getName() const override { return "RTC"; }
+};
+
+/**
+ * @brief Hora fijada externamente (reloj simulado en el host, widget RTC de Blynk...)
+ */
+class ManualTimeSource : public TimeSource {
+private:
+    int64_t pendingEpochMs;
+    unsigned long pendingMillis; // millis() when the time was set
+    bool hasPending;
+
+public:
+    ManualTimeSource();
+    bool begin() override;
+    bool read(struct timeval& tv) override;
+    bool isAuthoritative() const override { return true; }
+    const char* getName() const override { return "MANUAL"; }
+
+    void setTime(time_t epoch, long milliseconds = 0);
+};
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <Arduino.h>
+#include <AsyncMqttClient.h>
+#include "config/config.h"
+#include "telemetry/TelemetrySink.h"
+#include "telemetry/TelemetryOutbox.h"
+
+/**
+ * @brief Telemetría por MQTT (Home Assistant, broker propio)
+ *
+ * Temas, con <base> = MQTT_TOPIC_PREFIX/MQTT_NODE_ID:
+ * - <base>/t       tramas binarias (telemetry/TelemetryFrame.h), QoS 1
+ * - <base>/schema  JSON retenido con el número, clave, unidad y decimales de
+ *                  cada canal; publicado en cada conexión
+ * - <base>/status  "online" / "offline" retenido (último deseo)
+ *
+ * MQTT 3.1.1 no tiene alias de tema: el número de canal dentro de la trama
+ * cumple esa función y un único tema corto lleva todas las lecturas.
+ *
+ * Las tramas pasan por una cola acotada (Telemetry::Outbox) hasta su PUBACK,
+ * con como mucho MQTT_MAX_INFLIGHT sin confirmar y reenvío tras
+ * MQTT_RETRY_INTERVAL. Los eventos del cliente llegan por la tarea de
+ * AsyncTCP; solo dejan marcas y PUBACK pendientes que el loop procesa.
+ */
+class MqttTelemetry : public Telemetry::Sink {
+private:
+    AsyncMqttClient client;
+    Telemetry::Outbox outbox;
+
+    // Written by the AsyncTCP task, guarded by eventMutex
+    SemaphoreHandle_t eventMutex;
+    uint16_t pendingAcks[MQTT_OUTBOX_SIZE];
+    uint8_t pendingAckCount;
+    bool sessionStarted; // Conexión nueva aún no atendida por el loop
+    volatile bool connected;
+
+    char dataTopic[64];
+    char schemaTopic[64];
+    char statusTopic[64];
+    bool initialized;
+    uint16_t sequence;
+    unsigned long lastConnectAttempt;
+    unsigned long framesSent;
+    unsigned long framesAcked;
+
+    void onConnect();
+    void onDisconnect();
+    void onPublishAck(uint16_t packetId);
+
+    void startSession();
+    void processAcks();
+    void sendPending(unsigned long now);
+    bool publishSchema();
+
+public:
+    MqttTelemetry();
+    ~MqttTelemetry();
+
+    // Deshabilitar copia y asignación (el cliente guarda punteros a this)
+    MqttTelemetry(const MqttTelemetry&) = delete;
+    MqttTelemetry& operator=(const MqttTelemetry&) = delete;
+
+    // user = nullptr para un broker sin autenticación
+    bool begin(const char* host, uint16_t port, const char* user = nullptr, const char* password = nullptr);
+
+    const char* name() const override;
+    bool isConnected() const override;
+    void publish(const Telemetry::Sample* samples, uint8_t count, uint32_t time) override;
+    void update() override;
+
+    uint8_t getOutboxSize() const;
+    unsigned long getDroppedCount() const;
+    unsigned long getSentCount() const;
+    unsigned long getAckedCount() const;
+};
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <Arduino.h>
+#include "telemetry/TelemetrySink.h"
+
+/**
+ * @brief Trama binaria compacta de telemetría
+ *
+ * [0]     versión (FRAME_VERSION)
+ * [1..4]  hora Unix, uint32 little endian (0 = hora desconocida)
+ * [5..6]  secuencia, uint16 little endian (detecta pérdidas y duplicados)
+ * Después, por cada muestra: número de canal (1 byte) seguido del valor
+ * multiplicado por 10^decimales del canal, en varint zigzag (como protobuf).
+ *
+ * Una lectura típica ocupa 3 bytes (temperatura 23,4 °C -> canal 1, 468);
+ * las muestras NAN no se envían.
+ */
+namespace Telemetry {
+
+static const uint8_t FRAME_VERSION = 1;
+static const uint8_t FRAME_HEADER_SIZE = 7;
+static const uint8_t FRAME_MAX_SAMPLE_SIZE = 6; // Canal + varint de 32 bits
+
+// Bytes escritos, o 0 si la trama no cabe en el búfer
+size_t encodeFrame(uint8_t* buffer, size_t size, uint32_t time, uint16_t sequence,
+                   const Sample* samples, uint8_t count);
+
+} // namespace Telemetry
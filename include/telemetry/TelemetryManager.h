@@ -0,0 +1,41 @@
+#pragma once
+
+#include <Arduino.h>
+#include "config/config.h"
+#include "telemetry/TelemetrySink.h"
+
+class SensorManager;
+class ActuatorManager;
+class TimeManager;
+
+/**
+ * @brief Muestreo periódico de telemetría hacia los destinos registrados
+ *
+ * Cada TELEMETRY_INTERVAL lee sensores y actuadores una sola vez y entrega
+ * la misma muestra a todos los destinos. Blynk sigue con su propio envío en
+ * SensorManager (widgets de texto incluidos).
+ */
+class TelemetryManager {
+private:
+    SensorManager* sensorManager;
+    ActuatorManager* actuatorManager;
+    TimeManager* timeManager;
+    Telemetry::Sink* sinks[TELEMETRY_MAX_SINKS];
+    uint8_t sinkCount;
+    unsigned long lastSample;
+    bool initialized;
+
+    uint8_t collect(Telemetry::Sample* samples);
+
+public:
+    TelemetryManager();
+
+    bool begin(SensorManager* sensors, ActuatorManager* actuators, TimeManager* clock = nullptr);
+    bool addSink(Telemetry::Sink* sink);
+    // Llamar en cada iteración del loop
+    void update();
+    // ms hasta la próxima muestra
+    unsigned long getIdleTime() const;
+
+    uint8_t getSinkCount() const;
+};
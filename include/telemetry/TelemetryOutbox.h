@@ -0,0 +1,55 @@
+#pragma once
+
+#include <Arduino.h>
+#include "config/config.h"
+
+namespace Telemetry {
+
+/**
+ * @brief Cola acotada de tramas pendientes de confirmación (QoS 1)
+ *
+ * Cada trama se queda en la cola hasta que llega su PUBACK; si no llega en
+ * el plazo de reintento se vuelve a enviar. Con la cola llena se descarta la
+ * trama más antigua: en telemetría vale más el dato reciente. Solo se usa
+ * desde el loop; los PUBACK llegan por otra tarea y se le pasan con
+ * acknowledge() desde allí.
+ */
+class Outbox {
+public:
+    struct Entry {
+        uint16_t packetId;     // 0 = aún no enviada (o reenviar tras reconectar)
+        bool acked;
+        unsigned long sentAt;
+        uint8_t length;
+        uint8_t payload[TELEMETRY_MAX_FRAME];
+    };
+
+private:
+    Entry entries[MQTT_OUTBOX_SIZE];
+    uint8_t head;
+    uint8_t count;
+    unsigned long dropped;
+
+    Entry& at(uint8_t offset);
+    void popAcked();
+
+public:
+    Outbox();
+
+    // Slot for a new frame (drops the oldest one when full); commit() enqueues it
+    uint8_t* reserve();
+    void commit(uint8_t length);
+
+    // Oldest frame that is unsent or whose PUBACK timed out, or nullptr
+    Entry* nextToSend(unsigned long now, unsigned long retryInterval, uint8_t maxInFlight);
+    void markSent(Entry* entry, uint16_t packetId, unsigned long now);
+    bool acknowledge(uint16_t packetId);
+    // Nueva sesión: los identificadores anteriores ya no valen
+    void resetInFlight();
+
+    uint8_t size() const;
+    uint8_t inFlight() const;
+    unsigned long getDroppedCount() const;
+};
+
+} // namespace Telemetry
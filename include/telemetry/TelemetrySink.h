@@ -0,0 +1,103 @@
+#pragma once
+
+#include <Arduino.h>
+
+/**
+ * @brief Telemetría independiente del transporte
+ *
+ * TelemetryManager toma cada TELEMETRY_INTERVAL una muestra de los sensores
+ * y actuadores y la entrega a todos los destinos registrados. Cada canal se
+ * identifica por un número fijo (CHANNELS); los destinos deciden cómo
+ * codificarlo: MQTT lo empaqueta en binario, otro destino podría usar la
+ * clave de texto. Los números de canal no se reutilizan nunca: un canal
+ * retirado deja su hueco para no romper a los consumidores existentes.
+ */
+namespace Telemetry {
+
+enum Channel : uint8_t {
+    CH_TEMPERATURE = 1,
+    CH_HUMIDITY = 2,
+    CH_HEAT_INDEX = 3,
+    CH_LUX = 4,
+    CH_LIGHT_LUX = 5,
+    CH_SOIL_MOISTURE = 6,
+    CH_SOIL_MOISTURE_RS485 = 7,
+    CH_SOIL_TEMPERATURE = 8,
+    CH_SOIL_EC = 9,
+    CH_SOIL_PH = 10,
+    CH_WATER_LEVEL = 11,
+    CH_WATER_PERCENTAGE = 12,
+    CH_FAN = 13,
+    CH_WATER_PUMP = 14,
+    CH_HEATER = 15,
+    CH_LED_STRIP = 16,
+    CH_VENTILATION = 17,
+};
+
+struct ChannelInfo {
+    Channel id;
+    const char* key;
+    const char* unit;
+    uint8_t decimals; // Resolución con la que se codifica el valor
+};
+
+inline constexpr ChannelInfo CHANNELS[] = {
+    {CH_TEMPERATURE, "temperature", "°C", 1},
+    {CH_HUMIDITY, "humidity", "%", 1},
+    {CH_HEAT_INDEX, "heatIndex", "°C", 1},
+    {CH_LUX, "lux", "lx", 0},
+    {CH_LIGHT_LUX, "lightLux", "lx", 0},
+    {CH_SOIL_MOISTURE, "soilMoisture", "%", 1},
+    {CH_SOIL_MOISTURE_RS485, "soilMoistureRS485", "%", 1},
+    {CH_SOIL_TEMPERATURE, "soilTemperature", "°C", 1},
+    {CH_SOIL_EC, "soilEC", "uS/cm", 0},
+    {CH_SOIL_PH, "soilPH", "pH", 2},
+    {CH_WATER_LEVEL, "waterLevel", "cm", 1},
+    {CH_WATER_PERCENTAGE, "waterPercentage", "%", 1},
+    {CH_FAN, "fan", "", 0},
+    {CH_WATER_PUMP, "waterPump", "", 0},
+    {CH_HEATER, "heater", "", 0},
+    {CH_LED_STRIP, "ledStrip", "", 0},
+    {CH_VENTILATION, "ventilationOpen", "", 0},
+};
+inline constexpr uint8_t CHANNEL_COUNT = sizeof(CHANNELS) / sizeof(CHANNELS[0]);
+
+constexpr const ChannelInfo* findChannel(uint8_t id) {
+    for (const ChannelInfo& channel : CHANNELS) {
+        if (channel.id == id) return &channel;
+    }
+    return nullptr;
+}
+
+constexpr bool channelsUnique() {
+    for (uint8_t i = 0; i < CHANNEL_COUNT; i++) {
+        for (uint8_t j = i + 1; j < CHANNEL_COUNT; j++) {
+            if (CHANNELS[i].id == CHANNELS[j].id) return false;
+        }
+    }
+    return true;
+}
+static_assert(channelsUnique(), "Telemetry channel ids must be unique");
+
+struct Sample {
+    Channel channel;
+    float value;
+};
+
+/**
+ * @brief Destino de telemetría (MQTT, ...)
+ * publish() no debe bloquear: un destino sin conexión guarda o descarta.
+ */
+class Sink {
+public:
+    virtual ~Sink() = default;
+
+    virtual const char* name() const = 0;
+    virtual bool isConnected() const = 0;
+    // Muestras tomadas en el mismo instante; time = 0 si la hora no es válida
+    virtual void publish(const Sample* samples, uint8_t count, uint32_t time) = 0;
+    // Llamar en cada iteración del loop (reconexión, reintentos)
+    virtual void update() = 0;
+};
+
+} // namespace Telemetry
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <Arduino.h>
+
+/**
+ * @brief Escritor JSON en streaming con límite de tamaño
+ *
+ * Escribe directamente sobre un Print (p. ej. el búfer de la respuesta HTTP)
+ * sin construir String ni documentos intermedios. Nunca escribe más de
+ * `limit` bytes: si un valor no cabe se descarta con todo lo que venga
+ * detrás y overflowed() pasa a true, para que el llamante responda con error
+ * en lugar de enviar un JSON cortado.
+ *
+ * NAN e infinito se escriben como null (sensor sin lectura).
+ */
+class JsonWriter {
+public:
+    static const uint8_t MAX_DEPTH = 8;
+
+private:
+    Print& out;
+    size_t limit;
+    size_t written;
+    bool overflow;
+    uint8_t depth;
+    bool hasItems[MAX_DEPTH]; // Nivel con elementos ya escritos (falta la coma)
+
+    bool write(const char* text, size_t length);
+    bool write(const char* text);
+    bool separator();
+    bool key(const char* name);
+    bool string(const char* text);
+    bool number(float value, uint8_t decimals);
+    bool number(long value);
+    bool open(char bracket);
+    bool close(char bracket);
+
+public:
+    JsonWriter(Print& output, size_t maxBytes);
+
+    // Objects and arrays (key = nullptr inside arrays or at the root)
+    bool beginObject(const char* name = nullptr);
+    bool endObject();
+    bool beginArray(const char* name = nullptr);
+    bool endArray();
+
+    // Object members
+    bool add(const char* name, float value, uint8_t decimals = 2);
+    bool add(const char* name, long value);
+    bool add(const char* name, unsigned long value);
+    bool add(const char* name, int value);
+    bool add(const char* name, bool value);
+    bool add(const char* name, const char* value);
+    bool addNull(const char* name);
+
+    // Array elements
+    bool add(float value, uint8_t decimals = 2);
+    bool add(long value);
+
+    size_t size() const;
+    bool overflowed() const;
+};
+
+/**
+ * @brief Destino Print sobre un búfer fijo (mensajes que se envían después)
+ * Siempre termina en '\0'; lo que no cabe se descarta.
+ */
+class JsonBuffer : public Print {
+private:
+    char* data;
+    size_t capacity;
+    size_t length;
+
+public:
+    JsonBuffer(char* buffer, size_t bufferSize);
+
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* buffer, size_t size) override;
+
+    void clear();
+    const char* c_str() const;
+    size_t size() const;
+};
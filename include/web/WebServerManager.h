@@ -0,0 +1,171 @@
+#pragma once
+
+#include <Arduino.h>
+#include <ESPAsyncWebServer.h>
+#include "config/config.h"
+
+class SensorManager;
+class ActuatorManager;
+class LogicManager;
+class TimeManager;
+class JsonWriter;
+
+/**
+ * @brief Panel web local y API JSON (sin depender de la nube de Blynk)
+ *
+ * - GET  /api/snapshot  lectura actual de sensores y estado del sistema
+ * - GET  /api/actuators estado de los actuadores
+ * - GET  /api/targets   objetivos; PUT con un objeto JSON parcial los cambia
+ * - GET  /api/history   últimas WEB_HISTORY_SIZE muestras
+ * - GET  /metrics       métricas en formato Prometheus (system/Metrics.h)
+ * - WS   /ws            estado completo al conectar y después solo los cambios
+ * - /                   panel estático desde LittleFS (index.html.gz)
+ *
+ * Las peticiones se atienden en la tarea de AsyncTCP, nunca en el loop. El
+ * loop publica cada WEB_SNAPSHOT_INTERVAL ms una copia de los datos y aplica
+ * los objetivos recibidos; las peticiones solo leen esa copia, de modo que
+ * varios clientes a la vez no tocan los sensores ni retrasan el control.
+ * Las respuestas se escriben con JsonWriter en el búfer de la respuesta,
+ * con un tamaño máximo fijo por ruta.
+ *
+ * El canal en vivo compara cada copia con la última enviada (con banda muerta
+ * por campo) y manda un único mensaje por trama con los campos que cambiaron.
+ * Un cliente que no vacía su cola se desconecta en lugar de acumular memoria.
+ */
+class WebServerManager {
+private:
+    struct Snapshot {
+        unsigned long uptime;      // s
+        time_t time;               // 0 = hora desconocida
+        // Sensores
+        float temperature;
+        float humidity;
+        float heatIndex;
+        float lux;
+        float lightLux;
+        float soilMoisture;
+        float soilMoistureRS485;
+        float soilTemperature;
+        float soilEC;
+        float soilPH;
+        float waterLevel;
+        float waterPercentage;
+        // Actuadores
+        bool fan;
+        bool waterPump;
+        bool heater;
+        bool ledStrip;
+        bool ventilationOpen;
+        // Sistema
+        bool autoMode;
+        bool systemEnabled;
+        bool autotuning;
+    };
+
+    struct HistorySample {
+        time_t time;
+        float temperature;
+        float humidity;
+        float soilMoisture;
+        float lux;
+    };
+
+    // Fields of the snapshot, shared by the REST routes and the live channel
+    struct SensorField {
+        const char* key;
+        float Snapshot::* value;
+        float deadband;   // Cambio mínimo que se envía por el canal en vivo
+        uint8_t decimals;
+    };
+    struct FlagField {
+        const char* key;
+        bool Snapshot::* value;
+    };
+    static const SensorField SENSOR_FIELDS[];
+    static const uint8_t SENSOR_FIELD_COUNT;
+    static const FlagField ACTUATOR_FIELDS[];
+    static const uint8_t ACTUATOR_FIELD_COUNT;
+    static const FlagField SYSTEM_FIELDS[];
+    static const uint8_t SYSTEM_FIELD_COUNT;
+
+    struct TargetKey {
+        const char* key;
+        uint8_t pin; // Entrada en BlynkTargets::PIN_TABLE (campo y rango)
+    };
+    static const uint8_t TARGET_KEY_COUNT = 8;
+    static const TargetKey TARGET_KEYS[TARGET_KEY_COUNT];
+
+    AsyncWebServer server;
+    AsyncWebSocket liveSocket;
+    SensorManager* sensorManager;
+    ActuatorManager* actuatorManager;
+    LogicManager* logicManager;
+    TimeManager* timeManager;
+
+    // Shared with the AsyncTCP task, guarded by dataMutex
+    SemaphoreHandle_t dataMutex;
+    Snapshot snapshot;
+    HistorySample history[WEB_HISTORY_SIZE];
+    uint8_t historyHead;
+    uint8_t historyCount;
+    float targetValues[TARGET_KEY_COUNT];   // Copia de targets para GET
+    float pendingTargets[TARGET_KEY_COUNT]; // NAN = sin cambio pendiente
+    bool targetsPending;
+    uint32_t liveClients[WEB_LIVE_MAX_CLIENTS]; // Ids de AsyncWebSocketClient
+    uint8_t liveClientCount;
+
+    // Live channel baseline (loop only)
+    Snapshot lastPushed;
+    unsigned long droppedClients;
+
+    unsigned long lastSnapshot;
+    unsigned long lastHistorySample;
+    bool running;
+    unsigned long requestCount;
+
+    // Loop side
+    void publishSnapshot(unsigned long now);
+    void applyPendingTargets();
+    void pushChanges(const Snapshot& fresh);
+
+    // AsyncTCP side
+    void handleSnapshot(AsyncWebServerRequest* request);
+    void handleActuators(AsyncWebServerRequest* request);
+    void handleGetTargets(AsyncWebServerRequest* request);
+    void handlePutTargets(AsyncWebServerRequest* request, uint8_t* data, size_t length, size_t index, size_t total);
+    void handleHistory(AsyncWebServerRequest* request);
+    void handleMetrics(AsyncWebServerRequest* request);
+    void handleProfile(AsyncWebServerRequest* request);
+    void handleLiveEvent(AsyncWebSocketClient* client, AwsEventType type);
+    void removeLiveClient(uint32_t id);
+    // previous = nullptr writes every field, otherwise only the changed ones
+    static void writeSnapshot(JsonWriter& json, const Snapshot& current, const Snapshot* previous);
+    static bool writeSensorFields(JsonWriter& json, const Snapshot& current, const Snapshot* previous);
+    static bool writeFlagFields(JsonWriter& json, const char* group, const FlagField* fields, uint8_t count,
+                                const Snapshot& current, const Snapshot* previous);
+    void sendJson(AsyncWebServerRequest* request, AsyncResponseStream* response, const JsonWriter& json);
+    void sendError(AsyncWebServerRequest* request, int code, const char* message);
+    int8_t findTargetKey(const char* key, size_t length) const;
+    bool parseTargets(const char* body, size_t length, float* values, const char*& error) const;
+
+public:
+    WebServerManager();
+    ~WebServerManager();
+
+    // Deshabilitar copia y asignación (el servidor guarda punteros a this)
+    WebServerManager(const WebServerManager&) = delete;
+    WebServerManager& operator=(const WebServerManager&) = delete;
+
+    // Llamar con WiFi iniciado y los demás gestores ya listos
+    bool begin(SensorManager* sensors, ActuatorManager* actuators, LogicManager* logic,
+               TimeManager* clock = nullptr);
+    // Llamar en cada iteración del loop
+    void update();
+    // ms hasta el próximo envío en directo (ULONG_MAX sin clientes: se refresca al despertar el loop)
+    unsigned long getIdleTime() const;
+
+    bool isRunning() const;
+    unsigned long getRequestCount() const;
+    uint8_t getLiveClientCount() const;
+    unsigned long getDroppedClientCount() const;
+};
@@ -11,6 +11,7 @@ private:
     unsigned long connectionTimeout;
     unsigned long retryInterval;
     unsigned long lastConnectionAttempt;
+    bool wasConnected;            // Último estado notificado a los callbacks
     
 public:
     WiFiManager();
@@ -20,6 +21,7 @@ public:
     bool begin();
     bool connectToWiFi();
     bool connectToWiFi(String ssid, String password);
+    bool startConnection();       // Sin bloquear: el resultado llega por onConnect
     
     // Configuración
     void setConnectionTimeout(unsigned long timeout);
@@ -0,0 +1,155 @@
+#include "AsyncMqttClient.h"
+#include "NativeHal.h"
+#include "NativeHalInternal.h"
+
+namespace {
+
+NativeHal::MqttBroker* broker = nullptr;
+AsyncMqttClient* activeClient = nullptr; // The connected client, if any
+
+} // namespace
+
+AsyncMqttClient::AsyncMqttClient() :
+    clientId(""),
+    cleanSession(true),
+    isConnected(false),
+    nextPacketId(1)
+{
+}
+
+AsyncMqttClient::~AsyncMqttClient() {
+    if (activeClient == this) {
+        activeClient = nullptr;
+    }
+}
+
+AsyncMqttClient& AsyncMqttClient::setServer(const char* host, uint16_t port) {
+    (void)host;
+    (void)port;
+    return *this;
+}
+
+AsyncMqttClient& AsyncMqttClient::setClientId(const char* id) {
+    clientId = id;
+    return *this;
+}
+
+AsyncMqttClient& AsyncMqttClient::setKeepAlive(uint16_t keepAlive) {
+    (void)keepAlive;
+    return *this;
+}
+
+AsyncMqttClient& AsyncMqttClient::setCleanSession(bool clean) {
+    cleanSession = clean;
+    return *this;
+}
+
+AsyncMqttClient& AsyncMqttClient::setWill(const char* topic, uint8_t qos, bool retain, const char* payload,
+                                          size_t length) {
+    (void)topic;
+    (void)qos;
+    (void)retain;
+    (void)payload;
+    (void)length;
+    return *this;
+}
+
+AsyncMqttClient& AsyncMqttClient::setCredentials(const char* username, const char* password) {
+    (void)username;
+    (void)password;
+    return *this;
+}
+
+AsyncMqttClient& AsyncMqttClient::onConnect(OnConnectUserCallback callback) {
+    onConnectCallback = callback;
+    return *this;
+}
+
+AsyncMqttClient& AsyncMqttClient::onDisconnect(OnDisconnectUserCallback callback) {
+    onDisconnectCallback = callback;
+    return *this;
+}
+
+AsyncMqttClient& AsyncMqttClient::onPublish(OnPublishUserCallback callback) {
+    onPublishCallback = callback;
+    return *this;
+}
+
+bool AsyncMqttClient::connected() const {
+    return isConnected;
+}
+
+void AsyncMqttClient::connect() {
+    if (isConnected) return;
+
+    if (!broker || !broker->onConnect(clientId, cleanSession)) {
+        if (onDisconnectCallback) onDisconnectCallback(AsyncMqttClientDisconnectReason::TCP_DISCONNECTED);
+        return;
+    }
+    isConnected = true;
+    activeClient = this;
+    if (onConnectCallback) onConnectCallback(false);
+}
+
+void AsyncMqttClient::disconnect(bool force) {
+    (void)force;
+    dropConnection();
+}
+
+uint16_t AsyncMqttClient::publish(const char* topic, uint8_t qos, bool retain, const char* payload, size_t length,
+                                  bool dup, uint16_t messageId) {
+    if (!isConnected || !broker) return 0;
+    if (payload && length == 0) {
+        length = strlen(payload);
+    }
+
+    uint16_t packetId = 0;
+    if (qos > 0) {
+        packetId = messageId;
+        if (packetId == 0) {
+            packetId = nextPacketId++;
+            if (nextPacketId == 0) nextPacketId = 1;
+        }
+    }
+    if (!broker->onPublish(topic, qos, retain, (const uint8_t*)payload, length, dup, packetId)) {
+        return 0;
+    }
+    return qos > 0 ? packetId : 1;
+}
+
+void AsyncMqttClient::deliverPublishAck(uint16_t packetId) {
+    if (isConnected && onPublishCallback) onPublishCallback(packetId);
+}
+
+void AsyncMqttClient::dropConnection() {
+    if (!isConnected) return;
+    isConnected = false;
+    if (activeClient == this) {
+        activeClient = nullptr;
+    }
+    if (onDisconnectCallback) onDisconnectCallback(AsyncMqttClientDisconnectReason::TCP_DISCONNECTED);
+}
+
+namespace NativeHal {
+
+void attachMqttBroker(MqttBroker* mqttBroker) {
+    broker = mqttBroker;
+}
+
+void mqttPublishAck(uint16_t packetId) {
+    if (activeClient) activeClient->deliverPublishAck(packetId);
+}
+
+void mqttDropConnection() {
+    if (activeClient) activeClient->dropConnection();
+}
+
+namespace Internal {
+
+void resetMqtt() {
+    broker = nullptr;
+    activeClient = nullptr;
+}
+
+} // namespace Internal
+} // namespace NativeHal
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <functional>
+#include "Arduino.h"
+
+// Cliente MQTT de marvinroger/async-mqtt-client sobre el broker en proceso de
+// NativeHal (attachMqttBroker). Sin TCP: connect() y publish() llegan al broker
+// en el acto, y los PUBACK y cortes los entrega el banco de pruebas
+
+enum class AsyncMqttClientDisconnectReason : uint8_t {
+    TCP_DISCONNECTED = 0,
+    MQTT_UNACCEPTABLE_PROTOCOL_VERSION = 1,
+    MQTT_IDENTIFIER_REJECTED = 2,
+    MQTT_SERVER_UNAVAILABLE = 3,
+    MQTT_MALFORMED_CREDENTIALS = 4,
+    MQTT_NOT_AUTHORIZED = 5,
+};
+
+class AsyncMqttClient {
+public:
+    typedef std::function<void(bool sessionPresent)> OnConnectUserCallback;
+    typedef std::function<void(AsyncMqttClientDisconnectReason reason)> OnDisconnectUserCallback;
+    typedef std::function<void(uint16_t packetId)> OnPublishUserCallback;
+
+private:
+    const char* clientId;
+    bool cleanSession;
+    bool isConnected;
+    uint16_t nextPacketId;
+    OnConnectUserCallback onConnectCallback;
+    OnDisconnectUserCallback onDisconnectCallback;
+    OnPublishUserCallback onPublishCallback;
+
+public:
+    AsyncMqttClient();
+    ~AsyncMqttClient();
+
+    AsyncMqttClient& setServer(const char* host, uint16_t port);
+    AsyncMqttClient& setClientId(const char* id);
+    AsyncMqttClient& setKeepAlive(uint16_t keepAlive);
+    AsyncMqttClient& setCleanSession(bool clean);
+    AsyncMqttClient& setWill(const char* topic, uint8_t qos, bool retain, const char* payload = nullptr,
+                             size_t length = 0);
+    AsyncMqttClient& setCredentials(const char* username, const char* password = nullptr);
+
+    AsyncMqttClient& onConnect(OnConnectUserCallback callback);
+    AsyncMqttClient& onDisconnect(OnDisconnectUserCallback callback);
+    AsyncMqttClient& onPublish(OnPublishUserCallback callback);
+
+    bool connected() const;
+    void connect();
+    void disconnect(bool force = false);
+    // Identificador del paquete (QoS 1), 1 con QoS 0, o 0 si no se pudo enviar
+    uint16_t publish(const char* topic, uint8_t qos, bool retain, const char* payload = nullptr,
+                     size_t length = 0, bool dup = false, uint16_t messageId = 0);
+
+    // Del broker en proceso (NativeHal::mqttPublishAck, mqttDropConnection)
+    void deliverPublishAck(uint16_t packetId);
+    void dropConnection();
+};
@@ -0,0 +1,79 @@
+#include "DHT.h"
+#include "NativeHal.h"
+
+namespace {
+
+const unsigned long MIN_INTERVAL_MS = 2000;
+const uint32_t START_SIGNAL_US = 1100;
+const uint32_t FRAME_US = 4800;        // Respuesta + 40 bits (~50 % unos)
+const uint32_t TIMEOUT_US = 1000;      // Sin respuesta: espera de expectPulse
+
+} // namespace
+
+DHT::DHT(uint8_t pin, uint8_t type, uint8_t count)
+    : pin(pin), type(type), lastResult(false), hasRead(false), lastReadTime(0), temperature(NAN),
+      humidity(NAN) {
+    (void)count;
+}
+
+void DHT::begin(uint8_t usec) {
+    (void)usec;
+    pinMode(pin, INPUT_PULLUP);
+}
+
+bool DHT::read(bool force) {
+    unsigned long now = millis();
+    if (!force && hasRead && now - lastReadTime < MIN_INTERVAL_MS) {
+        return lastResult;
+    }
+    hasRead = true;
+    lastReadTime = now;
+
+    // La librería original bloquea durante toda la transacción
+    delayMicroseconds(START_SIGNAL_US);
+    if (!NativeHal::isDht22Connected()) {
+        delayMicroseconds(TIMEOUT_US);
+        lastResult = false;
+        return false;
+    }
+    delayMicroseconds(FRAME_US);
+    // Misma resolución que la trama (décimas)
+    temperature = roundf(NativeHal::getDht22Temperature() * 10.0f) / 10.0f;
+    humidity = roundf(NativeHal::getDht22Humidity() * 10.0f) / 10.0f;
+    lastResult = true;
+    return true;
+}
+
+float DHT::readTemperature(bool fahrenheit, bool force) {
+    if (!read(force)) {
+        return NAN;
+    }
+    return fahrenheit ? temperature * 1.8f + 32.0f : temperature;
+}
+
+float DHT::readHumidity(bool force) {
+    return read(force) ? humidity : NAN;
+}
+
+// Fórmula de la NOAA, como la librería de Adafruit
+float DHT::computeHeatIndex(float temperature, float percentHumidity, bool isFahrenheit) {
+    float fahrenheit = isFahrenheit ? temperature : temperature * 1.8f + 32.0f;
+    float hi = 0.5f * (fahrenheit + 61.0f + ((fahrenheit - 68.0f) * 1.2f) + (percentHumidity * 0.094f));
+
+    if (hi > 79.0f) {
+        hi = -42.379f + 2.04901523f * fahrenheit + 10.14333127f * percentHumidity +
+             -0.22475541f * fahrenheit * percentHumidity + -0.00683783f * fahrenheit * fahrenheit +
+             -0.05481717f * percentHumidity * percentHumidity +
+             0.00122874f * fahrenheit * fahrenheit * percentHumidity +
+             0.00085282f * fahrenheit * percentHumidity * percentHumidity +
+             -0.00000199f * fahrenheit * fahrenheit * percentHumidity * percentHumidity;
+
+        if (percentHumidity < 13.0f && fahrenheit >= 80.0f && fahrenheit <= 112.0f) {
+            hi -= ((13.0f - percentHumidity) * 0.25f) * sqrtf((17.0f - fabsf(fahrenheit - 95.0f)) * 0.05882f);
+        } else if (percentHumidity > 85.0f && fahrenheit >= 80.0f && fahrenheit <= 87.0f) {
+            hi += ((percentHumidity - 85.0f) * 0.1f) * ((87.0f - fahrenheit) * 0.2f);
+        }
+    }
+
+    return isFahrenheit ? hi : (hi - 32.0f) * 0.55555f;
+}
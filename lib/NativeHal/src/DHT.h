@@ -0,0 +1,32 @@
+#pragma once
+
+#include "Arduino.h"
+
+#define DHT11 11
+#define DHT22 22
+
+/**
+ * @brief Librería DHT de Adafruit sobre el DHT22 simulado
+ *
+ * read() cuesta en el reloj simulado lo mismo que en el ESP32 (señal de
+ * inicio y trama de 40 bits con bit-banging) y, como la original, devuelve
+ * la lectura anterior si no han pasado 2 s.
+ */
+class DHT {
+private:
+    uint8_t pin;
+    uint8_t type;
+    bool lastResult;
+    bool hasRead;
+    unsigned long lastReadTime;
+    float temperature;
+    float humidity;
+
+public:
+    DHT(uint8_t pin, uint8_t type, uint8_t count = 6);
+    void begin(uint8_t usec = 55);
+    bool read(bool force = false);
+    float readTemperature(bool fahrenheit = false, bool force = false);
+    float readHumidity(bool force = false);
+    float computeHeatIndex(float temperature, float percentHumidity, bool isFahrenheit = true);
+};
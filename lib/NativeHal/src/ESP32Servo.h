@@ -0,0 +1,71 @@
+#pragma once
+
+#include "Arduino.h"
+
+class ESP32PWM {
+public:
+    static void allocateTimer(int timer) { (void)timer; }
+};
+
+/**
+ * @brief ESP32Servo sobre el LEDC simulado
+ * El ancho de pulso se lee con NativeHal::getLedcDuty() del canal asignado.
+ */
+class Servo {
+private:
+    static const uint8_t FIRST_CHANNEL = 8;    // ESP32Servo reserva los canales altos
+    static uint8_t nextChannel;
+
+    int pin;
+    int channel;
+    int periodHertz;
+    int minMicros;
+    int maxMicros;
+    int pulseMicros;
+
+public:
+    Servo() : pin(-1), channel(-1), periodHertz(50), minMicros(544), maxMicros(2400), pulseMicros(0) {}
+
+    void setPeriodHertz(int hertz) { periodHertz = hertz; }
+
+    int attach(int servoPin, int minPulse = 544, int maxPulse = 2400) {
+        if (channel < 0) {
+            if (nextChannel >= 16) {
+                return 0;
+            }
+            channel = nextChannel++;
+        }
+        pin = servoPin;
+        minMicros = minPulse;
+        maxMicros = maxPulse;
+        ledcSetup(channel, periodHertz, 16);
+        ledcAttachPin(pin, channel);
+        return 1;
+    }
+
+    void detach() {
+        if (pin >= 0) {
+            ledcDetachPin(pin);
+            pin = -1;
+        }
+    }
+
+    void write(int angle) {
+        angle = constrain(angle, 0, 180);
+        writeMicroseconds((int)map(angle, 0, 180, minMicros, maxMicros));
+    }
+
+    void writeMicroseconds(int micros) {
+        pulseMicros = constrain(micros, minMicros, maxMicros);
+        if (channel >= 0) {
+            // Ciclo de trabajo con 16 bits sobre el periodo
+            ledcWrite(channel, (uint32_t)((uint64_t)pulseMicros * 65535 * periodHertz / 1000000));
+        }
+    }
+
+    int read() { return (int)map(pulseMicros, minMicros, maxMicros, 0, 180); }
+    int readMicroseconds() { return pulseMicros; }
+    bool attached() { return pin >= 0; }
+};
+
+inline uint8_t Servo::nextChannel = Servo::FIRST_CHANNEL;
@@ -0,0 +1,130 @@
+#include "esp_timer.h"
+#include "NativeHal.h"
+#include "NativeHalInternal.h"
+
+#include <vector>
+
+struct esp_timer {
+    esp_timer_cb_t callback;
+    void* arg;
+    bool armed;
+    uint64_t dueAt;
+    uint64_t period;  // 0: one-shot
+};
+
+namespace {
+
+std::vector<esp_timer*> timers;
+bool running = false;
+
+} // namespace
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t* args, esp_timer_handle_t* handle) {
+    if (!args || !args->callback || !handle) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    esp_timer* timer = new esp_timer{args->callback, args->arg, false, 0, 0};
+    timers.push_back(timer);
+    *handle = timer;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeoutMicros) {
+    if (!timer || timer->armed) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    timer->armed = true;
+    timer->dueAt = NativeHal::nowMicros() + timeoutMicros;
+    timer->period = 0;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, uint64_t periodMicros) {
+    if (!timer || timer->armed || periodMicros == 0) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    timer->armed = true;
+    timer->dueAt = NativeHal::nowMicros() + periodMicros;
+    timer->period = periodMicros;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_stop(esp_timer_handle_t timer) {
+    if (!timer || !timer->armed) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    timer->armed = false;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_delete(esp_timer_handle_t timer) {
+    if (!timer) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    for (size_t i = 0; i < timers.size(); i++) {
+        if (timers[i] == timer) {
+            timers.erase(timers.begin() + i);
+            break;
+        }
+    }
+    delete timer;
+    return ESP_OK;
+}
+
+int64_t esp_timer_get_time() {
+    return (int64_t)NativeHal::nowMicros();
+}
+
+namespace NativeHal {
+namespace Internal {
+
+// A callback may advance the clock itself (delay), so guard against re-entry
+void runDueTimers() {
+    if (running) {
+        return;
+    }
+    running = true;
+    bool fired = true;
+    while (fired) {
+        fired = false;
+        for (size_t i = 0; i < timers.size(); i++) {
+            esp_timer* timer = timers[i];
+            if (!timer->armed || timer->dueAt > nowMicros()) {
+                continue;
+            }
+            if (timer->period) {
+                timer->dueAt += timer->period;
+            } else {
+                timer->armed = false;
+            }
+            timer->callback(timer->arg);
+            fired = true;
+            break;  // The callback may have created or deleted timers
+        }
+    }
+    running = false;
+}
+
+// False while a callback runs: its own delay() must not dispatch timers again
+bool nextTimerDue(uint64_t until, uint64_t& dueAt) {
+    if (running) {
+        return false;
+    }
+    bool found = false;
+    for (esp_timer* timer : timers) {
+        if (timer->armed && timer->dueAt <= until && (!found || timer->dueAt < dueAt)) {
+            dueAt = timer->dueAt;
+            found = true;
+        }
+    }
+    return found;
+}
+
+void resetTimers() {
+    for (esp_timer* timer : timers) {
+        timer->armed = false;
+    }
+}
+
+} // namespace Internal
+} // namespace NativeHal
@@ -0,0 +1,105 @@
+#include "HardwareSerial.h"
+#include "NativeHal.h"
+
+#include <cstdio>
+
+HardwareSerial Serial(0);
+HardwareSerial Serial1(1);
+HardwareSerial Serial2(2);
+
+size_t Print::write(const uint8_t* buffer, size_t size) {
+    size_t written = 0;
+    for (size_t i = 0; i < size; i++) {
+        written += write(buffer[i]);
+    }
+    return written;
+}
+
+size_t Print::printf(const char* format, ...) {
+    char stackBuffer[256];
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(stackBuffer, sizeof(stackBuffer), format, args);
+    va_end(args);
+    if (length < 0) {
+        return 0;
+    }
+    if ((size_t)length < sizeof(stackBuffer)) {
+        return write((const uint8_t*)stackBuffer, (size_t)length);
+    }
+
+    std::vector<char> heapBuffer((size_t)length + 1);
+    va_start(args, format);
+    vsnprintf(heapBuffer.data(), heapBuffer.size(), format, args);
+    va_end(args);
+    return write((const uint8_t*)heapBuffer.data(), (size_t)length);
+}
+
+void HardwareSerial::begin(unsigned long baud, uint32_t config, int8_t rxPin, int8_t txPin) {
+    (void)config;
+    (void)rxPin;
+    (void)txPin;
+    baudRate = baud;
+}
+
+void HardwareSerial::end() {
+    txPending.clear();
+    rxBuffer.clear();
+}
+
+void HardwareSerial::deliver() {
+    if (txPending.empty()) {
+        return;
+    }
+    std::vector<uint8_t> frame;
+    frame.swap(txPending);
+    NativeHal::UartPeer* peer = NativeHal::getUartPeer(uart);
+    if (peer) {
+        peer->onTransmit(*this, frame.data(), frame.size());
+    }
+}
+
+int HardwareSerial::available() {
+    deliver();
+    return (int)rxBuffer.size();
+}
+
+int HardwareSerial::read() {
+    deliver();
+    if (rxBuffer.empty()) {
+        return -1;
+    }
+    uint8_t c = rxBuffer.front();
+    rxBuffer.pop_front();
+    return c;
+}
+
+int HardwareSerial::peek() {
+    deliver();
+    return rxBuffer.empty() ? -1 : rxBuffer.front();
+}
+
+void HardwareSerial::flush() {
+    if (uart == 0) {
+        fflush(stdout);
+        return;
+    }
+    deliver();
+}
+
+size_t HardwareSerial::write(uint8_t c) {
+    return write(&c, 1);
+}
+
+size_t HardwareSerial::write(const uint8_t* buffer, size_t size) {
+    if (uart == 0) {
+        NativeHal::consoleWrite(buffer, size);
+        return size;
+    }
+    txPending.insert(txPending.end(), buffer, buffer + size);
+    return size;
+}
+
+void HardwareSerial::injectRx(const uint8_t* data, size_t length) {
+    rxBuffer.insert(rxBuffer.end(), data, data + length);
+}
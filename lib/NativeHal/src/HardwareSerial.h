@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstdarg>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+#include "WString.h"
+
+#define SERIAL_8N1 0x800001c
+
+/**
+ * @brief Print de Arduino: texto y números sobre write()
+ */
+class Print {
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t* buffer, size_t size);
+    virtual void flush() {}
+    size_t write(const char* text) { return text ? write((const uint8_t*)text, strlen(text)) : 0; }
+
+    size_t print(const char* text) { return write(text); }
+    size_t print(const String& text) { return write(text.c_str()); }
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(unsigned char number, int base = 10) { return print(String(number, (unsigned char)base)); }
+    size_t print(int number, int base = 10) { return print(String(number, (unsigned char)base)); }
+    size_t print(unsigned int number, int base = 10) { return print(String(number, (unsigned char)base)); }
+    size_t print(long number, int base = 10) { return print(String(number, (unsigned char)base)); }
+    size_t print(unsigned long number, int base = 10) { return print(String(number, (unsigned char)base)); }
+    size_t print(long long number, int base = 10) { return print(String(number, (unsigned char)base)); }
+    size_t print(unsigned long long number, int base = 10) { return print(String(number, (unsigned char)base)); }
+    size_t print(double number, int digits = 2) { return print(String(number, (unsigned int)digits)); }
+
+    size_t println() { return write("\r\n"); }
+    template <typename T>
+    size_t println(const T& value) { return print(value) + println(); }
+    template <typename T>
+    size_t println(const T& value, int format) { return print(value, format) + println(); }
+
+    size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3)));
+};
+
+/**
+ * @brief UART simulada
+ *
+ * La UART 0 (Serial) escribe en la consola. En las UART 1 y 2 lo transmitido
+ * se entrega al NativeHal::UartPeer asociado al vaciar (flush) o al leer,
+ * y el peer responde con injectRx().
+ */
+class HardwareSerial : public Print {
+private:
+    uint8_t uart;
+    unsigned long baudRate;
+    std::vector<uint8_t> txPending;
+    std::deque<uint8_t> rxBuffer;
+
+    void deliver();
+
+public:
+    explicit HardwareSerial(uint8_t uartNumber) : uart(uartNumber), baudRate(0) {}
+
+    void begin(unsigned long baud, uint32_t config = SERIAL_8N1, int8_t rxPin = -1, int8_t txPin = -1);
+    void end();
+    int available();
+    int read();
+    int peek();
+    void flush();
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* buffer, size_t size) override;
+    using Print::write;
+    void setTimeout(unsigned long timeout) { (void)timeout; }
+    operator bool() const { return true; }
+
+    // Lado del dispositivo simulado
+    void injectRx(const uint8_t* data, size_t length);
+    uint8_t getUartNumber() const { return uart; }
+    unsigned long getBaudRate() const { return baudRate; }
+};
+
+extern HardwareSerial Serial;
+extern HardwareSerial Serial1;
+extern HardwareSerial Serial2;
@@ -0,0 +1,387 @@
+#include "NativeHal.h"
+#include "NativeHalInternal.h"
+#include "Arduino.h"
+#include "WiFi.h"
+
+#include <cstdio>
+#include <random>
+
+namespace {
+
+const uint8_t PIN_COUNT = 40;
+const uint8_t LEDC_CHANNELS = 16;
+
+struct PinState {
+    int mode;
+    int outputLevel;
+    int inputLevel;
+    uint16_t analogValue;
+    unsigned long pulseWidth;
+    uint32_t writes;
+    uint64_t lowSince;
+};
+
+struct LedcState {
+    uint32_t duty;
+    int pin;
+};
+
+uint64_t clockMicros = 0;
+PinState pins[PIN_COUNT];
+LedcState ledc[LEDC_CHANNELS];
+NativeHal::UartPeer* uartPeers[3] = {nullptr, nullptr, nullptr};
+float dhtTemperature = 22.0f;
+float dhtHumidity = 55.0f;
+bool dhtConnected = true;
+bool wifiConnected = false;
+int8_t wifiRssi = -60;
+bool consoleEnabled = true;
+uint32_t consoleBytes = 0;
+uint32_t freeHeap = 180000;
+std::mt19937 randomEngine(1);
+
+void resetPins() {
+    for (PinState& pin : pins) {
+        pin = {-1, LOW, HIGH, 0, 0, 0, 0};
+    }
+    for (LedcState& channel : ledc) {
+        channel = {0, -1};
+    }
+}
+
+bool validPin(uint8_t pin) {
+    return pin < PIN_COUNT;
+}
+
+// Static init order: the pins table must be ready before any global driver constructor runs
+struct PinInit {
+    PinInit() { resetPins(); }
+} pinInit;
+
+} // namespace
+
+namespace NativeHal {
+
+// ===== Reloj simulado =====
+
+uint64_t nowMicros() {
+    return clockMicros;
+}
+
+void advanceMicros(uint64_t micros) {
+    // Each timer fires at its own deadline, not at the end of the jump: a callback
+    // that drives a pin (DHT22 start signal) must see the right clock
+    uint64_t target = clockMicros + micros;
+    uint64_t dueAt;
+    while (Internal::nextTimerDue(target, dueAt)) {
+        if (dueAt > clockMicros) {
+            clockMicros = dueAt;
+        }
+        Internal::runDueTimers();
+    }
+    if (clockMicros < target) {
+        clockMicros = target;
+    }
+    Internal::runDueTimers();
+}
+
+void advanceMillis(uint32_t millis) {
+    advanceMicros((uint64_t)millis * 1000);
+}
+
+void reset() {
+    clockMicros = 0;
+    resetPins();
+    for (UartPeer*& peer : uartPeers) {
+        peer = nullptr;
+    }
+    dhtTemperature = 22.0f;
+    dhtHumidity = 55.0f;
+    dhtConnected = true;
+    wifiConnected = false;
+    consoleBytes = 0;
+    randomEngine.seed(1);
+    Internal::resetTimers();
+    Internal::resetRmt();
+    Internal::resetWire();
+    Internal::resetPreferences();
+    Internal::resetMqtt();
+}
+
+// ===== GPIO =====
+
+int getPinMode(uint8_t pin) {
+    return validPin(pin) ? pins[pin].mode : -1;
+}
+
+int getOutputLevel(uint8_t pin) {
+    return validPin(pin) ? pins[pin].outputLevel : LOW;
+}
+
+void setInputLevel(uint8_t pin, int level) {
+    if (validPin(pin)) {
+        pins[pin].inputLevel = level;
+    }
+}
+
+uint32_t getPinWriteCount(uint8_t pin) {
+    return validPin(pin) ? pins[pin].writes : 0;
+}
+
+// ===== ADC =====
+
+void setAnalogValue(uint8_t pin, uint16_t value) {
+    if (validPin(pin)) {
+        pins[pin].analogValue = value > 4095 ? 4095 : value;
+    }
+}
+
+// ===== LEDC =====
+
+uint32_t getLedcDuty(uint8_t channel) {
+    return channel < LEDC_CHANNELS ? ledc[channel].duty : 0;
+}
+
+int getLedcPin(uint8_t channel) {
+    return channel < LEDC_CHANNELS ? ledc[channel].pin : -1;
+}
+
+// ===== pulseIn =====
+
+void setPulseWidth(uint8_t pin, unsigned long micros) {
+    if (validPin(pin)) {
+        pins[pin].pulseWidth = micros;
+    }
+}
+
+// ===== UART =====
+
+void attachUartPeer(uint8_t uart, UartPeer* peer) {
+    if (uart >= 1 && uart <= 2) {
+        uartPeers[uart] = peer;
+    }
+}
+
+UartPeer* getUartPeer(uint8_t uart) {
+    return uart <= 2 ? uartPeers[uart] : nullptr;
+}
+
+// ===== DHT22 =====
+
+void setDht22(float temperature, float humidity) {
+    dhtTemperature = temperature;
+    dhtHumidity = humidity;
+}
+
+void setDht22Connected(bool connected) {
+    dhtConnected = connected;
+}
+
+float getDht22Temperature() {
+    return dhtTemperature;
+}
+
+float getDht22Humidity() {
+    return dhtHumidity;
+}
+
+bool isDht22Connected() {
+    return dhtConnected;
+}
+
+// ===== WiFi =====
+
+void setWiFiConnected(bool connected, int8_t rssi) {
+    wifiConnected = connected;
+    wifiRssi = rssi;
+}
+
+// ===== Serial =====
+
+void setConsoleEnabled(bool enabled) {
+    consoleEnabled = enabled;
+}
+
+uint32_t getConsoleBytes() {
+    return consoleBytes;
+}
+
+void consoleWrite(const uint8_t* data, size_t length) {
+    consoleBytes += (uint32_t)length;
+    if (consoleEnabled) {
+        fwrite(data, 1, length, stdout);
+    }
+}
+
+// ===== Memoria =====
+
+void setFreeHeap(uint32_t bytes) {
+    freeHeap = bytes;
+}
+
+uint32_t getFreeHeap() {
+    return freeHeap;
+}
+
+} // namespace NativeHal
+
+// ===== Core Arduino =====
+
+unsigned long millis() {
+    return (unsigned long)(clockMicros / 1000);
+}
+
+unsigned long micros() {
+    return (unsigned long)clockMicros;
+}
+
+void delay(uint32_t ms) {
+    NativeHal::advanceMillis(ms);
+}
+
+void delayMicroseconds(uint32_t us) {
+    NativeHal::advanceMicros(us);
+}
+
+void yield() {
+}
+
+void pinMode(uint8_t pin, uint8_t mode) {
+    if (!validPin(pin)) {
+        return;
+    }
+    pins[pin].mode = mode;
+    // Un pin en entrada ya no se retiene a nivel bajo
+    if (mode == INPUT || mode == INPUT_PULLUP || mode == INPUT_PULLDOWN) {
+        pins[pin].outputLevel = HIGH;
+    }
+}
+
+void digitalWrite(uint8_t pin, uint8_t value) {
+    if (!validPin(pin)) {
+        return;
+    }
+    PinState& state = pins[pin];
+    int level = value ? HIGH : LOW;
+    if (state.outputLevel == HIGH && level == LOW) {
+        state.lowSince = clockMicros;
+    } else if (state.outputLevel == LOW && level == HIGH) {
+        NativeHal::Internal::rmtPinReleased(pin, clockMicros - state.lowSince);
+        NativeHal::Internal::wirePinReleased(pin);
+    }
+    state.outputLevel = level;
+    state.writes++;
+}
+
+int digitalRead(uint8_t pin) {
+    if (!validPin(pin)) {
+        return LOW;
+    }
+    // Open drain: the line reads low while this side holds it low
+    if ((pins[pin].mode == OUTPUT_OPEN_DRAIN || pins[pin].mode == OUTPUT) && pins[pin].outputLevel == LOW) {
+        return LOW;
+    }
+    return pins[pin].inputLevel;
+}
+
+unsigned long pulseIn(uint8_t pin, uint8_t state, unsigned long timeout) {
+    (void)state;
+    unsigned long width = validPin(pin) ? pins[pin].pulseWidth : 0;
+    if (width == 0 || width > timeout) {
+        NativeHal::advanceMicros(timeout);
+        return 0;
+    }
+    NativeHal::advanceMicros(width);
+    return width;
+}
+
+uint16_t analogRead(uint8_t pin) {
+    return validPin(pin) ? pins[pin].analogValue : 0;
+}
+
+void analogReadResolution(uint8_t bits) {
+    (void)bits;
+}
+
+double ledcSetup(uint8_t channel, double frequency, uint8_t resolutionBits) {
+    (void)resolutionBits;
+    return channel < LEDC_CHANNELS ? frequency : 0;
+}
+
+void ledcAttachPin(uint8_t pin, uint8_t channel) {
+    if (channel < LEDC_CHANNELS) {
+        ledc[channel].pin = pin;
+    }
+}
+
+void ledcDetachPin(uint8_t pin) {
+    for (LedcState& channel : ledc) {
+        if (channel.pin == pin) {
+            channel.pin = -1;
+        }
+    }
+}
+
+void ledcWrite(uint8_t channel, uint32_t duty) {
+    if (channel < LEDC_CHANNELS) {
+        ledc[channel].duty = duty;
+    }
+}
+
+uint32_t ledcRead(uint8_t channel) {
+    return channel < LEDC_CHANNELS ? ledc[channel].duty : 0;
+}
+
+long map(long x, long inMin, long inMax, long outMin, long outMax) {
+    if (inMax == inMin) {
+        return outMin;
+    }
+    return (x - inMin) * (outMax - outMin) / (inMax - inMin) + outMin;
+}
+
+long random(long max) {
+    return max > 0 ? random(0, max) : 0;
+}
+
+long random(long min, long max) {
+    if (max <= min) {
+        return min;
+    }
+    std::uniform_int_distribution<long> distribution(min, max - 1);
+    return distribution(randomEngine);
+}
+
+void randomSeed(unsigned long seed) {
+    randomEngine.seed((uint32_t)seed);
+}
+
+EspClass ESP;
+WiFiClass WiFi;
+
+wl_status_t WiFiClass::status() {
+    return wifiConnected ? WL_CONNECTED : WL_DISCONNECTED;
+}
+
+int8_t WiFiClass::RSSI() {
+    return wifiConnected ? wifiRssi : 0;
+}
+
+uint32_t EspClass::getFreeHeap() {
+    return NativeHal::getFreeHeap();
+}
+
+uint32_t EspClass::getHeapSize() {
+    return 320 * 1024;
+}
+
+uint32_t EspClass::getMinFreeHeap() {
+    return NativeHal::getFreeHeap();
+}
+
+uint32_t EspClass::getMaxAllocHeap() {
+    return NativeHal::getFreeHeap();
+}
+
+void EspClass::restart() {
+    NativeHal::reset();
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+class HardwareSerial;
+
+/**
+ * @brief Capa de hardware simulada para el entorno native (Linux)
+ *
+ * Implementa en el PC la parte del core de Arduino-ESP32 que usan los
+ * drivers (GPIO, ADC, LEDC, UART, I2C, esp_timer, RMT, millis()/micros() y
+ * Serial) sobre un reloj simulado. Nada avanza solo: delay() y
+ * delayMicroseconds() consumen tiempo simulado, y el banco de pruebas lo
+ * avanza con advanceMicros(). Así una espera bloqueante en un driver se ve
+ * como tiempo simulado perdido en la iteración del loop.
+ *
+ * Los dispositivos externos (sensores I2C, esclavos RS485...) se modelan
+ * fuera, implementando I2CDevice o UartPeer y registrándolos aquí.
+ */
+namespace NativeHal {
+
+// ===== Reloj simulado =====
+
+uint64_t nowMicros();
+void advanceMicros(uint64_t micros);   // Dispara los esp_timer vencidos
+void advanceMillis(uint32_t millis);
+
+// Todo al estado de encendido (reloj a 0, pines, dispositivos, temporizadores)
+void reset();
+
+// ===== GPIO =====
+
+int getPinMode(uint8_t pin);            // -1 si nunca se configuró
+int getOutputLevel(uint8_t pin);
+void setInputLevel(uint8_t pin, int level);
+uint32_t getPinWriteCount(uint8_t pin);
+
+// ===== ADC =====
+
+void setAnalogValue(uint8_t pin, uint16_t value);  // 0-4095
+
+// ===== LEDC =====
+
+uint32_t getLedcDuty(uint8_t channel);
+int getLedcPin(uint8_t channel);        // -1 sin pin asociado
+
+// ===== pulseIn (eco del HC-SR04) =====
+
+void setPulseWidth(uint8_t pin, unsigned long micros);  // 0: sin eco (timeout)
+
+// ===== UART =====
+
+class UartPeer {
+public:
+    virtual ~UartPeer() {}
+    // Bytes transmitidos por el puerto; la respuesta se deja con port.injectRx()
+    virtual void onTransmit(HardwareSerial& port, const uint8_t* data, size_t length) = 0;
+};
+
+void attachUartPeer(uint8_t uart, UartPeer* peer);   // uart 1 o 2
+UartPeer* getUartPeer(uint8_t uart);
+
+// ===== I2C =====
+
+class I2CDevice {
+public:
+    virtual ~I2CDevice() {}
+    // Escritura del maestro (registro y datos); false = NACK
+    virtual bool write(const uint8_t* data, size_t length) = 0;
+    // Lectura del maestro; devuelve los bytes entregados
+    virtual size_t read(uint8_t* data, size_t length) = 0;
+};
+
+void attachI2CDevice(uint8_t address, I2CDevice* device);
+I2CDevice* getI2CDevice(uint8_t address);
+void setI2CStuck(bool stuck);           // SDA retenida a nivel bajo hasta que SCL dé 9 pulsos
+bool isI2CStuck();
+uint32_t getI2CTransactionCount();
+
+// ===== DHT22 (librería DHT y captura RMT) =====
+
+void setDht22(float temperature, float humidity);
+void setDht22Connected(bool connected);
+float getDht22Temperature();
+float getDht22Humidity();
+bool isDht22Connected();
+
+// ===== MQTT (AsyncMqttClient) =====
+
+class MqttBroker {
+public:
+    virtual ~MqttBroker() {}
+    // CONNECT del cliente; false = conexión rechazada
+    virtual bool onConnect(const char* clientId, bool cleanSession) = 0;
+    // PUBLISH del cliente (packetId 0 con QoS 0); false = búfer TCP lleno, no se envía
+    virtual bool onPublish(const char* topic, uint8_t qos, bool retain, const uint8_t* payload, size_t length,
+                           bool dup, uint16_t packetId) = 0;
+};
+
+void attachMqttBroker(MqttBroker* broker);  // nullptr: broker inalcanzable
+// Del broker al cliente conectado (en el ESP32 llegan por la tarea de AsyncTCP)
+void mqttPublishAck(uint16_t packetId);
+void mqttDropConnection();                  // Corte de TCP: onDisconnect
+
+// ===== WiFi (solo estado) =====
+
+void setWiFiConnected(bool connected, int8_t rssi = -60);
+
+// ===== Serial (consola) =====
+
+void setConsoleEnabled(bool enabled);   // Desactivar en las medidas del banco
+uint32_t getConsoleBytes();
+void consoleWrite(const uint8_t* data, size_t length);  // Salida de Serial
+
+// ===== Memoria (ESP.getFreeHeap y heap_caps) =====
+
+void setFreeHeap(uint32_t bytes);
+uint32_t getFreeHeap();
+
+} // namespace NativeHal
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstdint>
+
+// Enlaces entre los fakes (no forma parte de la API del banco de pruebas)
+namespace NativeHal {
+namespace Internal {
+
+void runDueTimers();
+bool nextTimerDue(uint64_t until, uint64_t& dueAt);  // Earliest armed deadline <= until
+void resetTimers();
+void resetRmt();
+void resetPreferences();
+void resetWire();
+void resetMqtt();
+
+// Flanco de subida en un pin de salida (fin de la señal de inicio del DHT22, pulsos de SCL)
+void rmtPinReleased(uint8_t pin, uint64_t heldLowMicros);
+void wirePinReleased(uint8_t pin);
+
+} // namespace Internal
+} // namespace NativeHal
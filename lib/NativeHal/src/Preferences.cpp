@@ -0,0 +1,108 @@
+#include "Preferences.h"
+#include "NativeHalInternal.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace {
+
+// namespace -> clave -> valor
+std::map<std::string, std::map<std::string, std::vector<uint8_t>>> storage;
+
+} // namespace
+
+bool Preferences::begin(const char* name, bool readOnlyMode) {
+    // Como NVS: los nombres de namespace tienen 15 caracteres como máximo
+    if (opened || !name || strlen(name) == 0 || strlen(name) > 15) {
+        return false;
+    }
+    space = name;
+    readOnly = readOnlyMode;
+    // En solo lectura un namespace inexistente no se puede abrir
+    if (readOnly && storage.find(space.c_str()) == storage.end()) {
+        return false;
+    }
+    opened = true;
+    return true;
+}
+
+void Preferences::end() {
+    opened = false;
+}
+
+bool Preferences::clear() {
+    if (!opened || readOnly) {
+        return false;
+    }
+    storage[space.c_str()].clear();
+    return true;
+}
+
+bool Preferences::remove(const char* key) {
+    if (!opened || readOnly) {
+        return false;
+    }
+    return storage[space.c_str()].erase(key) > 0;
+}
+
+bool Preferences::isKey(const char* key) {
+    if (!opened) {
+        return false;
+    }
+    auto& entries = storage[space.c_str()];
+    return entries.find(key) != entries.end();
+}
+
+size_t Preferences::putBytes(const char* key, const void* value, size_t length) {
+    if (!opened || readOnly || !key || (!value && length)) {
+        return 0;
+    }
+    const uint8_t* bytes = static_cast<const uint8_t*>(value);
+    storage[space.c_str()][key].assign(bytes, bytes + length);
+    return length;
+}
+
+size_t Preferences::getBytes(const char* key, void* buffer, size_t maxLength) {
+    if (!opened || !key) {
+        return 0;
+    }
+    auto& entries = storage[space.c_str()];
+    auto entry = entries.find(key);
+    if (entry == entries.end() || entry->second.size() > maxLength) {
+        return 0;
+    }
+    memcpy(buffer, entry->second.data(), entry->second.size());
+    return entry->second.size();
+}
+
+size_t Preferences::getBytesLength(const char* key) {
+    if (!opened || !key) {
+        return 0;
+    }
+    auto& entries = storage[space.c_str()];
+    auto entry = entries.find(key);
+    return entry == entries.end() ? 0 : entry->second.size();
+}
+
+size_t Preferences::putFloat(const char* key, float value) {
+    return putBytes(key, &value, sizeof(value));
+}
+
+float Preferences::getFloat(const char* key, float defaultValue) {
+    float value = defaultValue;
+    if (getBytesLength(key) != sizeof(value) || getBytes(key, &value, sizeof(value)) != sizeof(value)) {
+        return defaultValue;
+    }
+    return value;
+}
+
+namespace NativeHal {
+namespace Internal {
+
+void resetPreferences() {
+    storage.clear();
+}
+
+} // namespace Internal
+} // namespace NativeHal
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "Arduino.h"
+
+/**
+ * @brief NVS en memoria: se conserva entre instancias, se borra con NativeHal::reset()
+ */
+class Preferences {
+private:
+    String space;
+    bool opened;
+    bool readOnly;
+
+public:
+    Preferences() : opened(false), readOnly(false) {}
+    ~Preferences() { end(); }
+
+    bool begin(const char* name, bool readOnly = false);
+    void end();
+    bool clear();
+    bool remove(const char* key);
+    bool isKey(const char* key);
+
+    size_t putBytes(const char* key, const void* value, size_t length);
+    size_t getBytes(const char* key, void* buffer, size_t maxLength);
+    size_t getBytesLength(const char* key);
+    size_t putFloat(const char* key, float value);
+    float getFloat(const char* key, float defaultValue = NAN);
+};
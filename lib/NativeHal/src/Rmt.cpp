@@ -0,0 +1,242 @@
+#include "driver/rmt.h"
+#include "Arduino.h"
+#include "NativeHal.h"
+#include "NativeHalInternal.h"
+
+#include <cmath>
+#include <vector>
+
+struct NativeRingbuf {
+    std::vector<rmt_item32_t> items;
+    uint64_t readyAt;
+    bool full;
+    bool lent;
+};
+
+namespace {
+
+// Respuesta del DHT22 tras la señal de inicio (hoja de datos AM2302)
+const uint16_t DHT_RELEASE_HIGH_US = 30;
+const uint16_t DHT_RESPONSE_US = 80;
+const uint16_t DHT_BIT_LOW_US = 50;
+const uint16_t DHT_BIT_ZERO_US = 27;
+const uint16_t DHT_BIT_ONE_US = 70;
+const uint16_t DHT_START_MIN_US = 800;
+
+struct Channel {
+    bool configured;
+    bool installed;
+    bool receiving;
+    int pin;
+    uint16_t idleThreshold;
+    NativeRingbuf ringbuf;
+};
+
+Channel channels[RMT_CHANNEL_MAX];
+
+bool validChannel(rmt_channel_t channel) {
+    return channel >= RMT_CHANNEL_0 && channel < RMT_CHANNEL_MAX;
+}
+
+void appendLevel(std::vector<rmt_item32_t>& items, bool& halfUsed, bool high, uint16_t micros) {
+    if (!halfUsed) {
+        rmt_item32_t item = {};
+        item.level0 = high ? 1 : 0;
+        item.duration0 = micros;
+        items.push_back(item);
+        halfUsed = true;
+    } else {
+        items.back().level1 = high ? 1 : 0;
+        items.back().duration1 = micros;
+        halfUsed = false;
+    }
+}
+
+// 40 bits: humedad y temperatura en décimas (bit 15 = signo) y suma de comprobación
+void buildDhtFrame(NativeRingbuf& ringbuf, uint16_t idleThreshold) {
+    uint16_t humidity = (uint16_t)lroundf(NativeHal::getDht22Humidity() * 10.0f);
+    float temperature = NativeHal::getDht22Temperature();
+    uint16_t temperatureRaw = (uint16_t)lroundf(fabsf(temperature) * 10.0f) & 0x7FFF;
+    if (temperature < 0) {
+        temperatureRaw |= 0x8000;
+    }
+    uint8_t bytes[5] = {highByte(humidity), lowByte(humidity), highByte(temperatureRaw), lowByte(temperatureRaw), 0};
+    bytes[4] = (uint8_t)(bytes[0] + bytes[1] + bytes[2] + bytes[3]);
+
+    std::vector<rmt_item32_t>& items = ringbuf.items;
+    items.clear();
+    bool halfUsed = false;
+    uint32_t total = 0;
+    auto level = [&](bool high, uint16_t micros) {
+        appendLevel(items, halfUsed, high, micros);
+        total += micros;
+    };
+    level(true, DHT_RELEASE_HIGH_US);
+    level(false, DHT_RESPONSE_US);
+    level(true, DHT_RESPONSE_US);
+    for (uint8_t bit = 0; bit < 40; bit++) {
+        level(false, DHT_BIT_LOW_US);
+        level(true, bitRead(bytes[bit / 8], 7 - bit % 8) ? DHT_BIT_ONE_US : DHT_BIT_ZERO_US);
+    }
+    level(false, DHT_BIT_LOW_US);
+    // El receptor cierra la trama con un nivel de duración 0 al superar idle_threshold
+    appendLevel(items, halfUsed, true, 0);
+    if (halfUsed) {
+        items.back().level1 = 1;
+        items.back().duration1 = 0;
+    }
+
+    ringbuf.readyAt = NativeHal::nowMicros() + total + idleThreshold;
+    ringbuf.full = true;
+    ringbuf.lent = false;
+}
+
+} // namespace
+
+esp_err_t rmt_config(const rmt_config_t* config) {
+    if (!config || !validChannel(config->channel) || config->rmt_mode != RMT_MODE_RX) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    Channel& channel = channels[config->channel];
+    channel.configured = true;
+    channel.pin = config->gpio_num;
+    // clk_div 80: un tick por microsegundo, la única base de tiempo simulada
+    channel.idleThreshold = config->rx_config.idle_threshold;
+    return ESP_OK;
+}
+
+esp_err_t rmt_driver_install(rmt_channel_t channel, size_t rxBufferSize, int interruptFlags) {
+    (void)rxBufferSize;
+    (void)interruptFlags;
+    if (!validChannel(channel) || !channels[channel].configured) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (channels[channel].installed) {
+        return ESP_FAIL;
+    }
+    channels[channel].installed = true;
+    return ESP_OK;
+}
+
+esp_err_t rmt_driver_uninstall(rmt_channel_t channel) {
+    if (!validChannel(channel) || !channels[channel].installed) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    channels[channel] = Channel();
+    return ESP_OK;
+}
+
+esp_err_t rmt_get_ringbuf_handle(rmt_channel_t channel, RingbufHandle_t* handle) {
+    if (!validChannel(channel) || !channels[channel].installed || !handle) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *handle = &channels[channel].ringbuf;
+    return ESP_OK;
+}
+
+esp_err_t rmt_rx_start(rmt_channel_t channel, bool resetIndex) {
+    (void)resetIndex;
+    if (!validChannel(channel) || !channels[channel].installed) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    channels[channel].receiving = true;
+    return ESP_OK;
+}
+
+esp_err_t rmt_rx_stop(rmt_channel_t channel) {
+    if (!validChannel(channel) || !channels[channel].installed) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    channels[channel].receiving = false;
+    return ESP_OK;
+}
+
+void* xRingbufferReceive(RingbufHandle_t ringbuf, size_t* itemSize, TickType_t ticksToWait) {
+    if (!ringbuf || !ringbuf->full || ringbuf->lent) {
+        return nullptr;
+    }
+    if (ringbuf->readyAt > NativeHal::nowMicros()) {
+        // Esperar bloquea: se refleja en el reloj simulado
+        if (ticksToWait == 0) {
+            return nullptr;
+        }
+        uint64_t waitMicros = ringbuf->readyAt - NativeHal::nowMicros();
+        if (ticksToWait != portMAX_DELAY && waitMicros > (uint64_t)ticksToWait * 1000) {
+            NativeHal::advanceMillis(ticksToWait);
+            return nullptr;
+        }
+        NativeHal::advanceMicros(waitMicros);
+    }
+    ringbuf->lent = true;
+    if (itemSize) {
+        *itemSize = ringbuf->items.size() * sizeof(rmt_item32_t);
+    }
+    return ringbuf->items.data();
+}
+
+void vRingbufferReturnItem(RingbufHandle_t ringbuf, void* item) {
+    (void)item;
+    if (ringbuf) {
+        ringbuf->full = false;
+        ringbuf->lent = false;
+    }
+}
+
+esp_err_t gpio_set_direction(gpio_num_t pin, gpio_mode_t mode) {
+    switch (mode) {
+        case GPIO_MODE_INPUT:
+            pinMode(pin, INPUT);
+            break;
+        case GPIO_MODE_OUTPUT:
+        case GPIO_MODE_INPUT_OUTPUT:
+            pinMode(pin, OUTPUT);
+            break;
+        case GPIO_MODE_OUTPUT_OD:
+        case GPIO_MODE_INPUT_OUTPUT_OD:
+            pinMode(pin, OUTPUT_OPEN_DRAIN);
+            break;
+        default:
+            break;
+    }
+    return ESP_OK;
+}
+
+esp_err_t gpio_set_pull_mode(gpio_num_t pin, gpio_pull_mode_t pull) {
+    (void)pin;
+    (void)pull;
+    return ESP_OK;
+}
+
+esp_err_t gpio_set_level(gpio_num_t pin, uint32_t level) {
+    digitalWrite(pin, level ? HIGH : LOW);
+    return ESP_OK;
+}
+
+int gpio_get_level(gpio_num_t pin) {
+    return digitalRead(pin);
+}
+
+namespace NativeHal {
+namespace Internal {
+
+void resetRmt() {
+    for (Channel& channel : channels) {
+        channel = Channel();
+    }
+}
+
+// Fin de la señal de inicio: si un canal escucha ese pin, el DHT22 responde con una trama
+void rmtPinReleased(uint8_t pin, uint64_t heldLowMicros) {
+    if (heldLowMicros < DHT_START_MIN_US || !isDht22Connected()) {
+        return;
+    }
+    for (Channel& channel : channels) {
+        if (channel.installed && channel.receiving && channel.pin == pin && !channel.ringbuf.full) {
+            buildDhtFrame(channel.ringbuf, channel.idleThreshold);
+            return;
+        }
+    }
+}
+
+} // namespace Internal
+} // namespace NativeHal
@@ -0,0 +1,83 @@
+#include "WString.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+
+std::string String::fromUnsigned(unsigned long long number, unsigned char base) {
+    if (base < 2 || base > 36) {
+        base = 10;
+    }
+    std::string digits;
+    do {
+        unsigned digit = (unsigned)(number % base);
+        digits += (char)(digit < 10 ? '0' + digit : 'A' + digit - 10);
+        number /= base;
+    } while (number > 0);
+    std::reverse(digits.begin(), digits.end());
+    return digits;
+}
+
+std::string String::fromLong(long long number, unsigned char base) {
+    if (number < 0 && base == 10) {
+        return "-" + fromUnsigned(0ULL - (unsigned long long)number, base);
+    }
+    return fromUnsigned((unsigned long long)number, base);
+}
+
+std::string String::fromDouble(double number, unsigned int decimalPlaces) {
+    char buffer[64];
+    snprintf(buffer, sizeof(buffer), "%.*f", (int)decimalPlaces, number);
+    return buffer;
+}
+
+int String::indexOf(char c, unsigned int from) const {
+    size_t position = value.find(c, from);
+    return position == std::string::npos ? -1 : (int)position;
+}
+
+int String::indexOf(const String& text, unsigned int from) const {
+    size_t position = value.find(text.value, from);
+    return position == std::string::npos ? -1 : (int)position;
+}
+
+String String::substring(unsigned int from) const {
+    return from < value.size() ? String(value.substr(from)) : String();
+}
+
+String String::substring(unsigned int from, unsigned int to) const {
+    if (from > to) {
+        std::swap(from, to);
+    }
+    if (from >= value.size()) {
+        return String();
+    }
+    return String(value.substr(from, to - from));
+}
+
+bool String::endsWith(const String& suffix) const {
+    return value.size() >= suffix.value.size() &&
+           value.compare(value.size() - suffix.value.size(), suffix.value.size(), suffix.value) == 0;
+}
+
+void String::trim() {
+    size_t first = value.find_first_not_of(" \t\r\n");
+    if (first == std::string::npos) {
+        value.clear();
+        return;
+    }
+    size_t last = value.find_last_not_of(" \t\r\n");
+    value = value.substr(first, last - first + 1);
+}
+
+void String::toLowerCase() {
+    for (char& c : value) {
+        c = (char)tolower((unsigned char)c);
+    }
+}
+
+void String::toUpperCase() {
+    for (char& c : value) {
+        c = (char)toupper((unsigned char)c);
+    }
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+/**
+ * @brief String de Arduino sobre std::string (subconjunto que usa el proyecto)
+ */
+class String {
+private:
+    std::string value;
+
+    static std::string fromLong(long long number, unsigned char base);
+    static std::string fromUnsigned(unsigned long long number, unsigned char base);
+    static std::string fromDouble(double number, unsigned int decimalPlaces);
+
+public:
+    String() {}
+    String(const char* text) : value(text ? text : "") {}
+    String(const std::string& text) : value(text) {}
+    explicit String(char c) : value(1, c) {}
+    explicit String(unsigned char number, unsigned char base = 10) : value(fromUnsigned(number, base)) {}
+    explicit String(int number, unsigned char base = 10) : value(fromLong(number, base)) {}
+    explicit String(unsigned int number, unsigned char base = 10) : value(fromUnsigned(number, base)) {}
+    explicit String(long number, unsigned char base = 10) : value(fromLong(number, base)) {}
+    explicit String(unsigned long number, unsigned char base = 10) : value(fromUnsigned(number, base)) {}
+    explicit String(long long number, unsigned char base = 10) : value(fromLong(number, base)) {}
+    explicit String(unsigned long long number, unsigned char base = 10) : value(fromUnsigned(number, base)) {}
+    explicit String(float number, unsigned int decimalPlaces = 2) : value(fromDouble(number, decimalPlaces)) {}
+    explicit String(double number, unsigned int decimalPlaces = 2) : value(fromDouble(number, decimalPlaces)) {}
+
+    const char* c_str() const { return value.c_str(); }
+    unsigned int length() const { return (unsigned int)value.size(); }
+    bool isEmpty() const { return value.empty(); }
+    bool reserve(unsigned int size) { value.reserve(size); return true; }
+    char charAt(unsigned int index) const { return index < value.size() ? value[index] : 0; }
+    char operator[](unsigned int index) const { return charAt(index); }
+
+    String& operator+=(const String& other) { value += other.value; return *this; }
+    String& operator+=(const char* text) { value += text ? text : ""; return *this; }
+    String& operator+=(char c) { value += c; return *this; }
+    template <typename Number>
+    String& operator+=(Number number) { return *this += String(number); }
+    template <typename T>
+    bool concat(const T& other) { *this += other; return true; }
+
+    bool operator==(const String& other) const { return value == other.value; }
+    bool operator==(const char* text) const { return value == (text ? text : ""); }
+    bool operator!=(const String& other) const { return value != other.value; }
+    bool operator!=(const char* text) const { return !(*this == text); }
+    bool operator<(const String& other) const { return value < other.value; }
+    bool equals(const String& other) const { return value == other.value; }
+
+    int indexOf(char c, unsigned int from = 0) const;
+    int indexOf(const String& text, unsigned int from = 0) const;
+    String substring(unsigned int from) const;
+    String substring(unsigned int from, unsigned int to) const;
+    bool startsWith(const String& prefix) const { return value.compare(0, prefix.value.size(), prefix.value) == 0; }
+    bool endsWith(const String& suffix) const;
+    long toInt() const { return strtol(value.c_str(), nullptr, 10); }
+    float toFloat() const { return strtof(value.c_str(), nullptr); }
+    void trim();
+    void toLowerCase();
+    void toUpperCase();
+};
+
+inline String operator+(const String& lhs, const String& rhs) {
+    String result(lhs);
+    result += rhs;
+    return result;
+}
+
+inline String operator+(const String& lhs, const char* rhs) {
+    String result(lhs);
+    result += rhs;
+    return result;
+}
+
+inline String operator+(const char* lhs, const String& rhs) {
+    String result(lhs);
+    result += rhs;
+    return result;
+}
+
+inline String operator+(const String& lhs, char rhs) {
+    String result(lhs);
+    result += rhs;
+    return result;
+}
+
+// Números como en Arduino: enteros en base 10, float y double con 2 decimales
+template <typename Number, typename = decltype(String(Number()))>
+inline String operator+(const String& lhs, Number rhs) {
+    String result(lhs);
+    result += String(rhs);
+    return result;
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "Arduino.h"
+
+// Solo el estado de la conexión (NativeHal::setWiFiConnected); sin pila de red
+
+typedef enum {
+    WL_IDLE_STATUS = 0,
+    WL_NO_SSID_AVAIL = 1,
+    WL_CONNECTED = 3,
+    WL_CONNECT_FAILED = 4,
+    WL_CONNECTION_LOST = 5,
+    WL_DISCONNECTED = 6,
+} wl_status_t;
+
+typedef enum {
+    WIFI_OFF = 0,
+    WIFI_STA = 1,
+} wifi_mode_t;
+
+class WiFiClass {
+public:
+    wl_status_t status();
+    int8_t RSSI();
+    bool mode(wifi_mode_t mode) { (void)mode; return true; }
+    bool isConnected() { return status() == WL_CONNECTED; }
+};
+
+extern WiFiClass WiFi;
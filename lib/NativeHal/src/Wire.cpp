@@ -0,0 +1,172 @@
+#include "Wire.h"
+#include "Arduino.h"
+#include "NativeHal.h"
+#include "NativeHalInternal.h"
+
+TwoWire Wire;
+
+namespace {
+
+NativeHal::I2CDevice* devices[128] = {};
+bool stuck = false;
+uint8_t stuckPulses = 0;
+uint32_t transactions = 0;
+
+} // namespace
+
+namespace NativeHal {
+
+void attachI2CDevice(uint8_t address, I2CDevice* device) {
+    if (address < 128) {
+        devices[address] = device;
+    }
+}
+
+I2CDevice* getI2CDevice(uint8_t address) {
+    return address < 128 ? devices[address] : nullptr;
+}
+
+void setI2CStuck(bool isStuck) {
+    stuck = isStuck;
+    stuckPulses = 0;
+    if (Wire.getSdaPin() >= 0) {
+        setInputLevel((uint8_t)Wire.getSdaPin(), stuck ? LOW : HIGH);
+    }
+}
+
+bool isI2CStuck() {
+    return stuck;
+}
+
+uint32_t getI2CTransactionCount() {
+    return transactions;
+}
+
+namespace Internal {
+
+void resetWire() {
+    for (I2CDevice*& device : devices) {
+        device = nullptr;
+    }
+    stuck = false;
+    stuckPulses = 0;
+    transactions = 0;
+}
+
+// The slave holding SDA lets go once SCL clocks out the rest of its byte
+void wirePinReleased(uint8_t pin) {
+    if (!stuck || (int)pin != Wire.getSclPin()) {
+        return;
+    }
+    if (++stuckPulses >= 9) {
+        setI2CStuck(false);
+    }
+}
+
+} // namespace Internal
+} // namespace NativeHal
+
+TwoWire::TwoWire()
+    : sdaPin(-1), sclPin(-1), frequency(100000), timeoutMs(50), started(false), txAddress(0), rxIndex(0) {
+}
+
+bool TwoWire::begin(int sda, int scl, uint32_t clock) {
+    sdaPin = sda;
+    sclPin = scl;
+    frequency = clock ? clock : 100000;
+    started = true;
+    if (sdaPin >= 0) {
+        NativeHal::setInputLevel((uint8_t)sdaPin, stuck ? LOW : HIGH);
+    }
+    return true;
+}
+
+bool TwoWire::end() {
+    started = false;
+    return true;
+}
+
+void TwoWire::setClock(uint32_t clock) {
+    frequency = clock;
+}
+
+void TwoWire::setTimeOut(uint16_t timeout) {
+    timeoutMs = timeout;
+}
+
+// Address + data bytes, 9 clocks each, plus start/stop
+void TwoWire::chargeBusTime(size_t bytes) {
+    NativeHal::advanceMicros(((uint64_t)(bytes + 1) * 9 + 2) * 1000000ULL / frequency);
+}
+
+void TwoWire::beginTransmission(uint8_t address) {
+    txAddress = address;
+    txBuffer.clear();
+}
+
+size_t TwoWire::write(uint8_t data) {
+    txBuffer.push_back(data);
+    return 1;
+}
+
+size_t TwoWire::write(const uint8_t* data, size_t length) {
+    txBuffer.insert(txBuffer.end(), data, data + length);
+    return length;
+}
+
+uint8_t TwoWire::endTransmission(bool sendStop) {
+    (void)sendStop;
+    transactions++;
+    if (!started) {
+        return 4;
+    }
+    if (stuck) {
+        NativeHal::advanceMillis(timeoutMs);
+        return 5;
+    }
+    chargeBusTime(txBuffer.size());
+    NativeHal::I2CDevice* device = NativeHal::getI2CDevice(txAddress);
+    if (!device) {
+        return 2;
+    }
+    // Solo la dirección (sondeo): el dispositivo responde con ACK sin recibir datos
+    if (txBuffer.empty()) {
+        return 0;
+    }
+    return device->write(txBuffer.data(), txBuffer.size()) ? 0 : 3;
+}
+
+uint8_t TwoWire::requestFrom(uint8_t address, uint8_t quantity, bool sendStop) {
+    (void)sendStop;
+    transactions++;
+    rxBuffer.clear();
+    rxIndex = 0;
+    if (!started) {
+        return 0;
+    }
+    if (stuck) {
+        NativeHal::advanceMillis(timeoutMs);
+        return 0;
+    }
+    chargeBusTime(quantity);
+    NativeHal::I2CDevice* device = NativeHal::getI2CDevice(address);
+    if (!device) {
+        return 0;
+    }
+    rxBuffer.resize(quantity);
+    size_t received = device->read(rxBuffer.data(), quantity);
+    rxBuffer.resize(received);
+    return (uint8_t)received;
+}
+
+int TwoWire::available() {
+    return (int)(rxBuffer.size() - rxIndex);
+}
+
+int TwoWire::read() {
+    return rxIndex < rxBuffer.size() ? rxBuffer[rxIndex++] : -1;
+}
+
+int TwoWire::peek() {
+    return rxIndex < rxBuffer.size() ? rxBuffer[rxIndex] : -1;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief TwoWire simulado: cada transacción va al NativeHal::I2CDevice de su dirección
+ *
+ * Códigos de endTransmission() como en Arduino-ESP32: 0 OK, 2 NACK de
+ * dirección, 5 timeout (bus bloqueado).
+ */
+class TwoWire {
+private:
+    int sdaPin;
+    int sclPin;
+    uint32_t frequency;
+    uint16_t timeoutMs;
+    bool started;
+    uint8_t txAddress;
+    std::vector<uint8_t> txBuffer;
+    std::vector<uint8_t> rxBuffer;
+    size_t rxIndex;
+
+    void chargeBusTime(size_t bytes);
+
+public:
+    TwoWire();
+
+    bool begin(int sda = -1, int scl = -1, uint32_t frequency = 100000);
+    bool end();
+    void setClock(uint32_t frequency);
+    void setTimeOut(uint16_t timeoutMs);
+
+    void beginTransmission(uint8_t address);
+    size_t write(uint8_t data);
+    size_t write(const uint8_t* data, size_t length);
+    uint8_t endTransmission(bool sendStop = true);
+    uint8_t requestFrom(uint8_t address, uint8_t quantity, bool sendStop = true);
+    int available();
+    int read();
+    int peek();
+
+    int getSdaPin() const { return sdaPin; }
+    int getSclPin() const { return sclPin; }
+    uint32_t getClock() const { return frequency; }
+};
+
+extern TwoWire Wire;
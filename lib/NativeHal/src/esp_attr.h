@@ -0,0 +1,7 @@
+#pragma once
+
+// Sin memoria RTC ni IRAM en el PC: variables normales, que NativeHal::reset() no borra
+// (un reinicio simulado conserva lo RTC_NOINIT_ATTR, como un reinicio en caliente)
+#define RTC_NOINIT_ATTR
+#define RTC_DATA_ATTR
+#define IRAM_ATTR
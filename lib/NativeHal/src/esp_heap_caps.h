@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "NativeHal.h"
+
+#define MALLOC_CAP_8BIT    (1 << 2)
+#define MALLOC_CAP_DEFAULT (1 << 12)
+
+// Sin fragmentación simulada: el bloque mayor es todo el heap libre
+inline size_t heap_caps_get_largest_free_block(uint32_t caps) {
+    (void)caps;
+    return NativeHal::getFreeHeap();
+}
+
+inline size_t heap_caps_get_free_size(uint32_t caps) {
+    (void)caps;
+    return NativeHal::getFreeHeap();
+}
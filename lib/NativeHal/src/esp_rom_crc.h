@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstdint>
+
+// CRC-32 (IEEE 802.3) como el de la ROM: crc = 0 para empezar, encadenable
+inline uint32_t esp_rom_crc32_le(uint32_t crc, const uint8_t* buf, uint32_t len) {
+    crc = ~crc;
+    for (uint32_t i = 0; i < len; i++) {
+        crc ^= buf[i];
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320 & (0u - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstdlib>
+#include <ctime>
+#include <sys/time.h>
+
+// Sin red en el host: SNTP nunca sincroniza (usar ManualTimeSource en TimeManager)
+
+typedef void (*sntp_sync_time_cb_t)(struct timeval* tv);
+
+inline void sntp_set_time_sync_notification_cb(sntp_sync_time_cb_t callback) {
+    (void)callback;
+}
+
+inline void configTzTime(const char* timezone, const char* server1, const char* server2 = nullptr,
+                         const char* server3 = nullptr) {
+    (void)server1;
+    (void)server2;
+    (void)server3;
+    // La hora local del host sigue la zona del firmware
+    setenv("TZ", timezone, 1);
+    tzset();
+}
@@ -0,0 +1,10 @@
+#pragma once
+
+#include <cstddef>
+#include "freertos/FreeRTOS.h"
+
+// Solo lo que usa el driver RMT: un elemento por trama, disponible cuando el reloj simulado llega a ella
+typedef struct NativeRingbuf* RingbufHandle_t;
+
+void* xRingbufferReceive(RingbufHandle_t ringbuf, size_t* itemSize, TickType_t ticksToWait);
+void vRingbufferReturnItem(RingbufHandle_t ringbuf, void* item);
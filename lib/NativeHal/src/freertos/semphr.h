@@ -0,0 +1,33 @@
+#pragma once
+
+#include <mutex>
+#include "freertos/FreeRTOS.h"
+
+// Mutex de FreeRTOS sobre std::mutex. En el host no hay otra tarea que lo libere:
+// una espera acotada sobre un mutex tomado falla al momento en vez de consumir tiempo
+
+struct NativeSemaphore {
+    std::mutex mutex;
+};
+typedef NativeSemaphore* SemaphoreHandle_t;
+
+inline SemaphoreHandle_t xSemaphoreCreateMutex() {
+    return new NativeSemaphore();
+}
+
+inline BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticksToWait) {
+    if (ticksToWait == portMAX_DELAY) {
+        semaphore->mutex.lock();
+        return pdTRUE;
+    }
+    return semaphore->mutex.try_lock() ? pdTRUE : pdFALSE;
+}
+
+inline BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore) {
+    semaphore->mutex.unlock();
+    return pdTRUE;
+}
+
+inline void vSemaphoreDelete(SemaphoreHandle_t semaphore) {
+    delete semaphore;
+}
@@ -1,12 +1,37 @@
 #include "actuators/ActuatorManager.h"
 #include "config/config.h"
 
+namespace {
+
+// Every GPIO the firmware drives or reads: an actuator on a sensor or bus pin,
+// or two actuators on the same pin, fight over the output at boot
+constexpr int USED_PINS[] = {
+    FAN_MAIN_PIN, WATER_PUMP_PIN, HEATER_MAIN_PIN, LED_STRIP_PIN, FAN_SERVO_PIN, RELAY_PIN_6, RELAY_PIN_7,
+    I2C_SDA_PIN, I2C_SCL_PIN, DHT22_PIN, SOIL_MOISTURE_PIN, HCSR04_TRIGGER_PIN, HCSR04_ECHO_PIN,
+    RS485_TX_PIN, RS485_RX_PIN, RS485_TX_ENABLE_PIN, MODBUS_RTU_RX_PIN, MODBUS_RTU_TX_PIN, MODBUS_RTU_DE_PIN,
+};
+
+constexpr bool gpioPinsUnique() {
+    const size_t count = sizeof(USED_PINS) / sizeof(USED_PINS[0]);
+    for (size_t i = 0; i < count; i++) {
+        for (size_t j = i + 1; j < count; j++) {
+            if (USED_PINS[i] == USED_PINS[j]) return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+static_assert(gpioPinsUnique(), "Pin GPIO duplicado entre actuadores, relés y sensores (revisar *_PIN en config.h)");
+
 ActuatorManager::ActuatorManager(BlynkManager& blynk) {
     fanActuator = nullptr;
     waterPumpActuator = nullptr;
     heaterActuator = nullptr;
     ledStripActuator = nullptr;
     servoActuator = nullptr;
+    valveRelays = nullptr;
     blynkManager = &blynk;
     
     lastBlynkUpdate = 0;
@@ -24,44 +49,46 @@ ActuatorManager::~ActuatorManager() {
     delete heaterActuator;
     delete ledStripActuator;
     delete servoActuator;
+    delete valveRelays;
 }
 
 bool ActuatorManager::begin() {
     Serial.println("[ActuatorManager] Inicializando gestor de actuadores...");
     
-    // Configuración de pines por defecto para ESP32
-    // Estos pines pueden ser ajustados según el hardware específico
+    // Pines en config.h; USED_PINS comprueba en compilación que no se solapan
     
     // Inicializar ventilador
-    fanActuator = new FanActuator(25); // Pin GPIO 25
+    fanActuator = new FanActuator(FAN_MAIN_PIN);
     if (!fanActuator->begin()) {
         Serial.println("[ActuatorManager] ERROR: No se pudo inicializar el ventilador");
         return false;
     }
     
     // Inicializar bomba de agua
-    waterPumpActuator = new WaterPumpActuator(26); // Pin GPIO 26
+    waterPumpActuator = new WaterPumpActuator(WATER_PUMP_PIN);
     if (!waterPumpActuator->begin()) {
         Serial.println("[ActuatorManager] ERROR: No se pudo inicializar la bomba de agua");
         return false;
     }
     
     // Inicializar calefactor
-    heaterActuator = new HeaterActuator(27); // Pin GPIO 27
+    heaterActuator = new HeaterActuator(HEATER_MAIN_PIN);
     if (!heaterActuator->begin()) {
         Serial.println("[ActuatorManager] ERROR: No se pudo inicializar el calefactor");
         return false;
     }
+    // El control proporcional en el tiempo conmuta con pulsos de al menos HEATER_MIN_HEATING_TIME
+    heaterActuator->setMinStateChangeInterval(HEATER_MIN_HEATING_TIME);
     
     // Inicializar tira LED con soporte PWM
-    ledStripActuator = new LEDStripActuator(32, true, 0); // Pin GPIO 32, PWM canal 0
+    ledStripActuator = new LEDStripActuator(LED_STRIP_PIN, true, LED_STRIP_PWM_CHANNEL);
     if (!ledStripActuator->begin()) {
         Serial.println("[ActuatorManager] ERROR: No se pudo inicializar la tira LED");
         return false;
     }
     
     // Inicializar servomotor
-    servoActuator = new ServoActuator(33); // Pin GPIO 33
+    servoActuator = new ServoActuator(FAN_SERVO_PIN);
     if (!servoActuator->begin()) {
         Serial.println("[ActuatorManager] ERROR: No se pudo inicializar el servomotor");
         return false;
@@ -71,6 +98,16 @@ bool ActuatorManager::begin() {
     servoActuator->setOpenPosition(0);   // 0° = ventilador libre
     servoActuator->setClosedPosition(90); // 90° = ventilador tapado
     
+    // Inicializar válvulas de riego (canales numerados desde 0 en RelayController)
+    valveRelays = new RelayController();
+    valveRelays->begin();
+    bool relayInverted = (RELAY_TRIGGER_TYPE == 0);
+    if (!valveRelays->configureRelay(IRRIGATION_ZONE_1_RELAY - 1, RELAY_PIN_6, "Válvula zona 1", relayInverted) ||
+        !valveRelays->configureRelay(IRRIGATION_ZONE_2_RELAY - 1, RELAY_PIN_7, "Válvula zona 2", relayInverted)) {
+        Serial.println("[ActuatorManager] ERROR: No se pudieron configurar las válvulas de riego");
+        return false;
+    }
+    
     actuatorsInitialized = true;
     
     Serial.println("[ActuatorManager] Todos los actuadores inicializados correctamente");
@@ -111,40 +148,137 @@ void ActuatorManager::update() {
     }
 }
 
+// cppcheck-suppress unusedFunction
+unsigned long ActuatorManager::getIdleTime() {
+    if (!actuatorsInitialized) {
+        return ULONG_MAX;
+    }
+    
+    unsigned long idle = ULONG_MAX;
+    if (servoActuator) {
+        idle = min(idle, servoActuator->getIdleTime());
+    }
+    if (heaterActuator) {
+        idle = min(idle, heaterActuator->getTimeUntilMaxRunTime());
+    }
+    if (waterPumpActuator) {
+        idle = min(idle, waterPumpActuator->getTimeUntilMaxRunTime());
+    }
+    
+    unsigned long sinceBlynk = millis() - lastBlynkUpdate;
+    return min(idle, sinceBlynk >= blynkUpdateInterval ? 0 : blynkUpdateInterval - sinceBlynk);
+}
+
+// cppcheck-suppress unusedFunction
+bool ActuatorManager::needsPwmClock() {
+    if (!actuatorsInitialized) {
+        return false;
+    }
+    // El servo solo recibe pulsos mientras el LEDC funciona: en movimiento, o sujetando la ventana abierta
+    if (servoActuator && (servoActuator->isInMotion() || !servoActuator->isClosed())) {
+        return true;
+    }
+    return ledStripActuator && ledStripActuator->isRunning() && ledStripActuator->supportsBrightness();
+}
+
+// cppcheck-suppress unusedFunction
+uint32_t ActuatorManager::getSafeState() {
+    if (!actuatorsInitialized) {
+        return 0;
+    }
+    uint32_t state = SAFE_VALID;
+    if (fanActuator->isRunning()) state |= SAFE_FAN;
+    if (heaterActuator->isRunning()) state |= SAFE_HEATER;
+    if (ledStripActuator->isRunning()) state |= SAFE_LED;
+    state |= (uint32_t)ledStripActuator->getBrightness() << SAFE_BRIGHTNESS_SHIFT;
+    // Destino del servo: si se movía, el reinicio no debe dejarlo a medio camino
+    state |= (uint32_t)(servoActuator->getTargetPosition() & 0xFF) << SAFE_VENT_SHIFT;
+    return state;
+}
+
+// cppcheck-suppress unusedFunction
+void ActuatorManager::restoreSafeState(uint32_t state) {
+    if (!actuatorsInitialized || !(state & SAFE_VALID)) {
+        return;
+    }
+    Serial.printf("[ActuatorManager] Restaurando estado previo al reinicio (0x%06lX)\n", (unsigned long)state);
+    if (state & SAFE_FAN) {
+        fanActuator->resumeOn();
+    }
+    if (state & SAFE_HEATER) {
+        heaterActuator->resumeOn();
+    }
+    if (ledStripActuator->supportsBrightness()) {
+        ledStripActuator->setBrightness((uint8_t)(state >> SAFE_BRIGHTNESS_SHIFT));
+    }
+    if (state & SAFE_LED) {
+        ledStripActuator->resumeOn();
+    }
+    servoActuator->moveToPosition((int)((state >> SAFE_VENT_SHIFT) & 0xFF));
+}
+
+// cppcheck-suppress unusedFunction
+void ActuatorManager::saveState(StateSnapshot::State& state) {
+    if (!actuatorsInitialized) {
+        return;
+    }
+    fanActuator->saveState(state.fan);
+    heaterActuator->saveState(state.heater);
+    waterPumpActuator->saveState(state.pump);
+    ledStripActuator->saveState(state.ledStrip);
+    state.ledBrightness = ledStripActuator->getBrightness();
+    state.ventPosition = (uint8_t)servoActuator->getTargetPosition();
+}
+
+// cppcheck-suppress unusedFunction
+void ActuatorManager::restoreState(const StateSnapshot::State& state) {
+    if (!actuatorsInitialized) {
+        return;
+    }
+    Serial.println("[ActuatorManager] Restaurando estado previo al reinicio");
+    if (ledStripActuator->supportsBrightness()) {
+        ledStripActuator->setBrightness(state.ledBrightness);
+    }
+    fanActuator->restoreState(state.fan);
+    heaterActuator->restoreState(state.heater);
+    waterPumpActuator->restoreState(state.pump);
+    ledStripActuator->restoreState(state.ledStrip);
+    servoActuator->moveToPosition(state.ventPosition);
+}
+
 void ActuatorManager::sendDataToBlynk() {
     if (!blynkManager || !actuatorsInitialized) {
         return;
     }
     
-    // Enviar estados de actuadores a Blynk usando pines virtuales
-    // Estos valores pueden ser ajustados según la configuración de Blynk
+    // Enviar estados de actuadores a Blynk (pines registrados en BlynkTargets.h)
     
     if (fanActuator) {
-        blynkManager->sendVirtualPin(10, fanActuator->getBlynkState());
+        blynkManager->sendVirtualPin(BLYNK_VPIN_FAN_MAIN_STATE, fanActuator->getBlynkState());
     }
     
     if (waterPumpActuator) {
-        blynkManager->sendVirtualPin(11, waterPumpActuator->getBlynkState());
+        blynkManager->sendVirtualPin(BLYNK_VPIN_WATER_PUMP_STATE, waterPumpActuator->getBlynkState());
     }
     
     if (heaterActuator) {
-        blynkManager->sendVirtualPin(12, heaterActuator->getBlynkState());
+        blynkManager->sendVirtualPin(BLYNK_VPIN_HEATER_MAIN_STATE, heaterActuator->getBlynkState());
     }
     
     if (ledStripActuator) {
-        blynkManager->sendVirtualPin(13, ledStripActuator->getBlynkState());
+        blynkManager->sendVirtualPin(BLYNK_VPIN_LED_STRIP_STATE, ledStripActuator->getBlynkState());
         if (ledStripActuator->supportsBrightness()) {
             // Enviar brillo como porcentaje
             int brightness = map(ledStripActuator->getBrightness(), 0, 255, 0, 100);
-            blynkManager->sendVirtualPin(14, brightness);
+            blynkManager->sendVirtualPin(BLYNK_VPIN_LED_STRIP_BRIGHTNESS, brightness);
         }
     }
     
     if (servoActuator) {
-        blynkManager->sendVirtualPin(15, servoActuator->getBlynkState());
+        blynkManager->sendVirtualPin(BLYNK_VPIN_FAN_SERVO_STATE, servoActuator->getBlynkState());
         // Enviar posición actual como porcentaje
         int position = map(servoActuator->getCurrentPosition(), 0, 180, 0, 100);
-        blynkManager->sendVirtualPin(16, position);
+        blynkManager->sendVirtualPin(BLYNK_VPIN_FAN_SERVO_POSITION, position);
     }
 }
 
@@ -184,6 +318,11 @@ ServoActuator* ActuatorManager::getServo() {
     return servoActuator;
 }
 
+// cppcheck-suppress unusedFunction
+RelayController* ActuatorManager::getValveRelays() {
+    return valveRelays;
+}
+
 // Métodos de control directo (para compatibilidad)
 // cppcheck-suppress unusedFunction
 bool ActuatorManager::activarVentilador() {
@@ -267,6 +406,7 @@ void ActuatorManager::desactivarTodos() {
     if (waterPumpActuator) waterPumpActuator->turnOff();
     if (heaterActuator) heaterActuator->turnOff();
     if (ledStripActuator) ledStripActuator->turnOff();
+    if (valveRelays) valveRelays->deactivateAllRelays();
     // El servo mantiene su posición actual
 }
 
@@ -283,6 +423,10 @@ void ActuatorManager::modoSeguridad() {
         waterPumpActuator->turnOff();
     }
     
+    if (valveRelays) {
+        valveRelays->deactivateAllRelays();
+    }
+    
     if (fanActuator) {
         fanActuator->turnOff();
     }
@@ -333,29 +477,3 @@ void ActuatorManager::imprimirEstado() const {
     }
     Serial.println("==================================================");
 }
-
-// cppcheck-suppress unusedFunction
-bool ActuatorManager::controlarDesdeBlynk(uint8_t actuador, int estado) {
-    Serial.printf("[ActuatorManager] Control desde Blynk - Actuador: %d, Estado: %d\n", actuador, estado);
-    
-    switch (actuador) {
-        case 0: // Ventilador
-            return fanActuator ? fanActuator->setFromBlynk(estado) : false;
-            
-        case 1: // Bomba de agua
-            return waterPumpActuator ? waterPumpActuator->setFromBlynk(estado) : false;
-            
-        case 2: // Calefactor
-            return heaterActuator ? heaterActuator->setFromBlynk(estado) : false;
-            
-        case 3: // Tira LED
-            return ledStripActuator ? ledStripActuator->setFromBlynk(estado) : false;
-            
-        case 4: // Servo
-            return servoActuator ? servoActuator->setFromBlynk(estado) : false;
-            
-        default:
-            Serial.printf("[ActuatorManager] ERROR: Actuador %d no válido\n", actuador);
-            return false;
-    }
-}
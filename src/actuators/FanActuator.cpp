@@ -1,5 +1,6 @@
 #include "actuators/FanActuator.h"
 #include "config/config.h"
+#include "system/Metrics.h"
 
 FanActuator::FanActuator(uint8_t pin) : relayPin(pin) {
     isOn = false;
@@ -44,6 +45,7 @@ bool FanActuator::turnOn() {
     
     if (!isOn) {
         digitalWrite(relayPin, HIGH);
+        Metrics::relayToggled(Metrics::RELAY_FAN);
         isOn = true;
         lastStateChange = currentTime;
         
@@ -74,6 +76,7 @@ bool FanActuator::turnOff() {
     
     if (isOn) {
         digitalWrite(relayPin, LOW);
+        Metrics::relayToggled(Metrics::RELAY_FAN);
         isOn = false;
         lastStateChange = currentTime;
         isContinuousRunning = false;
@@ -84,6 +87,13 @@ bool FanActuator::turnOff() {
     return true;
 }
 
+// cppcheck-suppress unusedFunction
+bool FanActuator::resumeOn() {
+    // El intervalo mínimo ya lo respetó el arranque anterior
+    lastStateChange = millis() - minStateChangeInterval;
+    return turnOn();
+}
+
 // cppcheck-suppress unusedFunction
 bool FanActuator::toggle() {
     if (isOn) {
@@ -149,6 +159,30 @@ void FanActuator::printStatus() {
     Serial.println("==========================================");
 }
 
+// cppcheck-suppress unusedFunction
+void FanActuator::saveState(StateSnapshot::Relay& state) {
+    state.lastStateChange = (int32_t)lastStateChange;
+    state.onSince = isContinuousRunning ? (int32_t)continuousRunStartTime : 0;
+    state.on = isOn;
+}
+
+// cppcheck-suppress unusedFunction
+void FanActuator::restoreState(const StateSnapshot::Relay& state) {
+    if (!isInitialized) {
+        return;
+    }
+    lastStateChange = state.lastStateChange;
+    if (state.on && !isOn) {
+        digitalWrite(relayPin, HIGH);
+        Metrics::relayToggled(Metrics::RELAY_FAN);
+        isOn = true;
+        // La marcha continua sigue contando desde antes del reinicio
+        continuousRunStartTime = state.onSince;
+        isContinuousRunning = true;
+        Serial.println("[FanActuator] Ventilador encendido (estado previo al reinicio)");
+    }
+}
+
 // cppcheck-suppress unusedFunction
 int FanActuator::getBlynkState() {
     return isOn ? 1 : 0;
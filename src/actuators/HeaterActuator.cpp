@@ -1,5 +1,6 @@
 #include "actuators/HeaterActuator.h"
 #include "config/config.h"
+#include "system/Metrics.h"
 
 HeaterActuator::HeaterActuator(uint8_t pin) : relayPin(pin) {
     isOn = false;
@@ -49,6 +50,7 @@ bool HeaterActuator::turnOn() {
     
     if (!isOn) {
         digitalWrite(relayPin, HIGH);
+        Metrics::relayToggled(Metrics::RELAY_HEATER);
         isOn = true;
         lastStateChange = currentTime;
         activationCount++;
@@ -86,6 +88,7 @@ bool HeaterActuator::turnOff() {
         }
         
         digitalWrite(relayPin, LOW);
+        Metrics::relayToggled(Metrics::RELAY_HEATER);
         isOn = false;
         lastStateChange = currentTime;
         
@@ -96,6 +99,13 @@ bool HeaterActuator::turnOff() {
     return true;
 }
 
+// cppcheck-suppress unusedFunction
+bool HeaterActuator::resumeOn() {
+    // El intervalo mínimo ya lo respetó el arranque anterior
+    lastStateChange = millis() - minStateChangeInterval;
+    return turnOn();
+}
+
 // cppcheck-suppress unusedFunction
 bool HeaterActuator::toggle() {
     if (isOn) {
@@ -171,6 +181,7 @@ bool HeaterActuator::emergencyShutdown() {
         }
         
         digitalWrite(relayPin, LOW);
+        Metrics::relayToggled(Metrics::RELAY_HEATER);
         isOn = false;
         lastStateChange = millis();
         
@@ -198,6 +209,16 @@ bool HeaterActuator::hasExceededMaxRunTime() {
     return false;
 }
 
+// cppcheck-suppress unusedFunction
+unsigned long HeaterActuator::getTimeUntilMaxRunTime() {
+    if (!isContinuousRunning || maxContinuousRunTime == 0) {
+        return ULONG_MAX;
+    }
+    // hasExceededMaxRunTime() compara con >: un milisegundo después del límite
+    unsigned long runTime = getContinuousRunTime();
+    return runTime > maxContinuousRunTime ? 0 : maxContinuousRunTime - runTime + 1;
+}
+
 unsigned long HeaterActuator::getTotalRunTime() {
     unsigned long currentTotal = totalRunTime;
     if (isContinuousRunning) {
@@ -238,6 +259,34 @@ void HeaterActuator::printStatus() {
     Serial.println("==========================================");
 }
 
+// cppcheck-suppress unusedFunction
+void HeaterActuator::saveState(StateSnapshot::Relay& state) {
+    state.lastStateChange = (int32_t)lastStateChange;
+    state.onSince = isContinuousRunning ? (int32_t)continuousRunStartTime : 0;
+    state.totalRunTime = totalRunTime;
+    state.activationCount = activationCount;
+    state.on = isOn;
+}
+
+// cppcheck-suppress unusedFunction
+void HeaterActuator::restoreState(const StateSnapshot::Relay& state) {
+    if (!isInitialized) {
+        return;
+    }
+    lastStateChange = state.lastStateChange;
+    totalRunTime = state.totalRunTime;
+    activationCount = state.activationCount;
+    if (state.on && !isOn) {
+        digitalWrite(relayPin, HIGH);
+        Metrics::relayToggled(Metrics::RELAY_HEATER);
+        isOn = true;
+        // La marcha continua máxima sigue contando desde antes del reinicio
+        continuousRunStartTime = state.onSince;
+        isContinuousRunning = true;
+        Serial.printf("[HeaterActuator] Calefactor encendido (estado previo al reinicio, Activación #%d)\n", activationCount);
+    }
+}
+
 // cppcheck-suppress unusedFunction
 int HeaterActuator::getBlynkState() {
     return isOn ? 1 : 0;
@@ -1,5 +1,6 @@
 #include "actuators/LEDStripActuator.h"
 #include "config/config.h"
+#include "system/Metrics.h"
 
 LEDStripActuator::LEDStripActuator(uint8_t pin, bool enablePWM, uint8_t pwmCh) 
     : relayPin(pin),
@@ -66,6 +67,7 @@ bool LEDStripActuator::turnOn() {
         } else {
             digitalWrite(relayPin, HIGH);
         }
+        Metrics::relayToggled(Metrics::RELAY_LED_STRIP);
         
         isOn = true;
         lastStateChange = currentTime;
@@ -112,6 +114,7 @@ bool LEDStripActuator::turnOff() {
         } else {
             digitalWrite(relayPin, LOW);
         }
+        Metrics::relayToggled(Metrics::RELAY_LED_STRIP);
         
         isOn = false;
         lastStateChange = currentTime;
@@ -123,6 +126,13 @@ bool LEDStripActuator::turnOff() {
     return true;
 }
 
+// cppcheck-suppress unusedFunction
+bool LEDStripActuator::resumeOn() {
+    // El intervalo mínimo ya lo respetó el arranque anterior
+    lastStateChange = millis() - minStateChangeInterval;
+    return turnOn();
+}
+
 // cppcheck-suppress unusedFunction
 bool LEDStripActuator::toggle() {
     if (isOn) {
@@ -306,6 +316,37 @@ void LEDStripActuator::printStatus() {
     Serial.println("==========================================");
 }
 
+// cppcheck-suppress unusedFunction
+void LEDStripActuator::saveState(StateSnapshot::Relay& state) {
+    state.lastStateChange = (int32_t)lastStateChange;
+    state.onSince = isContinuousRunning ? (int32_t)continuousRunStartTime : 0;
+    state.totalRunTime = totalRunTime;
+    state.activationCount = activationCount;
+    state.on = isOn;
+}
+
+// cppcheck-suppress unusedFunction
+void LEDStripActuator::restoreState(const StateSnapshot::Relay& state) {
+    if (!isInitialized) {
+        return;
+    }
+    lastStateChange = state.lastStateChange;
+    totalRunTime = state.totalRunTime;
+    activationCount = state.activationCount;
+    if (state.on && !isOn) {
+        if (supportsPWM) {
+            ledcWrite(pwmChannel, brightness);
+        } else {
+            digitalWrite(relayPin, HIGH);
+        }
+        Metrics::relayToggled(Metrics::RELAY_LED_STRIP);
+        isOn = true;
+        continuousRunStartTime = state.onSince;
+        isContinuousRunning = true;
+        Serial.printf("[LEDStripActuator] Tira LED encendida (estado previo al reinicio, Brillo: %d)\n", brightness);
+    }
+}
+
 // cppcheck-suppress unusedFunction
 int LEDStripActuator::getBlynkState() {
     return isOn ? 1 : 0;
@@ -1,4 +1,5 @@
 #include "actuators/RelayController.h"
+#include "system/Metrics.h"
 
 RelayController::RelayController() 
     : activeChannels(0), isInitialized(false), debounceDelay(50) {
@@ -74,6 +75,9 @@ bool RelayController::activateRelay(uint8_t channel) {
         return false; // Debounce activo
     }
     
+    if (!relays[channel].isActive) {
+        Metrics::relayToggled(Metrics::RELAY_MULTICHANNEL);
+    }
     relays[channel].isActive = true;
     relays[channel].lastToggleTime = currentTime;
     writeRelayState(channel, true);
@@ -94,6 +98,9 @@ bool RelayController::deactivateRelay(uint8_t channel) {
         return false; // Debounce activo
     }
     
+    if (relays[channel].isActive) {
+        Metrics::relayToggled(Metrics::RELAY_MULTICHANNEL);
+    }
     relays[channel].isActive = false;
     relays[channel].lastToggleTime = currentTime;
     writeRelayState(channel, false);
@@ -144,6 +151,9 @@ void RelayController::deactivateAllRelays() {
     
     for (uint8_t i = 0; i < MAX_RELAYS; i++) {
         if (relays[i].pin != 255) {
+            if (relays[i].isActive) {
+                Metrics::relayToggled(Metrics::RELAY_MULTICHANNEL);
+            }
             relays[i].isActive = false;
             writeRelayState(i, false);
         }
@@ -35,9 +35,8 @@ bool ServoActuator::begin() {
     if (servo.attach(servoPin, 500, 2400)) { // Pulsos de 500 a 2400 microsegundos
         isInitialized = true;
         
-        // Mover a posición inicial (abierto)
+        // Mover a posición inicial (abierto); el servo llega solo, no hace falta esperarlo
         servo.write(currentPosition);
-        delay(500); // Tiempo para estabilizar
         
         Serial.printf("[ServoActuator] Servo inicializado en pin %d\n", servoPin);
         Serial.printf("[ServoActuator] Posición inicial: %d grados\n", currentPosition);
@@ -191,6 +190,15 @@ void ServoActuator::update() {
     }
 }
 
+// cppcheck-suppress unusedFunction
+unsigned long ServoActuator::getIdleTime() {
+    if (!isInitialized || !isMoving) {
+        return ULONG_MAX;
+    }
+    unsigned long elapsed = millis() - lastMoveTime;
+    return elapsed >= moveInterval ? 0 : moveInterval - elapsed;
+}
+
 // cppcheck-suppress unusedFunction
 bool ServoActuator::smoothMoveTo(int position) {
     if (!isInitialized) {
@@ -1,5 +1,6 @@
 #include "actuators/WaterPumpActuator.h"
 #include "config/config.h"
+#include "system/Metrics.h"
 
 WaterPumpActuator::WaterPumpActuator(uint8_t pin) : relayPin(pin) {
     isOn = false;
@@ -46,6 +47,7 @@ bool WaterPumpActuator::turnOn() {
     
     if (!isOn) {
         digitalWrite(relayPin, HIGH);
+        Metrics::relayToggled(Metrics::RELAY_WATER_PUMP);
         isOn = true;
         lastStateChange = currentTime;
         activationCount++;
@@ -83,6 +85,7 @@ bool WaterPumpActuator::turnOff() {
         }
         
         digitalWrite(relayPin, LOW);
+        Metrics::relayToggled(Metrics::RELAY_WATER_PUMP);
         isOn = false;
         lastStateChange = currentTime;
         
@@ -142,6 +145,16 @@ bool WaterPumpActuator::hasExceededMaxRunTime() {
     return false;
 }
 
+// cppcheck-suppress unusedFunction
+unsigned long WaterPumpActuator::getTimeUntilMaxRunTime() {
+    if (!isContinuousRunning || maxContinuousRunTime == 0) {
+        return ULONG_MAX;
+    }
+    // hasExceededMaxRunTime() compara con >: un milisegundo después del límite
+    unsigned long runTime = getContinuousRunTime();
+    return runTime > maxContinuousRunTime ? 0 : maxContinuousRunTime - runTime + 1;
+}
+
 unsigned long WaterPumpActuator::getTotalRunTime() {
     unsigned long currentTotal = totalRunTime;
     if (isContinuousRunning) {
@@ -180,6 +193,33 @@ void WaterPumpActuator::printStatus() {
     Serial.println("===============================================");
 }
 
+// cppcheck-suppress unusedFunction
+void WaterPumpActuator::saveState(StateSnapshot::Relay& state) {
+    state.lastStateChange = (int32_t)lastStateChange;
+    state.onSince = isContinuousRunning ? (int32_t)continuousRunStartTime : 0;
+    state.totalRunTime = totalRunTime;
+    state.activationCount = activationCount;
+    state.on = isOn;
+}
+
+// cppcheck-suppress unusedFunction
+void WaterPumpActuator::restoreState(const StateSnapshot::Relay& state) {
+    if (!isInitialized) {
+        return;
+    }
+    totalRunTime = state.totalRunTime;
+    activationCount = state.activationCount;
+    if (state.on) {
+        // No se vuelve a encender aquí: la marcha terminó con el reinicio (millis() = 0 en este
+        // arranque) y el riego interrumpido lo reanuda IrrigationScheduler, válvula antes que bomba
+        totalRunTime += (unsigned long)(-state.onSince);
+        lastStateChange = 0;
+        Serial.println("[WaterPumpActuator] Bomba detenida por el reinicio");
+    } else {
+        lastStateChange = state.lastStateChange;
+    }
+}
+
 // cppcheck-suppress unusedFunction
 int WaterPumpActuator::getBlynkState() {
     return isOn ? 1 : 0;
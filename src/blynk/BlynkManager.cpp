@@ -1,6 +1,14 @@
 #include "blynk/blynk_config.h"
 #include "blynk/BlynkManager.h"
+#include "blynk/BlynkTargets.h"
 #include "config/config.h"
+#include "system/Metrics.h"
+
+namespace {
+// Unregistered pins already reported (one bit per pin; a single flag for pins above MAX_VPIN)
+uint8_t reportedPins[(BlynkTargets::MAX_VPIN + 8) / 8];
+bool outOfRangeReported = false;
+} // namespace
 
 BlynkManager::BlynkManager() 
     : authToken(""),
@@ -132,7 +140,11 @@ bool BlynkManager::attemptReconnection() {
         lastConnectionAttempt = currentTime;
         
         if (!isConnected() && WiFi.status() == WL_CONNECTED) {
-            return connect();
+            if (connect()) {
+                Metrics::increment(Metrics::BLYNK_RECONNECTS);
+                return true;
+            }
+            return false;
         }
     }
     
@@ -172,19 +184,38 @@ void BlynkManager::onDisconnect(void (*callback)()) {
 
 // cppcheck-suppress unusedFunction
 void BlynkManager::sendVirtualPin(int pin, float value) {
-    if (isConnected() && blynkVirtualWriteFunc) {
+    if (blynkVirtualWriteFunc && canSend(pin)) {
         blynkVirtualWriteFunc(pin, value);
     }
 }
 
 void BlynkManager::sendVirtualPin(int pin, int value) {
-    if (isConnected() && blynkVirtualWriteIntFunc) {
+    if (blynkVirtualWriteIntFunc && canSend(pin)) {
         blynkVirtualWriteIntFunc(pin, value);
     }
 }
 
 void BlynkManager::sendVirtualPin(int pin, String value) {
-    if (isConnected() && blynkVirtualWriteStringFunc) {
+    if (blynkVirtualWriteStringFunc && canSend(pin)) {
         blynkVirtualWriteStringFunc(pin, value);
     }
 }
+
+bool BlynkManager::canSend(int pin) {
+    // Offline every send is dropped anyway: no registry lookup and no log
+    if (!isConnected()) return false;
+
+    bool inRange = pin >= 0 && pin <= BlynkTargets::MAX_VPIN;
+    if (inRange && BlynkTargets::findPin(pin)) return true;
+
+    if (inRange) {
+        uint8_t bit = 1 << (pin % 8);
+        if (reportedPins[pin / 8] & bit) return false;
+        reportedPins[pin / 8] |= bit;
+    } else {
+        if (outOfRangeReported) return false;
+        outOfRangeReported = true;
+    }
+    Serial.printf("[Blynk] Pin V%d no registrado en PIN_TABLE, no se envía (aviso único)\n", pin);
+    return false;
+}
@@ -0,0 +1,97 @@
+#include "blynk/BlynkTargets.h"
+#include "actuators/ActuatorManager.h"
+#include "blynk/BlynkManager.h"
+#include "config/SettingsStore.h"
+#include "logic/LogicManager.h"
+
+namespace BlynkTargets {
+
+namespace {
+LogicManager* logicManager = nullptr;
+ActuatorManager* actuatorManager = nullptr;
+SettingsStore* settingsStore = nullptr;
+BlynkManager* blynkManager = nullptr;
+
+void startOrCancelAutotune(const PinEntry& entry, float value, LogicManager::AutotuneLoop loop) {
+    if (!logicManager) return;
+    if (value != 0.0) {
+        logicManager->startAutotune(loop);
+    } else {
+        logicManager->cancelAutotune();
+    }
+    if (blynkManager) {
+        blynkManager->sendVirtualPin(entry.pin, logicManager->isAutotuning() ? 1 : 0);
+    }
+}
+
+template <typename T>
+void setActuator(const PinEntry& entry, T* actuator, float value) {
+    if (!actuator || isnan(value)) return;
+    // A refused command (interlock, minimum run time...) puts the real state back on the widget
+    if (!actuator->setFromBlynk(value != 0.0 ? 1 : 0) && blynkManager) {
+        blynkManager->sendVirtualPin(entry.pin, actuator->getBlynkState());
+    }
+}
+} // namespace
+
+void begin(LogicManager* logic, ActuatorManager* actuators, SettingsStore* settings, BlynkManager* blynk) {
+    logicManager = logic;
+    actuatorManager = actuators;
+    settingsStore = settings;
+    blynkManager = blynk;
+}
+
+bool dispatch(uint8_t pin, float value) {
+    const PinEntry* entry = findPin(pin);
+    if (!entry || !entry->onWrite) {
+        Serial.printf("[Blynk] Escritura ignorada en V%u\n", pin);
+        return false;
+    }
+    entry->onWrite(*entry, value);
+    return true;
+}
+
+void writeTarget(const PinEntry& entry, float value) {
+    if (isnan(value)) return;
+    float clamped = constrain(value, entry.minValue, entry.maxValue);
+    targets.*entry.field = clamped;
+    if (settingsStore) {
+        settingsStore->markDirty();
+    }
+    Serial.printf("[Blynk] %s: %.2f\n", entry.name, clamped);
+
+    // The widget already shows the value; send it back only if it was limited
+    if (clamped != value && blynkManager) {
+        blynkManager->sendVirtualPin(entry.pin, clamped);
+    }
+}
+
+void writeAutotuneTemperature(const PinEntry& entry, float value) {
+    startOrCancelAutotune(entry, value, LogicManager::AUTOTUNE_TEMPERATURE);
+}
+
+void writeAutotuneHumidity(const PinEntry& entry, float value) {
+    startOrCancelAutotune(entry, value, LogicManager::AUTOTUNE_HUMIDITY);
+}
+
+void writeFan(const PinEntry& entry, float value) {
+    setActuator(entry, actuatorManager ? actuatorManager->getFan() : nullptr, value);
+}
+
+void writeWaterPump(const PinEntry& entry, float value) {
+    setActuator(entry, actuatorManager ? actuatorManager->getWaterPump() : nullptr, value);
+}
+
+void writeHeater(const PinEntry& entry, float value) {
+    setActuator(entry, actuatorManager ? actuatorManager->getHeater() : nullptr, value);
+}
+
+void writeLEDStrip(const PinEntry& entry, float value) {
+    setActuator(entry, actuatorManager ? actuatorManager->getLEDStrip() : nullptr, value);
+}
+
+void writeServo(const PinEntry& entry, float value) {
+    setActuator(entry, actuatorManager ? actuatorManager->getServo() : nullptr, value);
+}
+
+} // namespace BlynkTargets
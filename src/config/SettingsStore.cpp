@@ -0,0 +1,193 @@
+#include "config/SettingsStore.h"
+#include "config/config.h"
+#include <Preferences.h>
+#include <stddef.h>
+
+ControlTuning tuning;
+
+void ControlTuning::loadDefaults() {
+    temperatureKp = NAN;
+    temperatureKi = NAN;
+    temperatureKd = NAN;
+    humidityKp = NAN;
+    humidityKi = NAN;
+    humidityKd = NAN;
+    ventTempHysteresis = 3.0;
+    ventHumidityHysteresis = 15.0;
+}
+
+bool ControlTuning::hasTemperatureGains() const {
+    return !isnan(temperatureKp) && !isnan(temperatureKi) && !isnan(temperatureKd);
+}
+
+bool ControlTuning::hasHumidityGains() const {
+    return !isnan(humidityKp) && !isnan(humidityKi) && !isnan(humidityKd);
+}
+
+SettingsStore::SettingsStore() :
+    loaded(false),
+    dirty(false),
+    lastChange(0),
+    savedCrc(0),
+    writeCount(0)
+{
+}
+
+bool SettingsStore::begin() {
+    unsigned long startTime = micros();
+
+    Preferences prefs;
+    if (!prefs.begin(SETTINGS_PREFS_NAMESPACE, true)) {
+        // First boot: the namespace does not exist yet
+        if (importLegacyGains()) {
+            markDirty();
+        }
+        Serial.println("[SettingsStore] No stored settings, using defaults");
+        return false;
+    }
+
+    Record record;
+    size_t length = prefs.getBytes("record", &record, sizeof(record));
+    prefs.end();
+
+    if (length != sizeof(record) || record.magic != RECORD_MAGIC ||
+        record.version != SETTINGS_VERSION || record.size != sizeof(record)) {
+        if (importLegacyGains()) {
+            markDirty();
+        }
+        Serial.println("[SettingsStore] No compatible settings record, using defaults");
+        return false;
+    }
+
+    if (record.crc != crc32((const uint8_t*)&record, offsetof(Record, crc))) {
+        Serial.println("[SettingsStore] Error: Settings record corrupted, using defaults");
+        return false;
+    }
+
+    targets = record.targets;
+    tuning = record.tuning;
+    savedCrc = record.crc;
+    loaded = true;
+
+    Serial.println(String("[SettingsStore] Settings loaded in ") + (micros() - startTime) + " us");
+    return true;
+}
+
+void SettingsStore::update() {
+    if (dirty && millis() - lastChange >= SETTINGS_FLUSH_DELAY) {
+        flush();
+    }
+}
+
+// cppcheck-suppress unusedFunction
+unsigned long SettingsStore::getIdleTime() const {
+    if (!dirty) {
+        return ULONG_MAX;
+    }
+    unsigned long elapsed = millis() - lastChange;
+    return elapsed >= SETTINGS_FLUSH_DELAY ? 0 : SETTINGS_FLUSH_DELAY - elapsed;
+}
+
+void SettingsStore::markDirty() {
+    // Every change restarts the delay, so a slider drag ends in one write
+    dirty = true;
+    lastChange = millis();
+}
+
+bool SettingsStore::flush() {
+    if (!dirty) {
+        return true;
+    }
+    dirty = false;
+
+    Record record;
+    fillRecord(record);
+    if (loaded && record.crc == savedCrc) {
+        return true; // Back to the stored values: nothing to write
+    }
+
+    Preferences prefs;
+    if (!prefs.begin(SETTINGS_PREFS_NAMESPACE, false)) {
+        Serial.println("[SettingsStore] Error: Could not open flash storage");
+        return false;
+    }
+    size_t written = prefs.putBytes("record", &record, sizeof(record));
+    prefs.end();
+
+    if (written != sizeof(record)) {
+        Serial.println("[SettingsStore] Error: Settings write failed");
+        return false;
+    }
+
+    savedCrc = record.crc;
+    loaded = true;
+    writeCount++;
+    Serial.println("[SettingsStore] Settings saved");
+    return true;
+}
+
+// cppcheck-suppress unusedFunction
+void SettingsStore::resetToDefaults() {
+    targets.loadDefaults();
+    tuning.loadDefaults();
+    markDirty();
+    flush();
+}
+
+// cppcheck-suppress unusedFunction
+bool SettingsStore::isLoaded() const {
+    return loaded;
+}
+
+// cppcheck-suppress unusedFunction
+bool SettingsStore::isDirty() const {
+    return dirty;
+}
+
+// cppcheck-suppress unusedFunction
+unsigned int SettingsStore::getWriteCount() const {
+    return writeCount;
+}
+
+void SettingsStore::fillRecord(Record& record) const {
+    record.magic = RECORD_MAGIC;
+    record.version = SETTINGS_VERSION;
+    record.size = sizeof(record);
+    record.targets = targets;
+    record.tuning = tuning;
+    record.crc = crc32((const uint8_t*)&record, offsetof(Record, crc));
+}
+
+bool SettingsStore::importLegacyGains() {
+    // Autotuned gains used to live in their own namespace
+    Preferences prefs;
+    if (!prefs.begin(AUTOTUNE_PREFS_NAMESPACE, true)) {
+        return false;
+    }
+
+    tuning.temperatureKp = prefs.getFloat("temp_kp", NAN);
+    tuning.temperatureKi = prefs.getFloat("temp_ki", NAN);
+    tuning.temperatureKd = prefs.getFloat("temp_kd", NAN);
+    tuning.humidityKp = prefs.getFloat("hum_kp", NAN);
+    tuning.humidityKi = prefs.getFloat("hum_ki", NAN);
+    tuning.humidityKd = prefs.getFloat("hum_kd", NAN);
+    prefs.end();
+
+    bool imported = tuning.hasTemperatureGains() || tuning.hasHumidityGains();
+    if (imported) {
+        Serial.println("[SettingsStore] Imported autotuned gains from previous storage");
+    }
+    return imported;
+}
+
+uint32_t SettingsStore::crc32(const uint8_t* data, size_t length) {
+    // CRC-32 (IEEE 802.3), bitwise: the record is under 100 bytes
+    uint32_t crc = 0xFFFFFFFF;
+    for (size_t i = 0; i < length; i++) {
+        crc ^= data[i];
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
@@ -1,20 +1,25 @@
 #include "logic/HumidityControl.h"
+#include "config/config.h"
 
 HumidityControl::HumidityControl() :
     targetHumidity(65.0),
     currentHumidity(50.0),
     tolerance(5.0),
-    previousError(0.0),
-    errorSum(0.0),
-    kp(1.5),
-    ki(0.05),
-    kd(0.3),
+    pid(),
+    humidifierInstalled(HUMIDIFIER_INSTALLED),
     minHumidity(30.0),
     maxHumidity(90.0),
     criticalLowHumidity(20.0),
     criticalHighHumidity(95.0),
     lastUpdate(0),
-    lastAction(0),
+    fanWindowSize(FAN_HUMIDITY_WINDOW),
+    fanMinSwitchTime(FAN_HUMIDITY_MIN_SWITCH),
+    fanWindowStart(0),
+    fanOnTime(0),
+    fanDuty(0.0),
+    humidifierDuty(0.0),
+    fanOutput(false),
+    fanPulseDone(false),
     enabled(false),
     humidifyingActive(false),
     dehumidifyingActive(false),
@@ -30,23 +35,36 @@ HumidityControl::HumidityControl() :
 bool HumidityControl::begin() {
     Serial.println("[HumidityControl] Initializing humidity control system");
     
+    // Set PID constants optimized for humidity control
+    // Output is fan duty (%) per %RH; humidity changes more slowly than temperature
+    pid.setGains(Q16_16(8.0),    // Proportional gain
+                 Q16_16(0.004),  // Low integral gain (humidity is slow to change)
+                 Q16_16(0.0));   // No derivative: the DHT22 reports whole-percent steps
+    // Without a humidifier the positive side has no actuator: keep the integral out of it
+    pid.setOutputLimits(Q16_16(-100), Q16_16(humidifierInstalled ? 100 : 0));
+    pid.setDerivativeFilter(Q16_16(0.5));
+    pid.setSetpoint(Q16_16(targetHumidity));
+    
     // Reset control variables
-    previousError = 0.0;
-    errorSum = 0.0;
+    pid.reset();
     lastUpdate = millis();
-    lastAction = 0;
     
-    // Set PID constants optimized for humidity control
-    // Humidity changes more slowly than temperature
-    kp = 1.5;  // Moderate proportional gain
-    ki = 0.05; // Low integral gain (humidity is slow to change)
-    kd = 0.3;  // Low derivative gain
+    // Start a fresh fan window with the fan off
+    fanWindowStart = lastUpdate;
+    fanOnTime = 0;
+    fanDuty = 0.0;
+    humidifierDuty = 0.0;
+    fanOutput = false;
+    fanPulseDone = false;
     
     enabled = true;
     
     Serial.println("[HumidityControl] Initialized successfully");
     Serial.println(String("[HumidityControl] Target: ") + targetHumidity + "%, Tolerance: ±" + tolerance + "%");
-    Serial.println(String("[HumidityControl] PID Constants - Kp:") + kp + " Ki:" + ki + " Kd:" + kd);
+    Serial.println(String("[HumidityControl] PID Constants - Kp:") + pid.getKp().toFloat() + " Ki:" + pid.getKi().toFloat() +
+                   " Kd:" + pid.getKd().toFloat());
+    Serial.println(String("[HumidityControl] Fan window: ") + (fanWindowSize / 1000) + "s, Min switch: " + 
+                  (fanMinSwitchTime / 1000) + "s");
     
     return true;
 }
@@ -56,9 +74,9 @@ void HumidityControl::update(float currentHum, float currentTemp) {
     if (!enabled) return;
     
     unsigned long currentTime = millis();
-    float deltaTime = (currentTime - lastUpdate) / 1000.0;
+    unsigned long deltaTime = currentTime - lastUpdate; // ms
     
-    if (deltaTime <= 0) return;
+    if (deltaTime == 0) return;
     
     currentHumidity = currentHum;
     
@@ -73,91 +91,63 @@ void HumidityControl::update(float currentHum, float currentTemp) {
         if (adjustedTarget < minHumidity) adjustedTarget = minHumidity;
     }
     
-    // Calculate error
-    float error = adjustedTarget - currentHumidity;
+    // Calculate PID output: > 0 humidify, < 0 dehumidify through the fan
+    // The temperature-adjusted target moves every update; derivative on
+    // measurement keeps those moves from kicking the output
+    pid.setSetpoint(Q16_16(adjustedTarget));
+    float output = pid.compute(Q16_16(currentHumidity), deltaTime).toFloat();
     
-    // Update error sum (with windup protection)
-    errorSum += error * deltaTime;
-    if (errorSum > 100.0) errorSum = 100.0;
-    if (errorSum < -100.0) errorSum = -100.0;
+    float fanDemand = output < 0.0f ? -output : 0.0f;
+    humidifierDuty = output > 0.0f ? output : 0.0f;
     
-    // Calculate derivative
-    float derivative = (error - previousError) / deltaTime;
+    // Critical limits override the loop
+    if (currentHumidity >= criticalHighHumidity) {
+        fanDemand = 100.0;
+        humidifierDuty = 0.0;
+    } else if (currentHumidity <= criticalLowHumidity && humidifierInstalled) {
+        fanDemand = 0.0;
+        humidifierDuty = 100.0;
+    }
+    updateFanOutput(currentTime, fanDemand);
     
-    // Calculate control output (for future advanced control)
-    // float controlOutput = (kp * error) + (ki * errorSum) + (kd * derivative);
+    bool wasHumidifying = humidifyingActive;
+    bool wasDehumidifying = dehumidifyingActive;
     
-    // Determine control actions
-    bool wasActive = humidifyingActive || dehumidifyingActive || ventilationActive;
+    humidifyingActive = humidifierDuty > 0.0;
+    dehumidifyingActive = fanDuty > 0.0;
+    ventilationActive = fanOutput;
     
-    humidifyingActive = false;
-    dehumidifyingActive = false;
-    ventilationActive = false;
+    if (humidifyingActive && !wasHumidifying) {
+        lastActiveTime = currentTime;
+        adjustmentCount++;
+        Serial.println(String("[HumidityControl] Humidification activated. Current: ") + 
+                     currentHumidity + "%, Target: " + adjustedTarget + "%, Duty: " + humidifierDuty + "%");
+    }
     
-    // Check if minimum time between actions has passed
-    bool actionAllowed = (currentTime - lastAction) >= MIN_ACTION_INTERVAL;
-    
-    if (actionAllowed) {
-        if (error > tolerance) {
-            // Humidity too low - need humidification
-            if (currentHumidity < criticalLowHumidity) {
-                // Critical low humidity - immediate action
-                humidifyingActive = true;
-                lastAction = currentTime;
-            } else if (isDaytime && error > tolerance * 1.5) {
-                // Normal humidification during day
-                humidifyingActive = true;
-                lastAction = currentTime;
-            }
-            
-            if (!wasActive && humidifyingActive) {
-                lastActiveTime = currentTime;
-                adjustmentCount++;
-                Serial.println(String("[HumidityControl] Humidification activated. Current: ") + 
-                             currentHumidity + "%, Target: " + adjustedTarget + "%");
-            }
-        } else if (error < -tolerance) {
-            // Humidity too high - need dehumidification
-            if (currentHumidity > criticalHighHumidity) {
-                // Critical high humidity - ventilation + dehumidification
-                dehumidifyingActive = true;
-                ventilationActive = true;
-                lastAction = currentTime;
-            } else if (error < -tolerance * 1.5) {
-                // Moderate high humidity - primarily ventilation
-                ventilationActive = true;
-                if (error < -tolerance * 2.0) {
-                    dehumidifyingActive = true;
-                }
-                lastAction = currentTime;
-            }
-            
-            if (!wasActive && (dehumidifyingActive || ventilationActive)) {
-                lastActiveTime = currentTime;
-                adjustmentCount++;
-                Serial.println(String("[HumidityControl] Dehumidification activated. Current: ") + 
-                             currentHumidity + "%, Target: " + adjustedTarget + "%");
-            }
-        } else {
-            // Humidity in acceptable range
-            if (wasActive) {
-                totalActiveTime += (currentTime - lastActiveTime);
-                Serial.println(String("[HumidityControl] Humidity stable. Current: ") + 
-                             currentHumidity + "%, Target: " + adjustedTarget + "%");
-            }
-        }
+    if (dehumidifyingActive && !wasDehumidifying) {
+        lastActiveTime = currentTime;
+        adjustmentCount++;
+        Serial.println(String("[HumidityControl] Dehumidification activated. Current: ") + 
+                     currentHumidity + "%, Target: " + adjustedTarget + "%, Fan duty: " + fanDuty + "%");
+    }
+    
+    if (!humidifyingActive && !dehumidifyingActive && (wasHumidifying || wasDehumidifying)) {
+        // Humidity in acceptable range
+        totalActiveTime += (currentTime - lastActiveTime);
+        Serial.println(String("[HumidityControl] Humidity stable. Current: ") + 
+                     currentHumidity + "%, Target: " + adjustedTarget + "%");
     }
     
-    previousError = error;
     lastUpdate = currentTime;
 }
 
 // Configuration methods
 // cppcheck-suppress unusedFunction
 void HumidityControl::setTarget(float target) {
+    if (target == targetHumidity) return;
+    
     if (target >= minHumidity && target <= maxHumidity) {
         targetHumidity = target;
-        errorSum = 0.0; // Reset integral
         Serial.println(String("[HumidityControl] Target humidity set to: ") + target + "%");
     } else {
         Serial.println(String("[HumidityControl] Invalid target humidity: ") + target + 
@@ -180,11 +170,8 @@ void HumidityControl::setTolerance(float tol) {
 
 // cppcheck-suppress unusedFunction
 void HumidityControl::setControlConstants(float p, float i, float d) {
-    kp = p;
-    ki = i;
-    kd = d;
-    errorSum = 0.0; // Reset integral
-    Serial.println(String("[HumidityControl] Control constants updated - Kp:") + kp + " Ki:" + ki + " Kd:" + kd);
+    pid.setGains(Q16_16(p), Q16_16(i), Q16_16(d));
+    Serial.println(String("[HumidityControl] Control constants updated - Kp:") + p + " Ki:" + i + " Kd:" + d);
 }
 
 // cppcheck-suppress unusedFunction
@@ -203,6 +190,18 @@ void HumidityControl::setCriticalLimits(float criticalLow, float criticalHigh) {
     Serial.println(String("[HumidityControl] Critical limits set: ") + criticalLow + "-" + criticalHigh + "%");
 }
 
+// cppcheck-suppress unusedFunction
+void HumidityControl::setFanWindow(unsigned long windowMs, unsigned long minSwitchMs) {
+    // The window must leave room for a minimum ON and a minimum OFF period
+    if (windowMs >= 2 * minSwitchMs && windowMs > 0) {
+        fanWindowSize = windowMs;
+        fanMinSwitchTime = minSwitchMs;
+        fanWindowStart = millis();
+        Serial.println(String("[HumidityControl] Fan window set to: ") + (windowMs / 1000) + "s, Min switch: " + 
+                      (minSwitchMs / 1000) + "s");
+    }
+}
+
 // cppcheck-suppress unusedFunction
 void HumidityControl::setDaytimeStatus(bool isDay) {
     isDaytime = isDay;
@@ -216,8 +215,7 @@ void HumidityControl::setTemperatureFactor(float factor) {
 // cppcheck-suppress unusedFunction
 void HumidityControl::enable() {
     enabled = true;
-    errorSum = 0.0;
-    previousError = 0.0;
+    pid.reset();
     lastUpdate = millis();
     Serial.println("[HumidityControl] Enabled");
 }
@@ -228,9 +226,31 @@ void HumidityControl::disable() {
     humidifyingActive = false;
     dehumidifyingActive = false;
     ventilationActive = false;
+    fanOutput = false;
+    fanDuty = 0.0;
+    fanOnTime = 0;
+    fanPulseDone = false;
+    humidifierDuty = 0.0;
     Serial.println("[HumidityControl] Disabled");
 }
 
+// cppcheck-suppress unusedFunction
+void HumidityControl::resetControl() {
+    // The fan is off when the relay experiment releases it: start from zero output
+    pid.reset();
+    lastUpdate = millis();
+    fanWindowStart = lastUpdate;
+    fanOnTime = 0;
+    fanDuty = 0.0;
+    humidifierDuty = 0.0;
+    fanOutput = false;
+    fanPulseDone = false;
+    humidifyingActive = false;
+    dehumidifyingActive = false;
+    ventilationActive = false;
+    Serial.println("[HumidityControl] Controller reset");
+}
+
 // cppcheck-suppress unusedFunction
 bool HumidityControl::isEnabled() const {
     return enabled;
@@ -268,25 +288,73 @@ bool HumidityControl::isInRange() const {
 
 // cppcheck-suppress unusedFunction
 int HumidityControl::getVentilationLevel() {
-    // Calculate ventilation level based on control state
-    if (!enabled || !ventilationActive) {
+    // Ventilation level is the dehumidifying duty the fan window delivers
+    if (!enabled) {
         return 0;
     }
+    return constrain((int)(fanDuty + 0.5f), 0, 100);
+}
+
+// cppcheck-suppress unusedFunction
+float HumidityControl::getControlOutput() const {
+    return pid.getOutput().toFloat();
+}
+
+// cppcheck-suppress unusedFunction
+bool HumidityControl::isFanOutputOn() const {
+    return enabled && fanOutput;
+}
+
+// cppcheck-suppress unusedFunction
+float HumidityControl::getFanDuty() const {
+    return enabled ? fanDuty : 0.0;
+}
+
+// cppcheck-suppress unusedFunction
+float HumidityControl::getHumidifierDuty() const {
+    return enabled ? humidifierDuty : 0.0;
+}
+
+void HumidityControl::updateFanOutput(unsigned long currentTime, float duty) {
+    duty = constrain(duty, 0.0f, 100.0f);
+    
+    // Roll over to a new window, catching up if updates were delayed
+    unsigned long elapsed = currentTime - fanWindowStart;
+    if (elapsed >= fanWindowSize) {
+        fanWindowStart += (elapsed / fanWindowSize) * fanWindowSize;
+        elapsed = currentTime - fanWindowStart;
+        fanPulseDone = false;
+    }
+    
+    // Convert duty to ON time within the window, respecting the minimum
+    // switch time for both the ON and the OFF pulse
+    unsigned long onTime = (unsigned long)((duty / 100.0) * fanWindowSize);
+    if (onTime < fanMinSwitchTime) {
+        onTime = 0;
+    } else if (fanWindowSize - onTime < fanMinSwitchTime) {
+        onTime = fanWindowSize;
+    }
     
-    // Calculate ventilation level based on humidity error (0-100%)
-    float error = abs(currentHumidity - targetHumidity);
-    float maxError = maxHumidity - minHumidity;
-    int level = (int)((error / maxError) * 100.0f);
+    fanDuty = (onTime * 100.0) / fanWindowSize;
     
-    // Constrain to 0-100%
-    return constrain(level, 0, 100);
+    // One ON pulse per window: once delivered, the fan waits for the next one
+    fanOnTime = fanPulseDone ? 0 : onTime;
+    
+    bool wasOn = fanOutput;
+    fanOutput = (elapsed < fanOnTime);
+    if (wasOn && !fanOutput) {
+        fanPulseDone = true;
+    }
+}
+
+// cppcheck-suppress unusedFunction
+float HumidityControl::getIntegralTerm() const {
+    return pid.getIntegralTerm().toFloat();
 }
 
 // cppcheck-suppress unusedFunction
-float HumidityControl::getControlOutput() {
-    // Return calculated PID output for monitoring purposes
-    float error = getError();
-    return (kp * error) + (ki * errorSum) + (kd * (error - previousError));
+void HumidityControl::restoreIntegralTerm(float integral) {
+    pid.reset(Q16_16(integral));
 }
 
 // cppcheck-suppress unusedFunction
@@ -1,5 +1,6 @@
 
 #include "logic/IrrigationControl.h"
+#include "config/config.h"
 
 // Devuelve si el riego está activo
 bool IrrigationControl::isIrrigationActive() const {
@@ -13,6 +14,8 @@ IrrigationControl::IrrigationControl() :
     previousMoisture(50.0),
     moistureRate(0.0),
     lastMoistureCheck(0),
+    planner(),
+    plannerEnabled(true),
     defaultIrrigationDuration(30),
     maxIrrigationDuration(300),
     minIntervalBetweenIrrigation(1800),
@@ -24,6 +27,8 @@ IrrigationControl::IrrigationControl() :
     lastIrrigationTime(0),
     currentIrrigationStart(0),
     irrigationActive(false),
+    deferredStart(false),
+    requestedDuration(0),
     temperatureFactor(1.0),
     humidityFactor(1.0),
     lightFactor(1.0),
@@ -41,9 +46,17 @@ IrrigationControl::IrrigationControl() :
     lastIrrigationDuration(0),
     morningSchedule({7, 0, 60, true, 0b01111111}),    // 7:00 AM, 60 seconds, every day
     eveningSchedule({19, 0, 45, true, 0b01111111}),   // 7:00 PM, 45 seconds, every day
-    emergencySchedule({12, 0, 120, true, 0b01111111}) // Emergency at noon
+    emergencySchedule({12, 0, 120, true, 0b01111111}), // Emergency at noon
+    lastScheduledMinute(-1),
+    scheduleTable()
 {
-    // Constructor body now empty of schedule initialization
+    // Rule order matches RULE_MORNING, RULE_EVENING
+    scheduleTable.addRule(morningSchedule.hour, morningSchedule.minute,
+                          morningSchedule.hour, morningSchedule.minute + 1,
+                          morningSchedule.durationSeconds, morningSchedule.weekDays);
+    scheduleTable.addRule(eveningSchedule.hour, eveningSchedule.minute,
+                          eveningSchedule.hour, eveningSchedule.minute + 1,
+                          eveningSchedule.durationSeconds, eveningSchedule.weekDays);
 }
 
 bool IrrigationControl::begin() {
@@ -54,6 +67,7 @@ bool IrrigationControl::begin() {
     
     enabled = true;
     scheduleEnabled = true;
+    configurePlanner();
     
     Serial.println("[IrrigationControl] Initialized successfully");
     Serial.println(String("[IrrigationControl] Target: ") + targetSoilMoisture + "%");
@@ -63,7 +77,8 @@ bool IrrigationControl::begin() {
 }
 
 // cppcheck-suppress unusedFunction
-void IrrigationControl::update(float currentMoisture, float temperature, float humidity, float lightLevel) {
+void IrrigationControl::update(float currentMoisture, float temperature, float humidity, float lightLevel,
+                               uint8_t currentHour, uint8_t currentMinute, uint8_t currentWeekDay) {
     if (!enabled) return;
     
     unsigned long currentTime = millis();
@@ -92,6 +107,12 @@ void IrrigationControl::update(float currentMoisture, float temperature, float h
     
     updateEvapotranspiration(temperature, humidity, lightLevel);
     
+    // Feed the drying curve history
+    planner.addSample(currentSoilMoisture, currentTime);
+    
+    // Waiting for the scheduler to open this zone's valve
+    if (requestedDuration > 0) return;
+    
     // Check emergency conditions
     if (currentSoilMoisture <= emergencyMoistureThreshold && !irrigationActive) {
         emergencyIrrigation();
@@ -107,8 +128,23 @@ void IrrigationControl::update(float currentMoisture, float temperature, float h
         return;
     }
     
-    // Check if irrigation is needed
-    if (needsIrrigation() && isValidIrrigationTime()) {
+    // Receding horizon: re-plan the next pulse with the latest readings
+    planner.plan(currentTime, lastIrrigationTime);
+    
+    if (plannerEnabled && planner.hasModel()) {
+        if (planner.shouldIrrigateNow(currentTime) && !isRainingOutside) {
+            // Planned pulses already account for the measured drying rate
+            Serial.println(String("[IrrigationControl] Planned pulse: ") + planner.getPlannedPulse() + "s");
+            beginIrrigationSession(planner.getPlannedPulse());
+        }
+    } else if (isScheduledTime(currentWeekDay, currentHour, currentMinute) && !isRainingOutside) {
+        // No drying model yet: fixed morning/evening sessions, once per scheduled minute
+        lastScheduledMinute = currentHour * 60 + currentMinute;
+        float duration = scheduleTable.getActiveValue(currentWeekDay, currentHour, currentMinute, 0.0);
+        Serial.println(String("[IrrigationControl] Scheduled irrigation at ") + currentHour + ":" + currentMinute);
+        startIrrigation((unsigned int)duration);
+    } else if (needsIrrigation() && isValidIrrigationTime()) {
+        // No drying model yet: reactive policy
         unsigned int duration = calculateOptimalDuration();
         startIrrigation(duration);
     }
@@ -118,8 +154,11 @@ void IrrigationControl::update(float currentMoisture, float temperature, float h
 
 // cppcheck-suppress unusedFunction
 void IrrigationControl::setTarget(float targetMoisture) {
+    if (targetMoisture == targetSoilMoisture) return;
+    
     if (targetMoisture >= 30.0 && targetMoisture <= 95.0) {
         targetSoilMoisture = targetMoisture;
+        configurePlanner();
         Serial.println(String("[IrrigationControl] Target soil moisture set to: ") + targetMoisture + "%");
     }
 }
@@ -138,6 +177,7 @@ void IrrigationControl::enable() {
 // cppcheck-suppress unusedFunction
 void IrrigationControl::disable() {
     enabled = false;
+    cancelIrrigationRequest();
     if (irrigationActive) {
         stopIrrigation();
     }
@@ -149,6 +189,11 @@ bool IrrigationControl::isEnabled() const {
     return enabled;
 }
 
+// cppcheck-suppress unusedFunction
+bool IrrigationControl::isEmergencyModeActive() const {
+    return emergencyModeActive;
+}
+
 void IrrigationControl::startIrrigation(unsigned int duration) {
     if (!enabled || irrigationActive) return;
     
@@ -158,9 +203,27 @@ void IrrigationControl::startIrrigation(unsigned int duration) {
     
     // Apply environmental factors to duration
     float adjustedDuration = duration * temperatureFactor * humidityFactor * lightFactor;
-    adjustedDuration = min(adjustedDuration, (float)maxIrrigationDuration);
+    beginIrrigationSession(adjustedDuration);
+}
+
+void IrrigationControl::beginIrrigationSession(float durationSeconds) {
+    if (!enabled || irrigationActive || requestedDuration > 0) return;
+    
+    unsigned int seconds = (unsigned int)min(durationSeconds, (float)maxIrrigationDuration);
+    if (seconds == 0) return;
     
-    wateringSessionTime = (unsigned long)adjustedDuration * 1000; // Convert to milliseconds
+    if (deferredStart) {
+        // The scheduler starts the session once the valve is open and the pump free
+        requestedDuration = seconds;
+        Serial.println(String("[IrrigationControl] Irrigation requested - Duration: ") + seconds + "s");
+        return;
+    }
+    
+    activateSession(seconds);
+}
+
+void IrrigationControl::activateSession(unsigned int durationSeconds) {
+    wateringSessionTime = durationSeconds * 1000UL; // Convert to milliseconds
     currentIrrigationStart = millis();
     irrigationActive = true;
     lastIrrigationTime = currentIrrigationStart;
@@ -168,12 +231,139 @@ void IrrigationControl::startIrrigation(unsigned int duration) {
     totalIrrigations++;
     dailyIrrigations++;
     
-    float sessionWater = (waterFlowRate * adjustedDuration) / 60.0; // ml
+    float sessionWater = (waterFlowRate * durationSeconds) / 60.0; // ml
     totalWaterUsed += sessionWater;
     dailyWaterUsed += sessionWater;
     
+    // Every pulse (planned, manual or emergency) restarts the drying curve
+    planner.notifyIrrigation(durationSeconds, currentSoilMoisture, currentIrrigationStart);
+    
     Serial.println(String("[IrrigationControl] Irrigation started - Duration: ") + 
-                  (adjustedDuration) + "s, Water: " + sessionWater + "ml");
+                  durationSeconds + "s, Water: " + sessionWater + "ml");
+}
+
+// cppcheck-suppress unusedFunction
+void IrrigationControl::setDeferredStart(bool deferred) {
+    deferredStart = deferred;
+    if (!deferred) {
+        cancelIrrigationRequest();
+    }
+}
+
+// cppcheck-suppress unusedFunction
+unsigned int IrrigationControl::getRequestedDuration() const {
+    return requestedDuration;
+}
+
+// cppcheck-suppress unusedFunction
+bool IrrigationControl::confirmIrrigationStart() {
+    if (requestedDuration == 0 || !enabled) return false;
+    
+    unsigned int seconds = requestedDuration;
+    requestedDuration = 0;
+    activateSession(seconds);
+    return true;
+}
+
+// cppcheck-suppress unusedFunction
+bool IrrigationControl::joinPumpRun() {
+    if (!enabled || irrigationActive || requestedDuration > 0 || isRainingOutside) return false;
+    if (!plannerEnabled || !planner.hasModel() || !isValidIrrigationTime()) return false;
+    if (!planner.shouldIrrigateNow(millis(), IRRIGATION_PLANNER_MERGE_WINDOW)) return false;
+    
+    // Slightly early, but one pump start instead of two
+    Serial.println(String("[IrrigationControl] Planned pulse joins the running pump: ") + planner.getPlannedPulse() + "s");
+    beginIrrigationSession(planner.getPlannedPulse());
+    return requestedDuration > 0;
+}
+
+// cppcheck-suppress unusedFunction
+void IrrigationControl::cancelIrrigationRequest() {
+    if (requestedDuration == 0) return;
+    
+    requestedDuration = 0;
+    emergencyModeActive = false;
+    Serial.println("[IrrigationControl] Irrigation request cancelled");
+}
+
+// cppcheck-suppress unusedFunction
+void IrrigationControl::setWaterFlowRate(float flowRate) {
+    if (flowRate > 0.0) {
+        waterFlowRate = flowRate;
+    }
+}
+
+// cppcheck-suppress unusedFunction
+float IrrigationControl::getWaterFlowRate() const {
+    return waterFlowRate;
+}
+
+void IrrigationControl::configurePlanner() {
+    // Pump duty limits: never shorter than the pump's own rest time or longer than its max run
+    unsigned long minInterval = max(minIntervalBetweenIrrigation, (unsigned int)WATER_PUMP_MIN_INTERVAL) * 1000UL;
+    unsigned int maxPulse = min(maxIrrigationDuration, (unsigned int)WATER_PUMP_MAX_RUN_TIME);
+    planner.configure(targetSoilMoisture - tolerance, targetSoilMoisture + tolerance, minInterval, maxPulse);
+}
+
+// cppcheck-suppress unusedFunction
+const IrrigationPlanner& IrrigationControl::getPlanner() const {
+    return planner;
+}
+
+// cppcheck-suppress unusedFunction
+void IrrigationControl::enablePlanner(bool enable) {
+    if (enable == plannerEnabled) return;
+    
+    // The model keeps learning either way; only the decisions change
+    plannerEnabled = enable;
+    Serial.println(String("[IrrigationControl] Planner ") + (enable ? "enabled" : "disabled"));
+}
+
+// cppcheck-suppress unusedFunction
+bool IrrigationControl::isPlannerEnabled() const {
+    return plannerEnabled;
+}
+
+// cppcheck-suppress unusedFunction
+void IrrigationControl::saveState(StateSnapshot::Zone& state) const {
+    state.lastIrrigationTime = (int32_t)lastIrrigationTime;
+    state.sessionActive = irrigationActive;
+    if (irrigationActive) {
+        state.sessionStart = (int32_t)currentIrrigationStart;
+        state.sessionLength = wateringSessionTime;
+    } else {
+        state.sessionLength = requestedDuration * 1000UL;
+    }
+}
+
+// cppcheck-suppress unusedFunction
+void IrrigationControl::restoreState(const StateSnapshot::Zone& state) {
+    // The minimum interval keeps counting from the pulse before the reset: no double watering
+    lastIrrigationTime = state.lastIrrigationTime;
+    
+    unsigned long remaining = state.sessionLength;
+    if (state.sessionActive) {
+        unsigned long elapsed = millis() - (unsigned long)state.sessionStart;
+        remaining = elapsed < state.sessionLength ? state.sessionLength - elapsed : 0;
+    }
+    if (remaining == 0) return;
+    
+    if (remaining < SNAPSHOT_MIN_RESUME * 1000UL) {
+        Serial.println(String("[IrrigationControl] Interrupted irrigation not resumed (") + (remaining / 1000) + "s left)");
+        return;
+    }
+    // Same path as a new pulse: with a shared pump the scheduler opens the valve first
+    Serial.println(String("[IrrigationControl] Resuming interrupted irrigation: ") + (remaining / 1000) + "s left");
+    beginIrrigationSession(remaining / 1000.0f);
+}
+
+// cppcheck-suppress unusedFunction
+bool IrrigationControl::predictIrrigationNeed(unsigned int hoursAhead) const {
+    if (!planner.hasModel()) {
+        return needsIrrigation();
+    }
+    float predicted = planner.predictMoisture(millis() + hoursAhead * 3600000UL);
+    return predicted < (targetSoilMoisture - tolerance);
 }
 
 void IrrigationControl::stopIrrigation() {
@@ -190,7 +380,7 @@ void IrrigationControl::stopIrrigation() {
 }
 
 void IrrigationControl::emergencyIrrigation() {
-    if (irrigationActive) return;
+    if (irrigationActive || requestedDuration > 0) return;
     
     emergencyModeActive = true;
     unsigned int emergencyDuration = min((unsigned int)(defaultIrrigationDuration * 2), maxIrrigationDuration);
@@ -228,6 +418,48 @@ bool IrrigationControl::isValidIrrigationTime() const {
     return true;
 }
 
+bool IrrigationControl::isScheduledTime(uint8_t currentWeekDay, uint8_t currentHour, uint8_t currentMinute) const {
+    if (!scheduleEnabled || currentHour > 23) return false; // 255 = wall-clock time unknown
+    if (lastScheduledMinute == currentHour * 60 + currentMinute) return false;
+    return scheduleTable.getActiveRule(currentWeekDay, currentHour, currentMinute) != ScheduleTable::NO_RULE;
+}
+
+void IrrigationControl::compileSchedule(uint8_t rule, const IrrigationSchedule& schedule) {
+    // Sessions are one-minute windows; 23:59 ends at 24:00
+    scheduleTable.setRule(rule, schedule.hour, schedule.minute,
+                          schedule.hour, schedule.minute + 1,
+                          schedule.durationSeconds, schedule.weekDays);
+    scheduleTable.setRuleEnabled(rule, schedule.enabled);
+}
+
+// cppcheck-suppress unusedFunction
+void IrrigationControl::setMorningSchedule(uint8_t hour, uint8_t minute, unsigned int duration, uint8_t weekDays) {
+    morningSchedule = {hour, minute, duration, true, weekDays};
+    compileSchedule(RULE_MORNING, morningSchedule);
+}
+
+// cppcheck-suppress unusedFunction
+void IrrigationControl::setEveningSchedule(uint8_t hour, uint8_t minute, unsigned int duration, uint8_t weekDays) {
+    eveningSchedule = {hour, minute, duration, true, weekDays};
+    compileSchedule(RULE_EVENING, eveningSchedule);
+}
+
+// cppcheck-suppress unusedFunction
+int8_t IrrigationControl::addScheduledSession(uint8_t hour, uint8_t minute, unsigned int duration, uint8_t weekDays) {
+    int8_t rule = scheduleTable.addRule(hour, minute, hour, minute + 1, duration, weekDays);
+    if (rule != ScheduleTable::NO_RULE) {
+        Serial.println(String("[IrrigationControl] Scheduled session added at ") + hour + ":" + minute +
+                       " (" + duration + "s)");
+    }
+    return rule;
+}
+
+// cppcheck-suppress unusedFunction
+uint16_t IrrigationControl::getMinutesToNextSession(uint8_t weekDay, uint8_t hour, uint8_t minute) const {
+    if (!scheduleEnabled || hour > 23) return ScheduleTable::NO_CHANGE;
+    return scheduleTable.getMinutesToNextChange(weekDay, hour, minute);
+}
+
 unsigned int IrrigationControl::calculateOptimalDuration() const {
     float moistureDeficit = targetSoilMoisture - currentSoilMoisture;
     
@@ -253,6 +485,8 @@ String IrrigationControl::getStatusString() const {
     } else if (irrigationActive) {
         unsigned long remaining = (wateringSessionTime - (millis() - currentIrrigationStart)) / 1000;
         status += " (IRRIGATING: " + String(remaining) + "s)";
+    } else if (requestedDuration > 0) {
+        status += " (WAITING VALVE: " + String(requestedDuration) + "s)";
     } else if (emergencyModeActive) {
         status += " (EMERGENCY)";
     } else {
@@ -260,6 +494,7 @@ String IrrigationControl::getStatusString() const {
     }
     
     status += " [Target: " + String(targetSoilMoisture, 1) + "%]";
+    status += " [Plan: " + planner.getStatusString(millis()) + "]";
     
     return status;
 }
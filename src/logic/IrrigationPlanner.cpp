@@ -0,0 +1,323 @@
+#include "logic/IrrigationPlanner.h"
+#include "config/config.h"
+
+static const float MS_PER_HOUR = 3600000.0;
+
+IrrigationPlanner::IrrigationPlanner() :
+    sampleTimes(),
+    sampleValues(),
+    sampleCount(0),
+    sampleHead(0),
+    segmentSamples(0),
+    lastSampleTime(0),
+    lowerBound(65.0),
+    upperBound(75.0),
+    minInterval(1800000),
+    maxPulse(300),
+    modelValid(false),
+    decayRate(0.0),
+    recentDecayRate(0.0),
+    anchorMoisture(0.0),
+    anchorTime(0),
+    responseGain(IRRIGATION_PLANNER_DEFAULT_GAIN),
+    gainMeasured(false),
+    learnedMargin(IRRIGATION_PLANNER_MARGIN - IRRIGATION_PLANNER_MIN_MARGIN),
+    holdingBound(false),
+    awaitingResponse(false),
+    pulseStart(0),
+    pulseSeconds(0),
+    moistureBeforePulse(0.0),
+    pulsePlanned(false),
+    nextPulseTime(0),
+    plannedPulse(0),
+    timeToCrossing(-1)
+{
+}
+
+void IrrigationPlanner::configure(float lower, float upper, unsigned long minIntervalMs, unsigned int maxPulseSeconds) {
+    if (lower < upper) {
+        // Keep a safety margin above the bound for sensor noise and model error
+        lowerBound = min(lower + (float)IRRIGATION_PLANNER_MIN_MARGIN, upper);
+        upperBound = upper;
+    }
+    minInterval = minIntervalMs;
+    maxPulse = max(maxPulseSeconds, (unsigned int)IRRIGATION_PLANNER_MIN_PULSE);
+}
+
+// cppcheck-suppress unusedFunction
+void IrrigationPlanner::reset() {
+    sampleCount = 0;
+    sampleHead = 0;
+    segmentSamples = 0;
+    modelValid = false;
+    decayRate = 0.0;
+    recentDecayRate = 0.0;
+    responseGain = IRRIGATION_PLANNER_DEFAULT_GAIN;
+    gainMeasured = false;
+    learnedMargin = IRRIGATION_PLANNER_MARGIN - IRRIGATION_PLANNER_MIN_MARGIN;
+    holdingBound = false;
+    awaitingResponse = false;
+    pulsePlanned = false;
+    timeToCrossing = -1;
+}
+
+void IrrigationPlanner::addSample(float moisture, unsigned long currentTime) {
+    if (isnan(moisture)) return;
+
+    // Ignore the wetting front until the pulse has soaked in
+    if (awaitingResponse) {
+        unsigned long soakTime = pulseSeconds * 1000UL + IRRIGATION_PLANNER_SETTLE_TIME;
+        if (currentTime - pulseStart < soakTime) return;
+        learnResponse(moisture, currentTime);
+    }
+
+    if (sampleCount > 0 && currentTime - lastSampleTime < IRRIGATION_PLANNER_SAMPLE_INTERVAL) {
+        return;
+    }
+
+    sampleTimes[sampleHead] = currentTime;
+    sampleValues[sampleHead] = moisture;
+    sampleHead = (sampleHead + 1) % MAX_SAMPLES;
+    if (sampleCount < MAX_SAMPLES) sampleCount++;
+    if (segmentSamples < MAX_SAMPLES) segmentSamples++;
+    lastSampleTime = currentTime;
+
+    fitSegment();
+}
+
+void IrrigationPlanner::notifyIrrigation(unsigned int seconds, float moistureBefore, unsigned long currentTime) {
+    // Once the bound is being held, a planned pulse should find the soil still above it:
+    // each shortfall (drying faster than fitted, wait for the shared pump) widens the
+    // margin by its size, and it shrinks back slowly while pulses arrive in time.
+    // Pulses that are still filling a dry soil up teach nothing about the plan
+    if (pulsePlanned && !isnan(moistureBefore)) {
+        if (holdingBound) {
+            float shortfall = lowerBound - moistureBefore;
+            if (shortfall > 0.0) {
+                learnedMargin += shortfall;
+            } else {
+                learnedMargin *= (float)IRRIGATION_PLANNER_MARGIN_DECAY;
+            }
+            learnedMargin = constrain(learnedMargin, 0.0f, (upperBound - lowerBound) / 2.0f);
+        }
+        holdingBound = moistureBefore >= lowerBound - (float)IRRIGATION_PLANNER_MIN_RISE;
+    }
+    // Predicted level without water, used later to measure the soil response
+    moistureBeforePulse = modelValid ? predictMoisture(currentTime) : moistureBefore;
+    pulseStart = currentTime;
+    pulseSeconds = seconds;
+    awaitingResponse = true;
+    pulsePlanned = false;
+}
+
+void IrrigationPlanner::learnResponse(float moisture, unsigned long currentTime) {
+    awaitingResponse = false;
+
+    // What the soil would read now without the pulse
+    float residual = IRRIGATION_PLANNER_RESIDUAL_MOISTURE;
+    float hours = (currentTime - pulseStart) / MS_PER_HOUR;
+    float expected = residual + (moistureBeforePulse - residual) * exp(-decayRate * hours);
+
+    // Noisy readings may come out below the expectation; keep them, the average is unbiased
+    if (pulseSeconds > 0) {
+        float observed = (moisture - expected) / pulseSeconds;
+        if (gainMeasured) {
+            // Bound single outliers so one bad reading cannot swing the pulse size
+            observed = constrain(observed, 0.5f * responseGain, 2.0f * responseGain);
+            responseGain = constrain(0.7 * responseGain + 0.3 * observed, 0.01f, 2.0f);
+        } else {
+            // The default only sizes the first pulse: the first response replaces it
+            responseGain = constrain(observed, 0.01f, 2.0f);
+            gainMeasured = true;
+        }
+    }
+
+    // Lift the pre-pulse history onto the new drying curve so the decay rate
+    // keeps being fitted across pulses: in the model a pulse only scales (m - r)
+    if (modelValid && expected > residual + 0.1 && moisture > residual) {
+        float ratio = (moisture - residual) / (expected - residual);
+        for (uint8_t i = 0; i < sampleCount; i++) {
+            sampleValues[i] = residual + (sampleValues[i] - residual) * ratio;
+        }
+    } else {
+        sampleCount = 0;
+        sampleHead = 0;
+    }
+    segmentSamples = 0;
+}
+
+void IrrigationPlanner::fitSegment() {
+    float residual = IRRIGATION_PLANNER_RESIDUAL_MOISTURE;
+    uint8_t newest = (sampleHead + MAX_SAMPLES - 1) % MAX_SAMPLES;
+    unsigned long newestTime = sampleTimes[newest];
+
+    float rate, intercept;
+    if (sampleCount >= MIN_FIT_SAMPLES && fitDecay(sampleCount, rate, intercept)) {
+        decayRate = rate;
+        anchorMoisture = residual + exp(intercept);
+        anchorTime = newestTime;
+        modelValid = true;
+        // The lifted history carries the old rate across each pulse and lags a drying
+        // that speeds up towards midday: fit the samples since the last pulse on their own
+        float recentIntercept;
+        uint8_t recentCount = min(segmentSamples, MIN_FIT_SAMPLES);
+        if (recentCount >= MIN_RECENT_SAMPLES && fitDecay(recentCount, rate, recentIntercept)) {
+            recentDecayRate = rate;
+            anchorMoisture = residual + exp(recentIntercept);
+        } else {
+            recentDecayRate = decayRate;
+        }
+    } else if (modelValid) {
+        // Too few points for a new fit: keep the decay rate, re-anchor the level
+        // on the average of the segment projected to the newest sample
+        float sum = 0;
+        for (uint8_t i = 0; i < sampleCount; i++) {
+            float hours = (newestTime - sampleTimes[i]) / MS_PER_HOUR;
+            sum += residual + (sampleValues[i] - residual) * exp(-decayRate * hours);
+        }
+        anchorMoisture = sum / sampleCount;
+        anchorTime = newestTime;
+    }
+}
+
+bool IrrigationPlanner::fitDecay(uint8_t count, float& rate, float& intercept) const {
+    float residual = IRRIGATION_PLANNER_RESIDUAL_MOISTURE;
+    uint8_t newest = (sampleHead + MAX_SAMPLES - 1) % MAX_SAMPLES;
+    unsigned long newestTime = sampleTimes[newest];
+
+    // Least squares on ln(m - r) = a + b·t over the newest samples,
+    // t in hours relative to the newest one
+    float sumT = 0, sumY = 0, sumTT = 0, sumTY = 0;
+    for (uint8_t j = 0; j < count; j++) {
+        uint8_t i = (newest + MAX_SAMPLES - j) % MAX_SAMPLES;
+        float t = -((float)(newestTime - sampleTimes[i]) / MS_PER_HOUR);
+        float y = log(max(sampleValues[i] - residual, 0.1f));
+        sumT += t;
+        sumY += y;
+        sumTT += t * t;
+        sumTY += t * y;
+    }
+    float n = count;
+    float denom = n * sumTT - sumT * sumT;
+    if (denom <= 0.0) return false;
+
+    float slope = (n * sumTY - sumT * sumY) / denom;
+    intercept = (sumY - slope * sumT) / n;
+    // Rising or flat soil (night, rain) means no drying for now
+    rate = max(-slope, 0.0f);
+    return true;
+}
+
+void IrrigationPlanner::plan(unsigned long currentTime, unsigned long lastIrrigationTime) {
+    pulsePlanned = false;
+    timeToCrossing = -1;
+
+    float residual = IRRIGATION_PLANNER_RESIDUAL_MOISTURE;
+    float floorLevel = lowerBound + learnedMargin;
+    if (!modelValid || awaitingResponse || floorLevel <= residual) return;
+
+    // When will the soil cross the lower bound?
+    float moistureNow = predictMoisture(currentTime);
+    if (moistureNow <= floorLevel) {
+        timeToCrossing = 0;
+    } else if (decayRate > 0.0) {
+        float hours = log((moistureNow - residual) / (floorLevel - residual)) / decayRate;
+        if (hours * MS_PER_HOUR > IRRIGATION_PLANNER_HORIZON) return;
+        timeToCrossing = (long)(hours * MS_PER_HOUR);
+    } else {
+        return;
+    }
+
+    // Pulse shortly before the crossing, but never before the pump may run again
+    long wait = max(timeToCrossing - (long)IRRIGATION_PLANNER_LEAD_TIME, 0L);
+    if (lastIrrigationTime != 0) {
+        long intervalWait = (long)(lastIrrigationTime + minInterval - currentTime);
+        wait = max(wait, intervalWait);
+    }
+    unsigned long pulseTime = currentTime + wait;
+
+    // Replace the drying predicted until the next pulse: at least until the next
+    // opportunity, and at least the minimum rise so the pump is not started for tenths,
+    // on the faster of the segment and the recent drying
+    float holdHours = (minInterval + IRRIGATION_PLANNER_LEAD_TIME) / MS_PER_HOUR;
+    float holdRate = max(decayRate, recentDecayRate);
+    float moistureAfter = residual + (floorLevel - residual) * exp(holdRate * holdHours);
+    moistureAfter = max(moistureAfter, floorLevel + (float)IRRIGATION_PLANNER_MIN_RISE);
+    moistureAfter = min(moistureAfter, upperBound);
+    float deficit = moistureAfter - predictMoisture(pulseTime);
+    if (deficit <= 0.0) return;
+
+    unsigned int seconds = (unsigned int)ceil(deficit / responseGain);
+    seconds = constrain(seconds, (unsigned int)IRRIGATION_PLANNER_MIN_PULSE, maxPulse);
+
+    pulsePlanned = true;
+    nextPulseTime = pulseTime;
+    plannedPulse = seconds;
+}
+
+bool IrrigationPlanner::shouldIrrigateNow(unsigned long currentTime, unsigned long advance) const {
+    return pulsePlanned && (long)(currentTime + advance - nextPulseTime) >= 0;
+}
+
+bool IrrigationPlanner::hasModel() const {
+    return modelValid;
+}
+
+// cppcheck-suppress unusedFunction
+float IrrigationPlanner::getDecayRate() const {
+    return decayRate;
+}
+
+// cppcheck-suppress unusedFunction
+float IrrigationPlanner::getResponseGain() const {
+    return responseGain;
+}
+
+// cppcheck-suppress unusedFunction
+float IrrigationPlanner::getLearnedMargin() const {
+    return learnedMargin;
+}
+
+float IrrigationPlanner::predictMoisture(unsigned long atTime) const {
+    if (!modelValid) return NAN;
+
+    float residual = IRRIGATION_PLANNER_RESIDUAL_MOISTURE;
+    float hours = (long)(atTime - anchorTime) / MS_PER_HOUR;
+    return residual + (anchorMoisture - residual) * exp(-decayRate * hours);
+}
+
+// cppcheck-suppress unusedFunction
+long IrrigationPlanner::getTimeToCrossing() const {
+    return timeToCrossing;
+}
+
+// cppcheck-suppress unusedFunction
+bool IrrigationPlanner::isPulsePlanned() const {
+    return pulsePlanned;
+}
+
+// cppcheck-suppress unusedFunction
+unsigned long IrrigationPlanner::getNextPulseTime() const {
+    return nextPulseTime;
+}
+
+unsigned int IrrigationPlanner::getPlannedPulse() const {
+    return plannedPulse;
+}
+
+String IrrigationPlanner::getStatusString(unsigned long currentTime) const {
+    if (!modelValid) {
+        return "LEARNING (" + String(sampleCount) + "/" + String(MIN_FIT_SAMPLES) + " samples)";
+    }
+
+    String status = "k: " + String(decayRate, 3) + "/h, gain: " + String(responseGain, 2) + "%/s";
+    if (pulsePlanned) {
+        long wait = (long)(nextPulseTime - currentTime);
+        status += ", next: " + String(plannedPulse) + "s in " + String(max(wait, 0L) / 60000) + "min";
+    } else if (awaitingResponse) {
+        status += ", soaking";
+    } else {
+        status += ", no pulse within horizon";
+    }
+    return status;
+}
@@ -0,0 +1,335 @@
+#include "logic/IrrigationScheduler.h"
+#include "config/config.h"
+
+IrrigationScheduler::IrrigationScheduler() :
+    zones(),
+    zoneCount(0),
+    queue(),
+    queueHead(0),
+    queueSize(0),
+    pump(nullptr),
+    valves(nullptr),
+    state(STATE_IDLE),
+    stateSince(0),
+    activeZone(NO_ZONE),
+    closingZone(NO_ZONE),
+    closingAt(0),
+    restPending(false),
+    lastUpdate(0),
+    pumpStarts(0)
+{
+}
+
+bool IrrigationScheduler::begin(WaterPumpActuator* waterPump, RelayController* valveRelays) {
+    if (!waterPump || !valveRelays) {
+        Serial.println("[IrrigationScheduler] Error: Invalid pump or valve controller");
+        return false;
+    }
+
+    pump = waterPump;
+    valves = valveRelays;
+    state = STATE_IDLE;
+    lastUpdate = millis();
+
+    Serial.println("[IrrigationScheduler] Initialized");
+    return true;
+}
+
+int8_t IrrigationScheduler::addZone(IrrigationControl* control, uint8_t relayChannel, const String& name) {
+    if (!control || zoneCount >= MAX_ZONES) {
+        Serial.println("[IrrigationScheduler] Error: Cannot add zone " + name);
+        return NO_ZONE;
+    }
+
+    Zone& zone = zones[zoneCount];
+    zone.control = control;
+    zone.relayChannel = relayChannel;
+    zone.name = name;
+    zone.queued = false;
+    zone.runStart = 0;
+    zone.runDuration = 0;
+    zone.totalVolume = 0.0;
+    zone.dailyVolume = 0.0;
+    zone.runCount = 0;
+
+    // The zone waits for its valve instead of starting on its own
+    control->setDeferredStart(true);
+
+    Serial.println(String("[IrrigationScheduler] Zone ") + zoneCount + " (" + name + ") on relay channel " + relayChannel);
+    return zoneCount++;
+}
+
+void IrrigationScheduler::update() {
+    if (!pump || !valves) return;
+
+    unsigned long currentTime = millis();
+
+    // Water reaches the active zone whenever the pump runs with its valve open
+    if (activeZone != NO_ZONE && pump->isRunning()) {
+        Zone& zone = zones[activeZone];
+        float volume = zone.control->getWaterFlowRate() * (currentTime - lastUpdate) / 60000.0;
+        zone.totalVolume += volume;
+        zone.dailyVolume += volume;
+    }
+    lastUpdate = currentTime;
+
+    // Collect new requests
+    for (uint8_t i = 0; i < zoneCount; i++) {
+        if (!zones[i].queued && i != activeZone && zones[i].control->getRequestedDuration() > 0) {
+            enqueue(i);
+        }
+    }
+
+    // Close the previous valve once the next one has been open for the overlap
+    if (closingZone != NO_ZONE && currentTime - closingAt >= IRRIGATION_VALVE_OVERLAP) {
+        if (valves->deactivateRelay(zones[closingZone].relayChannel)) {
+            closingZone = NO_ZONE;
+        }
+    }
+
+    switch (state) {
+        case STATE_IDLE: {
+            int8_t next = dequeue();
+            if (next != NO_ZONE) {
+                activeZone = next;
+                valves->activateRelay(zones[next].relayChannel);
+                setState(STATE_OPENING, currentTime);
+            }
+            break;
+        }
+
+        case STATE_OPENING:
+            if (zones[activeZone].control->getRequestedDuration() == 0) {
+                // Request withdrawn while the valve was opening
+                setState(STATE_DRAINING, currentTime);
+            } else if (currentTime - stateSince >= IRRIGATION_VALVE_SETTLE_TIME && pump->turnOn()) {
+                // Retried every update until the pump's own switching interval allows it
+                pumpStarts++;
+                startZone(activeZone, currentTime);
+                setState(STATE_RUNNING, currentTime);
+                // Zones whose planned pulse is close ride on this start (handover below)
+                for (uint8_t i = 0; i < zoneCount; i++) {
+                    if (i != activeZone && !zones[i].queued && zones[i].control->joinPumpRun()) {
+                        enqueue(i);
+                    }
+                }
+            }
+            break;
+
+        case STATE_RUNNING: {
+            Zone& zone = zones[activeZone];
+            bool finished = !zone.control->isIrrigationActive() ||
+                            currentTime - zone.runStart >= zone.runDuration ||
+                            !pump->isRunning(); // Pump stopped by its safety guard
+            if (!finished) break;
+
+            finishZone(activeZone);
+
+            // Back-to-back zones: hand over valves with the pump still pressurized
+            restPending = pump->isRunning() && queueSize > 0 && !pumpHasRoomFor(queue[queueHead]);
+            if (pump->isRunning() && queueSize > 0 && !restPending) {
+                int8_t next = dequeue();
+                if (next != NO_ZONE) {
+                    valves->activateRelay(zones[next].relayChannel);
+                    closingZone = activeZone;
+                    closingAt = currentTime;
+                    activeZone = next;
+                    startZone(next, currentTime);
+                    Serial.println("[IrrigationScheduler] Handover to zone " + zones[next].name + " (pump kept on)");
+                    break;
+                }
+            }
+
+            setState(STATE_DRAINING, currentTime);
+            break;
+        }
+
+        case STATE_DRAINING:
+            if (pump->isRunning()) {
+                // Retried every update until the pump's own switching interval allows it
+                if (pump->turnOff()) {
+                    stateSince = currentTime;
+                }
+                break;
+            }
+            if (currentTime - stateSince >= IRRIGATION_VALVE_SETTLE_TIME) {
+                if (activeZone != NO_ZONE) {
+                    valves->deactivateRelay(zones[activeZone].relayChannel);
+                    activeZone = NO_ZONE;
+                }
+                // Let the pump rest if the next zone would have exceeded its continuous run
+                setState(restPending ? STATE_RESTING : STATE_IDLE, currentTime);
+                restPending = false;
+            }
+            break;
+
+        case STATE_RESTING:
+            if (currentTime - stateSince >= IRRIGATION_PUMP_REST_TIME) {
+                setState(STATE_IDLE, currentTime);
+            }
+            break;
+    }
+}
+
+void IrrigationScheduler::startZone(uint8_t zone, unsigned long currentTime) {
+    Zone& z = zones[zone];
+    z.runDuration = z.control->getRequestedDuration() * 1000UL;
+    z.runStart = currentTime;
+    z.control->confirmIrrigationStart();
+    Serial.println(String("[IrrigationScheduler] Zone ") + z.name + " watering for " + (z.runDuration / 1000) + "s");
+}
+
+void IrrigationScheduler::finishZone(uint8_t zone) {
+    Zone& z = zones[zone];
+    if (z.control->isIrrigationActive()) {
+        z.control->stopIrrigation();
+    }
+    z.runCount++;
+    Serial.println(String("[IrrigationScheduler] Zone ") + z.name + " done, total " + String(z.totalVolume, 0) + " ml");
+}
+
+bool IrrigationScheduler::pumpHasRoomFor(uint8_t zone) const {
+    unsigned long pending = zones[zone].control->getRequestedDuration() * 1000UL;
+    return pump->getContinuousRunTime() + pending <= IRRIGATION_PUMP_MAX_CONTINUOUS;
+}
+
+void IrrigationScheduler::setState(State newState, unsigned long currentTime) {
+    state = newState;
+    stateSince = currentTime;
+    if (newState == STATE_DRAINING && pump->isRunning() && !pump->turnOff()) {
+        // Still inside the pump's switching interval: retried while draining
+        stateSince = currentTime;
+    }
+}
+
+bool IrrigationScheduler::enqueue(uint8_t zone) {
+    if (queueSize >= MAX_ZONES) return false;
+    queue[(queueHead + queueSize) % MAX_ZONES] = zone;
+    queueSize++;
+    zones[zone].queued = true;
+    return true;
+}
+
+int8_t IrrigationScheduler::dequeue() {
+    while (queueSize > 0) {
+        uint8_t zone = queue[queueHead];
+        queueHead = (queueHead + 1) % MAX_ZONES;
+        queueSize--;
+        zones[zone].queued = false;
+        // Skip requests withdrawn while waiting
+        if (zones[zone].control->getRequestedDuration() > 0) {
+            return zone;
+        }
+    }
+    return NO_ZONE;
+}
+
+// cppcheck-suppress unusedFunction
+void IrrigationScheduler::stopAll() {
+    for (uint8_t i = 0; i < zoneCount; i++) {
+        zones[i].control->cancelIrrigationRequest();
+        if (zones[i].control->isIrrigationActive()) {
+            zones[i].control->stopIrrigation();
+        }
+        zones[i].queued = false;
+    }
+    queueSize = 0;
+
+    // Pump first, then the valves once the line is depressurized
+    if (activeZone != NO_ZONE || pump->isRunning()) {
+        setState(STATE_DRAINING, millis());
+    }
+    Serial.println("[IrrigationScheduler] All zones stopped");
+}
+
+// Status
+// cppcheck-suppress unusedFunction
+uint8_t IrrigationScheduler::getZoneCount() const {
+    return zoneCount;
+}
+
+// cppcheck-suppress unusedFunction
+IrrigationControl* IrrigationScheduler::getZoneControl(uint8_t zone) const {
+    return zone < zoneCount ? zones[zone].control : nullptr;
+}
+
+// cppcheck-suppress unusedFunction
+int8_t IrrigationScheduler::getActiveZone() const {
+    return state == STATE_RUNNING ? activeZone : NO_ZONE;
+}
+
+// cppcheck-suppress unusedFunction
+uint8_t IrrigationScheduler::getQueuedZones() const {
+    return queueSize;
+}
+
+// cppcheck-suppress unusedFunction
+bool IrrigationScheduler::isBusy() const {
+    return state != STATE_IDLE || queueSize > 0;
+}
+
+bool IrrigationScheduler::hasNewRequests() const {
+    for (uint8_t i = 0; i < zoneCount; i++) {
+        if (!zones[i].queued && i != activeZone && zones[i].control->getRequestedDuration() > 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// cppcheck-suppress unusedFunction
+unsigned int IrrigationScheduler::getPumpStarts() const {
+    return pumpStarts;
+}
+
+// Water accounting
+// cppcheck-suppress unusedFunction
+float IrrigationScheduler::getZoneVolume(uint8_t zone) const {
+    return zone < zoneCount ? zones[zone].totalVolume : 0.0;
+}
+
+// cppcheck-suppress unusedFunction
+float IrrigationScheduler::getZoneDailyVolume(uint8_t zone) const {
+    return zone < zoneCount ? zones[zone].dailyVolume : 0.0;
+}
+
+// cppcheck-suppress unusedFunction
+unsigned int IrrigationScheduler::getZoneRunCount(uint8_t zone) const {
+    return zone < zoneCount ? zones[zone].runCount : 0;
+}
+
+// cppcheck-suppress unusedFunction
+float IrrigationScheduler::getTotalVolume() const {
+    float total = 0.0;
+    for (uint8_t i = 0; i < zoneCount; i++) {
+        total += zones[i].totalVolume;
+    }
+    return total;
+}
+
+// cppcheck-suppress unusedFunction
+void IrrigationScheduler::resetDailyVolumes() {
+    for (uint8_t i = 0; i < zoneCount; i++) {
+        zones[i].dailyVolume = 0.0;
+    }
+    Serial.println("[IrrigationScheduler] Daily volumes reset");
+}
+
+// cppcheck-suppress unusedFunction
+String IrrigationScheduler::getStatusString() const {
+    String status;
+    switch (state) {
+        case STATE_OPENING:  status = "OPENING " + zones[activeZone].name; break;
+        case STATE_RUNNING:  status = "WATERING " + zones[activeZone].name; break;
+        case STATE_DRAINING: status = "DRAINING"; break;
+        case STATE_RESTING:  status = "PUMP REST"; break;
+        default:             status = "IDLE"; break;
+    }
+    if (queueSize > 0) {
+        status += " (+" + String(queueSize) + " queued)";
+    }
+    for (uint8_t i = 0; i < zoneCount; i++) {
+        status += " | " + zones[i].name + ": " + String(zones[i].dailyVolume, 0) + "ml";
+    }
+    return status;
+}
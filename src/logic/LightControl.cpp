@@ -8,11 +8,7 @@ LightControl::LightControl() :
     currentLightHours(0),
     dayStartTime(0),
     currentPhotoperiod(0),
-    previousError(0.0),
-    errorIntegral(0.0),
-    kp(0.8),
-    ki(0.02),
-    kd(0.1),
+    pid(),
     minLux(500.0),
     maxLux(50000.0),
     maxLEDIntensity(100.0),
@@ -22,9 +18,11 @@ LightControl::LightControl() :
     artificialLightActive(false),
     photoperiodActive(true),
     isDaytime(true),
+    clockSynced(false),
     cloudinessDetection(true),
     naturalLightLevel(0.0),
     supplementalLightLevel(0.0),
+    ledIntensity(0.0),
     totalLightTime(0),
     dailyLightTime(0),
     adjustmentCount(0),
@@ -32,25 +30,34 @@ LightControl::LightControl() :
     morningSchedule({6, 0, 8, 0, 30.0, true}),
     daySchedule({8, 0, 18, 0, 80.0, true}),
     eveningSchedule({18, 0, 20, 0, 50.0, true}),
-    nightSchedule({20, 0, 6, 0, 0.0, false})
+    nightSchedule({20, 0, 6, 0, 0.0, false}),
+    scheduleTable()
 {
-    // Constructor body now empty of schedule initialization
+    // Rule order matches RULE_MORNING, RULE_DAY, RULE_EVENING
+    scheduleTable.addRule(morningSchedule.startHour, morningSchedule.startMinute,
+                          morningSchedule.endHour, morningSchedule.endMinute, morningSchedule.intensity);
+    scheduleTable.addRule(daySchedule.startHour, daySchedule.startMinute,
+                          daySchedule.endHour, daySchedule.endMinute, daySchedule.intensity);
+    scheduleTable.addRule(eveningSchedule.startHour, eveningSchedule.startMinute,
+                          eveningSchedule.endHour, eveningSchedule.endMinute, eveningSchedule.intensity);
 }
 
 bool LightControl::begin() {
     Serial.println("[LightControl] Initializing light control system");
     
+    // Set PID constants for light control (output % of LED PWM per lux)
+    // The sensor sees the LEDs at once, so the loop is almost static: mostly integral
+    pid.setGains(0.002,   // Low proportional gain (LED lux feed back immediately)
+                 0.0002,  // Integral gain: reaches the target in a few updates
+                 0.0);    // No derivative: clouds make lux readings noisy
+    pid.setOutputLimits(0.0, maxLEDIntensity);
+    pid.setDerivativeFilter(0.7); // Clouds make lux readings noisy
+    
     // Reset control variables
-    previousError = 0.0;
-    errorIntegral = 0.0;
+    pid.reset();
     lastUpdate = millis();
     dayStartTime = millis();
     
-    // Set PID constants for light control
-    kp = 0.8;  // Moderate proportional gain
-    ki = 0.02; // Low integral gain (lights respond quickly)
-    kd = 0.1;  // Low derivative gain
-    
     enabled = true;
     photoperiodActive = true;
     
@@ -62,87 +69,73 @@ bool LightControl::begin() {
 }
 
 // cppcheck-suppress unusedFunction
-void LightControl::update(float currentLux, uint8_t currentHour, uint8_t currentMinute) {
+void LightControl::update(float currentLux, uint8_t currentHour, uint8_t currentMinute, uint8_t currentWeekDay) {
     if (!enabled) return;
     
     unsigned long currentTime = millis();
-    float deltaTime = (currentTime - lastUpdate) / 1000.0;
+    unsigned long deltaTime = currentTime - lastUpdate; // ms
     
-    if (deltaTime <= 0) return;
+    if (deltaTime == 0) return;
     
     currentLightIntensity = currentLux;
+    clockSynced = currentHour < 24;
     naturalLightLevel = currentLux; // Assume current reading is natural light
     
     // Determine current schedule
-    LightSchedule currentSchedule = getCurrentSchedule(currentHour, currentMinute);
+    LightSchedule currentSchedule = getCurrentSchedule(currentWeekDay, currentHour, currentMinute);
     
-    // Calculate target based on schedule and natural light
+    // Calculate target based on schedule
     float scheduleTarget = (targetLightIntensity * currentSchedule.intensity) / 100.0;
-    float effectiveTarget = scheduleTarget;        // If we have natural light, reduce artificial light need
-        if (cloudinessDetection && naturalLightLevel > minLux) {
-            float naturalContribution = min(naturalLightLevel, scheduleTarget);
-            effectiveTarget = max(0.0f, scheduleTarget - naturalContribution);
-        }
-    
-    // Calculate error
-    float totalLightAvailable = naturalLightLevel + supplementalLightLevel;
-    float error = scheduleTarget - totalLightAvailable;
     
-    // Update integral
-    errorIntegral += error * deltaTime;
-    if (errorIntegral > 100.0) errorIntegral = 100.0;
-    if (errorIntegral < -100.0) errorIntegral = -100.0;
-    
-    // Calculate derivative
-    float derivative = (error - previousError) / deltaTime;
-    
-    // Calculate LED intensity needed (for future advanced control)
-    // float pidOutput = (kp * error) + (ki * errorIntegral) + (kd * derivative);
+    // LED intensity from the PID on the measured light (natural plus LEDs)
+    if (!currentSchedule.enabled) {
+        ledIntensity = 0.0;
+        pid.reset();
+    } else if (cloudinessDetection) {
+        pid.setSetpoint(scheduleTarget);
+        ledIntensity = pid.compute(currentLux, deltaTime);
+    } else {
+        // Without natural light compensation the LEDs follow the schedule
+        ledIntensity = min(currentSchedule.intensity, (float)maxLEDIntensity);
+    }
     
-    // Check if adjustment is allowed
+    // Switch the strip with hysteresis; the brightness follows the PID meanwhile
     bool adjustmentAllowed = (currentTime - lastAdjustment) >= MIN_ADJUST_INTERVAL;
-    
     bool wasActive = artificialLightActive;
-    artificialLightActive = false;
     
-    if (adjustmentAllowed && currentSchedule.enabled) {
-        if (error > tolerance && effectiveTarget > 0) {
+    if (adjustmentAllowed) {
+        if (!wasActive && ledIntensity >= LED_ON_LEVEL) {
             artificialLightActive = true;
-            supplementalLightLevel = min(effectiveTarget, (float)(maxLEDIntensity * targetLightIntensity / 100.0));
             lastAdjustment = currentTime;
-            
-            if (!wasActive) {
-                adjustmentCount++;
-                Serial.println(String("[LightControl] Artificial light activated. Target: ") + 
-                             scheduleTarget + " lux, Natural: " + naturalLightLevel + " lux");
-            }
-        } else if (error < -tolerance || effectiveTarget <= 0) {
-            supplementalLightLevel = 0.0;
-            if (wasActive) {
-                lastAdjustment = currentTime;
-                Serial.println("[LightControl] Artificial light deactivated - sufficient natural light");
-            }
+            adjustmentCount++;
+            Serial.println(String("[LightControl] Artificial light activated. Target: ") + 
+                         scheduleTarget + " lux, Measured: " + currentLux + " lux, LED: " + ledIntensity + "%");
+        } else if (wasActive && ledIntensity < LED_OFF_LEVEL) {
+            artificialLightActive = false;
+            lastAdjustment = currentTime;
+            Serial.println("[LightControl] Artificial light deactivated - sufficient natural light");
         }
     }
+    supplementalLightLevel = artificialLightActive ? ledIntensity * targetLightIntensity / 100.0 : 0.0;
     
     // Update photoperiod
     updatePhotoperiod();
     
     // Update energy consumption
     if (artificialLightActive) {
-        float powerConsumption = (supplementalLightLevel / targetLightIntensity) * 50.0; // 50W max LED strip
-        dailyEnergyConsumption += (powerConsumption * deltaTime) / 3600.0; // Wh
+        float powerConsumption = (ledIntensity / 100.0) * 50.0; // 50W max LED strip
+        dailyEnergyConsumption += (powerConsumption * (deltaTime / 1000.0)) / 3600.0; // Wh
     }
     
-    previousError = error;
     lastUpdate = currentTime;
 }
 
 // cppcheck-suppress unusedFunction
 void LightControl::setTarget(float targetLux) {
+    if (targetLux == targetLightIntensity) return;
+    
     if (targetLux >= minLux && targetLux <= maxLux) {
         targetLightIntensity = targetLux;
-        errorIntegral = 0.0;
         Serial.println(String("[LightControl] Target light intensity set to: ") + targetLux + " lux");
     }
 }
@@ -163,7 +156,7 @@ void LightControl::setPhotoperiod(unsigned int hours) {
 // cppcheck-suppress unusedFunction
 void LightControl::enable() {
     enabled = true;
-    errorIntegral = 0.0;
+    pid.reset();
     lastUpdate = millis();
     Serial.println("[LightControl] Enabled");
 }
@@ -173,6 +166,7 @@ void LightControl::disable() {
     enabled = false;
     artificialLightActive = false;
     supplementalLightLevel = 0.0;
+    ledIntensity = 0.0;
     Serial.println("[LightControl] Disabled");
 }
 
@@ -194,8 +188,22 @@ bool LightControl::isArtificialLightActive() const {
 float LightControl::getLEDIntensity() const {
     if (!artificialLightActive) return 0.0;
     
-    float intensity = (supplementalLightLevel / targetLightIntensity) * 100.0;
-    return min(intensity, (float)maxLEDIntensity);
+    return min(ledIntensity, (float)maxLEDIntensity);
+}
+
+// cppcheck-suppress unusedFunction
+float LightControl::getPIDOutput() const {
+    return enabled ? pid.getOutput() : 0.0;
+}
+
+// cppcheck-suppress unusedFunction
+float LightControl::getIntegralTerm() const {
+    return pid.getIntegralTerm();
+}
+
+// cppcheck-suppress unusedFunction
+void LightControl::restoreIntegralTerm(float integral) {
+    pid.reset(integral);
 }
 
 // cppcheck-suppress unusedFunction
@@ -221,23 +229,86 @@ bool LightControl::checkEmergency() const {
     return false;
 }
 
-LightControl::LightSchedule LightControl::getCurrentSchedule(uint8_t hour, uint8_t minute) const {
-    if (isTimeInSchedule(hour, minute, morningSchedule)) return morningSchedule;
-    if (isTimeInSchedule(hour, minute, daySchedule)) return daySchedule;
-    if (isTimeInSchedule(hour, minute, eveningSchedule)) return eveningSchedule;
-    return nightSchedule;
+LightControl::LightSchedule LightControl::getCurrentSchedule(uint8_t weekDay, uint8_t hour, uint8_t minute) const {
+    if (hour >= 24) return nightSchedule; // Sin hora: sin franja programada
+    
+    int8_t rule = scheduleTable.getActiveRule(weekDay, hour, minute);
+    if (rule == RULE_MORNING) return morningSchedule;
+    if (rule == RULE_DAY) return daySchedule;
+    if (rule == RULE_EVENING) return eveningSchedule;
+    if (rule == ScheduleTable::NO_RULE) return nightSchedule;
+    
+    const ScheduleTable::Rule& extra = scheduleTable.getRule(rule);
+    LightSchedule schedule = {
+        (uint8_t)(extra.startMinute / 60), (uint8_t)(extra.startMinute % 60),
+        (uint8_t)((extra.endMinute / 60) % 24), (uint8_t)(extra.endMinute % 60),
+        extra.value, true
+    };
+    return schedule;
 }
 
-bool LightControl::isTimeInSchedule(uint8_t hour, uint8_t minute, const LightSchedule& schedule) const {
-    int currentMinutes = hour * 60 + minute;
-    int startMinutes = schedule.startHour * 60 + schedule.startMinute;
-    int endMinutes = schedule.endHour * 60 + schedule.endMinute;
-    
-    if (endMinutes < startMinutes) { // Schedule crosses midnight
-        return (currentMinutes >= startMinutes) || (currentMinutes < endMinutes);
-    } else {
-        return (currentMinutes >= startMinutes) && (currentMinutes < endMinutes);
+void LightControl::compileSchedule(uint8_t rule, const LightSchedule& schedule) {
+    // A disabled window falls through to the next active rule or to night
+    scheduleTable.setRule(rule, schedule.startHour, schedule.startMinute,
+                          schedule.endHour, schedule.endMinute, schedule.intensity);
+    scheduleTable.setRuleEnabled(rule, schedule.enabled);
+}
+
+// cppcheck-suppress unusedFunction
+void LightControl::setSchedule(const LightSchedule& morning, const LightSchedule& day, 
+                               const LightSchedule& evening, const LightSchedule& night) {
+    morningSchedule = morning;
+    daySchedule = day;
+    eveningSchedule = evening;
+    nightSchedule = night;
+    compileSchedule(RULE_MORNING, morningSchedule);
+    compileSchedule(RULE_DAY, daySchedule);
+    compileSchedule(RULE_EVENING, eveningSchedule);
+}
+
+// cppcheck-suppress unusedFunction
+void LightControl::setMorningSchedule(uint8_t startH, uint8_t startM, uint8_t endH, uint8_t endM, float intensity) {
+    morningSchedule = {startH, startM, endH, endM, intensity, true};
+    compileSchedule(RULE_MORNING, morningSchedule);
+}
+
+// cppcheck-suppress unusedFunction
+void LightControl::setDaySchedule(uint8_t startH, uint8_t startM, uint8_t endH, uint8_t endM, float intensity) {
+    daySchedule = {startH, startM, endH, endM, intensity, true};
+    compileSchedule(RULE_DAY, daySchedule);
+}
+
+// cppcheck-suppress unusedFunction
+void LightControl::setEveningSchedule(uint8_t startH, uint8_t startM, uint8_t endH, uint8_t endM, float intensity) {
+    eveningSchedule = {startH, startM, endH, endM, intensity, true};
+    compileSchedule(RULE_EVENING, eveningSchedule);
+}
+
+// cppcheck-suppress unusedFunction
+void LightControl::setNightSchedule(uint8_t startH, uint8_t startM, uint8_t endH, uint8_t endM, float intensity) {
+    // Night is the fallback outside every window, its hours are informative
+    nightSchedule = {startH, startM, endH, endM, intensity, intensity > 0.0};
+}
+
+// cppcheck-suppress unusedFunction
+int8_t LightControl::addScheduleRule(uint8_t startH, uint8_t startM, uint8_t endH, uint8_t endM, float intensity,
+                                     uint8_t weekDays) {
+    int8_t rule = scheduleTable.addRule(startH, startM, endH, endM, intensity, weekDays);
+    if (rule != ScheduleTable::NO_RULE) {
+        Serial.println(String("[LightControl] Schedule rule ") + rule + " added: " + intensity + "%");
     }
+    return rule;
+}
+
+// cppcheck-suppress unusedFunction
+const ScheduleTable& LightControl::getScheduleTable() const {
+    return scheduleTable;
+}
+
+// cppcheck-suppress unusedFunction
+uint16_t LightControl::getMinutesToNextScheduleChange(uint8_t weekDay, uint8_t hour, uint8_t minute) const {
+    if (hour >= 24) return ScheduleTable::NO_CHANGE;
+    return scheduleTable.getMinutesToNextChange(weekDay, hour, minute);
 }
 
 void LightControl::updatePhotoperiod() {
@@ -245,17 +316,18 @@ void LightControl::updatePhotoperiod() {
     unsigned long elapsedTime = currentTime - dayStartTime;
     currentPhotoperiod = elapsedTime / (60 * 1000); // Convert to minutes
     
-    // Reset daily stats at midnight (approximately)
-    if (currentPhotoperiod > 24 * 60) {
+    // Without wall-clock time, reset daily stats every 24 h of uptime
+    // (with it, the day rollover event calls resetDailyStatistics)
+    if (!clockSynced && currentPhotoperiod > 24 * 60) {
         resetDailyStatistics();
-        dayStartTime = currentTime;
-        currentPhotoperiod = 0;
     }
 }
 
 void LightControl::resetDailyStatistics() {
     dailyLightTime = 0;
     dailyEnergyConsumption = 0.0;
+    dayStartTime = millis();
+    currentPhotoperiod = 0;
     Serial.println("[LightControl] Daily statistics reset");
 }
 
@@ -1,16 +1,35 @@
 #include "logic/LogicManager.h"
 #include "config/Targets.h"
+#include "config/config.h"
+
+namespace {
+
+// Log names of Metrics::ControlInput
+const char* const INPUT_NAMES[] = {"temperatura", "humedad", "luz", "suelo zona 1", "suelo zona 2"};
+static_assert(sizeof(INPUT_NAMES) / sizeof(INPUT_NAMES[0]) == Metrics::INPUT_COUNT,
+              "One name per Metrics::ControlInput");
+static_assert(Metrics::INPUT_SOIL_ZONE_1 + IRRIGATION_ZONE_COUNT == Metrics::INPUT_COUNT,
+              "One soil input per irrigation zone");
+
+} // namespace
 
 LogicManager::LogicManager() :
     temperatureControl(nullptr),
     humidityControl(nullptr),
     lightControl(nullptr),
-    irrigationControl(nullptr),
+    irrigationZones(),
+    irrigationScheduler(nullptr),
     ventilationControl(nullptr),
+    autotune(nullptr),
+    autotuneLoop(AUTOTUNE_NONE),
     sensorManager(nullptr),
     actuatorManager(nullptr),
     blynkManager(nullptr),
+    timeManager(nullptr),
+    settingsStore(nullptr),
     lastUpdate(0),
+    inputFault(),
+    inputFaultCount(),
     autoMode(false),
     systemEnabled(false)
 {
@@ -20,11 +39,16 @@ LogicManager::~LogicManager() {
     delete temperatureControl;
     delete humidityControl;
     delete lightControl;
-    delete irrigationControl;
+    delete irrigationScheduler;
+    for (uint8_t i = 0; i < IRRIGATION_ZONE_COUNT; i++) {
+        delete irrigationZones[i];
+    }
     delete ventilationControl;
+    delete autotune;
 }
 
-bool LogicManager::begin(SensorManager* sensors, ActuatorManager* actuators, BlynkManager* blynk) {
+bool LogicManager::begin(SensorManager* sensors, ActuatorManager* actuators, BlynkManager* blynk, TimeManager* clock,
+                         SettingsStore* settings) {
     if (!sensors || !actuators || !blynk) {
         Serial.println("[LogicManager] Error: Invalid pointers provided");
         return false;
@@ -33,19 +57,28 @@ bool LogicManager::begin(SensorManager* sensors, ActuatorManager* actuators, Bly
     sensorManager = sensors;
     actuatorManager = actuators;
     blynkManager = blynk;
+    timeManager = clock;
+    settingsStore = settings;
     
     // Initialize control modules
     temperatureControl = new TemperatureControl();
     humidityControl = new HumidityControl();
     lightControl = new LightControl();
-    irrigationControl = new IrrigationControl();
+    for (uint8_t i = 0; i < IRRIGATION_ZONE_COUNT; i++) {
+        irrigationZones[i] = new IrrigationControl();
+    }
+    irrigationScheduler = new IrrigationScheduler();
     ventilationControl = new VentilationControl();
+    autotune = new RelayAutotune();
     
     bool success = true;
     success &= temperatureControl->begin();
     success &= humidityControl->begin();
     success &= lightControl->begin();
-    success &= irrigationControl->begin();
+    for (uint8_t i = 0; i < IRRIGATION_ZONE_COUNT; i++) {
+        success &= irrigationZones[i]->begin();
+    }
+    success &= irrigationScheduler->begin(actuators->getWaterPump(), actuators->getValveRelays());
     success &= ventilationControl->begin();
     
     if (success) {
@@ -53,10 +86,19 @@ bool LogicManager::begin(SensorManager* sensors, ActuatorManager* actuators, Bly
         temperatureControl->setTarget(targets.temperature);
         humidityControl->setTarget(targets.humidity);
         lightControl->setTarget(targets.luxMin);
-        irrigationControl->setTarget(targets.soilMoisture);
+        // Zone valves, numbered from 1 like the relay pins in config.h
+        const uint8_t zoneRelays[IRRIGATION_ZONE_COUNT] = {IRRIGATION_ZONE_1_RELAY, IRRIGATION_ZONE_2_RELAY};
+        for (uint8_t i = 0; i < IRRIGATION_ZONE_COUNT; i++) {
+            irrigationZones[i]->setTarget(targets.soilMoisture);
+            irrigationScheduler->addZone(irrigationZones[i], zoneRelays[i] - 1, "Zona " + String(i + 1));
+        }
         // Configure ventilation thresholds from global struct
-        ventilationControl->setTemperatureThresholds(targets.ventTemp, targets.ventTemp + 3.0); // 3°C hysteresis
-        ventilationControl->setHumidityThresholds(targets.humidity, targets.humidity + 15.0); // 15% hysteresis
+        ventilationControl->setTemperatureThresholds(targets.ventTemp, targets.ventTemp + tuning.ventTempHysteresis,
+                                                     tuning.ventTempHysteresis);
+        ventilationControl->setHumidityThresholds(targets.humidity, targets.humidity + tuning.ventHumidityHysteresis,
+                                                  tuning.ventHumidityHysteresis);
+        // Replace default PID gains with autotuned ones loaded from flash
+        applyStoredTuning();
         Serial.println("[LogicManager] Initialized successfully");
         systemEnabled = true;
     } else {
@@ -68,8 +110,16 @@ bool LogicManager::begin(SensorManager* sensors, ActuatorManager* actuators, Bly
 void LogicManager::update() {
     unsigned long currentTime = millis();
     
+    // Valve and pump sequencing needs sub-second timing
+    if (systemEnabled) {
+        irrigationScheduler->update();
+    }
+    
     if (currentTime - lastUpdate >= UPDATE_INTERVAL) {
         if (systemEnabled) {
+            if (isAutotuning()) {
+                processAutotune();
+            }
             processLogic();
             sendStatusToBlynk();
         }
@@ -78,87 +128,114 @@ void LogicManager::update() {
     }
 }
 
+// cppcheck-suppress unusedFunction
+unsigned long LogicManager::getIdleTime() {
+    // Valve settle, overlap and drain steps are sub-second
+    if (systemEnabled && irrigationScheduler &&
+        (irrigationScheduler->isBusy() || irrigationScheduler->hasNewRequests())) {
+        return POWER_BUSY_POLL_INTERVAL;
+    }
+    unsigned long elapsed = millis() - lastUpdate;
+    return elapsed >= UPDATE_INTERVAL ? 0 : UPDATE_INTERVAL - elapsed;
+}
+
 void LogicManager::processLogic() {
     if (!autoMode || !systemEnabled) {
         return;
     }
     
-    // Check for emergency conditions first
-    if (checkAlerts()) {
-        handleEmergency();
-        return;
-    }
-    
     // Get current sensor readings
-    float temperature = 20.0; // Default fallback
-    float humidity = 50.0;
-    float lightLevel = 1000.0;
-    float soilMoisture = 50.0;
-    // TODO: Get actual sensor readings from SensorManager
-    // temperature = sensorManager->getTemperature();
-    // humidity = sensorManager->getHumidity();
-    // lightLevel = sensorManager->getLightLevel();
-    // soilMoisture = sensorManager->getSoilMoisture();
+    // A missing one holds the loop that depends on it, never a made-up value
+    float temperature = sensorManager->getTemperature();
+    float humidity = sensorManager->getHumidity();
+    float lightLevel = sensorManager->getLightLux();
+    // One probe per zone: zone 1 capacitive, zone 2 RS485; a zone never borrows another's probe
+    float zoneMoisture[IRRIGATION_ZONE_COUNT];
+    zoneMoisture[0] = sensorManager->getSoilMoisture();
+    if constexpr (IRRIGATION_ZONE_COUNT > 1) {
+        zoneMoisture[1] = sensorManager->getSoilMoistureRS485();
+    }
+    bool temperatureValid = checkInput(Metrics::INPUT_TEMPERATURE, temperature);
+    bool humidityValid = checkInput(Metrics::INPUT_HUMIDITY, humidity);
+    bool lightValid = checkInput(Metrics::INPUT_LIGHT, lightLevel);
+    for (uint8_t i = 0; i < IRRIGATION_ZONE_COUNT; i++) {
+        checkInput((Metrics::ControlInput)(Metrics::INPUT_SOIL_ZONE_1 + i), zoneMoisture[i]);
+    }
+
+    // Wall-clock time for the schedules (255 = unknown)
+    uint8_t hour = timeManager ? timeManager->getHour() : TimeManager::INVALID_TIME;
+    uint8_t minute = timeManager ? timeManager->getMinute() : TimeManager::INVALID_TIME;
+    uint8_t weekDay = timeManager ? timeManager->getWeekDay() : TimeManager::INVALID_TIME;
+    if (hour < 24) {
+        ventilationControl->setDaytimeStatus(hour >= TIME_DAY_START_HOUR && hour < TIME_DAY_END_HOUR);
+    }
 
     // --- Integrate global targets from Blynk ---
     temperatureControl->setTarget(targets.temperature);
     humidityControl->setTarget(targets.humidity);
     lightControl->setTarget(targets.luxMin);
-    irrigationControl->setTarget(targets.soilMoisture);
-    ventilationControl->setTemperatureThresholds(targets.ventTemp, targets.ventTemp + 3.0); // 3°C hysteresis
-    ventilationControl->setHumidityThresholds(targets.humidity, targets.humidity + 15.0); // 15% hysteresis
+    ventilationControl->setTemperatureThresholds(targets.ventTemp, targets.ventTemp + tuning.ventTempHysteresis,
+                                                 tuning.ventTempHysteresis);
+    ventilationControl->setHumidityThresholds(targets.humidity, targets.humidity + tuning.ventHumidityHysteresis,
+                                              tuning.ventHumidityHysteresis);
 
     // Update each control module
-    temperatureControl->update(temperature);
-    humidityControl->update(humidity, temperature);
-    lightControl->update(lightLevel);
-    irrigationControl->update(soilMoisture, temperature, humidity, lightLevel);
-    ventilationControl->update(temperature, humidity);
+    // The loop under autotune is frozen: the relay drives its actuator and the PID must not integrate
+    // A loop without its reading is frozen too; apply*() keeps its actuator in the safe state
+    if (temperatureValid && autotuneLoop != AUTOTUNE_TEMPERATURE) {
+        temperatureControl->update(temperature);
+    }
+    if (humidityValid && autotuneLoop != AUTOTUNE_HUMIDITY) {
+        humidityControl->update(humidity, temperatureValid ? temperature : -1);
+    }
+    if (lightValid) {
+        lightControl->update(lightLevel, hour, minute, weekDay);
+    }
+    // Zones only request water; IrrigationScheduler opens valves and runs the pump
+    // Climate inputs are optional there (-1 = unknown); the zone's own probe is not
+    for (uint8_t i = 0; i < IRRIGATION_ZONE_COUNT; i++) {
+        if (inputFault[Metrics::INPUT_SOIL_ZONE_1 + i]) {
+            irrigationZones[i]->cancelIrrigationRequest();
+            continue;
+        }
+        irrigationZones[i]->update(zoneMoisture[i], temperatureValid ? temperature : -1,
+                                   humidityValid ? humidity : -1, lightValid ? lightLevel : -1, hour, minute, weekDay);
+    }
+    // Ventilation keeps its level until both climate readings are back
+    if (temperatureValid && humidityValid) {
+        ventilationControl->update(temperature, humidity, -1, hour, minute);
+    }
+    
+    // Emergencies are judged on this cycle's readings, after every loop has seen them,
+    // and only add to the outputs: the actuators below are applied in every case
+    if (checkAlerts()) {
+        handleEmergency();
+    } else if (ventilationControl->isEmergencyActive()) {
+        ventilationControl->stopEmergencyVentilation();
+    }
     
     // Apply control decisions to actuators
-    applyTemperatureControl();
-    applyHumidityControl();
+    // While autotuning, the relay owns the heater/fan: climate loops stay off the actuators
+    if (!isAutotuning()) {
+        applyTemperatureControl();
+        applyVentilationControl();
+    }
     applyLightControl();
-    applyIrrigationControl();
-    applyVentilationControl();
 }
 
 void LogicManager::applyTemperatureControl() {
     if (!temperatureControl->isEnabled()) return;
     
-    bool heatingNeeded = temperatureControl->isHeatingActive();
-    bool coolingNeeded = temperatureControl->isCoolingActive();
-    
-    // Control real de calefactor
-    if (heatingNeeded) {
-        actuatorManager->getHeater()->turnOn();
-    } else {
-        actuatorManager->getHeater()->turnOff();
-    }
-    
-    // Control de ventilación para refrigeración
-    if (coolingNeeded) {
-        actuatorManager->getFan()->turnOn();
-        actuatorManager->getServo()->openVent();
-    }
-}
-
-void LogicManager::applyHumidityControl() {
-    if (!humidityControl->isEnabled()) return;
-    
-    bool humidifyingNeeded = humidityControl->isHumidifyingActive();
-    bool dehumidifyingNeeded = humidityControl->isDehumidifyingActive();
-    bool ventilationNeeded = humidityControl->isVentilationActive();
-    
-    // Control de deshumidificación mediante ventilación
-    if (dehumidifyingNeeded || ventilationNeeded) {
-        actuatorManager->getFan()->turnOn();
-        actuatorManager->getServo()->openVent();
-    }
-    
-    // Control de humidificación (si hay sistema de nebulización)
-    if (humidifyingNeeded) {
-        // Implementar cuando se agregue sistema de nebulización
+    // Control real de calefactor (salida proporcional en el tiempo del PID)
+    // Sin lectura de temperatura el calefactor queda apagado
+    bool heaterOn = !inputFault[Metrics::INPUT_TEMPERATURE] && temperatureControl->isHeaterOutputOn();
+    HeaterActuator* heater = actuatorManager->getHeater();
+    if (heaterOn != heater->isRunning()) {
+        if (heaterOn) {
+            heater->turnOn();
+        } else {
+            heater->turnOff();
+        }
     }
 }
 
@@ -166,66 +243,72 @@ void LogicManager::applyLightControl() {
     if (!lightControl->isEnabled()) return;
     
     float ledIntensity = lightControl->getLEDIntensity();
-    bool lightNeeded = lightControl->isArtificialLightActive();
+    // Sin lectura de luz los LEDs se apagan
+    bool lightNeeded = !inputFault[Metrics::INPUT_LIGHT] && lightControl->isArtificialLightActive();
     
-    // Control real de tira LED
+    // Control real de tira LED: el PWM sigue la salida del PID (0-100% -> 0-255)
+    LEDStripActuator* ledStrip = actuatorManager->getLEDStrip();
     if (lightNeeded) {
-        actuatorManager->getLEDStrip()->turnOn();
-        if (actuatorManager->getLEDStrip()->supportsBrightness()) {
-            actuatorManager->getLEDStrip()->setBrightness(ledIntensity);
+        if (ledStrip->supportsBrightness()) {
+            uint8_t brightness = (uint8_t)(constrain(ledIntensity, 0.0f, 100.0f) * 2.55f + 0.5f);
+            if (brightness != ledStrip->getBrightness()) {
+                ledStrip->setBrightness(brightness);
+            }
         }
-    } else {
-        actuatorManager->getLEDStrip()->turnOff();
-    }
-}
-
-void LogicManager::applyIrrigationControl() {
-    if (!irrigationControl->isEnabled()) return;
-    
-    bool irrigationNeeded = irrigationControl->needsIrrigation();
-    bool irrigationActive = irrigationControl->isIrrigationActive();
-    
-    // Control real de bomba de agua
-    if (irrigationNeeded && !irrigationActive) {
-        unsigned int duration = irrigationControl->calculateOptimalDuration();
-        actuatorManager->getWaterPump()->turnOn();
-        // Iniciar ciclo de riego sin el método inexistente
-        irrigationControl->startIrrigation();
-        Serial.println(String("[LogicManager] Iniciando riego por ") + duration + " segundos");
-    } else if (!irrigationNeeded && irrigationActive) {
-        actuatorManager->getWaterPump()->turnOff();
-        irrigationControl->stopIrrigation();
+        if (!ledStrip->isRunning()) {
+            ledStrip->turnOn();
+        }
+    } else if (ledStrip->isRunning()) {
+        ledStrip->turnOff();
     }
 }
 
 void LogicManager::applyVentilationControl() {
-    if (!ventilationControl->isEnabled()) return;
-    
-    uint8_t fanSpeed = ventilationControl->getFanSpeed();
-    uint8_t servoPosition = ventilationControl->getServoPosition();
-    bool damperOpen = ventilationControl->isDamperOpen();
-    
-    // Control real de ventilador y servo
-    if (fanSpeed > 0) {
-        actuatorManager->getFan()->turnOn();
-        // Si el ventilador soporta control de velocidad PWM
-        // actuatorManager->getFan()->setSpeed(fanSpeed);
-    } else {
-        actuatorManager->getFan()->turnOff();
+    // Único punto que mueve ventilador y trampilla: refrigeración, pulso de
+    // deshumidificación y nivel de ventilación piden aire y se suman aquí
+    // Sin la lectura de la que dependen, refrigeración y deshumidificación no piden nada
+    bool cooling = !inputFault[Metrics::INPUT_TEMPERATURE] && temperatureControl->isCoolingActive();
+    bool dehumidifying = !inputFault[Metrics::INPUT_HUMIDITY] && humidityControl->isFanOutputOn();
+    bool ventilating = ventilationControl->isEnabled() && ventilationControl->getFanSpeed() > 0;
+    // Humidificación: no hay nebulizador (HUMIDIFIER_INSTALLED); su relé seguiría getHumidifierDuty()
+    
+    // Ventilador: se conmuta solo cuando cambia la decisión
+    // (si el ventilador soporta PWM, seguiría getFanSpeed())
+    bool fanOn = cooling || dehumidifying || ventilating;
+    FanActuator* fan = actuatorManager->getFan();
+    if (fanOn != fan->isRunning()) {
+        if (fanOn) {
+            fan->turnOn();
+        } else {
+            fan->turnOff();
+        }
     }
     
-    // Control de posición del servo usando método correcto
-    if (servoPosition > 90) {
-        actuatorManager->getServo()->openVent();
-    } else if (servoPosition < 10) {
-        actuatorManager->getServo()->closeVent();
-    } else {
-        // Para posiciones intermedias, usar el método moveToPosition si existe
-        // actuatorManager->getServo()->moveToPosition(servoPosition);
-        Serial.println(String("[LogicManager] Posición servo: ") + servoPosition + "°");
+    // Trampilla del ventilador: abierta mientras alguien pida aire
+    // (las posiciones abierta/cerrada las fija ActuatorManager según el montaje)
+    bool ventOpen = cooling || dehumidifying || (ventilationControl->isEnabled() && ventilationControl->isDamperOpen());
+    ServoActuator* servo = actuatorManager->getServo();
+    if (ventOpen && !servo->isOpen()) {
+        servo->openVent();
+    } else if (!ventOpen && !servo->isClosed()) {
+        servo->closeVent();
     }
 }
 
+bool LogicManager::checkInput(Metrics::ControlInput input, float value) {
+    bool valid = !isnan(value);
+    if (!valid && !inputFault[input]) {
+        inputFaultCount[input]++;
+        Metrics::increment(Metrics::CONTROL_INPUT_FAULTS, input);
+        Serial.println(String("[LogicManager] Sin lectura de ") + INPUT_NAMES[input] +
+                       ": lazo en espera y salida en estado seguro (fallo " + inputFaultCount[input] + ")");
+    } else if (valid && inputFault[input]) {
+        Serial.println(String("[LogicManager] Lectura de ") + INPUT_NAMES[input] + " recuperada: lazo reanudado");
+    }
+    inputFault[input] = !valid;
+    return valid;
+}
+
 // Control modes
 // cppcheck-suppress unusedFunction
 void LogicManager::setAutoMode(bool enabled) {
@@ -276,9 +359,15 @@ void LogicManager::setLightTarget(float target) {
 
 // cppcheck-suppress unusedFunction
 void LogicManager::setSoilMoistureTarget(float target) {
-    if (irrigationControl) {
-        irrigationControl->setTarget(target);
-        Serial.println(String("[LogicManager] Soil moisture target set to: ") + target + "%");
+    for (uint8_t i = 0; i < IRRIGATION_ZONE_COUNT; i++) {
+        setZoneMoistureTarget(i, target);
+    }
+}
+
+void LogicManager::setZoneMoistureTarget(uint8_t zone, float target) {
+    if (zone < IRRIGATION_ZONE_COUNT && irrigationZones[zone]) {
+        irrigationZones[zone]->setTarget(target);
+        Serial.println(String("[LogicManager] Zone ") + (zone + 1) + " soil moisture target set to: " + target + "%");
     }
 }
 
@@ -300,7 +389,44 @@ float LogicManager::getLightTarget() const {
 
 // cppcheck-suppress unusedFunction
 float LogicManager::getSoilMoistureTarget() const {
-    return irrigationControl ? irrigationControl->getTarget() : 0.0;
+    return getZoneMoistureTarget(0);
+}
+
+// cppcheck-suppress unusedFunction
+float LogicManager::getZoneMoistureTarget(uint8_t zone) const {
+    return (zone < IRRIGATION_ZONE_COUNT && irrigationZones[zone]) ? irrigationZones[zone]->getTarget() : 0.0;
+}
+
+// cppcheck-suppress unusedFunction
+IrrigationScheduler* LogicManager::getIrrigationScheduler() {
+    return irrigationScheduler;
+}
+
+// cppcheck-suppress unusedFunction
+VentilationControl* LogicManager::getVentilationControl() {
+    return ventilationControl;
+}
+
+// cppcheck-suppress unusedFunction
+void LogicManager::saveState(StateSnapshot::State& state) const {
+    state.autoMode = autoMode;
+    if (temperatureControl) state.temperatureIntegral = temperatureControl->getIntegralTerm();
+    if (humidityControl) state.humidityIntegral = humidityControl->getIntegralTerm();
+    if (lightControl) state.lightIntegral = lightControl->getIntegralTerm();
+    for (uint8_t i = 0; i < IRRIGATION_ZONE_COUNT; i++) {
+        if (irrigationZones[i]) irrigationZones[i]->saveState(state.zones[i]);
+    }
+}
+
+// cppcheck-suppress unusedFunction
+void LogicManager::restoreState(const StateSnapshot::State& state) {
+    if (state.autoMode) setAutoMode(true);
+    if (temperatureControl) temperatureControl->restoreIntegralTerm(state.temperatureIntegral);
+    if (humidityControl) humidityControl->restoreIntegralTerm(state.humidityIntegral);
+    if (lightControl) lightControl->restoreIntegralTerm(state.lightIntegral);
+    for (uint8_t i = 0; i < IRRIGATION_ZONE_COUNT; i++) {
+        if (irrigationZones[i]) irrigationZones[i]->restoreState(state.zones[i]);
+    }
 }
 
 // Status
@@ -318,66 +444,84 @@ void LogicManager::getSystemStatus(String& status) {
     if (lightControl) {
         status += " | Light: " + lightControl->getStatusString();
     }
-    if (irrigationControl) {
-        status += " | Irrigation: " + irrigationControl->getStatusString();
+    for (uint8_t i = 0; i < IRRIGATION_ZONE_COUNT; i++) {
+        if (irrigationZones[i]) {
+            status += " | Irrigation " + String(i + 1) + ": " + irrigationZones[i]->getStatusString();
+        }
+    }
+    if (irrigationScheduler) {
+        status += " | Valves: " + irrigationScheduler->getStatusString();
     }
     if (ventilationControl) {
         status += " | Ventilation: " + ventilationControl->getStatusString();
     }
+    for (uint8_t i = 0; i < Metrics::INPUT_COUNT; i++) {
+        if (inputFaultCount[i] > 0) {
+            status += String(" | Fallos ") + INPUT_NAMES[i] + ": " + inputFaultCount[i] +
+                      (inputFault[i] ? " (SIN LECTURA)" : "");
+        }
+    }
 }
 
 void LogicManager::sendStatusToBlynk() {
     if (!blynkManager) return;
     
-    // Send current targets and status to Blynk virtual pins
-    // TODO: Implement specific virtual pin assignments
-    
-    // Example virtual pin assignments:
-    // V20 - Temperature target
-    // V21 - Humidity target  
-    // V22 - Light target
-    // V23 - Soil moisture target
-    // V24 - System enabled status
-    // V25 - Auto mode status
-    
-    blynkManager->sendVirtualPin(24, systemEnabled ? 1 : 0);
-    blynkManager->sendVirtualPin(25, autoMode ? 1 : 0);
+    // Targets applied by the controllers and system status (pins registered in BlynkTargets.h)
+    blynkManager->sendVirtualPin(BLYNK_VPIN_SYSTEM_ENABLED, systemEnabled ? 1 : 0);
+    blynkManager->sendVirtualPin(BLYNK_VPIN_AUTO_MODE, autoMode ? 1 : 0);
+    blynkManager->sendVirtualPin(BLYNK_VPIN_AUTOTUNE_STATUS, getAutotuneStatus());
     
     if (temperatureControl) {
-        blynkManager->sendVirtualPin(20, temperatureControl->getTarget());
+        blynkManager->sendVirtualPin(BLYNK_VPIN_STATUS_TARGET_TEMPERATURE, temperatureControl->getTarget());
     }
     if (humidityControl) {
-        blynkManager->sendVirtualPin(21, humidityControl->getTarget());
+        blynkManager->sendVirtualPin(BLYNK_VPIN_STATUS_TARGET_HUMIDITY, humidityControl->getTarget());
     }
     if (lightControl) {
-        blynkManager->sendVirtualPin(22, lightControl->getTarget());
+        blynkManager->sendVirtualPin(BLYNK_VPIN_STATUS_TARGET_LUX, lightControl->getTarget());
     }
-    if (irrigationControl) {
-        blynkManager->sendVirtualPin(23, irrigationControl->getTarget());
+    if (irrigationZones[0]) {
+        blynkManager->sendVirtualPin(BLYNK_VPIN_STATUS_TARGET_SOIL, irrigationZones[0]->getTarget());
     }
 }
 
+// Calendar
+void LogicManager::resetDailyStatistics() {
+    for (uint8_t i = 0; i < IRRIGATION_ZONE_COUNT; i++) {
+        if (irrigationZones[i]) irrigationZones[i]->resetDailyStatistics();
+    }
+    if (irrigationScheduler) irrigationScheduler->resetDailyVolumes();
+    if (lightControl) lightControl->resetDailyStatistics();
+    if (ventilationControl) ventilationControl->resetDailyStatistics();
+}
+
 // Emergency handling
 void LogicManager::handleEmergency() {
     Serial.println("[LogicManager] EMERGENCY: Taking protective actions");
     
-    // Check individual control emergencies
-    if (temperatureControl && temperatureControl->checkEmergency()) {
-        // Emergency cooling
-        ventilationControl->emergencyVentilation();
+    // Check individual control emergencies (a loop without its reading has none)
+    // Too hot: emergency cooling; too cold: the heater PID is already at full output
+    if (temperatureControl && !inputFault[Metrics::INPUT_TEMPERATURE] && temperatureControl->checkEmergency()) {
+        if (temperatureControl->getError() < 0) {
+            ventilationControl->emergencyVentilation();
+        }
         Serial.println("[LogicManager] Emergency temperature control activated");
     }
     
-    if (humidityControl && humidityControl->checkEmergency()) {
-        // Emergency dehumidification
-        ventilationControl->emergencyVentilation();
+    // Too humid: emergency dehumidification; outside air would only dry a too-dry greenhouse further
+    if (humidityControl && !inputFault[Metrics::INPUT_HUMIDITY] && humidityControl->checkEmergency()) {
+        if (humidityControl->getError() < 0) {
+            ventilationControl->emergencyVentilation();
+        }
         Serial.println("[LogicManager] Emergency humidity control activated");
     }
     
-    if (irrigationControl && irrigationControl->checkEmergency()) {
-        // Emergency irrigation
-        irrigationControl->emergencyIrrigation();
-        Serial.println("[LogicManager] Emergency irrigation activated");
+    for (uint8_t i = 0; i < IRRIGATION_ZONE_COUNT; i++) {
+        if (irrigationZones[i] && !inputFault[Metrics::INPUT_SOIL_ZONE_1 + i] && irrigationZones[i]->checkEmergency()) {
+            // Emergency irrigation (queued behind any zone already watering)
+            irrigationZones[i]->emergencyIrrigation();
+            Serial.println(String("[LogicManager] Emergency irrigation activated in zone ") + (i + 1));
+        }
     }
     
     if (ventilationControl && ventilationControl->checkEmergency()) {
@@ -390,16 +534,19 @@ void LogicManager::handleEmergency() {
 bool LogicManager::checkAlerts() {
     bool alertDetected = false;
     
-    if (temperatureControl && temperatureControl->checkEmergency()) {
+    // Controllers without a valid reading only hold their last value: no alert from them
+    if (temperatureControl && !inputFault[Metrics::INPUT_TEMPERATURE] && temperatureControl->checkEmergency()) {
         alertDetected = true;
     }
     
-    if (humidityControl && humidityControl->checkEmergency()) {
+    if (humidityControl && !inputFault[Metrics::INPUT_HUMIDITY] && humidityControl->checkEmergency()) {
         alertDetected = true;
     }
     
-    if (irrigationControl && irrigationControl->checkEmergency()) {
-        alertDetected = true;
+    for (uint8_t i = 0; i < IRRIGATION_ZONE_COUNT; i++) {
+        if (irrigationZones[i] && !inputFault[Metrics::INPUT_SOIL_ZONE_1 + i] && irrigationZones[i]->checkEmergency()) {
+            alertDetected = true;
+        }
     }
     
     if (ventilationControl && ventilationControl->checkEmergency()) {
@@ -408,3 +555,174 @@ bool LogicManager::checkAlerts() {
     
     return alertDetected;
 }
+
+// Sensor faults
+// cppcheck-suppress unusedFunction
+bool LogicManager::hasInputFault(Metrics::ControlInput input) const {
+    return input < Metrics::INPUT_COUNT && inputFault[input];
+}
+
+// cppcheck-suppress unusedFunction
+unsigned int LogicManager::getInputFaultCount(Metrics::ControlInput input) const {
+    return input < Metrics::INPUT_COUNT ? inputFaultCount[input] : 0;
+}
+
+// PID autotune (relay feedback)
+// cppcheck-suppress unusedFunction
+bool LogicManager::startAutotune(AutotuneLoop loop) {
+    if (!autotune || !systemEnabled || loop == AUTOTUNE_NONE) {
+        return false;
+    }
+    if (isAutotuning()) {
+        Serial.println("[LogicManager] Autotune already running");
+        return false;
+    }
+    
+    float measurement;
+    float target;
+    if (loop == AUTOTUNE_TEMPERATURE) {
+        measurement = sensorManager->getTemperature();
+        target = targets.temperature;
+        // Heater relay: full duty / off, in heater PID units (%)
+        autotune->setOutputs(100.0, 0.0);
+        autotune->setHysteresis(AUTOTUNE_TEMP_HYSTERESIS);
+        autotune->setMeasurementLimits(5.0, 40.0);
+    } else {
+        measurement = sensorManager->getHumidity();
+        target = targets.humidity;
+        // Fan relay: off (0) / full dehumidification (-100), in humidity PID units
+        autotune->setOutputs(0.0, -100.0);
+        autotune->setHysteresis(AUTOTUNE_HUMIDITY_HYSTERESIS);
+        autotune->setMeasurementLimits(20.0, 95.0);
+    }
+    
+    if (isnan(measurement)) {
+        Serial.println("[LogicManager] Autotune not started: no valid sensor reading");
+        return false;
+    }
+    
+    autotune->setCycles(AUTOTUNE_CYCLES);
+    autotune->setTimeout(AUTOTUNE_TIMEOUT);
+    autotune->start(target, measurement);
+    autotuneLoop = loop;
+    applyAutotuneOutput(autotune->isOutputHigh());
+    
+    Serial.println(String("[LogicManager] Autotune started for ") +
+                  (loop == AUTOTUNE_TEMPERATURE ? "temperature" : "humidity"));
+    return true;
+}
+
+// cppcheck-suppress unusedFunction
+void LogicManager::cancelAutotune() {
+    if (!isAutotuning()) return;
+    
+    autotune->cancel();
+    finishAutotune();
+}
+
+bool LogicManager::isAutotuning() const {
+    return autotune && autotune->isRunning() && autotuneLoop != AUTOTUNE_NONE;
+}
+
+String LogicManager::getAutotuneStatus() const {
+    return autotune ? autotune->getStatusString() : String("IDLE");
+}
+
+void LogicManager::processAutotune() {
+    float measurement = (autotuneLoop == AUTOTUNE_TEMPERATURE) ?
+        sensorManager->getTemperature() : sensorManager->getHumidity();
+    
+    autotune->update(measurement, millis());
+    
+    if (autotune->isRunning()) {
+        applyAutotuneOutput(autotune->isOutputHigh());
+    } else {
+        finishAutotune();
+    }
+}
+
+void LogicManager::applyAutotuneOutput(bool relayHigh) {
+    if (autotuneLoop == AUTOTUNE_TEMPERATURE) {
+        HeaterActuator* heater = actuatorManager->getHeater();
+        if (relayHigh != heater->isRunning()) {
+            if (relayHigh) {
+                heater->turnOn();
+            } else {
+                heater->turnOff();
+            }
+        }
+    } else if (autotuneLoop == AUTOTUNE_HUMIDITY) {
+        // Relay low = fan on (dehumidify)
+        bool fanOn = !relayHigh;
+        FanActuator* fan = actuatorManager->getFan();
+        if (fanOn != fan->isRunning()) {
+            if (fanOn) {
+                fan->turnOn();
+            } else {
+                fan->turnOff();
+            }
+        }
+    }
+}
+
+void LogicManager::finishAutotune() {
+    AutotuneLoop loop = autotuneLoop;
+    autotuneLoop = AUTOTUNE_NONE;
+    
+    // Release the actuator; the loop restarts from zero output on the next cycle
+    if (loop == AUTOTUNE_TEMPERATURE) {
+        actuatorManager->getHeater()->turnOff();
+        temperatureControl->resetControl();
+    } else if (loop == AUTOTUNE_HUMIDITY) {
+        actuatorManager->getFan()->turnOff();
+        humidityControl->resetControl();
+    }
+    
+    float kp, ki, kd;
+    if (!autotune->getGains(kp, ki, kd)) {
+        Serial.println("[LogicManager] Autotune finished without new gains: " + autotune->getStatusString());
+        return;
+    }
+    
+    if (loop == AUTOTUNE_TEMPERATURE) {
+        temperatureControl->setPIDConstants(kp, ki, kd);
+    } else if (loop == AUTOTUNE_HUMIDITY) {
+        humidityControl->setControlConstants(kp, ki, kd);
+    }
+    saveTunedGains(loop, kp, ki, kd);
+}
+
+void LogicManager::applyStoredTuning() {
+    // Gains come from SettingsStore, loaded before the controllers start
+    if (tuning.hasTemperatureGains()) {
+        temperatureControl->setPIDConstants(tuning.temperatureKp, tuning.temperatureKi, tuning.temperatureKd);
+        Serial.println("[LogicManager] Loaded autotuned temperature gains");
+    }
+    if (tuning.hasHumidityGains()) {
+        humidityControl->setControlConstants(tuning.humidityKp, tuning.humidityKi, tuning.humidityKd);
+        Serial.println("[LogicManager] Loaded autotuned humidity gains");
+    }
+}
+
+void LogicManager::saveTunedGains(AutotuneLoop loop, float kp, float ki, float kd) {
+    if (loop == AUTOTUNE_TEMPERATURE) {
+        tuning.temperatureKp = kp;
+        tuning.temperatureKi = ki;
+        tuning.temperatureKd = kd;
+    } else if (loop == AUTOTUNE_HUMIDITY) {
+        tuning.humidityKp = kp;
+        tuning.humidityKi = ki;
+        tuning.humidityKd = kd;
+    }
+    
+    if (!settingsStore) {
+        Serial.println("[LogicManager] Warning: No settings store, tuned gains will not survive a reboot");
+        return;
+    }
+    // Rare and valuable: write now instead of waiting for the coalescing delay
+    settingsStore->markDirty();
+    settingsStore->flush();
+    
+    const char* prefix = (loop == AUTOTUNE_TEMPERATURE) ? "temp" : "hum";
+    Serial.println(String("[LogicManager] Tuned ") + prefix + " gains saved - Kp:" + kp + " Ki:" + ki + " Kd:" + kd);
+}
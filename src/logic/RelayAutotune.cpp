@@ -0,0 +1,284 @@
+#include "logic/RelayAutotune.h"
+
+RelayAutotune::RelayAutotune() :
+    setpoint(0.0),
+    outputHigh(100.0),
+    outputLow(0.0),
+    hysteresis(0.2),
+    minMeasurement(-1000.0),
+    maxMeasurement(1000.0),
+    requiredCycles(3),
+    timeout(4UL * 3600000UL),
+    state(STATE_IDLE),
+    relayHigh(false),
+    startTime(0),
+    lastRiseTime(0),
+    peakMax(0.0),
+    peakMin(0.0),
+    cycleCount(0),
+    amplitudes(),
+    periods(),
+    ultimateGain(0.0),
+    ultimatePeriod(0.0),
+    failReason("")
+{
+}
+
+// Configuration
+// cppcheck-suppress unusedFunction
+void RelayAutotune::setOutputs(float high, float low) {
+    if (high > low) {
+        outputHigh = high;
+        outputLow = low;
+    }
+}
+
+// cppcheck-suppress unusedFunction
+void RelayAutotune::setHysteresis(float hyst) {
+    if (hyst >= 0.0) {
+        hysteresis = hyst;
+    }
+}
+
+// cppcheck-suppress unusedFunction
+void RelayAutotune::setMeasurementLimits(float minValue, float maxValue) {
+    if (minValue < maxValue) {
+        minMeasurement = minValue;
+        maxMeasurement = maxValue;
+    }
+}
+
+// cppcheck-suppress unusedFunction
+void RelayAutotune::setCycles(uint8_t cycles) {
+    // One extra cycle is always discarded as transient
+    requiredCycles = constrain(cycles, (uint8_t)2, (uint8_t)(MAX_CYCLES - 1));
+}
+
+// cppcheck-suppress unusedFunction
+void RelayAutotune::setTimeout(unsigned long timeoutMs) {
+    if (timeoutMs > 0) {
+        timeout = timeoutMs;
+    }
+}
+
+// Control
+// cppcheck-suppress unusedFunction
+void RelayAutotune::start(float target, float currentMeasurement) {
+    setpoint = target;
+    startTime = millis();
+    lastRiseTime = 0;
+    cycleCount = 0;
+    ultimateGain = 0.0;
+    ultimatePeriod = 0.0;
+    failReason = "";
+
+    // Start pushing the process towards the target
+    relayHigh = (currentMeasurement < setpoint);
+    peakMax = currentMeasurement;
+    peakMin = currentMeasurement;
+    state = STATE_RUNNING;
+
+    Serial.println(String("[RelayAutotune] Started. Target: ") + setpoint + ", Relay: " + outputLow + "/" + outputHigh +
+                  ", Hysteresis: ±" + hysteresis);
+}
+
+// cppcheck-suppress unusedFunction
+void RelayAutotune::cancel() {
+    if (state == STATE_RUNNING) {
+        state = STATE_IDLE;
+        relayHigh = false;
+        Serial.println("[RelayAutotune] Cancelled");
+    }
+}
+
+float RelayAutotune::update(float measurement, unsigned long currentTime) {
+    if (state != STATE_RUNNING) {
+        return outputLow;
+    }
+
+    // Skip invalid readings, keep the relay where it is
+    if (isnan(measurement)) {
+        return getOutput();
+    }
+
+    if (measurement < minMeasurement || measurement > maxMeasurement) {
+        fail("measurement out of safe range");
+        return outputLow;
+    }
+
+    if (currentTime - startTime > timeout) {
+        fail("timeout without stable oscillation");
+        return outputLow;
+    }
+
+    if (measurement > peakMax) peakMax = measurement;
+    if (measurement < peakMin) peakMin = measurement;
+
+    if (relayHigh && measurement > setpoint + hysteresis) {
+        relayHigh = false;
+    } else if (!relayHigh && measurement < setpoint - hysteresis) {
+        relayHigh = true;
+
+        // A low->high switch closes one full oscillation cycle
+        if (lastRiseTime != 0) {
+            if (cycleCount < MAX_CYCLES) {
+                amplitudes[cycleCount] = (peakMax - peakMin) / 2.0;
+                periods[cycleCount] = (currentTime - lastRiseTime) / 1000.0;
+                cycleCount++;
+                Serial.println(String("[RelayAutotune] Cycle ") + cycleCount + ": amplitude ±" +
+                             amplitudes[cycleCount - 1] + ", period " + periods[cycleCount - 1] + "s");
+            }
+
+            // The first cycle still carries the start-up transient and is never averaged
+            if (cycleCount > requiredCycles && cyclesConverged()) {
+                finish();
+                return outputLow;
+            }
+            if (cycleCount >= MAX_CYCLES) {
+                fail("oscillation did not settle");
+                return outputLow;
+            }
+        }
+
+        lastRiseTime = currentTime;
+        peakMax = measurement;
+        peakMin = measurement;
+    }
+
+    return getOutput();
+}
+
+bool RelayAutotune::cyclesConverged() const {
+    // The last requiredCycles cycles must agree within 10% in amplitude and period
+    uint8_t first = cycleCount - requiredCycles;
+    float ampMean = 0.0, periodMean = 0.0;
+    for (uint8_t i = first; i < cycleCount; i++) {
+        ampMean += amplitudes[i];
+        periodMean += periods[i];
+    }
+    ampMean /= requiredCycles;
+    periodMean /= requiredCycles;
+
+    for (uint8_t i = first; i < cycleCount; i++) {
+        if (abs(amplitudes[i] - ampMean) > 0.1 * ampMean) return false;
+        if (abs(periods[i] - periodMean) > 0.1 * periodMean) return false;
+    }
+    return true;
+}
+
+void RelayAutotune::finish() {
+    uint8_t first = cycleCount - requiredCycles;
+    float amplitude = 0.0;
+    float period = 0.0;
+    for (uint8_t i = first; i < cycleCount; i++) {
+        amplitude += amplitudes[i];
+        period += periods[i];
+    }
+    amplitude /= requiredCycles;
+    period /= requiredCycles;
+
+    if (amplitude <= hysteresis || period <= 0.0) {
+        fail("oscillation too small for the hysteresis");
+        return;
+    }
+
+    // Describing-function estimate, corrected for the relay hysteresis
+    float relayAmplitude = (outputHigh - outputLow) / 2.0;
+    ultimateGain = (4.0 * relayAmplitude) / (PI * sqrt(amplitude * amplitude - hysteresis * hysteresis));
+    ultimatePeriod = period;
+    relayHigh = false;
+    state = STATE_DONE;
+
+    Serial.println(String("[RelayAutotune] Done. Ku: ") + ultimateGain + ", Tu: " + ultimatePeriod + "s");
+}
+
+void RelayAutotune::fail(const char* reason) {
+    state = STATE_FAILED;
+    relayHigh = false;
+    failReason = reason;
+    Serial.println(String("[RelayAutotune] Failed: ") + reason);
+}
+
+// Status
+// cppcheck-suppress unusedFunction
+RelayAutotune::State RelayAutotune::getState() const {
+    return state;
+}
+
+bool RelayAutotune::isRunning() const {
+    return state == STATE_RUNNING;
+}
+
+// cppcheck-suppress unusedFunction
+bool RelayAutotune::isDone() const {
+    return state == STATE_DONE;
+}
+
+// cppcheck-suppress unusedFunction
+bool RelayAutotune::hasFailed() const {
+    return state == STATE_FAILED;
+}
+
+// cppcheck-suppress unusedFunction
+bool RelayAutotune::isOutputHigh() const {
+    return state == STATE_RUNNING && relayHigh;
+}
+
+float RelayAutotune::getOutput() const {
+    return isOutputHigh() ? outputHigh : outputLow;
+}
+
+// cppcheck-suppress unusedFunction
+uint8_t RelayAutotune::getCycleCount() const {
+    return cycleCount;
+}
+
+// cppcheck-suppress unusedFunction
+String RelayAutotune::getFailReason() const {
+    return failReason;
+}
+
+// cppcheck-suppress unusedFunction
+String RelayAutotune::getStatusString() const {
+    switch (state) {
+        case STATE_RUNNING:
+            return String("RUNNING (cycle ") + cycleCount + ", relay " + (relayHigh ? "HIGH" : "LOW") + ")";
+        case STATE_DONE:
+            return String("DONE (Ku: ") + String(ultimateGain, 2) + ", Tu: " + String(ultimatePeriod, 0) + "s)";
+        case STATE_FAILED:
+            return "FAILED (" + failReason + ")";
+        default:
+            return "IDLE";
+    }
+}
+
+// Results
+// cppcheck-suppress unusedFunction
+float RelayAutotune::getUltimateGain() const {
+    return ultimateGain;
+}
+
+// cppcheck-suppress unusedFunction
+float RelayAutotune::getUltimatePeriod() const {
+    return ultimatePeriod;
+}
+
+// cppcheck-suppress unusedFunction
+bool RelayAutotune::getGains(float& kp, float& ki, float& kd, TuningRule rule) const {
+    if (state != STATE_DONE) return false;
+
+    // Parallel form used by PIDController: ki = Kp/Ti, kd = Kp·Td
+    float ti, td;
+    if (rule == RULE_ZIEGLER_NICHOLS) {
+        kp = 0.6 * ultimateGain;
+        ti = ultimatePeriod / 2.0;
+        td = ultimatePeriod / 8.0;
+    } else {
+        kp = ultimateGain / 2.2;
+        ti = 2.2 * ultimatePeriod;
+        td = ultimatePeriod / 6.3;
+    }
+    ki = kp / ti;
+    kd = kp * td;
+    return true;
+}
@@ -0,0 +1,226 @@
+#include "logic/ScheduleTable.h"
+
+ScheduleTable::ScheduleTable() :
+    rules(),
+    ruleCount(0),
+    transitions(),
+    transitionCount(0)
+{
+}
+
+int8_t ScheduleTable::addRule(uint8_t startHour, uint8_t startMinute, uint8_t endHour, uint8_t endMinute,
+                              float value, uint8_t weekDays) {
+    if (ruleCount >= MAX_RULES) {
+        Serial.println("[ScheduleTable] Error: Rule table full");
+        return NO_RULE;
+    }
+
+    uint8_t index = ruleCount;
+    ruleCount++;
+    if (!setRule(index, startHour, startMinute, endHour, endMinute, value, weekDays)) {
+        ruleCount--;
+        return NO_RULE;
+    }
+    return index;
+}
+
+bool ScheduleTable::setRule(uint8_t index, uint8_t startHour, uint8_t startMinute, uint8_t endHour, uint8_t endMinute,
+                            float value, uint8_t weekDays) {
+    if (index >= ruleCount) {
+        return false;
+    }
+
+    uint16_t start = startHour * 60 + startMinute;
+    uint16_t end = endHour * 60 + endMinute;
+
+    // 24:00 is allowed as an end time; an empty window is not
+    if (start >= MINUTES_PER_DAY || end > MINUTES_PER_DAY || end == start || (weekDays & ALL_DAYS) == 0) {
+        Serial.println("[ScheduleTable] Error: Invalid rule window");
+        return false;
+    }
+
+    Rule& rule = rules[index];
+    rule.startMinute = start;
+    rule.endMinute = end;
+    rule.weekDays = weekDays & ALL_DAYS;
+    rule.value = value;
+    rule.enabled = true;
+
+    compile();
+    return true;
+}
+
+bool ScheduleTable::setRuleEnabled(uint8_t index, bool enabled) {
+    if (index >= ruleCount) {
+        return false;
+    }
+    if (rules[index].enabled != enabled) {
+        rules[index].enabled = enabled;
+        compile();
+    }
+    return true;
+}
+
+void ScheduleTable::clear() {
+    ruleCount = 0;
+    transitionCount = 0;
+}
+
+// cppcheck-suppress unusedFunction
+uint8_t ScheduleTable::getRuleCount() const {
+    return ruleCount;
+}
+
+const ScheduleTable::Rule& ScheduleTable::getRule(uint8_t index) const {
+    return rules[index < ruleCount ? index : 0];
+}
+
+void ScheduleTable::compile() {
+    // Sort key: week minute, then off before on (a window ending where the
+    // next one starts leaves the rule active), then rule index
+    uint32_t keys[MAX_TRANSITIONS];
+    uint16_t count = 0;
+
+    for (uint8_t r = 0; r < ruleCount; r++) {
+        const Rule& rule = rules[r];
+        if (!rule.enabled) {
+            continue;
+        }
+
+        // Windows that cross midnight end on the following day
+        uint16_t duration = rule.endMinute > rule.startMinute
+            ? rule.endMinute - rule.startMinute
+            : rule.endMinute + MINUTES_PER_DAY - rule.startMinute;
+
+        for (uint8_t day = 0; day < 7; day++) {
+            if (!(rule.weekDays & (1 << day))) {
+                continue;
+            }
+            uint16_t on = day * MINUTES_PER_DAY + rule.startMinute;
+            uint16_t off = (on + duration) % MINUTES_PER_WEEK;
+            keys[count++] = ((uint32_t)on << 6) | (1 << 5) | r;
+            keys[count++] = ((uint32_t)off << 6) | r;
+        }
+    }
+
+    // Insertion sort: a few dozen entries, only on configuration changes
+    for (uint16_t i = 1; i < count; i++) {
+        uint32_t key = keys[i];
+        int16_t j = i - 1;
+        while (j >= 0 && keys[j] > key) {
+            keys[j + 1] = keys[j];
+            j--;
+        }
+        keys[j + 1] = key;
+    }
+
+    // The rules still active at the end of the week are the ones active at
+    // Sunday 00:00, so a first pass gives the starting mask
+    uint16_t mask = 0;
+    for (uint16_t i = 0; i < count; i++) {
+        uint16_t bit = 1 << (keys[i] & 0x1F);
+        mask = (keys[i] & (1 << 5)) ? (mask | bit) : (mask & ~bit);
+    }
+
+    // Second pass: one entry per minute with the rules active after it
+    uint16_t startMask = mask;
+    transitionCount = 0;
+    for (uint16_t i = 0; i < count; i++) {
+        uint16_t weekMinute = keys[i] >> 6;
+        uint16_t bit = 1 << (keys[i] & 0x1F);
+        mask = (keys[i] & (1 << 5)) ? (mask | bit) : (mask & ~bit);
+
+        if (transitionCount > 0 && transitions[transitionCount - 1].weekMinute == weekMinute) {
+            transitions[transitionCount - 1].activeMask = mask;
+        } else {
+            transitions[transitionCount].weekMinute = weekMinute;
+            transitions[transitionCount].activeMask = mask;
+            transitionCount++;
+        }
+    }
+
+    // Drop the entries that leave the active set unchanged (back-to-back
+    // windows, whole-day rules...) so every entry is a real change
+    uint16_t previous = startMask;
+    uint16_t kept = 0;
+    for (uint16_t i = 0; i < transitionCount; i++) {
+        if (transitions[i].activeMask != previous) {
+            previous = transitions[i].activeMask;
+            transitions[kept++] = transitions[i];
+        }
+    }
+    transitionCount = kept;
+
+    // Nothing ever changes: keep the mask without any change point
+    if (transitionCount == 0 && startMask != 0) {
+        transitions[0].weekMinute = 0;
+        transitions[0].activeMask = startMask;
+        transitionCount = 1;
+    }
+}
+
+uint16_t ScheduleTable::toWeekMinute(uint8_t weekDay, uint8_t hour, uint8_t minute) {
+    if (weekDay > 6) {
+        weekDay = 0;
+    }
+    return weekDay * MINUTES_PER_DAY + hour * 60 + minute;
+}
+
+int16_t ScheduleTable::findTransition(uint16_t weekMinute) const {
+    if (transitionCount == 0) {
+        return -1;
+    }
+
+    // Last transition at or before weekMinute; before the first one the
+    // state is the one left by the last transition of the previous week
+    int16_t low = 0;
+    int16_t high = transitionCount - 1;
+    int16_t found = transitionCount - 1;
+    while (low <= high) {
+        int16_t mid = (low + high) / 2;
+        if (transitions[mid].weekMinute <= weekMinute) {
+            found = mid;
+            low = mid + 1;
+        } else {
+            high = mid - 1;
+        }
+    }
+    return found;
+}
+
+uint16_t ScheduleTable::getActiveMask(uint8_t weekDay, uint8_t hour, uint8_t minute) const {
+    int16_t index = findTransition(toWeekMinute(weekDay, hour, minute));
+    return index < 0 ? 0 : transitions[index].activeMask;
+}
+
+int8_t ScheduleTable::getActiveRule(uint8_t weekDay, uint8_t hour, uint8_t minute) const {
+    uint16_t mask = getActiveMask(weekDay, hour, minute);
+    for (uint8_t r = 0; r < ruleCount; r++) {
+        if (mask & (1 << r)) {
+            return r;
+        }
+    }
+    return NO_RULE;
+}
+
+// cppcheck-suppress unusedFunction
+float ScheduleTable::getActiveValue(uint8_t weekDay, uint8_t hour, uint8_t minute, float defaultValue) const {
+    int8_t rule = getActiveRule(weekDay, hour, minute);
+    return rule == NO_RULE ? defaultValue : rules[rule].value;
+}
+
+// cppcheck-suppress unusedFunction
+bool ScheduleTable::isActive(uint8_t index, uint8_t weekDay, uint8_t hour, uint8_t minute) const {
+    return index < ruleCount && (getActiveMask(weekDay, hour, minute) & (1 << index));
+}
+
+uint16_t ScheduleTable::getMinutesToNextChange(uint8_t weekDay, uint8_t hour, uint8_t minute) const {
+    if (transitionCount < 2) {
+        return NO_CHANGE;
+    }
+
+    uint16_t now = toWeekMinute(weekDay, hour, minute);
+    int16_t index = findTransition(now);
+    const Transition& next = transitions[(index + 1) % transitionCount];
+    return (next.weekMinute + MINUTES_PER_WEEK - now) % MINUTES_PER_WEEK;
+}
@@ -1,20 +1,22 @@
 #include "logic/TemperatureControl.h"
+#include "config/config.h"
 
 TemperatureControl::TemperatureControl() :
     targetTemperature(22.0),
     currentTemperature(20.0),
     tolerance(1.0),
-    previousError(0.0),
-    integral(0.0),
-    derivative(0.0),
-    kp(2.0),
-    ki(0.1),
-    kd(0.5),
+    coolingHysteresis(FAN_COOLING_HYSTERESIS),
+    pid(),
     minTemp(10.0),
     maxTemp(35.0),
-    maxIntegral(100.0),
     lastUpdate(0),
-    deltaTime(0.0),
+    heaterWindowSize(HEATER_CYCLE_ON_TIME),
+    heaterMinSwitchTime(HEATER_MIN_HEATING_TIME),
+    heaterWindowStart(0),
+    heaterOnTime(0),
+    heaterDuty(0.0),
+    heaterOutput(false),
+    heaterPulseDone(false),
     enabled(false),
     heatingActive(false),
     coolingActive(false),
@@ -27,23 +29,33 @@ TemperatureControl::TemperatureControl() :
 bool TemperatureControl::begin() {
     Serial.println("[TemperatureControl] Initializing temperature control system");
     
+    // Set default PID constants optimized for greenhouse temperature control
+    // Based on thermal mass and response characteristics
+    pid.setGains(HEATER_PID_KP,   // Proportional gain
+                 HEATER_PID_KI,   // Integral gain (slow to prevent overshoot)
+                 HEATER_PID_KD);  // Derivative gain (moderate for stability)
+    pid.setOutputLimits(0.0, 100.0); // Heater duty cycle
+    pid.setDerivativeFilter(0.5); // Smooth DHT22 quantization steps
+    pid.setSetpoint(targetTemperature);
+    
     // Reset PID variables
-    previousError = 0.0;
-    integral = 0.0;
-    derivative = 0.0;
+    pid.reset();
     lastUpdate = millis();
     
-    // Set default PID constants optimized for greenhouse temperature control
-    // Based on thermal mass and response characteristics
-    kp = 2.0;  // Proportional gain
-    ki = 0.1;  // Integral gain (slow to prevent overshoot)
-    kd = 0.5;  // Derivative gain (moderate for stability)
+    // Start a fresh time-proportioning window with the heater off
+    heaterWindowStart = lastUpdate;
+    heaterOnTime = 0;
+    heaterDuty = 0.0;
+    heaterOutput = false;
+    heaterPulseDone = false;
     
     enabled = true;
     
     Serial.println("[TemperatureControl] Initialized successfully");
     Serial.println(String("[TemperatureControl] Target: ") + targetTemperature + "°C, Tolerance: ±" + tolerance + "°C");
-    Serial.println(String("[TemperatureControl] PID Constants - Kp:") + kp + " Ki:" + ki + " Kd:" + kd);
+    Serial.println(String("[TemperatureControl] PID Constants - Kp:") + pid.getKp() + " Ki:" + pid.getKi() + " Kd:" + pid.getKd());
+    Serial.println(String("[TemperatureControl] Heater window: ") + (heaterWindowSize / 1000) + "s, Min switch: " + 
+                  (heaterMinSwitchTime / 1000) + "s");
     
     return true;
 }
@@ -53,71 +65,61 @@ void TemperatureControl::update(float currentTemp) {
     if (!enabled) return;
     
     unsigned long currentTime = millis();
-    deltaTime = (currentTime - lastUpdate) / 1000.0; // Convert to seconds
+    unsigned long deltaTime = currentTime - lastUpdate; // ms
     
-    if (deltaTime <= 0) return; // Avoid division by zero
+    if (deltaTime == 0) return; // Avoid division by zero
     
     currentTemperature = currentTemp;
     
     // Calculate error
     float error = targetTemperature - currentTemperature;
     
-    // Update integral (with windup protection)
-    integral += error * deltaTime;
-    if (integral > maxIntegral) integral = maxIntegral;
-    if (integral < -maxIntegral) integral = -maxIntegral;
-    
-    // Calculate derivative
-    derivative = (error - previousError) / deltaTime;
+    // Calculate PID output and drive the time-proportioning heater stage
+    float pidOutput = pid.compute(currentTemperature, deltaTime);
     
-    // Calculate PID output (for future advanced control)
-    // float pidOutput = getPIDOutput();
-    
-    // Determine heating/cooling actions based on error and tolerance
     bool wasHeating = heatingActive;
     bool wasCooling = coolingActive;
     
-    heatingActive = false;
-    coolingActive = false;
+    // Temperature too high - need cooling, heater stays off
+    // Starts above target + tolerance and stops only back at target + tolerance - hysteresis
+    float coolingLimit = wasCooling ? tolerance - coolingHysteresis : tolerance;
+    coolingActive = (error < -coolingLimit);
+    updateHeaterOutput(currentTime, coolingActive ? 0.0 : pidOutput);
+    heatingActive = (heaterDuty > 0.0);
     
-    if (error > tolerance) {
-        // Temperature too low - need heating
-        heatingActive = true;
-        if (!wasHeating) {
-            lastActiveTime = currentTime;
-            adjustmentCount++;
-            Serial.println(String("[TemperatureControl] Heating activated. Current: ") + 
-                         currentTemperature + "°C, Target: " + targetTemperature + "°C");
-        }
-    } else if (error < -tolerance) {
-        // Temperature too high - need cooling  
-        coolingActive = true;
-        if (!wasCooling) {
-            lastActiveTime = currentTime;
-            adjustmentCount++;
-            Serial.println(String("[TemperatureControl] Cooling activated. Current: ") + 
-                         currentTemperature + "°C, Target: " + targetTemperature + "°C");
-        }
-    } else {
+    if (heatingActive && !wasHeating) {
+        lastActiveTime = currentTime;
+        adjustmentCount++;
+        Serial.println(String("[TemperatureControl] Heating activated. Current: ") + 
+                     currentTemperature + "°C, Target: " + targetTemperature + "°C, Duty: " + heaterDuty + "%");
+    }
+    
+    if (coolingActive && !wasCooling) {
+        lastActiveTime = currentTime;
+        adjustmentCount++;
+        Serial.println(String("[TemperatureControl] Cooling activated. Current: ") + 
+                     currentTemperature + "°C, Target: " + targetTemperature + "°C");
+    }
+    
+    if (!heatingActive && !coolingActive && (wasHeating || wasCooling)) {
         // Temperature in acceptable range
-        if (wasHeating || wasCooling) {
-            totalActiveTime += (currentTime - lastActiveTime);
-            Serial.println(String("[TemperatureControl] Temperature stable. Current: ") + 
-                         currentTemperature + "°C, Target: " + targetTemperature + "°C");
-        }
+        totalActiveTime += (currentTime - lastActiveTime);
+        Serial.println(String("[TemperatureControl] Temperature stable. Current: ") + 
+                     currentTemperature + "°C, Target: " + targetTemperature + "°C");
     }
     
-    previousError = error;
     lastUpdate = currentTime;
 }
 
 // Configuration methods
 // cppcheck-suppress unusedFunction
 void TemperatureControl::setTarget(float target) {
+    if (target == targetTemperature) return;
+    
     if (target >= minTemp && target <= maxTemp) {
         targetTemperature = target;
-        // Reset integral when target changes to prevent windup
-        integral = 0.0;
+        // Bumpless setpoint change: no integral reset, no derivative kick
+        pid.setSetpoint(target);
         Serial.println(String("[TemperatureControl] Target temperature set to: ") + target + "°C");
     } else {
         Serial.println(String("[TemperatureControl] Invalid target temperature: ") + target + 
@@ -140,12 +142,9 @@ void TemperatureControl::setTolerance(float tol) {
 
 // cppcheck-suppress unusedFunction
 void TemperatureControl::setPIDConstants(float p, float i, float d) {
-    kp = p;
-    ki = i;
-    kd = d;
-    // Reset integral when PID constants change
-    integral = 0.0;
-    Serial.println(String("[TemperatureControl] PID constants updated - Kp:") + kp + " Ki:" + ki + " Kd:" + kd);
+    // Integral is kept in output units, so changing gains does not bump the output
+    pid.setGains(p, i, d);
+    Serial.println(String("[TemperatureControl] PID constants updated - Kp:") + p + " Ki:" + i + " Kd:" + d);
 }
 
 // cppcheck-suppress unusedFunction
@@ -157,13 +156,24 @@ void TemperatureControl::setTemperatureLimits(float min, float max) {
     }
 }
 
+// cppcheck-suppress unusedFunction
+void TemperatureControl::setHeaterWindow(unsigned long windowMs, unsigned long minSwitchMs) {
+    // The window must leave room for a minimum ON and a minimum OFF period
+    if (windowMs >= 2 * minSwitchMs && windowMs > 0) {
+        heaterWindowSize = windowMs;
+        heaterMinSwitchTime = minSwitchMs;
+        heaterWindowStart = millis();
+        Serial.println(String("[TemperatureControl] Heater window set to: ") + (windowMs / 1000) + "s, Min switch: " + 
+                      (minSwitchMs / 1000) + "s");
+    }
+}
+
 // Control methods
 // cppcheck-suppress unusedFunction
 void TemperatureControl::enable() {
     enabled = true;
     // Reset state when enabling
-    integral = 0.0;
-    previousError = 0.0;
+    pid.reset();
     lastUpdate = millis();
     Serial.println("[TemperatureControl] Enabled");
 }
@@ -173,9 +183,28 @@ void TemperatureControl::disable() {
     enabled = false;
     heatingActive = false;
     coolingActive = false;
+    heaterOutput = false;
+    heaterDuty = 0.0;
+    heaterOnTime = 0;
+    heaterPulseDone = false;
     Serial.println("[TemperatureControl] Disabled");
 }
 
+// cppcheck-suppress unusedFunction
+void TemperatureControl::resetControl() {
+    // The heater is off when the relay experiment releases it: start from zero output
+    pid.reset();
+    lastUpdate = millis();
+    heaterWindowStart = lastUpdate;
+    heaterOnTime = 0;
+    heaterDuty = 0.0;
+    heaterOutput = false;
+    heaterPulseDone = false;
+    heatingActive = false;
+    coolingActive = false;
+    Serial.println("[TemperatureControl] Controller reset");
+}
+
 // cppcheck-suppress unusedFunction
 bool TemperatureControl::isEnabled() const {
     return enabled;
@@ -207,17 +236,68 @@ bool TemperatureControl::isInRange() const {
     return error <= tolerance;
 }
 
-float TemperatureControl::getPIDOutput() {
+float TemperatureControl::getPIDOutput() const {
     if (!enabled) return 0.0;
     
-    float error = getError();
-    float output = (kp * error) + (ki * integral) + (kd * derivative);
+    return pid.getOutput();
+}
+
+// cppcheck-suppress unusedFunction
+float TemperatureControl::getIntegralTerm() const {
+    return pid.getIntegralTerm();
+}
+
+// cppcheck-suppress unusedFunction
+void TemperatureControl::restoreIntegralTerm(float integral) {
+    // Preloaded like a bumpless start: the first step after the restart resumes from it
+    pid.reset(integral);
+}
+
+// cppcheck-suppress unusedFunction
+bool TemperatureControl::isHeaterOutputOn() const {
+    return enabled && heaterOutput;
+}
+
+// cppcheck-suppress unusedFunction
+float TemperatureControl::getHeaterDuty() const {
+    return enabled ? heaterDuty : 0.0;
+}
+
+void TemperatureControl::updateHeaterOutput(unsigned long currentTime, float pidOutput) {
+    // Only positive PID output calls for heat; the relay cannot cool
+    float duty = constrain(pidOutput, 0.0f, 100.0f);
     
-    // Limit output to reasonable range
-    if (output > 100.0) output = 100.0;
-    if (output < -100.0) output = -100.0;
+    // Roll over to a new window, catching up if updates were delayed
+    unsigned long elapsed = currentTime - heaterWindowStart;
+    if (elapsed >= heaterWindowSize) {
+        heaterWindowStart += (elapsed / heaterWindowSize) * heaterWindowSize;
+        elapsed = currentTime - heaterWindowStart;
+        heaterPulseDone = false;
+    }
     
-    return output;
+    // Convert duty to ON time within the window, respecting the minimum
+    // heating time for both the ON and the OFF pulse
+    unsigned long onTime = (unsigned long)((duty / 100.0) * heaterWindowSize);
+    if (onTime < heaterMinSwitchTime) {
+        onTime = 0;
+    } else if (heaterWindowSize - onTime < heaterMinSwitchTime) {
+        onTime = heaterWindowSize;
+    }
+    
+    // The ON pulse of this window was already delivered: keep the heater off
+    // until the next window instead of adding a second short cycle
+    if (heaterPulseDone) {
+        onTime = 0;
+    }
+    
+    heaterOnTime = onTime;
+    heaterDuty = (heaterOnTime * 100.0) / heaterWindowSize;
+    
+    bool wasOn = heaterOutput;
+    heaterOutput = (elapsed < heaterOnTime);
+    if (wasOn && !heaterOutput) {
+        heaterPulseDone = true;
+    }
 }
 
 // Statistics methods
@@ -249,7 +329,7 @@ String TemperatureControl::getStatusString() const {
     if (!enabled) {
         status += " (OFF)";
     } else if (heatingActive) {
-        status += " (HEATING)";
+        status += " (HEATING " + String(heaterDuty, 0) + "%)";
     } else if (coolingActive) {
         status += " (COOLING)";
     } else {
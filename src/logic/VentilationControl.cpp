@@ -9,6 +9,8 @@ bool VentilationControl::isEnabled() const {
 VentilationControl::VentilationControl() :
     targetAirExchangeRate(6.0),
     currentAirQuality(50.0),
+    currentTemperature(20.0),
+    currentHumidity(60.0),
     temperatureThreshold(25.0),
     humidityThreshold(80.0),
     co2Threshold(1000.0),
@@ -22,6 +24,10 @@ VentilationControl::VentilationControl() :
     minRunTime(60000),
     maxRunTime(1800000),
     cooldownTime(180000),
+    scheduleActive(false),
+    scheduleStartMinute(0),
+    scheduleEndMinute(0),
+    scheduledLevel(VENTILATION_OFF),
     outsideTemperature(20.0),
     outsideHumidity(60.0),
     isWindy(false),
@@ -67,8 +73,11 @@ bool VentilationControl::begin() {
 }
 
 // cppcheck-suppress unusedFunction
-void VentilationControl::update(float temperature, float humidity, float co2Level, float lightLevel) {
+void VentilationControl::update(float temperature, float humidity, float co2Level,
+                                uint8_t currentHour, uint8_t currentMinute) {
     unsigned long currentTime = millis();
+    currentTemperature = temperature;
+    currentHumidity = humidity;
     
     // Calculate composite air quality index
     currentAirQuality = calculateCompositeAirQuality(temperature, humidity, co2Level);
@@ -87,6 +96,11 @@ void VentilationControl::update(float temperature, float humidity, float co2Leve
         requiredLevel = adaptLevelToConditions(requiredLevel);
     }
     
+    // Scheduled window sets a minimum level
+    if (isInScheduledWindow(currentHour, currentMinute) && scheduledLevel > requiredLevel) {
+        requiredLevel = scheduledLevel;
+    }
+    
     // Check if level change is allowed
     if (isLevelChangeAllowed() && requiredLevel != currentLevel) {
         previousLevel = currentLevel;
@@ -129,8 +143,38 @@ void VentilationControl::setHumidityThresholds(float target, float threshold, fl
                   "%, Threshold: " + threshold + "%");
 }
 
+// cppcheck-suppress unusedFunction
+void VentilationControl::setDaytimeStatus(bool isDay) {
+    isDaytime = isDay;
+}
+
+// cppcheck-suppress unusedFunction
+void VentilationControl::scheduleVentilation(uint8_t startHour, uint8_t startMinute, uint8_t endHour, uint8_t endMinute, VentilationLevel level) {
+    scheduleStartMinute = startHour * 60 + startMinute;
+    scheduleEndMinute = endHour * 60 + endMinute;
+    scheduledLevel = level;
+    scheduleActive = (level != VENTILATION_OFF);
+    Serial.println(String("[VentilationControl] Scheduled ventilation ") + startHour + ":" + startMinute +
+                  " - " + endHour + ":" + endMinute + " at " + (int)level + "%");
+}
+
+bool VentilationControl::isInScheduledWindow(uint8_t hour, uint8_t minute) const {
+    if (!scheduleActive || hour > 23) return false; // 255 = wall-clock time unknown
+    
+    uint16_t now = hour * 60 + minute;
+    if (scheduleEndMinute < scheduleStartMinute) { // Window crosses midnight
+        return now >= scheduleStartMinute || now < scheduleEndMinute;
+    }
+    return now >= scheduleStartMinute && now < scheduleEndMinute;
+}
+
 void VentilationControl::emergencyVentilation() {
     emergencyActive = true;
+    // Entering MAX counts as a level change: the normal level waits out minRunTime after the emergency
+    if (currentLevel != VENTILATION_MAX) {
+        previousLevel = currentLevel;
+        lastLevelChange = millis();
+    }
     currentLevel = VENTILATION_MAX;
     updateFanControl();
     updateServoControl();
@@ -149,17 +193,22 @@ VentilationControl::VentilationLevel VentilationControl::calculateRequiredLevel(
     // float tempError = abs(targetTemperature - outsideTemperature);
     // float humError = abs(targetHumidity - outsideHumidity);
     
+    // Hysteresis: ventilation started by a threshold runs until the reading
+    // drops its hysteresis below it, so the level does not chatter around it
+    float temperatureOff = temperatureThreshold - (currentLevel >= VENTILATION_MEDIUM ? temperatureHysteresis : 0.0f);
+    float humidityOff = humidityThreshold - (currentLevel >= VENTILATION_LOW ? humidityHysteresis : 0.0f);
+    
     // Temperature-based control
-    if (outsideTemperature > temperatureThreshold + temperatureHysteresis) {
+    if (currentTemperature > temperatureThreshold + temperatureHysteresis) {
         return VENTILATION_HIGH;
-    } else if (outsideTemperature > temperatureThreshold) {
+    } else if (currentTemperature > temperatureOff) {
         return VENTILATION_MEDIUM;
     }
     
     // Humidity-based control
-    if (outsideHumidity > humidityThreshold + humidityHysteresis) {
+    if (currentHumidity > humidityThreshold + humidityHysteresis) {
         return VENTILATION_HIGH;
-    } else if (outsideHumidity > humidityThreshold) {
+    } else if (currentHumidity > humidityOff) {
         return VENTILATION_LOW;
     }
     
@@ -342,6 +391,11 @@ bool VentilationControl::isDamperOpen() const {
     return damperOpen;
 }
 
+// cppcheck-suppress unusedFunction
+bool VentilationControl::isEmergencyActive() const {
+    return emergencyActive;
+}
+
 // cppcheck-suppress unusedFunction
 VentilationControl::VentilationLevel VentilationControl::getCurrentLevel() const {
     return currentLevel;
@@ -0,0 +1,586 @@
+#include "modbus/ModbusManager.h"
+#include "blynk/BlynkTargets.h"
+#include "sensors/SensorManager.h"
+#include "actuators/ActuatorManager.h"
+#include "logic/LogicManager.h"
+#include "system/PowerManager.h"
+
+namespace {
+
+// Holding registers must point at a target in the Blynk registry (field and range)
+constexpr bool holdingTargetsValid() {
+    for (const ModbusMap::Entry& entry : ModbusMap::REGISTER_MAP) {
+        if (entry.area != ModbusMap::Area::HOLDING_REGISTER) continue;
+        const BlynkTargets::PinEntry* pin = BlynkTargets::findPin(entry.source);
+        if (!pin || !pin->field || entry.scale <= 0) return false;
+    }
+    return true;
+}
+static_assert(holdingTargetsValid(), "Every holding register needs a Blynk target pin and a positive scale");
+
+// Function codes and exception codes (Modbus Application Protocol v1.1b3)
+const uint8_t FC_READ_COILS = 0x01;
+const uint8_t FC_READ_HOLDING_REGISTERS = 0x03;
+const uint8_t FC_READ_INPUT_REGISTERS = 0x04;
+const uint8_t FC_WRITE_SINGLE_COIL = 0x05;
+const uint8_t FC_WRITE_SINGLE_REGISTER = 0x06;
+const uint8_t FC_WRITE_MULTIPLE_COILS = 0x0F;
+const uint8_t FC_WRITE_MULTIPLE_REGISTERS = 0x10;
+
+const uint8_t EX_ILLEGAL_FUNCTION = 0x01;
+const uint8_t EX_ILLEGAL_DATA_ADDRESS = 0x02;
+const uint8_t EX_ILLEGAL_DATA_VALUE = 0x03;
+const uint8_t EX_SLAVE_DEVICE_BUSY = 0x06;
+
+uint16_t readU16(const uint8_t* data) {
+    return (uint16_t)((data[0] << 8) | data[1]);
+}
+
+void writeU16(uint8_t* data, uint16_t value) {
+    data[0] = (uint8_t)(value >> 8);
+    data[1] = (uint8_t)value;
+}
+
+uint16_t encodeRegister(float value, float scale) {
+    if (isnan(value)) return ModbusMap::NO_READING;
+    float scaled = roundf(value * scale);
+    if (scaled > 32767.0f) scaled = 32767.0f;
+    if (scaled < -32767.0f) scaled = -32767.0f; // -32768 is NO_READING
+    return (uint16_t)(int16_t)scaled;
+}
+
+} // namespace
+
+ModbusManager::ModbusManager() :
+    server(nullptr),
+    sensorManager(nullptr),
+    actuatorManager(nullptr),
+    logicManager(nullptr),
+    dataMutex(nullptr),
+    inputImage(),
+    holdingImage(),
+    coilImage(),
+    pendingWrites(),
+    pendingCount(0),
+    requestCount(0),
+    exceptionCount(0),
+    connections(),
+    rtuSerial(nullptr),
+    rtuBuffer(),
+    rtuLength(0),
+    rtuLastByte(0),
+    lastImage(0),
+    running(false)
+{
+    dataMutex = xSemaphoreCreateMutex();
+    for (uint16_t i = 0; i < ModbusMap::INPUT_COUNT; i++) {
+        writeU16(inputImage + i * 2, ModbusMap::NO_READING);
+    }
+}
+
+ModbusManager::~ModbusManager() {
+    if (server) {
+        server->end();
+        delete server;
+    }
+    if (dataMutex) {
+        vSemaphoreDelete(dataMutex);
+    }
+}
+
+// cppcheck-suppress unusedFunction
+bool ModbusManager::begin(SensorManager* sensors, ActuatorManager* actuators, LogicManager* logic) {
+    if (!sensors || !actuators || !logic || !dataMutex) {
+        Serial.println("[ModbusManager] Error: missing managers or mutex");
+        return false;
+    }
+    sensorManager = sensors;
+    actuatorManager = actuators;
+    logicManager = logic;
+    publishImage();
+
+    if (MODBUS_TCP_ENABLED) {
+        server = new AsyncServer(MODBUS_TCP_PORT);
+        server->onClient([](void* arg, AsyncClient* client) {
+            static_cast<ModbusManager*>(arg)->handleClient(client);
+        }, this);
+        server->setNoDelay(true);
+        server->begin();
+        Serial.printf("[ModbusManager] Modbus TCP on port %u\n", (unsigned)MODBUS_TCP_PORT);
+    }
+
+    if (MODBUS_RTU_ENABLED) {
+        rtuSerial = &Serial1;
+        rtuSerial->begin(MODBUS_RTU_BAUD, SERIAL_8N1, MODBUS_RTU_RX_PIN, MODBUS_RTU_TX_PIN);
+        pinMode(MODBUS_RTU_DE_PIN, OUTPUT);
+        digitalWrite(MODBUS_RTU_DE_PIN, LOW);
+        Serial.printf("[ModbusManager] Modbus RTU slave %u at %lu baud\n", (unsigned)MODBUS_UNIT_ID,
+                      (unsigned long)MODBUS_RTU_BAUD);
+    }
+
+    running = true;
+    return true;
+}
+
+void ModbusManager::update() {
+    if (!running) return;
+
+    applyPendingWrites();
+    if (millis() - lastImage >= MODBUS_IMAGE_INTERVAL) {
+        publishImage();
+    }
+    if (rtuSerial) {
+        pollRtu();
+    }
+}
+
+// cppcheck-suppress unusedFunction
+unsigned long ModbusManager::getIdleTime() const {
+    if (!running) return ULONG_MAX;
+    if (pendingCount > 0) return 0;
+    // RTU requests wait in the UART buffer; one poll per inter-frame gap keeps up with the master
+    return rtuSerial ? MODBUS_RTU_IDLE_GAP : ULONG_MAX;
+}
+
+// Loop side
+
+void ModbusManager::publishImage() {
+    // Convert once per interval, outside the lock
+    uint8_t inputs[sizeof(inputImage)];
+    uint8_t holdings[sizeof(holdingImage)];
+    uint8_t coils[sizeof(coilImage)] = {0};
+
+    for (const ModbusMap::Entry& entry : ModbusMap::REGISTER_MAP) {
+        switch (entry.area) {
+            case ModbusMap::Area::INPUT_REGISTER: {
+                float value = NAN;
+                switch (entry.source) {
+                    case ModbusMap::SRC_TEMPERATURE: value = sensorManager->getTemperature(); break;
+                    case ModbusMap::SRC_HUMIDITY: value = sensorManager->getHumidity(); break;
+                    case ModbusMap::SRC_HEAT_INDEX: value = sensorManager->getHeatIndex(); break;
+                    case ModbusMap::SRC_LUX: value = sensorManager->getLux(); break;
+                    case ModbusMap::SRC_LIGHT_LUX: value = sensorManager->getLightLux(); break;
+                    case ModbusMap::SRC_SOIL_MOISTURE: value = sensorManager->getSoilMoisture(); break;
+                    case ModbusMap::SRC_SOIL_MOISTURE_RS485: value = sensorManager->getSoilMoistureRS485(); break;
+                    case ModbusMap::SRC_SOIL_TEMPERATURE: value = sensorManager->getSoilTemperature(); break;
+                    case ModbusMap::SRC_SOIL_EC: value = sensorManager->getSoilEC(); break;
+                    case ModbusMap::SRC_SOIL_PH: value = sensorManager->getSoilPH(); break;
+                    case ModbusMap::SRC_WATER_LEVEL: value = sensorManager->getWaterLevel(); break;
+                    case ModbusMap::SRC_WATER_PERCENTAGE: value = sensorManager->getWaterPercentage(); break;
+                    case ModbusMap::SRC_UPTIME_MINUTES: value = (float)((millis() / 60000UL) % 32768UL); break;
+                    default: break;
+                }
+                writeU16(inputs + entry.address * 2, encodeRegister(value, entry.scale));
+                break;
+            }
+            case ModbusMap::Area::HOLDING_REGISTER: {
+                float value = targets.*(BlynkTargets::findPin(entry.source)->field);
+                writeU16(holdings + entry.address * 2, encodeRegister(value, entry.scale));
+                break;
+            }
+            case ModbusMap::Area::COIL: {
+                bool state = false;
+                switch (entry.source) {
+                    case ModbusMap::SRC_FAN: state = actuatorManager->obtenerEstadoVentilador(); break;
+                    case ModbusMap::SRC_WATER_PUMP: state = actuatorManager->obtenerEstadoBombaAgua(); break;
+                    case ModbusMap::SRC_HEATER: state = actuatorManager->obtenerEstadoCalefactor(); break;
+                    case ModbusMap::SRC_LED_STRIP: state = actuatorManager->obtenerEstadoTiraLED(); break;
+                    case ModbusMap::SRC_VENTILATION: state = actuatorManager->obtenerEstadoVentilacion(); break;
+                    case ModbusMap::SRC_AUTO_MODE: state = logicManager->isAutoMode(); break;
+                    default: break;
+                }
+                if (state) coils[entry.address / 8] |= (uint8_t)(1 << (entry.address % 8));
+                break;
+            }
+        }
+    }
+
+    // Never wait for a request being served: retry on the next loop instead
+    if (xSemaphoreTake(dataMutex, 0) != pdTRUE) return;
+    memcpy(inputImage, inputs, sizeof(inputImage));
+    memcpy(holdingImage, holdings, sizeof(holdingImage));
+    memcpy(coilImage, coils, sizeof(coilImage));
+    xSemaphoreGive(dataMutex);
+    lastImage = millis();
+}
+
+void ModbusManager::applyPendingWrites() {
+    PendingWrite writes[MODBUS_MAX_PENDING_WRITES];
+    if (xSemaphoreTake(dataMutex, 0) != pdTRUE) return;
+    uint8_t count = pendingCount;
+    memcpy(writes, pendingWrites, count * sizeof(PendingWrite));
+    pendingCount = 0;
+    xSemaphoreGive(dataMutex);
+    if (count == 0) return;
+
+    for (uint8_t i = 0; i < count; i++) {
+        const PendingWrite& write = writes[i];
+        const ModbusMap::Entry* entry = ModbusMap::findEntry(write.area, write.address);
+        if (!entry) continue;
+
+        if (write.area == ModbusMap::Area::HOLDING_REGISTER) {
+            // Same path as the app and the web API: clamp, persist, echo to Blynk
+            BlynkTargets::dispatch(entry->source, (int16_t)write.value / entry->scale);
+            continue;
+        }
+
+        bool on = write.value != 0;
+        switch (entry->source) {
+            case ModbusMap::SRC_FAN:
+                if (on) actuatorManager->activarVentilador(); else actuatorManager->desactivarVentilador();
+                break;
+            case ModbusMap::SRC_WATER_PUMP:
+                if (on) actuatorManager->activarBombaAgua(); else actuatorManager->desactivarBombaAgua();
+                break;
+            case ModbusMap::SRC_HEATER:
+                if (on) actuatorManager->activarCalefactor(); else actuatorManager->desactivarCalefactor();
+                break;
+            case ModbusMap::SRC_LED_STRIP:
+                if (on) actuatorManager->activarTiraLED(); else actuatorManager->desactivarTiraLED();
+                break;
+            case ModbusMap::SRC_VENTILATION:
+                if (on) actuatorManager->abrirVentilacion(); else actuatorManager->cerrarVentilacion();
+                break;
+            case ModbusMap::SRC_AUTO_MODE:
+                logicManager->setAutoMode(on);
+                break;
+            default:
+                break;
+        }
+    }
+
+    // Reads after a write should see it as soon as possible
+    publishImage();
+}
+
+void ModbusManager::pollRtu() {
+    while (rtuSerial->available() && rtuLength < sizeof(rtuBuffer)) {
+        rtuBuffer[rtuLength++] = (uint8_t)rtuSerial->read();
+        rtuLastByte = millis();
+    }
+    if (rtuLength < 4) return;
+
+    // The loop is too coarse for the 3.5 character gap, so frames are
+    // delimited by the length each function code implies
+    uint16_t expected;
+    switch (rtuBuffer[1]) {
+        case FC_READ_COILS:
+        case FC_READ_HOLDING_REGISTERS:
+        case FC_READ_INPUT_REGISTERS:
+        case FC_WRITE_SINGLE_COIL:
+        case FC_WRITE_SINGLE_REGISTER:
+            expected = 8;
+            break;
+        case FC_WRITE_MULTIPLE_COILS:
+        case FC_WRITE_MULTIPLE_REGISTERS:
+            if (rtuLength < 7) return;
+            expected = 9 + rtuBuffer[6];
+            break;
+        default:
+            // Unknown function: take whatever arrived once the line goes quiet, the CRC decides
+            if (millis() - rtuLastByte < MODBUS_RTU_IDLE_GAP) return;
+            expected = rtuLength;
+            break;
+    }
+    if (expected > sizeof(rtuBuffer)) {
+        rtuLength = 0;
+        return;
+    }
+    if (rtuLength < expected) return;
+
+    uint16_t crc = crc16(rtuBuffer, expected - 2);
+    if (rtuBuffer[expected - 2] != (uint8_t)crc || rtuBuffer[expected - 1] != (uint8_t)(crc >> 8)) {
+        rtuLength = 0; // Noise or lost sync: drop everything and wait for the next request
+        return;
+    }
+
+    uint8_t address = rtuBuffer[0];
+    if (address == MODBUS_UNIT_ID || address == 0) {
+        uint8_t response[MAX_RTU_ADU];
+        xSemaphoreTake(dataMutex, portMAX_DELAY);
+        uint16_t pduLength = processPdu(rtuBuffer + 1, expected - 3, response + 1);
+        requestCount++;
+        xSemaphoreGive(dataMutex);
+
+        // Broadcasts (address 0) are applied but never answered
+        if (address != 0) {
+            response[0] = address;
+            uint16_t length = pduLength + 1;
+            uint16_t responseCrc = crc16(response, length);
+            response[length++] = (uint8_t)responseCrc;
+            response[length++] = (uint8_t)(responseCrc >> 8);
+            digitalWrite(MODBUS_RTU_DE_PIN, HIGH);
+            rtuSerial->write(response, length);
+            rtuSerial->flush();
+            digitalWrite(MODBUS_RTU_DE_PIN, LOW);
+        }
+    }
+
+    rtuLength -= expected;
+    memmove(rtuBuffer, rtuBuffer + expected, rtuLength);
+}
+
+// AsyncTCP side
+
+void ModbusManager::handleClient(AsyncClient* client) {
+    Connection* connection = nullptr;
+    for (Connection& candidate : connections) {
+        if (!candidate.client) {
+            connection = &candidate;
+            break;
+        }
+    }
+    client->onDisconnect([this, connection](void* arg, AsyncClient* c) {
+        (void)arg;
+        if (connection) {
+            connection->client = nullptr;
+            connection->length = 0;
+        }
+        delete c;
+    });
+    if (!connection) {
+        Serial.println("[ModbusManager] Too many Modbus TCP clients, rejecting");
+        client->close(true);
+        return;
+    }
+
+    connection->client = client;
+    connection->length = 0;
+    client->setNoDelay(true);
+    client->setRxTimeout(MODBUS_TCP_IDLE_TIMEOUT);
+    client->onData([this, connection](void* arg, AsyncClient* c, void* data, size_t length) {
+        (void)arg; (void)c;
+        handleData(*connection, (const uint8_t*)data, length);
+    });
+    // Frames held back for lack of TCP space go out once the peer acknowledges
+    client->onAck([this, connection](void* arg, AsyncClient* c, size_t length, uint32_t time) {
+        (void)arg; (void)c; (void)length; (void)time;
+        processConnection(*connection);
+    });
+    client->onTimeout([](void* arg, AsyncClient* c, uint32_t time) {
+        (void)arg; (void)time;
+        c->close();
+    });
+}
+
+void ModbusManager::handleData(Connection& connection, const uint8_t* data, size_t length) {
+    while (length > 0 && connection.client) {
+        size_t room = sizeof(connection.buffer) - connection.length;
+        if (room == 0) {
+            // The peer keeps sending without reading the answers
+            closeConnection(connection);
+            return;
+        }
+        size_t chunk = length < room ? length : room;
+        memcpy(connection.buffer + connection.length, data, chunk);
+        connection.length += chunk;
+        data += chunk;
+        length -= chunk;
+        processConnection(connection);
+    }
+}
+
+void ModbusManager::processConnection(Connection& connection) {
+    AsyncClient* client = connection.client;
+    if (!client) return;
+
+    uint8_t response[MAX_TCP_ADU];
+    uint16_t offset = 0;
+    bool queued = false;
+
+    // Answer every complete request in the buffer, in order
+    while (connection.length - offset >= 7) {
+        const uint8_t* adu = connection.buffer + offset;
+        uint16_t protocol = readU16(adu + 2);
+        uint16_t aduLength = readU16(adu + 4); // Unit id + PDU
+        if (protocol != 0 || aduLength < 2 || aduLength > MAX_PDU + 1) {
+            closeConnection(connection);
+            return;
+        }
+        uint16_t total = 6 + aduLength;
+        if (connection.length - offset < total) break;
+        if (client->space() < MAX_TCP_ADU) break;
+
+        xSemaphoreTake(dataMutex, portMAX_DELAY);
+        uint16_t pduLength = processPdu(adu + 7, aduLength - 1, response + 7);
+        requestCount++;
+        xSemaphoreGive(dataMutex);
+
+        // Same transaction id, protocol and unit id as the request
+        memcpy(response, adu, 4);
+        writeU16(response + 4, pduLength + 1);
+        response[6] = adu[6];
+        client->add((const char*)response, 7 + pduLength);
+        queued = true;
+        offset += total;
+    }
+
+    if (queued) {
+        client->send();
+    }
+    if (offset > 0) {
+        connection.length -= offset;
+        memmove(connection.buffer, connection.buffer + offset, connection.length);
+    }
+}
+
+void ModbusManager::closeConnection(Connection& connection) {
+    connection.length = 0;
+    if (connection.client) {
+        connection.client->close();
+    }
+}
+
+// Protocol core
+
+uint16_t ModbusManager::exceptionResponse(uint8_t function, uint8_t code, uint8_t* response) {
+    exceptionCount++;
+    response[0] = function | 0x80;
+    response[1] = code;
+    return 2;
+}
+
+bool ModbusManager::queueWrite(ModbusMap::Area area, uint16_t address, uint16_t value) {
+    if (pendingCount >= MODBUS_MAX_PENDING_WRITES) return false;
+    pendingWrites[pendingCount++] = {area, address, value};
+    PowerManager::wake();
+    return true;
+}
+
+uint16_t ModbusManager::processPdu(const uint8_t* pdu, uint16_t length, uint8_t* response) {
+    if (length < 1) return exceptionResponse(0, EX_ILLEGAL_FUNCTION, response);
+    uint8_t function = pdu[0];
+
+    switch (function) {
+        case FC_READ_COILS: {
+            if (length != 5) return exceptionResponse(function, EX_ILLEGAL_DATA_VALUE, response);
+            uint16_t start = readU16(pdu + 1);
+            uint16_t quantity = readU16(pdu + 3);
+            if (quantity < 1 || quantity > 2000) return exceptionResponse(function, EX_ILLEGAL_DATA_VALUE, response);
+            if (start + quantity > ModbusMap::COIL_COUNT) {
+                return exceptionResponse(function, EX_ILLEGAL_DATA_ADDRESS, response);
+            }
+            uint8_t bytes = (quantity + 7) / 8;
+            response[0] = function;
+            response[1] = bytes;
+            memset(response + 2, 0, bytes);
+            for (uint16_t i = 0; i < quantity; i++) {
+                uint16_t coil = start + i;
+                if (coilImage[coil / 8] & (1 << (coil % 8))) {
+                    response[2 + i / 8] |= (uint8_t)(1 << (i % 8));
+                }
+            }
+            return 2 + bytes;
+        }
+
+        case FC_READ_HOLDING_REGISTERS:
+        case FC_READ_INPUT_REGISTERS: {
+            if (length != 5) return exceptionResponse(function, EX_ILLEGAL_DATA_VALUE, response);
+            uint16_t start = readU16(pdu + 1);
+            uint16_t quantity = readU16(pdu + 3);
+            if (quantity < 1 || quantity > 125) return exceptionResponse(function, EX_ILLEGAL_DATA_VALUE, response);
+            bool holding = function == FC_READ_HOLDING_REGISTERS;
+            uint16_t count = holding ? ModbusMap::HOLDING_COUNT : ModbusMap::INPUT_COUNT;
+            if (start + quantity > count) return exceptionResponse(function, EX_ILLEGAL_DATA_ADDRESS, response);
+            // Already big endian: a straight copy from the image
+            response[0] = function;
+            response[1] = (uint8_t)(quantity * 2);
+            memcpy(response + 2, (holding ? holdingImage : inputImage) + start * 2, quantity * 2);
+            return 2 + quantity * 2;
+        }
+
+        case FC_WRITE_SINGLE_COIL: {
+            if (length != 5) return exceptionResponse(function, EX_ILLEGAL_DATA_VALUE, response);
+            uint16_t address = readU16(pdu + 1);
+            uint16_t value = readU16(pdu + 3);
+            if (value != 0xFF00 && value != 0x0000) return exceptionResponse(function, EX_ILLEGAL_DATA_VALUE, response);
+            const ModbusMap::Entry* entry = ModbusMap::findEntry(ModbusMap::Area::COIL, address);
+            if (!entry || !entry->writable) return exceptionResponse(function, EX_ILLEGAL_DATA_ADDRESS, response);
+            if (!queueWrite(ModbusMap::Area::COIL, address, value)) {
+                return exceptionResponse(function, EX_SLAVE_DEVICE_BUSY, response);
+            }
+            memcpy(response, pdu, 5);
+            return 5;
+        }
+
+        case FC_WRITE_SINGLE_REGISTER: {
+            if (length != 5) return exceptionResponse(function, EX_ILLEGAL_DATA_VALUE, response);
+            uint16_t address = readU16(pdu + 1);
+            if (address >= ModbusMap::HOLDING_COUNT) return exceptionResponse(function, EX_ILLEGAL_DATA_ADDRESS, response);
+            if (!queueWrite(ModbusMap::Area::HOLDING_REGISTER, address, readU16(pdu + 3))) {
+                return exceptionResponse(function, EX_SLAVE_DEVICE_BUSY, response);
+            }
+            memcpy(response, pdu, 5);
+            return 5;
+        }
+
+        case FC_WRITE_MULTIPLE_COILS:
+        case FC_WRITE_MULTIPLE_REGISTERS: {
+            if (length < 6) return exceptionResponse(function, EX_ILLEGAL_DATA_VALUE, response);
+            uint16_t start = readU16(pdu + 1);
+            uint16_t quantity = readU16(pdu + 3);
+            uint8_t bytes = pdu[5];
+            bool coils = function == FC_WRITE_MULTIPLE_COILS;
+            uint16_t maxQuantity = coils ? 1968 : 123;
+            uint16_t expectedBytes = coils ? (quantity + 7) / 8 : quantity * 2;
+            if (quantity < 1 || quantity > maxQuantity || bytes != expectedBytes || length != 6 + bytes) {
+                return exceptionResponse(function, EX_ILLEGAL_DATA_VALUE, response);
+            }
+            ModbusMap::Area area = coils ? ModbusMap::Area::COIL : ModbusMap::Area::HOLDING_REGISTER;
+            for (uint16_t i = 0; i < quantity; i++) {
+                const ModbusMap::Entry* entry = ModbusMap::findEntry(area, start + i);
+                if (!entry || !entry->writable) return exceptionResponse(function, EX_ILLEGAL_DATA_ADDRESS, response);
+            }
+            // All or nothing
+            if (MODBUS_MAX_PENDING_WRITES - pendingCount < quantity) {
+                return exceptionResponse(function, EX_SLAVE_DEVICE_BUSY, response);
+            }
+            const uint8_t* values = pdu + 6;
+            for (uint16_t i = 0; i < quantity; i++) {
+                uint16_t value = coils ? ((values[i / 8] >> (i % 8)) & 1) : readU16(values + i * 2);
+                queueWrite(area, start + i, value);
+            }
+            memcpy(response, pdu, 5);
+            return 5;
+        }
+
+        default:
+            return exceptionResponse(function, EX_ILLEGAL_FUNCTION, response);
+    }
+}
+
+uint16_t ModbusManager::crc16(const uint8_t* data, uint16_t length) {
+    uint16_t crc = 0xFFFF;
+    for (uint16_t i = 0; i < length; i++) {
+        crc ^= data[i];
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x0001) ? (crc >> 1) ^ 0xA001 : crc >> 1;
+        }
+    }
+    return crc;
+}
+
+// cppcheck-suppress unusedFunction
+void ModbusManager::printRegisterMap() const {
+    static const char* const AREA_NAMES[] = {"coil", "input", "holding"};
+    Serial.println("[ModbusManager] Register map (area, address, name, scale):");
+    for (const ModbusMap::Entry& entry : ModbusMap::REGISTER_MAP) {
+        Serial.printf("  %-7s %3u  %-30s %g\n", AREA_NAMES[(uint8_t)entry.area], (unsigned)entry.address,
+                      entry.name, entry.area == ModbusMap::Area::COIL ? 1.0 : (double)entry.scale);
+    }
+}
+
+// cppcheck-suppress unusedFunction
+bool ModbusManager::isRunning() const {
+    return running;
+}
+
+// cppcheck-suppress unusedFunction
+unsigned long ModbusManager::getRequestCount() const {
+    return requestCount;
+}
+
+// cppcheck-suppress unusedFunction
+unsigned long ModbusManager::getExceptionCount() const {
+    return exceptionCount;
+}
@@ -0,0 +1,182 @@
+// Banco de pruebas del entorno native: pio run -e native && .pio/build/native/program [iteraciones] [paso_ms]
+//
+// Ejecuta SensorManager, ActuatorManager y LogicManager en el PC sobre el reloj
+// simulado de NativeHal, con los dispositivos de SimDevices, y mide cada etapa:
+// - tiempo de CPU del host (p50/p99/máx), para comparar cambios de código
+// - tiempo simulado consumido (delay, pulseIn, esperas de bus), que en el
+//   ESP32 es tiempo en que el loop está bloqueado
+// Al final mide el coste de PIDController::compute() en float y en Q16.16
+// (ciclos del contador de tiempo del procesador en x86, ns en el resto)
+
+#include <Arduino.h>
+#include <NativeHal.h>
+#include "native/NativeFirmware.h"
+#include "native/SimDevices.h"
+#include "logic/FixedPoint.h"
+#include "logic/PIDController.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace {
+
+const uint32_t DEFAULT_ITERATIONS = 20000;
+const uint32_t DEFAULT_STEP_MS = 100;              // Paso fijo: mide el coste por iteración, no la espera del loop
+const time_t START_EPOCH = 1767258000;             // 2026-01-01 09:00 UTC
+const uint32_t PID_ITERATIONS = 1000000;
+
+struct Stage {
+    const char* name;
+    std::vector<uint32_t> hostNanos;
+    uint64_t simMicros;
+    uint32_t simMaxMicros;
+};
+
+enum StageId {
+    STAGE_TIME,
+    STAGE_SETTINGS,
+    STAGE_SENSORS,
+    STAGE_ACTUATORS,
+    STAGE_LOGIC,
+    STAGE_COUNT
+};
+
+Stage stages[STAGE_COUNT] = {
+    {"time", {}, 0, 0},
+    {"settings", {}, 0, 0},
+    {"sensors", {}, 0, 0},
+    {"actuators", {}, 0, 0},
+    {"logic", {}, 0, 0},
+};
+
+template <typename Function>
+void measure(StageId id, Function function) {
+    Stage& stage = stages[id];
+    uint64_t simStart = NativeHal::nowMicros();
+    auto hostStart = std::chrono::steady_clock::now();
+    function();
+    auto hostEnd = std::chrono::steady_clock::now();
+    uint32_t simElapsed = (uint32_t)(NativeHal::nowMicros() - simStart);
+    stage.hostNanos.push_back((uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(hostEnd - hostStart).count());
+    stage.simMicros += simElapsed;
+    stage.simMaxMicros = std::max(stage.simMaxMicros, simElapsed);
+}
+
+uint32_t percentile(std::vector<uint32_t>& sorted, float fraction) {
+    if (sorted.empty()) {
+        return 0;
+    }
+    size_t index = (size_t)(fraction * (sorted.size() - 1) + 0.5f);
+    return sorted[index];
+}
+
+void printReport(uint32_t iterations, uint32_t stepMs) {
+    Serial.printf("\n=== Benchmark native: %u iteraciones, paso %u ms (%.1f h simuladas) ===\n", iterations, stepMs,
+                  NativeHal::nowMicros() / 3600.0e6);
+    Serial.printf("%-10s %10s %10s %10s %14s %12s\n", "etapa", "host p50", "host p99", "host max", "bloqueo medio",
+                  "bloqueo max");
+    for (Stage& stage : stages) {
+        std::vector<uint32_t> sorted = stage.hostNanos;
+        std::sort(sorted.begin(), sorted.end());
+        Serial.printf("%-10s %8u ns %8u ns %8u ns %11.1f us %9u us\n", stage.name, percentile(sorted, 0.5f),
+                      percentile(sorted, 0.99f), sorted.empty() ? 0 : sorted.back(),
+                      iterations ? (double)stage.simMicros / iterations : 0.0, stage.simMaxMicros);
+    }
+}
+
+uint64_t readCycles() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+// Closed loop on a first-order plant so the branches (saturation, sign) vary as in use
+template <typename T>
+void benchmarkPid(const char* name) {
+    PIDController<T> pid;
+    pid.setGains(T(8.0f), T(0.004f), T(0.5f));
+    pid.setOutputLimits(T(-100), T(100));
+    pid.setDerivativeFilter(T(0.5f));
+    float measurement = 50.0f;
+    float sink = 0.0f;
+
+    auto hostStart = std::chrono::steady_clock::now();
+    uint64_t cycleStart = readCycles();
+    for (uint32_t i = 0; i < PID_ITERATIONS; i++) {
+        if (i % 5000 == 0) {
+            pid.setSetpoint(T((i / 5000) % 2 ? 60.0f : 55.0f));
+        }
+        float output = (float)pid.compute(T(measurement), 5000);
+        measurement += (0.2f * output - (measurement - 50.0f)) * 0.01f;
+        sink += output;
+    }
+    uint64_t cycles = readCycles() - cycleStart;
+    auto hostEnd = std::chrono::steady_clock::now();
+    double nanos = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(hostEnd - hostStart).count();
+
+    Serial.printf("%-10s %8.1f ns %8.1f ciclos  (salida media %.1f)\n", name, nanos / PID_ITERATIONS,
+                  (double)cycles / PID_ITERATIONS, sink / PID_ITERATIONS);
+}
+
+} // namespace
+
+// pio test compila src/ con las pruebas, que traen su propio main()
+#ifndef PIO_UNIT_TESTING
+int main(int argc, char** argv) {
+    uint32_t iterations = argc > 1 ? (uint32_t)strtoul(argv[1], nullptr, 10) : DEFAULT_ITERATIONS;
+    uint32_t stepMs = argc > 2 ? (uint32_t)strtoul(argv[2], nullptr, 10) : DEFAULT_STEP_MS;
+    if (stepMs == 0) {
+        stepMs = DEFAULT_STEP_MS;
+    }
+
+    NativeHal::reset();
+    SimDevices::Greenhouse greenhouse;
+    greenhouse.attach();
+
+    NativeFirmware firmware;
+    if (!firmware.begin(START_EPOCH)) {
+        return 1;
+    }
+
+    // Sin consola durante la medida: imprimir no es parte del coste de las etapas
+    NativeHal::setConsoleEnabled(false);
+    for (Stage& stage : stages) {
+        stage.hostNanos.reserve(iterations);
+    }
+
+    for (uint32_t i = 0; i < iterations; i++) {
+        uint64_t iterationStart = NativeHal::nowMicros();
+
+        measure(STAGE_TIME, [&] { firmware.clock.update(); });
+        measure(STAGE_SETTINGS, [&] { firmware.settings.update(); });
+        measure(STAGE_SENSORS, [&] { firmware.sensors.update(); });
+        measure(STAGE_ACTUATORS, [&] { firmware.actuators.update(); });
+        measure(STAGE_LOGIC, [&] { firmware.logic.update(); });
+
+        // Resto del paso, como el delay() al final del loop
+        uint64_t elapsed = NativeHal::nowMicros() - iterationStart;
+        uint64_t step = (uint64_t)stepMs * 1000;
+        NativeHal::advanceMicros(elapsed < step ? step - elapsed : 0);
+    }
+
+    NativeHal::setConsoleEnabled(true);
+    printReport(iterations, stepMs);
+    Serial.printf("Salida de consola durante la medida: %u bytes\n", NativeHal::getConsoleBytes());
+    Serial.printf("Sensores: %.1f C, %.1f %%HR, %.0f lx\n", firmware.sensors.getTemperature(),
+                  firmware.sensors.getHumidity(), firmware.sensors.getLightLux());
+
+    Serial.printf("\n=== PIDController::compute(): %u llamadas ===\n", PID_ITERATIONS);
+    benchmarkPid<float>("float");
+    benchmarkPid<Q16_16>("Q16.16");
+    Serial.flush();
+    return 0;
+}
+#endif
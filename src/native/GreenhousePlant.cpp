@@ -0,0 +1,210 @@
+#include "native/GreenhousePlant.h"
+#include "actuators/ActuatorManager.h"
+#include "config/Targets.h"
+
+namespace {
+
+const float AIR_DENSITY = 1.2f;          // kg/m³
+const float AIR_HEAT_CAPACITY = 1005.0f; // J/(kg·K)
+const float SOIL_CALIBRATION_DRY = 3000; // Calibración por defecto de SoilMoistureSensor
+const float SOIL_CALIBRATION_WET = 1200;
+
+} // namespace
+
+GreenhousePlant::Params GreenhousePlant::defaultParams() {
+    Params p;
+    // Túnel de 6 x 4 m, 2.5 m de altura media
+    p.airVolume = 60.0f;
+    p.thermalCapacity = 400000.0f;
+    p.envelopeUA = 120.0f;
+    p.infiltrationFlow = 0.01f;
+    p.ventFlow = 0.08f;
+    p.fanFlow = 0.4f;
+    // Día de primavera
+    p.outsideMeanTemp = 12.0f;
+    p.outsideTempSwing = 5.0f;
+    p.outsideHumidity = 70.0f;
+    p.peakIrradiance = 800.0f;
+    p.sunriseHour = 7.0f;
+    p.sunsetHour = 19.0f;
+    p.solarArea = 12.0f;
+    p.transmittance = 0.7f;
+    p.solarHeatFraction = 0.5f;
+    p.luxPerWatt = 110.0f;
+    p.peakTranspiration = 0.15f;
+    p.nightTranspiration = 0.03f;
+    p.soilDryingRate = 0.3f;
+    p.soilEtRate = 1.5f;
+    p.litresPerPercent = 2.0f;
+    p.fieldCapacity = 60.0f;
+    p.heaterPower = 3000.0f;
+    p.fanPower = 60.0f;
+    p.pumpPower = 250.0f;
+    p.pumpFlow = 6.0f;
+    p.ledPower = 120.0f;
+    p.ledLux = 8000.0f;
+    return p;
+}
+
+GreenhousePlant::GreenhousePlant(SimDevices::Greenhouse& greenhouse, ActuatorManager& actuatorManager,
+                                 const Params& plantParams)
+    : params(plantParams), devices(&greenhouse), actuators(&actuatorManager), airTemperature(20.0f),
+      absoluteHumidity(10.0f), soilMoisture(), hourOfDay(0.0f), lastOn() {
+    resetDay();
+}
+
+void GreenhousePlant::begin(float temperature, float humidity, float soil, float hour) {
+    airTemperature = temperature;
+    absoluteHumidity = saturationDensity(temperature) * humidity / 100.0f;
+    for (float& zone : soilMoisture) {
+        zone = soil;
+    }
+    hourOfDay = hour;
+    publishSensors(0.0f);
+}
+
+// Magnus: densidad de vapor saturado en g/m³
+float GreenhousePlant::saturationDensity(float temperature) {
+    return 6.112f * expf(17.67f * temperature / (temperature + 243.5f)) * 216.74f / (273.15f + temperature);
+}
+
+float GreenhousePlant::outsideTemperature() const {
+    return params.outsideMeanTemp + params.outsideTempSwing * cosf((hourOfDay - 15.0f) * (float)PI / 12.0f);
+}
+
+// Media onda senoidal entre el orto y el ocaso
+float GreenhousePlant::irradiance() const {
+    if (hourOfDay <= params.sunriseHour || hourOfDay >= params.sunsetHour) {
+        return 0.0f;
+    }
+    float phase = (hourOfDay - params.sunriseHour) / (params.sunsetHour - params.sunriseHour);
+    return params.peakIrradiance * sinf(phase * (float)PI);
+}
+
+float GreenhousePlant::getRelativeHumidity() const {
+    return constrain(absoluteHumidity / saturationDensity(airTemperature) * 100.0f, 0.0f, 100.0f);
+}
+
+float GreenhousePlant::getSoilMoisture(uint8_t zone) const {
+    return zone < IRRIGATION_ZONE_COUNT ? soilMoisture[zone] : NAN;
+}
+
+void GreenhousePlant::step(float dt, float hour) {
+    hourOfDay = hour;
+
+    // Lo que ordenó el firmware
+    bool heaterOn = actuators->getHeater()->isRunning();
+    bool fanOn = actuators->getFan()->isRunning();
+    bool pumpOn = actuators->getWaterPump()->isRunning();
+    LEDStripActuator* led = actuators->getLEDStrip();
+    float ledFraction = led->isRunning() ? (led->supportsBrightness() ? led->getBrightness() / 255.0f : 1.0f) : 0.0f;
+    bool ventOpen = !actuators->getServo()->isClosed();
+    RelayController* valves = actuators->getValveRelays();
+    const uint8_t zoneRelays[] = {IRRIGATION_ZONE_1_RELAY, IRRIGATION_ZONE_2_RELAY};
+    bool valveOpen[IRRIGATION_ZONE_COUNT];
+    uint8_t openValves = 0;
+    for (uint8_t i = 0; i < IRRIGATION_ZONE_COUNT; i++) {
+        valveOpen[i] = i < sizeof(zoneRelays) && valves->getRelayState(zoneRelays[i] - 1);
+        openValves += valveOpen[i] ? 1 : 0;
+    }
+
+    // Renovación de aire: el ventilador domina; la ventana sola ventila por tiro natural
+    float airFlow = params.infiltrationFlow + (fanOn ? params.fanFlow : (ventOpen ? params.ventFlow : 0.0f));
+
+    // Balance térmico del aire
+    float sun = irradiance();
+    float outside = outsideTemperature();
+    float heatIn = (heaterOn ? params.heaterPower : 0.0f) + ledFraction * params.ledPower +
+                   sun * params.solarArea * params.transmittance * params.solarHeatFraction;
+    float heatOut = (params.envelopeUA + AIR_DENSITY * AIR_HEAT_CAPACITY * airFlow) * (airTemperature - outside);
+    airTemperature += (heatIn - heatOut) * dt / params.thermalCapacity;
+
+    // Vapor: transpiración frente a intercambio con el aire exterior
+    float meanSoil = 0.0f;
+    for (float zone : soilMoisture) {
+        meanSoil += zone;
+    }
+    meanSoil /= IRRIGATION_ZONE_COUNT;
+    float soilFactor = constrain(meanSoil / params.fieldCapacity, 0.0f, 1.0f);
+    float transpiration = (params.nightTranspiration +
+                           (params.peakTranspiration - params.nightTranspiration) * sun / params.peakIrradiance) *
+                          soilFactor;
+    float outsideVapour = saturationDensity(outside) * params.outsideHumidity / 100.0f;
+    absoluteHumidity += (transpiration - airFlow * (absoluteHumidity - outsideVapour)) * dt / params.airVolume;
+    absoluteHumidity = min(max(absoluteHumidity, 0.0f), saturationDensity(airTemperature));  // Condensación
+
+    // Suelo: secado por zona, riego repartido entre las válvulas abiertas
+    float water = (pumpOn && openValves > 0) ? params.pumpFlow * dt / 60.0f : 0.0f;
+    float dryingPerSecond = (params.soilDryingRate + params.soilEtRate * sun / params.peakIrradiance) / 3600.0f;
+    for (uint8_t i = 0; i < IRRIGATION_ZONE_COUNT; i++) {
+        float& zone = soilMoisture[i];
+        zone -= dryingPerSecond * dt * constrain(zone / params.fieldCapacity, 0.0f, 1.0f);
+        if (valveOpen[i] && water > 0.0f) {
+            zone += water / openValves / params.litresPerPercent;
+        }
+        // Por encima de capacidad de campo drena en minutos
+        if (zone > params.fieldCapacity) {
+            zone -= (zone - params.fieldCapacity) * min(dt / 600.0f, 1.0f);
+        }
+        zone = constrain(zone, 0.0f, 100.0f);
+    }
+
+    countCycle(CYCLE_HEATER, heaterOn);
+    countCycle(CYCLE_FAN, fanOn);
+    countCycle(CYCLE_PUMP, pumpOn);
+    countCycle(CYCLE_LED, ledFraction > 0.0f);
+    countCycle(CYCLE_VENT, ventOpen);
+    for (uint8_t i = 0; i < IRRIGATION_ZONE_COUNT && CYCLE_VALVE_1 + i < CYCLE_COUNT; i++) {
+        countCycle((Cycled)(CYCLE_VALVE_1 + i), valveOpen[i]);
+    }
+    const float watts[LOAD_COUNT] = {heaterOn ? params.heaterPower : 0.0f, fanOn ? params.fanPower : 0.0f,
+                                     pumpOn ? params.pumpPower : 0.0f, ledFraction * params.ledPower};
+    accumulate(dt, watts, water);
+
+    publishSensors(ledFraction);
+}
+
+void GreenhousePlant::countCycle(Cycled actuator, bool on) {
+    if (on && !lastOn[actuator]) {
+        today.cycles[actuator]++;
+    }
+    lastOn[actuator] = on;
+}
+
+void GreenhousePlant::accumulate(float dt, const float watts[LOAD_COUNT], float water) {
+    for (uint8_t i = 0; i < LOAD_COUNT; i++) {
+        today.energyWh[i] += watts[i] * dt / 3600.0f;
+    }
+    today.waterLitres += water;
+    today.seconds += dt;
+
+    if (fabsf(airTemperature - targets.temperature) <= TEMPERATURE_BAND) {
+        today.temperatureInBand += dt;
+    }
+    if (fabsf(getRelativeHumidity() - targets.humidity) <= HUMIDITY_BAND) {
+        today.humidityInBand += dt;
+    }
+    for (uint8_t i = 0; i < IRRIGATION_ZONE_COUNT; i++) {
+        if (soilMoisture[i] >= targets.soilMoisture - SOIL_BAND) {
+            today.soilInBand[i] += dt;
+        }
+    }
+    today.minTemperature = min(today.minTemperature, airTemperature);
+    today.maxTemperature = max(today.maxTemperature, airTemperature);
+}
+
+void GreenhousePlant::publishSensors(float ledFraction) {
+    devices->setAirConditions(airTemperature, getRelativeHumidity());
+    devices->setLight(irradiance() * params.transmittance * params.luxPerWatt + ledFraction * params.ledLux);
+
+    // Zona 1: sonda capacitiva (ADC); zona 2: sonda RS485
+    float raw = SOIL_CALIBRATION_DRY - (SOIL_CALIBRATION_DRY - SOIL_CALIBRATION_WET) * soilMoisture[0] / 100.0f;
+    devices->setSoilMoistureRaw((uint16_t)raw);
+    devices->soilProbe.setReadings(soilMoisture[IRRIGATION_ZONE_COUNT - 1], airTemperature - 2.0f, 1200, 6.5f, 40, 20, 60);
+}
+
+void GreenhousePlant::resetDay() {
+    today = DayStats();
+    today.minTemperature = airTemperature;
+    today.maxTemperature = airTemperature;
+}
@@ -0,0 +1,53 @@
+#include "native/NativeFirmware.h"
+#include "config/config.h"
+#include "config/Targets.h"
+
+#include <cstdlib>
+
+bool NativeFirmware::begin(time_t epoch, bool replay) {
+    // Hora local del firmware, no la del host
+    setenv("TZ", TIME_TIMEZONE, 1);
+    tzset();
+
+    Serial.begin(SERIAL_BAUDRATE);
+    targets.loadDefaults();
+    primaryTime.setTime(epoch);
+    clock.setPrimarySource(&primaryTime);
+    clock.setFallbackSource(&fallbackTime);
+
+    if (!actuators.begin()) {
+        Serial.println("[NativeFirmware] Error: ActuatorManager");
+        return false;
+    }
+    settings.begin();
+    if (replay) {
+        sensors.beginReplay();
+    } else if (!sensors.begin()) {
+        Serial.println("[NativeFirmware] Error: SensorManager");
+        return false;
+    }
+    if (!logic.begin(&sensors, &actuators, &blynk, &clock, &settings)) {
+        Serial.println("[NativeFirmware] Error: LogicManager");
+        return false;
+    }
+    clock.begin();
+    return true;
+}
+
+void NativeFirmware::update() {
+    clock.update();
+    settings.update();
+    sensors.update();
+    actuators.update();
+    logic.update();
+}
+
+unsigned long NativeFirmware::getIdleTime() {
+    unsigned long idle = POWER_MAX_SLEEP;
+    idle = min(idle, clock.getIdleTime());
+    idle = min(idle, settings.getIdleTime());
+    idle = min(idle, sensors.getIdleTime());
+    idle = min(idle, actuators.getIdleTime());
+    idle = min(idle, logic.getIdleTime());
+    return max(idle, (unsigned long)POWER_MIN_SLEEP);
+}
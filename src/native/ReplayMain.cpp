@@ -0,0 +1,246 @@
+// Reproducción de trazas: pio run -e native_replay && .pio/build/native_replay/program traza [decisiones.csv] [referencia.csv]
+//
+// Alimenta el firmware (lógica y actuadores reales sobre NativeHal) con una
+// traza de SensorTrace grabada en campo, sobre el reloj simulado: el
+// resultado es determinista y no depende de la velocidad del PC.
+// traza: fichero binario de LittleFS, o registro de consola con las líneas "#T ".
+// decisiones.csv: cada cambio de los actuadores (ms desde el inicio de la traza).
+// referencia.csv: decisiones de otra versión del firmware; informa de la
+// primera diferencia y termina con código 1 si no coinciden.
+
+#include <Arduino.h>
+#include <NativeHal.h>
+#include "config/config.h"
+#include "native/NativeFirmware.h"
+#include "sensors/SensorTrace.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+const time_t DEFAULT_EPOCH = 1767258000;         // 2026-01-01 09:00 UTC si la traza no trae hora
+const char* CSV_HEADER = "ms,calefactor,ventilador,bomba,leds,ventana,reles";
+
+int hexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return -1;
+}
+
+bool isHeader(const uint8_t* data, size_t length) {
+    return length >= 3 && data[0] == 'G' && data[1] == 'T' && data[2] == SensorTrace::TRACE_VERSION;
+}
+
+// Fichero binario tal cual; registro de consola: bloques de las líneas "#T " del primer arranque
+bool loadTrace(const char* path, std::vector<uint8_t>& trace) {
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        return false;
+    }
+    std::vector<uint8_t> raw;
+    uint8_t chunk[4096];
+    size_t count;
+    while ((count = fread(chunk, 1, sizeof(chunk), file)) > 0) {
+        raw.insert(raw.end(), chunk, chunk + count);
+    }
+    fclose(file);
+
+    if (isHeader(raw.data(), raw.size())) {
+        trace.swap(raw);
+        return true;
+    }
+
+    std::string text(raw.begin(), raw.end());
+    size_t position = 0;
+    while ((position = text.find("#T ", position)) != std::string::npos) {
+        position += 3;
+        std::vector<uint8_t> block;
+        while (position + 1 < text.size() && hexValue(text[position]) >= 0 && hexValue(text[position + 1]) >= 0) {
+            block.push_back((uint8_t)(hexValue(text[position]) << 4 | hexValue(text[position + 1])));
+            position += 2;
+        }
+        if (isHeader(block.data(), block.size())) {
+            if (!trace.empty()) {
+                Serial.println("[Replay] El registro sigue tras un reinicio; se reproduce solo el primer arranque");
+                break;
+            }
+        } else if (trace.empty()) {
+            continue;  // Líneas anteriores a la cabecera
+        }
+        trace.insert(trace.end(), block.begin(), block.end());
+    }
+    return !trace.empty();
+}
+
+// Hora Unix al inicio de la traza, a partir de su primer RECORD_TIME
+time_t startEpoch(const std::vector<uint8_t>& trace) {
+    SensorTrace::Reader reader;
+    SensorTrace::Record record;
+    reader.begin(trace.data(), trace.size());
+    while (reader.next(record)) {
+        if (record.type == SensorTrace::RECORD_TIME) {
+            return (time_t)record.epoch - (time_t)((record.millis - reader.getStartMillis()) / 1000);
+        }
+    }
+    return 0;
+}
+
+// Lo que ha decidido el firmware, como línea de CSV (sin el tiempo)
+std::string decisions(ActuatorManager& actuators) {
+    LEDStripActuator* led = actuators.getLEDStrip();
+    int ledLevel = led->isRunning() ? (led->supportsBrightness() ? led->getBrightness() : 255) : 0;
+    uint32_t relays = 0;
+    for (uint8_t i = 0; i < RELAY_CHANNELS; i++) {
+        relays |= actuators.getValveRelays()->getRelayState(i) ? (1u << i) : 0;
+    }
+    char line[64];
+    snprintf(line, sizeof(line), "%d,%d,%d,%d,%d,%04X", actuators.getHeater()->isRunning(),
+             actuators.getFan()->isRunning(), actuators.getWaterPump()->isRunning(), ledLevel,
+             !actuators.getServo()->isClosed(), (unsigned)relays);
+    return line;
+}
+
+std::vector<std::string> loadLines(const char* path) {
+    std::vector<std::string> lines;
+    FILE* file = fopen(path, "r");
+    if (!file) {
+        return lines;
+    }
+    char buffer[256];
+    while (fgets(buffer, sizeof(buffer), file)) {
+        buffer[strcspn(buffer, "\r\n")] = '\0';
+        if (strcmp(buffer, CSV_HEADER) != 0 && buffer[0] != '\0') {
+            lines.push_back(buffer);
+        }
+    }
+    fclose(file);
+    return lines;
+}
+
+// Primera diferencia entre dos secuencias de decisiones; 0 si coinciden
+int compare(const std::vector<std::string>& stream, const std::vector<std::string>& reference) {
+    size_t common = stream.size() < reference.size() ? stream.size() : reference.size();
+    for (size_t i = 0; i < common; i++) {
+        if (stream[i] != reference[i]) {
+            Serial.printf("[Replay] Difiere en el cambio %u:\n  esta versión: %s\n  referencia:   %s\n", (unsigned)(i + 1),
+                          stream[i].c_str(), reference[i].c_str());
+            return 1;
+        }
+    }
+    if (stream.size() != reference.size()) {
+        Serial.printf("[Replay] Mismos %u primeros cambios; esta versión tiene %u y la referencia %u\n",
+                      (unsigned)common, (unsigned)stream.size(), (unsigned)reference.size());
+        return 1;
+    }
+    Serial.printf("[Replay] Decisiones idénticas a la referencia (%u cambios)\n", (unsigned)stream.size());
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        Serial.println("Uso: program traza [decisiones.csv] [referencia.csv]");
+        return 2;
+    }
+
+    std::vector<uint8_t> trace;
+    SensorTrace::Reader reader;
+    if (!loadTrace(argv[1], trace) || !reader.begin(trace.data(), trace.size())) {
+        Serial.printf("[Replay] %s no es una traza de sensores\n", argv[1]);
+        return 2;
+    }
+    time_t epoch = startEpoch(trace);
+    if (!epoch) {
+        Serial.println("[Replay] La traza no trae hora; se usa 2026-01-01 09:00 UTC");
+        epoch = DEFAULT_EPOCH;
+    }
+
+    NativeHal::reset();
+    NativeFirmware firmware;
+    if (!firmware.begin(epoch, true)) {
+        return 1;
+    }
+    // Las trazas se graban con el control automático activo
+    firmware.logic.setAutoMode(true);
+    NativeHal::setConsoleEnabled(false);
+
+    FILE* output = argc > 2 ? fopen(argv[2], "w") : nullptr;
+    if (output) {
+        fprintf(output, "%s\n", CSV_HEADER);
+    }
+    std::vector<std::string> stream;
+    std::string last;
+
+    // millis() de la traza -> reloj simulado: el primer registro en la primera iteración
+    uint64_t offsetMicros = NativeHal::nowMicros();
+    uint32_t startMillis = reader.getStartMillis();
+    uint32_t records = 0;
+    SensorTrace::Record record;
+    bool pending = reader.next(record);
+    auto hostStart = std::chrono::steady_clock::now();
+
+    while (pending) {
+        uint64_t iterationStart = NativeHal::nowMicros();
+        uint32_t traceMillis = (uint32_t)((iterationStart - offsetMicros) / 1000);
+
+        // Lecturas de la traza que ya ocurrieron, antes del update() que las usa
+        while (pending && record.millis - startMillis <= traceMillis) {
+            if (record.type == SensorTrace::RECORD_TIME) {
+                firmware.primaryTime.setTime((time_t)record.epoch);
+            } else {
+                firmware.sensors.replayRecord(record);
+            }
+            records++;
+            pending = reader.next(record);
+        }
+
+        firmware.update();
+
+        std::string current = decisions(firmware.actuators);
+        if (current != last) {
+            last = current;
+            std::string line = std::to_string(traceMillis) + "," + current;
+            stream.push_back(line);
+            if (output) {
+                fprintf(output, "%s\n", line.c_str());
+            }
+        }
+
+        // Espera del loop, adelantada por el siguiente registro como lo haría la lectura del sensor
+        uint64_t wakeAt = NativeHal::nowMicros() + (uint64_t)firmware.getIdleTime() * 1000;
+        if (pending) {
+            uint64_t recordAt = offsetMicros + (uint64_t)(record.millis - startMillis) * 1000;
+            wakeAt = recordAt > iterationStart && recordAt < wakeAt ? recordAt : wakeAt;
+        }
+        NativeHal::advanceMicros(wakeAt > NativeHal::nowMicros() ? wakeAt - NativeHal::nowMicros() : 0);
+    }
+
+    double hostSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - hostStart).count();
+    double simulatedDays = (NativeHal::nowMicros() - offsetMicros) / 86400.0e6;
+    if (output) {
+        fclose(output);
+    }
+    NativeHal::setConsoleEnabled(true);
+    if (!reader.isAtEnd()) {
+        Serial.println("[Replay] Traza truncada: reproducida hasta el último registro completo");
+    }
+    Serial.printf("[Replay] %u registros, %.2f días en %.2f s (%.0fx tiempo real), %u cambios de actuadores\n",
+                  records, simulatedDays, hostSeconds, hostSeconds > 0 ? simulatedDays * 86400.0 / hostSeconds : 0.0,
+                  (unsigned)stream.size());
+
+    if (argc > 3) {
+        std::vector<std::string> reference = loadLines(argv[3]);
+        if (reference.empty()) {
+            Serial.printf("[Replay] No se pudo leer %s\n", argv[3]);
+            return 2;
+        }
+        return compare(stream, reference);
+    }
+    return 0;
+}
@@ -0,0 +1,169 @@
+#include "native/SimDevices.h"
+#include "config/config.h"
+#include "sensors/AS7341Sensor.h"
+#include "sensors/BH1750Sensor.h"
+
+namespace SimDevices {
+
+// ===== BH1750Model =====
+
+BH1750Model::BH1750Model() : lux(500.0f), mtreg(BH1750_MTREG_DEFAULT), powered(false), pendingMtregHigh(0) {
+}
+
+bool BH1750Model::write(const uint8_t* data, size_t length) {
+    if (length != 1) {
+        return false;
+    }
+    uint8_t command = data[0];
+    if (command == BH1750_POWER_DOWN) {
+        powered = false;
+    } else if (command == BH1750_POWER_ON || command == BH1750_RESET) {
+        powered = true;
+    } else if ((command & 0xF8) == BH1750_MTREG_HIGH) {
+        pendingMtregHigh = command & 0x07;
+    } else if ((command & 0xE0) == BH1750_MTREG_LOW) {
+        mtreg = (uint8_t)((pendingMtregHigh << 5) | (command & 0x1F));
+    } else {
+        // Cualquier modo de medición enciende el sensor
+        powered = true;
+    }
+    return true;
+}
+
+size_t BH1750Model::read(uint8_t* data, size_t length) {
+    if (length < 2) {
+        return 0;
+    }
+    // Cuentas = lux * 1.2 * MTreg / 69 (modo H-res)
+    float counts = powered ? lux * 1.2f * mtreg / BH1750_MTREG_DEFAULT : 0.0f;
+    uint16_t raw = counts >= 65535.0f ? 65535 : (uint16_t)counts;
+    data[0] = highByte(raw);
+    data[1] = lowByte(raw);
+    return 2;
+}
+
+// ===== AS7341Model =====
+
+AS7341Model::AS7341Model() : pointer(0) {
+    memset(registers, 0, sizeof(registers));
+    registers[AS7341_ID] = 0x09;
+    setIntensity(0.5f);
+}
+
+void AS7341Model::setIntensity(float intensity) {
+    intensity = constrain(intensity, 0.0f, 1.0f);
+    // Perfil espectral aproximado de luz diurna (F1-F8, Clear, NIR...)
+    static const uint16_t PROFILE[12] = {900, 1800, 2600, 3200, 1200, 600, 3500, 3300, 2900, 2500, 7000, 1500};
+    for (uint8_t i = 0; i < 12; i++) {
+        uint16_t value = (uint16_t)(PROFILE[i] * intensity) + 1;
+        registers[AS7341_CH0_DATA_L + i * 2] = lowByte(value);
+        registers[AS7341_CH0_DATA_L + i * 2 + 1] = highByte(value);
+    }
+}
+
+bool AS7341Model::write(const uint8_t* data, size_t length) {
+    if (length == 0) {
+        return false;
+    }
+    pointer = data[0];
+    for (size_t i = 1; i < length; i++) {
+        registers[pointer++] = data[i];
+    }
+    return true;
+}
+
+size_t AS7341Model::read(uint8_t* data, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        data[i] = registers[pointer++];
+    }
+    return length;
+}
+
+// ===== SoilProbeModel =====
+
+SoilProbeModel::SoilProbeModel(uint8_t deviceAddress) : address(deviceAddress), requests(0) {
+    setReadings(45.0f, 21.0f, 1200, 6.5f, 40, 20, 60);
+}
+
+void SoilProbeModel::setReadings(float moisture, float temperature, uint16_t ec, float ph, uint16_t n, uint16_t p,
+                                 uint16_t k) {
+    registers[0] = (uint16_t)lroundf(moisture * 10.0f);
+    registers[1] = (uint16_t)lroundf(temperature * 10.0f);
+    registers[2] = ec;
+    registers[3] = (uint16_t)lroundf(ph * 10.0f);
+    registers[4] = n;
+    registers[5] = p;
+    registers[6] = k;
+}
+
+void SoilProbeModel::onTransmit(HardwareSerial& port, const uint8_t* data, size_t length) {
+    if (length != 8 || data[0] != address || data[1] != 0x03) {
+        return;
+    }
+    if (crc16(data, 6) != (uint16_t)(data[6] | (data[7] << 8))) {
+        return;
+    }
+    uint16_t start = (uint16_t)((data[2] << 8) | data[3]);
+    uint16_t count = (uint16_t)((data[4] << 8) | data[5]);
+    if (start + count > 7 || count == 0) {
+        return;
+    }
+    requests++;
+
+    uint8_t response[3 + 7 * 2 + 2];
+    size_t index = 0;
+    response[index++] = address;
+    response[index++] = 0x03;
+    response[index++] = (uint8_t)(count * 2);
+    for (uint16_t i = 0; i < count; i++) {
+        response[index++] = highByte(registers[start + i]);
+        response[index++] = lowByte(registers[start + i]);
+    }
+    uint16_t crc = crc16(response, index);
+    response[index++] = lowByte(crc);
+    response[index++] = highByte(crc);
+    port.injectRx(response, index);
+}
+
+uint16_t SoilProbeModel::crc16(const uint8_t* data, size_t length) {
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < length; i++) {
+        crc ^= data[i];
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x0001) ? (uint16_t)((crc >> 1) ^ 0xA001) : (uint16_t)(crc >> 1);
+        }
+    }
+    return crc;
+}
+
+// ===== Greenhouse =====
+
+void Greenhouse::attach() {
+    NativeHal::attachI2CDevice(BH1750_DEFAULT_ADDR, &bh1750);
+    NativeHal::attachI2CDevice(AS7341_ADDR, &as7341);
+    NativeHal::attachUartPeer(2, &soilProbe);
+    setAirConditions(22.0f, 60.0f);
+    setLight(500.0f);
+    setSoilMoistureRaw(2200);
+    setWaterDistanceCm(40.0f);
+}
+
+void Greenhouse::setAirConditions(float temperature, float humidity) {
+    NativeHal::setDht22(temperature, humidity);
+}
+
+void Greenhouse::setLight(float lux) {
+    bh1750.setLux(lux);
+    as7341.setIntensity(lux / 20000.0f);
+}
+
+void Greenhouse::setSoilMoistureRaw(uint16_t adcValue) {
+    NativeHal::setAnalogValue(SOIL_MOISTURE_PIN, adcValue);
+}
+
+// Eco del HC-SR04: 58 µs por centímetro (ida y vuelta)
+void Greenhouse::setWaterDistanceCm(float centimeters) {
+    NativeHal::setPulseWidth(HCSR04_ECHO_PIN, (unsigned long)(centimeters * 58.0f));
+}
+
+} // namespace SimDevices
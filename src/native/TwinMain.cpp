@@ -0,0 +1,213 @@
+// Gemelo digital: pio run -e native_twin && .pio/build/native_twin/program [días] [velocidad] [traza_min] [fichero]
+//
+// El firmware (sensores, actuadores y lógica reales sobre NativeHal) controla
+// el modelo físico de GreenhousePlant en lazo cerrado. Por cada día simulado
+// informa de energía, agua, tiempo en banda y ciclos de cada actuador; al
+// final, los despertares del loop por hora (espera adaptativa de main.cpp).
+// velocidad: veces el tiempo real (1000 por defecto; 0 = sin límite).
+// traza_min: una línea de estado cada tantos minutos simulados (0 = sin traza).
+// fichero: graba las lecturas en una SensorTrace, reproducible con native_replay.
+
+#include <Arduino.h>
+#include <NativeHal.h>
+#include "config/config.h"
+#include "config/Targets.h"
+#include "native/GreenhousePlant.h"
+#include "native/NativeFirmware.h"
+#include "native/SimDevices.h"
+#include "sensors/SensorTrace.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+namespace {
+
+const uint32_t DEFAULT_DAYS = 3;
+const float DEFAULT_SPEED = 1000.0f;
+const time_t START_EPOCH = 1775512800;           // 2026-04-07 00:00 CEST (medianoche local)
+const uint32_t SECONDS_PER_DAY = 86400;
+
+// Print sobre un fichero del host (el File de LittleFS en el ESP32)
+class FilePrint : public Print {
+private:
+    FILE* file;
+
+public:
+    explicit FilePrint(FILE* output) : file(output) {}
+    size_t write(uint8_t c) override { return fputc(c, file) == EOF ? 0 : 1; }
+    size_t write(const uint8_t* buffer, size_t size) override { return fwrite(buffer, 1, size, file); }
+    void flush() override { fflush(file); }
+};
+
+float localHour(uint64_t simMicros) {
+    time_t now = START_EPOCH + (time_t)(simMicros / 1000000);
+    struct tm local;
+    localtime_r(&now, &local);
+    return local.tm_hour + local.tm_min / 60.0f + local.tm_sec / 3600.0f;
+}
+
+float percent(float part, float total) {
+    return total > 0.0f ? part * 100.0f / total : 0.0f;
+}
+
+void printTrace(float hour, const GreenhousePlant& plant, NativeFirmware& firmware) {
+    ActuatorManager& actuators = firmware.actuators;
+    Serial.printf("[Twin] %05.2f h  %5.1f C %5.1f %%HR %6.0f W/m2  suelo", hour, plant.getAirTemperature(),
+                  plant.getRelativeHumidity(), plant.getIrradiance());
+    for (uint8_t i = 0; i < IRRIGATION_ZONE_COUNT; i++) {
+        Serial.printf(" %4.1f", plant.getSoilMoisture(i));
+    }
+    Serial.printf("  | DHT %5.1f C %5.1f %%HR  | calef %d vent %d bomba %d LEDs %d ventana %d\n",
+                  firmware.sensors.getTemperature(), firmware.sensors.getHumidity(),
+                  actuators.getHeater()->isRunning(), actuators.getFan()->isRunning(),
+                  actuators.getWaterPump()->isRunning(), actuators.getLEDStrip()->isRunning(),
+                  !actuators.getServo()->isClosed());
+}
+
+void printDay(const char* label, const GreenhousePlant::DayStats& stats) {
+    using Plant = GreenhousePlant;
+    float totalWh = 0.0f;
+    for (float energy : stats.energyWh) {
+        totalWh += energy;
+    }
+    Serial.printf("%3s %7.2f %6.2f %6.2f %6.2f %6.2f %7.1f | %5.1f %5.1f", label, totalWh / 1000.0f,
+                  stats.energyWh[Plant::LOAD_HEATER] / 1000.0f, stats.energyWh[Plant::LOAD_FAN] / 1000.0f,
+                  stats.energyWh[Plant::LOAD_PUMP] / 1000.0f, stats.energyWh[Plant::LOAD_LED] / 1000.0f,
+                  stats.waterLitres, percent(stats.temperatureInBand, stats.seconds),
+                  percent(stats.humidityInBand, stats.seconds));
+    for (float soil : stats.soilInBand) {
+        Serial.printf(" %5.1f", percent(soil, stats.seconds));
+    }
+    Serial.printf(" | %5.1f %5.1f |", stats.minTemperature, stats.maxTemperature);
+    for (uint32_t cycles : stats.cycles) {
+        Serial.printf(" %4u", cycles);
+    }
+    Serial.println();
+}
+
+void printHeader() {
+    Serial.printf("\n=== Gemelo digital: objetivos %.1f C ±%.1f, %.0f %%HR ±%.0f, suelo >= %.0f %% ===\n",
+                  targets.temperature, GreenhousePlant::TEMPERATURE_BAND, targets.humidity,
+                  GreenhousePlant::HUMIDITY_BAND, targets.soilMoisture - GreenhousePlant::SOIL_BAND);
+    Serial.printf("día  energía  calef  vent.  bomba   LEDs    agua | %%banda T    HR");
+    for (uint8_t i = 0; i < IRRIGATION_ZONE_COUNT; i++) {
+        Serial.printf("    Z%u", i + 1);
+    }
+    Serial.println(" | T mín T máx | ciclos calef vent bomba LEDs vent. Z1 Z2");
+    Serial.println("       kWh    kWh    kWh    kWh    kWh       L |");
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    uint32_t days = argc > 1 ? (uint32_t)strtoul(argv[1], nullptr, 10) : DEFAULT_DAYS;
+    float speed = argc > 2 ? strtof(argv[2], nullptr) : DEFAULT_SPEED;
+    uint32_t traceMinutes = argc > 3 ? (uint32_t)strtoul(argv[3], nullptr, 10) : 0;
+    FILE* traceFile = argc > 4 ? fopen(argv[4], "wb") : nullptr;
+    if (argc > 4 && !traceFile) {
+        Serial.printf("[Twin] No se pudo crear %s\n", argv[4]);
+        return 1;
+    }
+
+    NativeHal::reset();
+    SimDevices::Greenhouse greenhouse;
+    greenhouse.attach();
+
+    NativeFirmware firmware;
+    GreenhousePlant plant(greenhouse, firmware.actuators);
+    // Sensores con valores físicos antes del arranque (primera lectura de cada driver)
+    plant.begin(16.0f, 70.0f, 35.0f, localHour(0));
+    if (!firmware.begin(START_EPOCH)) {
+        return 1;
+    }
+    firmware.logic.setAutoMode(true);
+    plant.resetDay();
+
+    FilePrint traceOutput(traceFile);
+    SensorTrace::Recorder recorder;
+    if (traceFile) {
+        recorder.begin(traceOutput, false, 0);
+        firmware.sensors.setTraceRecorder(&recorder);
+    }
+
+    NativeHal::setConsoleEnabled(false);
+    auto hostStart = std::chrono::steady_clock::now();
+    uint64_t simStart = NativeHal::nowMicros();
+    uint64_t lastStep = simStart;
+    uint64_t lastTrace = simStart;
+    uint32_t day = 1;
+    uint64_t wakes = 0;
+    GreenhousePlant::DayStats totals = {};
+    bool headerPrinted = false;
+
+    while (day <= days) {
+        firmware.update();
+        recorder.clock(firmware.clock.now());
+        // Como PowerManager::sleep(): hasta el próximo trabajo de algún subsistema
+        NativeHal::advanceMicros((uint64_t)firmware.getIdleTime() * 1000);
+        wakes++;
+
+        uint64_t now = NativeHal::nowMicros();
+        plant.step((now - lastStep) / 1e6f, localHour(now - simStart));
+        lastStep = now;
+
+        if (traceMinutes > 0 && now - lastTrace >= (uint64_t)traceMinutes * 60000000) {
+            lastTrace = now;
+            NativeHal::setConsoleEnabled(true);
+            printTrace(localHour(now - simStart), plant, firmware);
+            NativeHal::setConsoleEnabled(false);
+        }
+
+        // Ritmo: la simulación no adelanta al reloj del host más que speed veces
+        if (speed > 0.0f) {
+            auto due = hostStart + std::chrono::microseconds((uint64_t)((now - simStart) / speed));
+            std::this_thread::sleep_until(due);
+        }
+
+        if (now - simStart >= (uint64_t)day * SECONDS_PER_DAY * 1000000) {
+            NativeHal::setConsoleEnabled(true);
+            if (!headerPrinted) {
+                printHeader();
+                headerPrinted = true;
+            }
+            const GreenhousePlant::DayStats& stats = plant.getDayStats();
+            printDay(String(day).c_str(), stats);
+            for (uint8_t i = 0; i < GreenhousePlant::LOAD_COUNT; i++) {
+                totals.energyWh[i] += stats.energyWh[i];
+            }
+            totals.waterLitres += stats.waterLitres;
+            totals.seconds += stats.seconds;
+            totals.temperatureInBand += stats.temperatureInBand;
+            totals.humidityInBand += stats.humidityInBand;
+            for (uint8_t i = 0; i < IRRIGATION_ZONE_COUNT; i++) {
+                totals.soilInBand[i] += stats.soilInBand[i];
+            }
+            for (uint8_t i = 0; i < GreenhousePlant::CYCLE_COUNT; i++) {
+                totals.cycles[i] += stats.cycles[i];
+            }
+            totals.minTemperature = day == 1 ? stats.minTemperature : min(totals.minTemperature, stats.minTemperature);
+            totals.maxTemperature = day == 1 ? stats.maxTemperature : max(totals.maxTemperature, stats.maxTemperature);
+            plant.resetDay();
+            NativeHal::setConsoleEnabled(false);
+            day++;
+        }
+    }
+
+    NativeHal::setConsoleEnabled(true);
+    if (days > 1) {
+        printDay("tot", totals);
+    }
+    double hostSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - hostStart).count();
+    Serial.printf("%u días simulados en %.1f s (%.0fx tiempo real)\n", days, hostSeconds,
+                  hostSeconds > 0 ? days * (double)SECONDS_PER_DAY / hostSeconds : 0.0);
+    Serial.printf("Loop: %.0f despertares por hora (36000 con una espera fija de 100 ms)\n",
+                  wakes * 3600.0e6 / (double)(NativeHal::nowMicros() - simStart));
+    if (traceFile) {
+        Serial.printf("Traza de sensores: %u bytes en %s\n", (unsigned)recorder.getBytesWritten(), argv[4]);
+        fclose(traceFile);
+    }
+    Serial.flush();
+    return 0;
+}
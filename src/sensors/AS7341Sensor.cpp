@@ -1,9 +1,11 @@
 #include "sensors/AS7341Sensor.h"
 #include "config/config.h"
 #include <Arduino.h>
-#include <Wire.h>
 
-AS7341Sensor::AS7341Sensor() {
+// Tras la integración, margen para que el sensor publique los canales
+static const unsigned long AS7341_DATA_MARGIN = 20;
+
+AS7341Sensor::AS7341Sensor(I2CBus& i2cBus) : bus(&i2cBus), busDevice(I2CBus::NO_DEVICE), readPending(false) {
     // Inicializar variables
     for (int i = 0; i < 12; i++) {
         spectralData[i] = 0;
@@ -22,6 +24,7 @@ AS7341Sensor::AS7341Sensor() {
     
     lastReading = 0;
     readInterval = AS7341_READ_INTERVAL;
+    readyAt = 0;
     isInitialized = false;
     lastReadValid = false;
     currentSample = 0;
@@ -38,8 +41,12 @@ AS7341Sensor::~AS7341Sensor() {
 }
 
 bool AS7341Sensor::begin() {
-    // Inicializar I2C
-    Wire.begin(AS7341_SDA_PIN, AS7341_SCL_PIN);
+    // Registrar el sensor en el bus compartido
+    bus->begin();
+    busDevice = bus->addDevice("as7341", AS7341_ADDR);
+    if (busDevice == I2CBus::NO_DEVICE) {
+        return false;
+    }
     
     // Verificar si el dispositivo está presente
     if (!checkDevice()) {
@@ -53,13 +60,11 @@ bool AS7341Sensor::begin() {
     writeRegister(AS7341_ASTEP_H, 0x03);
     writeRegister(AS7341_CFG1, currentGain); // Configurar ganancia
     
-    delay(100); // Tiempo de estabilización
+    // Estabilización sin bloquear: la primera lectura la hace el loop
+    readyAt = millis() + AS7341_WARMUP_TIME;
     
     isInitialized = true;
     
-    // Hacer primera lectura para inicializar
-    readSensor();
-    
     return true;
 }
 
@@ -68,20 +73,33 @@ bool AS7341Sensor::readSensor() {
         return false;
     }
     
-    // Iniciar medición
-    writeRegister(AS7341_ENABLE, 0x03); // Habilitar sensor y medición
-    
-    // Esperar a que termine la medición (simplificado)
-    delay(200);
+    // Iniciar medición y leer los canales cuando termine la integración,
+    // sin parar el loop mientras tanto
+    if (!readPending) {
+        const uint8_t start[] = {AS7341_ENABLE, 0x03}; // Habilitar sensor y medición
+        const uint8_t channels[] = {AS7341_CH0_DATA_L};
+        if (bus->submit(busDevice, start, sizeof(start), 0, 0, nullptr, nullptr)) {
+            readPending = bus->submit(busDevice, channels, sizeof(channels), 24,
+                                      getIntegrationTimeMs() + AS7341_DATA_MARGIN, onSpectralData, this);
+        }
+    }
     
-    // Leer canales espectrales
-    uint8_t buffer[24]; // 12 canales * 2 bytes
-    if (!readMultipleRegisters(AS7341_CH0_DATA_L, buffer, 24)) {
+    return lastReadValid;
+}
+
+void AS7341Sensor::onSpectralData(void* context, bool ok, const uint8_t* data, uint8_t length) {
+    AS7341Sensor* sensor = static_cast<AS7341Sensor*>(context);
+    sensor->readPending = false;
+    sensor->processSpectralData(data, ok && length == 24);
+}
+
+bool AS7341Sensor::processSpectralData(const uint8_t* buffer, bool ok) {
+    if (!ok) {
         lastReadValid = false;
         return false;
     }
     
-    // Convertir bytes a valores de 16 bits
+    // Convertir bytes a valores de 16 bits (12 canales * 2 bytes)
     for (int i = 0; i < 12; i++) {
         spectralData[i] = buffer[i*2] | (buffer[i*2 + 1] << 8);
     }
@@ -115,6 +133,21 @@ bool AS7341Sensor::isDataValid() {
     return lastReadValid && isInitialized;
 }
 
+// cppcheck-suppress unusedFunction
+void AS7341Sensor::replayReading(bool valid, const float* fields) {
+    isInitialized = true;
+    lastReadValid = valid;
+    if (valid) {
+        // F1-F8 en los canales 0-7, clear y NIR en 10 y 11 (como updateFloatValues)
+        static const uint8_t CHANNELS[10] = {0, 1, 2, 3, 4, 5, 6, 7, 10, 11};
+        for (uint8_t i = 0; i < 10; i++) {
+            spectralData[CHANNELS[i]] = (uint16_t)fields[i];
+        }
+        updateFloatValues();
+        lastReading = millis();
+    }
+}
+
 // Getters para canales específicos
 // cppcheck-suppress unusedFunction
 float AS7341Sensor::getViolet() { return violetReading; }
@@ -205,6 +238,12 @@ bool AS7341Sensor::setIntegrationTime(uint16_t time) {
     return false;
 }
 
+// (ATIME + 1) * (ASTEP + 1) * 2.78 µs
+unsigned long AS7341Sensor::getIntegrationTimeMs() const {
+    const uint32_t astep = 999;
+    return (unsigned long)((currentIntegrationTime + 1) * (astep + 1) * 278UL / 100000UL) + 1;
+}
+
 // cppcheck-suppress unusedFunction
 bool AS7341Sensor::isReady() {
     return isInitialized;
@@ -219,9 +258,21 @@ unsigned long AS7341Sensor::getTimeSinceLastReading() {
 
 // cppcheck-suppress unusedFunction
 bool AS7341Sensor::shouldRead() {
+    // Nothing to read until the warm-up started by begin() is over
+    if ((long)(millis() - readyAt) < 0) {
+        return false;
+    }
     return getTimeSinceLastReading() >= readInterval;
 }
 
+// cppcheck-suppress unusedFunction
+unsigned long AS7341Sensor::getIdleTime() {
+    unsigned long since = getTimeSinceLastReading();
+    unsigned long wait = since >= readInterval ? 0 : readInterval - since;
+    long warmUp = (long)(readyAt - millis());
+    return warmUp > (long)wait ? (unsigned long)warmUp : wait;
+}
+
 void AS7341Sensor::resetSamples() {
     for (int i = 0; i < 12; i++) {
         for (int j = 0; j < SAMPLES_COUNT; j++) {
@@ -299,54 +350,30 @@ void AS7341Sensor::updateFloatValues() {
 
 // Comunicación I2C
 bool AS7341Sensor::writeRegister(uint8_t reg, uint8_t value) {
-    Wire.beginTransmission(AS7341_ADDR);
-    Wire.write(reg);
-    Wire.write(value);
-    return Wire.endTransmission() == 0;
+    const uint8_t command[] = {reg, value};
+    return bus->transfer(busDevice, command, sizeof(command), nullptr, 0);
 }
 
 uint8_t AS7341Sensor::readRegister(uint8_t reg) {
-    Wire.beginTransmission(AS7341_ADDR);
-    Wire.write(reg);
-    Wire.endTransmission();
-    
-    Wire.requestFrom((uint8_t)AS7341_ADDR, (uint8_t)1);
-    if (Wire.available()) {
-        return Wire.read();
+    uint8_t value = 0;
+    if (!bus->transfer(busDevice, &reg, 1, &value, 1)) {
+        return 0;
     }
-    return 0;
+    return value;
 }
 
 // cppcheck-suppress unusedFunction
 uint16_t AS7341Sensor::readRegister16(uint8_t reg) {
-    Wire.beginTransmission(AS7341_ADDR);
-    Wire.write(reg);
-    Wire.endTransmission();
-    
-    Wire.requestFrom((uint8_t)AS7341_ADDR, (uint8_t)2);
-    if (Wire.available() >= 2) {
-        uint8_t low = Wire.read();
-        uint8_t high = Wire.read();
-        return low | (high << 8);
+    uint8_t buffer[2];
+    if (!bus->transfer(busDevice, &reg, 1, buffer, 2)) {
+        return 0;
     }
-    return 0;
+    return buffer[0] | (buffer[1] << 8);
 }
 
+// cppcheck-suppress unusedFunction
 bool AS7341Sensor::readMultipleRegisters(uint8_t reg, uint8_t* buffer, uint8_t length) {
-    Wire.beginTransmission(AS7341_ADDR);
-    Wire.write(reg);
-    Wire.endTransmission();
-    
-    Wire.requestFrom((uint8_t)AS7341_ADDR, length);
-    
-    for (uint8_t i = 0; i < length; i++) {
-        if (Wire.available()) {
-            buffer[i] = Wire.read();
-        } else {
-            return false;
-        }
-    }
-    return true;
+    return bus->transfer(busDevice, &reg, 1, buffer, length);
 }
 
 bool AS7341Sensor::checkDevice() {
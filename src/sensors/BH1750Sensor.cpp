@@ -1,28 +1,20 @@
 #include "sensors/BH1750Sensor.h"
 #include "config/config.h"
 #include <Arduino.h>
-#include <Wire.h>
 
-BH1750Sensor::BH1750Sensor() 
-    : deviceAddress(BH1750_DEFAULT_ADDR)
-    , currentMode(BH1750_CONT_HIGH_RES)
-    , luxValue(0.0)
-    , currentSample(0)
-    , lastReading(0)
-    , readInterval(BH1750_READ_INTERVAL)
-    , isInitialized(false)
-    , lastReadValid(false)
-{
-    resetSamples();
-}
-
-BH1750Sensor::BH1750Sensor(uint8_t address) 
-    : deviceAddress(address)
+BH1750Sensor::BH1750Sensor(I2CBus& i2cBus, uint8_t address) 
+    : bus(&i2cBus)
+    , busDevice(I2CBus::NO_DEVICE)
+    , readPending(false)
+    , deviceAddress(address)
     , currentMode(BH1750_CONT_HIGH_RES)
+    , measurementTimeReg(BH1750_MTREG_DEFAULT)
+    , autoMeasurementTime(BH1750_AUTO_MTREG)
     , luxValue(0.0)
     , currentSample(0)
     , lastReading(0)
     , readInterval(BH1750_READ_INTERVAL)
+    , readyAt(0)
     , isInitialized(false)
     , lastReadValid(false)
 {
@@ -40,8 +32,12 @@ bool BH1750Sensor::begin() {
 }
 
 bool BH1750Sensor::begin(uint8_t mode) {
-    // Inicializar I2C si no está inicializado
-    Wire.begin(BH1750_SDA_PIN, BH1750_SCL_PIN);
+    // Registrar el sensor en el bus compartido
+    bus->begin();
+    busDevice = bus->addDevice("bh1750", deviceAddress);
+    if (busDevice == I2CBus::NO_DEVICE) {
+        return false;
+    }
     
     // Verificar conexión
     if (!checkConnection()) {
@@ -55,21 +51,28 @@ bool BH1750Sensor::begin(uint8_t mode) {
         return false;
     }
     
+    // MTreg conocido: un reset del ESP32 no reinicia el sensor
+    if (!writeMeasurementTime(measurementTimeReg)) {
+        Serial.println("BH1750: Error al configurar MTreg");
+        return false;
+    }
+    
     // Configurar modo
     if (!setMode(mode)) {
         Serial.println("BH1750: Error al configurar modo");
         return false;
     }
     
-    // Esperar tiempo de estabilización
-    delay(200);
+    // Estabilización sin bloquear: la primera lectura la hace el loop
+    unsigned long warmedUpAt = millis() + BH1750_WARMUP_TIME;
+    if ((long)(warmedUpAt - readyAt) > 0) {
+        readyAt = warmedUpAt;
+    }
     
     isInitialized = true;
     
-    // Hacer primera lectura para inicializar
-    readSensor();
-    
-    Serial.printf("BH1750: Inicializado en dirección 0x%02X, modo 0x%02X\\n", deviceAddress, currentMode);
+    Serial.printf("BH1750: Inicializado en dirección 0x%02X, modo 0x%02X, MTreg %u\\n", deviceAddress, currentMode,
+                  measurementTimeReg);
     return true;
 }
 
@@ -78,9 +81,61 @@ bool BH1750Sensor::readSensor() {
         return false;
     }
     
-    // Leer valor raw del sensor
-    uint16_t rawValue = readRawValue();
+    if (!readPending) {
+        if (isContinuousMode()) {
+            // El sensor convierte sin parar: basta con leer los 2 bytes del último resultado
+            readPending = bus->submit(busDevice, nullptr, 0, 2, 0, onRawValue, this);
+        } else if (bus->submit(busDevice, &currentMode, 1, 0, 0, nullptr, nullptr)) {
+            // Una medición: se lanza y se lee cuando está garantizada
+            readPending = bus->submit(busDevice, nullptr, 0, 2, getMeasurementTime(currentMode), onRawValue, this);
+        }
+    }
+    
+    return lastReadValid;
+}
+
+void BH1750Sensor::onRawValue(void* context, bool ok, const uint8_t* data, uint8_t length) {
+    BH1750Sensor* sensor = static_cast<BH1750Sensor*>(context);
+    sensor->readPending = false;
+    if (!ok || length != 2) {
+        sensor->processRawValue(0xFFFF);
+        return;
+    }
+    
+    uint16_t rawValue = (uint16_t)((data[0] << 8) | data[1]);
+    sensor->processRawValue(rawValue);
     
+    // La siguiente conversión completa del modo continuo
+    if (sensor->isContinuousMode()) {
+        sensor->readyAt = millis() + sensor->getMeasurementTime(sensor->currentMode);
+    }
+    if (sensor->autoMeasurementTime) {
+        sensor->adjustMeasurementTime(rawValue);
+    }
+}
+
+// Escala MTreg cuando la lectura (llevada a MTreg por defecto) cae en un extremo:
+// máxima sensibilidad con poca luz, mínima antes de saturar, y vuelta al valor
+// por defecto con histéresis de un factor 2
+void BH1750Sensor::adjustMeasurementTime(uint16_t rawValue) {
+    uint32_t equivalent = (uint32_t)rawValue * BH1750_MTREG_DEFAULT / measurementTimeReg;
+    uint8_t target = measurementTimeReg;
+    
+    if (equivalent < BH1750_AUTO_MTREG_DARK_RAW) {
+        target = BH1750_MTREG_MAX;
+    } else if (equivalent > BH1750_AUTO_MTREG_BRIGHT_RAW) {
+        target = BH1750_MTREG_MIN;
+    } else if ((measurementTimeReg == BH1750_MTREG_MAX && equivalent >= 2UL * BH1750_AUTO_MTREG_DARK_RAW) ||
+               (measurementTimeReg == BH1750_MTREG_MIN && equivalent <= BH1750_AUTO_MTREG_BRIGHT_RAW / 2)) {
+        target = BH1750_MTREG_DEFAULT;
+    }
+    
+    if (target != measurementTimeReg && setMeasurementTime(target)) {
+        Serial.printf("[BH1750] MTreg %u (%lu cuentas equivalentes)\n", target, (unsigned long)equivalent);
+    }
+}
+
+bool BH1750Sensor::processRawValue(uint16_t rawValue) {
     if (rawValue == 0xFFFF) {
         // Error en la lectura
         lastReadValid = false;
@@ -113,6 +168,16 @@ bool BH1750Sensor::isDataValid() {
     return lastReadValid && isInitialized;
 }
 
+// cppcheck-suppress unusedFunction
+void BH1750Sensor::replayReading(bool valid, const float* fields) {
+    isInitialized = true;
+    lastReadValid = valid;
+    if (valid) {
+        luxValue = fields[0];
+        lastReading = millis();
+    }
+}
+
 // cppcheck-suppress unusedFunction
 float BH1750Sensor::getLux() {
     return luxValue;
@@ -179,8 +244,8 @@ bool BH1750Sensor::setMode(uint8_t mode) {
         if (writeCommand(mode)) {
             currentMode = mode;
             
-            // Esperar tiempo de medición
-            delay(getMeasurementTime(mode));
+            // Primera medición del nuevo modo: sin esperar, shouldRead() no lee antes
+            readyAt = millis() + getMeasurementTime(mode);
             
             return true;
         }
@@ -188,9 +253,44 @@ bool BH1750Sensor::setMode(uint8_t mode) {
     return false;
 }
 
+bool BH1750Sensor::setMeasurementTime(uint8_t mtreg) {
+    if (!writeMeasurementTime(mtreg)) {
+        return false;
+    }
+    
+    // Reiniciar la conversión: la siguiente ya usa el nuevo tiempo
+    return setMode(currentMode);
+}
+
+bool BH1750Sensor::writeMeasurementTime(uint8_t mtreg) {
+    if (mtreg < BH1750_MTREG_MIN || mtreg > BH1750_MTREG_MAX) {
+        return false;
+    }
+    if (!writeCommand(BH1750_MTREG_HIGH | (mtreg >> 5)) || !writeCommand(BH1750_MTREG_LOW | (mtreg & 0x1F))) {
+        return false;
+    }
+    measurementTimeReg = mtreg;
+    return true;
+}
+
+// cppcheck-suppress unusedFunction
+void BH1750Sensor::setAutoMeasurementTime(bool enabled) {
+    autoMeasurementTime = enabled;
+}
+
+// cppcheck-suppress unusedFunction
+uint8_t BH1750Sensor::getMeasurementTimeRegister() {
+    return measurementTimeReg;
+}
+
+bool BH1750Sensor::isContinuousMode() const {
+    return currentMode == BH1750_CONT_HIGH_RES || currentMode == BH1750_CONT_HIGH_RES2 ||
+           currentMode == BH1750_CONT_LOW_RES;
+}
+
 // cppcheck-suppress unusedFunction
 bool BH1750Sensor::setAddress(uint8_t address) {
-    if (address == BH1750_DEFAULT_ADDR || address == BH1750_ALT_ADDR) {
+    if (!isInitialized && (address == BH1750_DEFAULT_ADDR || address == BH1750_ALT_ADDR)) {
         deviceAddress = address;
         return true;
     }
@@ -224,9 +324,21 @@ unsigned long BH1750Sensor::getTimeSinceLastReading() {
 
 // cppcheck-suppress unusedFunction
 bool BH1750Sensor::shouldRead() {
+    // Nothing to read until the warm-up started by begin() is over
+    if ((long)(millis() - readyAt) < 0) {
+        return false;
+    }
     return getTimeSinceLastReading() >= readInterval;
 }
 
+// cppcheck-suppress unusedFunction
+unsigned long BH1750Sensor::getIdleTime() {
+    unsigned long since = getTimeSinceLastReading();
+    unsigned long wait = since >= readInterval ? 0 : readInterval - since;
+    long warmUp = (long)(readyAt - millis());
+    return warmUp > (long)wait ? (unsigned long)warmUp : wait;
+}
+
 // cppcheck-suppress unusedFunction
 void BH1750Sensor::printLightData() {
     if (!isDataValid()) {
@@ -239,11 +351,11 @@ void BH1750Sensor::printLightData() {
     Serial.printf("Nivel: %s\\n", getLightLevel().c_str());
     Serial.printf("Dirección I2C: 0x%02X\\n", deviceAddress);
     Serial.printf("Modo actual: 0x%02X\\n", currentMode);
+    Serial.printf("MTreg: %u\\n", measurementTimeReg);
 }
 
 bool BH1750Sensor::checkConnection() {
-    Wire.beginTransmission(deviceAddress);
-    return Wire.endTransmission() == 0;
+    return bus->transfer(busDevice, nullptr, 0, nullptr, 0);
 }
 
 float BH1750Sensor::calculateAverage(const float samples[], int count) {
@@ -277,18 +389,13 @@ void BH1750Sensor::resetSamples() {
 }
 
 bool BH1750Sensor::writeCommand(uint8_t command) {
-    Wire.beginTransmission(deviceAddress);
-    Wire.write(command);
-    return Wire.endTransmission() == 0;
+    return bus->transfer(busDevice, &command, 1, nullptr, 0);
 }
 
 uint16_t BH1750Sensor::readRawValue() {
-    Wire.requestFrom(deviceAddress, (uint8_t)2);
-    
-    if (Wire.available() >= 2) {
-        uint8_t high = Wire.read();
-        uint8_t low = Wire.read();
-        return (high << 8) | low;
+    uint8_t buffer[2];
+    if (bus->transfer(busDevice, nullptr, 0, buffer, 2)) {
+        return (buffer[0] << 8) | buffer[1];
     }
     
     return 0xFFFF;  // Error
@@ -318,22 +425,29 @@ float BH1750Sensor::convertToLux(uint16_t rawValue) {
             break;
     }
     
-    return lux;
+    // Las cuentas crecen con MTreg: referidas al valor por defecto
+    return lux * BH1750_MTREG_DEFAULT / measurementTimeReg;
 }
 
+// Tiempo máximo de conversión, proporcional a MTreg (redondeado hacia arriba)
 unsigned long BH1750Sensor::getMeasurementTime(uint8_t mode) {
+    unsigned long baseTime;
     switch (mode) {
         case BH1750_CONT_HIGH_RES:
         case BH1750_CONT_HIGH_RES2:
         case BH1750_ONE_HIGH_RES:
         case BH1750_ONE_HIGH_RES2:
-            return 180;  // 180ms para alta resolución
+            baseTime = 180;  // 180ms para alta resolución
+            break;
             
         case BH1750_CONT_LOW_RES:
         case BH1750_ONE_LOW_RES:
-            return 24;   // 24ms para baja resolución
+            baseTime = 24;   // 24ms para baja resolución
+            break;
             
         default:
-            return 180;  // Por defecto
+            baseTime = 180;  // Por defecto
+            break;
     }
+    return (baseTime * measurementTimeReg + BH1750_MTREG_DEFAULT - 1) / BH1750_MTREG_DEFAULT;
 }
@@ -0,0 +1,103 @@
+#include "sensors/DHT22Decoder.h"
+
+namespace DHT22Decoder {
+
+namespace {
+
+// Adjacent entries with the same level (RMT item boundaries) are one pulse
+class PulseReader {
+private:
+    const Level* levels;
+    size_t count;
+    size_t index;
+
+public:
+    PulseReader(const Level* levels, size_t count) : levels(levels), count(count), index(0) {}
+
+    bool next(bool& high, uint32_t& micros) {
+        while (index < count && levels[index].micros == 0) {
+            index++;
+        }
+        if (index >= count) {
+            return false;
+        }
+        high = levels[index].high;
+        micros = 0;
+        while (index < count && (levels[index].high == high || levels[index].micros == 0)) {
+            micros += levels[index].micros;
+            index++;
+        }
+        return true;
+    }
+};
+
+bool inRange(uint32_t micros, uint16_t min, uint16_t max) {
+    return micros >= min && micros <= max;
+}
+
+} // namespace
+
+Result decode(const Level* levels, size_t count, Reading& reading) {
+    PulseReader reader(levels, count);
+    bool high = false;
+    uint32_t micros = 0;
+
+    // Skip the host start signal until the 80 µs low + 80 µs high response
+    bool responded = false;
+    uint32_t previousLow = 0;
+    while (reader.next(high, micros)) {
+        if (!high) {
+            previousLow = micros;
+            continue;
+        }
+        if (inRange(previousLow, RESPONSE_MIN_US, RESPONSE_MAX_US) &&
+            inRange(micros, RESPONSE_MIN_US, RESPONSE_MAX_US)) {
+            responded = true;
+            break;
+        }
+        previousLow = 0;
+    }
+    if (!responded) {
+        return RESULT_NO_RESPONSE;
+    }
+
+    uint8_t bytes[5] = {0, 0, 0, 0, 0};
+    for (uint8_t bit = 0; bit < 40; bit++) {
+        if (!reader.next(high, micros)) {
+            return RESULT_TRUNCATED;
+        }
+        if (high || !inRange(micros, BIT_LOW_MIN_US, BIT_LOW_MAX_US)) {
+            return RESULT_BAD_TIMING;
+        }
+        if (!reader.next(high, micros)) {
+            return RESULT_TRUNCATED;
+        }
+        // The last bit's high ends at the sensor's final low; nothing else is needed after it
+        if (!high || !inRange(micros, BIT_HIGH_MIN_US, BIT_HIGH_MAX_US)) {
+            return RESULT_BAD_TIMING;
+        }
+        bytes[bit / 8] = (uint8_t)((bytes[bit / 8] << 1) | (micros > BIT_ONE_THRESHOLD_US ? 1 : 0));
+    }
+
+    if ((uint8_t)(bytes[0] + bytes[1] + bytes[2] + bytes[3]) != bytes[4]) {
+        return RESULT_CHECKSUM;
+    }
+
+    reading.humidity = ((bytes[0] << 8) | bytes[1]) * 0.1f;
+    float temperature = (((bytes[2] & 0x7F) << 8) | bytes[3]) * 0.1f;
+    reading.temperature = (bytes[2] & 0x80) ? -temperature : temperature;
+    return RESULT_OK;
+}
+
+const char* resultName(Result result) {
+    switch (result) {
+        case RESULT_OK:          return "ok";
+        case RESULT_NO_RESPONSE: return "no_response";
+        case RESULT_TRUNCATED:   return "truncated";
+        case RESULT_BAD_TIMING:  return "bad_timing";
+        case RESULT_CHECKSUM:    return "checksum";
+        default:                 return "unknown";
+    }
+}
+
+} // namespace DHT22Decoder
@@ -1,13 +1,25 @@
 #include "sensors/DHT22Sensor.h"
 #include "config/config.h"
+#include <driver/rmt.h>
+
+static const rmt_channel_t DHT22_RMT = (rmt_channel_t)DHT22_RMT_CHANNEL;
 
 DHT22Sensor::DHT22Sensor(uint8_t dataPin) : pin(dataPin) {
     dht = new DHT(pin, DHT22);
+    rmtBuffer = nullptr;
+    startTimer = nullptr;
+    capturePending = false;
+    captureStartedAt = 0;
+    lastTransaction = 0;
+    lastDecodeResult = DHT22Decoder::RESULT_OK;
+    decodeFailures = 0;
+    lastCaptureLength = 0;
     temperature = 0.0;
     humidity = 0.0;
     heatIndex = 0.0;
     lastReading = 0;
     readInterval = DHT22_READ_INTERVAL;
+    readyAt = 0;
     isInitialized = false;
     lastReadValid = false;
     currentSample = 0;
@@ -15,6 +27,13 @@ DHT22Sensor::DHT22Sensor(uint8_t dataPin) : pin(dataPin) {
 }
 
 DHT22Sensor::~DHT22Sensor() {
+    if (startTimer) {
+        esp_timer_stop(startTimer);
+        esp_timer_delete(startTimer);
+    }
+    if (rmtBuffer) {
+        rmt_driver_uninstall(DHT22_RMT);
+    }
     if (dht) {
         delete dht;
     }
@@ -22,14 +41,17 @@ DHT22Sensor::~DHT22Sensor() {
 
 bool DHT22Sensor::begin() {
     if (dht) {
-        dht->begin();
+        if constexpr (DHT22_USE_RMT) {
+            if (!beginCapture()) {
+                return false;
+            }
+        } else {
+            dht->begin();
+        }
         isInitialized = true;
         
-        // Esperar tiempo de estabilización
-        delay(2000);
-        
-        // Hacer primera lectura para inicializar
-        readSensor();
+        // Estabilización sin bloquear: la primera lectura la hace el loop
+        readyAt = millis() + DHT22_WARMUP_TIME;
         
         return true;
     }
@@ -41,10 +63,23 @@ bool DHT22Sensor::readSensor() {
         return false;
     }
     
-    // Leer temperatura y humedad
-    float newTemp = dht->readTemperature();
-    float newHum = dht->readHumidity();
+    if constexpr (DHT22_USE_RMT) {
+        // Una transacción en curso, o la anterior demasiado reciente para el sensor
+        if (!capturePending && millis() - lastTransaction >= DHT22_MIN_INTERVAL) {
+            startCapture();
+        }
+        return lastReadValid;
+    }
     
+    // Una sola transacción: read() trae temperatura y humedad juntas
+    if (!dht->read()) {
+        lastReadValid = false;
+        return false;
+    }
+    return processReading(dht->readTemperature(), dht->readHumidity());
+}
+
+bool DHT22Sensor::processReading(float newTemp, float newHum) {
     // Verificar si la lectura es válida
     if (isValidReading(newTemp, newHum)) {
         // Guardar muestra
@@ -69,11 +104,150 @@ bool DHT22Sensor::readSensor() {
     }
 }
 
+bool DHT22Sensor::beginCapture() {
+    rmt_config_t config = {};
+    config.rmt_mode = RMT_MODE_RX;
+    config.channel = DHT22_RMT;
+    config.gpio_num = (gpio_num_t)pin;
+    config.clk_div = 80;                             // 1 µs por tick (APB 80 MHz)
+    config.mem_block_num = 1;                        // 64 items: una trama completa
+    config.rx_config.filter_en = true;
+    config.rx_config.filter_ticks_thresh = 100;      // Glitches < 1.25 µs (ticks de APB)
+    config.rx_config.idle_threshold = DHT22_RMT_IDLE_US;
+    if (rmt_config(&config) != ESP_OK || rmt_driver_install(DHT22_RMT, 1024, 0) != ESP_OK) {
+        Serial.println("[DHT22] Error: RMT channel not available");
+        return false;
+    }
+    rmt_get_ringbuf_handle(DHT22_RMT, &rmtBuffer);
+    
+    // Open drain with the input still routed to the RMT: the same pin sends the start signal
+    gpio_set_direction((gpio_num_t)pin, GPIO_MODE_INPUT_OUTPUT_OD);
+    gpio_set_pull_mode((gpio_num_t)pin, GPIO_PULLUP_ONLY);
+    gpio_set_level((gpio_num_t)pin, 1);
+    
+    esp_timer_create_args_t timerArgs = {};
+    timerArgs.callback = onStartSignalDone;
+    timerArgs.arg = this;
+    timerArgs.dispatch_method = ESP_TIMER_TASK;
+    timerArgs.name = "dht22";
+    if (esp_timer_create(&timerArgs, &startTimer) != ESP_OK) {
+        Serial.println("[DHT22] Error: start timer not available");
+        return false;
+    }
+    return true;
+}
+
+void DHT22Sensor::startCapture() {
+    // Discard whatever a timed-out capture may have left behind
+    size_t size = 0;
+    void* stale = nullptr;
+    while ((stale = xRingbufferReceive(rmtBuffer, &size, 0)) != nullptr) {
+        vRingbufferReturnItem(rmtBuffer, stale);
+    }
+    
+    // Start signal: the line stays low until the timer releases it
+    gpio_set_level((gpio_num_t)pin, 0);
+    if (esp_timer_start_once(startTimer, DHT22_START_SIGNAL_US) != ESP_OK) {
+        gpio_set_level((gpio_num_t)pin, 1);
+        return;
+    }
+    capturePending = true;
+    captureStartedAt = millis();
+    lastTransaction = captureStartedAt;
+}
+
+// esp_timer task, DHT22_START_SIGNAL_US after startCapture()
+void DHT22Sensor::onStartSignalDone(void* context) {
+    DHT22Sensor* sensor = static_cast<DHT22Sensor*>(context);
+    rmt_rx_start(DHT22_RMT, true);
+    gpio_set_level((gpio_num_t)sensor->pin, 1);
+}
+
+// cppcheck-suppress unusedFunction
+void DHT22Sensor::update() {
+    if constexpr (DHT22_USE_RMT) {
+        if (!capturePending) {
+            return;
+        }
+        
+        size_t size = 0;
+        rmt_item32_t* items = (rmt_item32_t*)xRingbufferReceive(rmtBuffer, &size, 0);
+        if (items) {
+            // Each RMT item holds two levels; a zero duration marks the end of the frame
+            DHT22Decoder::Level levels[DHT22Decoder::MAX_LEVELS];
+            size_t count = 0;
+            for (size_t i = 0; i < size / sizeof(rmt_item32_t) && count + 2 <= DHT22Decoder::MAX_LEVELS; i++) {
+                levels[count++] = {items[i].level0 != 0, (uint16_t)items[i].duration0};
+                if (items[i].duration1 == 0) {
+                    break;
+                }
+                levels[count++] = {items[i].level1 != 0, (uint16_t)items[i].duration1};
+            }
+            vRingbufferReturnItem(rmtBuffer, items);
+            rmt_rx_stop(DHT22_RMT);
+            finishCapture(levels, count);
+        } else if (millis() - captureStartedAt >= DHT22_CAPTURE_TIMEOUT) {
+            rmt_rx_stop(DHT22_RMT);
+            finishCapture(nullptr, 0);
+        }
+    }
+}
+
+void DHT22Sensor::finishCapture(const DHT22Decoder::Level* levels, size_t count) {
+    capturePending = false;
+    
+    for (size_t i = 0; i < count; i++) {
+        lastCapture[i] = levels[i];
+    }
+    lastCaptureLength = count;
+    
+    DHT22Decoder::Reading reading = {NAN, NAN};
+    lastDecodeResult = DHT22Decoder::decode(levels, count, reading);
+    if (lastDecodeResult != DHT22Decoder::RESULT_OK) {
+        decodeFailures++;
+        lastReadValid = false;
+        return;
+    }
+    processReading(reading.temperature, reading.humidity);
+}
+
+// cppcheck-suppress unusedFunction
+DHT22Decoder::Result DHT22Sensor::getLastDecodeResult() {
+    return lastDecodeResult;
+}
+
+// cppcheck-suppress unusedFunction
+uint32_t DHT22Sensor::getDecodeFailures() {
+    return decodeFailures;
+}
+
+// cppcheck-suppress unusedFunction
+void DHT22Sensor::printLastCapture() {
+    Serial.printf("[DHT22] Last capture: %s, %u levels\n", DHT22Decoder::resultName(lastDecodeResult),
+                  (unsigned)lastCaptureLength);
+    for (size_t i = 0; i < lastCaptureLength; i++) {
+        Serial.printf("{%d, %u},%s", lastCapture[i].high ? 1 : 0, lastCapture[i].micros, (i % 8 == 7) ? "\n" : " ");
+    }
+    Serial.println();
+}
+
 // cppcheck-suppress unusedFunction
 bool DHT22Sensor::isDataValid() {
     return lastReadValid && isInitialized;
 }
 
+// cppcheck-suppress unusedFunction
+void DHT22Sensor::replayReading(bool valid, const float* fields) {
+    isInitialized = true;
+    lastReadValid = valid;
+    if (valid) {
+        temperature = fields[0];
+        humidity = fields[1];
+        heatIndex = dht->computeHeatIndex(temperature, humidity, false);
+        lastReading = millis();
+    }
+}
+
 // cppcheck-suppress unusedFunction
 float DHT22Sensor::getTemperature() {
     return temperature;
@@ -108,9 +282,38 @@ unsigned long DHT22Sensor::getTimeSinceLastReading() {
 
 // cppcheck-suppress unusedFunction
 bool DHT22Sensor::shouldRead() {
+    // Nothing to read until the warm-up started by begin() is over
+    if ((long)(millis() - readyAt) < 0) {
+        return false;
+    }
     return getTimeSinceLastReading() >= readInterval;
 }
 
+// cppcheck-suppress unusedFunction
+unsigned long DHT22Sensor::getIdleTime() {
+    if constexpr (DHT22_USE_RMT) {
+        if (capturePending) {
+            // The frame is in the RMT buffer by the capture timeout at the latest
+            long left = (long)(captureStartedAt + DHT22_CAPTURE_TIMEOUT - millis());
+            return left > 1 ? (unsigned long)left : 1;
+        }
+    }
+    unsigned long since = getTimeSinceLastReading();
+    unsigned long wait = since >= readInterval ? 0 : readInterval - since;
+    long warmUp = (long)(readyAt - millis());
+    if (warmUp > (long)wait) {
+        wait = (unsigned long)warmUp;
+    }
+    if constexpr (DHT22_USE_RMT) {
+        // A failed frame is retried once the sensor accepts a new transaction
+        long guard = (long)(lastTransaction + DHT22_MIN_INTERVAL - millis());
+        if (guard > (long)wait) {
+            wait = (unsigned long)guard;
+        }
+    }
+    return wait;
+}
+
 void DHT22Sensor::resetSamples() {
     for (int i = 0; i < SAMPLES_COUNT; i++) {
         tempSamples[i] = 0.0;
@@ -125,6 +125,18 @@ bool HCSR04Sensor::isDataValid() {
     return lastReadValid && isInitialized;
 }
 
+// cppcheck-suppress unusedFunction
+void HCSR04Sensor::replayReading(bool valid, const float* fields) {
+    isInitialized = true;
+    lastReadValid = valid;
+    if (valid) {
+        distanceCm = fields[0];
+        waterLevelCm = calculateWaterLevel(distanceCm);
+        waterLevelPercentage = calculateWaterPercentage(waterLevelCm);
+        lastReading = millis();
+    }
+}
+
 // cppcheck-suppress unusedFunction
 float HCSR04Sensor::getDistance() {
     return distanceCm;
@@ -215,6 +227,12 @@ bool HCSR04Sensor::shouldRead() {
     return getTimeSinceLastReading() >= readInterval;
 }
 
+// cppcheck-suppress unusedFunction
+unsigned long HCSR04Sensor::getIdleTime() {
+    unsigned long since = getTimeSinceLastReading();
+    return since >= readInterval ? 0 : readInterval - since;
+}
+
 // cppcheck-suppress unusedFunction
 void HCSR04Sensor::calibrateEmpty() {
     if (isInitialized) {
@@ -0,0 +1,240 @@
+#include "sensors/I2CBus.h"
+
+static_assert(I2C_MAX_DEVICES <= 16, "I2CBus::update keeps one bit per device in a uint16_t");
+
+I2CBus::I2CBus() :
+    queue(),
+    queueLength(0),
+    devices(),
+    deviceCount(0),
+    recoveries(0),
+    droppedJobs(0),
+    started(false)
+{
+}
+
+bool I2CBus::begin() {
+    if (started) {
+        return true;
+    }
+
+    // A slave reset mid-byte (brownout, ESP32 reset) may still hold SDA low
+    pinMode(I2C_SDA_PIN, INPUT_PULLUP);
+    if (digitalRead(I2C_SDA_PIN) == LOW) {
+        recoverBus();
+    } else {
+        startWire();
+    }
+    started = true;
+    Serial.printf("[I2CBus] SDA %d, SCL %d at %lu Hz\n", I2C_SDA_PIN, I2C_SCL_PIN, (unsigned long)I2C_FREQUENCY);
+    return true;
+}
+
+void I2CBus::startWire() {
+    Wire.begin(I2C_SDA_PIN, I2C_SCL_PIN, I2C_FREQUENCY);
+    Wire.setTimeOut(I2C_TIMEOUT_MS);
+}
+
+uint8_t I2CBus::addDevice(const char* name, uint8_t address) {
+    for (uint8_t i = 0; i < deviceCount; i++) {
+        if (devices[i].address == address) {
+            return i;
+        }
+    }
+    if (deviceCount >= I2C_MAX_DEVICES) {
+        Serial.printf("[I2CBus] Error: no room for device %s\n", name);
+        return NO_DEVICE;
+    }
+    DeviceStats& stats = devices[deviceCount];
+    stats = {};
+    stats.name = name;
+    stats.address = address;
+    return deviceCount++;
+}
+
+bool I2CBus::transfer(uint8_t device, const uint8_t* write, uint8_t writeLength, uint8_t* read,
+                      uint8_t readLength) {
+    return execute(device, write, writeLength, read, readLength);
+}
+
+bool I2CBus::submit(uint8_t device, const uint8_t* write, uint8_t writeLength, uint8_t readLength,
+                    unsigned long delayMs, Callback callback, void* context) {
+    if (device >= deviceCount || writeLength > MAX_WRITE || readLength > MAX_READ) {
+        return false;
+    }
+    if (queueLength >= I2C_QUEUE_SIZE) {
+        droppedJobs++;
+        return false;
+    }
+    Job& job = queue[queueLength++];
+    job.device = device;
+    job.writeLength = writeLength;
+    if (writeLength > 0) {
+        memcpy(job.write, write, writeLength);
+    }
+    job.readLength = readLength;
+    job.notBefore = millis() + delayMs;
+    job.callback = callback;
+    job.context = context;
+    return true;
+}
+
+void I2CBus::update() {
+    if (!started || queueLength == 0) {
+        return;
+    }
+
+    unsigned long now = millis();
+    uint16_t waiting = 0; // Devices with an earlier job not yet due: their later jobs wait too
+    uint8_t executed = 0;
+    uint8_t index = 0;
+    while (index < queueLength && executed < I2C_MAX_JOBS_PER_UPDATE) {
+        uint16_t deviceBit = (uint16_t)(1u << queue[index].device);
+        if ((waiting & deviceBit) || (long)(now - queue[index].notBefore) < 0) {
+            waiting |= deviceBit;
+            index++;
+            continue;
+        }
+
+        // Out of the queue before the callback, which may submit the next step
+        Job job = queue[index];
+        memmove(&queue[index], &queue[index + 1], (queueLength - index - 1) * sizeof(Job));
+        queueLength--;
+
+        uint8_t data[MAX_READ];
+        bool ok = execute(job.device, job.write, job.writeLength, data, job.readLength);
+        executed++;
+        if (job.callback) {
+            job.callback(job.context, ok, data, ok ? job.readLength : 0);
+        }
+    }
+}
+
+// cppcheck-suppress unusedFunction
+unsigned long I2CBus::getIdleTime() const {
+    unsigned long now = millis();
+    unsigned long idle = ULONG_MAX;
+    // A later job of a device never runs before its earlier ones, so the earliest notBefore is a safe bound
+    for (uint8_t i = 0; i < queueLength; i++) {
+        long left = (long)(queue[i].notBefore - now);
+        unsigned long wait = left > 0 ? (unsigned long)left : 0;
+        if (wait < idle) {
+            idle = wait;
+        }
+    }
+    return idle;
+}
+
+bool I2CBus::execute(uint8_t device, const uint8_t* write, uint8_t writeLength, uint8_t* read,
+                     uint8_t readLength) {
+    if (!started || device >= deviceCount) {
+        return false;
+    }
+
+    DeviceStats& stats = devices[device];
+    unsigned long start = micros();
+    uint8_t error = 0;
+    bool ok = true;
+
+    // An empty write is an address probe
+    if (writeLength > 0 || readLength == 0) {
+        Wire.beginTransmission(stats.address);
+        if (writeLength > 0) {
+            Wire.write(write, writeLength);
+        }
+        error = Wire.endTransmission(readLength == 0); // Repeated start when a read follows
+        ok = error == 0;
+    }
+    if (ok && readLength > 0) {
+        uint8_t received = Wire.requestFrom(stats.address, readLength);
+        for (uint8_t i = 0; i < received && i < readLength; i++) {
+            read[i] = Wire.read();
+        }
+        ok = received == readLength;
+    }
+
+    uint32_t elapsed = micros() - start;
+    stats.transactions++;
+    stats.totalMicros += elapsed;
+    if (elapsed > stats.maxMicros) {
+        stats.maxMicros = elapsed;
+    }
+    if (!ok) {
+        stats.errors++;
+        // A NACK (2, 3) means the device is absent or busy; anything else with SDA low is a stuck bus
+        if (error != 2 && error != 3 && digitalRead(I2C_SDA_PIN) == LOW) {
+            recoverBus();
+        }
+    }
+    return ok;
+}
+
+bool I2CBus::recoverBus() {
+    recoveries++;
+    if (started) {
+        Wire.end();
+    }
+
+    pinMode(I2C_SDA_PIN, INPUT_PULLUP);
+    pinMode(I2C_SCL_PIN, OUTPUT_OPEN_DRAIN);
+    digitalWrite(I2C_SCL_PIN, HIGH);
+    delayMicroseconds(5);
+
+    // Clock out the rest of the byte the slave believes it is still sending
+    for (uint8_t pulse = 0; pulse < 9 && digitalRead(I2C_SDA_PIN) == LOW; pulse++) {
+        digitalWrite(I2C_SCL_PIN, LOW);
+        delayMicroseconds(5);
+        digitalWrite(I2C_SCL_PIN, HIGH);
+        delayMicroseconds(5);
+    }
+
+    // STOP: SDA rises while SCL is high
+    pinMode(I2C_SDA_PIN, OUTPUT_OPEN_DRAIN);
+    digitalWrite(I2C_SDA_PIN, LOW);
+    delayMicroseconds(5);
+    digitalWrite(I2C_SDA_PIN, HIGH);
+    delayMicroseconds(5);
+    pinMode(I2C_SDA_PIN, INPUT_PULLUP);
+    bool released = digitalRead(I2C_SDA_PIN) == HIGH;
+
+    startWire();
+    Serial.printf("[I2CBus] Bus recovery %s\n", released ? "OK" : "failed, SDA still low");
+    return released;
+}
+
+// cppcheck-suppress unusedFunction
+uint8_t I2CBus::getDeviceCount() const {
+    return deviceCount;
+}
+
+// cppcheck-suppress unusedFunction
+const I2CBus::DeviceStats& I2CBus::getDeviceStats(uint8_t device) const {
+    return devices[device < deviceCount ? device : 0];
+}
+
+// cppcheck-suppress unusedFunction
+uint8_t I2CBus::getQueueLength() const {
+    return queueLength;
+}
+
+// cppcheck-suppress unusedFunction
+uint32_t I2CBus::getRecoveryCount() const {
+    return recoveries;
+}
+
+// cppcheck-suppress unusedFunction
+uint32_t I2CBus::getDroppedJobCount() const {
+    return droppedJobs;
+}
+
+void I2CBus::printStats() const {
+    Serial.printf("[I2CBus] %u jobs queued, %lu dropped, %lu bus recoveries\n", (unsigned)queueLength,
+                  (unsigned long)droppedJobs, (unsigned long)recoveries);
+    for (uint8_t i = 0; i < deviceCount; i++) {
+        const DeviceStats& stats = devices[i];
+        unsigned long mean = stats.transactions ? stats.totalMicros / stats.transactions : 0;
+        Serial.printf("  %-8s 0x%02X  %lu transactions, %lu errors, mean %lu us, max %lu us\n", stats.name,
+                      stats.address, (unsigned long)stats.transactions, (unsigned long)stats.errors, mean,
+                      (unsigned long)stats.maxMicros);
+    }
+}
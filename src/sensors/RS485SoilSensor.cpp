@@ -1,5 +1,6 @@
 #include "sensors/RS485SoilSensor.h"
 #include "config/config.h"
+#include "system/Metrics.h"
 #include <Arduino.h>
 
 RS485SoilSensor::RS485SoilSensor() 
@@ -17,6 +18,7 @@ RS485SoilSensor::RS485SoilSensor()
     , currentSample(0)
     , lastReading(0)
     , readInterval(RS485_READ_INTERVAL)
+    , readyAt(0)
     , isInitialized(false)
     , lastReadValid(false)
 {
@@ -38,6 +40,7 @@ RS485SoilSensor::RS485SoilSensor(HardwareSerial* serial, uint8_t txPin, uint8_t
     , currentSample(0)
     , lastReading(0)
     , readInterval(RS485_READ_INTERVAL)
+    , readyAt(0)
     , isInitialized(false)
     , lastReadValid(false)
 {
@@ -82,17 +85,8 @@ bool RS485SoilSensor::begin(uint32_t baud) {
     
     isInitialized = true;
     
-    // Hacer primera lectura para verificar comunicación
-    delay(100);
-    if (readSensor7in1()) {
-        Serial.println("RS485: Sensor 7-en-1 detectado");
-    } else if (readSensor4in1()) {
-        Serial.println("RS485: Sensor 4-en-1 detectado");
-    } else if (readSensor3in1()) {
-        Serial.println("RS485: Sensor 3-en-1 detectado");
-    } else {
-        Serial.println("RS485: Advertencia - No se pudo comunicar con el sensor");
-    }
+    // La primera lectura (y la detección del modelo 7/4/3-en-1) la hace el loop
+    readyAt = millis() + RS485_WARMUP_TIME;
     
     Serial.printf("RS485: Inicializado - TX: %d, RX: %d, Baud: %lu\\n", 
                   RS485_TX_PIN, RS485_RX_PIN, baudRate);
@@ -136,6 +130,7 @@ bool RS485SoilSensor::readSensor7in1() {
             lastReadValid = isValidReading();
             return true;
         }
+        Metrics::increment(Metrics::RS485_CRC_ERRORS);
     }
     
     return false;
@@ -159,6 +154,7 @@ bool RS485SoilSensor::readSensor4in1() {
             lastReadValid = isValidReading();
             return true;
         }
+        Metrics::increment(Metrics::RS485_CRC_ERRORS);
     }
     
     return false;
@@ -182,6 +178,7 @@ bool RS485SoilSensor::readSensor3in1() {
             lastReadValid = isValidReading();
             return true;
         }
+        Metrics::increment(Metrics::RS485_CRC_ERRORS);
     }
     
     return false;
@@ -376,6 +373,22 @@ bool RS485SoilSensor::isDataValid() {
     return lastReadValid && isInitialized;
 }
 
+// cppcheck-suppress unusedFunction
+void RS485SoilSensor::replayReading(bool valid, const float* fields) {
+    isInitialized = true;
+    lastReadValid = valid;
+    if (valid) {
+        temperature = fields[0];
+        moisture = fields[1];
+        electricalConductivity = fields[2];
+        pH = fields[3];
+        nitrogen = (uint16_t)fields[4];
+        phosphorus = (uint16_t)fields[5];
+        potassium = (uint16_t)fields[6];
+        lastReading = millis();
+    }
+}
+
 // cppcheck-suppress unusedFunction
 bool RS485SoilSensor::isReady() {
     return isInitialized;
@@ -492,9 +505,21 @@ unsigned long RS485SoilSensor::getTimeSinceLastReading() {
 
 // cppcheck-suppress unusedFunction
 bool RS485SoilSensor::shouldRead() {
+    // Nothing to read until the warm-up started by begin() is over
+    if ((long)(millis() - readyAt) < 0) {
+        return false;
+    }
     return getTimeSinceLastReading() >= readInterval;
 }
 
+// cppcheck-suppress unusedFunction
+unsigned long RS485SoilSensor::getIdleTime() {
+    unsigned long since = getTimeSinceLastReading();
+    unsigned long wait = since >= readInterval ? 0 : readInterval - since;
+    long warmUp = (long)(readyAt - millis());
+    return warmUp > (long)wait ? (unsigned long)warmUp : wait;
+}
+
 void RS485SoilSensor::printSoilData() {
     if (!isDataValid()) {
         Serial.println("RS485: Datos no válidos");
@@ -1,16 +1,32 @@
 #include "sensors/SensorManager.h"
 #include "config/config.h"
+#include "system/Metrics.h"
+
+namespace {
+
+// Lectura con su latencia y su fallo en el registro de métricas
+template <typename SensorType>
+bool timedRead(SensorType* sensor, Metrics::Sensor id) {
+    unsigned long start = micros();
+    bool success = sensor->readSensor();
+    Metrics::sensorRead(id, micros() - start, success);
+    return success;
+}
+
+} // namespace
 
 SensorManager::SensorManager(BlynkManager& blynk) : blynkManager(&blynk) {
     dht22Sensor = new DHT22Sensor(DHT22_PIN);
-    as7341Sensor = new AS7341Sensor();
+    as7341Sensor = new AS7341Sensor(i2cBus);
     soilMoistureSensor = new SoilMoistureSensor();
-    bh1750Sensor = new BH1750Sensor();
+    bh1750Sensor = new BH1750Sensor(i2cBus);
     hcsr04Sensor = new HCSR04Sensor();
     rs485SoilSensor = new RS485SoilSensor(&Serial2, RS485_TX_ENABLE_PIN, 0x01);
     lastBlynkUpdate = 0;
     blynkUpdateInterval = BLYNK_UPDATE_INTERVAL;
     sensorsInitialized = false;
+    traceRecorder = nullptr;
+    replaying = false;
 }
 
 SensorManager::~SensorManager() {
@@ -92,17 +108,54 @@ bool SensorManager::begin() {
 
 // cppcheck-suppress unusedFunction
 void SensorManager::update() {
-    if (!sensorsInitialized) {
+    if (!sensorsInitialized || replaying) {
         return;
     }
     
     // Leer sensores si es necesario
     readAllSensors();
     
+    // Transacciones I2C encoladas por las lecturas (y las que ya tocan)
+    i2cBus.update();
+    
+    // Trama del DHT22 capturada por RMT
+    dht22Sensor->update();
+    
     // Enviar datos a Blynk si es necesario
     if (shouldUpdateBlynk()) {
         sendDataToBlynk();
     }
+    
+    if (traceRecorder) {
+        recordTrace();
+    }
+}
+
+// cppcheck-suppress unusedFunction
+unsigned long SensorManager::getIdleTime() {
+    if (!sensorsInitialized || replaying) {
+        return ULONG_MAX;
+    }
+    
+    unsigned long idle = i2cBus.getIdleTime();
+    idle = min(idle, untilRead(dht22Sensor->getIdleTime()));
+    idle = min(idle, untilRead(as7341Sensor->getIdleTime()));
+    idle = min(idle, untilRead(soilMoistureSensor->getIdleTime()));
+    idle = min(idle, untilRead(bh1750Sensor->getIdleTime()));
+    idle = min(idle, untilRead(hcsr04Sensor->getIdleTime()));
+    idle = min(idle, untilRead(rs485SoilSensor->getIdleTime()));
+    
+    // Sin conexión el envío sigue pendiente; sale en la primera iteración tras reconectar
+    if (blynkManager->isConnected()) {
+        unsigned long sinceBlynk = millis() - lastBlynkUpdate;
+        idle = min(idle, sinceBlynk >= blynkUpdateInterval ? 0 : blynkUpdateInterval - sinceBlynk);
+    }
+    return idle;
+}
+
+// Tras update(), un sensor que sigue pendiente es uno cuya lectura acaba de fallar
+unsigned long SensorManager::untilRead(unsigned long wait) {
+    return wait > 0 ? wait : POWER_SENSOR_RETRY_INTERVAL;
 }
 
 bool SensorManager::readAllSensors() {
@@ -110,42 +163,42 @@ bool SensorManager::readAllSensors() {
     
     // Leer DHT22 si es tiempo
     if (dht22Sensor->shouldRead()) {
-        if (!dht22Sensor->readSensor()) {
+        if (!timedRead(dht22Sensor, Metrics::SENSOR_DHT22)) {
             success = false;
         }
     }
     
     // Leer AS7341 si es tiempo
     if (as7341Sensor->shouldRead()) {
-        if (!as7341Sensor->readSensor()) {
+        if (!timedRead(as7341Sensor, Metrics::SENSOR_AS7341)) {
             success = false;
         }
     }
     
     // Leer sensor de humedad del suelo si es tiempo
     if (soilMoistureSensor->shouldRead()) {
-        if (!soilMoistureSensor->readSensor()) {
+        if (!timedRead(soilMoistureSensor, Metrics::SENSOR_SOIL_MOISTURE)) {
             success = false;
         }
     }
     
     // Leer sensor BH1750 si es tiempo
     if (bh1750Sensor->shouldRead()) {
-        if (!bh1750Sensor->readSensor()) {
+        if (!timedRead(bh1750Sensor, Metrics::SENSOR_BH1750)) {
             success = false;
         }
     }
     
     // Leer sensor HC-SR04 si es tiempo
     if (hcsr04Sensor->shouldRead()) {
-        if (!hcsr04Sensor->readSensor()) {
+        if (!timedRead(hcsr04Sensor, Metrics::SENSOR_HCSR04)) {
             success = false;
         }
     }
     
     // Leer sensor RS485 de suelo si es tiempo
     if (rs485SoilSensor->shouldRead()) {
-        if (!rs485SoilSensor->readSensor()) {
+        if (!timedRead(rs485SoilSensor, Metrics::SENSOR_RS485_SOIL)) {
             success = false;
         }
     }
@@ -455,9 +508,16 @@ void SensorManager::printAllSensorData() {
         Serial.println("Sensor RS485 Suelo: Sin datos válidos");
     }
     
+    i2cBus.printStats();
+    
     Serial.println("========================\\n");
 }
 
+// cppcheck-suppress unusedFunction
+const I2CBus& SensorManager::getI2CBus() const {
+    return i2cBus;
+}
+
 bool SensorManager::shouldUpdateBlynk() {
     return (millis() - lastBlynkUpdate) >= blynkUpdateInterval;
 }
@@ -525,3 +585,78 @@ String SensorManager::getNutrientStatus() {
     }
     return "Sin datos";
 }
+
+// cppcheck-suppress unusedFunction
+bool SensorManager::hasControlReadings() {
+    return sensorsInitialized && dht22Sensor->isDataValid();
+}
+
+// cppcheck-suppress unusedFunction
+void SensorManager::setTraceRecorder(SensorTrace::Recorder* recorder) {
+    traceRecorder = recorder;
+}
+
+void SensorManager::recordTrace() {
+    float fields[SensorTrace::MAX_FIELDS];
+    
+    fields[0] = dht22Sensor->getTemperature();
+    fields[1] = dht22Sensor->getHumidity();
+    traceRecorder->sample(Metrics::SENSOR_DHT22, dht22Sensor->isDataValid(), fields);
+    
+    const float spectral[] = {as7341Sensor->getViolet(), as7341Sensor->getBlue(), as7341Sensor->getCyan(),
+                              as7341Sensor->getGreen(), as7341Sensor->getYellow(), as7341Sensor->getOrange(),
+                              as7341Sensor->getRed(), as7341Sensor->getNearIR(), as7341Sensor->getClear(),
+                              as7341Sensor->getNIR()};
+    traceRecorder->sample(Metrics::SENSOR_AS7341, as7341Sensor->isDataValid(), spectral);
+    
+    fields[0] = soilMoistureSensor->getRawValue();
+    traceRecorder->sample(Metrics::SENSOR_SOIL_MOISTURE, soilMoistureSensor->isDataValid(), fields);
+    
+    fields[0] = bh1750Sensor->getLux();
+    traceRecorder->sample(Metrics::SENSOR_BH1750, bh1750Sensor->isDataValid(), fields);
+    
+    fields[0] = hcsr04Sensor->getDistance();
+    traceRecorder->sample(Metrics::SENSOR_HCSR04, hcsr04Sensor->isDataValid(), fields);
+    
+    fields[0] = rs485SoilSensor->getTemperature();
+    fields[1] = rs485SoilSensor->getMoisture();
+    fields[2] = rs485SoilSensor->getElectricalConductivity();
+    fields[3] = rs485SoilSensor->getPH();
+    fields[4] = rs485SoilSensor->getNitrogen();
+    fields[5] = rs485SoilSensor->getPhosphorus();
+    fields[6] = rs485SoilSensor->getPotassium();
+    traceRecorder->sample(Metrics::SENSOR_RS485_SOIL, rs485SoilSensor->isDataValid(), fields);
+}
+
+// cppcheck-suppress unusedFunction
+void SensorManager::beginReplay() {
+    sensorsInitialized = true;
+    replaying = true;
+    Serial.println("[SensorManager] Reproducción de traza: sensores sin hardware");
+}
+
+// cppcheck-suppress unusedFunction
+void SensorManager::replayRecord(const SensorTrace::Record& record) {
+    switch (record.type) {
+        case Metrics::SENSOR_DHT22:
+            dht22Sensor->replayReading(record.valid, record.fields);
+            break;
+        case Metrics::SENSOR_AS7341:
+            as7341Sensor->replayReading(record.valid, record.fields);
+            break;
+        case Metrics::SENSOR_SOIL_MOISTURE:
+            soilMoistureSensor->replayReading(record.valid, record.fields);
+            break;
+        case Metrics::SENSOR_BH1750:
+            bh1750Sensor->replayReading(record.valid, record.fields);
+            break;
+        case Metrics::SENSOR_HCSR04:
+            hcsr04Sensor->replayReading(record.valid, record.fields);
+            break;
+        case Metrics::SENSOR_RS485_SOIL:
+            rs485SoilSensor->replayReading(record.valid, record.fields);
+            break;
+        default:
+            break;
+    }
+}
@@ -0,0 +1,267 @@
+#include "sensors/SensorTrace.h"
+#include "config/config.h"
+
+namespace SensorTrace {
+
+namespace {
+
+const char MAGIC[2] = {'G', 'T'};
+
+// Decimales de cada campo; los sensores con menos campos dejan el resto a 0
+const uint8_t FIELD_COUNT[Metrics::SENSOR_COUNT] = {
+    2,   // DHT22: temperatura, humedad
+    10,  // AS7341: F1-F8, clear, NIR
+    1,   // Humedad del suelo: valor ADC
+    1,   // BH1750: lux
+    1,   // HC-SR04: distancia
+    7,   // RS485: temperatura, humedad, EC, pH, N, P, K
+};
+const uint8_t FIELD_DECIMALS[Metrics::SENSOR_COUNT][MAX_FIELDS] = {
+    {2, 2},
+    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {0},
+    {1},
+    {2},
+    {2, 2, 1, 2, 0, 0, 0},
+};
+
+const char HEX_DIGITS[] = "0123456789ABCDEF";
+
+size_t writeVarint(uint8_t* out, uint32_t value) {
+    size_t length = 0;
+    while (value >= 0x80) {
+        out[length++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    out[length++] = (uint8_t)value;
+    return length;
+}
+
+uint32_t zigzag(int32_t value) {
+    return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+int32_t unzigzag(uint32_t value) {
+    return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+}
+
+float power10(uint8_t decimals) {
+    float factor = 1.0f;
+    for (uint8_t i = 0; i < decimals; i++) {
+        factor *= 10.0f;
+    }
+    return factor;
+}
+
+int32_t scale(float value, uint8_t decimals) {
+    if (isnan(value)) return 0;
+    float scaled = roundf(value * power10(decimals));
+    if (scaled > 2147483520.0f) return INT32_MAX;
+    if (scaled < -2147483520.0f) return INT32_MIN;
+    return (int32_t)scaled;
+}
+
+} // namespace
+
+uint8_t fieldCount(Metrics::Sensor sensor) {
+    return sensor < Metrics::SENSOR_COUNT ? FIELD_COUNT[sensor] : 0;
+}
+
+// ===== Recorder =====
+
+Recorder::Recorder()
+    : output(nullptr), hexLines(false), maxBytes(0), bytesWritten(0), full(false), lastRecordMillis(0),
+      lastTimeRecord(0), recorded(), lastValid(), lastFields() {}
+
+// cppcheck-suppress unusedFunction
+void Recorder::begin(Print& out, bool hex, size_t limit) {
+    output = &out;
+    hexLines = hex;
+    maxBytes = limit;
+    bytesWritten = 0;
+    full = false;
+    for (bool& sensor : recorded) {
+        sensor = false;
+    }
+    memset(lastFields, 0, sizeof(lastFields));
+
+    uint32_t now = millis();
+    uint8_t header[HEADER_SIZE] = {(uint8_t)MAGIC[0], (uint8_t)MAGIC[1], TRACE_VERSION};
+    for (uint8_t i = 0; i < 4; i++) {
+        header[3 + i] = (uint8_t)(now >> (8 * i));
+    }
+    lastRecordMillis = now;
+    lastTimeRecord = now - SENSOR_TRACE_TIME_INTERVAL;  // Hora en el primer clock() con hora válida
+    write(header, sizeof(header));
+}
+
+bool Recorder::write(const uint8_t* data, size_t length) {
+    if (!isActive()) {
+        return false;
+    }
+    if (maxBytes && bytesWritten + length > maxBytes) {
+        full = true;
+        Serial.printf("[SensorTrace] Límite de %u bytes alcanzado, grabación detenida\n", (unsigned)maxBytes);
+        return false;
+    }
+    if (hexLines) {
+        char line[4 + MAX_RECORD_SIZE * 2 + 1];
+        size_t position = 0;
+        line[position++] = '#';
+        line[position++] = 'T';
+        line[position++] = ' ';
+        for (size_t i = 0; i < length && position + 2 < sizeof(line); i++) {
+            line[position++] = HEX_DIGITS[data[i] >> 4];
+            line[position++] = HEX_DIGITS[data[i] & 0x0F];
+        }
+        line[position] = '\0';
+        output->println(line);
+    } else {
+        output->write(data, length);
+    }
+    bytesWritten += length;
+    return true;
+}
+
+size_t Recorder::beginRecord(uint8_t* buffer, uint8_t type) {
+    unsigned long now = millis();
+    size_t length = writeVarint(buffer, (uint32_t)(now - lastRecordMillis));
+    lastRecordMillis = now;
+    buffer[length++] = type;
+    return length;
+}
+
+// cppcheck-suppress unusedFunction
+void Recorder::sample(Metrics::Sensor sensor, bool valid, const float* fields) {
+    if (!isActive() || sensor >= Metrics::SENSOR_COUNT || !(SENSOR_TRACE_SENSORS & (1u << sensor))) {
+        return;
+    }
+
+    int32_t scaled[MAX_FIELDS] = {};
+    bool changed = !recorded[sensor] || valid != lastValid[sensor];
+    if (valid) {
+        for (uint8_t i = 0; i < FIELD_COUNT[sensor]; i++) {
+            scaled[i] = scale(fields[i], FIELD_DECIMALS[sensor][i]);
+            changed = changed || scaled[i] != lastFields[sensor][i];
+        }
+    }
+    if (!changed) {
+        return;
+    }
+
+    uint8_t buffer[MAX_RECORD_SIZE];
+    size_t length = beginRecord(buffer, valid ? (uint8_t)sensor : (uint8_t)(sensor | FLAG_INVALID));
+    if (valid) {
+        // Diferencia con el último valor válido: una lectura que apenas cambia ocupa 1 byte por campo
+        for (uint8_t i = 0; i < FIELD_COUNT[sensor]; i++) {
+            length += writeVarint(buffer + length, zigzag((int32_t)((uint32_t)scaled[i] - (uint32_t)lastFields[sensor][i])));
+        }
+    }
+    if (write(buffer, length)) {
+        recorded[sensor] = true;
+        lastValid[sensor] = valid;
+        if (valid) {
+            memcpy(lastFields[sensor], scaled, sizeof(scaled));
+        }
+    }
+}
+
+// cppcheck-suppress unusedFunction
+void Recorder::clock(time_t epoch) {
+    if (!isActive() || epoch < TIME_MIN_VALID_EPOCH || millis() - lastTimeRecord < SENSOR_TRACE_TIME_INTERVAL) {
+        return;
+    }
+    lastTimeRecord = millis();
+
+    uint8_t buffer[MAX_RECORD_SIZE];
+    size_t length = beginRecord(buffer, RECORD_TIME);
+    length += writeVarint(buffer + length, (uint32_t)epoch);
+    write(buffer, length);
+    // Fichero: lo grabado hasta aquí sobrevive a un corte de alimentación
+    output->flush();
+}
+
+// ===== Reader =====
+
+Reader::Reader() : data(nullptr), length(0), position(0), millis(0), lastFields() {}
+
+// cppcheck-suppress unusedFunction
+bool Reader::begin(const uint8_t* trace, size_t size) {
+    data = trace;
+    length = size;
+    position = 0;
+    millis = 0;
+    if (size < HEADER_SIZE || trace[0] != (uint8_t)MAGIC[0] || trace[1] != (uint8_t)MAGIC[1] ||
+        trace[2] != TRACE_VERSION) {
+        return false;
+    }
+    millis = getStartMillis();
+    memset(lastFields, 0, sizeof(lastFields));
+    position = HEADER_SIZE;
+    return true;
+}
+
+uint32_t Reader::getStartMillis() const {
+    if (!data || length < HEADER_SIZE) {
+        return 0;
+    }
+    uint32_t start = 0;
+    for (uint8_t i = 0; i < 4; i++) {
+        start |= (uint32_t)data[3 + i] << (8 * i);
+    }
+    return start;
+}
+
+bool Reader::readVarint(uint32_t& value) {
+    value = 0;
+    for (uint8_t shift = 0; shift < 35; shift += 7) {
+        if (position >= length) {
+            return false;
+        }
+        uint8_t byte = data[position++];
+        value |= (uint32_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// cppcheck-suppress unusedFunction
+bool Reader::next(Record& record) {
+    uint32_t delta;
+    if (isAtEnd() || !readVarint(delta) || position >= length) {
+        return false;
+    }
+    millis += delta;
+    uint8_t type = data[position++];
+
+    record.millis = millis;
+    record.type = type & ~FLAG_INVALID;
+    record.valid = !(type & FLAG_INVALID);
+    record.epoch = 0;
+    for (float& field : record.fields) {
+        field = NAN;
+    }
+
+    if (record.type == RECORD_TIME) {
+        return readVarint(record.epoch);
+    }
+    if (record.type >= Metrics::SENSOR_COUNT) {
+        return false;
+    }
+    if (!record.valid) {
+        return true;
+    }
+    for (uint8_t i = 0; i < FIELD_COUNT[record.type]; i++) {
+        uint32_t value;
+        if (!readVarint(value)) {
+            return false;
+        }
+        lastFields[record.type][i] = (int32_t)((uint32_t)lastFields[record.type][i] + (uint32_t)unzigzag(value));
+        record.fields[i] = lastFields[record.type][i] / power10(FIELD_DECIMALS[record.type][i]);
+    }
+    return true;
+}
+
+} // namespace SensorTrace
@@ -78,6 +78,17 @@ bool SoilMoistureSensor::isDataValid() {
     return lastReadValid && isInitialized;
 }
 
+// cppcheck-suppress unusedFunction
+void SoilMoistureSensor::replayReading(bool valid, const float* fields) {
+    isInitialized = true;
+    lastReadValid = valid;
+    if (valid) {
+        rawValue = (uint16_t)fields[0];
+        moisturePercentage = convertToPercentage(rawValue);
+        lastReading = millis();
+    }
+}
+
 // cppcheck-suppress unusedFunction
 float SoilMoistureSensor::getMoisturePercentage() {
     return moisturePercentage;
@@ -161,6 +172,12 @@ bool SoilMoistureSensor::shouldRead() {
     return getTimeSinceLastReading() >= readInterval;
 }
 
+// cppcheck-suppress unusedFunction
+unsigned long SoilMoistureSensor::getIdleTime() {
+    unsigned long since = getTimeSinceLastReading();
+    return since >= readInterval ? 0 : readInterval - since;
+}
+
 // cppcheck-suppress unusedFunction
 void SoilMoistureSensor::printMoistureData() {
     if (!isDataValid()) {
@@ -0,0 +1,42 @@
+#include "system/BootSequence.h"
+
+BootSequence::BootSequence() :
+    finished(0),
+    failed(0),
+    finishedAt(),
+    summaryPrinted(false)
+{
+}
+
+bool BootSequence::isReady(Boot::Phase phase) const {
+    uint16_t dependsOn = Boot::PHASES[phase].dependsOn;
+    return !isFinished(phase) && (finished & dependsOn) == dependsOn;
+}
+
+bool BootSequence::isFinished(Boot::Phase phase) const {
+    return finished & Boot::bit(phase);
+}
+
+bool BootSequence::isComplete() const {
+    return finished == (uint16_t)((1u << Boot::PHASE_COUNT) - 1);
+}
+
+void BootSequence::finish(Boot::Phase phase, bool ok, unsigned long startedAt) {
+    if (isFinished(phase)) return;
+    unsigned long now = millis();
+    finished |= Boot::bit(phase);
+    if (!ok) {
+        failed |= Boot::bit(phase);
+    }
+    finishedAt[phase] = now;
+    Serial.printf("[Boot] %-14s %-5s %5lu ms  (t=%lu ms)\n", Boot::PHASES[phase].name, ok ? "OK" : "ERROR",
+                  now - startedAt, now);
+}
+
+void BootSequence::printSummaryOnce() {
+    if (summaryPrinted || !isComplete()) return;
+    summaryPrinted = true;
+    Serial.printf("[Boot] First control cycle at %lu ms, Wi-Fi at %lu ms, %u phase(s) failed\n",
+                  finishedAt[Boot::PHASE_CONTROL], finishedAt[Boot::PHASE_WIFI_CONNECTED],
+                  (unsigned)__builtin_popcount(failed));
+}
@@ -0,0 +1,93 @@
+#include "system/LoopProfiler.h"
+
+namespace LoopProfiler {
+
+StageData stages[STAGE_COUNT];
+std::atomic<uint32_t> overruns;
+std::atomic<bool> resetRequested;
+
+namespace {
+
+const char* const STAGE_NAMES[] = {
+    "time", "settings", "wifi", "blynk", "sensors", "actuators",
+    "logic", "web", "telemetry", "modbus", "loop"
+};
+static_assert(sizeof(STAGE_NAMES) / sizeof(STAGE_NAMES[0]) == STAGE_COUNT, "One name per LoopProfiler::Stage");
+
+// Smallest bucket bound holding at least `rank` observations
+uint32_t percentile(const uint32_t* buckets, uint32_t rank, uint32_t maxMicros) {
+    uint32_t cumulative = 0;
+    for (uint8_t i = 0; i < BUCKET_COUNT; i++) {
+        cumulative += buckets[i];
+        if (cumulative >= rank) {
+            uint32_t bound = bucketUpperBound(i);
+            return bound < maxMicros ? bound : maxMicros;
+        }
+    }
+    return maxMicros;
+}
+
+} // namespace
+
+const char* stageName(Stage stage) {
+    return stage < STAGE_COUNT ? STAGE_NAMES[stage] : "?";
+}
+
+void Stopwatch::resetIfRequested() {
+    if (!resetRequested.load(std::memory_order_relaxed)) return;
+    for (StageData& data : stages) {
+        for (std::atomic<uint32_t>& bucket : data.buckets) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+        data.maxMicros.store(0, std::memory_order_relaxed);
+        data.totalMicros.store(0, std::memory_order_relaxed);
+    }
+    overruns.store(0, std::memory_order_relaxed);
+    resetRequested.store(false, std::memory_order_relaxed);
+}
+
+Summary summarize(Stage stage) {
+    const StageData& data = stages[stage];
+    // Copy first: the loop keeps writing while this runs
+    uint32_t buckets[BUCKET_COUNT];
+    uint32_t count = 0;
+    for (uint8_t i = 0; i < BUCKET_COUNT; i++) {
+        buckets[i] = data.buckets[i].load(std::memory_order_relaxed);
+        count += buckets[i];
+    }
+
+    Summary summary = {};
+    summary.count = count;
+    if (count == 0) return summary;
+    summary.maxMicros = data.maxMicros.load(std::memory_order_relaxed);
+    summary.p50Micros = percentile(buckets, (count + 1) / 2, summary.maxMicros);
+    summary.p99Micros = percentile(buckets, count - count / 100, summary.maxMicros);
+    summary.meanMicros = (uint32_t)(data.totalMicros.load(std::memory_order_relaxed) / count);
+    return summary;
+}
+
+// cppcheck-suppress unusedFunction
+uint32_t getOverrunCount() {
+    return overruns.load(std::memory_order_relaxed);
+}
+
+// cppcheck-suppress unusedFunction
+void requestReset() {
+    resetRequested.store(true, std::memory_order_relaxed);
+}
+
+// cppcheck-suppress unusedFunction
+void printReport() {
+    Summary loop = summarize(STAGE_LOOP);
+    Serial.printf("[LoopProfiler] %lu loops, %lu over %lu us budget\n", (unsigned long)loop.count,
+                  (unsigned long)getOverrunCount(), (unsigned long)LOOP_PROFILER_BUDGET_US);
+    Serial.println("  stage          p50 us     p99 us     max us    mean us");
+    for (uint8_t i = 0; i < STAGE_COUNT; i++) {
+        Summary summary = summarize((Stage)i);
+        Serial.printf("  %-10s %10lu %10lu %10lu %10lu\n", STAGE_NAMES[i], (unsigned long)summary.p50Micros,
+                      (unsigned long)summary.p99Micros, (unsigned long)summary.maxMicros,
+                      (unsigned long)summary.meanMicros);
+    }
+}
+
+} // namespace LoopProfiler
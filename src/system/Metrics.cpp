@@ -0,0 +1,207 @@
+#include "system/Metrics.h"
+#include <WiFi.h>
+#include <esp_heap_caps.h>
+
+namespace Metrics {
+
+std::atomic<uint32_t> counters[COUNTER_COUNT];
+HistogramData histograms[HISTOGRAM_COUNT];
+
+namespace {
+
+enum class Type : uint8_t { COUNTER, GAUGE, HISTOGRAM };
+
+struct Family {
+    const char* name;
+    const char* help;
+    Type type;
+    const char* labelName;          // nullptr = una sola serie sin etiqueta
+    const char* const* labelValues;
+    uint8_t seriesCount;
+    uint8_t slot;                   // Primera ranura del contador o histograma
+    float (*read)();                // Indicadores: valor leído al servir
+};
+
+const char* const SENSOR_LABELS[] = {"dht22", "as7341", "soil_moisture", "bh1750", "hcsr04", "rs485_soil"};
+const char* const RELAY_LABELS[] = {"fan", "heater", "water_pump", "led_strip", "multichannel"};
+const char* const INPUT_LABELS[] = {"temperature", "humidity", "light", "soil_zone_1", "soil_zone_2"};
+static_assert(sizeof(SENSOR_LABELS) / sizeof(SENSOR_LABELS[0]) == SENSOR_COUNT, "One label per Metrics::Sensor");
+static_assert(sizeof(RELAY_LABELS) / sizeof(RELAY_LABELS[0]) == RELAY_COUNT, "One label per Metrics::Relay");
+static_assert(sizeof(INPUT_LABELS) / sizeof(INPUT_LABELS[0]) == INPUT_COUNT, "One label per Metrics::ControlInput");
+
+float readFreeHeap() {
+    return (float)ESP.getFreeHeap();
+}
+
+float readLargestFreeBlock() {
+    return (float)heap_caps_get_largest_free_block(MALLOC_CAP_8BIT);
+}
+
+float readWiFiRssi() {
+    return WiFi.status() == WL_CONNECTED ? (float)WiFi.RSSI() : NAN;
+}
+
+float readUptime() {
+    return millis() / 1000.0f;
+}
+
+const Family FAMILIES[] = {
+    {"greenhouse_loop_duration_seconds", "Duration of one control loop iteration",
+     Type::HISTOGRAM, nullptr, nullptr, 1, LOOP_DURATION, nullptr},
+    {"greenhouse_sensor_read_duration_seconds", "Duration of one sensor read",
+     Type::HISTOGRAM, "sensor", SENSOR_LABELS, SENSOR_COUNT, SENSOR_READ_DURATION, nullptr},
+    {"greenhouse_sensor_read_failures_total", "Sensor reads that returned no valid data",
+     Type::COUNTER, "sensor", SENSOR_LABELS, SENSOR_COUNT, SENSOR_READ_FAILURES, nullptr},
+    {"greenhouse_rs485_crc_errors_total", "RS485 soil sensor frames rejected by CRC",
+     Type::COUNTER, nullptr, nullptr, 1, RS485_CRC_ERRORS, nullptr},
+    {"greenhouse_relay_toggles_total", "Output state changes",
+     Type::COUNTER, "relay", RELAY_LABELS, RELAY_COUNT, RELAY_TOGGLES, nullptr},
+    {"greenhouse_blynk_reconnects_total", "Successful Blynk reconnections",
+     Type::COUNTER, nullptr, nullptr, 1, BLYNK_RECONNECTS, nullptr},
+    {"greenhouse_loop_wakeups_total", "Control loop wake-ups (adaptive sleep)",
+     Type::COUNTER, nullptr, nullptr, 1, LOOP_WAKEUPS, nullptr},
+    {"greenhouse_control_input_faults_total", "Control inputs lost (their loop held in a safe state)",
+     Type::COUNTER, "input", INPUT_LABELS, INPUT_COUNT, CONTROL_INPUT_FAULTS, nullptr},
+    {"greenhouse_heap_free_bytes", "Free heap",
+     Type::GAUGE, nullptr, nullptr, 1, 0, readFreeHeap},
+    {"greenhouse_heap_largest_free_block_bytes", "Largest allocatable heap block",
+     Type::GAUGE, nullptr, nullptr, 1, 0, readLargestFreeBlock},
+    {"greenhouse_wifi_rssi_dbm", "Wi-Fi signal strength (NaN while disconnected)",
+     Type::GAUGE, nullptr, nullptr, 1, 0, readWiFiRssi},
+    {"greenhouse_uptime_seconds", "Time since boot",
+     Type::GAUGE, nullptr, nullptr, 1, 0, readUptime},
+};
+const uint8_t FAMILY_COUNT = sizeof(FAMILIES) / sizeof(FAMILIES[0]);
+
+// Histogram series: one line per bucket, +Inf, _sum and _count
+const uint8_t HISTOGRAM_LINES = BUCKET_COUNT + 3;
+
+const char* typeName(Type type) {
+    switch (type) {
+        case Type::COUNTER: return "counter";
+        case Type::GAUGE: return "gauge";
+        default: return "histogram";
+    }
+}
+
+// Label set "{sensor="dht22",le="0.001"}" (empty when there are no labels)
+void formatLabels(char* out, size_t size, const Family& family, uint8_t series, const char* le) {
+    bool labelled = family.labelName != nullptr;
+    if (labelled && le) {
+        snprintf(out, size, "{%s=\"%s\",le=\"%s\"}", family.labelName, family.labelValues[series], le);
+    } else if (labelled) {
+        snprintf(out, size, "{%s=\"%s\"}", family.labelName, family.labelValues[series]);
+    } else if (le) {
+        snprintf(out, size, "{le=\"%s\"}", le);
+    } else {
+        out[0] = '\0';
+    }
+}
+
+size_t clampLength(int length, size_t size) {
+    if (length < 0) return 0;
+    return (size_t)length < size ? (size_t)length : size - 1;
+}
+
+} // namespace
+
+Renderer::Renderer() :
+    family(0),
+    item(0),
+    cumulative(0),
+    pending(),
+    pendingLength(0),
+    pendingOffset(0)
+{
+}
+
+size_t Renderer::formatItem(char* out, size_t size) {
+    const Family& f = FAMILIES[family];
+    if (item == 0) {
+        return clampLength(snprintf(out, size, "# HELP %s %s\n", f.name, f.help), size);
+    }
+    if (item == 1) {
+        return clampLength(snprintf(out, size, "# TYPE %s %s\n", f.name, typeName(f.type)), size);
+    }
+
+    uint16_t index = item - 2;
+    uint8_t linesPerSeries = f.type == Type::HISTOGRAM ? HISTOGRAM_LINES : 1;
+    if (index >= f.seriesCount * linesPerSeries) {
+        return 0; // Family done
+    }
+    uint8_t series = index / linesPerSeries;
+    uint8_t line = index % linesPerSeries;
+    char labels[64];
+
+    if (f.type == Type::GAUGE) {
+        formatLabels(labels, sizeof(labels), f, series, nullptr);
+        float value = f.read();
+        if (isnan(value)) {
+            return clampLength(snprintf(out, size, "%s%s NaN\n", f.name, labels), size);
+        }
+        return clampLength(snprintf(out, size, "%s%s %.0f\n", f.name, labels, value), size);
+    }
+
+    if (f.type == Type::COUNTER) {
+        formatLabels(labels, sizeof(labels), f, series, nullptr);
+        uint32_t value = counters[f.slot + series].load(std::memory_order_relaxed);
+        return clampLength(snprintf(out, size, "%s%s %lu\n", f.name, labels, (unsigned long)value), size);
+    }
+
+    // Buckets are stored per range; Prometheus wants them cumulative
+    HistogramData& data = histograms[f.slot + series];
+    if (line == 0) {
+        cumulative = 0;
+    }
+    if (line <= BUCKET_COUNT) {
+        char le[16];
+        if (line < BUCKET_COUNT) {
+            snprintf(le, sizeof(le), "%g", BUCKET_BOUNDS_US[line] / 1e6);
+        } else {
+            strcpy(le, "+Inf");
+        }
+        cumulative += data.buckets[line].load(std::memory_order_relaxed);
+        formatLabels(labels, sizeof(labels), f, series, le);
+        return clampLength(snprintf(out, size, "%s_bucket%s %lu\n", f.name, labels, (unsigned long)cumulative), size);
+    }
+
+    formatLabels(labels, sizeof(labels), f, series, nullptr);
+    if (line == BUCKET_COUNT + 1) {
+        double sum = data.sumMicros.load(std::memory_order_relaxed) / 1e6;
+        return clampLength(snprintf(out, size, "%s_sum%s %.6f\n", f.name, labels, sum), size);
+    }
+    // _count matches the +Inf bucket written just before
+    return clampLength(snprintf(out, size, "%s_count%s %lu\n", f.name, labels, (unsigned long)cumulative), size);
+}
+
+size_t Renderer::fill(uint8_t* buffer, size_t maxLength) {
+    size_t written = 0;
+    while (written < maxLength) {
+        // A line that did not fit continues in the next chunk
+        if (pendingOffset < pendingLength) {
+            size_t count = pendingLength - pendingOffset;
+            if (count > maxLength - written) {
+                count = maxLength - written;
+            }
+            memcpy(buffer + written, pending + pendingOffset, count);
+            pendingOffset += count;
+            written += count;
+            continue;
+        }
+
+        if (family >= FAMILY_COUNT) {
+            break;
+        }
+        pendingLength = formatItem(pending, sizeof(pending));
+        pendingOffset = 0;
+        if (pendingLength == 0) {
+            family++;
+            item = 0;
+        } else {
+            item++;
+        }
+    }
+    return written;
+}
+
+} // namespace Metrics
@@ -0,0 +1,143 @@
+#include "system/PowerManager.h"
+#include "system/Metrics.h"
+#include <WiFi.h>
+#include <esp_pm.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+namespace PowerManager {
+
+namespace {
+
+const uint32_t HOUR_MILLIS = 3600000UL;
+
+TaskHandle_t loopTask = nullptr;
+esp_pm_lock_handle_t pwmLock = nullptr;
+bool pwmLockHeld = false;
+Mode mode = MODE_WAIT;
+
+// Loop task only
+int64_t awakeSince = 0;
+unsigned long windowStart = 0;
+HourStats current = {};
+
+// Written by the loop, read by the web server
+portMUX_TYPE statsMux = portMUX_INITIALIZER_UNLOCKED;
+HourStats lastHour = {};
+bool hourCompleted = false;
+
+const char* const MODE_NAMES[] = {"espera", "frecuencia dinámica", "sueño ligero"};
+
+void holdPwmClock(bool hold) {
+    if (!pwmLock || hold == pwmLockHeld) {
+        return;
+    }
+    if (hold) {
+        esp_pm_lock_acquire(pwmLock);
+    } else {
+        esp_pm_lock_release(pwmLock);
+    }
+    pwmLockHeld = hold;
+}
+
+void closeHour(unsigned long now) {
+    current.lengthMillis = now - windowStart;
+    portENTER_CRITICAL(&statsMux);
+    lastHour = current;
+    hourCompleted = true;
+    portEXIT_CRITICAL(&statsMux);
+
+    Serial.printf("[PowerManager] Última hora: %u despertares del loop (%u adelantados), %.2f %% despierto, modo %s\n",
+                  (unsigned)current.wakes, (unsigned)current.earlyWakes,
+                  current.awakeMillis * 100.0f / current.lengthMillis, getModeName());
+    current = {};
+    windowStart = now;
+}
+
+} // namespace
+
+// cppcheck-suppress unusedFunction
+void begin() {
+    loopTask = xTaskGetCurrentTaskHandle();
+    windowStart = millis();
+    awakeSince = esp_timer_get_time();
+
+    // ESP_ERR_NOT_SUPPORTED: no CONFIG_PM_ENABLE, or light sleep without tickless idle
+    esp_pm_config_esp32_t config = {};
+    config.max_freq_mhz = POWER_CPU_MAX_MHZ;
+    config.min_freq_mhz = POWER_CPU_MIN_MHZ;
+    config.light_sleep_enable = POWER_LIGHT_SLEEP_ENABLED;
+    esp_err_t result = esp_pm_configure(&config);
+    if (result == ESP_ERR_NOT_SUPPORTED && config.light_sleep_enable) {
+        config.light_sleep_enable = false;
+        result = esp_pm_configure(&config);
+    }
+    if (result == ESP_OK) {
+        mode = config.light_sleep_enable ? MODE_LIGHT_SLEEP : MODE_DFS;
+        if (esp_pm_lock_create(ESP_PM_NO_LIGHT_SLEEP, 0, "pwm", &pwmLock) != ESP_OK) {
+            pwmLock = nullptr;
+        }
+    }
+    Serial.printf("[PowerManager] Modo de ahorro: %s (%d-%d MHz)\n", getModeName(), POWER_CPU_MIN_MHZ, POWER_CPU_MAX_MHZ);
+}
+
+// cppcheck-suppress unusedFunction
+void sleep(unsigned long idleMs, bool keepPwmClock) {
+    int64_t sleepStart = esp_timer_get_time();
+    current.awakeMillis += (uint32_t)((sleepStart - awakeSince) / 1000);
+    holdPwmClock(keepPwmClock);
+
+    unsigned long wait = constrain(idleMs, (unsigned long)POWER_MIN_SLEEP, (unsigned long)POWER_MAX_SLEEP);
+    bool early = ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(wait)) > 0;
+
+    awakeSince = esp_timer_get_time();
+    current.wakes++;
+    if (early) {
+        current.earlyWakes++;
+    }
+    Metrics::increment(Metrics::LOOP_WAKEUPS);
+
+    unsigned long now = millis();
+    if (now - windowStart >= HOUR_MILLIS) {
+        closeHour(now);
+    }
+}
+
+// cppcheck-suppress unusedFunction
+void wake() {
+    if (loopTask) {
+        xTaskNotifyGive(loopTask);
+    }
+}
+
+// cppcheck-suppress unusedFunction
+void configureWiFi() {
+    // Con sueño ligero automático el WiFi necesita modem sleep para seguir asociado
+    WiFi.setSleep(POWER_WIFI_SLEEP);
+}
+
+Mode getMode() {
+    return mode;
+}
+
+const char* getModeName() {
+    return MODE_NAMES[mode];
+}
+
+// cppcheck-suppress unusedFunction
+HourStats getLastHour() {
+    portENTER_CRITICAL(&statsMux);
+    bool completed = hourCompleted;
+    HourStats stats = lastHour;
+    portEXIT_CRITICAL(&statsMux);
+    if (completed) {
+        return stats;
+    }
+    // First hour still running: what there is so far (the loop keeps writing, hence approximate)
+    stats = current;
+    stats.lengthMillis = millis() - windowStart;
+    return stats;
+}
+
+} // namespace PowerManager
@@ -0,0 +1,112 @@
+#include "system/StateSnapshot.h"
+#include <esp_attr.h>
+#include <esp_rom_crc.h>
+#include <cstddef>
+#include <cstring>
+
+namespace StateSnapshot {
+
+namespace {
+
+const uint32_t SNAPSHOT_MAGIC = 0x534E4150;  // "SNAP"
+
+struct Record {
+    uint32_t magic;
+    uint32_t size;   // sizeof(State): a firmware with another layout starts cold
+    State state;
+    uint32_t crc;
+};
+
+// RTC slow memory, not cleared on reset. The heartbeat lives outside the record so the
+// per-iteration write does not touch the CRC; its complement tells it apart from garbage
+RTC_NOINIT_ATTR Record record;
+RTC_NOINIT_ATTR uint32_t aliveMillis;
+RTC_NOINIT_ATTR uint32_t aliveCheck;
+
+State restored = {};
+bool hasRestored = false;
+uint32_t writes = 0;
+
+uint32_t recordCrc() {
+    return esp_rom_crc32_le(0, (const uint8_t*)&record, offsetof(Record, crc));
+}
+
+void write(const State& state) {
+    record.magic = SNAPSHOT_MAGIC;
+    record.size = sizeof(State);
+    record.state = state;
+    record.crc = recordCrc();
+    writes++;
+}
+
+void rebase(int32_t& time, uint32_t shift) {
+    time = (int32_t)((uint32_t)time - shift);
+}
+
+void rebase(Relay& relay, uint32_t shift) {
+    rebase(relay.lastStateChange, shift);
+    rebase(relay.onSince, shift);
+}
+
+} // namespace
+
+// cppcheck-suppress unusedFunction
+void begin(unsigned long hangMillis) {
+    if constexpr (!SNAPSHOT_ENABLED) return;
+
+    bool valid = record.magic == SNAPSHOT_MAGIC && record.size == sizeof(State) && record.crc == recordCrc() &&
+                 aliveCheck == ~aliveMillis;
+    if (!valid) {
+        Serial.println("[StateSnapshot] Arranque en frío: sin estado previo en RTC");
+        return;
+    }
+
+    // Previous boot's millis() -> this boot's: the reset happened at millis() = 0
+    uint32_t shift = aliveMillis + hangMillis;
+    restored = record.state;
+    rebase(restored.fan, shift);
+    rebase(restored.heater, shift);
+    rebase(restored.pump, shift);
+    rebase(restored.ledStrip, shift);
+    for (Zone& zone : restored.zones) {
+        if (zone.lastIrrigationTime != 0) {
+            rebase(zone.lastIrrigationTime, shift);
+        }
+        rebase(zone.sessionStart, shift);
+    }
+    hasRestored = true;
+
+    // Already in this boot's time base, in case it resets again before the first update()
+    write(restored);
+    touch();
+    Serial.printf("[StateSnapshot] Arranque en caliente: estado de hace %lu ms\n", (unsigned long)(shift + millis()));
+}
+
+// cppcheck-suppress unusedFunction
+const State* getRestored() {
+    return hasRestored ? &restored : nullptr;
+}
+
+// cppcheck-suppress unusedFunction
+void touch() {
+    if constexpr (!SNAPSHOT_ENABLED) return;
+    uint32_t now = millis();
+    aliveMillis = now;
+    aliveCheck = ~now;
+}
+
+// cppcheck-suppress unusedFunction
+void update(const State& state) {
+    if constexpr (!SNAPSHOT_ENABLED) return;
+    if (record.magic == SNAPSHOT_MAGIC && memcmp(&record.state, &state, sizeof(State)) == 0) {
+        return;
+    }
+    write(state);
+}
+
+// cppcheck-suppress unusedFunction
+uint32_t getWriteCount() {
+    return writes;
+}
+
+} // namespace StateSnapshot
@@ -0,0 +1,226 @@
+#include "system/Supervisor.h"
+#include <esp_attr.h>
+#include <esp_rom_crc.h>
+#include <esp_system.h>
+#include <esp_task_wdt.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <cstddef>
+#include <cstring>
+
+namespace Supervisor {
+
+namespace {
+
+const uint32_t HANG_MAGIC = 0x48414E47;  // "HANG"
+
+// RTC slow memory, not cleared on reset: written just before esp_restart(), read by the next boot
+RTC_NOINIT_ATTR HangRecord hangRecord;
+
+const uint32_t DEADLINES[LoopProfiler::STAGE_COUNT] = {
+    WATCHDOG_DEADLINE_TIME,
+    WATCHDOG_DEADLINE_SETTINGS,
+    WATCHDOG_DEADLINE_WIFI,
+    WATCHDOG_DEADLINE_BLYNK,
+    WATCHDOG_DEADLINE_SENSORS,
+    WATCHDOG_DEADLINE_ACTUATORS,
+    WATCHDOG_DEADLINE_LOGIC,
+    WATCHDOG_DEADLINE_WEB,
+    WATCHDOG_DEADLINE_TELEMETRY,
+    WATCHDOG_DEADLINE_MODBUS,
+    WATCHDOG_DEADLINE_LOOP,
+};
+const uint32_t SLEEP_DEADLINE = POWER_MAX_SLEEP + WATCHDOG_SLEEP_MARGIN;
+
+static_assert(POWER_MAX_SLEEP + WATCHDOG_SLEEP_MARGIN < WATCHDOG_TASK_TIMEOUT * 1000UL,
+              "The loop must wake up and feed the task watchdog before it expires");
+
+const char* const CAUSE_NAMES[] = {"plazo de la etapa", "task watchdog"};
+const char* const RESET_NAMES[] = {
+    "unknown", "poweron", "ext", "sw", "panic", "int_wdt", "task_wdt", "wdt", "deepsleep", "brownout", "sdio"
+};
+
+esp_timer_handle_t deadlineTimer = nullptr;
+
+// Written by the loop, read by the deadline timer task and the task watchdog ISR
+portMUX_TYPE stateMux = portMUX_INITIALIZER_UNLOCKED;
+uint8_t currentStage = STAGE_BOOT;
+int64_t stageStart = 0;
+uint32_t stageDeadline = WATCHDOG_TASK_TIMEOUT * 1000UL;
+int64_t iterationStart = 0;
+uint32_t currentMicros[LoopProfiler::STAGE_COUNT] = {};
+uint32_t lastMicros[LoopProfiler::STAGE_COUNT] = {};
+uint32_t actuators = 0;
+
+HangRecord lastHang = {};
+bool lastHangValid = false;
+
+// Called from the task watchdog ISR too: IRAM only, no flash functions
+void IRAM_ATTR capture(Cause cause) {
+    int64_t now = esp_timer_get_time();
+    portENTER_CRITICAL_SAFE(&stateMux);
+    hangRecord.magic = HANG_MAGIC;
+    hangRecord.cause = cause;
+    hangRecord.stage = currentStage;
+    hangRecord.resetReason = 0;
+    hangRecord.reserved = 0;
+    hangRecord.elapsedMillis = (uint32_t)(now - stageStart) / 1000;
+    hangRecord.deadlineMillis = stageDeadline;
+    hangRecord.uptimeSeconds = (uint32_t)(now / 1000000);
+    hangRecord.actuatorState = actuators;
+    memcpy(hangRecord.lastLoopMicros, lastMicros, sizeof(lastMicros));
+    memcpy(hangRecord.hungLoopMicros, currentMicros, sizeof(currentMicros));
+    if (currentStage < LoopProfiler::STAGE_COUNT) {
+        hangRecord.hungLoopMicros[currentStage] += (uint32_t)(now - stageStart);
+    }
+    hangRecord.hungLoopMicros[LoopProfiler::STAGE_LOOP] = iterationStart ? (uint32_t)(now - iterationStart) : 0;
+    portEXIT_CRITICAL_SAFE(&stateMux);
+    hangRecord.crc = esp_rom_crc32_le(0, (const uint8_t*)&hangRecord, offsetof(HangRecord, crc));
+}
+
+void onDeadline(void* arg) {
+    (void)arg;
+    // The loop may have moved on while this callback waited for the timer task
+    portENTER_CRITICAL(&stateMux);
+    bool expired = esp_timer_get_time() - stageStart >= (int64_t)stageDeadline * 1000;
+    portEXIT_CRITICAL(&stateMux);
+    if (!expired) {
+        return;
+    }
+    capture(CAUSE_DEADLINE);
+    Serial.printf("[Supervisor] Etapa %s bloqueada más de %lu ms, reiniciando\n", stageName(hangRecord.stage),
+                  (unsigned long)hangRecord.deadlineMillis);
+    Serial.flush();
+    esp_restart();
+}
+
+// Loop task: closes the running stage and starts the next one with its deadline
+void switchStage(uint8_t stage, uint32_t deadline) {
+    int64_t now = esp_timer_get_time();
+    portENTER_CRITICAL(&stateMux);
+    if (currentStage < LoopProfiler::STAGE_COUNT) {
+        currentMicros[currentStage] += (uint32_t)(now - stageStart);
+    }
+    currentStage = stage;
+    stageStart = now;
+    stageDeadline = deadline;
+    portEXIT_CRITICAL(&stateMux);
+
+    esp_task_wdt_reset();
+    if (deadlineTimer) {
+        esp_timer_stop(deadlineTimer);  // ESP_ERR_INVALID_STATE if it was not running
+        esp_timer_start_once(deadlineTimer, (uint64_t)deadline * 1000);
+    }
+}
+
+void printStages(const char* title, const uint32_t* micros) {
+    Serial.printf("[Supervisor] %s (µs):", title);
+    for (uint8_t i = 0; i < LoopProfiler::STAGE_COUNT; i++) {
+        Serial.printf(" %s=%lu", stageName(i), (unsigned long)micros[i]);
+    }
+    Serial.println();
+}
+
+} // namespace
+
+// Task watchdog ISR (weak in IDF): the loop task missed WATCHDOG_TASK_TIMEOUT, the panic handler resets next
+extern "C" void IRAM_ATTR esp_task_wdt_isr_user_handler(void) {
+    capture(CAUSE_TASK_WATCHDOG);
+}
+
+// cppcheck-suppress unusedFunction
+void begin() {
+    uint8_t reason = (uint8_t)esp_reset_reason();
+    // Power-on leaves random contents: the CRC tells a real record apart
+    lastHangValid = hangRecord.magic == HANG_MAGIC &&
+                    hangRecord.crc == esp_rom_crc32_le(0, (const uint8_t*)&hangRecord, offsetof(HangRecord, crc));
+    if (lastHangValid) {
+        lastHang = hangRecord;
+        lastHang.resetReason = reason;
+    }
+    hangRecord.magic = 0;
+
+    if (lastHangValid) {
+        Serial.printf("[Supervisor] Reinicio por bloqueo (%s): etapa %s a los %lu ms, plazo %lu ms, tras %lu s en marcha, reset %s\n",
+                      causeName(lastHang.cause), stageName(lastHang.stage), (unsigned long)lastHang.elapsedMillis,
+                      (unsigned long)lastHang.deadlineMillis, (unsigned long)lastHang.uptimeSeconds,
+                      resetReasonName(reason));
+        printStages("Última iteración completa", lastHang.lastLoopMicros);
+        printStages("Iteración bloqueada", lastHang.hungLoopMicros);
+    } else {
+        Serial.printf("[Supervisor] Arranque, reset %s\n", resetReasonName(reason));
+    }
+
+    if constexpr (WATCHDOG_ENABLED) {
+        // Already running for the idle tasks: this updates the timeout and subscribes the loop task
+        esp_task_wdt_init(WATCHDOG_TASK_TIMEOUT, true);
+        esp_task_wdt_add(NULL);
+
+        esp_timer_create_args_t args = {};
+        args.callback = onDeadline;
+        args.name = "supervisor";
+        if (esp_timer_create(&args, &deadlineTimer) != ESP_OK) {
+            deadlineTimer = nullptr;
+            Serial.println("[Supervisor] Error: sin temporizador, solo queda el task watchdog");
+        }
+        Serial.printf("[Supervisor] Watchdog del loop activo (%d s, plazos por etapa)\n", WATCHDOG_TASK_TIMEOUT);
+    }
+}
+
+// cppcheck-suppress unusedFunction
+void beginIteration() {
+    if constexpr (!WATCHDOG_ENABLED) return;
+    portENTER_CRITICAL(&stateMux);
+    memset(currentMicros, 0, sizeof(currentMicros));
+    currentStage = STAGE_SLEEP;
+    iterationStart = esp_timer_get_time();
+    portEXIT_CRITICAL(&stateMux);
+    switchStage(LoopProfiler::STAGE_TIME, DEADLINES[LoopProfiler::STAGE_TIME]);
+}
+
+// cppcheck-suppress unusedFunction
+void enter(LoopProfiler::Stage stage) {
+    if constexpr (!WATCHDOG_ENABLED) return;
+    switchStage(stage, DEADLINES[stage]);
+}
+
+// cppcheck-suppress unusedFunction
+void endIteration(uint32_t actuatorState) {
+    if constexpr (!WATCHDOG_ENABLED) return;
+    switchStage(LoopProfiler::STAGE_LOOP, DEADLINES[LoopProfiler::STAGE_LOOP]);
+    portENTER_CRITICAL(&stateMux);
+    currentMicros[LoopProfiler::STAGE_LOOP] = (uint32_t)(stageStart - iterationStart);
+    memcpy(lastMicros, currentMicros, sizeof(currentMicros));
+    actuators = actuatorState;
+    portEXIT_CRITICAL(&stateMux);
+}
+
+// cppcheck-suppress unusedFunction
+void sleeping() {
+    if constexpr (!WATCHDOG_ENABLED) return;
+    switchStage(STAGE_SLEEP, SLEEP_DEADLINE);
+}
+
+// cppcheck-suppress unusedFunction
+bool getLastHang(HangRecord& record) {
+    if (lastHangValid) {
+        record = lastHang;
+    }
+    return lastHangValid;
+}
+
+const char* stageName(uint8_t stage) {
+    if (stage == STAGE_SLEEP) return "sleep";
+    if (stage == STAGE_BOOT) return "boot";
+    return LoopProfiler::stageName((LoopProfiler::Stage)stage);
+}
+
+const char* causeName(uint8_t cause) {
+    return cause < sizeof(CAUSE_NAMES) / sizeof(CAUSE_NAMES[0]) ? CAUSE_NAMES[cause] : "?";
+}
+
+const char* resetReasonName(uint8_t reason) {
+    return reason < sizeof(RESET_NAMES) / sizeof(RESET_NAMES[0]) ? RESET_NAMES[reason] : "?";
+}
+
+} // namespace Supervisor
@@ -1,16 +1,28 @@
 #include "system/SystemManager.h"
 #include "config/credentials.h"
 #include "logic/LogicManager.h"
+#include "system/Metrics.h"
+#include "system/LoopProfiler.h"
+#include "system/PowerManager.h"
+#include "system/StateSnapshot.h"
+#include "system/Supervisor.h"
 
 // Instancia estática para callbacks
 SystemManager* SystemManager::instance = nullptr;
 
 SystemManager::SystemManager(WiFiManager& wifi, BlynkManager& blynk) 
-    : wifiManager(&wifi), blynkManager(&blynk), wifiConnected(false), blynkConnected(false), sensorsReady(false) {
+    : wifiManager(&wifi), blynkManager(&blynk), wifiConnected(false), blynkConnected(false), sensorsReady(false),
+      lastProfileReport(0) {
     instance = this;
     sensorManager = new SensorManager(blynk);
     logicManager = new LogicManager();
     actuatorManager = new ActuatorManager(blynk);
+    timeManager = new TimeManager();
+    settingsStore = new SettingsStore();
+    webServerManager = new WebServerManager();
+    telemetryManager = new TelemetryManager();
+    mqttTelemetry = MQTT_ENABLED ? new MqttTelemetry() : nullptr;
+    modbusManager = new ModbusManager();
 }
 
 SystemManager::~SystemManager() {
@@ -23,6 +35,24 @@ SystemManager::~SystemManager() {
     if (actuatorManager) {
         delete actuatorManager;
     }
+    if (timeManager) {
+        delete timeManager;
+    }
+    if (settingsStore) {
+        delete settingsStore;
+    }
+    if (webServerManager) {
+        delete webServerManager;
+    }
+    if (telemetryManager) {
+        delete telemetryManager;
+    }
+    if (mqttTelemetry) {
+        delete mqttTelemetry;
+    }
+    if (modbusManager) {
+        delete modbusManager;
+    }
 }
 
 // cppcheck-suppress unusedFunction
@@ -35,71 +65,291 @@ bool SystemManager::initialize() {
     blynkManager->onConnect(onBlynkConnectCallback);
     blynkManager->onDisconnect(onBlynkDisconnectCallback);
     
-    // Inicializar WiFiManager
-    if (!wifiManager->begin()) {
-        return false;
-    }
+    // Espera adaptativa del loop y sueño ligero
+    PowerManager::begin();
     
-    // Conectar a WiFi
-    wifiManager->setCredentials(WIFI_SSID, WIFI_PASSWORD);
-    if (!wifiManager->connectToWiFi()) {
-        return false;
-    }
+    // Watchdog del loop; informa del bloqueo que causó el reinicio anterior, si lo hubo
+    Supervisor::begin();
     
-    // Configurar Blynk
-    blynkManager->begin(BLYNK_AUTH_TOKEN);
+    // Estado del arranque anterior en RTC; el bloqueo, si lo hubo, también cuenta como tiempo transcurrido
+    Supervisor::HangRecord hang;
+    StateSnapshot::begin(Supervisor::getLastHang(hang) ? hang.hungLoopMicros[LoopProfiler::STAGE_LOOP] / 1000 : 0);
     
-    // Inicializar sensores
-    if (sensorManager->begin()) {
-        sensorsReady = true;
-        Serial.println("Sensores inicializados");
-    } else {
-        Serial.println("Error al inicializar sensores");
+    // Fases inmediatas del grafo de arranque; las diferidas las completa el loop
+    for (const Boot::PhaseEntry& entry : Boot::PHASES) {
+        if (entry.deferred || !boot.isReady(entry.phase)) {
+            continue;
+        }
+        unsigned long startedAt = millis();
+        bool ok = runBootPhase(entry.phase);
+        boot.finish(entry.phase, ok, startedAt);
+        if (!ok && entry.required) {
+            return false;
+        }
     }
     
-    // Inicializar actuadores
-    if (actuatorManager->begin()) {
-        Serial.println("Actuadores inicializados");
-    } else {
-        Serial.println("Error al inicializar actuadores");
-        return false;
+    return true;
+}
+
+// Traza de lecturas para reproducir en el PC (entorno native_replay)
+void SystemManager::beginSensorTrace() {
+#if SENSOR_TRACE_OUTPUT == SENSOR_TRACE_SERIAL
+    sensorTrace.begin(Serial, true, 0);
+    sensorManager->setTraceRecorder(&sensorTrace);
+    Serial.println("[SystemManager] Traza de sensores por Serial (líneas #T)");
+#elif SENSOR_TRACE_OUTPUT == SENSOR_TRACE_FILE
+    if (!LittleFS.begin(false)) {
+        Serial.println("[SystemManager] Error: LittleFS no disponible, traza de sensores desactivada");
+        return;
     }
-    
-    // Inicializar LogicManager
-    if (logicManager->begin(sensorManager, actuatorManager, blynkManager)) {
-        Serial.println("LogicManager inicializado");
-    } else {
-        Serial.println("Error al inicializar LogicManager");
-        return false;
+    // Se conserva la traza del arranque anterior (el fallo suele estar justo antes del reinicio)
+    if (LittleFS.exists(SENSOR_TRACE_PATH)) {
+        LittleFS.remove(SENSOR_TRACE_PREVIOUS_PATH);
+        LittleFS.rename(SENSOR_TRACE_PATH, SENSOR_TRACE_PREVIOUS_PATH);
+    }
+    traceFile = LittleFS.open(SENSOR_TRACE_PATH, FILE_WRITE);
+    if (!traceFile) {
+        Serial.println("[SystemManager] Error: no se pudo crear " SENSOR_TRACE_PATH);
+        return;
+    }
+    sensorTrace.begin(traceFile, false, SENSOR_TRACE_MAX_BYTES);
+    sensorManager->setTraceRecorder(&sensorTrace);
+    Serial.println("[SystemManager] Traza de sensores en " SENSOR_TRACE_PATH);
+#endif
+}
+
+bool SystemManager::runBootPhase(Boot::Phase phase) {
+    switch (phase) {
+        case Boot::PHASE_ACTUATORS:
+            // Primero las salidas: cada actuador arranca apagado
+            if (actuatorManager->begin()) {
+                Serial.println("Actuadores inicializados");
+                // Tras un reinicio en caliente, las salidas vuelven como estaban sin esperar a la lógica
+                Supervisor::HangRecord hang;
+                if (const StateSnapshot::State* snapshot = StateSnapshot::getRestored()) {
+                    actuatorManager->restoreState(*snapshot);
+                } else if (Supervisor::getLastHang(hang)) {
+                    actuatorManager->restoreSafeState(hang.actuatorState);
+                }
+                return true;
+            }
+            Serial.println("Error al inicializar actuadores");
+            return false;
+            
+        case Boot::PHASE_SETTINGS:
+            // Targets y ajustes guardados, antes de cualquier controlador
+            settingsStore->begin();
+            return true;
+            
+        case Boot::PHASE_SENSORS:
+            // Sin esperas: cada sensor no se lee hasta terminar su estabilización
+            if (sensorManager->begin()) {
+                sensorsReady = true;
+                Serial.println("Sensores inicializados");
+                beginSensorTrace();
+                return true;
+            }
+            Serial.println("Error al inicializar sensores");
+            return false;
+            
+        case Boot::PHASE_LOGIC:
+            if (logicManager->begin(sensorManager, actuatorManager, blynkManager, timeManager, settingsStore)) {
+                Serial.println("LogicManager inicializado");
+                // Modo automático, integradores y riego interrumpido del arranque anterior
+                if (const StateSnapshot::State* snapshot = StateSnapshot::getRestored()) {
+                    logicManager->restoreState(*snapshot);
+                }
+                return true;
+            }
+            Serial.println("Error al inicializar LogicManager");
+            return false;
+            
+        case Boot::PHASE_NETWORK:
+            if (!wifiManager->begin()) {
+                return false;
+            }
+            // Hora local (SNTP necesita la pila de red ya iniciada)
+            timeManager->onDayRollover(onDayRolloverCallback);
+            timeManager->begin();
+            // Blynk antes de que conecte el WiFi: onWiFiConnect lo necesita configurado
+            blynkManager->begin(BLYNK_AUTH_TOKEN);
+            // Conexión en segundo plano; el loop notifica onWiFiConnect
+            wifiManager->setCredentials(WIFI_SSID, WIFI_PASSWORD);
+            return wifiManager->startConnection();
+            
+        case Boot::PHASE_SERVICES: {
+            bool ok = true;
+            // Panel web local (opcional: el control sigue sin él)
+            if (webServerManager->begin(sensorManager, actuatorManager, logicManager, timeManager)) {
+                Serial.println("Servidor web iniciado");
+            } else {
+                Serial.println("Error al iniciar el servidor web");
+                ok = false;
+            }
+            
+            // Telemetría hacia MQTT (opcional, como el panel web)
+            if (telemetryManager->begin(sensorManager, actuatorManager, timeManager)) {
+                if (mqttTelemetry && mqttTelemetry->begin(MQTT_BROKER_HOST, MQTT_BROKER_PORT, MQTT_USER, MQTT_PASSWORD)) {
+                    telemetryManager->addSink(mqttTelemetry);
+                }
+            } else {
+                Serial.println("Error al iniciar la telemetría");
+                ok = false;
+            }
+            
+            // Esclavo Modbus para PLC/SCADA (opcional)
+            if (modbusManager->begin(sensorManager, actuatorManager, logicManager)) {
+                Serial.println("Modbus iniciado");
+            } else {
+                Serial.println("Error al iniciar Modbus");
+                ok = false;
+            }
+            return ok;
+        }
+            
+        default:
+            return false;
+    }
+}
+
+void SystemManager::advanceBoot() {
+    if (boot.isComplete()) {
+        return;
     }
     
-    return true;
+    // Lecturas mínimas para controlar el clima, o control con lo que haya pasado el plazo
+    if (boot.isReady(Boot::PHASE_SENSORS_READY)) {
+        bool valid = sensorsReady && sensorManager->hasControlReadings();
+        if (valid || millis() >= BOOT_SENSOR_TIMEOUT) {
+            boot.finish(Boot::PHASE_SENSORS_READY, valid, 0);
+        }
+    }
+    if (boot.isReady(Boot::PHASE_CONTROL)) {
+        boot.finish(Boot::PHASE_CONTROL, true, 0);
+    }
+    if (boot.isReady(Boot::PHASE_WIFI_CONNECTED) && wifiConnected) {
+        boot.finish(Boot::PHASE_WIFI_CONNECTED, true, 0);
+    }
+    boot.printSummaryOnce();
 }
 
 void SystemManager::update() {
+    unsigned long start = micros();
+    LoopProfiler::Stopwatch stopwatch;
+    Supervisor::beginIteration();
+    StateSnapshot::touch();
+    
+    // Fases diferidas del arranque (lecturas mínimas, primer control, WiFi)
+    advanceBoot();
+    
+    // Hora local y eventos de calendario
+    timeManager->update();
+    stopwatch.mark(LoopProfiler::STAGE_TIME);
+    
+    // Escritura diferida de targets y ajustes
+    Supervisor::enter(LoopProfiler::STAGE_SETTINGS);
+    settingsStore->update();
+    stopwatch.mark(LoopProfiler::STAGE_SETTINGS);
+    
     // Gestionar reconexiones
+    Supervisor::enter(LoopProfiler::STAGE_WIFI);
     wifiManager->attemptReconnection();
+    stopwatch.mark(LoopProfiler::STAGE_WIFI);
+    Supervisor::enter(LoopProfiler::STAGE_BLYNK);
     blynkManager->attemptReconnection();
     
     // Ejecutar Blynk si está conectado
     if (blynkConnected) {
         blynkManager->run();
     }
+    stopwatch.mark(LoopProfiler::STAGE_BLYNK);
     
     // Actualizar sensores
+    Supervisor::enter(LoopProfiler::STAGE_SENSORS);
     if (sensorsReady) {
         sensorManager->update();
+        sensorTrace.clock(timeManager->now());
     }
+    stopwatch.mark(LoopProfiler::STAGE_SENSORS);
     
     // Actualizar actuadores
+    Supervisor::enter(LoopProfiler::STAGE_ACTUATORS);
     if (actuatorManager) {
         actuatorManager->update();
     }
+    stopwatch.mark(LoopProfiler::STAGE_ACTUATORS);
     
-    // Actualizar lógica de control
-    if (logicManager) {
+    // Actualizar lógica de control (desde que el arranque lo permite)
+    Supervisor::enter(LoopProfiler::STAGE_LOGIC);
+    if (logicManager && boot.isFinished(Boot::PHASE_CONTROL)) {
         logicManager->update();
     }
+    stopwatch.mark(LoopProfiler::STAGE_LOGIC);
+    
+    // Publicar datos para el panel web y aplicar sus cambios
+    Supervisor::enter(LoopProfiler::STAGE_WEB);
+    webServerManager->update();
+    stopwatch.mark(LoopProfiler::STAGE_WEB);
+    
+    // Muestras de telemetría, reconexión y reenvíos
+    Supervisor::enter(LoopProfiler::STAGE_TELEMETRY);
+    telemetryManager->update();
+    stopwatch.mark(LoopProfiler::STAGE_TELEMETRY);
+    
+    // Imagen de registros Modbus, escrituras recibidas y RTU
+    Supervisor::enter(LoopProfiler::STAGE_MODBUS);
+    modbusManager->update();
+    stopwatch.mark(LoopProfiler::STAGE_MODBUS);
+    
+    stopwatch.finish();
+    Metrics::observe(Metrics::LOOP_DURATION, micros() - start);
+    // Perfil de la iteración y estado de las salidas, por si la siguiente se bloquea
+    Supervisor::endIteration(actuatorManager->getSafeState());
+    
+    // Estado para el arranque en caliente (solo se reescribe si ha cambiado)
+    StateSnapshot::State snapshot = {};
+    actuatorManager->saveState(snapshot);
+    logicManager->saveState(snapshot);
+    StateSnapshot::update(snapshot);
+    
+    // Informe periódico del perfilador
+    if (LOOP_PROFILER_ENABLED && LOOP_PROFILER_REPORT_INTERVAL > 0 &&
+        millis() - lastProfileReport >= LOOP_PROFILER_REPORT_INTERVAL) {
+        lastProfileReport = millis();
+        LoopProfiler::printReport();
+    }
+}
+
+// cppcheck-suppress unusedFunction
+unsigned long SystemManager::getIdleTime() {
+    // WiFi, Blynk.run() y reconexiones no anuncian su próximo trabajo
+    unsigned long idle = POWER_NETWORK_POLL_INTERVAL;
+    
+    // Fases diferidas del arranque: lecturas mínimas y primer control
+    if (!boot.isFinished(Boot::PHASE_CONTROL)) {
+        idle = min(idle, (unsigned long)POWER_BUSY_POLL_INTERVAL);
+    }
+    
+    idle = min(idle, timeManager->getIdleTime());
+    idle = min(idle, settingsStore->getIdleTime());
+    if (sensorsReady) {
+        idle = min(idle, sensorManager->getIdleTime());
+    }
+    idle = min(idle, actuatorManager->getIdleTime());
+    if (boot.isFinished(Boot::PHASE_CONTROL)) {
+        idle = min(idle, logicManager->getIdleTime());
+    }
+    idle = min(idle, webServerManager->getIdleTime());
+    idle = min(idle, telemetryManager->getIdleTime());
+    idle = min(idle, modbusManager->getIdleTime());
+    return idle;
+}
+
+// cppcheck-suppress unusedFunction
+void SystemManager::sleepUntilNextTask() {
+    Supervisor::sleeping();
+    // Sin sueño ligero mientras el LEDC genera PWM (servo, LEDs regulados)
+    PowerManager::sleep(getIdleTime(), actuatorManager->needsPwmClock());
 }
 
 // Callbacks estáticos
@@ -119,9 +369,14 @@ void SystemManager::onBlynkDisconnectCallback() {
     if (instance) instance->onBlynkDisconnect();
 }
 
+void SystemManager::onDayRolloverCallback() {
+    if (instance && instance->logicManager) instance->logicManager->resetDailyStatistics();
+}
+
 // Implementación de callbacks
 void SystemManager::onWiFiConnect() {
     wifiConnected = true;
+    PowerManager::configureWiFi();
     
     // Intentar conectar a Blynk cuando WiFi esté conectado
     if (blynkManager->begin()) {
@@ -0,0 +1,239 @@
+#include "system/TimeManager.h"
+#include "config/config.h"
+
+TimeManager::TimeManager() :
+    sntpSource(),
+    rtcSource(),
+    primary(&sntpSource),
+    fallback(&rtcSource),
+    activeSource("NONE"),
+    anchored(false),
+    anchoredToPrimary(false),
+    anchorEpochMs(0),
+    anchorMillis(0),
+    driftPpm(0.0),
+    driftKnown(false),
+    lastSyncAttempt(0),
+    lastSync(0),
+    cachedEpoch(0),
+    cachedLocal(),
+    lastMinuteKey(-1),
+    lastDayKey(-1),
+    minuteCallback(nullptr),
+    dayCallback(nullptr)
+{
+}
+
+bool TimeManager::begin() {
+    setenv("TZ", TIME_TIMEZONE, 1);
+    tzset();
+
+    bool success = true;
+    if (primary) success &= primary->begin();
+    if (fallback) fallback->begin();
+
+    // Start from the fallback right away if it already holds a valid time
+    pollSources(millis());
+
+    Serial.println(String("[TimeManager] Initialized - ") + getTimeString());
+    return success;
+}
+
+void TimeManager::update() {
+    unsigned long nowMillis = millis();
+
+    unsigned long interval = anchoredToPrimary ? TIME_SYNC_INTERVAL : TIME_RETRY_INTERVAL;
+    if (nowMillis - lastSyncAttempt >= interval) {
+        pollSources(nowMillis);
+    }
+
+    if (!anchored) return;
+
+    // Keep the elapsed time well inside the millis() range
+    if (nowMillis - anchorMillis > 86400000UL) {
+        anchorEpochMs = extrapolate(nowMillis);
+        anchorMillis = nowMillis;
+    }
+
+    time_t epoch = (time_t)(extrapolate(nowMillis) / 1000);
+    if (epoch != cachedEpoch) {
+        refreshCache(epoch);
+        emitEvents();
+    }
+}
+
+// cppcheck-suppress unusedFunction
+unsigned long TimeManager::getIdleTime() const {
+    unsigned long nowMillis = millis();
+    unsigned long interval = anchoredToPrimary ? TIME_SYNC_INTERVAL : TIME_RETRY_INTERVAL;
+    unsigned long sinceAttempt = nowMillis - lastSyncAttempt;
+    unsigned long idle = sinceAttempt >= interval ? 0 : interval - sinceAttempt;
+    if (!anchored) return idle;
+
+    // Minute and day events fire on the first update() of the new minute
+    int64_t epochMs = extrapolate(nowMillis);
+    unsigned long toMinute = (unsigned long)(60000 - epochMs % 60000);
+    return toMinute < idle ? toMinute : idle;
+}
+
+void TimeManager::pollSources(unsigned long nowMillis) {
+    lastSyncAttempt = nowMillis;
+    struct timeval tv;
+
+    if (primary && primary->read(tv)) {
+        // Drift is only measured between two readings of a reference source
+        anchorTo(tv, nowMillis, anchoredToPrimary && primary->isAuthoritative());
+        anchoredToPrimary = true;
+        activeSource = primary->getName();
+        if (fallback) {
+            fallback->write(tv);
+        }
+        return;
+    }
+
+    if (!anchored && fallback && fallback->read(tv)) {
+        anchorTo(tv, nowMillis, false);
+        activeSource = fallback->getName();
+        Serial.println(String("[TimeManager] Using fallback clock: ") + activeSource);
+    }
+}
+
+void TimeManager::anchorTo(const struct timeval& tv, unsigned long atMillis, bool measureDrift) {
+    int64_t epochMs = (int64_t)tv.tv_sec * 1000 + tv.tv_usec / 1000;
+
+    if (anchored && measureDrift) {
+        unsigned long span = atMillis - lastSync;
+        if (span >= TIME_MIN_DRIFT_WINDOW) {
+            // Error left over by the current correction over the last sync window
+            float errorMs = (float)(epochMs - extrapolate(atMillis));
+            float observed = driftPpm + errorMs * 1000000.0 / span;
+            if (fabs(observed) <= TIME_MAX_DRIFT_PPM) {
+                driftPpm = driftKnown ? 0.7 * driftPpm + 0.3 * observed : observed;
+                driftKnown = true;
+            } else {
+                // A clock step, not drift
+                Serial.println(String("[TimeManager] Clock stepped by ") + (long)errorMs + " ms");
+            }
+        }
+    }
+
+    anchorEpochMs = epochMs;
+    anchorMillis = atMillis;
+    lastSync = atMillis;
+    anchored = true;
+}
+
+int64_t TimeManager::extrapolate(unsigned long nowMillis) const {
+    unsigned long elapsed = nowMillis - anchorMillis;
+    return anchorEpochMs + elapsed + (int64_t)(elapsed * driftPpm / 1000000.0);
+}
+
+void TimeManager::refreshCache(time_t epoch) {
+    cachedEpoch = epoch;
+    localtime_r(&cachedEpoch, &cachedLocal);
+}
+
+void TimeManager::emitEvents() {
+    long minuteKey = (long)(cachedEpoch / 60);
+    long dayKey = (cachedLocal.tm_year + 1900) * 1000L + cachedLocal.tm_yday;
+
+    // Day rollover fires once per calendar day, even if a sync steps the clock back
+    if (lastDayKey < 0) {
+        lastDayKey = dayKey;
+    } else if (dayKey > lastDayKey) {
+        lastDayKey = dayKey;
+        Serial.println("[TimeManager] Day rollover: " + getTimeString());
+        if (dayCallback) dayCallback();
+    }
+
+    if (lastMinuteKey < 0 || minuteKey < lastMinuteKey - 1) {
+        // First valid time, or the clock was stepped back
+        lastMinuteKey = minuteKey;
+    } else if (minuteKey > lastMinuteKey) {
+        lastMinuteKey = minuteKey;
+        if (minuteCallback) minuteCallback();
+    }
+}
+
+// Time sources
+// cppcheck-suppress unusedFunction
+void TimeManager::setPrimarySource(TimeSource* source) {
+    primary = source;
+    anchoredToPrimary = false;
+}
+
+// cppcheck-suppress unusedFunction
+void TimeManager::setFallbackSource(TimeSource* source) {
+    fallback = source;
+}
+
+// Calendar events
+// cppcheck-suppress unusedFunction
+void TimeManager::onMinuteTick(CalendarCallback callback) {
+    minuteCallback = callback;
+}
+
+// cppcheck-suppress unusedFunction
+void TimeManager::onDayRollover(CalendarCallback callback) {
+    dayCallback = callback;
+}
+
+// Local time
+bool TimeManager::isValid() const {
+    return anchored && cachedEpoch != 0;
+}
+
+// cppcheck-suppress unusedFunction
+time_t TimeManager::now() const {
+    return isValid() ? cachedEpoch : 0;
+}
+
+// cppcheck-suppress unusedFunction
+uint8_t TimeManager::getHour() const {
+    return isValid() ? cachedLocal.tm_hour : INVALID_TIME;
+}
+
+// cppcheck-suppress unusedFunction
+uint8_t TimeManager::getMinute() const {
+    return isValid() ? cachedLocal.tm_min : INVALID_TIME;
+}
+
+// cppcheck-suppress unusedFunction
+uint8_t TimeManager::getSecond() const {
+    return isValid() ? cachedLocal.tm_sec : INVALID_TIME;
+}
+
+// cppcheck-suppress unusedFunction
+uint8_t TimeManager::getWeekDay() const {
+    return isValid() ? cachedLocal.tm_wday : INVALID_TIME;
+}
+
+// cppcheck-suppress unusedFunction
+const struct tm& TimeManager::getLocalTime() const {
+    return cachedLocal;
+}
+
+// Status
+// cppcheck-suppress unusedFunction
+const char* TimeManager::getSourceName() const {
+    return activeSource;
+}
+
+// cppcheck-suppress unusedFunction
+float TimeManager::getDriftPpm() const {
+    return driftPpm;
+}
+
+// cppcheck-suppress unusedFunction
+unsigned long TimeManager::getTimeSinceSync() const {
+    return anchored ? millis() - lastSync : 0;
+}
+
+String TimeManager::getTimeString() const {
+    if (!isValid()) {
+        return "--:-- (sin hora)";
+    }
+    char buffer[24];
+    strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &cachedLocal);
+    return String(buffer) + " (" + activeSource + ", " + String(driftPpm, 1) + " ppm)";
+}
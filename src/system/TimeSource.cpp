@@ -0,0 +1,71 @@
+#include "system/TimeSource.h"
+#include "config/config.h"
+#include <esp_sntp.h>
+
+// ===== SntpTimeSource =====
+
+volatile bool SntpTimeSource::syncPending = false;
+
+void SntpTimeSource::onSync(struct timeval* tv) {
+    (void)tv;
+    syncPending = true;
+}
+
+bool SntpTimeSource::begin() {
+    // Requiere la pila de red iniciada (WiFi.mode); SNTP reintenta solo hasta que haya conexión
+    sntp_set_time_sync_notification_cb(onSync);
+    configTzTime(TIME_TIMEZONE, TIME_NTP_SERVER_1, TIME_NTP_SERVER_2);
+    Serial.println(String("[TimeSource] SNTP: ") + TIME_NTP_SERVER_1 + ", " + TIME_NTP_SERVER_2);
+    return true;
+}
+
+bool SntpTimeSource::read(struct timeval& tv) {
+    if (!syncPending) return false;
+    syncPending = false;
+
+    // SNTP has just set the system clock
+    gettimeofday(&tv, nullptr);
+    return tv.tv_sec >= TIME_MIN_VALID_EPOCH;
+}
+
+// ===== RtcTimeSource =====
+
+bool RtcTimeSource::begin() {
+    return true;
+}
+
+bool RtcTimeSource::read(struct timeval& tv) {
+    gettimeofday(&tv, nullptr);
+    return tv.tv_sec >= TIME_MIN_VALID_EPOCH;
+}
+
+bool RtcTimeSource::write(const struct timeval& tv) {
+    return settimeofday(&tv, nullptr) == 0;
+}
+
+// ===== ManualTimeSource =====
+
+ManualTimeSource::ManualTimeSource() : pendingEpochMs(0), pendingMillis(0), hasPending(false) {
+}
+
+bool ManualTimeSource::begin() {
+    return true;
+}
+
+bool ManualTimeSource::read(struct timeval& tv) {
+    if (!hasPending) return false;
+    hasPending = false;
+    
+    // The time set, advanced to the moment of reading
+    int64_t epochMs = pendingEpochMs + (millis() - pendingMillis);
+    tv.tv_sec = epochMs / 1000;
+    tv.tv_usec = (epochMs % 1000) * 1000;
+    return true;
+}
+
+// cppcheck-suppress unusedFunction
+void ManualTimeSource::setTime(time_t epoch, long milliseconds) {
+    pendingEpochMs = (int64_t)epoch * 1000 + milliseconds;
+    pendingMillis = millis();
+    hasPending = epoch >= TIME_MIN_VALID_EPOCH;
+}
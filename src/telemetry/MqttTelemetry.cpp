@@ -0,0 +1,215 @@
+#include "telemetry/MqttTelemetry.h"
+#include "telemetry/TelemetryFrame.h"
+#include "web/JsonWriter.h"
+#include <WiFi.h>
+
+MqttTelemetry::MqttTelemetry() :
+    pendingAcks(),
+    pendingAckCount(0),
+    sessionStarted(false),
+    connected(false),
+    dataTopic(),
+    schemaTopic(),
+    statusTopic(),
+    initialized(false),
+    sequence(0),
+    lastConnectAttempt(0),
+    framesSent(0),
+    framesAcked(0)
+{
+    eventMutex = xSemaphoreCreateMutex();
+}
+
+MqttTelemetry::~MqttTelemetry() {
+    if (eventMutex) {
+        vSemaphoreDelete(eventMutex);
+    }
+}
+
+// cppcheck-suppress unusedFunction
+bool MqttTelemetry::begin(const char* host, uint16_t port, const char* user, const char* password) {
+    if (!eventMutex) {
+        Serial.println("[MqttTelemetry] Error: could not create mutex");
+        return false;
+    }
+
+    snprintf(dataTopic, sizeof(dataTopic), "%s/%s/t", MQTT_TOPIC_PREFIX, MQTT_NODE_ID);
+    snprintf(schemaTopic, sizeof(schemaTopic), "%s/%s/schema", MQTT_TOPIC_PREFIX, MQTT_NODE_ID);
+    snprintf(statusTopic, sizeof(statusTopic), "%s/%s/status", MQTT_TOPIC_PREFIX, MQTT_NODE_ID);
+
+    // The client keeps these pointers: host and credentials must outlive it
+    client.setServer(host, port);
+    client.setClientId(MQTT_NODE_ID);
+    client.setKeepAlive(MQTT_KEEP_ALIVE);
+    client.setCleanSession(true);
+    client.setWill(statusTopic, 1, true, "offline");
+    if (user) {
+        client.setCredentials(user, password);
+    }
+
+    client.onConnect([this](bool sessionPresent) {
+        (void)sessionPresent;
+        onConnect();
+    });
+    client.onDisconnect([this](AsyncMqttClientDisconnectReason reason) {
+        (void)reason;
+        onDisconnect();
+    });
+    client.onPublish([this](uint16_t packetId) { onPublishAck(packetId); });
+
+    initialized = true;
+    Serial.printf("[MqttTelemetry] Broker %s:%u, topic %s\n", host, (unsigned)port, dataTopic);
+    return true;
+}
+
+// AsyncTCP side: only record the event for the loop
+
+void MqttTelemetry::onConnect() {
+    xSemaphoreTake(eventMutex, portMAX_DELAY);
+    sessionStarted = true;
+    pendingAckCount = 0; // PUBACKs from the old session no longer match
+    xSemaphoreGive(eventMutex);
+    connected = true;
+}
+
+void MqttTelemetry::onDisconnect() {
+    connected = false;
+}
+
+void MqttTelemetry::onPublishAck(uint16_t packetId) {
+    xSemaphoreTake(eventMutex, portMAX_DELAY);
+    // If the list is full the frame is resent after MQTT_RETRY_INTERVAL (QoS 1 allows duplicates)
+    if (pendingAckCount < MQTT_OUTBOX_SIZE) {
+        pendingAcks[pendingAckCount++] = packetId;
+    }
+    xSemaphoreGive(eventMutex);
+}
+
+// Loop side
+
+void MqttTelemetry::startSession() {
+    outbox.resetInFlight();
+    client.publish(statusTopic, 1, true, "online");
+    publishSchema();
+    Serial.printf("[MqttTelemetry] Connected, %u frames queued\n", (unsigned)outbox.size());
+}
+
+void MqttTelemetry::processAcks() {
+    uint16_t acks[MQTT_OUTBOX_SIZE];
+    bool newSession;
+
+    xSemaphoreTake(eventMutex, portMAX_DELAY);
+    uint8_t ackCount = pendingAckCount;
+    memcpy(acks, pendingAcks, ackCount * sizeof(acks[0]));
+    pendingAckCount = 0;
+    newSession = sessionStarted;
+    sessionStarted = false;
+    xSemaphoreGive(eventMutex);
+
+    if (newSession) {
+        startSession();
+    }
+    for (uint8_t i = 0; i < ackCount; i++) {
+        if (outbox.acknowledge(acks[i])) framesAcked++;
+    }
+}
+
+void MqttTelemetry::sendPending(unsigned long now) {
+    Telemetry::Outbox::Entry* entry;
+    while ((entry = outbox.nextToSend(now, MQTT_RETRY_INTERVAL, MQTT_MAX_INFLIGHT)) != nullptr) {
+        // A retry keeps its packet id and sets DUP
+        bool retry = entry->packetId != 0;
+        uint16_t packetId = client.publish(dataTopic, 1, false, (const char*)entry->payload, entry->length,
+                                           retry, entry->packetId);
+        if (packetId == 0) {
+            return; // TCP buffer full: try again next loop
+        }
+        outbox.markSent(entry, packetId, now);
+        if (!retry) framesSent++;
+    }
+}
+
+bool MqttTelemetry::publishSchema() {
+    // Only the loop builds it, so one static buffer is enough
+    static char schema[MQTT_SCHEMA_MAX_SIZE];
+    JsonBuffer buffer(schema, sizeof(schema));
+    JsonWriter json(buffer, sizeof(schema) - 1);
+
+    json.beginObject();
+    json.add("version", (int)Telemetry::FRAME_VERSION);
+    json.beginArray("channels");
+    for (const Telemetry::ChannelInfo& channel : Telemetry::CHANNELS) {
+        json.beginObject();
+        json.add("id", (int)channel.id);
+        json.add("key", channel.key);
+        json.add("unit", channel.unit);
+        json.add("decimals", (int)channel.decimals);
+        json.endObject();
+    }
+    json.endArray();
+    json.endObject();
+
+    if (json.overflowed()) {
+        Serial.println("[MqttTelemetry] Error: schema does not fit MQTT_SCHEMA_MAX_SIZE");
+        return false;
+    }
+    return client.publish(schemaTopic, 1, true, buffer.c_str(), buffer.size()) != 0;
+}
+
+const char* MqttTelemetry::name() const {
+    return "MQTT";
+}
+
+bool MqttTelemetry::isConnected() const {
+    return connected;
+}
+
+void MqttTelemetry::publish(const Telemetry::Sample* samples, uint8_t count, uint32_t time) {
+    if (!initialized) return;
+
+    // Queued even while offline: the outbox keeps the most recent frames
+    uint8_t* slot = outbox.reserve();
+    size_t length = Telemetry::encodeFrame(slot, TELEMETRY_MAX_FRAME, time, sequence, samples, count);
+    if (length == 0) {
+        Serial.println("[MqttTelemetry] Error: frame does not fit TELEMETRY_MAX_FRAME");
+        return;
+    }
+    outbox.commit((uint8_t)length);
+    sequence++;
+}
+
+void MqttTelemetry::update() {
+    if (!initialized) return;
+
+    unsigned long now = millis();
+    if (!connected) {
+        if (WiFi.status() == WL_CONNECTED && now - lastConnectAttempt >= MQTT_RECONNECT_INTERVAL) {
+            lastConnectAttempt = now;
+            client.connect();
+        }
+        return;
+    }
+
+    processAcks();
+    sendPending(now);
+}
+
+// cppcheck-suppress unusedFunction
+uint8_t MqttTelemetry::getOutboxSize() const {
+    return outbox.size();
+}
+
+// cppcheck-suppress unusedFunction
+unsigned long MqttTelemetry::getDroppedCount() const {
+    return outbox.getDroppedCount();
+}
+
+// cppcheck-suppress unusedFunction
+unsigned long MqttTelemetry::getSentCount() const {
+    return framesSent;
+}
+
+// cppcheck-suppress unusedFunction
+unsigned long MqttTelemetry::getAckedCount() const {
+    return framesAcked;
+}
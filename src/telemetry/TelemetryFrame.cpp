@@ -0,0 +1,58 @@
+#include "telemetry/TelemetryFrame.h"
+
+namespace Telemetry {
+
+namespace {
+
+size_t writeVarint(uint8_t* out, uint32_t value) {
+    size_t length = 0;
+    while (value >= 0x80) {
+        out[length++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    out[length++] = (uint8_t)value;
+    return length;
+}
+
+uint32_t zigzag(int32_t value) {
+    return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+int32_t scale(float value, uint8_t decimals) {
+    float scaled = value;
+    for (uint8_t i = 0; i < decimals; i++) {
+        scaled *= 10.0f;
+    }
+    scaled = roundf(scaled);
+    // Saturate instead of wrapping on absurd readings
+    if (scaled > 2147483520.0f) return INT32_MAX;
+    if (scaled < -2147483520.0f) return INT32_MIN;
+    return (int32_t)scaled;
+}
+
+} // namespace
+
+size_t encodeFrame(uint8_t* buffer, size_t size, uint32_t time, uint16_t sequence,
+                   const Sample* samples, uint8_t count) {
+    if (size < FRAME_HEADER_SIZE) return 0;
+
+    buffer[0] = FRAME_VERSION;
+    for (uint8_t i = 0; i < 4; i++) {
+        buffer[1 + i] = (uint8_t)(time >> (8 * i));
+    }
+    buffer[5] = (uint8_t)sequence;
+    buffer[6] = (uint8_t)(sequence >> 8);
+
+    size_t length = FRAME_HEADER_SIZE;
+    for (uint8_t i = 0; i < count; i++) {
+        const ChannelInfo* channel = findChannel(samples[i].channel);
+        if (!channel || isnan(samples[i].value) || isinf(samples[i].value)) continue;
+        if (length + FRAME_MAX_SAMPLE_SIZE > size) return 0;
+
+        buffer[length++] = channel->id;
+        length += writeVarint(buffer + length, zigzag(scale(samples[i].value, channel->decimals)));
+    }
+    return length;
+}
+
+} // namespace Telemetry
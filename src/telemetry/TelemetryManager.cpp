@@ -0,0 +1,93 @@
+#include "telemetry/TelemetryManager.h"
+#include "sensors/SensorManager.h"
+#include "actuators/ActuatorManager.h"
+#include "system/TimeManager.h"
+
+TelemetryManager::TelemetryManager() :
+    sensorManager(nullptr),
+    actuatorManager(nullptr),
+    timeManager(nullptr),
+    sinks(),
+    sinkCount(0),
+    lastSample(0),
+    initialized(false)
+{
+}
+
+// cppcheck-suppress unusedFunction
+bool TelemetryManager::begin(SensorManager* sensors, ActuatorManager* actuators, TimeManager* clock) {
+    if (!sensors || !actuators) {
+        Serial.println("[TelemetryManager] Error: missing sensor or actuator manager");
+        return false;
+    }
+    sensorManager = sensors;
+    actuatorManager = actuators;
+    timeManager = clock;
+    initialized = true;
+    return true;
+}
+
+// cppcheck-suppress unusedFunction
+bool TelemetryManager::addSink(Telemetry::Sink* sink) {
+    if (!sink || sinkCount >= TELEMETRY_MAX_SINKS) {
+        return false;
+    }
+    sinks[sinkCount++] = sink;
+    Serial.printf("[TelemetryManager] Sink added: %s\n", sink->name());
+    return true;
+}
+
+uint8_t TelemetryManager::collect(Telemetry::Sample* samples) {
+    using namespace Telemetry;
+    uint8_t count = 0;
+    samples[count++] = {CH_TEMPERATURE, sensorManager->getTemperature()};
+    samples[count++] = {CH_HUMIDITY, sensorManager->getHumidity()};
+    samples[count++] = {CH_HEAT_INDEX, sensorManager->getHeatIndex()};
+    samples[count++] = {CH_LUX, sensorManager->getLux()};
+    samples[count++] = {CH_LIGHT_LUX, sensorManager->getLightLux()};
+    samples[count++] = {CH_SOIL_MOISTURE, sensorManager->getSoilMoisture()};
+    samples[count++] = {CH_SOIL_MOISTURE_RS485, sensorManager->getSoilMoistureRS485()};
+    samples[count++] = {CH_SOIL_TEMPERATURE, sensorManager->getSoilTemperature()};
+    samples[count++] = {CH_SOIL_EC, sensorManager->getSoilEC()};
+    samples[count++] = {CH_SOIL_PH, sensorManager->getSoilPH()};
+    samples[count++] = {CH_WATER_LEVEL, sensorManager->getWaterLevel()};
+    samples[count++] = {CH_WATER_PERCENTAGE, sensorManager->getWaterPercentage()};
+    samples[count++] = {CH_FAN, actuatorManager->obtenerEstadoVentilador() ? 1.0f : 0.0f};
+    samples[count++] = {CH_WATER_PUMP, actuatorManager->obtenerEstadoBombaAgua() ? 1.0f : 0.0f};
+    samples[count++] = {CH_HEATER, actuatorManager->obtenerEstadoCalefactor() ? 1.0f : 0.0f};
+    samples[count++] = {CH_LED_STRIP, actuatorManager->obtenerEstadoTiraLED() ? 1.0f : 0.0f};
+    samples[count++] = {CH_VENTILATION, actuatorManager->obtenerEstadoVentilacion() ? 1.0f : 0.0f};
+    return count;
+}
+
+void TelemetryManager::update() {
+    if (!initialized || sinkCount == 0) return;
+
+    for (uint8_t i = 0; i < sinkCount; i++) {
+        sinks[i]->update();
+    }
+
+    unsigned long now = millis();
+    if (lastSample != 0 && now - lastSample < TELEMETRY_INTERVAL) return;
+    lastSample = now;
+
+    Telemetry::Sample samples[Telemetry::CHANNEL_COUNT];
+    uint8_t count = collect(samples);
+    uint32_t time = (timeManager && timeManager->isValid()) ? (uint32_t)timeManager->now() : 0;
+    for (uint8_t i = 0; i < sinkCount; i++) {
+        sinks[i]->publish(samples, count, time);
+    }
+}
+
+// cppcheck-suppress unusedFunction
+unsigned long TelemetryManager::getIdleTime() const {
+    if (!initialized || sinkCount == 0) return ULONG_MAX;
+    if (lastSample == 0) return 0;
+    unsigned long elapsed = millis() - lastSample;
+    return elapsed >= TELEMETRY_INTERVAL ? 0 : TELEMETRY_INTERVAL - elapsed;
+}
+
+// cppcheck-suppress unusedFunction
+uint8_t TelemetryManager::getSinkCount() const {
+    return sinkCount;
+}
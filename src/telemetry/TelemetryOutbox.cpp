@@ -0,0 +1,102 @@
+#include "telemetry/TelemetryOutbox.h"
+
+namespace Telemetry {
+
+Outbox::Outbox() :
+    entries(),
+    head(0),
+    count(0),
+    dropped(0)
+{
+}
+
+Outbox::Entry& Outbox::at(uint8_t offset) {
+    return entries[(head + offset) % MQTT_OUTBOX_SIZE];
+}
+
+void Outbox::popAcked() {
+    while (count > 0 && at(0).acked) {
+        head = (head + 1) % MQTT_OUTBOX_SIZE;
+        count--;
+    }
+}
+
+uint8_t* Outbox::reserve() {
+    if (count == MQTT_OUTBOX_SIZE) {
+        // A late PUBACK for the dropped frame simply finds no match
+        if (!at(0).acked) dropped++;
+        head = (head + 1) % MQTT_OUTBOX_SIZE;
+        count--;
+    }
+    return at(count).payload;
+}
+
+void Outbox::commit(uint8_t length) {
+    Entry& entry = at(count);
+    entry.packetId = 0;
+    entry.acked = false;
+    entry.sentAt = 0;
+    entry.length = length;
+    count++;
+}
+
+Outbox::Entry* Outbox::nextToSend(unsigned long now, unsigned long retryInterval, uint8_t maxInFlight) {
+    uint8_t pending = inFlight();
+    for (uint8_t i = 0; i < count; i++) {
+        Entry& entry = at(i);
+        if (entry.acked) continue;
+        if (entry.packetId == 0) {
+            if (pending < maxInFlight) return &entry;
+        } else if (now - entry.sentAt >= retryInterval) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+void Outbox::markSent(Entry* entry, uint16_t packetId, unsigned long now) {
+    entry->packetId = packetId;
+    entry->sentAt = now;
+}
+
+bool Outbox::acknowledge(uint16_t packetId) {
+    for (uint8_t i = 0; i < count; i++) {
+        Entry& entry = at(i);
+        if (!entry.acked && entry.packetId == packetId) {
+            entry.acked = true;
+            popAcked();
+            return true;
+        }
+    }
+    return false;
+}
+
+void Outbox::resetInFlight() {
+    for (uint8_t i = 0; i < count; i++) {
+        at(i).packetId = 0;
+    }
+}
+
+uint8_t Outbox::size() const {
+    uint8_t pending = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        if (!entries[(head + i) % MQTT_OUTBOX_SIZE].acked) pending++;
+    }
+    return pending;
+}
+
+uint8_t Outbox::inFlight() const {
+    uint8_t pending = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        const Entry& entry = entries[(head + i) % MQTT_OUTBOX_SIZE];
+        if (!entry.acked && entry.packetId != 0) pending++;
+    }
+    return pending;
+}
+
+// cppcheck-suppress unusedFunction
+unsigned long Outbox::getDroppedCount() const {
+    return dropped;
+}
+
+} // namespace Telemetry
@@ -0,0 +1,202 @@
+#include "web/JsonWriter.h"
+
+JsonWriter::JsonWriter(Print& output, size_t maxBytes) :
+    out(output),
+    limit(maxBytes),
+    written(0),
+    overflow(false),
+    depth(0),
+    hasItems()
+{
+}
+
+bool JsonWriter::write(const char* text, size_t length) {
+    if (overflow || written + length > limit) {
+        overflow = true;
+        return false;
+    }
+    out.write((const uint8_t*)text, length);
+    written += length;
+    return true;
+}
+
+bool JsonWriter::write(const char* text) {
+    return write(text, strlen(text));
+}
+
+bool JsonWriter::separator() {
+    if (depth == 0) {
+        return !overflow;
+    }
+    if (hasItems[depth - 1]) {
+        return write(",", 1);
+    }
+    hasItems[depth - 1] = true;
+    return !overflow;
+}
+
+bool JsonWriter::key(const char* name) {
+    if (!separator()) return false;
+    if (!name) return true;
+    return string(name) && write(":", 1);
+}
+
+bool JsonWriter::string(const char* text) {
+    if (!write("\"", 1)) return false;
+
+    // Escape in runs so plain text goes out in a single write
+    const char* run = text;
+    for (const char* c = text; *c; c++) {
+        char escaped[7] = {0};
+        switch (*c) {
+            case '"': strcpy(escaped, "\\\""); break;
+            case '\\': strcpy(escaped, "\\\\"); break;
+            case '\n': strcpy(escaped, "\\n"); break;
+            case '\r': strcpy(escaped, "\\r"); break;
+            case '\t': strcpy(escaped, "\\t"); break;
+            default:
+                if ((uint8_t)*c < 0x20) {
+                    snprintf(escaped, sizeof(escaped), "\\u%04x", (uint8_t)*c);
+                }
+                break;
+        }
+        if (escaped[0]) {
+            if (!write(run, c - run) || !write(escaped)) return false;
+            run = c + 1;
+        }
+    }
+    return write(run) && write("\"", 1);
+}
+
+bool JsonWriter::number(float value, uint8_t decimals) {
+    if (isnan(value) || isinf(value)) {
+        return write("null", 4);
+    }
+    char buffer[24];
+    int length = snprintf(buffer, sizeof(buffer), "%.*f", decimals, value);
+    return length > 0 && write(buffer, (size_t)length);
+}
+
+bool JsonWriter::number(long value) {
+    char buffer[24];
+    int length = snprintf(buffer, sizeof(buffer), "%ld", value);
+    return length > 0 && write(buffer, (size_t)length);
+}
+
+bool JsonWriter::open(char bracket) {
+    if (depth >= MAX_DEPTH) {
+        overflow = true;
+        return false;
+    }
+    if (!write(&bracket, 1)) return false;
+    hasItems[depth++] = false;
+    return true;
+}
+
+bool JsonWriter::close(char bracket) {
+    if (depth == 0) return false;
+    depth--;
+    return write(&bracket, 1);
+}
+
+bool JsonWriter::beginObject(const char* name) {
+    return key(name) && open('{');
+}
+
+bool JsonWriter::endObject() {
+    return close('}');
+}
+
+bool JsonWriter::beginArray(const char* name) {
+    return key(name) && open('[');
+}
+
+bool JsonWriter::endArray() {
+    return close(']');
+}
+
+bool JsonWriter::add(const char* name, float value, uint8_t decimals) {
+    return key(name) && number(value, decimals);
+}
+
+bool JsonWriter::add(const char* name, long value) {
+    return key(name) && number(value);
+}
+
+bool JsonWriter::add(const char* name, unsigned long value) {
+    char buffer[24];
+    int length = snprintf(buffer, sizeof(buffer), "%lu", value);
+    return key(name) && length > 0 && write(buffer, (size_t)length);
+}
+
+bool JsonWriter::add(const char* name, int value) {
+    return key(name) && number((long)value);
+}
+
+bool JsonWriter::add(const char* name, bool value) {
+    return key(name) && (value ? write("true", 4) : write("false", 5));
+}
+
+bool JsonWriter::add(const char* name, const char* value) {
+    if (!value) return addNull(name);
+    return key(name) && string(value);
+}
+
+bool JsonWriter::addNull(const char* name) {
+    return key(name) && write("null", 4);
+}
+
+bool JsonWriter::add(float value, uint8_t decimals) {
+    return key(nullptr) && number(value, decimals);
+}
+
+bool JsonWriter::add(long value) {
+    return key(nullptr) && number(value);
+}
+
+// cppcheck-suppress unusedFunction
+size_t JsonWriter::size() const {
+    return written;
+}
+
+bool JsonWriter::overflowed() const {
+    return overflow;
+}
+
+JsonBuffer::JsonBuffer(char* buffer, size_t bufferSize) :
+    data(buffer),
+    capacity(bufferSize),
+    length(0)
+{
+    clear();
+}
+
+size_t JsonBuffer::write(uint8_t c) {
+    return write(&c, 1);
+}
+
+size_t JsonBuffer::write(const uint8_t* buffer, size_t size) {
+    // One byte is kept for the terminator
+    if (capacity == 0 || length + size >= capacity) {
+        return 0;
+    }
+    memcpy(data + length, buffer, size);
+    length += size;
+    data[length] = '\0';
+    return size;
+}
+
+void JsonBuffer::clear() {
+    length = 0;
+    if (capacity > 0) {
+        data[0] = '\0';
+    }
+}
+
+const char* JsonBuffer::c_str() const {
+    return data;
+}
+
+size_t JsonBuffer::size() const {
+    return length;
+}
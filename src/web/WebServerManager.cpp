@@ -0,0 +1,686 @@
+#include "web/WebServerManager.h"
+#include "web/JsonWriter.h"
+#include "blynk/BlynkTargets.h"
+#include "sensors/SensorManager.h"
+#include "actuators/ActuatorManager.h"
+#include "logic/LogicManager.h"
+#include "system/TimeManager.h"
+#include "system/Metrics.h"
+#include "system/LoopProfiler.h"
+#include "system/PowerManager.h"
+#include "system/Supervisor.h"
+#include "system/StateSnapshot.h"
+#include <LittleFS.h>
+
+// JSON keys of the targets, in the order of targetValues/pendingTargets
+const WebServerManager::TargetKey WebServerManager::TARGET_KEYS[TARGET_KEY_COUNT] = {
+    {"temperature", BLYNK_VPIN_TARGET_TEMPERATURE},
+    {"humidity", BLYNK_VPIN_TARGET_HUMIDITY},
+    {"soilMoisture", BLYNK_VPIN_TARGET_SOIL_MOISTURE},
+    {"luxMin", BLYNK_VPIN_TARGET_LUX_MIN},
+    {"ventTemp", BLYNK_VPIN_TARGET_VENT_TEMP},
+    {"soilPH", BLYNK_VPIN_TARGET_SOIL_PH},
+    {"soilEC", BLYNK_VPIN_TARGET_SOIL_EC},
+    {"waterLevel", BLYNK_VPIN_TARGET_WATER_LEVEL},
+};
+
+// Deadbands keep sensor noise off the live channel
+const WebServerManager::SensorField WebServerManager::SENSOR_FIELDS[] = {
+    {"temperature", &Snapshot::temperature, 0.1, 1},
+    {"humidity", &Snapshot::humidity, 0.5, 1},
+    {"heatIndex", &Snapshot::heatIndex, 0.1, 1},
+    {"lux", &Snapshot::lux, 10.0, 0},
+    {"lightLux", &Snapshot::lightLux, 10.0, 0},
+    {"soilMoisture", &Snapshot::soilMoisture, 0.5, 1},
+    {"soilMoistureRS485", &Snapshot::soilMoistureRS485, 0.5, 1},
+    {"soilTemperature", &Snapshot::soilTemperature, 0.1, 1},
+    {"soilEC", &Snapshot::soilEC, 10.0, 0},
+    {"soilPH", &Snapshot::soilPH, 0.05, 2},
+    {"waterLevel", &Snapshot::waterLevel, 0.5, 1},
+    {"waterPercentage", &Snapshot::waterPercentage, 1.0, 0},
+};
+const uint8_t WebServerManager::SENSOR_FIELD_COUNT = sizeof(SENSOR_FIELDS) / sizeof(SENSOR_FIELDS[0]);
+
+const WebServerManager::FlagField WebServerManager::ACTUATOR_FIELDS[] = {
+    {"fan", &Snapshot::fan},
+    {"waterPump", &Snapshot::waterPump},
+    {"heater", &Snapshot::heater},
+    {"ledStrip", &Snapshot::ledStrip},
+    {"ventilationOpen", &Snapshot::ventilationOpen},
+};
+const uint8_t WebServerManager::ACTUATOR_FIELD_COUNT = sizeof(ACTUATOR_FIELDS) / sizeof(ACTUATOR_FIELDS[0]);
+
+const WebServerManager::FlagField WebServerManager::SYSTEM_FIELDS[] = {
+    {"autoMode", &Snapshot::autoMode},
+    {"enabled", &Snapshot::systemEnabled},
+    {"autotuning", &Snapshot::autotuning},
+};
+const uint8_t WebServerManager::SYSTEM_FIELD_COUNT = sizeof(SYSTEM_FIELDS) / sizeof(SYSTEM_FIELDS[0]);
+
+namespace {
+bool sensorChanged(float current, float previous, float deadband) {
+    if (isnan(current) || isnan(previous)) {
+        return isnan(current) != isnan(previous);
+    }
+    return fabsf(current - previous) >= deadband;
+}
+} // namespace
+
+WebServerManager::WebServerManager() :
+    server(WEB_SERVER_PORT),
+    liveSocket(WEB_LIVE_PATH),
+    sensorManager(nullptr),
+    actuatorManager(nullptr),
+    logicManager(nullptr),
+    timeManager(nullptr),
+    dataMutex(nullptr),
+    snapshot(),
+    history(),
+    historyHead(0),
+    historyCount(0),
+    targetValues(),
+    pendingTargets(),
+    targetsPending(false),
+    liveClients(),
+    liveClientCount(0),
+    lastPushed(),
+    droppedClients(0),
+    lastSnapshot(0),
+    lastHistorySample(0),
+    running(false),
+    requestCount(0)
+{
+}
+
+WebServerManager::~WebServerManager() {
+    if (running) {
+        server.end();
+    }
+    if (dataMutex) {
+        vSemaphoreDelete(dataMutex);
+    }
+}
+
+bool WebServerManager::begin(SensorManager* sensors, ActuatorManager* actuators, LogicManager* logic,
+                             TimeManager* clock) {
+    if (!sensors || !actuators || !logic) {
+        Serial.println("[WebServerManager] Error: Invalid pointers provided");
+        return false;
+    }
+
+    sensorManager = sensors;
+    actuatorManager = actuators;
+    logicManager = logic;
+    timeManager = clock;
+
+    dataMutex = xSemaphoreCreateMutex();
+    if (!dataMutex) {
+        Serial.println("[WebServerManager] Error: Could not create mutex");
+        return false;
+    }
+    for (uint8_t i = 0; i < TARGET_KEY_COUNT; i++) {
+        pendingTargets[i] = NAN;
+    }
+    publishSnapshot(millis());
+
+    // The API keeps working without the dashboard files
+    if (LittleFS.begin(false)) {
+        server.serveStatic("/", LittleFS, WEB_STATIC_PATH)
+            .setDefaultFile("index.html")
+            .setCacheControl(WEB_STATIC_CACHE);
+    } else {
+        Serial.println("[WebServerManager] Warning: LittleFS not mounted, dashboard unavailable");
+    }
+
+    server.on("/api/snapshot", HTTP_GET, [this](AsyncWebServerRequest* request) { handleSnapshot(request); });
+    server.on("/api/actuators", HTTP_GET, [this](AsyncWebServerRequest* request) { handleActuators(request); });
+    server.on("/api/targets", HTTP_GET, [this](AsyncWebServerRequest* request) { handleGetTargets(request); });
+    server.on("/api/history", HTTP_GET, [this](AsyncWebServerRequest* request) { handleHistory(request); });
+    server.on(WEB_METRICS_PATH, HTTP_GET, [this](AsyncWebServerRequest* request) { handleMetrics(request); });
+    if (LOOP_PROFILER_ENABLED) {
+        server.on("/api/profile", HTTP_GET, [this](AsyncWebServerRequest* request) { handleProfile(request); });
+    }
+    // The PUT reply is sent from the body callback; without a body there is none
+    server.on("/api/targets", HTTP_PUT,
+              [this](AsyncWebServerRequest* request) {
+                  if (request->contentLength() == 0) sendError(request, 400, "Empty body");
+              },
+              nullptr,
+              [this](AsyncWebServerRequest* request, uint8_t* data, size_t length, size_t index, size_t total) {
+                  handlePutTargets(request, data, length, index, total);
+              });
+    liveSocket.onEvent([this](AsyncWebSocket* socket, AsyncWebSocketClient* client, AwsEventType type,
+                              void* arg, uint8_t* data, size_t length) {
+        (void)socket; (void)arg; (void)data; (void)length;
+        handleLiveEvent(client, type);
+    });
+    server.addHandler(&liveSocket);
+    server.onNotFound([this](AsyncWebServerRequest* request) { sendError(request, 404, "Not found"); });
+
+    server.begin();
+    running = true;
+    Serial.println(String("[WebServerManager] Listening on port ") + WEB_SERVER_PORT);
+    return true;
+}
+
+void WebServerManager::update() {
+    if (!running) return;
+
+    unsigned long now = millis();
+    if (targetsPending) {
+        applyPendingTargets();
+    }
+    if (now - lastSnapshot >= WEB_SNAPSHOT_INTERVAL) {
+        publishSnapshot(now);
+    }
+}
+
+// cppcheck-suppress unusedFunction
+unsigned long WebServerManager::getIdleTime() const {
+    if (!running) return ULONG_MAX;
+    if (targetsPending) return 0;
+    // Only live clients need the snapshot cadence; requests read whatever the last wake published
+    if (liveClientCount == 0) return ULONG_MAX;
+    unsigned long elapsed = millis() - lastSnapshot;
+    return elapsed >= WEB_SNAPSHOT_INTERVAL ? 0 : WEB_SNAPSHOT_INTERVAL - elapsed;
+}
+
+// cppcheck-suppress unusedFunction
+bool WebServerManager::isRunning() const {
+    return running;
+}
+
+// cppcheck-suppress unusedFunction
+unsigned long WebServerManager::getRequestCount() const {
+    return requestCount;
+}
+
+// cppcheck-suppress unusedFunction
+uint8_t WebServerManager::getLiveClientCount() const {
+    return liveClientCount;
+}
+
+// cppcheck-suppress unusedFunction
+unsigned long WebServerManager::getDroppedClientCount() const {
+    return droppedClients;
+}
+
+void WebServerManager::publishSnapshot(unsigned long now) {
+    // Read everything outside the lock, then copy it in one go
+    Snapshot fresh;
+    fresh.uptime = now / 1000;
+    fresh.time = (timeManager && timeManager->isValid()) ? timeManager->now() : 0;
+    fresh.temperature = sensorManager->getTemperature();
+    fresh.humidity = sensorManager->getHumidity();
+    fresh.heatIndex = sensorManager->getHeatIndex();
+    fresh.lux = sensorManager->getLux();
+    fresh.lightLux = sensorManager->getLightLux();
+    fresh.soilMoisture = sensorManager->getSoilMoisture();
+    fresh.soilMoistureRS485 = sensorManager->getSoilMoistureRS485();
+    fresh.soilTemperature = sensorManager->getSoilTemperature();
+    fresh.soilEC = sensorManager->getSoilEC();
+    fresh.soilPH = sensorManager->getSoilPH();
+    fresh.waterLevel = sensorManager->getWaterLevel();
+    fresh.waterPercentage = sensorManager->getWaterPercentage();
+    fresh.fan = actuatorManager->obtenerEstadoVentilador();
+    fresh.waterPump = actuatorManager->obtenerEstadoBombaAgua();
+    fresh.heater = actuatorManager->obtenerEstadoCalefactor();
+    fresh.ledStrip = actuatorManager->obtenerEstadoTiraLED();
+    fresh.ventilationOpen = actuatorManager->obtenerEstadoVentilacion();
+    fresh.autoMode = logicManager->isAutoMode();
+    fresh.systemEnabled = logicManager->isSystemEnabled();
+    fresh.autotuning = logicManager->isAutotuning();
+
+    float values[TARGET_KEY_COUNT];
+    for (uint8_t i = 0; i < TARGET_KEY_COUNT; i++) {
+        values[i] = targets.*(BlynkTargets::findPin(TARGET_KEYS[i].pin)->field);
+    }
+
+    // Never wait for a request being served: retry on the next loop instead
+    if (xSemaphoreTake(dataMutex, 0) != pdTRUE) return;
+
+    snapshot = fresh;
+    memcpy(targetValues, values, sizeof(targetValues));
+    if (historyCount == 0 || now - lastHistorySample >= WEB_HISTORY_INTERVAL) {
+        HistorySample& sample = history[historyHead];
+        sample.time = fresh.time;
+        sample.temperature = fresh.temperature;
+        sample.humidity = fresh.humidity;
+        sample.soilMoisture = fresh.soilMoisture;
+        sample.lux = fresh.lightLux;
+        historyHead = (historyHead + 1) % WEB_HISTORY_SIZE;
+        if (historyCount < WEB_HISTORY_SIZE) historyCount++;
+        lastHistorySample = now;
+    }
+    xSemaphoreGive(dataMutex);
+
+    lastSnapshot = now;
+    if (liveClientCount > 0) {
+        pushChanges(fresh);
+    } else {
+        lastPushed = fresh; // New clients get the full state on connect
+    }
+}
+
+void WebServerManager::pushChanges(const Snapshot& fresh) {
+    char message[WEB_LIVE_MAX_MESSAGE];
+    JsonBuffer buffer(message, sizeof(message));
+    JsonWriter json(buffer, sizeof(message) - 1);
+
+    json.beginObject();
+    json.add("uptime", fresh.uptime);
+    bool changed = writeSensorFields(json, fresh, &lastPushed);
+    changed |= writeFlagFields(json, "actuators", ACTUATOR_FIELDS, ACTUATOR_FIELD_COUNT, fresh, &lastPushed);
+    changed |= writeFlagFields(json, "system", SYSTEM_FIELDS, SYSTEM_FIELD_COUNT, fresh, &lastPushed);
+    json.endObject();
+    if (!changed || json.overflowed()) return;
+
+    // One coalesced frame; clients that cannot keep up are dropped, not buffered
+    uint32_t ids[WEB_LIVE_MAX_CLIENTS];
+    uint8_t count = 0;
+    if (xSemaphoreTake(dataMutex, 0) != pdTRUE) return; // Keep the baseline, retry next frame
+    memcpy(ids, liveClients, sizeof(ids));
+    count = liveClientCount;
+    xSemaphoreGive(dataMutex);
+
+    for (uint8_t i = 0; i < count; i++) {
+        AsyncWebSocketClient* client = liveSocket.client(ids[i]);
+        if (!client) continue;
+        if (client->queueIsFull()) {
+            Serial.printf("[WebServerManager] Live client %u too slow, disconnecting\n", (unsigned)ids[i]);
+            client->close();
+            droppedClients++;
+            continue;
+        }
+        client->text(message, buffer.size());
+    }
+
+    // Sensors inside their deadband keep the old baseline so slow drift is sent eventually
+    Snapshot baseline = fresh;
+    for (uint8_t i = 0; i < SENSOR_FIELD_COUNT; i++) {
+        const SensorField& field = SENSOR_FIELDS[i];
+        if (!sensorChanged(fresh.*field.value, lastPushed.*field.value, field.deadband)) {
+            baseline.*field.value = lastPushed.*field.value;
+        }
+    }
+    lastPushed = baseline;
+}
+
+void WebServerManager::applyPendingTargets() {
+    float values[TARGET_KEY_COUNT];
+    if (xSemaphoreTake(dataMutex, 0) != pdTRUE) return;
+    memcpy(values, pendingTargets, sizeof(values));
+    for (uint8_t i = 0; i < TARGET_KEY_COUNT; i++) {
+        pendingTargets[i] = NAN;
+    }
+    targetsPending = false;
+    xSemaphoreGive(dataMutex);
+
+    // Same path as a Blynk slider: clamped, logged and stored in NVS
+    for (uint8_t i = 0; i < TARGET_KEY_COUNT; i++) {
+        if (!isnan(values[i])) {
+            BlynkTargets::dispatch(TARGET_KEYS[i].pin, values[i]);
+        }
+    }
+    publishSnapshot(millis()); // New targets visible right away
+}
+
+void WebServerManager::handleSnapshot(AsyncWebServerRequest* request) {
+    requestCount++;
+    AsyncResponseStream* response = request->beginResponseStream("application/json", WEB_JSON_MAX_SIZE);
+    JsonWriter json(*response, WEB_JSON_MAX_SIZE);
+
+    xSemaphoreTake(dataMutex, portMAX_DELAY);
+    json.beginObject();
+    json.add("uptime", snapshot.uptime);
+    json.add("time", (long)snapshot.time);
+    writeSensorFields(json, snapshot, nullptr);
+    writeFlagFields(json, "system", SYSTEM_FIELDS, SYSTEM_FIELD_COUNT, snapshot, nullptr);
+    json.endObject();
+    xSemaphoreGive(dataMutex);
+
+    sendJson(request, response, json);
+}
+
+void WebServerManager::handleActuators(AsyncWebServerRequest* request) {
+    requestCount++;
+    AsyncResponseStream* response = request->beginResponseStream("application/json", WEB_JSON_MAX_SIZE);
+    JsonWriter json(*response, WEB_JSON_MAX_SIZE);
+
+    xSemaphoreTake(dataMutex, portMAX_DELAY);
+    writeFlagFields(json, nullptr, ACTUATOR_FIELDS, ACTUATOR_FIELD_COUNT, snapshot, nullptr);
+    xSemaphoreGive(dataMutex);
+
+    sendJson(request, response, json);
+}
+
+void WebServerManager::handleGetTargets(AsyncWebServerRequest* request) {
+    requestCount++;
+    AsyncResponseStream* response = request->beginResponseStream("application/json", WEB_JSON_MAX_SIZE);
+    JsonWriter json(*response, WEB_JSON_MAX_SIZE);
+
+    xSemaphoreTake(dataMutex, portMAX_DELAY);
+    json.beginObject();
+    for (uint8_t i = 0; i < TARGET_KEY_COUNT; i++) {
+        json.add(TARGET_KEYS[i].key, targetValues[i]);
+    }
+    json.endObject();
+    xSemaphoreGive(dataMutex);
+
+    sendJson(request, response, json);
+}
+
+void WebServerManager::handlePutTargets(AsyncWebServerRequest* request, uint8_t* data, size_t length,
+                                        size_t index, size_t total) {
+    // Reply once the last chunk is in; the object must fit in one chunk
+    if (index + length != total) return;
+    requestCount++;
+    if (index != 0 || total > WEB_MAX_BODY_SIZE) {
+        sendError(request, 413, "Body too large");
+        return;
+    }
+
+    float values[TARGET_KEY_COUNT];
+    const char* error = nullptr;
+    if (!parseTargets((const char*)data, length, values, error)) {
+        sendError(request, 400, error);
+        return;
+    }
+
+    // Applied by the loop on its next pass; ranges are checked there
+    xSemaphoreTake(dataMutex, portMAX_DELAY);
+    uint8_t accepted = 0;
+    for (uint8_t i = 0; i < TARGET_KEY_COUNT; i++) {
+        if (!isnan(values[i])) {
+            pendingTargets[i] = values[i];
+            accepted++;
+        }
+    }
+    targetsPending = targetsPending || accepted > 0;
+    xSemaphoreGive(dataMutex);
+    if (accepted > 0) {
+        PowerManager::wake();
+    }
+
+    AsyncResponseStream* response = request->beginResponseStream("application/json", WEB_JSON_MAX_SIZE);
+    response->setCode(202);
+    JsonWriter json(*response, WEB_JSON_MAX_SIZE);
+    json.beginObject();
+    json.add("accepted", (int)accepted);
+    json.endObject();
+    sendJson(request, response, json);
+}
+
+void WebServerManager::handleHistory(AsyncWebServerRequest* request) {
+    requestCount++;
+    AsyncResponseStream* response = request->beginResponseStream("application/json", WEB_HISTORY_JSON_MAX_SIZE);
+    JsonWriter json(*response, WEB_HISTORY_JSON_MAX_SIZE);
+
+    xSemaphoreTake(dataMutex, portMAX_DELAY);
+    json.beginObject();
+    json.add("interval", (unsigned long)(WEB_HISTORY_INTERVAL / 1000));
+    json.beginArray("samples");
+    // Oldest first
+    uint8_t first = (historyHead + WEB_HISTORY_SIZE - historyCount) % WEB_HISTORY_SIZE;
+    for (uint8_t i = 0; i < historyCount; i++) {
+        const HistorySample& sample = history[(first + i) % WEB_HISTORY_SIZE];
+        json.beginArray();
+        json.add((long)sample.time);
+        json.add(sample.temperature, 1);
+        json.add(sample.humidity, 1);
+        json.add(sample.soilMoisture, 1);
+        json.add(sample.lux, 0);
+        json.endArray();
+    }
+    json.endArray();
+    json.add("fields", "time,temperature,humidity,soilMoisture,lux");
+    json.endObject();
+    xSemaphoreGive(dataMutex);
+
+    sendJson(request, response, json);
+}
+
+void WebServerManager::handleMetrics(AsyncWebServerRequest* request) {
+    requestCount++;
+    // Chunked: the registry is rendered a few lines per TCP segment
+    Metrics::Renderer renderer;
+    request->send(request->beginChunkedResponse("text/plain; version=0.0.4",
+        [renderer](uint8_t* buffer, size_t maxLength, size_t index) mutable -> size_t {
+            (void)index;
+            return renderer.fill(buffer, maxLength);
+        }));
+}
+
+void WebServerManager::handleProfile(AsyncWebServerRequest* request) {
+    requestCount++;
+    AsyncResponseStream* response = request->beginResponseStream("application/json", WEB_PROFILE_JSON_MAX_SIZE);
+    JsonWriter json(*response, WEB_PROFILE_JSON_MAX_SIZE);
+
+    // Lock-free: the loop only ever adds to the counters
+    json.beginObject();
+    json.add("budgetUs", (unsigned long)LOOP_PROFILER_BUDGET_US);
+    json.add("overruns", (unsigned long)LoopProfiler::getOverrunCount());
+    json.beginArray("stages");
+    for (uint8_t i = 0; i < LoopProfiler::STAGE_COUNT; i++) {
+        LoopProfiler::Stage stage = (LoopProfiler::Stage)i;
+        LoopProfiler::Summary summary = LoopProfiler::summarize(stage);
+        json.beginObject();
+        json.add("name", LoopProfiler::stageName(stage));
+        json.add("count", (unsigned long)summary.count);
+        json.add("p50Us", (unsigned long)summary.p50Micros);
+        json.add("p99Us", (unsigned long)summary.p99Micros);
+        json.add("maxUs", (unsigned long)summary.maxMicros);
+        json.add("meanUs", (unsigned long)summary.meanMicros);
+        json.endObject();
+    }
+    json.endArray();
+    // Adaptive sleep over the last complete hour (or the current one during the first hour)
+    PowerManager::HourStats power = PowerManager::getLastHour();
+    json.beginObject("power");
+    json.add("mode", PowerManager::getModeName());
+    json.add("windowS", (unsigned long)(power.lengthMillis / 1000));
+    json.add("wakes", (unsigned long)power.wakes);
+    json.add("earlyWakes", (unsigned long)power.earlyWakes);
+    json.add("awakePercent", power.lengthMillis ? power.awakeMillis * 100.0f / power.lengthMillis : 0.0f);
+    json.endObject();
+    // Hang that caused the last restart, if any, with the stage times of the iteration it interrupted
+    Supervisor::HangRecord hang;
+    if (Supervisor::getLastHang(hang)) {
+        json.beginObject("hang");
+        json.add("cause", Supervisor::causeName(hang.cause));
+        json.add("stage", Supervisor::stageName(hang.stage));
+        json.add("elapsedMs", (unsigned long)hang.elapsedMillis);
+        json.add("deadlineMs", (unsigned long)hang.deadlineMillis);
+        json.add("uptimeS", (unsigned long)hang.uptimeSeconds);
+        json.add("resetReason", Supervisor::resetReasonName(hang.resetReason));
+        json.beginArray("stagesUs");
+        for (uint8_t i = 0; i < LoopProfiler::STAGE_COUNT; i++) {
+            json.add((long)hang.hungLoopMicros[i]);
+        }
+        json.endArray();
+        json.endObject();
+    }
+    // Warm restart: whether this boot resumed the RTC state, and how often it has been rewritten since
+    json.beginObject("snapshot");
+    json.add("warmStart", StateSnapshot::getRestored() != nullptr);
+    json.add("writes", (unsigned long)StateSnapshot::getWriteCount());
+    json.endObject();
+    json.endObject();
+
+    // ?reset=1 starts a new measurement window from the next loop iteration
+    if (request->hasParam("reset")) {
+        LoopProfiler::requestReset();
+    }
+    sendJson(request, response, json);
+}
+
+void WebServerManager::handleLiveEvent(AsyncWebSocketClient* client, AwsEventType type) {
+    if (type == WS_EVT_DISCONNECT) {
+        removeLiveClient(client->id());
+        return;
+    }
+    if (type != WS_EVT_CONNECT) return; // The channel is push-only
+
+    requestCount++;
+    char message[WEB_LIVE_MAX_MESSAGE];
+    JsonBuffer buffer(message, sizeof(message));
+    JsonWriter json(buffer, sizeof(message) - 1);
+
+    xSemaphoreTake(dataMutex, portMAX_DELAY);
+    bool accepted = liveClientCount < WEB_LIVE_MAX_CLIENTS;
+    if (accepted) {
+        liveClients[liveClientCount++] = client->id();
+        writeSnapshot(json, snapshot, nullptr);
+    }
+    xSemaphoreGive(dataMutex);
+
+    if (!accepted) {
+        client->close(1013, "Too many clients");
+        return;
+    }
+    PowerManager::wake(); // Start the snapshot cadence now, not at the loop's next deadline
+    // A newer frame may arrive first; the next change of each field fixes it
+    client->text(message, buffer.size());
+}
+
+void WebServerManager::removeLiveClient(uint32_t id) {
+    xSemaphoreTake(dataMutex, portMAX_DELAY);
+    for (uint8_t i = 0; i < liveClientCount; i++) {
+        if (liveClients[i] == id) {
+            liveClients[i] = liveClients[--liveClientCount];
+            break;
+        }
+    }
+    xSemaphoreGive(dataMutex);
+}
+
+void WebServerManager::writeSnapshot(JsonWriter& json, const Snapshot& current, const Snapshot* previous) {
+    json.beginObject();
+    json.add("uptime", current.uptime);
+    json.add("time", (long)current.time);
+    writeSensorFields(json, current, previous);
+    writeFlagFields(json, "actuators", ACTUATOR_FIELDS, ACTUATOR_FIELD_COUNT, current, previous);
+    writeFlagFields(json, "system", SYSTEM_FIELDS, SYSTEM_FIELD_COUNT, current, previous);
+    json.endObject();
+}
+
+bool WebServerManager::writeSensorFields(JsonWriter& json, const Snapshot& current, const Snapshot* previous) {
+    bool opened = false;
+    for (uint8_t i = 0; i < SENSOR_FIELD_COUNT; i++) {
+        const SensorField& field = SENSOR_FIELDS[i];
+        float value = current.*field.value;
+        if (previous && !sensorChanged(value, previous->*field.value, field.deadband)) continue;
+        if (!opened) {
+            json.beginObject("sensors");
+            opened = true;
+        }
+        json.add(field.key, value, field.decimals);
+    }
+    if (opened) json.endObject();
+    return opened;
+}
+
+bool WebServerManager::writeFlagFields(JsonWriter& json, const char* group, const FlagField* fields, uint8_t count,
+                                       const Snapshot& current, const Snapshot* previous) {
+    bool opened = false;
+    for (uint8_t i = 0; i < count; i++) {
+        bool value = current.*fields[i].value;
+        if (previous && value == previous->*fields[i].value) continue;
+        if (!opened) {
+            json.beginObject(group);
+            opened = true;
+        }
+        json.add(fields[i].key, value);
+    }
+    if (opened) json.endObject();
+    return opened;
+}
+
+void WebServerManager::sendJson(AsyncWebServerRequest* request, AsyncResponseStream* response, const JsonWriter& json) {
+    if (json.overflowed()) {
+        // Never send truncated JSON
+        delete response;
+        Serial.println("[WebServerManager] Error: Response larger than its limit");
+        sendError(request, 500, "Response too large");
+        return;
+    }
+    response->addHeader("Cache-Control", "no-store");
+    request->send(response);
+}
+
+void WebServerManager::sendError(AsyncWebServerRequest* request, int code, const char* message) {
+    char body[96];
+    snprintf(body, sizeof(body), "{\"error\":\"%s\"}", message);
+    request->send(code, "application/json", body);
+}
+
+int8_t WebServerManager::findTargetKey(const char* key, size_t length) const {
+    for (uint8_t i = 0; i < TARGET_KEY_COUNT; i++) {
+        if (strlen(TARGET_KEYS[i].key) == length && strncmp(TARGET_KEYS[i].key, key, length) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+bool WebServerManager::parseTargets(const char* body, size_t length, float* values, const char*& error) const {
+    // Flat object of numbers only, e.g. {"temperature":24.5,"humidity":65}
+    char text[WEB_MAX_BODY_SIZE + 1];
+    memcpy(text, body, length);
+    text[length] = '\0';
+
+    for (uint8_t i = 0; i < TARGET_KEY_COUNT; i++) {
+        values[i] = NAN;
+    }
+
+    const char* p = text;
+    while (isspace((unsigned char)*p)) p++;
+    if (*p++ != '{') {
+        error = "Expected a JSON object";
+        return false;
+    }
+
+    while (true) {
+        while (isspace((unsigned char)*p)) p++;
+        if (*p == '}') break;
+        if (*p++ != '"') {
+            error = "Expected a key";
+            return false;
+        }
+        const char* key = p;
+        while (*p && *p != '"') p++;
+        if (*p != '"') {
+            error = "Unterminated key";
+            return false;
+        }
+        int8_t target = findTargetKey(key, p - key);
+        p++;
+        if (target < 0) {
+            error = "Unknown target";
+            return false;
+        }
+
+        while (isspace((unsigned char)*p)) p++;
+        if (*p++ != ':') {
+            error = "Expected ':'";
+            return false;
+        }
+        char* end = nullptr;
+        float value = strtof(p, &end);
+        if (end == p || isnan(value) || isinf(value)) {
+            error = "Expected a number";
+            return false;
+        }
+        values[target] = value;
+        p = end;
+
+        while (isspace((unsigned char)*p)) p++;
+        if (*p == ',') {
+            p++;
+        } else if (*p != '}') {
+            error = "Expected ',' or '}'";
+            return false;
+        }
+    }
+    return true;
+}
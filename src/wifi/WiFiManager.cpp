@@ -5,6 +5,7 @@ WiFiManager::WiFiManager() {
     connectionTimeout = WIFI_CONNECTION_TIMEOUT;
     retryInterval = WIFI_RETRY_INTERVAL;
     lastConnectionAttempt = 0;
+    wasConnected = false;
     connectCallback = nullptr;
     disconnectCallback = nullptr;
 }
@@ -41,6 +42,7 @@ bool WiFiManager::connectToWiFi(String newSSID, String newPassword) {
     }
     
     if (WiFi.status() == WL_CONNECTED) {
+        wasConnected = true;
         if (connectCallback) {
             connectCallback();
         }
@@ -51,18 +53,42 @@ bool WiFiManager::connectToWiFi(String newSSID, String newPassword) {
 }
 
 // cppcheck-suppress unusedFunction
+// cppcheck-suppress unusedFunction
+bool WiFiManager::startConnection() {
+    if (ssid.length() == 0) {
+        return false;
+    }
+    
+    WiFi.mode(WIFI_STA);
+    WiFi.begin(ssid.c_str(), password.c_str());
+    lastConnectionAttempt = millis();
+    return true;
+}
+
 bool WiFiManager::attemptReconnection() {
-    unsigned long currentTime = millis();
+    bool connected = isConnected();
     
-    if (currentTime - lastConnectionAttempt >= retryInterval) {
-        lastConnectionAttempt = currentTime;
-        
-        if (!isConnected() && ssid.length() > 0) {
-            return connectToWiFi();
+    // Notificar los cambios de estado, también los de una conexión en segundo plano
+    if (connected != wasConnected) {
+        wasConnected = connected;
+        if (connected && connectCallback) {
+            connectCallback();
+        } else if (!connected && disconnectCallback) {
+            disconnectCallback();
         }
     }
     
-    return isConnected();
+    if (connected || ssid.length() == 0) {
+        return connected;
+    }
+    
+    // Nuevo intento sin bloquear, dando a cada uno su tiempo máximo de conexión
+    unsigned long wait = retryInterval > connectionTimeout ? retryInterval : connectionTimeout;
+    if (millis() - lastConnectionAttempt >= wait) {
+        startConnection();
+    }
+    
+    return false;
 }
 
 bool WiFiManager::isConnected() {
@@ -102,6 +128,7 @@ void WiFiManager::setCredentials(String newSSID, String newPassword) {
 
 void WiFiManager::disconnect() {
     WiFi.disconnect();
+    wasConnected = false;
     if (disconnectCallback) {
         disconnectCallback();
     }
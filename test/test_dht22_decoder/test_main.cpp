@@ -0,0 +1,184 @@
+// Decodificación de tramas del DHT22 capturadas por el RMT
+// pio test -e native -f test_dht22_decoder
+//
+// Las tramas están en el formato de DHT22Sensor::printLastCapture() (nivel y
+// duración en µs, ocho por línea), con la dispersión de tiempos de un sensor
+// real: una captura impresa por consola se pega aquí tal cual. Cubren una
+// lectura normal, una temperatura negativa, un pulso partido entre dos items
+// del RMT y cada error que distingue DHT22Decoder.
+
+#include <unity.h>
+#include "sensors/DHT22Decoder.h"
+
+using DHT22Decoder::Level;
+
+namespace {
+
+// 56,1 %, 23,4 °C
+const Level CAPTURE_POSITIVE[] = {
+    {1, 28}, {0, 78}, {1, 82}, {0, 49}, {1, 25}, {0, 55}, {1, 25}, {0, 54},
+    {1, 28}, {0, 51}, {1, 22}, {0, 55}, {1, 22}, {0, 54}, {1, 25}, {0, 48},
+    {1, 73}, {0, 55}, {1, 24}, {0, 51}, {1, 26}, {0, 49}, {1, 24}, {0, 48},
+    {1, 68}, {0, 48}, {1, 73}, {0, 48}, {1, 25}, {0, 51}, {1, 25}, {0, 48},
+    {1, 26}, {0, 51}, {1, 74}, {0, 55}, {1, 25}, {0, 51}, {1, 24}, {0, 51},
+    {1, 27}, {0, 51}, {1, 28}, {0, 55}, {1, 24}, {0, 48}, {1, 25}, {0, 49},
+    {1, 23}, {0, 52}, {1, 22}, {0, 53}, {1, 73}, {0, 54}, {1, 72}, {0, 51},
+    {1, 70}, {0, 52}, {1, 26}, {0, 55}, {1, 74}, {0, 54}, {1, 26}, {0, 48},
+    {1, 71}, {0, 51}, {1, 27}, {0, 54}, {1, 25}, {0, 50}, {1, 24}, {0, 53},
+    {1, 22}, {0, 55}, {1, 73}, {0, 49}, {1, 74}, {0, 50}, {1, 72}, {0, 54},
+    {1, 24}, {0, 55}, {1, 73}, {0, 49}, {1, 0},
+};
+
+// 87,3 %, -5,2 °C: bit 15 de la temperatura a 1
+const Level CAPTURE_NEGATIVE[] = {
+    {1, 26}, {0, 78}, {1, 79}, {0, 53}, {1, 28}, {0, 50}, {1, 27}, {0, 52},
+    {1, 24}, {0, 51}, {1, 26}, {0, 48}, {1, 26}, {0, 50}, {1, 25}, {0, 54},
+    {1, 74}, {0, 53}, {1, 72}, {0, 55}, {1, 26}, {0, 52}, {1, 68}, {0, 48},
+    {1, 70}, {0, 55}, {1, 24}, {0, 54}, {1, 71}, {0, 50}, {1, 26}, {0, 50},
+    {1, 23}, {0, 51}, {1, 68}, {0, 50}, {1, 70}, {0, 50}, {1, 23}, {0, 53},
+    {1, 26}, {0, 50}, {1, 25}, {0, 54}, {1, 27}, {0, 53}, {1, 28}, {0, 53},
+    {1, 24}, {0, 55}, {1, 23}, {0, 54}, {1, 27}, {0, 55}, {1, 27}, {0, 51},
+    {1, 71}, {0, 52}, {1, 71}, {0, 53}, {1, 27}, {0, 55}, {1, 71}, {0, 53},
+    {1, 26}, {0, 55}, {1, 25}, {0, 51}, {1, 24}, {0, 50}, {1, 26}, {0, 52},
+    {1, 74}, {0, 55}, {1, 24}, {0, 52}, {1, 28}, {0, 54}, {1, 24}, {0, 51},
+    {1, 25}, {0, 53}, {1, 27}, {0, 53}, {1, 0},
+};
+
+// 56,1 %, 23,4 °C con el alto de la respuesta y el del bit 6 partidos entre dos items RMT
+// (y un nivel vacío en medio): cada mitad sola quedaría fuera de tolerancia o leería un 0
+const Level CAPTURE_SPLIT[] = {
+    {1, 27}, {0, 84}, {1, 40}, {0, 0}, {1, 42}, {0, 48}, {1, 22}, {0, 50},
+    {1, 27}, {0, 55}, {1, 28}, {0, 53}, {1, 24}, {0, 48}, {1, 24}, {0, 55},
+    {1, 28}, {0, 51}, {1, 31}, {1, 42}, {0, 54}, {1, 26}, {0, 49}, {1, 23},
+    {0, 52}, {1, 27}, {0, 49}, {1, 74}, {0, 54}, {1, 70}, {0, 49}, {1, 24},
+    {0, 54}, {1, 28}, {0, 52}, {1, 25}, {0, 49}, {1, 74}, {0, 51}, {1, 27},
+    {0, 52}, {1, 22}, {0, 48}, {1, 26}, {0, 51}, {1, 28}, {0, 53}, {1, 25},
+    {0, 51}, {1, 26}, {0, 48}, {1, 27}, {0, 53}, {1, 23}, {0, 54}, {1, 70},
+    {0, 53}, {1, 72}, {0, 49}, {1, 68}, {0, 51}, {1, 22}, {0, 52}, {1, 70},
+    {0, 51}, {1, 25}, {0, 55}, {1, 69}, {0, 50}, {1, 26}, {0, 51}, {1, 28},
+    {0, 48}, {1, 23}, {0, 50}, {1, 22}, {0, 53}, {1, 72}, {0, 52}, {1, 70},
+    {0, 54}, {1, 72}, {0, 54}, {1, 24}, {0, 50}, {1, 73}, {0, 52}, {1, 0},
+};
+
+// 61,7 %, 19,8 °C con un bit de la suma de control cambiado
+const Level CAPTURE_CHECKSUM[] = {
+    {1, 29}, {0, 79}, {1, 83}, {0, 55}, {1, 27}, {0, 49}, {1, 26}, {0, 48},
+    {1, 28}, {0, 55}, {1, 24}, {0, 51}, {1, 23}, {0, 55}, {1, 26}, {0, 55},
+    {1, 71}, {0, 50}, {1, 23}, {0, 50}, {1, 28}, {0, 54}, {1, 73}, {0, 48},
+    {1, 73}, {0, 49}, {1, 23}, {0, 48}, {1, 70}, {0, 48}, {1, 28}, {0, 52},
+    {1, 25}, {0, 54}, {1, 73}, {0, 54}, {1, 25}, {0, 55}, {1, 23}, {0, 53},
+    {1, 22}, {0, 48}, {1, 23}, {0, 55}, {1, 23}, {0, 52}, {1, 27}, {0, 54},
+    {1, 28}, {0, 52}, {1, 25}, {0, 54}, {1, 72}, {0, 53}, {1, 72}, {0, 54},
+    {1, 26}, {0, 51}, {1, 24}, {0, 48}, {1, 28}, {0, 52}, {1, 72}, {0, 50},
+    {1, 73}, {0, 53}, {1, 26}, {0, 49}, {1, 27}, {0, 51}, {1, 27}, {0, 52},
+    {1, 70}, {0, 49}, {1, 22}, {0, 55}, {1, 28}, {0, 55}, {1, 22}, {0, 53},
+    {1, 28}, {0, 49}, {1, 71}, {0, 50}, {1, 0},
+};
+
+// 48,0 %, 21,5 °C: el sensor deja la línea libre tras 30 bits
+const Level CAPTURE_TRUNCATED[] = {
+    {1, 29}, {0, 81}, {1, 79}, {0, 54}, {1, 25}, {0, 50}, {1, 22}, {0, 49},
+    {1, 22}, {0, 54}, {1, 26}, {0, 52}, {1, 28}, {0, 48}, {1, 23}, {0, 53},
+    {1, 24}, {0, 50}, {1, 74}, {0, 49}, {1, 70}, {0, 51}, {1, 68}, {0, 52},
+    {1, 74}, {0, 52}, {1, 23}, {0, 50}, {1, 24}, {0, 52}, {1, 27}, {0, 53},
+    {1, 22}, {0, 53}, {1, 27}, {0, 54}, {1, 26}, {0, 51}, {1, 23}, {0, 51},
+    {1, 25}, {0, 52}, {1, 22}, {0, 52}, {1, 22}, {0, 52}, {1, 26}, {0, 52},
+    {1, 28}, {0, 51}, {1, 25}, {0, 54}, {1, 72}, {0, 52}, {1, 71}, {0, 55},
+    {1, 23}, {0, 51}, {1, 70}, {0, 52}, {1, 28}, {0, 48}, {1, 68}, {0, 48},
+    {1, 0},
+};
+
+// 52,4 %, 22,0 °C con un pico que alarga el alto del bit 12 a 142 µs
+const Level CAPTURE_BAD_TIMING[] = {
+    {1, 30}, {0, 82}, {1, 86}, {0, 48}, {1, 28}, {0, 55}, {1, 28}, {0, 51},
+    {1, 27}, {0, 48}, {1, 23}, {0, 49}, {1, 24}, {0, 55}, {1, 28}, {0, 51},
+    {1, 71}, {0, 49}, {1, 26}, {0, 51}, {1, 22}, {0, 51}, {1, 25}, {0, 52},
+    {1, 23}, {0, 54}, {1, 23}, {0, 49}, {1, 142}, {0, 55}, {1, 69}, {0, 50},
+    {1, 22}, {0, 48}, {1, 23}, {0, 51}, {1, 23}, {0, 50}, {1, 24}, {0, 53},
+    {1, 23}, {0, 51}, {1, 23}, {0, 51}, {1, 25}, {0, 52}, {1, 22}, {0, 53},
+    {1, 25}, {0, 50}, {1, 23}, {0, 52}, {1, 68}, {0, 53}, {1, 70}, {0, 48},
+    {1, 26}, {0, 53}, {1, 68}, {0, 52}, {1, 70}, {0, 52}, {1, 71}, {0, 53},
+    {1, 23}, {0, 55}, {1, 25}, {0, 50}, {1, 68}, {0, 52}, {1, 68}, {0, 53},
+    {1, 74}, {0, 54}, {1, 22}, {0, 54}, {1, 70}, {0, 54}, {1, 26}, {0, 48},
+    {1, 71}, {0, 48}, {1, 27}, {0, 50}, {1, 0},
+};
+
+// Solo la liberación de la línea por el host y ruido: no hay respuesta de 80 + 80 µs
+const Level CAPTURE_NO_RESPONSE[] = {
+    {1, 31}, {0, 14}, {1, 22}, {0, 9}, {1, 0},
+};
+
+template <size_t N>
+DHT22Decoder::Result decode(const Level (&capture)[N], DHT22Decoder::Reading& reading) {
+    return DHT22Decoder::decode(capture, N, reading);
+}
+
+void assertResult(DHT22Decoder::Result expected, DHT22Decoder::Result actual) {
+    TEST_ASSERT_EQUAL_STRING(DHT22Decoder::resultName(expected), DHT22Decoder::resultName(actual));
+}
+
+} // namespace
+
+void setUp() {}
+
+void tearDown() {}
+
+void test_positive_temperature() {
+    DHT22Decoder::Reading reading = {};
+    assertResult(DHT22Decoder::RESULT_OK, decode(CAPTURE_POSITIVE, reading));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 56.1f, reading.humidity);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 23.4f, reading.temperature);
+}
+
+void test_negative_temperature() {
+    DHT22Decoder::Reading reading = {};
+    assertResult(DHT22Decoder::RESULT_OK, decode(CAPTURE_NEGATIVE, reading));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 87.3f, reading.humidity);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, -5.2f, reading.temperature);
+}
+
+void test_pulse_split_across_rmt_items() {
+    DHT22Decoder::Reading reading = {};
+    assertResult(DHT22Decoder::RESULT_OK, decode(CAPTURE_SPLIT, reading));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 56.1f, reading.humidity);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 23.4f, reading.temperature);
+}
+
+void test_checksum_error() {
+    DHT22Decoder::Reading reading = {-100.0f, -100.0f};
+    assertResult(DHT22Decoder::RESULT_CHECKSUM, decode(CAPTURE_CHECKSUM, reading));
+    // A rejected frame leaves the previous reading untouched
+    TEST_ASSERT_EQUAL_FLOAT(-100.0f, reading.humidity);
+    TEST_ASSERT_EQUAL_FLOAT(-100.0f, reading.temperature);
+}
+
+void test_truncated_frame() {
+    DHT22Decoder::Reading reading = {};
+    assertResult(DHT22Decoder::RESULT_TRUNCATED, decode(CAPTURE_TRUNCATED, reading));
+    // The same capture cut inside the response is not a response at all
+    assertResult(DHT22Decoder::RESULT_NO_RESPONSE, DHT22Decoder::decode(CAPTURE_TRUNCATED, 2, reading));
+}
+
+void test_bad_timing() {
+    DHT22Decoder::Reading reading = {};
+    assertResult(DHT22Decoder::RESULT_BAD_TIMING, decode(CAPTURE_BAD_TIMING, reading));
+}
+
+void test_no_response() {
+    DHT22Decoder::Reading reading = {};
+    assertResult(DHT22Decoder::RESULT_NO_RESPONSE, decode(CAPTURE_NO_RESPONSE, reading));
+    // Capture timeout: DHT22Sensor hands over an empty capture
+    assertResult(DHT22Decoder::RESULT_NO_RESPONSE, DHT22Decoder::decode(nullptr, 0, reading));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_positive_temperature);
+    RUN_TEST(test_negative_temperature);
+    RUN_TEST(test_pulse_split_across_rmt_items);
+    RUN_TEST(test_checksum_error);
+    RUN_TEST(test_truncated_frame);
+    RUN_TEST(test_bad_timing);
+    RUN_TEST(test_no_response);
+    return UNITY_END();
+}
@@ -0,0 +1,123 @@
+// Calefactor por modulación proporcional en el tiempo contra una planta térmica simulada
+// pio test -e native -f test_heater_pid
+//
+// Aire y estructura como un único nodo térmico (capacidad, pérdidas UA hacia el
+// exterior y el calefactor por relé), con la lectura cuantizada a 0.1 °C como el
+// DHT22 y TemperatureControl llamado cada 5 s como en LogicManager. Mide el
+// sobreimpulso tras el arranque y, ya asentada, la banda de temperatura y los
+// ciclos del relé por hora.
+
+#include <Arduino.h>
+#include <NativeHal.h>
+#include <unity.h>
+#include "config/config.h"
+#include "logic/TemperatureControl.h"
+
+namespace {
+
+const float CAPACITY = 400000.0f;        // J/K (túnel de 60 m³ del gemelo digital)
+const float UA = 130.0f;                 // W/K (envolvente e infiltración)
+const float HEATER_POWER = 3000.0f;      // W
+const unsigned long CONTROL_PERIOD = 5000;  // ms (LogicManager::UPDATE_INTERVAL)
+const float TARGET = 24.0f;
+
+struct Run {
+    float maxTemperature;
+    float minSettled;
+    float maxSettled;
+    uint32_t settledCycles;
+    float settledHours;
+};
+
+float quantize(float temperature) {
+    return roundf(temperature * 10.0f) / 10.0f;
+}
+
+// Simulates hours of closed loop from startTemperature; the band is measured after settleHours
+Run simulate(float startTemperature, float outside, float hours, float settleHours) {
+    NativeHal::reset();
+    TemperatureControl control;
+    control.begin();
+    control.setTarget(TARGET);
+
+    Run run = {startTemperature, 1e9f, -1e9f, 0, hours - settleHours};
+    float temperature = startTemperature;
+    bool wasOn = false;
+    const uint32_t steps = (uint32_t)(hours * 3600000.0f / CONTROL_PERIOD);
+    for (uint32_t step = 0; step < steps; step++) {
+        NativeHal::advanceMillis(CONTROL_PERIOD);
+        control.update(quantize(temperature));
+        bool on = control.isHeaterOutputOn();
+
+        // 1 s substeps of the plant with the relay as commanded
+        for (unsigned long s = 0; s < CONTROL_PERIOD / 1000; s++) {
+            float power = on ? HEATER_POWER : 0.0f;
+            temperature += (power - UA * (temperature - outside)) / CAPACITY;
+        }
+
+        run.maxTemperature = max(run.maxTemperature, temperature);
+        if (step * CONTROL_PERIOD >= settleHours * 3600000.0f) {
+            run.minSettled = min(run.minSettled, temperature);
+            run.maxSettled = max(run.maxSettled, temperature);
+            if (on && !wasOn) {
+                run.settledCycles++;
+            }
+        }
+        wasOn = on;
+    }
+    return run;
+}
+
+void report(const char* label, const Run& run) {
+    char message[160];
+    snprintf(message, sizeof(message), "%s: sobreimpulso %.2f C, banda %.2f..%.2f C, %.1f ciclos/h", label,
+             run.maxTemperature - TARGET, run.minSettled - TARGET, run.maxSettled - TARGET,
+             run.settledCycles / run.settledHours);
+    TEST_MESSAGE(message);
+}
+
+} // namespace
+
+void setUp(void) {
+    NativeHal::setConsoleEnabled(false);
+}
+
+void tearDown(void) {
+}
+
+void test_holds_target_within_0_3_degrees(void) {
+    // Cold night: the heater needs about half duty
+    Run run = simulate(TARGET, 12.0f, 8.0f, 2.0f);
+    report("noche a 12 C", run);
+    TEST_ASSERT_FLOAT_WITHIN(0.3f, TARGET, run.minSettled);
+    TEST_ASSERT_FLOAT_WITHIN(0.3f, TARGET, run.maxSettled);
+}
+
+void test_mild_night_holds_band_with_short_duty(void) {
+    // Little heat needed: pulses near the minimum heating time
+    Run run = simulate(TARGET, 20.0f, 8.0f, 2.0f);
+    report("noche a 20 C", run);
+    TEST_ASSERT_FLOAT_WITHIN(0.3f, TARGET, run.minSettled);
+    TEST_ASSERT_FLOAT_WITHIN(0.3f, TARGET, run.maxSettled);
+}
+
+void test_warm_up_overshoot_is_small(void) {
+    Run run = simulate(18.0f, 10.0f, 8.0f, 4.0f);
+    report("arranque a 18 C", run);
+    TEST_ASSERT_LESS_THAN(0.5f, run.maxTemperature - TARGET);
+}
+
+void test_relay_cycles_stay_within_one_per_window(void) {
+    Run run = simulate(TARGET, 12.0f, 8.0f, 2.0f);
+    // One ON pulse per time-proportioning window at most
+    TEST_ASSERT_LESS_OR_EQUAL(3600000.0f / HEATER_CYCLE_ON_TIME, run.settledCycles / run.settledHours);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_holds_target_within_0_3_degrees);
+    RUN_TEST(test_mild_night_holds_band_with_short_duty);
+    RUN_TEST(test_warm_up_overshoot_is_small);
+    RUN_TEST(test_relay_cycles_stay_within_one_per_window);
+    return UNITY_END();
+}
@@ -0,0 +1,187 @@
+// Agua del planificador de riego frente a la política reactiva
+// pio test -e native -f test_irrigation_planner
+//
+// Una traza grabada no sirve para medir agua: el suelo de la traza no responde
+// a los riegos de otra política. Por eso la comparación se hace en lazo
+// cerrado con el gemelo digital (GreenhousePlant), los mismos días y el mismo
+// arranque, una vez con IrrigationPlanner y otra con la política anterior
+// (sesiones de mañana/tarde y riego reactivo). Informa del agua de cada una,
+// del ahorro, de los arranques de bomba y del tiempo con el suelo en banda.
+//
+// En el gemelo el suelo solo pierde agua por secado y evapotranspiración,
+// proporcionales a la humedad: el agua la fija la humedad media a la que se
+// mantiene el suelo, no la política. El agua comparada es la consumida (la
+// aportada menos la que el suelo guarda de más al final), porque un 1 % de
+// humedad de diferencia al cortar ya son varios litros. La reactiva ronda el
+// límite inferior a ~1 % por encima y sale de la banda en cada retraso; el
+// planificador se queda más cerca del límite sin salir de ella, así que el
+// ahorro es real pero pequeño (su techo es ~3 %). A cambio no puede pagarlo en
+// arranques de bomba: la subida mínima por pulso y los pulsos de zonas vecinas
+// que comparten arranque lo mantienen por debajo de la reactiva.
+
+#include <Arduino.h>
+#include <NativeHal.h>
+#include <unity.h>
+#include "config/Targets.h"
+#include "config/config.h"
+#include "native/GreenhousePlant.h"
+#include "native/NativeFirmware.h"
+#include "native/SimDevices.h"
+
+namespace {
+
+const time_t START_EPOCH = 1775512800;   // 2026-04-07 00:00 CEST, como native_twin
+const uint32_t DAYS = 4;
+const uint32_t SECONDS_PER_DAY = 86400;
+const float MIN_SAVING = 0.1f;           // % de agua consumida menos que la reactiva
+
+struct Result {
+    float waterLitres;
+    float consumedLitres;                    // Agua aportada menos la que queda de más en el suelo
+    float soilInBand[IRRIGATION_ZONE_COUNT]; // % del tiempo
+    float minSoil;
+    float meanSoil;
+    unsigned int pulses;
+    bool modelLearned;
+    float decayRate; // 1/h, zona 1
+};
+
+float storedLitres(const GreenhousePlant& plant) {
+    float stored = 0.0f;
+    for (uint8_t i = 0; i < IRRIGATION_ZONE_COUNT; i++) {
+        stored += plant.getSoilMoisture(i) * GreenhousePlant::defaultParams().litresPerPercent;
+    }
+    return stored;
+}
+
+float localHour(uint64_t simMicros) {
+    time_t now = START_EPOCH + (time_t)(simMicros / 1000000);
+    struct tm local;
+    localtime_r(&now, &local);
+    return local.tm_hour + local.tm_min / 60.0f + local.tm_sec / 3600.0f;
+}
+
+Result runDays(bool usePlanner, float target) {
+    NativeHal::reset();
+    NativeHal::setConsoleEnabled(false);
+    SimDevices::Greenhouse greenhouse;
+    greenhouse.attach();
+
+    NativeFirmware firmware;
+    GreenhousePlant plant(greenhouse, firmware.actuators);
+    plant.begin(16.0f, 70.0f, 35.0f, localHour(0));
+    TEST_ASSERT_TRUE(firmware.begin(START_EPOCH));
+    NativeHal::setConsoleEnabled(false);
+    firmware.logic.setAutoMode(true);
+    firmware.logic.setSoilMoistureTarget(target);
+    IrrigationScheduler* scheduler = firmware.logic.getIrrigationScheduler();
+    for (uint8_t i = 0; i < scheduler->getZoneCount(); i++) {
+        scheduler->getZoneControl(i)->enablePlanner(usePlanner);
+    }
+    plant.resetDay();
+
+    Result result = {};
+    result.minSoil = 100.0f;
+    float inBandSeconds[IRRIGATION_ZONE_COUNT] = {};
+    float seconds = 0.0f;
+    double soilIntegral = 0.0;
+    float storedAtStart = 0.0f;
+    uint64_t simStart = NativeHal::nowMicros();
+    uint64_t lastStep = simStart;
+    uint32_t day = 1;
+    while (day <= DAYS) {
+        firmware.update();
+        NativeHal::advanceMicros((uint64_t)firmware.getIdleTime() * 1000);
+        uint64_t now = NativeHal::nowMicros();
+        float dt = (now - lastStep) / 1e6f;
+        plant.step(dt, localHour(now - simStart));
+        lastStep = now;
+        // The first day fills the soil from 35 % and learns the model: only the next ones are compared
+        if (day > 1) {
+            for (uint8_t i = 0; i < IRRIGATION_ZONE_COUNT; i++) {
+                result.minSoil = min(result.minSoil, plant.getSoilMoisture(i));
+                soilIntegral += plant.getSoilMoisture(i) * dt;
+            }
+        }
+
+        if (now - simStart >= (uint64_t)day * SECONDS_PER_DAY * 1000000) {
+            const GreenhousePlant::DayStats& stats = plant.getDayStats();
+            if (day > 1) {
+                result.waterLitres += stats.waterLitres;
+                seconds += stats.seconds;
+                for (uint8_t i = 0; i < IRRIGATION_ZONE_COUNT; i++) {
+                    inBandSeconds[i] += stats.soilInBand[i];
+                }
+                result.pulses += stats.cycles[GreenhousePlant::CYCLE_PUMP];
+            }
+            plant.resetDay();
+            day++;
+            if (day == 2) {
+                storedAtStart = storedLitres(plant);
+            }
+        }
+    }
+    result.consumedLitres = result.waterLitres - (storedLitres(plant) - storedAtStart);
+    for (uint8_t i = 0; i < IRRIGATION_ZONE_COUNT; i++) {
+        result.soilInBand[i] = seconds > 0.0f ? inBandSeconds[i] * 100.0f / seconds : 0.0f;
+    }
+    result.meanSoil = seconds > 0.0f ? soilIntegral / seconds / IRRIGATION_ZONE_COUNT : 0.0f;
+    const IrrigationPlanner& planner = scheduler->getZoneControl(0)->getPlanner();
+    result.modelLearned = planner.hasModel();
+    result.decayRate = planner.getDecayRate();
+    return result;
+}
+
+void compare(float target) {
+    targets.soilMoisture = target; // GreenhousePlant's band follows the global target
+    Result planned = runDays(true, target);
+    Result reactive = runDays(false, target);
+    targets = Targets();
+
+    float saved = reactive.consumedLitres - planned.consumedLitres;
+    char message[256];
+    snprintf(message, sizeof(message),
+             "objetivo %.0f %%, %u días: planificador %.1f L, reactiva %.1f L, ahorro %.1f L (%.1f %%)", target,
+             DAYS - 1, planned.consumedLitres, reactive.consumedLitres, saved,
+             reactive.consumedLitres > 0.0f ? saved * 100.0f / reactive.consumedLitres : 0.0f);
+    TEST_MESSAGE(message);
+    snprintf(message, sizeof(message),
+             "  aportada %.1f / %.1f L, suelo medio %.2f / %.2f %%, mínimo %.1f / %.1f %%, en banda Z1 %.1f / %.1f %%, "
+             "arranques %u / %u",
+             planned.waterLitres, reactive.waterLitres, planned.meanSoil, reactive.meanSoil, planned.minSoil,
+             reactive.minSoil, planned.soilInBand[0], reactive.soilInBand[0], planned.pulses, reactive.pulses);
+    TEST_MESSAGE(message);
+
+    TEST_ASSERT_TRUE(planned.modelLearned);
+    TEST_ASSERT_TRUE(planned.decayRate > 0.0f);
+    // Less water than the reactive policy, because the soil is held lower in the band,
+    // without paying for it in pump starts, and the soil never drier than with the reactive policy
+    TEST_ASSERT_TRUE(planned.meanSoil < reactive.meanSoil);
+    TEST_ASSERT_TRUE(saved * 100.0f >= reactive.consumedLitres * MIN_SAVING);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(reactive.pulses, planned.pulses);
+    TEST_ASSERT_TRUE(planned.minSoil >= reactive.minSoil);
+    for (uint8_t i = 0; i < IRRIGATION_ZONE_COUNT; i++) {
+        TEST_ASSERT_TRUE(planned.soilInBand[i] >= 99.0f);
+    }
+}
+
+} // namespace
+
+void setUp() {}
+
+void tearDown() {}
+
+void test_default_target() {
+    compare(Targets().soilMoisture);
+}
+
+void test_target_near_field_capacity() {
+    compare(55.0f);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_default_target);
+    RUN_TEST(test_target_near_field_capacity);
+    return UNITY_END();
+}
@@ -0,0 +1,188 @@
+// Día simulado de riego con 8 zonas sobre la bomba compartida
+// pio test -e native -f test_irrigation_scheduler
+//
+// IrrigationScheduler admite MAX_ZONES = 8 aunque la instalación use
+// IRRIGATION_ZONE_COUNT. Aquí cada zona tiene su IrrigationControl, su válvula
+// en RelayController y un suelo que se seca a su propio ritmo (más de día) y
+// solo se moja con su válvula abierta y la bomba en marcha. A medianoche todas
+// piden agua a la vez, 8 % por debajo del objetivo. Durante 24 h se comprueba
+// en cada paso que la bomba nunca empuja contra válvulas cerradas, que solo hay
+// dos válvulas abiertas durante el solape del relevo y que la marcha continua
+// no pasa del máximo; al final, que cada zona recibió agua, que pasadas 3 h el
+// suelo no bajó de la banda y que el volumen contabilizado cuadra con el
+// tiempo de bomba.
+
+#include <Arduino.h>
+#include <NativeHal.h>
+#include <unity.h>
+#include "actuators/RelayController.h"
+#include "actuators/WaterPumpActuator.h"
+#include "config/config.h"
+#include "logic/IrrigationControl.h"
+#include "logic/IrrigationScheduler.h"
+
+namespace {
+
+const uint8_t ZONES = IrrigationScheduler::MAX_ZONES;
+const unsigned long STEP = 500;            // ms, bucle principal con el secuenciador ocupado
+const unsigned long CONTROL_PERIOD = 5000; // ms (LogicManager::UPDATE_INTERVAL)
+const uint32_t DAY_MS = 86400000UL;
+const float TARGET = 40.0f;
+const float WETTING = 0.05f;               // % de humedad por segundo de riego
+const float TOLERANCE = 5.0f;              // Banda por defecto de IrrigationControl
+const uint32_t RECOVERY_MS = 3 * 3600000UL; // Las zonas salen 8 % por debajo: se cuenta a partir de aquí
+
+// The two real valve pins first, then any free pin of the simulated HAL
+const uint8_t VALVE_PINS[ZONES] = {RELAY_PIN_6, RELAY_PIN_7, 12, 14, 15, 23, 0, 3};
+
+struct Zone {
+    IrrigationControl control;
+    float moisture;
+    float dryingRate; // %/h por la noche; el doble a pleno sol
+};
+
+struct DayResult {
+    unsigned long pumpMillis;
+    unsigned long longestRun;      // ms de marcha continua
+    unsigned long longestOverlap;  // ms con dos válvulas abiertas
+    unsigned int dryPumpSteps;     // pasos con bomba y sin válvula
+    unsigned int overOpenSteps;    // pasos con más de dos válvulas
+    float minMoisture[ZONES];
+};
+
+float sunFactor(unsigned long dayMillis) {
+    float hour = dayMillis / 3600000.0f;
+    return (hour > 7.0f && hour < 20.0f) ? sinf(PI * (hour - 7.0f) / 13.0f) : 0.0f;
+}
+
+DayResult runDay(Zone* zones, IrrigationScheduler& scheduler, WaterPumpActuator& pump, RelayController& valves) {
+    DayResult result = {};
+    for (uint8_t i = 0; i < ZONES; i++) {
+        result.minMoisture[i] = 100.0f;
+    }
+    unsigned long runStart = 0;
+    unsigned long overlapStart = 0;
+    bool overlapping = false;
+    bool running = false;
+    unsigned long lastControl = 0;
+
+    for (unsigned long t = 0; t < DAY_MS; t += STEP) {
+        if (t == 0 || t - lastControl >= CONTROL_PERIOD) {
+            uint8_t hour = t / 3600000UL;
+            uint8_t minute = (t / 60000UL) % 60;
+            for (uint8_t i = 0; i < ZONES; i++) {
+                zones[i].control.update(zones[i].moisture, 25.0f, 60.0f, -1, hour, minute, 2);
+            }
+            lastControl = t;
+        }
+        scheduler.update();
+        valves.update();
+
+        bool pumpOn = pump.isRunning();
+        uint8_t open = 0;
+        for (uint8_t i = 0; i < ZONES; i++) {
+            if (valves.getRelayState(i)) open++;
+        }
+        if (pumpOn && open == 0) result.dryPumpSteps++;
+        if (open > 2) result.overOpenSteps++;
+
+        if (open == 2 && !overlapping) {
+            overlapping = true;
+            overlapStart = t;
+        } else if (open < 2 && overlapping) {
+            overlapping = false;
+            result.longestOverlap = max(result.longestOverlap, t - overlapStart);
+        }
+        if (pumpOn && !running) {
+            running = true;
+            runStart = t;
+        } else if (!pumpOn && running) {
+            running = false;
+            result.longestRun = max(result.longestRun, t - runStart);
+        }
+        if (pumpOn) result.pumpMillis += STEP;
+
+        float drying = 1.0f + sunFactor(t);
+        for (uint8_t i = 0; i < ZONES; i++) {
+            zones[i].moisture -= zones[i].dryingRate * drying * STEP / 3600000.0f;
+            if (pumpOn && valves.getRelayState(i)) {
+                zones[i].moisture += WETTING * STEP / 1000.0f;
+            }
+            if (t > RECOVERY_MS) {
+                result.minMoisture[i] = min(result.minMoisture[i], zones[i].moisture);
+            }
+        }
+        NativeHal::advanceMillis(STEP);
+    }
+    return result;
+}
+
+} // namespace
+
+void setUp() {
+    NativeHal::reset();
+    NativeHal::setConsoleEnabled(false);
+}
+
+void tearDown() {}
+
+void test_eight_zone_day() {
+    WaterPumpActuator pump(WATER_PUMP_PIN);
+    TEST_ASSERT_TRUE(pump.begin());
+    RelayController valves;
+    TEST_ASSERT_TRUE(valves.begin());
+    IrrigationScheduler scheduler;
+    TEST_ASSERT_TRUE(scheduler.begin(&pump, &valves));
+
+    static Zone zones[ZONES];
+    for (uint8_t i = 0; i < ZONES; i++) {
+        TEST_ASSERT_TRUE(valves.configureRelay(i, VALVE_PINS[i], "Zona " + String(i + 1), RELAY_TRIGGER_TYPE == 0));
+        TEST_ASSERT_TRUE(zones[i].control.begin());
+        zones[i].control.setTarget(TARGET);
+        // Every zone starts dry so the whole day begins with a full queue
+        zones[i].moisture = TARGET - 8.0f;
+        zones[i].dryingRate = 0.5f + 0.25f * i;
+        TEST_ASSERT_EQUAL_INT(i, scheduler.addZone(&zones[i].control, i, "Zona " + String(i + 1)));
+    }
+    TEST_ASSERT_EQUAL_INT(ZONES, scheduler.getZoneCount());
+    TEST_ASSERT_EQUAL_INT(IrrigationScheduler::NO_ZONE, scheduler.addZone(&zones[0].control, 0, "Sobrante"));
+
+    DayResult day = runDay(zones, scheduler, pump, valves);
+
+    unsigned int runs = 0;
+    for (uint8_t i = 0; i < ZONES; i++) {
+        runs += scheduler.getZoneRunCount(i);
+    }
+    char message[160];
+    snprintf(message, sizeof(message),
+             "8 zonas: %u riegos, %u arranques de bomba, %.0f min de bomba, %.1f L, marcha máx. %.1f min", runs,
+             scheduler.getPumpStarts(), day.pumpMillis / 60000.0f, scheduler.getTotalVolume() / 1000.0f,
+             day.longestRun / 60000.0f);
+    TEST_MESSAGE(message);
+
+    // Valve and pump safety on every step
+    TEST_ASSERT_EQUAL_UINT(0, day.dryPumpSteps);
+    TEST_ASSERT_EQUAL_UINT(0, day.overOpenSteps);
+    TEST_ASSERT_TRUE(day.longestOverlap <= IRRIGATION_VALVE_OVERLAP + STEP);
+    TEST_ASSERT_TRUE(day.longestRun <= IRRIGATION_PUMP_MAX_CONTINUOUS + STEP);
+    // Chained zones share pump starts
+    TEST_ASSERT_TRUE(scheduler.getPumpStarts() < runs);
+
+    float flow = zones[0].control.getWaterFlowRate(); // ml/min, the same for every zone
+    for (uint8_t i = 0; i < ZONES; i++) {
+        snprintf(message, sizeof(message), "  zona %u: %u riegos, %.1f L, humedad mínima %.1f %%", i + 1,
+                 scheduler.getZoneRunCount(i), scheduler.getZoneVolume(i) / 1000.0f, day.minMoisture[i]);
+        TEST_MESSAGE(message);
+        TEST_ASSERT_TRUE(scheduler.getZoneRunCount(i) > 0);
+        TEST_ASSERT_TRUE(scheduler.getZoneVolume(i) > 0.0f);
+        TEST_ASSERT_TRUE(day.minMoisture[i] > TARGET - TOLERANCE);
+    }
+    // Water is counted once, for the zone whose valve the pump feeds
+    TEST_ASSERT_FLOAT_WITHIN(flow * 0.1f, flow * day.pumpMillis / 60000.0f, scheduler.getTotalVolume());
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_eight_zone_day);
+    return UNITY_END();
+}
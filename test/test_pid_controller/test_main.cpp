@@ -0,0 +1,221 @@
+// Respuesta al escalón de PIDController (float y Q16.16) y de los lazos que lo usan
+// pio test -e native -f test_pid_controller
+//
+// La planta es de primer orden con retardo (ganancia, constante de tiempo y
+// tiempo muerto), integrada en pasos de 1 s con el PID cada 5 s como en
+// LogicManager. Humedad y luz se prueban contra sus actuadores: la ventana del
+// ventilador y el PWM de la tira LED que ve el propio sensor de luz.
+
+#include <Arduino.h>
+#include <NativeHal.h>
+#include <unity.h>
+#include "config/config.h"
+#include "logic/FixedPoint.h"
+#include "logic/HumidityControl.h"
+#include "logic/LightControl.h"
+#include "logic/PIDController.h"
+
+#include <deque>
+
+namespace {
+
+const unsigned long CONTROL_PERIOD = 5000; // ms (LogicManager::UPDATE_INTERVAL)
+
+struct Plant {
+    float gain;          // unidades de salida por % de actuador
+    float timeConstant;  // s
+    uint32_t deadTime;   // s
+};
+
+struct Step {
+    float finalValue;
+    float overshoot;
+    float riseTime;      // s hasta el 90 % del escalón
+    float maxOutputJump; // mayor salto de la salida entre dos pasos
+};
+
+template <typename T>
+Step stepResponse(PIDController<T>& pid, const Plant& plant, float setpoint, float hours) {
+    pid.setSetpoint(T(setpoint));
+    std::deque<float> delayed(plant.deadTime + 1, 0.0f);
+    float y = 0.0f;
+    float u = 0.0f;
+    float previousOutput = 0.0f;
+    Step step = {0.0f, 0.0f, -1.0f, 0.0f};
+    const uint32_t seconds = (uint32_t)(hours * 3600.0f);
+    for (uint32_t t = 0; t < seconds; t++) {
+        if (t % (CONTROL_PERIOD / 1000) == 0) {
+            u = (float)pid.compute(T(y), t == 0 ? 0 : CONTROL_PERIOD);
+            if (t > 0) {
+                step.maxOutputJump = max(step.maxOutputJump, fabsf(u - previousOutput));
+            }
+            previousOutput = u;
+        }
+        delayed.push_back(u);
+        float applied = delayed.front();
+        delayed.pop_front();
+        y += (plant.gain * applied - y) / plant.timeConstant;
+        step.overshoot = max(step.overshoot, y - setpoint);
+        if (step.riseTime < 0.0f && y >= 0.9f * setpoint) {
+            step.riseTime = (float)t;
+        }
+    }
+    step.finalValue = y;
+    return step;
+}
+
+template <typename T>
+void configure(PIDController<T>& pid, float kp, float ki, float kd, float outMin, float outMax) {
+    pid.setGains(T(kp), T(ki), T(kd));
+    pid.setOutputLimits(T(outMin), T(outMax));
+    pid.setDerivativeFilter(T(0.5f));
+    pid.reset();
+}
+
+// Tuned for the plant below: gain 0.2, tau 10 min, 30 s dead time (IMC, lambda = tau)
+const Plant SLOW_PLANT = {0.2f, 600.0f, 30};
+const float KP = 5.0f;
+const float KI = KP / 600.0f;
+
+} // namespace
+
+void setUp() {
+    NativeHal::reset();
+    NativeHal::setConsoleEnabled(false);
+}
+
+void tearDown() {}
+
+void test_float_step_settles_without_overshoot() {
+    PIDController<float> pid;
+    configure(pid, KP, KI, 0.0f, 0.0f, 100.0f);
+    Step step = stepResponse(pid, SLOW_PLANT, 10.0f, 3.0f);
+
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 10.0f, step.finalValue);
+    TEST_ASSERT_LESS_THAN_FLOAT(0.5f, step.overshoot);
+    TEST_ASSERT_TRUE(step.riseTime > 0.0f && step.riseTime < 3600.0f);
+}
+
+void test_fixed_point_follows_float() {
+    PIDController<float> reference;
+    PIDController<Q16_16> fixed;
+    configure(reference, KP, KI, 0.0f, 0.0f, 100.0f);
+    configure(fixed, KP, KI, 0.0f, 0.0f, 100.0f);
+    Step a = stepResponse(reference, SLOW_PLANT, 10.0f, 3.0f);
+    Step b = stepResponse(fixed, SLOW_PLANT, 10.0f, 3.0f);
+
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, a.finalValue, b.finalValue);
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, a.overshoot, b.overshoot);
+    TEST_ASSERT_FLOAT_WITHIN(30.0f, a.riseTime, b.riseTime);
+}
+
+void test_saturated_step_does_not_wind_up() {
+    // The step needs more than the actuator gives at first: without
+    // back-calculation the integral keeps growing and overshoots afterwards
+    PIDController<float> pid;
+    configure(pid, KP, KI, 0.0f, 0.0f, 100.0f);
+    Step step = stepResponse(pid, SLOW_PLANT, 18.0f, 4.0f);
+
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, 18.0f, step.finalValue);
+    TEST_ASSERT_LESS_THAN_FLOAT(0.5f, step.overshoot);
+}
+
+void test_derivative_on_measurement_keeps_output_smooth() {
+    PIDController<float> pid;
+    configure(pid, KP, KI, 20.0f, 0.0f, 100.0f);
+    stepResponse(pid, SLOW_PLANT, 5.0f, 2.0f);
+
+    // A setpoint step moves the output only through kp, never through kd
+    float before = pid.getOutput();
+    pid.setSetpoint(6.0f);
+    float after = pid.compute(5.0f, CONTROL_PERIOD);
+    TEST_ASSERT_FLOAT_WITHIN(1.0f, before, after);
+}
+
+void test_set_gains_without_integral_clears_tracking() {
+    PIDController<float> pid;
+    configure(pid, 2.0f, 0.1f, 0.0f, 0.0f, 100.0f);
+    pid.setGains(1.0f, 0.0f, 0.0f);
+    pid.reset(50.0f);
+    pid.setSetpoint(500.0f);
+
+    // Saturated P-only output: a stale tracking gain would bleed the preload away
+    for (int i = 0; i < 20; i++) {
+        TEST_ASSERT_EQUAL_FLOAT(100.0f, pid.compute(0.0f, CONTROL_PERIOD));
+    }
+    TEST_ASSERT_EQUAL_FLOAT(50.0f, pid.getIntegralTerm());
+}
+
+void test_humidity_pid_drives_fan_window() {
+    HumidityControl control;
+    control.begin();
+    control.setTarget(60.0f);
+
+    // Above target the negative PID output becomes fan duty, delivered as one pulse per window
+    float humidity = 75.0f;
+    unsigned long onMillis = 0;
+    for (unsigned long t = 0; t < FAN_HUMIDITY_WINDOW; t += CONTROL_PERIOD) {
+        NativeHal::advanceMillis(CONTROL_PERIOD);
+        control.update(humidity, 20.0f);
+        if (control.isFanOutputOn()) {
+            onMillis += CONTROL_PERIOD;
+        }
+    }
+    TEST_ASSERT_TRUE(control.getFanDuty() > 50.0f);
+    TEST_ASSERT_TRUE(onMillis >= FAN_HUMIDITY_MIN_SWITCH);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, control.getHumidifierDuty());
+
+    // Below target with no humidifier the loop rests instead of winding up
+    humidity = 45.0f;
+    for (int i = 0; i < 360; i++) {
+        NativeHal::advanceMillis(CONTROL_PERIOD);
+        control.update(humidity, 20.0f);
+    }
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, control.getFanDuty());
+    TEST_ASSERT_FALSE(control.isFanOutputOn());
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, control.getHumidifierDuty());
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, control.getControlOutput());
+    TEST_ASSERT_LESS_OR_EQUAL_FLOAT(0.0f, control.getIntegralTerm());
+}
+
+void test_light_pid_sets_led_pwm() {
+    LightControl control;
+    control.begin();
+    const float ledLuxPerPercent = 80.0f; // 8000 lx at full PWM, as in the digital twin
+    const float natural = 6000.0f;
+    const float target = control.getTarget() * 0.8f; // day schedule at 80 %
+
+    float lux = natural;
+    for (int i = 0; i < 240; i++) {
+        NativeHal::advanceMillis(CONTROL_PERIOD);
+        control.update(lux, 12, 0, 3);
+        lux = natural + control.getLEDIntensity() * ledLuxPerPercent;
+    }
+    char message[96];
+    snprintf(message, sizeof(message), "luz: %.0f lx con LED al %.1f %% (objetivo %.0f lx)", lux,
+             control.getLEDIntensity(), target);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_TRUE(control.isArtificialLightActive());
+    TEST_ASSERT_FLOAT_WITHIN(target * 0.02f, target, lux);
+
+    // Enough sunlight: the PID goes to zero and the strip switches off
+    for (int i = 0; i < 240; i++) {
+        NativeHal::advanceMillis(CONTROL_PERIOD);
+        lux = 20000.0f + control.getLEDIntensity() * ledLuxPerPercent;
+        control.update(lux, 12, 0, 3);
+    }
+    TEST_ASSERT_FALSE(control.isArtificialLightActive());
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, control.getLEDIntensity());
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_float_step_settles_without_overshoot);
+    RUN_TEST(test_fixed_point_follows_float);
+    RUN_TEST(test_saturated_step_does_not_wind_up);
+    RUN_TEST(test_derivative_on_measurement_keeps_output_smooth);
+    RUN_TEST(test_set_gains_without_integral_clears_tracking);
+    RUN_TEST(test_humidity_pid_drives_fan_window);
+    RUN_TEST(test_light_pid_sets_led_pwm);
+    return UNITY_END();
+}
@@ -0,0 +1,249 @@
+// Autoajuste por relé contra plantas de primer orden con tiempo muerto (FOPDT)
+// pio test -e native -f test_relay_autotune
+//
+// Para G(s) = K·e^(-Ls) / (τs + 1) la ganancia y el periodo últimos tienen
+// solución exacta: ωu·L + atan(ωu·τ) = π, Ku = sqrt(1 + (ωu·τ)²) / K,
+// Tu = 2π / ωu. El relé de RelayAutotune, muestreado cada 5 s como en
+// LogicManager y con histéresis mínima, debe acercarse a esos valores: la
+// función descriptiva supone una oscilación senoidal y el muestreo añade
+// retardo, así que Ku sale hasta un 30 % por debajo y Tu algo por encima.
+// Con la histéresis de config.h el relé encuentra un punto de menos fase
+// (Ku menor, Tu mayor), es decir, ganancias más prudentes; las de
+// Tyreus-Luyben que salen de él deben cerrar el lazo sin oscilar.
+
+#include <Arduino.h>
+#include <NativeHal.h>
+#include <unity.h>
+#include "config/config.h"
+#include "logic/PIDController.h"
+#include "logic/RelayAutotune.h"
+
+#include <deque>
+
+namespace {
+
+const unsigned long CONTROL_PERIOD = 5000; // ms (LogicManager::UPDATE_INTERVAL)
+
+struct Fopdt {
+    float gain;         // unidades de la medida por % de salida
+    float timeConstant; // s
+    uint32_t deadTime;  // s
+    float base;         // medida con la salida a 0
+};
+
+struct Ultimate {
+    float gain;
+    float period; // s
+};
+
+// Exact crossover of the FOPDT plant by bisection on the phase
+Ultimate exactUltimate(const Fopdt& plant) {
+    float lo = 1e-6f;
+    float hi = PI / max(1.0f, (float)plant.deadTime);
+    for (int i = 0; i < 100; i++) {
+        float w = 0.5f * (lo + hi);
+        float phase = w * plant.deadTime + atanf(w * plant.timeConstant);
+        if (phase < PI) {
+            lo = w;
+        } else {
+            hi = w;
+        }
+    }
+    float w = 0.5f * (lo + hi);
+    return {sqrtf(1.0f + w * plant.timeConstant * w * plant.timeConstant) / fabsf(plant.gain), 2.0f * PI / w};
+}
+
+class Simulation {
+public:
+    Simulation(const Fopdt& plant, float start) : plant(plant), y(start), delayed(plant.deadTime + 1, 0.0f) {}
+
+    // One control period of 1 s plant steps with the output held
+    float advance(float output) {
+        for (unsigned long s = 0; s < CONTROL_PERIOD / 1000; s++) {
+            delayed.push_back(output);
+            float applied = delayed.front();
+            delayed.pop_front();
+            y += (plant.base + plant.gain * applied - y) / plant.timeConstant;
+        }
+        NativeHal::advanceMillis(CONTROL_PERIOD);
+        return y;
+    }
+
+    float value() const { return y; }
+
+private:
+    Fopdt plant;
+    float y;
+    std::deque<float> delayed;
+};
+
+bool runRelay(RelayAutotune& autotune, Simulation& sim, float target, float high, float low, float hysteresis) {
+    autotune.setOutputs(high, low);
+    autotune.setHysteresis(hysteresis);
+    autotune.setMeasurementLimits(-100.0f, 200.0f);
+    autotune.setCycles(AUTOTUNE_CYCLES);
+    autotune.setTimeout(AUTOTUNE_TIMEOUT);
+    autotune.start(target, sim.value());
+    float output = autotune.getOutput();
+    while (autotune.isRunning()) {
+        float measurement = sim.advance(output);
+        output = autotune.update(measurement, millis());
+    }
+    return autotune.isDone();
+}
+
+struct ClosedLoop {
+    float overshoot;
+    float finalError;
+    float lastHourSwing;
+};
+
+ClosedLoop closeLoop(const Fopdt& plant, float kp, float ki, float kd, float outMin, float outMax, float start,
+                     float target, float hours) {
+    PIDController<float> pid;
+    pid.setGains(kp, ki, kd);
+    pid.setOutputLimits(outMin, outMax);
+    pid.setDerivativeFilter(0.5f);
+    pid.reset();
+    pid.setSetpoint(target);
+
+    Simulation sim(plant, start);
+    float direction = target > start ? 1.0f : -1.0f;
+    ClosedLoop result = {0.0f, 0.0f, 0.0f};
+    float lastMin = 1e9f, lastMax = -1e9f;
+    const uint32_t steps = (uint32_t)(hours * 3600000.0f / CONTROL_PERIOD);
+    float output = 0.0f;
+    for (uint32_t i = 0; i < steps; i++) {
+        float y = sim.advance(output);
+        output = pid.compute(y, CONTROL_PERIOD);
+        result.overshoot = max(result.overshoot, direction * (y - target));
+        if (i >= steps - 3600000 / CONTROL_PERIOD) {
+            lastMin = min(lastMin, y);
+            lastMax = max(lastMax, y);
+        }
+    }
+    result.finalError = sim.value() - target;
+    result.lastHourSwing = lastMax - lastMin;
+    return result;
+}
+
+const float SMALL_HYSTERESIS = 0.01f;
+
+void report(const char* name, const RelayAutotune& autotune, const Ultimate& exact) {
+    char message[128];
+    snprintf(message, sizeof(message), "%s: Ku %.2f (exacto %.2f), Tu %.0f s (exacto %.0f s)", name,
+             autotune.getUltimateGain(), exact.gain, autotune.getUltimatePeriod(), exact.period);
+    TEST_MESSAGE(message);
+}
+
+void assertNearUltimate(const RelayAutotune& autotune, const Ultimate& exact) {
+    float gainRatio = autotune.getUltimateGain() / exact.gain;
+    float periodRatio = autotune.getUltimatePeriod() / exact.period;
+    TEST_ASSERT_TRUE(gainRatio > 0.7f && gainRatio < 1.05f);
+    TEST_ASSERT_TRUE(periodRatio > 0.95f && periodRatio < 1.3f);
+}
+
+// Heated tunnel: 100 % heater = +15 °C over the 12 °C outside, 30 min, 1 min dead time
+const Fopdt HEATER_PLANT = {0.15f, 1800.0f, 60, 12.0f};
+// Humidity with the fan: 100 % fan = -20 %RH from 75 %RH, 10 min, 1 min dead time
+const Fopdt FAN_PLANT = {0.2f, 600.0f, 60, 75.0f};
+
+} // namespace
+
+void setUp() {
+    NativeHal::reset();
+    NativeHal::setConsoleEnabled(false);
+}
+
+void tearDown() {}
+
+void test_heater_relay_matches_fopdt_ultimate_point() {
+    Simulation sim(HEATER_PLANT, 22.0f);
+    RelayAutotune autotune;
+    TEST_ASSERT_TRUE(runRelay(autotune, sim, 22.0f, 100.0f, 0.0f, SMALL_HYSTERESIS));
+
+    Ultimate exact = exactUltimate(HEATER_PLANT);
+    report("calefactor", autotune, exact);
+    assertNearUltimate(autotune, exact);
+}
+
+void test_fan_relay_matches_fopdt_ultimate_point() {
+    Simulation sim(FAN_PLANT, 65.0f);
+    RelayAutotune autotune;
+    // Fan relay as LogicManager runs it: off (0) / full dehumidification (-100)
+    TEST_ASSERT_TRUE(runRelay(autotune, sim, 65.0f, 0.0f, -100.0f, SMALL_HYSTERESIS));
+
+    Ultimate exact = exactUltimate(FAN_PLANT);
+    report("ventilador", autotune, exact);
+    assertNearUltimate(autotune, exact);
+}
+
+void test_configured_hysteresis_errs_on_the_safe_side() {
+    Simulation fine(HEATER_PLANT, 22.0f);
+    Simulation configured(HEATER_PLANT, 22.0f);
+    RelayAutotune reference;
+    RelayAutotune autotune;
+    TEST_ASSERT_TRUE(runRelay(reference, fine, 22.0f, 100.0f, 0.0f, SMALL_HYSTERESIS));
+    TEST_ASSERT_TRUE(runRelay(autotune, configured, 22.0f, 100.0f, 0.0f, AUTOTUNE_TEMP_HYSTERESIS));
+
+    report("calefactor con histéresis de config.h", autotune, exactUltimate(HEATER_PLANT));
+    TEST_ASSERT_TRUE(autotune.getUltimateGain() <= reference.getUltimateGain());
+    TEST_ASSERT_TRUE(autotune.getUltimatePeriod() >= reference.getUltimatePeriod());
+}
+
+void test_tuned_gains_close_the_loop() {
+    Simulation sim(HEATER_PLANT, 22.0f);
+    RelayAutotune autotune;
+    TEST_ASSERT_TRUE(runRelay(autotune, sim, 22.0f, 100.0f, 0.0f, AUTOTUNE_TEMP_HYSTERESIS));
+    float kp, ki, kd;
+    TEST_ASSERT_TRUE(autotune.getGains(kp, ki, kd));
+
+    ClosedLoop loop = closeLoop(HEATER_PLANT, kp, ki, kd, 0.0f, 100.0f, 18.0f, 22.0f, 8.0f);
+    char message[128];
+    snprintf(message, sizeof(message), "calefactor Kp %.1f Ki %.4f Kd %.0f: sobreimpulso %.2f C, oscilación %.3f C",
+             kp, ki, kd, loop.overshoot, loop.lastHourSwing);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_LESS_THAN_FLOAT(1.0f, loop.overshoot);
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 0.0f, loop.finalError);
+    TEST_ASSERT_LESS_THAN_FLOAT(0.05f, loop.lastHourSwing);
+}
+
+void test_tuned_fan_gains_close_the_loop() {
+    Simulation sim(FAN_PLANT, 65.0f);
+    RelayAutotune autotune;
+    TEST_ASSERT_TRUE(runRelay(autotune, sim, 65.0f, 0.0f, -100.0f, AUTOTUNE_HUMIDITY_HYSTERESIS));
+    float kp, ki, kd;
+    TEST_ASSERT_TRUE(autotune.getGains(kp, ki, kd));
+
+    // Same output range as HumidityControl without a humidifier
+    ClosedLoop loop = closeLoop(FAN_PLANT, kp, ki, kd, -100.0f, 0.0f, 75.0f, 62.0f, 6.0f);
+    char message[128];
+    snprintf(message, sizeof(message), "ventilador Kp %.1f Ki %.4f Kd %.0f: sobreimpulso %.2f %%, oscilación %.3f %%",
+             kp, ki, kd, loop.overshoot, loop.lastHourSwing);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_LESS_THAN_FLOAT(2.0f, loop.overshoot);
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, 0.0f, loop.finalError);
+    TEST_ASSERT_LESS_THAN_FLOAT(0.1f, loop.lastHourSwing);
+}
+
+void test_timeout_fails_without_gains() {
+    // A plant that never crosses the setpoint cannot oscillate
+    Fopdt weak = {0.01f, 1800.0f, 60, 12.0f};
+    Simulation sim(weak, 12.0f);
+    RelayAutotune autotune;
+    TEST_ASSERT_FALSE(runRelay(autotune, sim, 22.0f, 100.0f, 0.0f, AUTOTUNE_TEMP_HYSTERESIS));
+    float kp, ki, kd;
+    TEST_ASSERT_TRUE(autotune.hasFailed());
+    TEST_ASSERT_FALSE(autotune.getGains(kp, ki, kd));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_heater_relay_matches_fopdt_ultimate_point);
+    RUN_TEST(test_fan_relay_matches_fopdt_ultimate_point);
+    RUN_TEST(test_configured_hysteresis_errs_on_the_safe_side);
+    RUN_TEST(test_tuned_gains_close_the_loop);
+    RUN_TEST(test_tuned_fan_gains_close_the_loop);
+    RUN_TEST(test_timeout_fails_without_gains);
+    return UNITY_END();
+}
@@ -0,0 +1,208 @@
+// Franjas de ScheduleTable que cruzan la medianoche
+// pio test -e native -f test_schedule_table
+//
+// Cada caso se compara minuto a minuto, durante la semana entera, con una
+// referencia de fuerza bruta que no usa el índice de transiciones: una regla
+// está activa si algún día de su máscara empezó hace menos que su duración.
+// Se cubren la noche de diario que acaba en la mañana siguiente, la del sábado
+// que acaba el domingo (vuelta de la semana), franjas encadenadas en la
+// medianoche (relevo de una regla a otra), prioridades entre reglas solapadas y tablas
+// aleatorias; también el tiempo al siguiente cambio a través de la medianoche.
+
+#include <Arduino.h>
+#include <NativeHal.h>
+#include <unity.h>
+#include "logic/ScheduleTable.h"
+
+namespace {
+
+const uint16_t DAY = ScheduleTable::MINUTES_PER_DAY;
+const uint16_t WEEK = ScheduleTable::MINUTES_PER_WEEK;
+
+bool referenceActive(const ScheduleTable::Rule& rule, uint16_t weekMinute) {
+    if (!rule.enabled) return false;
+    uint16_t duration = rule.endMinute > rule.startMinute ? rule.endMinute - rule.startMinute
+                                                          : rule.endMinute + DAY - rule.startMinute;
+    for (uint8_t day = 0; day < 7; day++) {
+        if (!(rule.weekDays & (1 << day))) continue;
+        uint16_t start = day * DAY + rule.startMinute;
+        if ((weekMinute + WEEK - start) % WEEK < duration) return true;
+    }
+    return false;
+}
+
+uint16_t referenceMask(const ScheduleTable& table, uint16_t weekMinute) {
+    uint16_t mask = 0;
+    for (uint8_t r = 0; r < table.getRuleCount(); r++) {
+        if (referenceActive(table.getRule(r), weekMinute)) mask |= 1 << r;
+    }
+    return mask;
+}
+
+uint16_t maskAt(const ScheduleTable& table, uint16_t weekMinute) {
+    return table.getActiveMask(weekMinute / DAY, (weekMinute % DAY) / 60, weekMinute % 60);
+}
+
+// Every minute of the week: active set, winning rule and minutes to the next change
+void assertMatchesReference(const ScheduleTable& table) {
+    uint16_t expected[WEEK];
+    bool changes = false;
+    for (uint16_t m = 0; m < WEEK; m++) {
+        expected[m] = referenceMask(table, m);
+        changes |= m > 0 && expected[m] != expected[m - 1];
+    }
+    changes |= expected[0] != expected[WEEK - 1];
+
+    char message[96];
+    for (uint16_t m = 0; m < WEEK; m++) {
+        uint8_t day = m / DAY, hour = (m % DAY) / 60, minute = m % 60;
+        if (maskAt(table, m) != expected[m]) {
+            snprintf(message, sizeof(message), "día %u %02u:%02u: máscara %04x, esperada %04x", day, hour, minute,
+                     maskAt(table, m), expected[m]);
+            TEST_FAIL_MESSAGE(message);
+        }
+
+        int8_t winner = ScheduleTable::NO_RULE;
+        for (uint8_t r = 0; r < table.getRuleCount() && winner == ScheduleTable::NO_RULE; r++) {
+            if (expected[m] & (1 << r)) winner = r;
+        }
+        TEST_ASSERT_EQUAL_INT(winner, table.getActiveRule(day, hour, minute));
+
+        uint16_t toChange = table.getMinutesToNextChange(day, hour, minute);
+        if (!changes) {
+            TEST_ASSERT_EQUAL_UINT16(ScheduleTable::NO_CHANGE, toChange);
+            continue;
+        }
+        uint16_t steps = 1;
+        while (expected[(m + steps) % WEEK] == expected[m]) steps++;
+        if (toChange != steps) {
+            snprintf(message, sizeof(message), "día %u %02u:%02u: cambio en %u min, esperado en %u", day, hour,
+                     minute, toChange, steps);
+            TEST_FAIL_MESSAGE(message);
+        }
+    }
+}
+
+} // namespace
+
+void setUp() {
+    NativeHal::reset();
+    NativeHal::setConsoleEnabled(false);
+}
+
+void tearDown() {}
+
+void test_weeknight_window_ends_next_morning() {
+    ScheduleTable table;
+    const uint8_t weekdays = 0b00111110; // Monday to Friday
+    TEST_ASSERT_EQUAL_INT(0, table.addRule(22, 0, 6, 0, 1.0f, weekdays));
+
+    // Friday night runs into Saturday morning; Sunday night never starts
+    TEST_ASSERT_TRUE(table.isActive(0, 5, 23, 59));
+    TEST_ASSERT_TRUE(table.isActive(0, 6, 0, 0));
+    TEST_ASSERT_TRUE(table.isActive(0, 6, 5, 59));
+    TEST_ASSERT_FALSE(table.isActive(0, 6, 6, 0));
+    TEST_ASSERT_FALSE(table.isActive(0, 0, 23, 0));
+    TEST_ASSERT_FALSE(table.isActive(0, 1, 3, 0));
+    TEST_ASSERT_TRUE(table.isActive(0, 2, 3, 0));
+    // Monday 23:30 -> Tuesday 06:00 is 6.5 h away, across midnight
+    TEST_ASSERT_EQUAL_UINT16(390, table.getMinutesToNextChange(1, 23, 30));
+    assertMatchesReference(table);
+}
+
+void test_saturday_window_wraps_into_sunday() {
+    ScheduleTable table;
+    TEST_ASSERT_EQUAL_INT(0, table.addRule(23, 0, 1, 0, 2.0f, 1 << 6)); // Saturday only
+
+    TEST_ASSERT_TRUE(table.isActive(0, 6, 23, 30));
+    TEST_ASSERT_TRUE(table.isActive(0, 0, 0, 30)); // Sunday, start of the next week
+    TEST_ASSERT_FALSE(table.isActive(0, 0, 1, 0));
+    TEST_ASSERT_EQUAL_FLOAT(2.0f, table.getActiveValue(0, 0, 59, -1.0f));
+    TEST_ASSERT_EQUAL_FLOAT(-1.0f, table.getActiveValue(0, 1, 30, -1.0f));
+    TEST_ASSERT_EQUAL_UINT16(30, table.getMinutesToNextChange(0, 0, 30));
+    TEST_ASSERT_EQUAL_UINT16(WEEK - 120, table.getMinutesToNextChange(0, 1, 0));
+    assertMatchesReference(table);
+}
+
+void test_back_to_back_at_midnight_hands_over() {
+    ScheduleTable table;
+    TEST_ASSERT_EQUAL_INT(0, table.addRule(20, 0, 24, 0, 1.0f)); // 24:00 end
+    TEST_ASSERT_EQUAL_INT(1, table.addRule(0, 0, 6, 0, 1.0f));
+
+    // The set changes at 00:00 (rule 0 -> rule 1), but the schedule stays on
+    TEST_ASSERT_EQUAL_INT(0, table.getActiveRule(3, 23, 59));
+    TEST_ASSERT_EQUAL_INT(1, table.getActiveRule(4, 0, 0));
+    TEST_ASSERT_EQUAL_UINT16(1, table.getMinutesToNextChange(3, 23, 59));
+    assertMatchesReference(table);
+}
+
+void test_overlapping_night_windows_keep_priority() {
+    ScheduleTable table;
+    TEST_ASSERT_EQUAL_INT(0, table.addRule(1, 0, 3, 0, 10.0f));   // Short, high priority
+    TEST_ASSERT_EQUAL_INT(1, table.addRule(21, 0, 5, 0, 20.0f));  // Across midnight
+    TEST_ASSERT_EQUAL_INT(2, table.addRule(0, 0, 24, 0, 30.0f, 0b01000001)); // Weekend base
+
+    TEST_ASSERT_EQUAL_FLOAT(20.0f, table.getActiveValue(2, 0, 30, 0.0f));
+    TEST_ASSERT_EQUAL_FLOAT(10.0f, table.getActiveValue(2, 1, 0, 0.0f));
+    TEST_ASSERT_EQUAL_FLOAT(20.0f, table.getActiveValue(2, 4, 59, 0.0f));
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, table.getActiveValue(2, 5, 0, 0.0f));
+    TEST_ASSERT_EQUAL_FLOAT(30.0f, table.getActiveValue(6, 12, 0, 0.0f));
+    assertMatchesReference(table);
+
+    // Disabling the midnight window recompiles the index
+    TEST_ASSERT_TRUE(table.setRuleEnabled(1, false));
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, table.getActiveValue(2, 0, 30, 0.0f));
+    assertMatchesReference(table);
+}
+
+void test_whole_day_rule_never_changes() {
+    ScheduleTable table;
+    TEST_ASSERT_EQUAL_INT(0, table.addRule(7, 0, 7, 1, 1.0f));
+    TEST_ASSERT_TRUE(table.setRule(0, 0, 0, 24, 0, 1.0f));
+    TEST_ASSERT_TRUE(table.isActive(0, 4, 0, 0));
+    TEST_ASSERT_EQUAL_UINT16(ScheduleTable::NO_CHANGE, table.getMinutesToNextChange(4, 0, 0));
+    assertMatchesReference(table);
+}
+
+void test_invalid_windows_are_rejected() {
+    ScheduleTable table;
+    TEST_ASSERT_EQUAL_INT(ScheduleTable::NO_RULE, table.addRule(6, 0, 6, 0, 1.0f));   // Empty
+    TEST_ASSERT_EQUAL_INT(ScheduleTable::NO_RULE, table.addRule(24, 0, 1, 0, 1.0f));  // Start past the day
+    TEST_ASSERT_EQUAL_INT(ScheduleTable::NO_RULE, table.addRule(22, 0, 24, 1, 1.0f)); // End past 24:00
+    TEST_ASSERT_EQUAL_INT(ScheduleTable::NO_RULE, table.addRule(22, 0, 6, 0, 1.0f, 0));
+    TEST_ASSERT_EQUAL_UINT8(0, table.getRuleCount());
+    TEST_ASSERT_EQUAL_INT(ScheduleTable::NO_RULE, table.getActiveRule(0, 0, 0));
+}
+
+void test_random_tables_match_reference() {
+    uint32_t seed = 12345;
+    auto next = [&seed](uint32_t range) {
+        seed = seed * 1103515245u + 12345u;
+        return (seed >> 16) % range;
+    };
+    for (int round = 0; round < 20; round++) {
+        ScheduleTable table;
+        uint8_t count = 1 + next(ScheduleTable::MAX_RULES);
+        for (uint8_t r = 0; r < count; r++) {
+            uint16_t start = next(DAY);
+            uint16_t end = 1 + next(DAY);
+            if (end == start) end = (start + 60) % DAY + 1;
+            uint8_t days = 1 + next(ScheduleTable::ALL_DAYS);
+            TEST_ASSERT_EQUAL_INT(r, table.addRule(start / 60, start % 60, end / 60, end % 60, r, days));
+            if (next(4) == 0) table.setRuleEnabled(r, false);
+        }
+        assertMatchesReference(table);
+    }
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_weeknight_window_ends_next_morning);
+    RUN_TEST(test_saturday_window_wraps_into_sunday);
+    RUN_TEST(test_back_to_back_at_midnight_hands_over);
+    RUN_TEST(test_overlapping_night_windows_keep_priority);
+    RUN_TEST(test_whole_day_rule_never_changes);
+    RUN_TEST(test_invalid_windows_are_rejected);
+    RUN_TEST(test_random_tables_match_reference);
+    return UNITY_END();
+}
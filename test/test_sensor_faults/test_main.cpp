@@ -0,0 +1,206 @@
+// Lazos de LogicManager sin lectura de su sensor y arbitraje del ventilador
+// pio test -e native -f test_sensor_faults
+//
+// El firmware completo de NativeFirmware sobre los dispositivos simulados, sin
+// gemelo: las lecturas se fijan a mano. Un sensor que deja de responder no se
+// sustituye por un valor nominal: su lazo queda en espera, el calefactor se
+// apaga, la zona de riego no pide agua (ni toma prestada la sonda de otra
+// zona) y cada pérdida se cuenta una vez. También se comprueba que con la
+// temperatura rondando el umbral de refrigeración el ventilador conmuta una
+// sola vez y no en cada ciclo de control, y que una emergencia (frío, calor o
+// suelo seco) se evalúa con la lectura del ciclo: actúa mientras dura y se
+// levanta en cuanto la lectura vuelve a su banda.
+
+#include <Arduino.h>
+#include <NativeHal.h>
+#include <unity.h>
+#include "config/Targets.h"
+#include "config/config.h"
+#include "native/NativeFirmware.h"
+#include "native/SimDevices.h"
+#include "system/Metrics.h"
+
+namespace {
+
+const time_t START_EPOCH = 1775556000; // 2026-04-07 12:00 CEST
+const float SOIL_DRY = 3000.0f;        // Calibración por defecto de SoilMoistureSensor
+const float SOIL_WET = 1200.0f;
+
+SimDevices::Greenhouse* greenhouse = nullptr;
+NativeFirmware* firmware = nullptr;
+
+uint16_t soilRaw(float percent) {
+    return (uint16_t)(SOIL_DRY - percent / 100.0f * (SOIL_DRY - SOIL_WET));
+}
+
+void run(unsigned long ms) {
+    uint64_t end = NativeHal::nowMicros() + (uint64_t)ms * 1000;
+    while (NativeHal::nowMicros() < end) {
+        firmware->update();
+        NativeHal::advanceMicros((uint64_t)firmware->getIdleTime() * 1000);
+    }
+}
+
+uint32_t fanToggles() {
+    return Metrics::counters[Metrics::RELAY_TOGGLES + Metrics::RELAY_FAN].load();
+}
+
+uint32_t faultMetric(Metrics::ControlInput input) {
+    return Metrics::counters[Metrics::CONTROL_INPUT_FAULTS + input].load();
+}
+
+} // namespace
+
+void setUp() {
+    NativeHal::reset();
+    NativeHal::setConsoleEnabled(false);
+    greenhouse = new SimDevices::Greenhouse();
+    greenhouse->attach();
+    greenhouse->setLight(20000.0f); // Daylight: the LEDs stay off
+    firmware = new NativeFirmware();
+    TEST_ASSERT_TRUE(firmware->begin(START_EPOCH));
+    NativeHal::setConsoleEnabled(false);
+    firmware->logic.setAutoMode(true);
+}
+
+void tearDown() {
+    delete firmware;
+    delete greenhouse;
+    firmware = nullptr;
+    greenhouse = nullptr;
+    targets = Targets();
+}
+
+void test_lost_temperature_turns_heater_off() {
+    greenhouse->setAirConditions(targets.temperature - 4.0f, 60.0f);
+    run(60000);
+    HeaterActuator* heater = firmware->actuators.getHeater();
+    TEST_ASSERT_TRUE(heater->isRunning());
+    uint32_t metricBefore = faultMetric(Metrics::INPUT_TEMPERATURE);
+
+    NativeHal::setDht22Connected(false);
+    run(30000);
+    TEST_ASSERT_TRUE(firmware->logic.hasInputFault(Metrics::INPUT_TEMPERATURE));
+    TEST_ASSERT_FALSE(heater->isRunning());
+    // Stays off for as long as the sensor is missing, counted once
+    run(600000);
+    TEST_ASSERT_FALSE(heater->isRunning());
+    TEST_ASSERT_EQUAL_UINT(1, firmware->logic.getInputFaultCount(Metrics::INPUT_TEMPERATURE));
+    TEST_ASSERT_EQUAL_UINT32(metricBefore + 1, faultMetric(Metrics::INPUT_TEMPERATURE));
+
+    String status;
+    firmware->logic.getSystemStatus(status);
+    TEST_ASSERT_TRUE(status.indexOf("SIN LECTURA") >= 0);
+
+    NativeHal::setDht22Connected(true);
+    run(60000);
+    TEST_ASSERT_FALSE(firmware->logic.hasInputFault(Metrics::INPUT_TEMPERATURE));
+    TEST_ASSERT_TRUE(heater->isRunning());
+    TEST_ASSERT_EQUAL_UINT(1, firmware->logic.getInputFaultCount(Metrics::INPUT_TEMPERATURE));
+}
+
+void test_zone_without_probe_asks_for_no_water() {
+    IrrigationScheduler* scheduler = firmware->logic.getIrrigationScheduler();
+    float target = scheduler->getZoneControl(0)->getTarget();
+    // Zone 1 (capacitive) dry, zone 2 (RS485) probe unplugged
+    greenhouse->setSoilMoistureRaw(soilRaw(target - 8.0f));
+    NativeHal::attachUartPeer(2, nullptr);
+    run(1800000);
+
+    TEST_ASSERT_TRUE(firmware->logic.hasInputFault(Metrics::INPUT_SOIL_ZONE_2));
+    TEST_ASSERT_FALSE(firmware->logic.hasInputFault(Metrics::INPUT_SOIL_ZONE_1));
+    TEST_ASSERT_EQUAL_UINT(1, firmware->logic.getInputFaultCount(Metrics::INPUT_SOIL_ZONE_2));
+    // Zone 1 is watered; zone 2 does not borrow zone 1's reading
+    TEST_ASSERT_TRUE(scheduler->getZoneRunCount(0) > 0);
+    TEST_ASSERT_EQUAL_UINT(0, scheduler->getZoneRunCount(1));
+    TEST_ASSERT_EQUAL_UINT(0, scheduler->getZoneControl(1)->getRequestedDuration());
+}
+
+void test_cooling_switches_fan_once() {
+    // Just above the cooling threshold (target + tolerance), humidity in band
+    greenhouse->setAirConditions(targets.temperature + 1.2f, targets.humidity);
+    run(30000);
+    uint32_t before = fanToggles();
+    FanActuator* fan = firmware->actuators.getFan();
+    run(3600000);
+    TEST_ASSERT_TRUE(fan->isRunning());
+    TEST_ASSERT_TRUE(firmware->actuators.getServo()->isOpen());
+    // One hour of cooling: at most the switch-on, not one toggle per control cycle
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(1, fanToggles() - before);
+
+    // Back inside the cooling hysteresis the fan keeps running; at the target it stops
+    greenhouse->setAirConditions(targets.temperature + 0.5f, targets.humidity);
+    run(120000);
+    TEST_ASSERT_TRUE(fan->isRunning());
+    greenhouse->setAirConditions(targets.temperature - 0.2f, targets.humidity);
+    run(120000);
+    TEST_ASSERT_FALSE(fan->isRunning());
+    TEST_ASSERT_TRUE(firmware->actuators.getServo()->isClosed());
+}
+
+void test_temperature_emergency_enters_and_leaves() {
+    HeaterActuator* heater = firmware->actuators.getHeater();
+    FanActuator* fan = firmware->actuators.getFan();
+    VentilationControl* ventilation = firmware->logic.getVentilationControl();
+    // Below the temperature-adjusted humidity target: the humidity loop asks for no fan pulse
+    const float dryAir = targets.humidity - 12.0f;
+
+    // Cold emergency: the heater runs at full output, the vent stays shut
+    greenhouse->setAirConditions(targets.temperature - 11.0f, dryAir);
+    run(30000);
+    TEST_ASSERT_TRUE(heater->isRunning());
+    TEST_ASSERT_FALSE(fan->isRunning());
+    TEST_ASSERT_TRUE(firmware->actuators.getServo()->isClosed());
+
+    // Warmer than the target: the heater stops (a stale cold reading would keep it latched)
+    greenhouse->setAirConditions(targets.temperature + 6.0f, dryAir);
+    run(60000);
+    TEST_ASSERT_FALSE(heater->isRunning());
+    TEST_ASSERT_FALSE(ventilation->isEmergencyActive());
+
+    // Hot emergency: maximum ventilation reaches the fan and the vent
+    greenhouse->setAirConditions(targets.temperature + 11.0f, dryAir);
+    run(30000);
+    TEST_ASSERT_TRUE(ventilation->isEmergencyActive());
+    TEST_ASSERT_TRUE(fan->isRunning());
+    TEST_ASSERT_TRUE(firmware->actuators.getServo()->isOpen());
+
+    // Back at the target: the emergency clears and, after the minimum run time, the fan stops
+    greenhouse->setAirConditions(targets.temperature - 0.2f, dryAir);
+    run(300000);
+    TEST_ASSERT_FALSE(ventilation->isEmergencyActive());
+    TEST_ASSERT_FALSE(fan->isRunning());
+    TEST_ASSERT_TRUE(firmware->actuators.getServo()->isClosed());
+}
+
+void test_soil_emergency_enters_and_leaves() {
+    IrrigationScheduler* scheduler = firmware->logic.getIrrigationScheduler();
+    IrrigationControl* zone = scheduler->getZoneControl(0);
+    greenhouse->setSoilMoistureRaw(soilRaw(70.0f));
+    run(60000);
+    uint32_t runsBefore = scheduler->getZoneRunCount(0);
+
+    // Below the emergency threshold until the probe's averaged reading gets there
+    greenhouse->setSoilMoistureRaw(soilRaw(15.0f));
+    run(120000);
+    TEST_ASSERT_TRUE(zone->checkEmergency());
+    TEST_ASSERT_TRUE(scheduler->getZoneRunCount(0) > runsBefore);
+
+    // Wet again: the emergency clears with the reading, not one watering per control cycle
+    // (the probe's moving average trails the re-wetting by a few readings: one more run at most)
+    greenhouse->setSoilMoistureRaw(soilRaw(70.0f));
+    run(7200000);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(runsBefore + 2, scheduler->getZoneRunCount(0));
+    TEST_ASSERT_FALSE(zone->checkEmergency());
+    TEST_ASSERT_FALSE(zone->isEmergencyModeActive());
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_lost_temperature_turns_heater_off);
+    RUN_TEST(test_zone_without_probe_asks_for_no_water);
+    RUN_TEST(test_cooling_switches_fan_once);
+    RUN_TEST(test_temperature_emergency_enters_and_leaves);
+    RUN_TEST(test_soil_emergency_enters_and_leaves);
+    return UNITY_END();
+}
@@ -0,0 +1,236 @@
+// Ida y vuelta de SettingsStore por la NVS simulada
+// pio test -e native -f test_settings_store
+//
+// La Preferences de NativeHal conserva los datos entre instancias como la NVS
+// real entre arranques (se borra con NativeHal::reset()). Cada prueba guarda
+// con un SettingsStore, vuelve a los valores por defecto como tras un reinicio
+// y carga con otro: lo leído debe ser exactamente lo guardado, incluidas las
+// ganancias NAN. También se comprueban la escritura diferida y agrupada, el
+// descarte de registros dañados o de otra versión y la importación de las
+// ganancias del espacio antiguo del autoajuste.
+
+#include <Arduino.h>
+#include <NativeHal.h>
+#include <Preferences.h>
+#include <unity.h>
+#include "config/SettingsStore.h"
+#include "config/Targets.h"
+#include "config/config.h"
+
+namespace {
+
+void rebootDefaults() {
+    targets.loadDefaults();
+    tuning.loadDefaults();
+}
+
+void setCustomSettings() {
+    targets.temperature = 21.5f;
+    targets.humidity = 72.0f;
+    targets.soilMoisture = 47.5f;
+    targets.luxMin = 12500.0f;
+    targets.ventTemp = 30.0f;
+    targets.soilPH = 6.1f;
+    targets.soilEC = 1850.0f;
+    targets.waterLevel = 15.0f;
+    tuning.temperatureKp = 28.4f;
+    tuning.temperatureKi = 0.0132f;
+    tuning.temperatureKd = 0.0f;
+    // Humidity gains stay NAN: the controller keeps the config.h defaults
+    tuning.ventTempHysteresis = 2.5f;
+    tuning.ventHumidityHysteresis = 12.0f;
+}
+
+void assertCustomSettings() {
+    TEST_ASSERT_EQUAL_FLOAT(21.5f, targets.temperature);
+    TEST_ASSERT_EQUAL_FLOAT(72.0f, targets.humidity);
+    TEST_ASSERT_EQUAL_FLOAT(47.5f, targets.soilMoisture);
+    TEST_ASSERT_EQUAL_FLOAT(12500.0f, targets.luxMin);
+    TEST_ASSERT_EQUAL_FLOAT(30.0f, targets.ventTemp);
+    TEST_ASSERT_EQUAL_FLOAT(6.1f, targets.soilPH);
+    TEST_ASSERT_EQUAL_FLOAT(1850.0f, targets.soilEC);
+    TEST_ASSERT_EQUAL_FLOAT(15.0f, targets.waterLevel);
+    TEST_ASSERT_EQUAL_FLOAT(28.4f, tuning.temperatureKp);
+    TEST_ASSERT_EQUAL_FLOAT(0.0132f, tuning.temperatureKi);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, tuning.temperatureKd);
+    TEST_ASSERT_TRUE(tuning.hasTemperatureGains());
+    TEST_ASSERT_FALSE(tuning.hasHumidityGains());
+    TEST_ASSERT_TRUE(isnan(tuning.humidityKp));
+    TEST_ASSERT_EQUAL_FLOAT(2.5f, tuning.ventTempHysteresis);
+    TEST_ASSERT_EQUAL_FLOAT(12.0f, tuning.ventHumidityHysteresis);
+}
+
+void assertDefaults() {
+    Targets defaults;
+    TEST_ASSERT_EQUAL_FLOAT(defaults.temperature, targets.temperature);
+    TEST_ASSERT_EQUAL_FLOAT(defaults.soilMoisture, targets.soilMoisture);
+    TEST_ASSERT_EQUAL_FLOAT(defaults.waterLevel, targets.waterLevel);
+    TEST_ASSERT_FALSE(tuning.hasTemperatureGains());
+    TEST_ASSERT_FALSE(tuning.hasHumidityGains());
+}
+
+// Saves the custom settings through a first store and reboots to defaults
+void saveCustomSettings() {
+    SettingsStore store;
+    store.begin();
+    setCustomSettings();
+    store.markDirty();
+    TEST_ASSERT_TRUE(store.flush());
+    rebootDefaults();
+}
+
+} // namespace
+
+void setUp() {
+    NativeHal::reset();
+    NativeHal::setConsoleEnabled(false);
+    rebootDefaults();
+}
+
+void tearDown() {
+    rebootDefaults();
+}
+
+void test_first_boot_keeps_defaults() {
+    SettingsStore store;
+    TEST_ASSERT_FALSE(store.begin());
+    TEST_ASSERT_FALSE(store.isLoaded());
+    TEST_ASSERT_FALSE(store.isDirty());
+    assertDefaults();
+}
+
+void test_round_trip_restores_every_field() {
+    saveCustomSettings();
+    assertDefaults();
+
+    SettingsStore store;
+    TEST_ASSERT_TRUE(store.begin());
+    TEST_ASSERT_TRUE(store.isLoaded());
+    assertCustomSettings();
+}
+
+void test_deferred_write_groups_changes() {
+    SettingsStore store;
+    store.begin();
+
+    // A slider drag: one change per second, written once after the last
+    for (int i = 0; i < 10; i++) {
+        targets.temperature = 20.0f + i * 0.5f;
+        store.markDirty();
+        NativeHal::advanceMillis(1000);
+        store.update();
+    }
+    TEST_ASSERT_EQUAL_UINT(0, store.getWriteCount());
+    TEST_ASSERT_TRUE(store.getIdleTime() > 0 && store.getIdleTime() < SETTINGS_FLUSH_DELAY);
+
+    NativeHal::advanceMillis(SETTINGS_FLUSH_DELAY);
+    store.update();
+    TEST_ASSERT_EQUAL_UINT(1, store.getWriteCount());
+    TEST_ASSERT_FALSE(store.isDirty());
+    TEST_ASSERT_TRUE(store.getIdleTime() == ULONG_MAX);
+
+    // Back to the stored value: no flash write
+    targets.temperature = 10.0f;
+    store.markDirty();
+    targets.temperature = 24.5f;
+    TEST_ASSERT_TRUE(store.flush());
+    TEST_ASSERT_EQUAL_UINT(1, store.getWriteCount());
+
+    rebootDefaults();
+    SettingsStore reloaded;
+    TEST_ASSERT_TRUE(reloaded.begin());
+    TEST_ASSERT_EQUAL_FLOAT(24.5f, targets.temperature);
+}
+
+void test_corrupted_record_is_discarded() {
+    saveCustomSettings();
+
+    // Flip one bit inside the stored targets
+    Preferences prefs;
+    TEST_ASSERT_TRUE(prefs.begin(SETTINGS_PREFS_NAMESPACE, false));
+    uint8_t record[256];
+    size_t length = prefs.getBytes("record", record, sizeof(record));
+    TEST_ASSERT_TRUE(length > 16);
+    record[12] ^= 0x01;
+    TEST_ASSERT_EQUAL_UINT32(length, prefs.putBytes("record", record, length));
+    prefs.end();
+
+    SettingsStore store;
+    TEST_ASSERT_FALSE(store.begin());
+    assertDefaults();
+}
+
+void test_other_version_is_discarded() {
+    saveCustomSettings();
+
+    // Record header: magic (4 bytes) then version (2 bytes)
+    Preferences prefs;
+    TEST_ASSERT_TRUE(prefs.begin(SETTINGS_PREFS_NAMESPACE, false));
+    uint8_t record[256];
+    size_t length = prefs.getBytes("record", record, sizeof(record));
+    uint16_t version = SETTINGS_VERSION + 1;
+    memcpy(record + 4, &version, sizeof(version));
+    prefs.putBytes("record", record, length);
+    prefs.end();
+
+    SettingsStore store;
+    TEST_ASSERT_FALSE(store.begin());
+    assertDefaults();
+
+    // A truncated record is not read either
+    TEST_ASSERT_TRUE(prefs.begin(SETTINGS_PREFS_NAMESPACE, false));
+    prefs.putBytes("record", record, length / 2);
+    prefs.end();
+    SettingsStore truncated;
+    TEST_ASSERT_FALSE(truncated.begin());
+    assertDefaults();
+}
+
+void test_legacy_autotune_gains_are_imported() {
+    Preferences legacy;
+    TEST_ASSERT_TRUE(legacy.begin(AUTOTUNE_PREFS_NAMESPACE, false));
+    legacy.putFloat("hum_kp", 6.5f);
+    legacy.putFloat("hum_ki", 0.003f);
+    legacy.putFloat("hum_kd", 0.0f);
+    legacy.end();
+
+    SettingsStore store;
+    TEST_ASSERT_FALSE(store.begin());
+    TEST_ASSERT_TRUE(tuning.hasHumidityGains());
+    TEST_ASSERT_FALSE(tuning.hasTemperatureGains());
+    TEST_ASSERT_TRUE(store.isDirty());
+    TEST_ASSERT_TRUE(store.flush());
+
+    // From now on the gains come from the settings record
+    rebootDefaults();
+    SettingsStore next;
+    TEST_ASSERT_TRUE(next.begin());
+    TEST_ASSERT_EQUAL_FLOAT(6.5f, tuning.humidityKp);
+    TEST_ASSERT_EQUAL_FLOAT(0.003f, tuning.humidityKi);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, tuning.humidityKd);
+}
+
+void test_reset_to_defaults_is_persisted() {
+    saveCustomSettings();
+    SettingsStore store;
+    TEST_ASSERT_TRUE(store.begin());
+    store.resetToDefaults();
+    assertDefaults();
+
+    setCustomSettings();
+    SettingsStore reloaded;
+    TEST_ASSERT_TRUE(reloaded.begin());
+    assertDefaults();
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_first_boot_keeps_defaults);
+    RUN_TEST(test_round_trip_restores_every_field);
+    RUN_TEST(test_deferred_write_groups_changes);
+    RUN_TEST(test_corrupted_record_is_discarded);
+    RUN_TEST(test_other_version_is_discarded);
+    RUN_TEST(test_legacy_autotune_gains_are_imported);
+    RUN_TEST(test_reset_to_defaults_is_persisted);
+    return UNITY_END();
+}
@@ -0,0 +1,381 @@
+// Cola QoS 1 de la telemetría MQTT contra un broker en proceso
+// pio test -e native -f test_telemetry_outbox
+//
+// StubBroker hace de broker y de consumidor: guarda cada PUBLISH que recibe
+// de AsyncMqttClient (NativeHal) y decodifica las tramas como lo haría quien
+// las suscribe. Los PUBACK se entregan a mano, en el orden que quiera cada
+// prueba, y el corte de TCP con NativeHal::mqttDropConnection(). Se prueban la
+// trama (codificación y decodificación), el descarte de la más antigua con la
+// cola llena, el límite de tramas en vuelo, el reenvío tras el plazo, los
+// PUBACK desordenados y la sesión nueva tras reconectar.
+
+#include <Arduino.h>
+#include <NativeHal.h>
+#include <unity.h>
+#include "config/config.h"
+#include "telemetry/MqttTelemetry.h"
+#include "telemetry/TelemetryFrame.h"
+#include "telemetry/TelemetryOutbox.h"
+
+#include <string>
+#include <vector>
+
+namespace {
+
+const unsigned long STEP = 100; // ms entre llamadas a update()
+
+struct Message {
+    std::string topic;
+    uint8_t qos;
+    bool retain;
+    bool dup;
+    uint16_t packetId;
+    std::vector<uint8_t> payload;
+};
+
+struct DecodedSample {
+    uint8_t channel;
+    float value;
+};
+
+struct DecodedFrame {
+    uint8_t version;
+    uint32_t time;
+    uint16_t sequence;
+    std::vector<DecodedSample> samples;
+};
+
+// Consumer side of telemetry/TelemetryFrame.h
+bool decodeFrame(const uint8_t* data, size_t length, DecodedFrame& frame) {
+    if (length < Telemetry::FRAME_HEADER_SIZE) return false;
+    frame.version = data[0];
+    frame.time = 0;
+    for (uint8_t i = 0; i < 4; i++) {
+        frame.time |= (uint32_t)data[1 + i] << (8 * i);
+    }
+    frame.sequence = (uint16_t)(data[5] | (data[6] << 8));
+    frame.samples.clear();
+
+    size_t offset = Telemetry::FRAME_HEADER_SIZE;
+    while (offset < length) {
+        const Telemetry::ChannelInfo* channel = Telemetry::findChannel(data[offset++]);
+        if (!channel) return false;
+        uint32_t raw = 0;
+        uint8_t shift = 0;
+        while (true) {
+            if (offset >= length || shift > 28) return false;
+            uint8_t byte = data[offset++];
+            raw |= (uint32_t)(byte & 0x7F) << shift;
+            shift += 7;
+            if (!(byte & 0x80)) break;
+        }
+        int32_t scaled = (int32_t)(raw >> 1) ^ -(int32_t)(raw & 1);
+        float value = (float)scaled;
+        for (uint8_t i = 0; i < channel->decimals; i++) {
+            value /= 10.0f;
+        }
+        frame.samples.push_back({channel->id, value});
+    }
+    return true;
+}
+
+class StubBroker : public NativeHal::MqttBroker {
+public:
+    std::vector<Message> messages;
+    uint32_t connects = 0;
+    bool accepting = true;
+
+    bool onConnect(const char* clientId, bool cleanSession) override {
+        (void)clientId;
+        (void)cleanSession;
+        if (accepting) connects++;
+        return accepting;
+    }
+
+    bool onPublish(const char* topic, uint8_t qos, bool retain, const uint8_t* payload, size_t length, bool dup,
+                   uint16_t packetId) override {
+        messages.push_back({topic, qos, retain, dup, packetId, std::vector<uint8_t>(payload, payload + length)});
+        return true;
+    }
+
+    std::vector<Message> frames() const {
+        std::vector<Message> result;
+        for (const Message& message : messages) {
+            if (message.topic == std::string(MQTT_TOPIC_PREFIX) + "/" + MQTT_NODE_ID + "/t") {
+                result.push_back(message);
+            }
+        }
+        return result;
+    }
+
+    uint16_t sequenceOf(const Message& message) const {
+        DecodedFrame frame;
+        TEST_ASSERT_TRUE(decodeFrame(message.payload.data(), message.payload.size(), frame));
+        return frame.sequence;
+    }
+};
+
+StubBroker* broker = nullptr;
+MqttTelemetry* mqtt = nullptr;
+
+void run(unsigned long ms) {
+    for (unsigned long elapsed = 0; elapsed < ms; elapsed += STEP) {
+        NativeHal::advanceMillis(STEP);
+        mqtt->update();
+    }
+}
+
+// One frame per call; the temperature tells the frames apart
+void publishFrame(float temperature) {
+    Telemetry::Sample samples[] = {
+        {Telemetry::CH_TEMPERATURE, temperature},
+        {Telemetry::CH_HUMIDITY, 61.5f},
+    };
+    mqtt->publish(samples, 2, 1775556000);
+}
+
+void connect() {
+    run(MQTT_RECONNECT_INTERVAL + STEP);
+    TEST_ASSERT_TRUE(mqtt->isConnected());
+}
+
+} // namespace
+
+void setUp() {
+    NativeHal::reset();
+    NativeHal::setConsoleEnabled(false);
+    NativeHal::setWiFiConnected(true);
+    broker = new StubBroker();
+    NativeHal::attachMqttBroker(broker);
+    mqtt = new MqttTelemetry();
+    TEST_ASSERT_TRUE(mqtt->begin(MQTT_BROKER_HOST, MQTT_BROKER_PORT));
+}
+
+void tearDown() {
+    delete mqtt;
+    delete broker;
+    mqtt = nullptr;
+    broker = nullptr;
+}
+
+void test_frame_round_trip() {
+    Telemetry::Sample samples[] = {
+        {Telemetry::CH_TEMPERATURE, 23.44f},
+        {Telemetry::CH_HUMIDITY, 61.5f},
+        {Telemetry::CH_SOIL_TEMPERATURE, -4.26f},
+        {Telemetry::CH_LUX, 54612.4f},
+        {Telemetry::CH_SOIL_PH, 6.54f},
+        {Telemetry::CH_SOIL_EC, NAN}, // Not sent
+        {Telemetry::CH_FAN, 1.0f},
+    };
+    uint8_t buffer[TELEMETRY_MAX_FRAME];
+    size_t length = Telemetry::encodeFrame(buffer, sizeof(buffer), 1775556000, 0xBEEF, samples, 7);
+    TEST_ASSERT_GREATER_THAN(Telemetry::FRAME_HEADER_SIZE, length);
+
+    DecodedFrame frame;
+    TEST_ASSERT_TRUE(decodeFrame(buffer, length, frame));
+    TEST_ASSERT_EQUAL_UINT8(Telemetry::FRAME_VERSION, frame.version);
+    TEST_ASSERT_EQUAL_UINT32(1775556000, frame.time);
+    TEST_ASSERT_EQUAL_UINT16(0xBEEF, frame.sequence);
+    TEST_ASSERT_EQUAL_UINT32(6, frame.samples.size());
+    // Rounded to each channel's resolution
+    const float expected[] = {23.4f, 61.5f, -4.3f, 54612.0f, 6.54f, 1.0f};
+    const uint8_t channels[] = {1, 2, 8, 4, 10, 13};
+    for (uint8_t i = 0; i < 6; i++) {
+        TEST_ASSERT_EQUAL_UINT8(channels[i], frame.samples[i].channel);
+        TEST_ASSERT_FLOAT_WITHIN(0.001f, expected[i], frame.samples[i].value);
+    }
+    // A typical reading takes 3 bytes (see TelemetryFrame.h)
+    TEST_ASSERT_EQUAL_UINT32(Telemetry::FRAME_HEADER_SIZE + 3, Telemetry::encodeFrame(buffer, sizeof(buffer), 0, 0, samples, 1));
+
+    // A frame that does not fit is not written
+    TEST_ASSERT_EQUAL_UINT32(0, Telemetry::encodeFrame(buffer, Telemetry::FRAME_HEADER_SIZE + 4, 0, 0, samples, 7));
+}
+
+void test_full_outbox_drops_oldest() {
+    Telemetry::Outbox outbox;
+    for (uint8_t i = 0; i < MQTT_OUTBOX_SIZE + 3; i++) {
+        outbox.reserve()[0] = i;
+        outbox.commit(1);
+    }
+    TEST_ASSERT_EQUAL_UINT8(MQTT_OUTBOX_SIZE, outbox.size());
+    TEST_ASSERT_EQUAL_UINT32(3, outbox.getDroppedCount());
+
+    // Oldest kept first, in order
+    for (uint8_t i = 0; i < MQTT_OUTBOX_SIZE; i++) {
+        Telemetry::Outbox::Entry* entry = outbox.nextToSend(0, MQTT_RETRY_INTERVAL, MQTT_OUTBOX_SIZE);
+        TEST_ASSERT_NOT_NULL(entry);
+        TEST_ASSERT_EQUAL_UINT8(i + 3, entry->payload[0]);
+        outbox.markSent(entry, i + 1, 0);
+    }
+    // A late PUBACK for a dropped frame finds no match; an acknowledged frame is not a loss
+    TEST_ASSERT_TRUE(outbox.acknowledge(1));
+    TEST_ASSERT_FALSE(outbox.acknowledge(1));
+    outbox.reserve();
+    outbox.commit(1);
+    TEST_ASSERT_EQUAL_UINT32(3, outbox.getDroppedCount());
+
+    // Offline with a full queue, through MqttTelemetry: the newest frames survive
+    for (uint8_t i = 0; i < MQTT_OUTBOX_SIZE + 5; i++) {
+        publishFrame(20.0f + i);
+    }
+    TEST_ASSERT_EQUAL_UINT8(MQTT_OUTBOX_SIZE, mqtt->getOutboxSize());
+    TEST_ASSERT_EQUAL_UINT32(5, mqtt->getDroppedCount());
+    connect();
+    run(STEP);
+    std::vector<Message> frames = broker->frames();
+    TEST_ASSERT_EQUAL_UINT32(MQTT_MAX_INFLIGHT, frames.size());
+    TEST_ASSERT_EQUAL_UINT16(5, broker->sequenceOf(frames[0]));
+}
+
+void test_in_flight_cap() {
+    connect();
+    for (uint8_t i = 0; i < 10; i++) {
+        publishFrame(20.0f + i);
+    }
+    run(1000);
+    std::vector<Message> frames = broker->frames();
+    TEST_ASSERT_EQUAL_UINT32(MQTT_MAX_INFLIGHT, frames.size());
+    for (const Message& frame : frames) {
+        TEST_ASSERT_EQUAL_UINT8(1, frame.qos);
+        TEST_ASSERT_FALSE(frame.dup);
+        TEST_ASSERT_FALSE(frame.retain);
+    }
+
+    // Each PUBACK frees exactly one slot
+    NativeHal::mqttPublishAck(frames[0].packetId);
+    run(1000);
+    TEST_ASSERT_EQUAL_UINT32(MQTT_MAX_INFLIGHT + 1, broker->frames().size());
+    TEST_ASSERT_EQUAL_UINT8(9, mqtt->getOutboxSize());
+    TEST_ASSERT_EQUAL_UINT32(1, mqtt->getAckedCount());
+}
+
+void test_retry_after_timeout() {
+    connect();
+    publishFrame(21.0f);
+    publishFrame(22.0f);
+    run(STEP);
+    std::vector<Message> first = broker->frames();
+    TEST_ASSERT_EQUAL_UINT32(2, first.size());
+
+    // No resend before the retry interval
+    run(MQTT_RETRY_INTERVAL - 2 * STEP);
+    TEST_ASSERT_EQUAL_UINT32(2, broker->frames().size());
+
+    // Resent with the same packet id and DUP set; not counted as new frames
+    run(2 * STEP);
+    std::vector<Message> frames = broker->frames();
+    TEST_ASSERT_EQUAL_UINT32(4, frames.size());
+    for (uint8_t i = 0; i < 2; i++) {
+        TEST_ASSERT_TRUE(frames[2 + i].dup);
+        TEST_ASSERT_EQUAL_UINT16(first[i].packetId, frames[2 + i].packetId);
+        TEST_ASSERT_TRUE(frames[2 + i].payload == first[i].payload);
+    }
+    TEST_ASSERT_EQUAL_UINT32(2, mqtt->getSentCount());
+
+    // The PUBACK of a retry clears the frame: no third copy
+    NativeHal::mqttPublishAck(first[0].packetId);
+    NativeHal::mqttPublishAck(first[1].packetId);
+    run(2 * MQTT_RETRY_INTERVAL);
+    TEST_ASSERT_EQUAL_UINT32(4, broker->frames().size());
+    TEST_ASSERT_EQUAL_UINT8(0, mqtt->getOutboxSize());
+}
+
+void test_out_of_order_puback() {
+    connect();
+    for (uint8_t i = 0; i < MQTT_MAX_INFLIGHT; i++) {
+        publishFrame(20.0f + i);
+    }
+    run(STEP);
+    std::vector<Message> frames = broker->frames();
+    TEST_ASSERT_EQUAL_UINT32(MQTT_MAX_INFLIGHT, frames.size());
+
+    // The third and the first confirmed; an unknown id is ignored
+    NativeHal::mqttPublishAck(frames[2].packetId);
+    NativeHal::mqttPublishAck(frames[0].packetId);
+    NativeHal::mqttPublishAck(0x7777);
+    run(STEP);
+    TEST_ASSERT_EQUAL_UINT8(MQTT_MAX_INFLIGHT - 2, mqtt->getOutboxSize());
+    TEST_ASSERT_EQUAL_UINT32(2, mqtt->getAckedCount());
+
+    // Only the unconfirmed frames come back after the timeout
+    run(MQTT_RETRY_INTERVAL);
+    std::vector<Message> all = broker->frames();
+    std::vector<Message> retries(all.begin() + MQTT_MAX_INFLIGHT, all.end());
+    TEST_ASSERT_EQUAL_UINT32(2, retries.size());
+    TEST_ASSERT_EQUAL_UINT16(frames[1].packetId, retries[0].packetId);
+    TEST_ASSERT_EQUAL_UINT16(frames[3].packetId, retries[1].packetId);
+
+    NativeHal::mqttPublishAck(frames[3].packetId);
+    NativeHal::mqttPublishAck(frames[1].packetId);
+    run(STEP);
+    TEST_ASSERT_EQUAL_UINT8(0, mqtt->getOutboxSize());
+    TEST_ASSERT_EQUAL_UINT32(MQTT_MAX_INFLIGHT, mqtt->getAckedCount());
+}
+
+void test_session_reset_resends_queue() {
+    connect();
+    run(STEP);
+    // Status and schema go out retained on every connection
+    TEST_ASSERT_EQUAL_UINT32(2, broker->messages.size());
+    TEST_ASSERT_TRUE(broker->messages[0].retain);
+    TEST_ASSERT_TRUE(std::string(broker->messages[0].payload.begin(), broker->messages[0].payload.end()) == "online");
+    TEST_ASSERT_TRUE(broker->messages[1].retain);
+    std::string schema(broker->messages[1].payload.begin(), broker->messages[1].payload.end());
+    TEST_ASSERT_TRUE(schema.find("\"key\":\"temperature\"") != std::string::npos);
+
+    for (uint8_t i = 0; i < 3; i++) {
+        publishFrame(20.0f + i);
+    }
+    run(STEP);
+    std::vector<Message> before = broker->frames();
+    TEST_ASSERT_EQUAL_UINT32(3, before.size());
+    NativeHal::mqttPublishAck(before[0].packetId);
+    run(STEP);
+
+    // A PUBACK arrives just before TCP drops and the loop never sees it: that frame and
+    // the unconfirmed one are sent again; two more are queued while offline
+    NativeHal::mqttPublishAck(before[1].packetId);
+    NativeHal::mqttDropConnection();
+    TEST_ASSERT_FALSE(mqtt->isConnected());
+    publishFrame(23.0f);
+    publishFrame(24.0f);
+    broker->messages.clear();
+
+    connect();
+    run(STEP);
+    TEST_ASSERT_EQUAL_UINT32(2, broker->connects);
+    // New session: status and schema again, then every pending frame, oldest first,
+    // as a new publish (new packet id, no DUP)
+    std::vector<Message> after = broker->frames();
+    TEST_ASSERT_EQUAL_UINT32(MQTT_MAX_INFLIGHT, after.size());
+    for (uint8_t i = 0; i < MQTT_MAX_INFLIGHT; i++) {
+        TEST_ASSERT_FALSE(after[i].dup);
+        TEST_ASSERT_EQUAL_UINT16(1 + i, broker->sequenceOf(after[i]));
+        TEST_ASSERT_TRUE(after[i].packetId != before[1].packetId && after[i].packetId != before[2].packetId);
+    }
+    // An id from the old session matches nothing
+    NativeHal::mqttPublishAck(before[2].packetId);
+    run(STEP);
+    TEST_ASSERT_EQUAL_UINT8(MQTT_MAX_INFLIGHT, mqtt->getOutboxSize());
+    for (const Message& frame : after) {
+        NativeHal::mqttPublishAck(frame.packetId);
+    }
+    run(STEP);
+    TEST_ASSERT_EQUAL_UINT8(0, mqtt->getOutboxSize());
+    TEST_ASSERT_EQUAL_UINT32(0, mqtt->getDroppedCount());
+    // Frames 1 and 2 went out in both sessions
+    TEST_ASSERT_EQUAL_UINT32(7, mqtt->getSentCount());
+    TEST_ASSERT_EQUAL_UINT32(5, mqtt->getAckedCount());
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_frame_round_trip);
+    RUN_TEST(test_full_outbox_drops_oldest);
+    RUN_TEST(test_in_flight_cap);
+    RUN_TEST(test_retry_after_timeout);
+    RUN_TEST(test_out_of_order_puback);
+    RUN_TEST(test_session_reset_resends_queue);
+    return UNITY_END();
+}
@@ -0,0 +1,166 @@
+// Eventos de calendario de TimeManager con la hora de ManualTimeSource
+// pio test -e native -f test_time_manager
+//
+// millis() es el reloj simulado de NativeHal; la hora "verdadera" que entregan
+// las fuentes avanza con la deriva que se le quiera dar al reloj local. El
+// tick de minuto y el cambio de día deben dispararse una sola vez por minuto y
+// por día: al pasar la medianoche, cuando el arranque desde el RTC adelantado
+// cruza la medianoche y SNTP hace retroceder el reloj, y cuando un corte de
+// SNTP con la deriva ya corregida abarca la medianoche.
+
+#include <Arduino.h>
+#include <NativeHal.h>
+#include <unity.h>
+#include "config/config.h"
+#include "system/TimeManager.h"
+#include "system/TimeSource.h"
+
+#include <vector>
+
+namespace {
+
+const time_t MIDNIGHT = 1775512800; // 2026-04-07 00:00 CEST
+const uint32_t STEP = 1000;         // ms entre llamadas a update()
+
+std::vector<long> minuteTicks;      // Minuto (época / 60) de cada tick
+uint32_t dayRollovers = 0;
+TimeManager* timeManager = nullptr;
+
+void countMinute() {
+    minuteTicks.push_back((long)(timeManager->now() / 60));
+}
+
+void countDay() {
+    dayRollovers++;
+}
+
+// Reloj verdadero: época en ms que avanza (1 + ppm) veces más deprisa que millis()
+struct TrueClock {
+    int64_t startEpochMs;
+    unsigned long startMillis;
+    float ppm;
+
+    int64_t epochMs() const {
+        unsigned long elapsed = millis() - startMillis;
+        return startEpochMs + elapsed + (int64_t)(elapsed * ppm / 1000000.0);
+    }
+};
+
+// Advances the simulated clock; while sntp is given it delivers the true time
+void run(unsigned long ms, const TrueClock& truth, ManualTimeSource* sntp) {
+    for (unsigned long elapsed = 0; elapsed < ms; elapsed += STEP) {
+        NativeHal::advanceMillis(STEP);
+        if (sntp) {
+            int64_t epochMs = truth.epochMs();
+            sntp->setTime((time_t)(epochMs / 1000), (long)(epochMs % 1000));
+        }
+        timeManager->update();
+    }
+}
+
+void assertEachMinuteOnce() {
+    for (size_t i = 1; i < minuteTicks.size(); i++) {
+        TEST_ASSERT_EQUAL_INT32(minuteTicks[i - 1] + 1, minuteTicks[i]);
+    }
+}
+
+} // namespace
+
+void setUp() {
+    NativeHal::reset();
+    NativeHal::setConsoleEnabled(false);
+    minuteTicks.clear();
+    dayRollovers = 0;
+    timeManager = new TimeManager();
+    timeManager->onMinuteTick(countMinute);
+    timeManager->onDayRollover(countDay);
+}
+
+void tearDown() {
+    delete timeManager;
+    timeManager = nullptr;
+}
+
+void test_midnight_fires_each_event_once() {
+    ManualTimeSource sntp;
+    ManualTimeSource rtc;
+    TrueClock truth = {(int64_t)(MIDNIGHT - 90) * 1000, millis(), 0.0f};
+    sntp.setTime(MIDNIGHT - 90);
+    timeManager->setPrimarySource(&sntp);
+    timeManager->setFallbackSource(&rtc);
+    TEST_ASSERT_TRUE(timeManager->begin());
+
+    // 23:58:30 -> 00:03:30
+    run(300000, truth, &sntp);
+    TEST_ASSERT_EQUAL_UINT32(1, dayRollovers);
+    TEST_ASSERT_EQUAL_UINT32(5, minuteTicks.size());
+    TEST_ASSERT_EQUAL_INT32((long)(MIDNIGHT / 60) - 1, minuteTicks.front());
+    assertEachMinuteOnce();
+    TEST_ASSERT_EQUAL_UINT8(0, timeManager->getHour());
+    TEST_ASSERT_EQUAL_UINT8(3, timeManager->getMinute());
+}
+
+void test_rtc_ahead_across_midnight_then_sntp_steps_back() {
+    ManualTimeSource sntp;
+    ManualTimeSource rtc;
+    TrueClock truth = {(int64_t)(MIDNIGHT - 33) * 1000, millis(), 0.0f};
+    // Boot from an RTC 5 s fast; SNTP has no time yet
+    rtc.setTime(MIDNIGHT - 28);
+    timeManager->setPrimarySource(&sntp);
+    timeManager->setFallbackSource(&rtc);
+    TEST_ASSERT_TRUE(timeManager->begin());
+
+    // The RTC-based clock crosses midnight first
+    run(29000, truth, nullptr);
+    TEST_ASSERT_TRUE(timeManager->isValid());
+    TEST_ASSERT_EQUAL_UINT32(1, dayRollovers);
+    TEST_ASSERT_EQUAL_UINT32(1, minuteTicks.size());
+    TEST_ASSERT_EQUAL_UINT8(0, timeManager->getHour());
+
+    // SNTP is read on the next retry, at 23:59:57 true time, and steps the clock back
+    // over midnight; the true midnight three seconds later is the same day and minute
+    run(1000, truth, &sntp);
+    TEST_ASSERT_EQUAL_UINT8(23, timeManager->getHour());
+    run(120000, truth, &sntp);
+    TEST_ASSERT_INT_WITHIN(1, (long)(truth.epochMs() / 1000), (long)timeManager->now());
+    TEST_ASSERT_EQUAL_UINT32(1, dayRollovers);
+    // 00:00 (on the RTC, not again on SNTP) and 00:01
+    TEST_ASSERT_EQUAL_UINT32(2, minuteTicks.size());
+    assertEachMinuteOnce();
+}
+
+void test_sntp_outage_across_midnight_with_drift_correction() {
+    ManualTimeSource sntp;
+    ManualTimeSource rtc;
+    // millis() runs 80 ppm slow against the true time
+    const time_t start = MIDNIGHT - 12 * 3600;
+    TrueClock truth = {(int64_t)start * 1000, millis(), 80.0f};
+    sntp.setTime(start);
+    timeManager->setPrimarySource(&sntp);
+    timeManager->setFallbackSource(&rtc);
+    TEST_ASSERT_TRUE(timeManager->begin());
+
+    // Hourly syncs from 12:00 to 18:00 learn the drift
+    run(6 * 3600000UL, truth, &sntp);
+    TEST_ASSERT_FLOAT_WITHIN(5.0f, 80.0f, timeManager->getDriftPpm());
+
+    // SNTP down from 18:00 to 02:00: 8 h at 80 ppm would be 2.3 s off without the correction
+    run(8 * 3600000UL, truth, nullptr);
+    TEST_ASSERT_INT_WITHIN(1, (long)(truth.epochMs() / 1000), (long)timeManager->now());
+    TEST_ASSERT_EQUAL_UINT32(1, dayRollovers);
+
+    // SNTP back: a small step, no second rollover and no minute counted twice
+    run(TIME_SYNC_INTERVAL + 30000, truth, &sntp);
+    TEST_ASSERT_EQUAL_UINT32(1, dayRollovers);
+    assertEachMinuteOnce();
+    // 12:00:00 -> 03:00:30: one tick per minute
+    TEST_ASSERT_EQUAL_UINT32(15 * 60, minuteTicks.size());
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_midnight_fires_each_event_once);
+    RUN_TEST(test_rtc_ahead_across_midnight_then_sntp_steps_back);
+    RUN_TEST(test_sntp_outage_across_midnight_with_drift_correction);
+    return UNITY_END();
+}